@@ -0,0 +1,60 @@
+#ifndef SORBET_AST_EXPRESSIONARENA_H
+#define SORBET_AST_EXPRESSIONARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace sorbet::ast {
+
+class Expression;
+
+// A bump allocator for AST nodes, the tree-level counterpart of parser::NodeArena.
+//
+// While an `ExpressionArena::Scope` is active on the current thread, every `ast::Expression`
+// allocation is served out of large blocks owned by the arena and individual deallocations become
+// no-ops; all of the memory is returned in one shot when the scope dies. This fits windows where
+// trees are built, consumed, and discarded without escaping: per-edit file hashing and the slow
+// path's deep copies of the whole workspace are the big ones, and freeing those node by node is
+// what fragments the heap over a long session. Each allocation is tagged with its origin, so trees
+// that mix arena nodes with nodes allocated on other threads (or outside any scope) still tear
+// down correctly, and passes that splice fresh nodes into an arena-backed tree need no changes.
+//
+// The bytes returned wholesale are exported through the `memory.expression_arena.*` counters (via
+// ArenaStats) so a run can confirm how much tree memory bypassed the general-purpose heap.
+class ExpressionArena final {
+    friend class Expression;
+
+public:
+    ExpressionArena() = default;
+    ExpressionArena(const ExpressionArena &) = delete;
+    ExpressionArena &operator=(const ExpressionArena &) = delete;
+    ~ExpressionArena();
+
+    class Scope final {
+    public:
+        Scope();
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        ExpressionArena arena;
+        ExpressionArena *prev;
+    };
+
+private:
+    static constexpr size_t BLOCK_SIZE = 256 * 1024;
+    static thread_local ExpressionArena *active;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char *freePtr = nullptr;
+    size_t available = 0;
+    size_t allocatedBytes = 0;
+    size_t blockBytes = 0;
+
+    void *allocate(size_t size);
+};
+}; // namespace sorbet::ast
+
+#endif
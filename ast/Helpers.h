@@ -207,11 +207,11 @@ public:
     }
 
     static std::unique_ptr<Expression> Symbol(core::Loc loc, core::NameRef name) {
-        return std::make_unique<ast::Literal>(loc, core::make_type<core::LiteralType>(core::Symbols::Symbol(), name));
+        return std::make_unique<ast::Literal>(loc, core::Types::symbolLiteral(name));
     }
 
     static std::unique_ptr<Expression> String(core::Loc loc, core::NameRef value) {
-        return std::make_unique<ast::Literal>(loc, core::make_type<core::LiteralType>(core::Symbols::String(), value));
+        return std::make_unique<ast::Literal>(loc, core::Types::stringLiteral(value));
     }
 
     static std::unique_ptr<MethodDef> Method(core::Loc loc, core::Loc declLoc, core::NameRef name,
@@ -76,13 +76,13 @@ void printTabs(stringstream &to, int count) {
     }
 }
 
-Expression::Expression(core::Loc loc) : loc(loc) {}
+Expression::Expression(Tag tag, core::Loc loc) : tag(tag), loc(loc) {}
 
-Reference::Reference(core::Loc loc) : Expression(loc) {}
+Reference::Reference(Tag tag, core::Loc loc) : Expression(tag, loc) {}
 
 ClassDef::ClassDef(core::Loc loc, core::Loc declLoc, core::SymbolRef symbol, unique_ptr<Expression> name,
                    ANCESTORS_store ancestors, RHS_store rhs, ClassDefKind kind)
-    : Declaration(loc, declLoc, symbol), kind(kind), rhs(std::move(rhs)), name(std::move(name)),
+    : Declaration(Tag::ClassDef, loc, declLoc, symbol), kind(kind), rhs(std::move(rhs)), name(std::move(name)),
       ancestors(std::move(ancestors)) {
     categoryCounterInc("trees", "classdef");
     histogramInc("trees.classdef.kind", (int)kind);
@@ -92,50 +92,51 @@ ClassDef::ClassDef(core::Loc loc, core::Loc declLoc, core::SymbolRef symbol, uni
 
 MethodDef::MethodDef(core::Loc loc, core::Loc declLoc, core::SymbolRef symbol, core::NameRef name, ARGS_store args,
                      unique_ptr<Expression> rhs, u4 flags)
-    : Declaration(loc, declLoc, symbol), rhs(std::move(rhs)), args(std::move(args)), name(name), flags(flags) {
+    : Declaration(Tag::MethodDef, loc, declLoc, symbol), rhs(std::move(rhs)), args(std::move(args)), name(name),
+      flags(flags) {
     categoryCounterInc("trees", "methoddef");
     histogramInc("trees.methodDef.args", this->args.size());
     _sanityCheck();
 }
 
-Declaration::Declaration(core::Loc loc, core::Loc declLoc, core::SymbolRef symbol)
-    : Expression(loc), declLoc(declLoc), symbol(symbol) {}
+Declaration::Declaration(Tag tag, core::Loc loc, core::Loc declLoc, core::SymbolRef symbol)
+    : Expression(tag, loc), declLoc(declLoc), symbol(symbol) {}
 
 If::If(core::Loc loc, unique_ptr<Expression> cond, unique_ptr<Expression> thenp, unique_ptr<Expression> elsep)
-    : Expression(loc), cond(std::move(cond)), thenp(std::move(thenp)), elsep(std::move(elsep)) {
+    : Expression(Tag::If, loc), cond(std::move(cond)), thenp(std::move(thenp)), elsep(std::move(elsep)) {
     categoryCounterInc("trees", "if");
     _sanityCheck();
 }
 
 While::While(core::Loc loc, unique_ptr<Expression> cond, unique_ptr<Expression> body)
-    : Expression(loc), cond(std::move(cond)), body(std::move(body)) {
+    : Expression(Tag::While, loc), cond(std::move(cond)), body(std::move(body)) {
     categoryCounterInc("trees", "while");
     _sanityCheck();
 }
 
-Break::Break(core::Loc loc, unique_ptr<Expression> expr) : Expression(loc), expr(std::move(expr)) {
+Break::Break(core::Loc loc, unique_ptr<Expression> expr) : Expression(Tag::Break, loc), expr(std::move(expr)) {
     categoryCounterInc("trees", "break");
     _sanityCheck();
 }
 
-Retry::Retry(core::Loc loc) : Expression(loc) {
+Retry::Retry(core::Loc loc) : Expression(Tag::Retry, loc) {
     categoryCounterInc("trees", "retry");
     _sanityCheck();
 }
 
-Next::Next(core::Loc loc, unique_ptr<Expression> expr) : Expression(loc), expr(std::move(expr)) {
+Next::Next(core::Loc loc, unique_ptr<Expression> expr) : Expression(Tag::Next, loc), expr(std::move(expr)) {
     categoryCounterInc("trees", "next");
     _sanityCheck();
 }
 
-Return::Return(core::Loc loc, unique_ptr<Expression> expr) : Expression(loc), expr(std::move(expr)) {
+Return::Return(core::Loc loc, unique_ptr<Expression> expr) : Expression(Tag::Return, loc), expr(std::move(expr)) {
     categoryCounterInc("trees", "return");
     _sanityCheck();
 }
 
 RescueCase::RescueCase(core::Loc loc, EXCEPTION_store exceptions, unique_ptr<Expression> var,
                        unique_ptr<Expression> body)
-    : Expression(loc), exceptions(std::move(exceptions)), var(std::move(var)), body(std::move(body)) {
+    : Expression(Tag::RescueCase, loc), exceptions(std::move(exceptions)), var(std::move(var)), body(std::move(body)) {
     categoryCounterInc("trees", "rescuecase");
     histogramInc("trees.rescueCase.exceptions", this->exceptions.size());
     _sanityCheck();
@@ -143,39 +144,41 @@ RescueCase::RescueCase(core::Loc loc, EXCEPTION_store exceptions, unique_ptr<Exp
 
 Rescue::Rescue(core::Loc loc, unique_ptr<Expression> body, RESCUE_CASE_store rescueCases, unique_ptr<Expression> else_,
                unique_ptr<Expression> ensure)
-    : Expression(loc), body(std::move(body)), rescueCases(std::move(rescueCases)), else_(std::move(else_)),
+    : Expression(Tag::Rescue, loc), body(std::move(body)), rescueCases(std::move(rescueCases)), else_(std::move(else_)),
       ensure(std::move(ensure)) {
     categoryCounterInc("trees", "rescue");
     histogramInc("trees.rescue.rescuecases", this->rescueCases.size());
     _sanityCheck();
 }
 
-Field::Field(core::Loc loc, core::SymbolRef symbol) : Reference(loc), symbol(symbol) {
+Field::Field(core::Loc loc, core::SymbolRef symbol) : Reference(Tag::Field, loc), symbol(symbol) {
     categoryCounterInc("trees", "field");
     _sanityCheck();
 }
 
-Local::Local(core::Loc loc, core::LocalVariable localVariable1) : Reference(loc), localVariable(localVariable1) {
+Local::Local(core::Loc loc, core::LocalVariable localVariable1)
+    : Reference(Tag::Local, loc), localVariable(localVariable1) {
     categoryCounterInc("trees", "local");
     _sanityCheck();
 }
 
 UnresolvedIdent::UnresolvedIdent(core::Loc loc, VarKind kind, core::NameRef name)
-    : Reference(loc), name(name), kind(kind) {
+    : Reference(Tag::UnresolvedIdent, loc), name(name), kind(kind) {
     categoryCounterInc("trees", "unresolvedident");
     _sanityCheck();
     _sanityCheck();
 }
 
 Assign::Assign(core::Loc loc, unique_ptr<Expression> lhs, unique_ptr<Expression> rhs)
-    : Expression(loc), lhs(std::move(lhs)), rhs(std::move(rhs)) {
+    : Expression(Tag::Assign, loc), lhs(std::move(lhs)), rhs(std::move(rhs)) {
     categoryCounterInc("trees", "assign");
     _sanityCheck();
 }
 
 Send::Send(core::Loc loc, unique_ptr<Expression> recv, core::NameRef fun, Send::ARGS_store args,
            unique_ptr<Block> block, u4 flags)
-    : Expression(loc), fun(fun), flags(flags), recv(std::move(recv)), args(std::move(args)), block(std::move(block)) {
+    : Expression(Tag::Send, loc), fun(fun), flags(flags), recv(std::move(recv)), args(std::move(args)),
+      block(std::move(block)) {
     categoryCounterInc("trees", "send");
     if (block) {
         counterInc("trees.send.with_block");
@@ -185,55 +188,57 @@ Send::Send(core::Loc loc, unique_ptr<Expression> recv, core::NameRef fun, Send::
 }
 
 Cast::Cast(core::Loc loc, core::TypePtr ty, unique_ptr<Expression> arg, core::NameRef cast)
-    : Expression(loc), cast(cast), type(std::move(ty)), arg(std::move(arg)) {
+    : Expression(Tag::Cast, loc), cast(cast), type(std::move(ty)), arg(std::move(arg)) {
     categoryCounterInc("trees", "cast");
     _sanityCheck();
 }
 
-ZSuperArgs::ZSuperArgs(core::Loc loc) : Expression(loc) {
+ZSuperArgs::ZSuperArgs(core::Loc loc) : Expression(Tag::ZSuperArgs, loc) {
     categoryCounterInc("trees", "zsuper");
     _sanityCheck();
 }
 
-RestArg::RestArg(core::Loc loc, unique_ptr<Reference> arg) : Reference(loc), expr(std::move(arg)) {
+RestArg::RestArg(core::Loc loc, unique_ptr<Reference> arg) : Reference(Tag::RestArg, loc), expr(std::move(arg)) {
     categoryCounterInc("trees", "restarg");
     _sanityCheck();
 }
 
-KeywordArg::KeywordArg(core::Loc loc, unique_ptr<Reference> expr) : Reference(loc), expr(std::move(expr)) {
+KeywordArg::KeywordArg(core::Loc loc, unique_ptr<Reference> expr)
+    : Reference(Tag::KeywordArg, loc), expr(std::move(expr)) {
     categoryCounterInc("trees", "keywordarg");
     _sanityCheck();
 }
 
 OptionalArg::OptionalArg(core::Loc loc, unique_ptr<Reference> expr, unique_ptr<Expression> default_)
-    : Reference(loc), expr(std::move(expr)), default_(std::move(default_)) {
+    : Reference(Tag::OptionalArg, loc), expr(std::move(expr)), default_(std::move(default_)) {
     categoryCounterInc("trees", "optionalarg");
     _sanityCheck();
 }
 
-ShadowArg::ShadowArg(core::Loc loc, unique_ptr<Reference> expr) : Reference(loc), expr(std::move(expr)) {
+ShadowArg::ShadowArg(core::Loc loc, unique_ptr<Reference> expr)
+    : Reference(Tag::ShadowArg, loc), expr(std::move(expr)) {
     categoryCounterInc("trees", "shadowarg");
     _sanityCheck();
 }
 
-BlockArg::BlockArg(core::Loc loc, unique_ptr<Reference> expr) : Reference(loc), expr(std::move(expr)) {
+BlockArg::BlockArg(core::Loc loc, unique_ptr<Reference> expr) : Reference(Tag::BlockArg, loc), expr(std::move(expr)) {
     categoryCounterInc("trees", "blockarg");
     _sanityCheck();
 }
 
-Literal::Literal(core::Loc loc, const core::TypePtr &value) : Expression(loc), value(std::move(value)) {
+Literal::Literal(core::Loc loc, const core::TypePtr &value) : Expression(Tag::Literal, loc), value(std::move(value)) {
     categoryCounterInc("trees", "literal");
     _sanityCheck();
 }
 
 UnresolvedConstantLit::UnresolvedConstantLit(core::Loc loc, unique_ptr<Expression> scope, core::NameRef cnst)
-    : Expression(loc), cnst(cnst), scope(std::move(scope)) {
+    : Expression(Tag::UnresolvedConstantLit, loc), cnst(cnst), scope(std::move(scope)) {
     categoryCounterInc("trees", "constantlit");
     _sanityCheck();
 }
 
 ConstantLit::ConstantLit(core::Loc loc, core::SymbolRef symbol, unique_ptr<UnresolvedConstantLit> original)
-    : Expression(loc), symbol(symbol), original(std::move(original)) {
+    : Expression(Tag::ConstantLit, loc), symbol(symbol), original(std::move(original)) {
     categoryCounterInc("trees", "resolvedconstantlit");
     _sanityCheck();
 }
@@ -259,32 +264,32 @@ ConstantLit::fullUnresolvedPath(const core::GlobalState &gs) const {
 }
 
 Block::Block(core::Loc loc, MethodDef::ARGS_store args, unique_ptr<Expression> body)
-    : Expression(loc), args(std::move(args)), body(std::move(body)) {
+    : Expression(Tag::Block, loc), args(std::move(args)), body(std::move(body)) {
     categoryCounterInc("trees", "block");
     _sanityCheck();
 };
 
 Hash::Hash(core::Loc loc, ENTRY_store keys, ENTRY_store values)
-    : Expression(loc), keys(std::move(keys)), values(std::move(values)) {
+    : Expression(Tag::Hash, loc), keys(std::move(keys)), values(std::move(values)) {
     categoryCounterInc("trees", "hash");
     histogramInc("trees.hash.entries", this->keys.size());
     _sanityCheck();
 }
 
-Array::Array(core::Loc loc, ENTRY_store elems) : Expression(loc), elems(std::move(elems)) {
+Array::Array(core::Loc loc, ENTRY_store elems) : Expression(Tag::Array, loc), elems(std::move(elems)) {
     categoryCounterInc("trees", "array");
     histogramInc("trees.array.elems", this->elems.size());
     _sanityCheck();
 }
 
 InsSeq::InsSeq(core::Loc loc, STATS_store stats, unique_ptr<Expression> expr)
-    : Expression(loc), stats(std::move(stats)), expr(std::move(expr)) {
+    : Expression(Tag::InsSeq, loc), stats(std::move(stats)), expr(std::move(expr)) {
     categoryCounterInc("trees", "insseq");
     histogramInc("trees.insseq.stats", this->stats.size());
     _sanityCheck();
 }
 
-EmptyTree::EmptyTree() : Expression(core::Loc::none()) {
+EmptyTree::EmptyTree() : Expression(Tag::EmptyTree, core::Loc::none()) {
     categoryCounterInc("trees", "emptytree");
     _sanityCheck();
 }
@@ -451,6 +456,7 @@ string MethodDef::showRaw(const core::GlobalState &gs, int tabs) {
     const pair<int, string_view> flags[] = {
         {SelfMethod, "self"sv},
         {DSLSynthesized, "dsl"sv},
+        {DSLSynthesizedTemplate, "dsl-template"sv},
     };
     for (auto &ent : flags) {
         if ((this->flags & ent.first) != 0) {
@@ -30,8 +30,49 @@ namespace sorbet::ast {
 
 class Expression {
 public:
-    Expression(core::Loc loc);
+    // Runtime type tag of the concrete class of this node. Dispatching on the tag is much cheaper
+    // than RTTI, which matters because every pass over this IR visits every node of every tree.
+    enum class Tag : u1 {
+        ClassDef = 1,
+        MethodDef,
+        If,
+        While,
+        Break,
+        Retry,
+        Next,
+        Return,
+        RescueCase,
+        Rescue,
+        Field,
+        Local,
+        UnresolvedIdent,
+        RestArg,
+        KeywordArg,
+        OptionalArg,
+        BlockArg,
+        ShadowArg,
+        Assign,
+        Send,
+        Cast,
+        Hash,
+        Array,
+        Literal,
+        UnresolvedConstantLit,
+        ConstantLit,
+        ZSuperArgs,
+        Block,
+        InsSeq,
+        EmptyTree,
+    };
+
+    Expression(Tag tag, core::Loc loc);
     virtual ~Expression() = default;
+
+    // Nodes are bump-allocated while an `ExpressionArena::Scope` is active on this thread; see
+    // ExpressionArena.h.
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr);
+
     virtual std::string toStringWithTabs(const core::GlobalState &gs, int tabs = 0) const = 0;
     std::string toString(const core::GlobalState &gs) const {
         return toStringWithTabs(gs);
@@ -40,6 +81,7 @@ public:
     virtual std::string showRaw(const core::GlobalState &gs, int tabs = 0) = 0;
     std::unique_ptr<Expression> deepCopy() const;
     virtual void _sanityCheck() = 0;
+    const Tag tag;
     const core::Loc loc;
 
     class DeepCopyError {};
@@ -56,17 +98,30 @@ struct ParsedFile {
     core::FileRef file;
 };
 
+// Maps each concrete node class to its Expression::Tag; specialized below, after the class
+// definitions.
+template <class To> struct ExpressionToTag;
+
 template <class To> To *cast_tree(Expression *what) {
     static_assert(!std::is_pointer<To>::value, "To has to be a pointer");
     static_assert(std::is_assignable<Expression *&, To *>::value, "Ill Formed To, has to be a subclass of Expression");
-    return fast_cast<Expression, To>(what);
+    if constexpr (std::is_final<To>::value) {
+        if (what != nullptr && what->tag == ExpressionToTag<To>::value) {
+            return static_cast<To *>(what);
+        }
+        return nullptr;
+    } else {
+        // Intermediate classes (Reference, Declaration) have no tag of their own; those casts are
+        // rare and never on a tree-walk hot path, so RTTI is fine for them.
+        return fast_cast<Expression, To>(what);
+    }
 }
 
 // A variant of cast_tree that preserves the const-ness (if const in, then const out)
 template <class To> const To *cast_tree_const(const Expression *what) {
     static_assert(!std::is_pointer<To>::value, "To has to be a pointer");
     static_assert(std::is_assignable<Expression *&, To *>::value, "Ill Formed To, has to be a subclass of Expression");
-    return fast_cast<Expression, To>(const_cast<Expression *>(what));
+    return cast_tree<To>(const_cast<Expression *>(what));
 }
 
 template <class To> bool isa_tree(Expression *what) {
@@ -75,7 +130,7 @@ template <class To> bool isa_tree(Expression *what) {
 
 class Reference : public Expression {
 public:
-    Reference(core::Loc loc);
+    Reference(Tag tag, core::Loc loc);
 };
 // CheckSize(Reference, 16, 8);
 
@@ -84,7 +139,7 @@ public:
     core::Loc declLoc;
     core::SymbolRef symbol;
 
-    Declaration(core::Loc loc, core::Loc declLoc, core::SymbolRef symbol);
+    Declaration(Tag tag, core::Loc loc, core::Loc declLoc, core::SymbolRef symbol);
 };
 // CheckSize(Declaration, 24, 8);
 
@@ -133,6 +188,11 @@ public:
     enum Flags {
         SelfMethod = 1,
         DSLSynthesized = 2,
+        // A DSL expansion whose body is built entirely from synthesized casts and T.unsafe stubs
+        // (never from user-written trees), so inference over it cannot produce diagnostics. The
+        // pipeline skips typechecking such methods; thousands of prop getters/setters share a
+        // handful of these template shapes.
+        DSLSynthesizedTemplate = 4,
     };
 
     MethodDef(core::Loc loc, core::Loc declLoc, core::SymbolRef symbol, core::NameRef name, ARGS_store args,
@@ -150,6 +210,10 @@ public:
         return (flags & DSLSynthesized) != 0;
     }
 
+    bool isDSLSynthesizedTemplate() const {
+        return (flags & DSLSynthesizedTemplate) != 0;
+    }
+
 private:
     virtual void _sanityCheck();
 };
@@ -649,6 +713,44 @@ private:
 };
 // CheckSize(EmptyTree, 16, 8);
 
+#define TREE_TO_TAG(T)                                             \
+    template <> struct ExpressionToTag<T> {                        \
+        static constexpr Expression::Tag value = Expression::Tag::T; \
+    }
+
+TREE_TO_TAG(ClassDef);
+TREE_TO_TAG(MethodDef);
+TREE_TO_TAG(If);
+TREE_TO_TAG(While);
+TREE_TO_TAG(Break);
+TREE_TO_TAG(Retry);
+TREE_TO_TAG(Next);
+TREE_TO_TAG(Return);
+TREE_TO_TAG(RescueCase);
+TREE_TO_TAG(Rescue);
+TREE_TO_TAG(Field);
+TREE_TO_TAG(Local);
+TREE_TO_TAG(UnresolvedIdent);
+TREE_TO_TAG(RestArg);
+TREE_TO_TAG(KeywordArg);
+TREE_TO_TAG(OptionalArg);
+TREE_TO_TAG(BlockArg);
+TREE_TO_TAG(ShadowArg);
+TREE_TO_TAG(Assign);
+TREE_TO_TAG(Send);
+TREE_TO_TAG(Cast);
+TREE_TO_TAG(Hash);
+TREE_TO_TAG(Array);
+TREE_TO_TAG(Literal);
+TREE_TO_TAG(UnresolvedConstantLit);
+TREE_TO_TAG(ConstantLit);
+TREE_TO_TAG(ZSuperArgs);
+TREE_TO_TAG(Block);
+TREE_TO_TAG(InsSeq);
+TREE_TO_TAG(EmptyTree);
+
+#undef TREE_TO_TAG
+
 /** https://git.corp.stripe.com/gist/nelhage/51564501674174da24822e60ad770f64
  *
  *  [] - prototype only
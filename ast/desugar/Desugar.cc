@@ -38,6 +38,67 @@ core::NameRef blockArg2Name(DesugarContext dctx, const BlockArg &blkArg) {
 
 unique_ptr<Expression> node2TreeImpl(DesugarContext dctx, unique_ptr<parser::Node> what);
 
+// The DSL pass only rewrites trees containing one of a fixed set of constructs. Desugaring visits
+// every send anyway, so it records on the File whether any such construct occurs, and
+// pipeline::runDSL skips the pass (two full tree walks) for files where none does. This may
+// over-approximate — a false positive only costs the walks — but must never miss a construct some
+// rewriter in //dsl keys on.
+bool isDSLTriggerSend(const parser::Send *send) {
+    switch (send->method._id) {
+        case core::Names::prop()._id:
+        case core::Names::const_()._id:
+        case core::Names::token_prop()._id:
+        case core::Names::timestamped_token_prop()._id:
+        case core::Names::created_prop()._id:
+        case core::Names::merchant_prop()._id:
+        case core::Names::encrypted_prop()._id:
+        case core::Names::before()._id:
+        case core::Names::describe()._id:
+        case core::Names::it()._id:
+        case core::Names::dslOptional()._id:
+        case core::Names::dslRequired()._id:
+        case core::Names::private_()._id:
+        case core::Names::privateClassMethod()._id:
+        case core::Names::delegate()._id:
+        case core::Names::attr()._id:
+        case core::Names::attrReader()._id:
+        case core::Names::attrWriter()._id:
+        case core::Names::attrAccessor()._id:
+        case core::Names::mattrReader()._id:
+        case core::Names::mattrWriter()._id:
+        case core::Names::mattrAccessor()._id:
+        case core::Names::cattrReader()._id:
+        case core::Names::cattrWriter()._id:
+        case core::Names::cattrAccessor()._id:
+        case core::Names::classAttribute()._id:
+        case core::Names::wrapInstance()._id:
+        case core::Names::msgclass()._id:
+        case core::Names::enummodule()._id:
+            return true;
+        case core::Names::new_()._id: {
+            // `Struct.new` / `Class.new` assignments (dsl::Struct, dsl::ClassNew).
+            auto *recv = parser::cast_node<parser::Const>(send->receiver.get());
+            return recv != nullptr && (recv->name == core::Names::Constants::Struct() ||
+                                       recv->name == core::Names::Constants::Class());
+        }
+        default:
+            return false;
+    }
+}
+
+// dsl::Command, dsl::OpusEnum and dsl::Rails key on the superclass rather than on a send.
+// Superclasses that are themselves sends (`ActiveRecord::Migration[5.2]`) are rare enough to
+// always count as a trigger rather than inspect further.
+bool isDSLTriggerSuperclass(const parser::Node *superclass) {
+    if (parser::isa_node<parser::Send>(superclass)) {
+        return true;
+    }
+    auto *cnst = parser::cast_node<parser::Const>(superclass);
+    return cnst != nullptr &&
+           (cnst->name == core::Names::Constants::Command() || cnst->name == core::Names::Constants::Enum() ||
+            cnst->name == core::Names::Constants::Migration());
+}
+
 pair<MethodDef::ARGS_store, InsSeq::STATS_store> desugarArgs(DesugarContext dctx, core::Loc loc,
                                                              unique_ptr<parser::Node> &argnode) {
     MethodDef::ARGS_store args;
@@ -256,6 +317,7 @@ unique_ptr<Expression> unsupportedNode(DesugarContext dctx, parser::Node *node)
 
 unique_ptr<Expression> desugarMlhs(DesugarContext dctx, core::Loc loc, parser::Mlhs *lhs, unique_ptr<Expression> rhs) {
     InsSeq::STATS_store stats;
+    stats.reserve(lhs->exprs.size() + 2); // +2 for the temp assignments prepended below
 
     core::NameRef tempRhs =
         dctx.ctx.state.freshNameUnique(core::UniqueNameKind::Desugar, core::Names::assignTemp(), ++dctx.uniqueCounter);
@@ -318,8 +380,11 @@ unique_ptr<Expression> desugarMlhs(DesugarContext dctx, core::Loc loc, parser::M
 
     auto expanded = MK::Send3(loc, MK::Constant(loc, core::Symbols::Magic()), core::Names::expandSplat(),
                               MK::Local(loc, tempRhs), MK::Int(loc, before), MK::Int(loc, after));
-    stats.insert(stats.begin(), MK::Assign(loc, tempExpanded, std::move(expanded)));
-    stats.insert(stats.begin(), MK::Assign(loc, tempRhs, std::move(rhs)));
+    // Both temp assignments go in front of the per-element statements; a single two-element insert
+    // shifts the store once instead of twice.
+    unique_ptr<Expression> prefix[2] = {MK::Assign(loc, tempRhs, std::move(rhs)),
+                                        MK::Assign(loc, tempExpanded, std::move(expanded))};
+    stats.insert(stats.begin(), std::make_move_iterator(std::begin(prefix)), std::make_move_iterator(std::end(prefix)));
 
     // Regardless of how we destructure an assignment, Ruby evaluates the expression to the entire right hand side,
     // not any individual component of the destructured assignment.
@@ -425,6 +490,9 @@ unique_ptr<Expression> node2TreeImpl(DesugarContext dctx, unique_ptr<parser::Nod
             // add entries here, without consulting the "node.*" counters from a
             // run over a representative code base.
             [&](parser::Send *send) {
+                if (isDSLTriggerSend(send)) {
+                    loc.file().data(dctx.ctx.state).hasDSLConstructs = true;
+                }
                 u4 flags = 0;
                 auto rec = node2TreeImpl(dctx, std::move(send->receiver));
                 if (isa_tree<EmptyTree>(rec.get())) {
@@ -451,8 +519,7 @@ unique_ptr<Expression> node2TreeImpl(DesugarContext dctx, unique_ptr<parser::Nod
 
                     auto array = make_unique<parser::Array>(loc, std::move(argnodes));
                     auto args = node2TreeImpl(dctx, std::move(array));
-                    auto method =
-                        MK::Literal(loc, core::make_type<core::LiteralType>(core::Symbols::Symbol(), send->method));
+                    auto method = MK::Symbol(loc, send->method);
 
                     Send::ARGS_store sendargs;
                     sendargs.emplace_back(std::move(rec));
@@ -492,8 +559,7 @@ unique_ptr<Expression> node2TreeImpl(DesugarContext dctx, unique_ptr<parser::Nod
                     if (block == nullptr) {
                         res = MK::Send(loc, std::move(rec), send->method, std::move(args), flags);
                     } else {
-                        auto method =
-                            MK::Literal(loc, core::make_type<core::LiteralType>(core::Symbols::Symbol(), send->method));
+                        auto method = MK::Symbol(loc, send->method);
                         auto convertedBlock = node2TreeImpl(dctx, std::move(block));
                         Literal *lit;
                         if ((lit = cast_tree<Literal>(convertedBlock.get())) && lit->isSymbol(dctx.ctx)) {
@@ -883,6 +949,9 @@ unique_ptr<Expression> node2TreeImpl(DesugarContext dctx, unique_ptr<parser::Nod
                 result.swap(res);
             },
             [&](parser::Class *claz) {
+                if (claz->superclass != nullptr && isDSLTriggerSuperclass(claz->superclass.get())) {
+                    loc.file().data(dctx.ctx.state).hasDSLConstructs = true;
+                }
                 ClassDef::RHS_store body = scopeNodeToBody(dctx, std::move(claz->body));
                 ClassDef::ANCESTORS_store ancestors;
                 if (claz->superclass == nullptr) {
@@ -1734,6 +1803,9 @@ unique_ptr<Expression> node2Tree(core::MutableContext ctx, unique_ptr<parser::No
         // We don't have an enclosing block arg to start off.
         DesugarContext dctx(ctx, uniqueCounter, core::NameRef::noName(), core::Loc::none(), core::NameRef::noName());
         auto loc = what->loc;
+        // Recomputed from scratch for this version of the file; the Send and Class cases set it
+        // back when they see something a DSL rewriter keys on.
+        loc.file().data(ctx.state).hasDSLConstructs = false;
         auto result = node2TreeImpl(dctx, std::move(what));
         result = liftTopLevel(dctx, loc, std::move(result));
         auto verifiedResult = Verifier::run(ctx, std::move(result));
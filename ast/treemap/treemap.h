@@ -638,62 +638,69 @@ private:
         auto loc = what->loc;
 
         try {
-            // TODO: reorder by frequency
             if constexpr (HAS_MEMBER_preTransformExpression<FUNC>::value) {
                 what = PostPonePreTransform_Expression<FUNC, CTX, HAS_MEMBER_preTransformExpression<FUNC>::value>::call(
                     ctx, move(what), func);
             }
 
-            if (isa_tree<EmptyTree>(what.get()) || isa_tree<ZSuperArgs>(what.get())) {
-                return what;
-            }
-
-            if (isa_tree<UnresolvedConstantLit>(what.get())) {
-                return mapUnresolvedConstantLit(
-                    std::unique_ptr<UnresolvedConstantLit>(static_cast<UnresolvedConstantLit *>(what.release())), ctx);
-            } else if (isa_tree<ConstantLit>(what.get())) {
-                return mapConstantLit(std::unique_ptr<ConstantLit>(static_cast<ConstantLit *>(what.release())), ctx);
-            } else if (isa_tree<Send>(what.get())) {
-                return mapSend(std::unique_ptr<Send>(static_cast<Send *>(what.release())), ctx);
-            } else if (isa_tree<Literal>(what.get())) {
-                return mapLiteral(std::unique_ptr<Literal>(static_cast<Literal *>(what.release())), ctx);
-            } else if (UnresolvedIdent *u = cast_tree<UnresolvedIdent>(what.get())) {
-                return mapUnresolvedIdent(
-                    std::unique_ptr<UnresolvedIdent>(static_cast<UnresolvedIdent *>(what.release())), ctx);
-            } else if (isa_tree<Local>(what.get())) {
-                return mapLocal(std::unique_ptr<Local>(static_cast<Local *>(what.release())), ctx);
-            } else if (isa_tree<MethodDef>(what.get())) {
-                return mapMethodDef(std::unique_ptr<MethodDef>(static_cast<MethodDef *>(what.release())), ctx);
-            } else if (isa_tree<InsSeq>(what.get())) {
-                return mapInsSeq(std::unique_ptr<InsSeq>(static_cast<InsSeq *>(what.release())), ctx);
-            } else if (isa_tree<Hash>(what.get())) {
-                return mapHash(std::unique_ptr<Hash>(static_cast<Hash *>(what.release())), ctx);
-            } else if (isa_tree<ClassDef>(what.get())) {
-                return mapClassDef(std::unique_ptr<ClassDef>(static_cast<ClassDef *>(what.release())), ctx);
-            } else if (isa_tree<If>(what.get())) {
-                return mapIf(std::unique_ptr<If>(static_cast<If *>(what.release())), ctx);
-            } else if (isa_tree<While>(what.get())) {
-                return mapWhile(std::unique_ptr<While>(static_cast<While *>(what.release())), ctx);
-            } else if (isa_tree<Break>(what.get())) {
-                return mapBreak(std::unique_ptr<Break>(static_cast<Break *>(what.release())), ctx);
-            } else if (isa_tree<Retry>(what.get())) {
-                return mapRetry(std::unique_ptr<Retry>(static_cast<Retry *>(what.release())), ctx);
-            } else if (isa_tree<Next>(what.get())) {
-                return mapNext(std::unique_ptr<Next>(static_cast<Next *>(what.release())), ctx);
-            } else if (isa_tree<Return>(what.get())) {
-                return mapReturn(std::unique_ptr<Return>(static_cast<Return *>(what.release())), ctx);
-            } else if (isa_tree<Rescue>(what.get())) {
-                return mapRescue(std::unique_ptr<Rescue>(static_cast<Rescue *>(what.release())), ctx);
-            } else if (isa_tree<Field>(what.get())) {
-                return mapField(std::unique_ptr<Field>(static_cast<Field *>(what.release())), ctx);
-            } else if (isa_tree<Assign>(what.get())) {
-                return mapAssign(std::unique_ptr<Assign>(static_cast<Assign *>(what.release())), ctx);
-            } else if (isa_tree<Array>(what.get())) {
-                return mapArray(std::unique_ptr<Array>(static_cast<Array *>(what.release())), ctx);
-            } else if (isa_tree<Cast>(what.get())) {
-                return mapCast(std::unique_ptr<Cast>(static_cast<Cast *>(what.release())), ctx);
-            } else {
-                Exception::raise("should never happen. Forgot to add new tree kind? {}", what->nodeName());
+            // Dispatch on the node's tag; this compiles to a jump table, where the old isa_tree
+            // chain paid up to one RTTI comparison per tree kind on every node.
+            switch (what->tag) {
+                case Expression::Tag::EmptyTree:
+                case Expression::Tag::ZSuperArgs:
+                    return what;
+
+                case Expression::Tag::UnresolvedConstantLit:
+                    return mapUnresolvedConstantLit(
+                        std::unique_ptr<UnresolvedConstantLit>(static_cast<UnresolvedConstantLit *>(what.release())),
+                        ctx);
+                case Expression::Tag::ConstantLit:
+                    return mapConstantLit(std::unique_ptr<ConstantLit>(static_cast<ConstantLit *>(what.release())),
+                                          ctx);
+                case Expression::Tag::Send:
+                    return mapSend(std::unique_ptr<Send>(static_cast<Send *>(what.release())), ctx);
+                case Expression::Tag::Literal:
+                    return mapLiteral(std::unique_ptr<Literal>(static_cast<Literal *>(what.release())), ctx);
+                case Expression::Tag::UnresolvedIdent:
+                    return mapUnresolvedIdent(
+                        std::unique_ptr<UnresolvedIdent>(static_cast<UnresolvedIdent *>(what.release())), ctx);
+                case Expression::Tag::Local:
+                    return mapLocal(std::unique_ptr<Local>(static_cast<Local *>(what.release())), ctx);
+                case Expression::Tag::MethodDef:
+                    return mapMethodDef(std::unique_ptr<MethodDef>(static_cast<MethodDef *>(what.release())), ctx);
+                case Expression::Tag::InsSeq:
+                    return mapInsSeq(std::unique_ptr<InsSeq>(static_cast<InsSeq *>(what.release())), ctx);
+                case Expression::Tag::Hash:
+                    return mapHash(std::unique_ptr<Hash>(static_cast<Hash *>(what.release())), ctx);
+                case Expression::Tag::ClassDef:
+                    return mapClassDef(std::unique_ptr<ClassDef>(static_cast<ClassDef *>(what.release())), ctx);
+                case Expression::Tag::If:
+                    return mapIf(std::unique_ptr<If>(static_cast<If *>(what.release())), ctx);
+                case Expression::Tag::While:
+                    return mapWhile(std::unique_ptr<While>(static_cast<While *>(what.release())), ctx);
+                case Expression::Tag::Break:
+                    return mapBreak(std::unique_ptr<Break>(static_cast<Break *>(what.release())), ctx);
+                case Expression::Tag::Retry:
+                    return mapRetry(std::unique_ptr<Retry>(static_cast<Retry *>(what.release())), ctx);
+                case Expression::Tag::Next:
+                    return mapNext(std::unique_ptr<Next>(static_cast<Next *>(what.release())), ctx);
+                case Expression::Tag::Return:
+                    return mapReturn(std::unique_ptr<Return>(static_cast<Return *>(what.release())), ctx);
+                case Expression::Tag::Rescue:
+                    return mapRescue(std::unique_ptr<Rescue>(static_cast<Rescue *>(what.release())), ctx);
+                case Expression::Tag::Field:
+                    return mapField(std::unique_ptr<Field>(static_cast<Field *>(what.release())), ctx);
+                case Expression::Tag::Assign:
+                    return mapAssign(std::unique_ptr<Assign>(static_cast<Assign *>(what.release())), ctx);
+                case Expression::Tag::Array:
+                    return mapArray(std::unique_ptr<Array>(static_cast<Array *>(what.release())), ctx);
+                case Expression::Tag::Cast:
+                    return mapCast(std::unique_ptr<Cast>(static_cast<Cast *>(what.release())), ctx);
+
+                default:
+                    // RescueCase, Block, and the argument nodes never appear as a free-standing
+                    // expression; their parents walk them directly.
+                    Exception::raise("should never happen. Forgot to add new tree kind? {}", what->nodeName());
             }
         } catch (SorbetException &e) {
             Exception::failInFuzzer();
@@ -719,6 +726,369 @@ public:
         }
     }
 };
+
+/**
+ * Read-only companion to TreeMapper for analysis passes that never rewrite the tree. Handlers use
+ * the same names TreeMap dispatches on, but take `const X &` and return nothing:
+ *
+ *     void preTransformSend(core::Context ctx, const Send &original);
+ *     void postTransformMethodDef(core::Context ctx, const MethodDef &original);
+ *
+ * No ownership is threaded through the walk, so several such passes can traverse one immutable
+ * tree concurrently from different workers. Visit order matches TreeMapper's.
+ */
+template <class FUNC, class CTX> class ConstTreeMapper {
+private:
+    friend class ConstTreeMap;
+
+    FUNC &func;
+
+    static_assert(!HAS_MEMBER_preTransformField<FUNC>::value, "use post*Transform instead");
+    static_assert(!HAS_MEMBER_preTransformUnresolvedIdent<FUNC>::value, "use post*Transform instead");
+    static_assert(!HAS_MEMBER_preTransformLiteral<FUNC>::value, "use post*Transform instead");
+    static_assert(!HAS_MEMBER_preTransformUnresolvedConstantLit<FUNC>::value, "use post*Transform instead");
+    static_assert(!HAS_MEMBER_preTransformConstantLit<FUNC>::value, "use post*Transform instead");
+    static_assert(!HAS_MEMBER_preTransformLocal<FUNC>::value, "use post*Transform instead");
+
+    ConstTreeMapper(FUNC &func) : func(func) {}
+
+    void walkClassDef(const ClassDef &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformClassDef<FUNC>::value) {
+            func.preTransformClassDef(ctx, v);
+        }
+
+        // We intentionally do not walk v.ancestors nor v.singletonAncestors.
+        // They are guaranteed to be simple trees in the desugarer.
+        for (auto &def : v.rhs) {
+            walkIt(def.get(), ctx.withOwner(v.symbol));
+        }
+
+        if constexpr (HAS_MEMBER_postTransformClassDef<FUNC>::value) {
+            func.postTransformClassDef(ctx, v);
+        }
+    }
+
+    void walkMethodDef(const MethodDef &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformMethodDef<FUNC>::value) {
+            func.preTransformMethodDef(ctx, v);
+        }
+
+        for (auto &arg : v.args) {
+            // Only OptionalArgs have subexpressions within them.
+            if (auto *optArg = cast_tree<OptionalArg>(arg.get())) {
+                walkIt(optArg->default_.get(), ctx.withOwner(v.symbol));
+            }
+        }
+        walkIt(v.rhs.get(), ctx.withOwner(v.symbol));
+
+        if constexpr (HAS_MEMBER_postTransformMethodDef<FUNC>::value) {
+            func.postTransformMethodDef(ctx, v);
+        }
+    }
+
+    void walkIf(const If &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformIf<FUNC>::value) {
+            func.preTransformIf(ctx, v);
+        }
+        walkIt(v.cond.get(), ctx);
+        walkIt(v.thenp.get(), ctx);
+        walkIt(v.elsep.get(), ctx);
+
+        if constexpr (HAS_MEMBER_postTransformIf<FUNC>::value) {
+            func.postTransformIf(ctx, v);
+        }
+    }
+
+    void walkWhile(const While &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformWhile<FUNC>::value) {
+            func.preTransformWhile(ctx, v);
+        }
+        walkIt(v.cond.get(), ctx);
+        walkIt(v.body.get(), ctx);
+
+        if constexpr (HAS_MEMBER_postTransformWhile<FUNC>::value) {
+            func.postTransformWhile(ctx, v);
+        }
+    }
+
+    void walkBreak(const Break &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformBreak<FUNC>::value) {
+            func.preTransformBreak(ctx, v);
+        }
+        walkIt(v.expr.get(), ctx);
+
+        if constexpr (HAS_MEMBER_postTransformBreak<FUNC>::value) {
+            func.postTransformBreak(ctx, v);
+        }
+    }
+
+    void walkRetry(const Retry &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_postTransformRetry<FUNC>::value) {
+            func.postTransformRetry(ctx, v);
+        }
+    }
+
+    void walkNext(const Next &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformNext<FUNC>::value) {
+            func.preTransformNext(ctx, v);
+        }
+        walkIt(v.expr.get(), ctx);
+
+        if constexpr (HAS_MEMBER_postTransformNext<FUNC>::value) {
+            func.postTransformNext(ctx, v);
+        }
+    }
+
+    void walkReturn(const Return &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformReturn<FUNC>::value) {
+            func.preTransformReturn(ctx, v);
+        }
+        walkIt(v.expr.get(), ctx);
+
+        if constexpr (HAS_MEMBER_postTransformReturn<FUNC>::value) {
+            func.postTransformReturn(ctx, v);
+        }
+    }
+
+    void walkRescueCase(const RescueCase &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformRescueCase<FUNC>::value) {
+            func.preTransformRescueCase(ctx, v);
+        }
+        for (auto &el : v.exceptions) {
+            walkIt(el.get(), ctx);
+        }
+        walkIt(v.var.get(), ctx);
+        walkIt(v.body.get(), ctx);
+
+        if constexpr (HAS_MEMBER_postTransformRescueCase<FUNC>::value) {
+            func.postTransformRescueCase(ctx, v);
+        }
+    }
+
+    void walkRescue(const Rescue &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformRescue<FUNC>::value) {
+            func.preTransformRescue(ctx, v);
+        }
+        walkIt(v.body.get(), ctx);
+        for (auto &el : v.rescueCases) {
+            walkRescueCase(*el, ctx);
+        }
+        walkIt(v.else_.get(), ctx);
+        walkIt(v.ensure.get(), ctx);
+
+        if constexpr (HAS_MEMBER_postTransformRescue<FUNC>::value) {
+            func.postTransformRescue(ctx, v);
+        }
+    }
+
+    void walkAssign(const Assign &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformAssign<FUNC>::value) {
+            func.preTransformAssign(ctx, v);
+        }
+        walkIt(v.lhs.get(), ctx);
+        walkIt(v.rhs.get(), ctx);
+
+        if constexpr (HAS_MEMBER_postTransformAssign<FUNC>::value) {
+            func.postTransformAssign(ctx, v);
+        }
+    }
+
+    void walkSend(const Send &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformSend<FUNC>::value) {
+            func.preTransformSend(ctx, v);
+        }
+        walkIt(v.recv.get(), ctx);
+        for (auto &arg : v.args) {
+            walkIt(arg.get(), ctx);
+        }
+        if (v.block) {
+            walkBlock(*v.block, ctx);
+        }
+
+        if constexpr (HAS_MEMBER_postTransformSend<FUNC>::value) {
+            func.postTransformSend(ctx, v);
+        }
+    }
+
+    void walkHash(const Hash &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformHash<FUNC>::value) {
+            func.preTransformHash(ctx, v);
+        }
+        for (auto &key : v.keys) {
+            walkIt(key.get(), ctx);
+        }
+        for (auto &value : v.values) {
+            walkIt(value.get(), ctx);
+        }
+
+        if constexpr (HAS_MEMBER_postTransformHash<FUNC>::value) {
+            func.postTransformHash(ctx, v);
+        }
+    }
+
+    void walkArray(const Array &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformArray<FUNC>::value) {
+            func.preTransformArray(ctx, v);
+        }
+        for (auto &elem : v.elems) {
+            walkIt(elem.get(), ctx);
+        }
+
+        if constexpr (HAS_MEMBER_postTransformArray<FUNC>::value) {
+            func.postTransformArray(ctx, v);
+        }
+    }
+
+    void walkBlock(const Block &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformBlock<FUNC>::value) {
+            func.preTransformBlock(ctx, v);
+        }
+        for (auto &arg : v.args) {
+            // Only OptionalArgs have subexpressions within them.
+            if (auto *optArg = cast_tree<OptionalArg>(arg.get())) {
+                walkIt(optArg->default_.get(), ctx);
+            }
+        }
+        walkIt(v.body.get(), ctx);
+
+        if constexpr (HAS_MEMBER_postTransformBlock<FUNC>::value) {
+            func.postTransformBlock(ctx, v);
+        }
+    }
+
+    void walkInsSeq(const InsSeq &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformInsSeq<FUNC>::value) {
+            func.preTransformInsSeq(ctx, v);
+        }
+        for (auto &stat : v.stats) {
+            walkIt(stat.get(), ctx);
+        }
+        walkIt(v.expr.get(), ctx);
+
+        if constexpr (HAS_MEMBER_postTransformInsSeq<FUNC>::value) {
+            func.postTransformInsSeq(ctx, v);
+        }
+    }
+
+    void walkCast(const Cast &v, CTX ctx) {
+        if constexpr (HAS_MEMBER_preTransformCast<FUNC>::value) {
+            func.preTransformCast(ctx, v);
+        }
+        walkIt(v.arg.get(), ctx);
+
+        if constexpr (HAS_MEMBER_postTransformCast<FUNC>::value) {
+            func.postTransformCast(ctx, v);
+        }
+    }
+
+    void walkIt(const Expression *what, CTX ctx) {
+        if (what == nullptr) {
+            return;
+        }
+        auto loc = what->loc;
+
+        try {
+            if constexpr (HAS_MEMBER_preTransformExpression<FUNC>::value) {
+                func.preTransformExpression(ctx, *what);
+            }
+
+            switch (what->tag) {
+                case Expression::Tag::EmptyTree:
+                case Expression::Tag::ZSuperArgs:
+                    return;
+
+                case Expression::Tag::UnresolvedConstantLit:
+                    if constexpr (HAS_MEMBER_postTransformUnresolvedConstantLit<FUNC>::value) {
+                        func.postTransformUnresolvedConstantLit(ctx,
+                                                                *static_cast<const UnresolvedConstantLit *>(what));
+                    }
+                    return;
+                case Expression::Tag::ConstantLit:
+                    if constexpr (HAS_MEMBER_postTransformConstantLit<FUNC>::value) {
+                        func.postTransformConstantLit(ctx, *static_cast<const ConstantLit *>(what));
+                    }
+                    return;
+                case Expression::Tag::Send:
+                    return walkSend(*static_cast<const Send *>(what), ctx);
+                case Expression::Tag::Literal:
+                    if constexpr (HAS_MEMBER_postTransformLiteral<FUNC>::value) {
+                        func.postTransformLiteral(ctx, *static_cast<const Literal *>(what));
+                    }
+                    return;
+                case Expression::Tag::UnresolvedIdent:
+                    if constexpr (HAS_MEMBER_postTransformUnresolvedIdent<FUNC>::value) {
+                        func.postTransformUnresolvedIdent(ctx, *static_cast<const UnresolvedIdent *>(what));
+                    }
+                    return;
+                case Expression::Tag::Local:
+                    if constexpr (HAS_MEMBER_postTransformLocal<FUNC>::value) {
+                        func.postTransformLocal(ctx, *static_cast<const Local *>(what));
+                    }
+                    return;
+                case Expression::Tag::MethodDef:
+                    return walkMethodDef(*static_cast<const MethodDef *>(what), ctx);
+                case Expression::Tag::InsSeq:
+                    return walkInsSeq(*static_cast<const InsSeq *>(what), ctx);
+                case Expression::Tag::Hash:
+                    return walkHash(*static_cast<const Hash *>(what), ctx);
+                case Expression::Tag::ClassDef:
+                    return walkClassDef(*static_cast<const ClassDef *>(what), ctx);
+                case Expression::Tag::If:
+                    return walkIf(*static_cast<const If *>(what), ctx);
+                case Expression::Tag::While:
+                    return walkWhile(*static_cast<const While *>(what), ctx);
+                case Expression::Tag::Break:
+                    return walkBreak(*static_cast<const Break *>(what), ctx);
+                case Expression::Tag::Retry:
+                    return walkRetry(*static_cast<const Retry *>(what), ctx);
+                case Expression::Tag::Next:
+                    return walkNext(*static_cast<const Next *>(what), ctx);
+                case Expression::Tag::Return:
+                    return walkReturn(*static_cast<const Return *>(what), ctx);
+                case Expression::Tag::Rescue:
+                    return walkRescue(*static_cast<const Rescue *>(what), ctx);
+                case Expression::Tag::Field:
+                    if constexpr (HAS_MEMBER_postTransformField<FUNC>::value) {
+                        func.postTransformField(ctx, *static_cast<const Field *>(what));
+                    }
+                    return;
+                case Expression::Tag::Assign:
+                    return walkAssign(*static_cast<const Assign *>(what), ctx);
+                case Expression::Tag::Array:
+                    return walkArray(*static_cast<const Array *>(what), ctx);
+                case Expression::Tag::Cast:
+                    return walkCast(*static_cast<const Cast *>(what), ctx);
+
+                default:
+                    // RescueCase, Block, and the argument nodes never appear as a free-standing
+                    // expression; their parents walk them directly. (nodeName() is not const, so
+                    // report the raw tag instead.)
+                    Exception::raise("should never happen. Forgot to add new tree kind? tag={}",
+                                     static_cast<int>(what->tag));
+            }
+        } catch (SorbetException &e) {
+            Exception::failInFuzzer();
+
+            throw ReportedRubyException{e, loc};
+        }
+    }
+};
+
+class ConstTreeMap {
+public:
+    template <typename CTX, typename FUNC> static void apply(CTX ctx, FUNC &func, const Expression &to) {
+        ConstTreeMapper<FUNC, CTX> walker(func);
+        try {
+            walker.walkIt(&to, ctx);
+        } catch (ReportedRubyException &exception) {
+            Exception::failInFuzzer();
+            if (auto e = ctx.state.beginError(exception.onLoc, core::errors::Internal::InternalError)) {
+                e.setHeader("Failed to process tree (backtrace is above)");
+            }
+            throw exception.reported;
+        }
+    }
+};
 } // namespace sorbet::ast
 
 #endif // SORBET_TREEMAP_H
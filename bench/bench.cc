@@ -0,0 +1,255 @@
+#include <cxxopts.hpp>
+
+#include "ast/ast.h"
+#include "common/Counters.h"
+#include "common/FileOps.h"
+#include "common/common.h"
+#include "core/ErrorQueue.h"
+#include "core/Unfreeze.h"
+#include "core/serialize/serialize.h"
+#include "main/pipeline/pipeline.h"
+#include "payload/binary/binary.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "spdlog/spdlog.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+// Performance harness: runs pinned synthetic corpora through the index/name/resolve/typecheck
+// phases one at a time and reports wall time, cpu time and max RSS per phase, plus the Counters
+// the phases emit (--counters). With --check it diffs the wall times against the checked-in
+// baseline (bench/baseline.txt) and fails when a phase regresses past --threshold percent; the
+// baseline is regenerated on the machine that gates on it with --update-baseline, since absolute
+// timings do not transfer between machines.
+//
+// The corpora are generated deterministically in-process (no checked-in fixtures): identical
+// sources on every run is the whole point, and generating them keeps a 1000-file corpus out of
+// the repo.
+
+namespace sorbet::bench {
+namespace spd = spdlog;
+using namespace std;
+
+namespace {
+
+struct Corpus {
+    string name;
+    int fileCount;
+    int methodsPerFile;
+};
+
+const vector<Corpus> corpora = {
+    {"small", 10, 20},
+    {"medium", 100, 20},
+    {"huge", 1000, 20},
+};
+
+// Deterministic synthetic Ruby: classes with sig'd methods, literal shapes, conditionals and
+// cross-file sends, so every phase (and the intrinsics/inference fast paths) does representative
+// work. Do not change the generated text casually — it invalidates every recorded baseline.
+string generateFile(const Corpus &corpus, int fileIdx) {
+    fmt::memory_buffer buf;
+    fmt::format_to(buf, "# typed: true\nclass Bench_{}_{}\n  extend T::Sig\n", corpus.name, fileIdx);
+    for (int m = 0; m < corpus.methodsPerFile; m++) {
+        fmt::format_to(buf,
+                       "  sig {{params(x: Integer).returns(Integer)}}\n"
+                       "  def m{}(x)\n"
+                       "    h = {{a: {}, b: \"s{}\"}}\n"
+                       "    t = [x, \"t{}\"]\n"
+                       "    if x > {}\n"
+                       "      h[:a] + t.fetch(0)\n"
+                       "    else\n"
+                       "      x - h.fetch(:a)\n"
+                       "    end\n"
+                       "  end\n",
+                       m, m, m, m, m);
+    }
+    if (fileIdx > 0) {
+        fmt::format_to(buf,
+                       "  sig {{returns(Integer)}}\n"
+                       "  def call_prev\n"
+                       "    Bench_{}_{}.new.m0(0)\n"
+                       "  end\n",
+                       corpus.name, fileIdx - 1);
+    }
+    fmt::format_to(buf, "end\n");
+    return to_string(buf);
+}
+
+struct PhaseStat {
+    string key; // "<corpus>.<phase>"
+    double wallMs;
+    double cpuMs;
+    long maxRssKb;
+};
+
+double cpuMsNow() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.0;
+    }
+    auto toMs = [](const struct timeval &tv) { return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0; };
+    return toMs(usage.ru_utime) + toMs(usage.ru_stime);
+}
+
+long maxRssKbNow() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return usage.ru_maxrss;
+}
+
+template <typename F> void measurePhase(vector<PhaseStat> &stats, const Corpus &corpus, string_view phase, F &&run) {
+    auto cpuBefore = cpuMsNow();
+    auto wallBefore = chrono::steady_clock::now();
+    run();
+    auto wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - wallBefore).count();
+    auto cpuMs = cpuMsNow() - cpuBefore;
+    stats.emplace_back(PhaseStat{fmt::format("{}.{}", corpus.name, phase), wallMs, cpuMs, maxRssKbNow()});
+}
+
+void runCorpus(const Corpus &corpus, shared_ptr<spd::logger> logger, vector<PhaseStat> &stats) {
+    auto errorQueue = make_shared<core::ErrorQueue>(*logger, *logger);
+    // Measurement runs must not pay for error formatting or printing; errors are drained (and
+    // merely counted) after the corpus finishes.
+    errorQueue->ignoreFlushes = true;
+    auto gs = make_unique<core::GlobalState>(errorQueue);
+    core::serialize::Serializer::loadGlobalState(*gs, getNameTablePayload);
+    realmain::options::Options opts;
+    auto workers = WorkerPool::create(opts.threads, *logger);
+
+    vector<core::FileRef> files;
+    {
+        core::UnfreezeFileTable fileTableAccess(*gs);
+        for (int i = 0; i < corpus.fileCount; i++) {
+            files.emplace_back(
+                gs->enterFile(fmt::format("bench/{}/file{}.rb", corpus.name, i), generateFile(corpus, i)));
+        }
+    }
+
+    unique_ptr<KeyValueStore> kvstore;
+    vector<ast::ParsedFile> trees;
+    measurePhase(stats, corpus, "index", [&] { trees = realmain::pipeline::index(gs, files, opts, *workers, kvstore); });
+    measurePhase(stats, corpus, "name", [&] { trees = realmain::pipeline::name(*gs, move(trees), opts); });
+    measurePhase(stats, corpus, "resolve", [&] {
+        trees = realmain::pipeline::resolve(gs, move(trees), opts, *workers, /* skipConfigatron */ true,
+                                            /* alreadyNamed */ true);
+    });
+    measurePhase(stats, corpus, "typecheck",
+                 [&] { trees = realmain::pipeline::typecheck(gs, move(trees), opts, *workers); });
+
+    auto errors = gs->errorQueue->drainAllErrors();
+    if (!errors.empty()) {
+        // The corpora are meant to be clean; errors mean the generator and the checker drifted
+        // apart and the timings are measuring something else.
+        logger->error("corpus {} produced {} errors; timings are not comparable", corpus.name, errors.size());
+    }
+}
+
+UnorderedMap<string, double> readBaseline(string_view path) {
+    UnorderedMap<string, double> baseline;
+    if (!FileOps::exists(path)) {
+        return baseline;
+    }
+    istringstream in(FileOps::read(path));
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        istringstream fields(line);
+        string key;
+        double value;
+        if (fields >> key >> value) {
+            baseline[key] = value;
+        }
+    }
+    return baseline;
+}
+
+} // namespace
+
+int benchmain(int argc, char *argv[]) {
+    cxxopts::Options options("bench", "Sorbet pipeline performance harness");
+    options.add_options()("check", "Fail if a phase's wall time regresses past --threshold vs the baseline");
+    options.add_options()("threshold", "Allowed wall-time regression, in percent",
+                          cxxopts::value<double>()->default_value("25"));
+    options.add_options()("baseline", "Baseline file to compare against / update",
+                          cxxopts::value<string>()->default_value("bench/baseline.txt"));
+    options.add_options()("update-baseline", "Record this run's wall times as the new baseline");
+    options.add_options()("counters", "Dump all Counters after the run");
+    options.add_options()("h,help", "Show help");
+    auto opts = options.parse(argc, argv);
+    if (opts["help"].as<bool>()) {
+        cout << options.help() << '\n';
+        return 0;
+    }
+
+    auto logger = spd::stderr_color_mt("bench");
+
+    vector<PhaseStat> stats;
+    for (auto &corpus : corpora) {
+        runCorpus(corpus, logger, stats);
+    }
+
+    fmt::print("{:<24} {:>12} {:>12} {:>12}\n", "phase", "wall_ms", "cpu_ms", "max_rss_kb");
+    for (auto &stat : stats) {
+        fmt::print("{:<24} {:>12.1f} {:>12.1f} {:>12}\n", stat.key, stat.wallMs, stat.cpuMs, stat.maxRssKb);
+    }
+
+    if (opts["counters"].as<bool>()) {
+        counterConsume(getAndClearThreadCounters());
+        fmt::print("{}\n", getCounterStatistics(Counters::ALL_COUNTERS));
+    }
+
+    auto baselinePath = opts["baseline"].as<string>();
+    if (opts["update-baseline"].as<bool>()) {
+        fmt::memory_buffer buf;
+        fmt::format_to(buf, "# Recorded by `bazel run //bench -- --update-baseline`; wall times in ms.\n"
+                            "# Timings only compare on the machine that recorded them.\n");
+        for (auto &stat : stats) {
+            fmt::format_to(buf, "{} {:.1f}\n", stat.key, stat.wallMs);
+        }
+        FileOps::write(baselinePath, string_view(buf.data(), buf.size()));
+        fmt::print("wrote baseline to {}\n", baselinePath);
+        return 0;
+    }
+
+    if (opts["check"].as<bool>()) {
+        auto threshold = opts["threshold"].as<double>();
+        auto baseline = readBaseline(baselinePath);
+        if (baseline.empty()) {
+            fmt::print(stderr, "no baseline at {}; record one with --update-baseline\n", baselinePath);
+            return 1;
+        }
+        int regressions = 0;
+        for (auto &stat : stats) {
+            auto it = baseline.find(stat.key);
+            if (it == baseline.end()) {
+                // New phases have no history yet; they start gating once the baseline is updated.
+                continue;
+            }
+            auto allowed = it->second * (1.0 + threshold / 100.0);
+            if (stat.wallMs > allowed) {
+                fmt::print(stderr, "REGRESSION {}: {:.1f}ms vs baseline {:.1f}ms (+{:.1f}%, allowed {:.1f}%)\n",
+                           stat.key, stat.wallMs, it->second, (stat.wallMs / it->second - 1.0) * 100.0, threshold);
+                regressions++;
+            }
+        }
+        if (regressions > 0) {
+            return 1;
+        }
+        fmt::print("all phases within {:.1f}% of baseline\n", threshold);
+    }
+    return 0;
+}
+
+} // namespace sorbet::bench
+
+int main(int argc, char *argv[]) {
+    return sorbet::bench::benchmain(argc, argv);
+}
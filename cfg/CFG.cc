@@ -1,22 +1,57 @@
 #include "cfg/CFG.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_split.h"
+#include "common/ArenaStats.h"
 
 // helps debugging
 template class std::unique_ptr<sorbet::cfg::CFG>;
-template class std::unique_ptr<sorbet::cfg::BasicBlock>;
 template class std::vector<sorbet::cfg::BasicBlock *>;
 
 using namespace std;
 
 namespace sorbet::cfg {
 
+CFGArena::~CFGArena() {
+    // Reverse allocation order, mirroring what individual deletes would have done.
+    for (auto it = destructors_.rbegin(); it != destructors_.rend(); ++it) {
+        it->destroy(it->obj);
+    }
+    // Methods that fit in the inline page (the common case) never touch the registry at all.
+    if (!pages_.empty()) {
+        ArenaStats::arenaFreed(ArenaStats::Kind::Cfg, allocatedBytes_, pageBytes_, pages_.size());
+    }
+}
+
+void *CFGArena::allocate(size_t bytes) {
+    // Keep every object at standard alignment.
+    bytes = (bytes + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    allocatedBytes_ += bytes;
+    if (bytes > PAGE_SIZE) {
+        // Oversized requests get a dedicated page; the current page keeps filling for normal ones.
+        pages_.emplace_back(make_unique<char[]>(bytes));
+        pageBytes_ += bytes;
+        ArenaStats::blockAllocated(bytes);
+        return pages_.back().get();
+    }
+    if (bytes > pageRemaining_) {
+        pages_.emplace_back(make_unique<char[]>(PAGE_SIZE));
+        pagePtr_ = pages_.back().get();
+        pageRemaining_ = PAGE_SIZE;
+        pageBytes_ += PAGE_SIZE;
+        ArenaStats::blockAllocated(PAGE_SIZE);
+    }
+    auto *res = pagePtr_;
+    pagePtr_ += bytes;
+    pageRemaining_ -= bytes;
+    return res;
+}
+
 BasicBlock *CFG::freshBlock(int outerLoops) {
     int id = this->maxBasicBlockId++;
-    auto &r = this->basicBlocks.emplace_back(make_unique<BasicBlock>());
+    auto *r = this->basicBlocks.emplace_back(arena.make<BasicBlock>());
     r->id = id;
     r->outerLoops = outerLoops;
-    return r.get();
+    return r;
 }
 
 CFG::CFG() {
@@ -35,7 +70,7 @@ CFG::ReadsAndWrites CFG::findAllReadsAndWrites(core::Context ctx) {
     target.dead.resize(maxBasicBlockId);
     vector<UnorderedSet<core::LocalVariable>> readsAndWrites(maxBasicBlockId);
 
-    for (unique_ptr<BasicBlock> &bb : this->basicBlocks) {
+    for (BasicBlock *bb : this->basicBlocks) {
         auto &blockWrites = target.writes[bb->id];
         auto &blockReads = target.reads[bb->id];
         auto &blockDead = target.dead[bb->id];
@@ -49,32 +84,32 @@ CFG::ReadsAndWrites CFG::findAllReadsAndWrites(core::Context ctx) {
              * assignment. Treating every write as also reading from the
              * variable serves to represent this.
              */
-            if (bind.bind.variable.isAliasForGlobal(ctx) && cast_instruction<Alias>(bind.value.get()) == nullptr) {
+            if (bind.bind.variable.isAliasForGlobal(ctx) && cast_instruction<Alias>(bind.value) == nullptr) {
                 blockReads.insert(bind.bind.variable);
             }
 
-            if (auto *v = cast_instruction<Ident>(bind.value.get())) {
+            if (auto *v = cast_instruction<Ident>(bind.value)) {
                 blockReads.insert(v->what);
                 blockReadsAndWrites.insert(v->what);
-            } else if (auto *v = cast_instruction<Send>(bind.value.get())) {
+            } else if (auto *v = cast_instruction<Send>(bind.value)) {
                 blockReads.insert(v->recv.variable);
                 blockReadsAndWrites.insert(v->recv.variable);
                 for (auto &arg : v->args) {
                     blockReads.insert(arg.variable);
                     blockReadsAndWrites.insert(arg.variable);
                 }
-            } else if (auto *v = cast_instruction<TAbsurd>(bind.value.get())) {
+            } else if (auto *v = cast_instruction<TAbsurd>(bind.value)) {
                 blockReads.insert(v->what.variable);
-            } else if (auto *v = cast_instruction<Return>(bind.value.get())) {
+            } else if (auto *v = cast_instruction<Return>(bind.value)) {
                 blockReads.insert(v->what.variable);
                 blockReadsAndWrites.insert(v->what.variable);
-            } else if (auto *v = cast_instruction<BlockReturn>(bind.value.get())) {
+            } else if (auto *v = cast_instruction<BlockReturn>(bind.value)) {
                 blockReads.insert(v->what.variable);
                 blockReadsAndWrites.insert(v->what.variable);
-            } else if (auto *v = cast_instruction<Cast>(bind.value.get())) {
+            } else if (auto *v = cast_instruction<Cast>(bind.value)) {
                 blockReads.insert(v->value.variable);
                 blockReadsAndWrites.insert(v->value.variable);
-            } else if (auto *v = cast_instruction<LoadSelf>(bind.value.get())) {
+            } else if (auto *v = cast_instruction<LoadSelf>(bind.value)) {
                 blockReads.insert(v->fallback);
                 blockReadsAndWrites.insert(v->fallback);
             }
@@ -120,12 +155,12 @@ void CFG::sanityCheck(core::Context ctx) {
     for (auto &bb : this->basicBlocks) {
         ENFORCE(bb->bexit.isCondSet(), "Block exit condition left unset for block {}", bb->toString(ctx));
 
-        if (bb.get() == deadBlock()) {
+        if (bb == deadBlock()) {
             continue;
         }
 
-        auto thenCount = absl::c_count(bb->bexit.thenb->backEdges, bb.get());
-        auto elseCount = absl::c_count(bb->bexit.elseb->backEdges, bb.get());
+        auto thenCount = absl::c_count(bb->bexit.thenb->backEdges, bb);
+        auto elseCount = absl::c_count(bb->bexit.elseb->backEdges, bb);
         ENFORCE(thenCount == 1, "bb id={}; then has {} back edges", bb->id, thenCount);
         ENFORCE(elseCount == 1, "bb id={}; else has {} back edges", bb->id, elseCount);
         if (bb->bexit.thenb == bb->bexit.elseb) {
@@ -190,8 +225,7 @@ string BasicBlock::toString(core::Context ctx) {
     return to_string(buf);
 }
 
-Binding::Binding(core::LocalVariable bind, core::Loc loc, unique_ptr<Instruction> value)
-    : bind(bind), loc(loc), value(std::move(value)) {}
+Binding::Binding(core::LocalVariable bind, core::Loc loc, Instruction *value) : bind(bind), loc(loc), value(value) {}
 
 bool CFG::shouldExport(const core::GlobalState &gs) const {
     // Only export CFGs whose owner mixes in T::CFGExport
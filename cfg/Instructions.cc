@@ -11,7 +11,7 @@ using namespace std;
 
 namespace sorbet::cfg {
 
-Return::Return(core::LocalVariable what) : what(what) {
+Return::Return(core::LocalVariable what) : Instruction(Tag::Return), what(what) {
     categoryCounterInc("cfg", "return");
 }
 
@@ -24,7 +24,7 @@ string Return::toString(core::Context ctx) {
 }
 
 BlockReturn::BlockReturn(shared_ptr<core::SendAndBlockLink> link, core::LocalVariable what)
-    : link(std::move(link)), what(what) {
+    : Instruction(Tag::BlockReturn), link(std::move(link)), what(what) {
     categoryCounterInc("cfg", "blockreturn");
 }
 
@@ -33,7 +33,7 @@ string BlockReturn::toString(core::Context ctx) {
 }
 
 LoadSelf::LoadSelf(shared_ptr<core::SendAndBlockLink> link, core::LocalVariable fallback)
-    : link(std::move(link)), fallback(fallback) {
+    : Instruction(Tag::LoadSelf), link(std::move(link)), fallback(fallback) {
     categoryCounterInc("cfg", "loadself");
 }
 
@@ -44,7 +44,8 @@ string LoadSelf::toString(core::Context ctx) {
 Send::Send(core::LocalVariable recv, core::NameRef fun, core::Loc receiverLoc,
            const InlinedVector<core::LocalVariable, 2> &args, InlinedVector<core::Loc, 2> argLocs,
            const shared_ptr<core::SendAndBlockLink> &link)
-    : recv(recv), fun(fun), receiverLoc(receiverLoc), argLocs(std::move(argLocs)), link(move(link)) {
+    : Instruction(Tag::Send), recv(recv), fun(fun), receiverLoc(receiverLoc), argLocs(std::move(argLocs)),
+      link(move(link)) {
     this->args.resize(args.size());
     int i = 0;
     for (const auto &e : args) {
@@ -55,7 +56,7 @@ Send::Send(core::LocalVariable recv, core::NameRef fun, core::Loc receiverLoc,
     histogramInc("cfg.send.args", this->args.size());
 }
 
-Literal::Literal(const core::TypePtr &value) : value(move(value)) {
+Literal::Literal(const core::TypePtr &value) : Instruction(Tag::Literal), value(move(value)) {
     categoryCounterInc("cfg", "literal");
 }
 
@@ -78,11 +79,11 @@ string Literal::toString(core::Context ctx) {
     return res;
 }
 
-Ident::Ident(core::LocalVariable what) : what(what) {
+Ident::Ident(core::LocalVariable what) : Instruction(Tag::Ident), what(what) {
     categoryCounterInc("cfg", "ident");
 }
 
-Alias::Alias(core::SymbolRef what) : what(what) {
+Alias::Alias(core::SymbolRef what) : Instruction(Tag::Alias), what(what) {
     categoryCounterInc("cfg", "alias");
 }
 
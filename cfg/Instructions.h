@@ -28,20 +28,63 @@ public:
 // implicitly numbered: result of every instruction can be uniquely referenced
 // by its position in a linear array.
 
+// The single list of concrete instruction kinds. The Tag enum and the InstructionToTag mapping are
+// both generated from it, so the two cannot drift apart when an instruction is added.
+#define SORBET_INSTRUCTIONS_LIST(X) \
+    X(Ident)                        \
+    X(Alias)                        \
+    X(SolveConstraint)              \
+    X(Send)                         \
+    X(Return)                       \
+    X(BlockReturn)                  \
+    X(LoadSelf)                     \
+    X(Literal)                      \
+    X(Unanalyzable)                 \
+    X(NotSupported)                 \
+    X(LoadArg)                      \
+    X(LoadYieldParams)              \
+    X(Cast)                         \
+    X(TAbsurd)
+
 // When adding a new subtype, see if you need to add it to fillInBlockArguments
 class Instruction {
 public:
+    // Runtime type tag of the concrete class of this instruction. Dispatching on the tag is much
+    // cheaper than RTTI, which matters because inference's processBinding loop discriminates on it
+    // for every instruction of every CFG.
+    enum class Tag : u1 {
+#define INSTRUCTION_TAG(I) I,
+        SORBET_INSTRUCTIONS_LIST(INSTRUCTION_TAG)
+#undef INSTRUCTION_TAG
+    };
+
     virtual ~Instruction() = default;
     virtual std::string toString(core::Context ctx) = 0;
-    Instruction() = default;
+    const Tag tag;
     bool isSynthetic = false;
+
+protected:
+    Instruction(Tag tag) : tag(tag) {}
 };
 
+// Maps each concrete instruction class to its Instruction::Tag; generated below, after the class
+// definitions.
+template <class To> struct InstructionToTag;
+
 template <class To> To *cast_instruction(Instruction *what) {
     static_assert(!std::is_pointer<To>::value, "To has to be a pointer");
     static_assert(std::is_assignable<Instruction *&, To *>::value,
                   "Ill Formed To, has to be a subclass of Instruction");
-    return fast_cast<Instruction, To>(what);
+    if constexpr (std::is_final<To>::value) {
+        if (what != nullptr && what->tag == InstructionToTag<To>::value) {
+            return static_cast<To *>(what);
+        }
+        return nullptr;
+    } else {
+        // Unanalyzable is the only non-final instruction class; casts to it are rare and never on
+        // a hot path, so RTTI is fine there.
+        return fast_cast<Instruction, To>(what);
+    }
 }
 
 template <class To> bool isa_instruction(Instruction *what) {
@@ -70,7 +113,8 @@ CheckSize(Alias, 16, 8);
 class SolveConstraint final : public Instruction {
 public:
     std::shared_ptr<core::SendAndBlockLink> link;
-    SolveConstraint(const std::shared_ptr<core::SendAndBlockLink> &link) : link(link){};
+    SolveConstraint(const std::shared_ptr<core::SendAndBlockLink> &link)
+        : Instruction(Tag::SolveConstraint), link(link){};
     virtual std::string toString(core::Context ctx);
 };
 CheckSize(SolveConstraint, 32, 8);
@@ -84,13 +128,26 @@ public:
     InlinedVector<core::Loc, 2> argLocs;
     std::shared_ptr<core::SendAndBlockLink> link;
 
+    struct InlineCache {
+        core::TypePtr receiverType;
+        InlinedVector<core::TypePtr, 2> argTypes;
+        core::TypePtr returnType;
+    };
+    // Last dispatch seen at this site; maintained by inference (Environment::processBinding).
+    // Keyed by pointer identity of the receiver and argument types (the entry pins them, so a
+    // recycled address can never alias a key) and only filled from blockless dispatches with no
+    // errors and no secondary component, so replaying a hit is observably identical. Fixpoint
+    // iteration re-dispatches every send in a loop body on each pass; this skips the re-dispatch
+    // when the incoming types have not changed.
+    std::unique_ptr<InlineCache> ic;
+
     Send(core::LocalVariable recv, core::NameRef fun, core::Loc receiverLoc,
          const InlinedVector<core::LocalVariable, 2> &args, InlinedVector<core::Loc, 2> argLocs,
          const std::shared_ptr<core::SendAndBlockLink> &link = nullptr);
 
     virtual std::string toString(core::Context ctx);
 };
-CheckSize(Send, 152, 8);
+CheckSize(Send, 160, 8);
 
 class Return final : public Instruction {
 public:
@@ -131,10 +188,15 @@ CheckSize(Literal, 32, 8);
 
 class Unanalyzable : public Instruction {
 public:
-    Unanalyzable() {
+    Unanalyzable() : Instruction(Tag::Unanalyzable) {
         categoryCounterInc("cfg", "unanalyzable");
     };
     virtual std::string toString(core::Context ctx);
+
+protected:
+    Unanalyzable(Tag tag) : Instruction(tag) {
+        categoryCounterInc("cfg", "unanalyzable");
+    };
 };
 CheckSize(Unanalyzable, 16, 8);
 
@@ -142,7 +204,7 @@ class NotSupported final : public Unanalyzable {
 public:
     std::string why;
 
-    NotSupported(std::string_view why) : why(why) {
+    NotSupported(std::string_view why) : Unanalyzable(Tag::NotSupported), why(why) {
         categoryCounterInc("cfg", "notsupported");
     };
     virtual std::string toString(core::Context ctx);
@@ -154,7 +216,7 @@ public:
     core::SymbolRef method;
     u2 argId;
 
-    LoadArg(core::SymbolRef method, int argId) : method(method), argId(argId) {
+    LoadArg(core::SymbolRef method, int argId) : Instruction(Tag::LoadArg), method(method), argId(argId) {
         categoryCounterInc("cfg", "loadarg");
     };
 
@@ -167,7 +229,8 @@ class LoadYieldParams final : public Instruction {
 public:
     std::shared_ptr<core::SendAndBlockLink> link;
 
-    LoadYieldParams(const std::shared_ptr<core::SendAndBlockLink> &link) : link(link) {
+    LoadYieldParams(const std::shared_ptr<core::SendAndBlockLink> &link)
+        : Instruction(Tag::LoadYieldParams), link(link) {
         categoryCounterInc("cfg", "loadarg");
     };
     virtual std::string toString(core::Context ctx);
@@ -181,7 +244,7 @@ public:
     core::NameRef cast;
 
     Cast(core::LocalVariable value, const core::TypePtr &type, core::NameRef cast)
-        : value(value), type(type), cast(cast) {}
+        : Instruction(Tag::Cast), value(value), type(type), cast(cast) {}
 
     virtual std::string toString(core::Context ctx);
 };
@@ -191,7 +254,7 @@ class TAbsurd final : public Instruction {
 public:
     VariableUseSite what;
 
-    TAbsurd(core::LocalVariable what) : what(what) {
+    TAbsurd(core::LocalVariable what) : Instruction(Tag::TAbsurd), what(what) {
         categoryCounterInc("cfg", "tabsurd");
     }
 
@@ -199,6 +262,13 @@ public:
 };
 CheckSize(TAbsurd, 40, 8);
 
+#define INSTRUCTION_TO_TAG(I)                                          \
+    template <> struct InstructionToTag<I> {                           \
+        static constexpr Instruction::Tag value = Instruction::Tag::I; \
+    };
+SORBET_INSTRUCTIONS_LIST(INSTRUCTION_TO_TAG)
+#undef INSTRUCTION_TO_TAG
+
 } // namespace sorbet::cfg
 
 #endif // SORBET_CFG_H
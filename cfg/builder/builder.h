@@ -19,9 +19,10 @@ private:
     static void computeMinMaxLoops(core::Context ctx, const CFG::ReadsAndWrites &RnW, CFG &cfg);
     static void removeDeadAssigns(core::Context ctx, const CFG::ReadsAndWrites &RnW, CFG &cfg);
     static void markLoopHeaders(core::Context ctx, CFG &cfg);
+    static void markSingleUseTemps(core::Context ctx, CFG &cfg);
     static int topoSortFwd(std::vector<BasicBlock *> &target, int nextFree, BasicBlock *currentBB);
     static void synthesizeExpr(BasicBlock *bb, core::LocalVariable var, core::Loc loc,
-                               std::unique_ptr<Instruction> inst);
+                               Instruction *inst);
 };
 
 class CFGContext {
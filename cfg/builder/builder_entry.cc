@@ -31,29 +31,29 @@ unique_ptr<CFG> CFGBuilder::buildFor(core::Context ctx, ast::MethodDef &md) {
         selfClaz = md.symbol;
     }
     synthesizeExpr(entry, core::LocalVariable::selfVariable(), md.loc,
-                   make_unique<Cast>(core::LocalVariable::selfVariable(),
+                   res->arena.make<Cast>(core::LocalVariable::selfVariable(),
                                      selfClaz.data(ctx)->enclosingClass(ctx).data(ctx)->selfType(ctx),
                                      core::Names::cast()));
     int i = -1;
     for (auto &argExpr : md.args) {
         i++;
         auto *a = ast::MK::arg2Local(argExpr.get());
-        synthesizeExpr(entry, a->localVariable, a->loc, make_unique<LoadArg>(md.symbol, i));
+        synthesizeExpr(entry, a->localVariable, a->loc, res->arena.make<LoadArg>(md.symbol, i));
     }
     auto cont = walk(cctx.withTarget(retSym), md.rhs.get(), entry);
     core::LocalVariable retSym1(core::Names::finalReturn(), 0);
 
-    auto rvLoc = cont->exprs.empty() || isa_instruction<LoadArg>(cont->exprs.back().value.get())
+    auto rvLoc = cont->exprs.empty() || isa_instruction<LoadArg>(cont->exprs.back().value)
                      ? md.loc
                      : cont->exprs.back().loc;
-    synthesizeExpr(cont, retSym1, rvLoc, make_unique<Return>(retSym)); // dead assign.
+    synthesizeExpr(cont, retSym1, rvLoc, res->arena.make<Return>(retSym)); // dead assign.
     jumpToDead(cont, *res.get(), rvLoc);
 
     vector<Binding> aliasesPrefix;
     for (auto kv : aliases) {
         core::SymbolRef global = kv.first;
         core::LocalVariable local = kv.second;
-        aliasesPrefix.emplace_back(local, global.data(ctx)->loc(), make_unique<Alias>(global));
+        aliasesPrefix.emplace_back(local, global.data(ctx)->loc(), res->arena.make<Alias>(global));
         if (global.data(ctx)->isField() || global.data(ctx)->isStaticField()) {
             res->minLoops[local] = CFG::MIN_LOOP_FIELD;
         } else {
@@ -62,7 +62,7 @@ unique_ptr<CFG> CFGBuilder::buildFor(core::Context ctx, ast::MethodDef &md) {
     }
     for (auto kv : discoveredUndeclaredFields) {
         aliasesPrefix.emplace_back(kv.second, core::Loc::none(),
-                                   make_unique<Alias>(core::Symbols::Magic_undeclaredFieldStub()));
+                                   res->arena.make<Alias>(core::Symbols::Magic_undeclaredFieldStub()));
         res->minLoops[kv.second] = CFG::MIN_LOOP_FIELD;
     }
     histogramInc("cfgbuilder.aliases", aliasesPrefix.size());
@@ -84,6 +84,7 @@ unique_ptr<CFG> CFGBuilder::buildFor(core::Context ctx, ast::MethodDef &md) {
     simplify(ctx, *res);
     histogramInc("cfgbuilder.basicBlocksSimplified", basicBlockCreated - res->basicBlocks.size());
     markLoopHeaders(ctx, *res);
+    markSingleUseTemps(ctx, *res); // requires the final block structure, so it runs after simplify
     sanityCheck(ctx, *res);
     res->sanityCheck(ctx);
     return res;
@@ -103,10 +104,10 @@ void CFGBuilder::fillInTopoSorts(core::Context ctx, CFG &cfg) {
             }
 
             bb->bexit.thenb->backEdges.erase(
-                remove(bb->bexit.thenb->backEdges.begin(), bb->bexit.thenb->backEdges.end(), bb.get()),
+                remove(bb->bexit.thenb->backEdges.begin(), bb->bexit.thenb->backEdges.end(), bb),
                 bb->bexit.thenb->backEdges.end());
             bb->bexit.elseb->backEdges.erase(
-                remove(bb->bexit.elseb->backEdges.begin(), bb->bexit.elseb->backEdges.end(), bb.get()),
+                remove(bb->bexit.elseb->backEdges.begin(), bb->bexit.elseb->backEdges.end(), bb),
                 bb->bexit.elseb->backEdges.end());
         }
     }
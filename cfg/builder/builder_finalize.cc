@@ -17,7 +17,7 @@ void CFGBuilder::simplify(core::Context ctx, CFG &cfg) {
     while (changed) {
         changed = false;
         for (auto it = cfg.basicBlocks.begin(); it != cfg.basicBlocks.end(); /*nothing*/) {
-            BasicBlock *bb = it->get();
+            BasicBlock *bb = *it;
             auto *const thenb = bb->bexit.thenb;
             auto *const elseb = bb->bexit.elseb;
             if (bb != cfg.deadBlock() && bb != cfg.entry()) {
@@ -111,17 +111,16 @@ void CFGBuilder::sanityCheck(core::Context ctx, CFG &cfg) {
     }
     for (auto &bb : cfg.basicBlocks) {
         for (auto parent : bb->backEdges) {
-            ENFORCE(parent->bexit.thenb == bb.get() || parent->bexit.elseb == bb.get(),
-                    "parent is not aware of a child");
+            ENFORCE(parent->bexit.thenb == bb || parent->bexit.elseb == bb, "parent is not aware of a child");
         }
-        if (bb.get() == cfg.deadBlock()) {
+        if (bb == cfg.deadBlock()) {
             continue;
         }
-        if (bb.get() != cfg.entry()) {
+        if (bb != cfg.entry()) {
             ENFORCE((bb->flags & CFG::WAS_JUMP_DESTINATION) != 0, "block {} was never linked into cfg", bb->id);
         }
-        auto thenFnd = absl::c_find(bb->bexit.thenb->backEdges, bb.get());
-        auto elseFnd = absl::c_find(bb->bexit.elseb->backEdges, bb.get());
+        auto thenFnd = absl::c_find(bb->bexit.thenb->backEdges, bb);
+        auto elseFnd = absl::c_find(bb->bexit.elseb->backEdges, bb);
         ENFORCE(thenFnd != bb->bexit.thenb->backEdges.end(), "backedge unset for thenb");
         ENFORCE(elseFnd != bb->bexit.elseb->backEdges.end(), "backedge unset for elseb");
     }
@@ -177,7 +176,7 @@ void CFGBuilder::dealias(core::Context ctx, CFG &cfg) {
         }
 
         for (Binding &bind : bb->exprs) {
-            if (auto *i = cast_instruction<Ident>(bind.value.get())) {
+            if (auto *i = cast_instruction<Ident>(bind.value)) {
                 i->what = maybeDealias(ctx, i->what, current);
             }
             /* invalidate a stale record */
@@ -192,22 +191,22 @@ void CFGBuilder::dealias(core::Context ctx, CFG &cfg) {
             if (!bind.value->isSynthetic) {
                 // we don't allow dealiasing values into synthetic instructions
                 // as otherwise it fools dead code analysis.
-                if (auto *v = cast_instruction<Ident>(bind.value.get())) {
+                if (auto *v = cast_instruction<Ident>(bind.value)) {
                     v->what = maybeDealias(ctx, v->what, current);
-                } else if (auto *v = cast_instruction<Send>(bind.value.get())) {
+                } else if (auto *v = cast_instruction<Send>(bind.value)) {
                     v->recv = maybeDealias(ctx, v->recv.variable, current);
                     for (auto &arg : v->args) {
                         arg = maybeDealias(ctx, arg.variable, current);
                     }
-                } else if (auto *v = cast_instruction<TAbsurd>(bind.value.get())) {
+                } else if (auto *v = cast_instruction<TAbsurd>(bind.value)) {
                     v->what = maybeDealias(ctx, v->what.variable, current);
-                } else if (auto *v = cast_instruction<Return>(bind.value.get())) {
+                } else if (auto *v = cast_instruction<Return>(bind.value)) {
                     v->what = maybeDealias(ctx, v->what.variable, current);
                 }
             }
 
             // record new aliases
-            if (auto *i = cast_instruction<Ident>(bind.value.get())) {
+            if (auto *i = cast_instruction<Ident>(bind.value)) {
                 current[bind.bind.variable] = i->what;
             }
         }
@@ -218,7 +217,7 @@ void CFGBuilder::dealias(core::Context ctx, CFG &cfg) {
 }
 
 void CFGBuilder::markLoopHeaders(core::Context ctx, CFG &cfg) {
-    for (unique_ptr<BasicBlock> &bb : cfg.basicBlocks) {
+    for (BasicBlock *bb : cfg.basicBlocks) {
         for (auto *parent : bb->backEdges) {
             if (parent->outerLoops < bb->outerLoops) {
                 bb->flags |= CFG::LOOP_HEADER;
@@ -227,6 +226,85 @@ void CFGBuilder::markLoopHeaders(core::Context ctx, CFG &cfg) {
         }
     }
 }
+void CFGBuilder::markSingleUseTemps(core::Context ctx, CFG &cfg) {
+    if (!ctx.state.lspQuery.isEmpty()) {
+        return;
+    }
+
+    struct Usage {
+        int writes = 0;
+        int reads = 0;
+        int blockId = -1;
+        bool escapes = false;
+    };
+    UnorderedMap<core::LocalVariable, Usage> usages;
+    auto trackWrite = [&](core::LocalVariable what, int blockId) {
+        if (!what.isSyntheticTemporary(ctx)) {
+            return;
+        }
+        auto &usage = usages[what];
+        usage.writes++;
+        if (usage.blockId == -1) {
+            usage.blockId = blockId;
+        } else if (usage.blockId != blockId) {
+            usage.escapes = true;
+        }
+    };
+    auto trackRead = [&](core::LocalVariable what, int blockId) {
+        if (!what.isSyntheticTemporary(ctx)) {
+            return;
+        }
+        auto &usage = usages[what];
+        usage.reads++;
+        if (usage.blockId == -1) {
+            usage.blockId = blockId;
+        } else if (usage.blockId != blockId) {
+            usage.escapes = true;
+        }
+    };
+
+    // The operand cases mirror CFG::findAllReadsAndWrites; instructions absent from both read no
+    // variables.
+    for (BasicBlock *bb : cfg.basicBlocks) {
+        for (const auto &arg : bb->args) {
+            if (arg.variable.isSyntheticTemporary(ctx)) {
+                usages[arg.variable].escapes = true;
+            }
+        }
+        if (bb->bexit.cond.variable.exists() && bb->bexit.cond.variable.isSyntheticTemporary(ctx)) {
+            usages[bb->bexit.cond.variable].escapes = true;
+        }
+        for (Binding &bind : bb->exprs) {
+            trackWrite(bind.bind.variable, bb->id);
+            if (auto *v = cast_instruction<Ident>(bind.value)) {
+                trackRead(v->what, bb->id);
+            } else if (auto *v = cast_instruction<Send>(bind.value)) {
+                trackRead(v->recv.variable, bb->id);
+                for (auto &arg : v->args) {
+                    trackRead(arg.variable, bb->id);
+                }
+            } else if (auto *v = cast_instruction<TAbsurd>(bind.value)) {
+                trackRead(v->what.variable, bb->id);
+            } else if (auto *v = cast_instruction<Return>(bind.value)) {
+                trackRead(v->what.variable, bb->id);
+            } else if (auto *v = cast_instruction<BlockReturn>(bind.value)) {
+                trackRead(v->what.variable, bb->id);
+            } else if (auto *v = cast_instruction<Cast>(bind.value)) {
+                trackRead(v->value.variable, bb->id);
+            } else if (auto *v = cast_instruction<LoadSelf>(bind.value)) {
+                trackRead(v->fallback, bb->id);
+            }
+        }
+    }
+
+    for (const auto &[local, usage] : usages) {
+        if (!usage.escapes && usage.writes == 1 && usage.reads == 1) {
+            cfg.singleUseTemps.insert(local);
+        }
+    }
+    histogramInc("cfgbuilder.singleUseTemps", cfg.singleUseTemps.size());
+}
+
 void CFGBuilder::removeDeadAssigns(core::Context ctx, const CFG::ReadsAndWrites &RnW, CFG &cfg) {
     if (!ctx.state.lspQuery.isEmpty()) {
         return;
@@ -265,9 +343,9 @@ void CFGBuilder::removeDeadAssigns(core::Context ctx, const CFG::ReadsAndWrites
                 // shorter to list the converse set -- those which *do* have
                 // side effects -- but doing it this way is more robust to us
                 // adding more instruction types in the future.
-                if (isa_instruction<Ident>(bind.value.get()) || isa_instruction<Literal>(bind.value.get()) ||
-                    isa_instruction<LoadSelf>(bind.value.get()) || isa_instruction<LoadArg>(bind.value.get()) ||
-                    isa_instruction<LoadYieldParams>(bind.value.get())) {
+                if (isa_instruction<Ident>(bind.value) || isa_instruction<Literal>(bind.value) ||
+                    isa_instruction<LoadSelf>(bind.value) || isa_instruction<LoadArg>(bind.value) ||
+                    isa_instruction<LoadYieldParams>(bind.value)) {
                     expIt = it->exprs.erase(expIt);
                 } else {
                     ++expIt;
@@ -102,8 +102,8 @@ core::LocalVariable unresolvedIdent2Local(CFGContext cctx, ast::UnresolvedIdent
     }
 }
 
-void CFGBuilder::synthesizeExpr(BasicBlock *bb, core::LocalVariable var, core::Loc loc, unique_ptr<Instruction> inst) {
-    auto &inserted = bb->exprs.emplace_back(var, loc, move(inst));
+void CFGBuilder::synthesizeExpr(BasicBlock *bb, core::LocalVariable var, core::Loc loc, Instruction *inst) {
+    auto &inserted = bb->exprs.emplace_back(var, loc, inst);
     inserted.value->isSynthetic = true;
 }
 
@@ -144,7 +144,7 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                                  a->body.get(), bodyBlock);
                 unconditionalJump(body, headerBlock, cctx.inWhat, a->loc);
 
-                synthesizeExpr(breakNotCalledBlock, cctx.target, a->loc, make_unique<Literal>(core::Types::nilClass()));
+                synthesizeExpr(breakNotCalledBlock, cctx.target, a->loc, cctx.inWhat.arena.make<Literal>(core::Types::nilClass()));
                 unconditionalJump(breakNotCalledBlock, continueBlock, cctx.inWhat, a->loc);
                 ret = continueBlock;
 
@@ -171,7 +171,7 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
             [&](ast::Return *a) {
                 core::LocalVariable retSym = cctx.newTemporary(core::Names::returnTemp());
                 auto cont = walk(cctx.withTarget(retSym), a->expr.get(), current);
-                cont->exprs.emplace_back(cctx.target, a->loc, make_unique<Return>(retSym)); // dead assign.
+                cont->exprs.emplace_back(cctx.target, a->loc, cctx.inWhat.arena.make<Return>(retSym)); // dead assign.
                 jumpToDead(cont, cctx.inWhat, a->loc);
                 ret = cctx.inWhat.deadBlock();
             },
@@ -200,19 +200,19 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                 }
             },
             [&](ast::Literal *a) {
-                current->exprs.emplace_back(cctx.target, a->loc, make_unique<Literal>(a->value));
+                current->exprs.emplace_back(cctx.target, a->loc, cctx.inWhat.arena.make<Literal>(a->value));
                 ret = current;
             },
             [&](ast::UnresolvedIdent *id) {
                 core::LocalVariable loc = unresolvedIdent2Local(cctx, id);
                 ENFORCE(loc.exists());
-                current->exprs.emplace_back(cctx.target, id->loc, make_unique<Ident>(loc));
+                current->exprs.emplace_back(cctx.target, id->loc, cctx.inWhat.arena.make<Ident>(loc));
 
                 ret = current;
             },
             [&](ast::UnresolvedConstantLit *a) { Exception::raise("Should have been eliminated by namer/resolver"); },
             [&](ast::Field *a) {
-                current->exprs.emplace_back(cctx.target, a->loc, make_unique<Ident>(global2Local(cctx, a->symbol)));
+                current->exprs.emplace_back(cctx.target, a->loc, cctx.inWhat.arena.make<Ident>(global2Local(cctx, a->symbol)));
                 ret = current;
             },
             [&](ast::ConstantLit *a) {
@@ -224,14 +224,14 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                 }
 
                 if (a->symbol == core::Symbols::StubModule()) {
-                    current->exprs.emplace_back(cctx.target, a->loc, make_unique<Alias>(core::Symbols::untyped()));
+                    current->exprs.emplace_back(cctx.target, a->loc, cctx.inWhat.arena.make<Alias>(core::Symbols::untyped()));
                 } else {
-                    current->exprs.emplace_back(cctx.target, a->loc, make_unique<Alias>(a->symbol));
+                    current->exprs.emplace_back(cctx.target, a->loc, cctx.inWhat.arena.make<Alias>(a->symbol));
                 }
                 ret = current;
             },
             [&](ast::Local *a) {
-                current->exprs.emplace_back(cctx.target, a->loc, make_unique<Ident>(a->localVariable));
+                current->exprs.emplace_back(cctx.target, a->loc, cctx.inWhat.arena.make<Ident>(a->localVariable));
                 ret = current;
             },
             [&](ast::Assign *a) {
@@ -250,7 +250,7 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                 }
 
                 auto rhsCont = walk(cctx.withTarget(lhs), a->rhs.get(), current);
-                rhsCont->exprs.emplace_back(cctx.target, a->loc, make_unique<Ident>(lhs));
+                rhsCont->exprs.emplace_back(cctx.target, a->loc, cctx.inWhat.arena.make<Ident>(lhs));
                 ret = rhsCont;
             },
             [&](ast::InsSeq *a) {
@@ -269,7 +269,7 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                             if (s->args.size() == 1) {
                                 auto temp = cctx.newTemporary(core::Names::statTemp());
                                 current = walk(cctx.withTarget(temp), s->args[0].get(), current);
-                                current->exprs.emplace_back(cctx.target, s->loc, make_unique<TAbsurd>(temp));
+                                current->exprs.emplace_back(cctx.target, s->loc, cctx.inWhat.arena.make<TAbsurd>(temp));
                             } else {
                                 if (auto e = cctx.ctx.state.beginError(s->loc, core::errors::CFG::MalformedTAbsurd)) {
                                     e.setHeader("`{}` expects exactly one argument but got `{}`", "T.absurd",
@@ -308,13 +308,13 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                         target.isShadow = e.shadow;
                     }
                     auto link = make_shared<core::SendAndBlockLink>(s->fun, move(argFlags));
-                    auto send = make_unique<Send>(recv, s->fun, s->recv->loc, args, argLocs, link);
-                    auto solveConstraint = make_unique<SolveConstraint>(link);
+                    auto send = cctx.inWhat.arena.make<Send>(recv, s->fun, s->recv->loc, args, argLocs, link);
+                    auto solveConstraint = cctx.inWhat.arena.make<SolveConstraint>(link);
                     core::LocalVariable sendTemp = cctx.newTemporary(core::Names::blockPreCallTemp());
                     current->exprs.emplace_back(sendTemp, s->loc, move(send));
                     core::LocalVariable restoreSelf = cctx.newTemporary(core::Names::selfRestore());
                     synthesizeExpr(current, restoreSelf, core::Loc::none(),
-                                   make_unique<Ident>(core::LocalVariable::selfVariable()));
+                                   cctx.inWhat.arena.make<Ident>(core::LocalVariable::selfVariable()));
 
                     auto headerBlock = cctx.inWhat.freshBlock(cctx.loops + 1);
                     // solveConstraintBlock is only entered if break is not called
@@ -326,8 +326,8 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                     core::LocalVariable argTemp = cctx.newTemporary(core::Names::blkArg());
                     core::LocalVariable idxTmp = cctx.newTemporary(core::Names::blkArg());
                     bodyBlock->exprs.emplace_back(core::LocalVariable::selfVariable(), s->loc,
-                                                  make_unique<LoadSelf>(link, core::LocalVariable::selfVariable()));
-                    bodyBlock->exprs.emplace_back(argTemp, s->block->loc, make_unique<LoadYieldParams>(link));
+                                                  cctx.inWhat.arena.make<LoadSelf>(link, core::LocalVariable::selfVariable()));
+                    bodyBlock->exprs.emplace_back(argTemp, s->block->loc, cctx.inWhat.arena.make<LoadYieldParams>(link));
 
                     for (int i = 0; i < blockArgs.size(); ++i) {
                         auto &arg = blockArgs[i];
@@ -338,9 +338,9 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                                 // Mixing positional and rest args in blocks is
                                 // not currently supported; drop in an untyped.
                                 bodyBlock->exprs.emplace_back(argLoc, arg.loc,
-                                                              make_unique<Alias>(core::Symbols::untyped()));
+                                                              cctx.inWhat.arena.make<Alias>(core::Symbols::untyped()));
                             } else {
-                                bodyBlock->exprs.emplace_back(argLoc, arg.loc, make_unique<Ident>(argTemp));
+                                bodyBlock->exprs.emplace_back(argLoc, arg.loc, cctx.inWhat.arena.make<Ident>(argTemp));
                             }
                             continue;
                         }
@@ -350,12 +350,12 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                         core::Loc zeroLengthLoc = arg.loc.copyWithZeroLength();
                         bodyBlock->exprs.emplace_back(
                             idxTmp, zeroLengthLoc,
-                            make_unique<Literal>(core::make_type<core::LiteralType>(int64_t(i))));
+                            cctx.inWhat.arena.make<Literal>(core::make_type<core::LiteralType>(int64_t(i))));
                         InlinedVector<core::LocalVariable, 2> idxVec{idxTmp};
                         InlinedVector<core::Loc, 2> locs{zeroLengthLoc};
                         bodyBlock->exprs.emplace_back(
                             argLoc, arg.loc,
-                            make_unique<Send>(argTemp, core::Names::squareBrackets(), s->block->loc, idxVec, locs));
+                            cctx.inWhat.arena.make<Send>(argTemp, core::Names::squareBrackets(), s->block->loc, idxVec, locs));
                     }
 
                     conditionalJump(headerBlock, core::LocalVariable::blockCall(), bodyBlock, solveConstraintBlock,
@@ -371,7 +371,7 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                                           s->block->body.get(), bodyBlock);
                     if (blockLast != cctx.inWhat.deadBlock()) {
                         core::LocalVariable dead = cctx.newTemporary(core::Names::blockReturnTemp());
-                        synthesizeExpr(blockLast, dead, s->block->loc, make_unique<BlockReturn>(link, blockrv));
+                        synthesizeExpr(blockLast, dead, s->block->loc, cctx.inWhat.arena.make<BlockReturn>(link, blockrv));
                     }
 
                     unconditionalJump(blockLast, headerBlock, cctx.inWhat, s->loc);
@@ -380,7 +380,7 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                     solveConstraintBlock->exprs.emplace_back(cctx.target, s->loc, move(solveConstraint));
                     current = postBlock;
                     synthesizeExpr(current, core::LocalVariable::selfVariable(), s->loc,
-                                   make_unique<Ident>(restoreSelf));
+                                   cctx.inWhat.arena.make<Ident>(restoreSelf));
 
                     /*
                      * This code:
@@ -403,7 +403,7 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                      */
                 } else {
                     current->exprs.emplace_back(cctx.target, s->loc,
-                                                make_unique<Send>(recv, s->fun, s->recv->loc, args, argLocs));
+                                                cctx.inWhat.arena.make<Send>(recv, s->fun, s->recv->loc, args, argLocs));
                 }
 
                 ret = current;
@@ -417,7 +417,7 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                 if (afterNext != cctx.inWhat.deadBlock() && cctx.isInsideRubyBlock) {
                     core::LocalVariable dead = cctx.newTemporary(core::Names::nextTemp());
                     ENFORCE(cctx.link.get() != nullptr);
-                    afterNext->exprs.emplace_back(dead, a->loc, make_unique<BlockReturn>(cctx.link, exprSym));
+                    afterNext->exprs.emplace_back(dead, a->loc, cctx.inWhat.arena.make<BlockReturn>(cctx.link, exprSym));
                 }
 
                 if (cctx.nextScope == nullptr) {
@@ -450,8 +450,8 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
 
                 // This is a temporary hack until we change how pining works to handle this case.
                 auto blockBreakAssign = cctx.newTemporary(core::Names::blockBreakAssign());
-                afterBreak->exprs.emplace_back(blockBreakAssign, a->loc, make_unique<Ident>(exprSym));
-                afterBreak->exprs.emplace_back(cctx.blockBreakTarget, a->loc, make_unique<Ident>(blockBreakAssign));
+                afterBreak->exprs.emplace_back(blockBreakAssign, a->loc, cctx.inWhat.arena.make<Ident>(exprSym));
+                afterBreak->exprs.emplace_back(cctx.blockBreakTarget, a->loc, cctx.inWhat.arena.make<Ident>(blockBreakAssign));
 
                 if (cctx.breakScope == nullptr) {
                     if (auto e = cctx.ctx.state.beginError(a->loc, core::errors::CFG::NoNextScope)) {
@@ -494,7 +494,7 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                 auto rescueHandlersBlock = cctx.inWhat.freshBlock(cctx.loops);
                 auto bodyBlock = cctx.inWhat.freshBlock(cctx.loops);
                 auto rescueStartTemp = cctx.newTemporary(core::Names::rescueStartTemp());
-                synthesizeExpr(rescueStartBlock, rescueStartTemp, what->loc, make_unique<Unanalyzable>());
+                synthesizeExpr(rescueStartBlock, rescueStartTemp, what->loc, cctx.inWhat.arena.make<Unanalyzable>());
                 conditionalJump(rescueStartBlock, rescueStartTemp, rescueHandlersBlock, bodyBlock, cctx.inWhat, a->loc);
 
                 // cctx.loops += 1; // should formally be here but this makes us report a lot of false errors
@@ -508,7 +508,7 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                 auto shouldEnsureBlock = cctx.inWhat.freshBlock(cctx.loops);
                 unconditionalJump(elseBody, shouldEnsureBlock, cctx.inWhat, a->loc);
                 auto rescueEndTemp = cctx.newTemporary(core::Names::rescueEndTemp());
-                synthesizeExpr(shouldEnsureBlock, rescueEndTemp, what->loc, make_unique<Unanalyzable>());
+                synthesizeExpr(shouldEnsureBlock, rescueEndTemp, what->loc, cctx.inWhat.arena.make<Unanalyzable>());
                 conditionalJump(shouldEnsureBlock, rescueEndTemp, rescueHandlersBlock, ensureBody, cctx.inWhat, a->loc);
 
                 for (auto &rescueCase : a->rescueCases) {
@@ -518,7 +518,7 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                     auto *local = ast::cast_tree<ast::Local>(rescueCase->var.get());
                     ENFORCE(local != nullptr, "rescue case var not a local?");
                     rescueHandlersBlock->exprs.emplace_back(local->localVariable, rescueCase->var->loc,
-                                                            make_unique<Unanalyzable>());
+                                                            cctx.inWhat.arena.make<Unanalyzable>());
 
                     if (exceptions.empty()) {
                         // rescue without a class catches StandardError
@@ -538,7 +538,7 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
 
                         rescueHandlersBlock->exprs.emplace_back(
                             isaCheck, loc,
-                            make_unique<Send>(local->localVariable, core::Names::is_a_p(), loc, args, argLocs));
+                            cctx.inWhat.arena.make<Send>(local->localVariable, core::Names::is_a_p(), loc, args, argLocs));
 
                         auto otherHandlerBlock = cctx.inWhat.freshBlock(cctx.loops);
                         conditionalJump(rescueHandlersBlock, isaCheck, caseBody, otherHandlerBlock, cctx.inWhat, loc);
@@ -557,7 +557,7 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                 // since in Ruby the exception would propagate up the statck.
                 auto gotoDeadTemp = cctx.newTemporary(core::Names::gotoDeadTemp());
                 synthesizeExpr(rescueHandlersBlock, gotoDeadTemp, a->loc,
-                               make_unique<Literal>(core::make_type<core::LiteralType>(true)));
+                               cctx.inWhat.arena.make<Literal>(core::make_type<core::LiteralType>(true)));
                 unconditionalJump(rescueHandlersBlock, ensureBody, cctx.inWhat, a->loc);
 
                 auto throwAway = cctx.newTemporary(core::Names::throwAwayTemp());
@@ -580,10 +580,10 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                     locs.emplace_back(h->values[i]->loc);
                 }
                 core::LocalVariable magic = cctx.newTemporary(core::Names::magic());
-                synthesizeExpr(current, magic, core::Loc::none(), make_unique<Alias>(core::Symbols::Magic()));
+                synthesizeExpr(current, magic, core::Loc::none(), cctx.inWhat.arena.make<Alias>(core::Symbols::Magic()));
 
                 current->exprs.emplace_back(cctx.target, h->loc,
-                                            make_unique<Send>(magic, core::Names::buildHash(), h->loc, vars, locs));
+                                            cctx.inWhat.arena.make<Send>(magic, core::Names::buildHash(), h->loc, vars, locs));
                 ret = current;
             },
 
@@ -597,16 +597,16 @@ BasicBlock *CFGBuilder::walk(CFGContext cctx, ast::Expression *what, BasicBlock
                     locs.emplace_back(a->loc);
                 }
                 core::LocalVariable magic = cctx.newTemporary(core::Names::magic());
-                synthesizeExpr(current, magic, core::Loc::none(), make_unique<Alias>(core::Symbols::Magic()));
+                synthesizeExpr(current, magic, core::Loc::none(), cctx.inWhat.arena.make<Alias>(core::Symbols::Magic()));
                 current->exprs.emplace_back(cctx.target, a->loc,
-                                            make_unique<Send>(magic, core::Names::buildArray(), a->loc, vars, locs));
+                                            cctx.inWhat.arena.make<Send>(magic, core::Names::buildArray(), a->loc, vars, locs));
                 ret = current;
             },
 
             [&](ast::Cast *c) {
                 core::LocalVariable tmp = cctx.newTemporary(core::Names::castTemp());
                 current = walk(cctx.withTarget(tmp), c->arg.get(), current);
-                current->exprs.emplace_back(cctx.target, c->loc, make_unique<Cast>(tmp, c->type, c->cast));
+                current->exprs.emplace_back(cctx.target, c->loc, cctx.inWhat.arena.make<Cast>(tmp, c->type, c->cast));
                 if (c->cast == core::Names::let()) {
                     cctx.inWhat.minLoops[cctx.target] = CFG::MIN_LOOP_LET;
                 }
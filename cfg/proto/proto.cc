@@ -25,7 +25,7 @@ com::stripe::rubytyper::LocalVariable Proto::toProto(const core::GlobalState &gs
 InlinedVector<com::stripe::rubytyper::Binding, 1> Proto::toProto(const core::GlobalState &gs, const Binding &bnd) {
     InlinedVector<com::stripe::rubytyper::Binding, 1> protos;
     typecase(
-        bnd.value.get(),
+        bnd.value,
         [&](const Ident *i) {
             protos.emplace_back();
             *protos.back().mutable_bind() = toProto(gs, bnd.bind);
@@ -73,7 +73,7 @@ InlinedVector<com::stripe::rubytyper::Binding, 1> Proto::toProto(const core::Glo
             com::stripe::rubytyper::LocalVariable local;
             local.set_unique_name(core::Names::tConstTemp().show(gs));
             *local.mutable_type() = core::Proto::toProto(
-                gs, core::make_type<core::ClassType>(core::Symbols::T().data(gs)->lookupSingletonClass(gs)));
+                gs, core::Types::classType(core::Symbols::T().data(gs)->lookupSingletonClass(gs)));
             *aliasBinding.mutable_bind() = local;
 
             com::stripe::rubytyper::Instruction alias;
@@ -0,0 +1,59 @@
+#include "common/ArenaStats.h"
+#include "common/Counters.h"
+#include "common/common.h"
+
+#include <atomic>
+
+using namespace std;
+
+namespace sorbet {
+
+namespace {
+// Relaxed is enough: the tallies are monotonic sums read at quiescent points (cycle boundaries,
+// process exit), never used to order anything.
+atomic<size_t> liveBytes{0};
+atomic<size_t> highWaterBytes{0};
+} // namespace
+
+void ArenaStats::blockAllocated(size_t bytes) {
+    auto live = liveBytes.fetch_add(bytes, memory_order_relaxed) + bytes;
+    auto highWater = highWaterBytes.load(memory_order_relaxed);
+    while (live > highWater && !highWaterBytes.compare_exchange_weak(highWater, live, memory_order_relaxed)) {
+    }
+}
+
+void ArenaStats::arenaFreed(Kind kind, size_t allocatedBytes, size_t blockBytes, size_t blocks) {
+    liveBytes.fetch_sub(blockBytes, memory_order_relaxed);
+    switch (kind) {
+        case Kind::Node:
+            prodCounterAdd("memory.node_arena.freed_bytes", allocatedBytes);
+            prodCounterAdd("memory.node_arena.blocks", blocks);
+            break;
+        case Kind::Expression:
+            prodCounterAdd("memory.expression_arena.freed_bytes", allocatedBytes);
+            prodCounterAdd("memory.expression_arena.blocks", blocks);
+            break;
+        case Kind::Cfg:
+            prodCounterAdd("memory.cfg_arena.freed_bytes", allocatedBytes);
+            prodCounterAdd("memory.cfg_arena.blocks", blocks);
+            break;
+        case Kind::Scratch:
+            prodCounterAdd("memory.scratch_arena.freed_bytes", allocatedBytes);
+            prodCounterAdd("memory.scratch_arena.blocks", blocks);
+            break;
+    }
+}
+
+size_t ArenaStats::liveBlockBytes() {
+    return liveBytes.load(memory_order_relaxed);
+}
+
+void ArenaStats::submitHighWater() {
+    prodCounterAdd("memory.arena.high_water_bytes", highWaterBytes.load(memory_order_relaxed));
+}
+
+void ArenaStats::enforceAllFreed() {
+    ENFORCE(liveBlockBytes() == 0, "arena blocks leaked across a cycle: {} bytes still live", liveBlockBytes());
+}
+
+} // namespace sorbet
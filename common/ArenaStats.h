@@ -0,0 +1,44 @@
+#ifndef SORBET_COMMON_ARENA_STATS_H
+#define SORBET_COMMON_ARENA_STATS_H
+
+#include <cstddef>
+
+namespace sorbet {
+
+// Central tally for the bump allocators (parser::NodeArena, ast::ExpressionArena, cfg::CFGArena,
+// MonotonicArena). Each arena reports the blocks it maps while it lives and everything it held
+// when it dies; the registry turns the teardown reports into per-arena Counters
+// (`memory.<arena>.freed_bytes` / `memory.<arena>.blocks`) and keeps a process-wide live-byte
+// tally with a high-water mark (`memory.arena.high_water_bytes`, submitted at process exit).
+//
+// The live tally also backs a debug-build drift check: between LSP edit cycles every arena should
+// be dead, so `enforceAllFreed` catches scopes that leak out of their window before the leak
+// compounds over a session. All tallies are relaxed atomics; the cost per mapped block is two
+// atomic adds, which is noise next to the allocation itself.
+class ArenaStats final {
+public:
+    // Which arena is reporting; selects the counter prefix.
+    enum class Kind { Node, Expression, Cfg, Scratch };
+
+    // An arena mapped a fresh block of `bytes` from the heap.
+    static void blockAllocated(size_t bytes);
+
+    // An arena died, returning its blocks wholesale. `allocatedBytes` is what it handed out to
+    // callers, `blockBytes` what it mapped for them; the difference is padding and slack at block
+    // tails.
+    static void arenaFreed(Kind kind, size_t allocatedBytes, size_t blockBytes, size_t blocks);
+
+    // Bytes currently held in live arena blocks, across all threads.
+    static size_t liveBlockBytes();
+
+    // Submits the process-wide high-water mark; call once, when counters are collected at exit.
+    static void submitHighWater();
+
+    // Debug-build check that no arena outlived its window; a nonzero live tally at a point where
+    // every phase has completed means blocks are drifting across cycles.
+    static void enforceAllFreed();
+};
+
+} // namespace sorbet
+
+#endif // SORBET_COMMON_ARENA_STATS_H
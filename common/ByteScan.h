@@ -0,0 +1,136 @@
+#ifndef SORBET_BYTESCAN_H
+#define SORBET_BYTESCAN_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace sorbet::bytescan {
+
+/**
+ * Vectorized byte scans for the hot per-byte loops that run over every file on load (line break
+ * tables, content validation). On x86 these process 16 bytes per step via SSE2; elsewhere a plain
+ * scalar loop is used. Both paths produce identical results.
+ */
+
+/** Appends the offset of every occurrence of `needle` in `s` to `out`. */
+inline void appendOffsets(std::string_view s, char needle, std::vector<int> &out) {
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i pattern = _mm_set1_epi8(needle);
+    for (; i + 16 <= s.size(); i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s.data() + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern));
+        while (mask != 0) {
+            out.emplace_back(i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < s.size(); i++) {
+        if (s[i] == needle) {
+            out.emplace_back(i);
+        }
+    }
+}
+
+/** Appends the offsets of every occurrence of `a` and `b` in `s` to `outA` and `outB` in one pass
+ * over the buffer. */
+inline void appendOffsets2(std::string_view s, char a, char b, std::vector<int> &outA, std::vector<int> &outB) {
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i patternA = _mm_set1_epi8(a);
+    const __m128i patternB = _mm_set1_epi8(b);
+    for (; i + 16 <= s.size(); i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s.data() + i));
+        int maskA = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, patternA));
+        while (maskA != 0) {
+            outA.emplace_back(i + __builtin_ctz(maskA));
+            maskA &= maskA - 1;
+        }
+        int maskB = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, patternB));
+        while (maskB != 0) {
+            outB.emplace_back(i + __builtin_ctz(maskB));
+            maskB &= maskB - 1;
+        }
+    }
+#endif
+    for (; i < s.size(); i++) {
+        if (s[i] == a) {
+            outA.emplace_back(i);
+        } else if (s[i] == b) {
+            outB.emplace_back(i);
+        }
+    }
+}
+
+/**
+ * Returns true if `s` is well-formed UTF-8 (RFC 3629: no overlong encodings, no surrogates, max
+ * U+10FFFF). All-ASCII blocks — the overwhelmingly common case for source code — are dispatched 16
+ * bytes at a time; only blocks containing high bytes take the scalar path.
+ */
+inline bool isValidUTF8(std::string_view s) {
+    size_t i = 0;
+    size_t size = s.size();
+    const auto *data = reinterpret_cast<const uint8_t *>(s.data());
+    while (i < size) {
+#ifdef __SSE2__
+        while (i + 16 <= size) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            if (_mm_movemask_epi8(chunk) != 0) {
+                break; // contains a non-ASCII byte; fall through to the scalar decoder
+            }
+            i += 16;
+        }
+        if (i >= size) {
+            break;
+        }
+#endif
+        uint8_t byte = data[i];
+        if (byte < 0x80) {
+            i++;
+            continue;
+        }
+        int len;
+        uint32_t min;
+        uint32_t codepoint;
+        if ((byte & 0xe0) == 0xc0) {
+            len = 2;
+            min = 0x80;
+            codepoint = byte & 0x1f;
+        } else if ((byte & 0xf0) == 0xe0) {
+            len = 3;
+            min = 0x800;
+            codepoint = byte & 0x0f;
+        } else if ((byte & 0xf8) == 0xf0) {
+            len = 4;
+            min = 0x10000;
+            codepoint = byte & 0x07;
+        } else {
+            return false; // stray continuation byte or invalid lead byte
+        }
+        if (i + len > size) {
+            return false;
+        }
+        for (int j = 1; j < len; j++) {
+            uint8_t cont = data[i + j];
+            if ((cont & 0xc0) != 0x80) {
+                return false;
+            }
+            codepoint = (codepoint << 6) | (cont & 0x3f);
+        }
+        if (codepoint < min || codepoint > 0x10ffff || (codepoint >= 0xd800 && codepoint <= 0xdfff)) {
+            return false;
+        }
+        i += len;
+    }
+    return true;
+}
+
+} // namespace sorbet::bytescan
+
+#endif // SORBET_BYTESCAN_H
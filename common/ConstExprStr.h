@@ -14,6 +14,22 @@ struct ConstExprStr {
     {}
 
     ConstExprStr() = delete;
+
+    // Number of `{}` replacement fields in the string, with `{{`/`}}` escapes skipped. Everything
+    // formatted through ErrorColors uses exactly this placeholder form, so callers can check the
+    // count against their argument count (see ErrorBuilder::setHeader).
+    constexpr std::size_t placeholderCount() const {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < size; i++) {
+            if (str[i] == '{' && i + 1 < size && str[i + 1] == '}') {
+                count++;
+                i++;
+            } else if ((str[i] == '{' || str[i] == '}') && i + 1 < size && str[i + 1] == str[i]) {
+                i++;
+            }
+        }
+        return count;
+    }
 };
 }; // namespace sorbet
 
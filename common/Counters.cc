@@ -1,6 +1,8 @@
 #include "common/Counters.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 #include "common/Counters_impl.h"
+#include "common/MicroTimer.h"
 #include <algorithm>
 #include <chrono>
 #include <cmath>
@@ -23,6 +25,114 @@ bool CounterState::hasNullCounters() const {
     return counters.get() == nullptr;
 }
 
+namespace {
+
+// Counter names are compile-time string literals (see ConstExprStr), so each distinct name is
+// assigned a dense slot once, and from then on incrementing it is a plain array add into the
+// thread's CounterImpl — no hashing and no locks on the hot path. Slots are keyed by string value
+// so the same literal compiled into two translation units shares a slot; the registry lock is only
+// taken the first time a thread sees a given literal's address, after which a small per-thread
+// direct-mapped cache resolves the address straight to its slot.
+struct CounterSlotRegistry {
+    absl::Mutex mtx;
+    UnorderedMap<string_view, u4> counters;
+    vector<const char *> counterNames;
+    UnorderedMap<pair<string_view, string_view>, u4> categories;
+    vector<pair<const char *, const char *>> categoryNames;
+};
+
+CounterSlotRegistry &slotRegistry() {
+    static CounterSlotRegistry registry;
+    return registry;
+}
+
+constexpr size_t SLOT_CACHE_SIZE = 1024;
+static_assert((SLOT_CACHE_SIZE & (SLOT_CACHE_SIZE - 1)) == 0, "must be a power of two");
+
+size_t slotCacheIdx(const void *p1, const void *p2) {
+    auto h = reinterpret_cast<uintptr_t>(p1) >> 3;
+    h = h * 31u + (reinterpret_cast<uintptr_t>(p2) >> 3);
+    h ^= h >> 13;
+    return h & (SLOT_CACHE_SIZE - 1);
+}
+
+struct CachedCounterSlot {
+    const char *name = nullptr;
+    u4 slot = 0;
+};
+thread_local vector<CachedCounterSlot> counterSlotCache;
+
+u4 counterSlot(const char *counter) {
+    if (counterSlotCache.empty()) {
+        counterSlotCache.resize(SLOT_CACHE_SIZE);
+    }
+    auto &entry = counterSlotCache[slotCacheIdx(counter, nullptr)];
+    if (entry.name == counter) {
+        return entry.slot;
+    }
+    auto &registry = slotRegistry();
+    absl::MutexLock lock(&registry.mtx);
+    auto [it, inserted] = registry.counters.try_emplace(string_view(counter), registry.counterNames.size());
+    if (inserted) {
+        registry.counterNames.emplace_back(counter);
+    }
+    entry.name = counter;
+    entry.slot = it->second;
+    return it->second;
+}
+
+struct CachedCategorySlot {
+    const char *category = nullptr;
+    const char *name = nullptr;
+    u4 slot = 0;
+};
+thread_local vector<CachedCategorySlot> categorySlotCache;
+
+u4 categorySlot(const char *category, const char *counter) {
+    if (categorySlotCache.empty()) {
+        categorySlotCache.resize(SLOT_CACHE_SIZE);
+    }
+    auto &entry = categorySlotCache[slotCacheIdx(category, counter)];
+    if (entry.category == category && entry.name == counter) {
+        return entry.slot;
+    }
+    auto &registry = slotRegistry();
+    absl::MutexLock lock(&registry.mtx);
+    auto [it, inserted] = registry.categories.try_emplace(make_pair(string_view(category), string_view(counter)),
+                                                          registry.categoryNames.size());
+    if (inserted) {
+        registry.categoryNames.emplace_back(category, counter);
+    }
+    entry.category = category;
+    entry.name = counter;
+    entry.slot = it->second;
+    return it->second;
+}
+
+} // namespace
+
+void CounterImpl::foldSlotCounters() {
+    auto &registry = slotRegistry();
+    absl::MutexLock lock(&registry.mtx);
+    // Slots past the registered names are necessarily zero; slots past the fixed capacity were
+    // never used (their names accumulate straight into the maps).
+    auto counterLimit = min<size_t>(this->counterSlots.size(), registry.counterNames.size());
+    for (u4 i = 0; i < counterLimit; i++) {
+        if (this->counterSlots[i] != 0) {
+            this->prodCounterAdd(registry.counterNames[i], this->counterSlots[i]);
+        }
+    }
+    this->counterSlots.fill(0);
+    auto categoryLimit = min<size_t>(this->categorySlots.size(), registry.categoryNames.size());
+    for (u4 i = 0; i < categoryLimit; i++) {
+        if (this->categorySlots[i] != 0) {
+            auto &name = registry.categoryNames[i];
+            this->prodCategoryCounterAdd(name.first, name.second, this->categorySlots[i]);
+        }
+    }
+    this->categorySlots.fill(0);
+}
+
 const char *CounterImpl::internKey(const char *str) {
     auto it1 = this->stringsByPtr.find(str);
     if (it1 != this->stringsByPtr.end()) {
@@ -83,16 +193,34 @@ void CounterImpl::prodCounterAdd(const char *counter, unsigned long value) {
     this->counters[counter] += value;
 }
 
+// 0 means "retain everything"; long-lived servers cap this so tracing can stay enabled.
+static atomic<size_t> maxRetainedTimings{0};
+
+void setMaxRetainedTimings(size_t maxRetained) {
+    maxRetainedTimings.store(maxRetained);
+}
+
 void CounterImpl::timingAdd(CounterImpl::Timing timing) {
     if (fuzz_mode) {
         return;
     }
-    this->timings.emplace_back(timing);
+    auto cap = maxRetainedTimings.load(memory_order_relaxed);
+    if (cap != 0 && this->timings.size() >= cap) {
+        // Flight recorder: overwrite the oldest event. Trace events carry their own timestamps,
+        // so order within the buffer does not matter to consumers.
+        this->timings[this->nextTimingSlot] = move(timing);
+        this->nextTimingSlot = (this->nextTimingSlot + 1) % cap;
+        prodCounterAdd("timings.dropped", 1);
+        return;
+    }
+    this->timings.emplace_back(move(timing));
 }
 
 thread_local CounterImpl counterState;
 
 CounterState getAndClearThreadCounters() {
+    // Promote any accumulated micro-timer slots so they ride the normal counter harvest.
+    flushMicroTimers();
     auto state = make_unique<CounterImpl>(move(counterState));
     counterState.clear();
     return CounterState(move(state));
@@ -103,6 +231,8 @@ void CounterImpl::clear() {
     this->stringsByPtr.clear();
     this->histograms.clear();
     this->counters.clear();
+    this->counterSlots.fill(0);
+    this->categorySlots.fill(0);
     this->countersByCategory.clear();
 }
 
@@ -122,6 +252,17 @@ UnorderedMap<long, long> getAndClearHistogram(ConstExprStr histogram) {
 }
 
 void counterConsume(CounterState cs) {
+    // Slot-indexed counters merge by elementwise addition over the fixed arrays; slots are global,
+    // so the same index means the same counter in every thread's state.
+    auto &theirCounters = cs.counters->counterSlots;
+    for (u4 i = 0; i < theirCounters.size(); i++) {
+        counterState.counterSlots[i] += theirCounters[i];
+    }
+    auto &theirCategories = cs.counters->categorySlots;
+    for (u4 i = 0; i < theirCategories.size(); i++) {
+        counterState.categorySlots[i] += theirCategories[i];
+    }
+
     for (auto &cat : cs.counters->countersByCategory) {
         for (auto &e : cat.second) {
             counterState.prodCategoryCounterAdd(cat.first, e.first, e.second);
@@ -143,7 +284,10 @@ void counterConsume(CounterState cs) {
 }
 
 void counterAdd(ConstExprStr counter, unsigned long value) {
-    counterState.counterAdd(counter.str, value);
+    if (!enable_counters) {
+        return;
+    }
+    prodCounterAdd(counter, value);
 }
 
 void counterInc(ConstExprStr counter) {
@@ -151,7 +295,16 @@ void counterInc(ConstExprStr counter) {
 }
 
 void prodCounterAdd(ConstExprStr counter, unsigned long value) {
-    counterState.prodCounterAdd(counter.str, value);
+    if (fuzz_mode) {
+        return;
+    }
+    auto slot = counterSlot(counter.str);
+    if (slot < CounterImpl::FIXED_COUNTER_SLOTS) {
+        counterState.counterSlots[slot] += value;
+    } else {
+        // Overflowed the fixed capacity; this name stays on the map path for the whole run.
+        counterState.prodCounterAdd(counter.str, value);
+    }
 }
 
 void prodCounterInc(ConstExprStr counter) {
@@ -167,7 +320,10 @@ void prodCategoryCounterInc(ConstExprStr category, ConstExprStr counter) {
 }
 
 void categoryCounterAdd(ConstExprStr category, ConstExprStr counter, unsigned long value) {
-    counterState.categoryCounterAdd(category.str, counter.str, value);
+    if (!enable_counters) {
+        return;
+    }
+    prodCategoryCounterAdd(category, counter, value);
 }
 
 int genThreadId() {
@@ -202,7 +358,15 @@ void timingAdd(ConstExprStr measure, std::chrono::time_point<std::chrono::steady
 }
 
 void prodCategoryCounterAdd(ConstExprStr category, ConstExprStr counter, unsigned long value) {
-    counterState.prodCategoryCounterAdd(category.str, counter.str, value);
+    if (fuzz_mode) {
+        return;
+    }
+    auto slot = categorySlot(category.str, counter.str);
+    if (slot < CounterImpl::FIXED_CATEGORY_SLOTS) {
+        counterState.categorySlots[slot] += value;
+    } else {
+        counterState.prodCategoryCounterAdd(category.str, counter.str, value);
+    }
 }
 
 void histogramInc(ConstExprStr histogram, int key) {
@@ -227,6 +391,7 @@ const int MAX_STAT_WIDTH = MAX_WIDTH - PAD_LIMIT;
 const float HIST_CUTOFF = 0.1;
 
 void CounterImpl::canonicalize() {
+    foldSlotCounters();
     CounterImpl out;
 
     for (auto &cat : this->countersByCategory) {
@@ -91,6 +91,11 @@ void timingAdd(ConstExprStr measure, std::chrono::time_point<std::chrono::steady
                std::chrono::time_point<std::chrono::steady_clock> end,
                std::vector<std::pair<ConstExprStr, std::string>> args, FlowId self, FlowId previous);
 
+/* Caps how many timing events each thread retains between flushes; once full, the newest event
+ * overwrites the oldest (flight-recorder semantics). 0 (the default) retains everything. Long-lived
+ * servers set a cap so tracing can stay on without unbounded memory growth. */
+void setMaxRetainedTimings(size_t maxRetained);
+
 UnorderedMap<long, long> getAndClearHistogram(ConstExprStr histogram);
 std::string getCounterStatistics(std::vector<std::string> names);
 
@@ -2,6 +2,7 @@
 #define SORBET_COUNTERS_IMPL_H
 
 #include "common/common.h"
+#include <array>
 #include <string_view>
 
 namespace sorbet {
@@ -17,6 +18,10 @@ struct CounterImpl {
 
     const char *internKey(const char *str);
 
+    // Folds the slot-indexed counters below into the canonical maps. Called by canonicalize(), so
+    // consumers that iterate the maps never observe the slot representation.
+    void foldSlotCounters();
+
     void histogramAdd(const char *histogram, int key, unsigned long value);
     void prodHistogramAdd(const char *histogram, int key, unsigned long value);
 
@@ -44,7 +49,19 @@ struct CounterImpl {
     void timingAdd(Timing timing);
     UnorderedMap<const char *, UnorderedMap<int, CounterType>> histograms;
     UnorderedMap<const char *, CounterType> counters;
+    // Hot-path storage: plain and category counters accumulate into these fixed-size arrays,
+    // indexed by the globally-assigned slot of their (compile-time constant) name — a plain add
+    // with no size check or heap indirection. See counterSlot() in Counters.cc. Merging two states
+    // is elementwise addition. The arrays are cacheline-aligned so high-frequency increments never
+    // share a line with the map-based slow path's buckets; names assigned a slot past the fixed
+    // capacity stay on that slow path for their whole run.
+    static constexpr u4 FIXED_COUNTER_SLOTS = 256;
+    static constexpr u4 FIXED_CATEGORY_SLOTS = 512;
+    alignas(64) std::array<CounterType, FIXED_COUNTER_SLOTS> counterSlots = {};
+    alignas(64) std::array<CounterType, FIXED_CATEGORY_SLOTS> categorySlots = {};
     std::vector<Timing> timings;
+    // Next slot to overwrite once `timings` has hit the retention cap. See setMaxRetainedTimings.
+    size_t nextTimingSlot = 0;
     UnorderedMap<const char *, UnorderedMap<const char *, CounterType>> countersByCategory;
 };
 } // namespace sorbet
@@ -10,6 +10,8 @@ namespace sorbet {
 class FileOps final {
 public:
     static bool exists(std::string_view filename);
+    /** Returns the size of the file in bytes, or -1 if the file does not exist. */
+    static long fileSize(std::string_view filename);
     static bool isFile(std::string_view path, std::string_view ignorePattern, const int pos);
     static bool isFolder(std::string_view path, std::string_view ignorePattern, const int pos);
     static std::string read(std::string_view filename);
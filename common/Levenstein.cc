@@ -1,6 +1,5 @@
 #include "common/Levenstein.h"
 #include "common/common.h"
-#include <vector>
 
 using namespace std;
 
@@ -20,20 +19,48 @@ int sorbet::Levenstein::distance(string_view s1, string_view s2, int bound) noex
     if (s2len - s1len > bound) {
         return INT_MAX;
     }
+    if (bound > s2len) {
+        bound = s2len;
+    }
 
-    vector<int> column(s1len + 1);
-    absl::c_iota(column, 0);
+    // A cell (x, y) with |x - y| > bound can never contribute to a result within the bound, so only
+    // the diagonal band is computed; cells just outside it are padded with a value that keeps them
+    // from ever winning a min().
+    const int outOfBand = bound + 1;
+    InlinedVector<int, 64> column(s1len + 1);
+    for (int y = 0; y <= s1len; y++) {
+        column[y] = y <= bound ? y : outOfBand;
+    }
 
     for (int x = 1; x <= s2len; x++) {
-        column[0] = x;
-        int lastDiagonal = x - 1;
-        for (auto y = 1; y <= s1len; y++) {
+        int lo = max(1, x - bound);
+        int hi = min(s1len, x + bound);
+        int lastDiagonal = column[lo - 1];
+        if (lo == 1) {
+            column[0] = x;
+        }
+        int columnMin = lo == 1 ? column[0] : INT_MAX;
+        for (int y = lo; y <= hi; y++) {
             int oldDiagonal = column[y];
-            auto possibilities = {column[y] + 1, column[y - 1] + 1, lastDiagonal + (s1[y - 1] == s2[x - 1] ? 0 : 1)};
-            column[y] = min(possibilities);
+            int value = min(min(column[y] + 1, column[y - 1] + 1), lastDiagonal + (s1[y - 1] == s2[x - 1] ? 0 : 1));
+            column[y] = value;
             lastDiagonal = oldDiagonal;
+            columnMin = min(columnMin, value);
+        }
+        if (columnMin > bound) {
+            // Distances never shrink along a row, so no suffix of the inputs can bring this back
+            // under the bound.
+            return INT_MAX;
+        }
+        if (hi < s1len) {
+            // This cell was not computed for this column; the next column must not read the stale
+            // value left behind by an earlier one.
+            column[hi + 1] = outOfBand;
         }
     }
     int result = column[s1len];
+    if (result > bound) {
+        return INT_MAX;
+    }
     return result;
 }
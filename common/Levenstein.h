@@ -6,6 +6,8 @@ namespace sorbet {
 
 class Levenstein {
 public:
+    // Edit distance between `s1` and `s2`, computed over a diagonal band of width `bound` with an
+    // early exit. Returns INT_MAX whenever the distance exceeds `bound`.
     static int distance(std::string_view s1, std::string_view s2, int bound) noexcept;
 };
 
@@ -0,0 +1,91 @@
+#include "common/MicroTimer.h"
+#include "common/Counters.h"
+#include <chrono>
+
+using namespace std;
+
+namespace sorbet {
+
+namespace {
+
+constexpr int SLOT_COUNT = static_cast<int>(MicroTimerSlot::SlotCount);
+
+struct MicroTimerState {
+    struct {
+        unsigned long cycles = 0;
+        unsigned long count = 0;
+    } slots[SLOT_COUNT];
+    // Calibration baseline, captured on this thread's first recording. The cycle counter has no
+    // portable frequency API, so the rate is inferred from how far both clocks moved by flush time.
+    unsigned long baselineCycles = 0;
+    chrono::steady_clock::time_point baselineWall;
+    bool calibrated = false;
+};
+thread_local MicroTimerState microTimerState;
+
+unsigned long readCycles() {
+#ifdef EMSCRIPTEN
+    return 0;
+#else
+    return __builtin_readcyclecounter();
+#endif
+}
+
+struct SlotNames {
+    ConstExprStr micros;
+    ConstExprStr count;
+};
+const SlotNames slotNames[SLOT_COUNT] = {
+    {"micro_timers.process_binding_us", "micro_timers.process_binding_count"},
+    {"micro_timers.dispatch_call_us", "micro_timers.dispatch_call_count"},
+};
+
+} // namespace
+
+MicroTimer::MicroTimer(MicroTimerSlot slot) : slot(slot), startCycles(readCycles()) {
+    auto &state = microTimerState;
+    if (!state.calibrated) {
+        state.baselineCycles = this->startCycles;
+        state.baselineWall = chrono::steady_clock::now();
+        state.calibrated = true;
+    }
+}
+
+MicroTimer::~MicroTimer() {
+    auto &entry = microTimerState.slots[static_cast<int>(this->slot)];
+    entry.cycles += readCycles() - this->startCycles;
+    entry.count += 1;
+}
+
+void flushMicroTimers() {
+    auto &state = microTimerState;
+    if (!state.calibrated) {
+        return;
+    }
+    auto nowCycles = readCycles();
+    auto nowWall = chrono::steady_clock::now();
+    auto elapsedCycles = nowCycles - state.baselineCycles;
+    auto elapsedNanos = chrono::duration_cast<chrono::nanoseconds>(nowWall - state.baselineWall).count();
+    if (elapsedNanos < 1'000'000 || elapsedCycles == 0) {
+        // Not enough wall time since the baseline to trust the inferred rate; keep accumulating
+        // and let a later flush promote the slots.
+        return;
+    }
+    double cyclesPerNano = static_cast<double>(elapsedCycles) / static_cast<double>(elapsedNanos);
+    for (int i = 0; i < SLOT_COUNT; i++) {
+        auto &entry = state.slots[i];
+        if (entry.count == 0) {
+            continue;
+        }
+        auto micros = static_cast<unsigned long>(static_cast<double>(entry.cycles) / cyclesPerNano / 1000.0);
+        prodCounterAdd(slotNames[i].micros, micros);
+        prodCounterAdd(slotNames[i].count, entry.count);
+        entry.cycles = 0;
+        entry.count = 0;
+    }
+    // Re-baseline so long-lived threads keep a fresh rate (frequency scaling drifts over time).
+    state.baselineCycles = nowCycles;
+    state.baselineWall = nowWall;
+}
+
+} // namespace sorbet
@@ -0,0 +1,40 @@
+#ifndef SORBET_MICRO_TIMER_H
+#define SORBET_MICRO_TIMER_H
+#include "common/common.h"
+
+namespace sorbet {
+
+// Two-tier timing. Timer costs a clock_gettime pair plus a timingAdd record per scope — fine at
+// phase granularity, far too heavy for the per-binding loops where regressions actually show up.
+// MicroTimer reads the CPU cycle counter on entry and exit and adds the difference into a fixed
+// per-thread slot: two register reads and an add, no allocation, no locking, always on.
+//
+// Slots are promoted to ordinary counters ("micro_timers.<slot>_us" and "_count") by
+// flushMicroTimers(), using a per-thread cycles-per-nanosecond rate calibrated against the steady
+// clock between first use and the flush. getAndClearThreadCounters() flushes automatically, so
+// worker harvests at phase ends pick the slots up without any extra plumbing.
+enum class MicroTimerSlot {
+    ProcessBinding,
+    DispatchCall,
+    SlotCount, // keep last
+};
+
+class MicroTimer {
+public:
+    MicroTimer(MicroTimerSlot slot);
+    ~MicroTimer();
+    MicroTimer(const MicroTimer &) = delete;
+    MicroTimer(MicroTimer &&) = delete;
+
+private:
+    MicroTimerSlot slot;
+    unsigned long startCycles;
+};
+
+// Converts this thread's accumulated slots into counters and zeroes them. Cheap when nothing was
+// recorded. Called from getAndClearThreadCounters(); standalone phases (the main thread between
+// harvests) may call it directly.
+void flushMicroTimers();
+
+} // namespace sorbet
+#endif // SORBET_MICRO_TIMER_H
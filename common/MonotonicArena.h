@@ -0,0 +1,100 @@
+#ifndef SORBET_COMMON_MONOTONIC_ARENA_H
+#define SORBET_COMMON_MONOTONIC_ARENA_H
+
+#include "common/ArenaStats.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sorbet {
+
+// A phase-scoped bump allocator for scratch containers (PMR in spirit, without depending on
+// <memory_resource>). Allocation is a pointer bump out of large blocks, deallocation is a no-op,
+// and all of the memory is returned in one shot when the arena dies. Intended for hash maps and
+// vectors that live exactly as long as one phase or walk: their growth churn stays off the
+// general-purpose heap, at the cost of retaining superseded tables until the arena is torn down.
+//
+// Blocks are reported to ArenaStats; see the `memory.scratch_arena.*` counters.
+class MonotonicArena final {
+public:
+    MonotonicArena() = default;
+    MonotonicArena(const MonotonicArena &) = delete;
+    MonotonicArena &operator=(const MonotonicArena &) = delete;
+
+    ~MonotonicArena() {
+        if (!blocks.empty()) {
+            ArenaStats::arenaFreed(ArenaStats::Kind::Scratch, allocatedBytes, blockBytes, blocks.size());
+        }
+    }
+
+    void *allocate(size_t bytes, size_t align) {
+        auto addr = reinterpret_cast<uintptr_t>(freePtr);
+        auto aligned = (addr + align - 1) & ~(uintptr_t(align) - 1);
+        auto padding = aligned - addr;
+        if (padding + bytes > available) {
+            refill(bytes + align);
+            addr = reinterpret_cast<uintptr_t>(freePtr);
+            aligned = (addr + align - 1) & ~(uintptr_t(align) - 1);
+            padding = aligned - addr;
+        }
+        freePtr += padding + bytes;
+        available -= padding + bytes;
+        allocatedBytes += bytes;
+        return reinterpret_cast<void *>(aligned);
+    }
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char *freePtr = nullptr;
+    size_t available = 0;
+    size_t allocatedBytes = 0;
+    size_t blockBytes = 0;
+
+    void refill(size_t atLeast) {
+        auto size = atLeast > BLOCK_SIZE ? atLeast : BLOCK_SIZE;
+        blocks.emplace_back(std::make_unique<char[]>(size));
+        freePtr = blocks.back().get();
+        available = size;
+        blockBytes += size;
+        ArenaStats::blockAllocated(size);
+    }
+};
+
+// std-compatible allocator handing out memory from a MonotonicArena. The arena must outlive every
+// container using it; declare it before the container so destruction order is right.
+template <class T> class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(MonotonicArena &arena) : arena_(&arena) {}
+    template <class U> ArenaAllocator(const ArenaAllocator<U> &other) : arena_(other.arena()) {}
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T *, size_t) {
+        // Freed wholesale when the arena dies.
+    }
+
+    MonotonicArena *arena() const {
+        return arena_;
+    }
+
+private:
+    MonotonicArena *arena_;
+};
+
+template <class T, class U> bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+    return a.arena() == b.arena();
+}
+template <class T, class U> bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+    return !(a == b);
+}
+
+} // namespace sorbet
+
+#endif // SORBET_COMMON_MONOTONIC_ARENA_H
@@ -1,9 +1,25 @@
 #include "common/Timer.h"
+#include <atomic>
 using namespace std;
 namespace sorbet {
 
+namespace {
+atomic<bool> collectTimerArgs{true};
+
+vector<pair<ConstExprStr, string>> maybeCollectArgs(initializer_list<pair<ConstExprStr, string>> args) {
+    if (args.size() == 0 || !collectTimerArgs.load(memory_order_relaxed)) {
+        return {};
+    }
+    return {args.begin(), args.end()};
+}
+} // namespace
+
+void Timer::setCollectArgs(bool collect) {
+    collectTimerArgs.store(collect, memory_order_relaxed);
+}
+
 Timer::Timer(spdlog::logger &log, ConstExprStr name, FlowId prev, initializer_list<pair<ConstExprStr, string>> args)
-    : log(log), name(name), prev(prev), self{0}, args(args), start(chrono::steady_clock::now()){};
+    : log(log), name(name), prev(prev), self{0}, args(maybeCollectArgs(args)), start(chrono::steady_clock::now()){};
 
 Timer::Timer(spdlog::logger &log, ConstExprStr name, initializer_list<pair<ConstExprStr, string>> args)
     : Timer(log, name, FlowId{0}, args){};
@@ -22,6 +22,11 @@ public:
     ~Timer();
     FlowId getFlowEdge();
 
+    /** Controls whether timers retain their per-scope args (file paths and the like). Args only
+     * feed the trace/report artifacts and sampled detailed telemetry; when nothing will consume
+     * them, disabling collection reduces a timer to a clock read and a branch. */
+    static void setCollectArgs(bool collect);
+
 private:
     spdlog::logger &log;
     ConstExprStr name;
@@ -1,4 +1,5 @@
 #include "common/common.h"
+#include "absl/synchronization/mutex.h"
 #include "common/Exception.h"
 #include "common/FileOps.h"
 #include "os/os.h"
@@ -11,6 +12,7 @@
 #include <dirent.h>
 #include <exception>
 #include <memory>
+#include <thread>
 #include <vector>
 
 using namespace std;
@@ -31,6 +33,14 @@ bool sorbet::FileOps::exists(string_view filename) {
     return (stat((string(filename)).c_str(), &buffer) == 0);
 }
 
+long sorbet::FileOps::fileSize(string_view filename) {
+    struct stat buffer;
+    if (stat((string(filename)).c_str(), &buffer) != 0) {
+        return -1;
+    }
+    return buffer.st_size;
+}
+
 string sorbet::FileOps::read(string_view filename) {
     FILE *fp = std::fopen((string(filename)).c_str(), "rb");
     if (fp) {
@@ -227,6 +237,18 @@ bool sorbet::FileOps::isFileIgnored(string_view basePath, string_view filePath,
     return false;
 }
 
+namespace {
+// Some filesystems (notably certain NFS servers) return DT_UNKNOWN instead of filling in d_type;
+// fall back to one stat for exactly those entries so directories on them still get walked.
+bool isDirectoryEntry(const struct dirent &entry, const string &fullPath) {
+    if (entry.d_type == DT_UNKNOWN) {
+        struct stat s;
+        return stat(fullPath.c_str(), &s) == 0 && S_ISDIR(s.st_mode);
+    }
+    return entry.d_type == DT_DIR;
+}
+} // namespace
+
 void appendFilesInDir(string_view basePath, string_view path, const sorbet::UnorderedSet<string> &extensions,
                       bool recursive, vector<string> &result, const std::vector<std::string> &absoluteIgnorePatterns,
                       const std::vector<std::string> &relativeIgnorePatterns) {
@@ -244,11 +266,14 @@ void appendFilesInDir(string_view basePath, string_view path, const sorbet::Unor
     }
 
     while ((entry = readdir(dir)) != nullptr) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
         auto fullPath = fmt::format("{}/{}", path, entry->d_name);
         if (sorbet::FileOps::isFileIgnored(basePath, fullPath, absoluteIgnorePatterns, relativeIgnorePatterns)) {
             continue;
-        } else if (entry->d_type == DT_DIR) {
-            if (!recursive || strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+        } else if (isDirectoryEntry(*entry, fullPath)) {
+            if (!recursive) {
                 continue;
             }
             appendFilesInDir(basePath, fullPath, extensions, recursive, result, absoluteIgnorePatterns,
@@ -267,11 +292,126 @@ void appendFilesInDir(string_view basePath, string_view path, const sorbet::Unor
     closedir(dir);
 }
 
+namespace {
+
+// Shared state for the parallel recursive crawl below.
+struct FileListingState {
+    absl::Mutex mutex;
+    std::vector<std::string> pendingDirs; // directories discovered but not yet scanned
+    int activeScans = 0;                  // directories currently being scanned by some worker
+    bool notDirError = false;
+    bool notFoundError = false;
+    std::vector<std::string> result;
+
+    bool hasWorkOrDone() const {
+        return !pendingDirs.empty() || activeScans == 0 || notDirError || notFoundError;
+    }
+};
+
+void crawlDirsWorker(string_view basePath, const sorbet::UnorderedSet<string> &extensions,
+                     const std::vector<std::string> &absoluteIgnorePatterns,
+                     const std::vector<std::string> &relativeIgnorePatterns, FileListingState &state) {
+    vector<string> localFiles;
+    while (true) {
+        string path;
+        {
+            absl::MutexLock lck(&state.mutex);
+            state.mutex.Await(absl::Condition(&state, &FileListingState::hasWorkOrDone));
+            if (state.notDirError || state.notFoundError || state.pendingDirs.empty()) {
+                break;
+            }
+            path = move(state.pendingDirs.back());
+            state.pendingDirs.pop_back();
+            state.activeScans++;
+        }
+
+        vector<string> localDirs;
+        DIR *dir;
+        struct dirent *entry;
+        if ((dir = opendir(path.c_str())) == nullptr) {
+            absl::MutexLock lck(&state.mutex);
+            // Same mapping as appendFilesInDir; the exception is rethrown on the calling thread.
+            if (errno == ENOTDIR) {
+                state.notDirError = true;
+            } else {
+                state.notFoundError = true;
+            }
+            state.activeScans--;
+            break;
+        }
+        while ((entry = readdir(dir)) != nullptr) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+                continue;
+            }
+            auto fullPath = fmt::format("{}/{}", path, entry->d_name);
+            if (sorbet::FileOps::isFileIgnored(basePath, fullPath, absoluteIgnorePatterns, relativeIgnorePatterns)) {
+                continue;
+            } else if (isDirectoryEntry(*entry, fullPath)) {
+                localDirs.emplace_back(move(fullPath));
+            } else {
+                auto dotLocation = fullPath.rfind('.');
+                // Note: Can't call substr with an index > string length, so explicitly check if a dot isn't found.
+                if (dotLocation != string::npos) {
+                    auto ext = fullPath.substr(dotLocation);
+                    if (extensions.find(ext) != extensions.end()) {
+                        localFiles.emplace_back(move(fullPath));
+                    }
+                }
+            }
+        }
+        closedir(dir);
+
+        {
+            absl::MutexLock lck(&state.mutex);
+            state.activeScans--;
+            state.pendingDirs.insert(state.pendingDirs.end(), make_move_iterator(localDirs.begin()),
+                                     make_move_iterator(localDirs.end()));
+        }
+    }
+
+    absl::MutexLock lck(&state.mutex);
+    state.result.insert(state.result.end(), make_move_iterator(localFiles.begin()),
+                        make_move_iterator(localFiles.end()));
+}
+
+} // namespace
+
 vector<string> sorbet::FileOps::listFilesInDir(string_view path, const UnorderedSet<string> &extensions, bool recursive,
                                                const std::vector<std::string> &absoluteIgnorePatterns,
                                                const std::vector<std::string> &relativeIgnorePatterns) {
     vector<string> result;
+#ifndef EMSCRIPTEN
+    if (recursive) {
+        // Recursive walks dominate startup on high-latency filesystems (NFS), where a serial crawl
+        // spends almost all of its time blocked on directory reads; fan the walk out over a few
+        // threads so those stalls overlap.
+        FileListingState state;
+        state.pendingDirs.emplace_back(path);
+        int numThreads = static_cast<int>(std::thread::hardware_concurrency());
+        numThreads = numThreads < 1 ? 1 : (numThreads > 8 ? 8 : numThreads);
+        {
+            vector<unique_ptr<Joinable>> threads;
+            for (int i = 0; i < numThreads; i++) {
+                threads.emplace_back(runInAThread("fileCrawl", [&path, &extensions, &absoluteIgnorePatterns,
+                                                                &relativeIgnorePatterns, &state]() {
+                    crawlDirsWorker(path, extensions, absoluteIgnorePatterns, relativeIgnorePatterns, state);
+                }));
+            }
+            // Destroying the Joinables joins the crawl threads.
+        }
+        if (state.notDirError) {
+            throw sorbet::FileNotDirException();
+        }
+        if (state.notFoundError) {
+            throw sorbet::FileNotFoundException();
+        }
+        result = move(state.result);
+    } else {
+        appendFilesInDir(path, path, extensions, recursive, result, absoluteIgnorePatterns, relativeIgnorePatterns);
+    }
+#else
     appendFilesInDir(path, path, extensions, recursive, result, absoluteIgnorePatterns, relativeIgnorePatterns);
+#endif
     fast_sort(result);
     return result;
 }
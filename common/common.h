@@ -12,6 +12,7 @@ static_assert(false, "Need c++14 to compile this codebase");
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
+#include "common/MonotonicArena.h"
 #include "pdqsort.h"
 #include "spdlog/fmt/fmt.h"
 #include "spdlog/spdlog.h"
@@ -29,8 +30,23 @@ static_assert(false, "Need c++14 to compile this codebase");
 namespace sorbet {
 
 template <class T, size_t N> using InlinedVector = absl::InlinedVector<T, N>;
-template <class K, class V> using UnorderedMap = absl::flat_hash_map<K, V>;
-template <class E> using UnorderedSet = absl::flat_hash_set<E>;
+template <class K, class V, class Hash = typename absl::flat_hash_map<K, V>::hasher,
+          class Eq = typename absl::flat_hash_map<K, V>::key_equal,
+          class Alloc = typename absl::flat_hash_map<K, V>::allocator_type>
+using UnorderedMap = absl::flat_hash_map<K, V, Hash, Eq, Alloc>;
+template <class E, class Hash = typename absl::flat_hash_set<E>::hasher,
+          class Eq = typename absl::flat_hash_set<E>::key_equal,
+          class Alloc = typename absl::flat_hash_set<E>::allocator_type>
+using UnorderedSet = absl::flat_hash_set<E, Hash, Eq, Alloc>;
+// UnorderedMap/UnorderedSet whose storage comes from a MonotonicArena: construct with
+// `{ArenaAllocator<...>(arena)}` and make sure the arena outlives the container. For scratch maps
+// that live exactly one phase or walk.
+template <class K, class V>
+using ArenaUnorderedMap = UnorderedMap<K, V, typename UnorderedMap<K, V>::hasher,
+                                       typename UnorderedMap<K, V>::key_equal, ArenaAllocator<std::pair<const K, V>>>;
+template <class E>
+using ArenaUnorderedSet =
+    UnorderedSet<E, typename UnorderedSet<E>::hasher, typename UnorderedSet<E>::key_equal, ArenaAllocator<E>>;
 // Uncomment to make vectors debuggable
 // template <class T, size_t N> using InlinedVector = std::vector<T>;
 
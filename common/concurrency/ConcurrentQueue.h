@@ -94,6 +94,15 @@ public:
 template <class Elem>
 using BlockingBoundedQueue = AbstractConcurrentBoundedQueue<Elem, moodycamel::BlockingConcurrentQueue<Elem>>;
 
+// Unbounded variant whose wait_pop_timed actually blocks; the non-blocking ConcurrentUnBoundedQueue
+// only supports try_pop.
+template <class Elem>
+class BlockingUnBoundedQueue : public AbstractConcurrentBoundedQueue<Elem, moodycamel::BlockingConcurrentQueue<Elem>> {
+public:
+    BlockingUnBoundedQueue()
+        : AbstractConcurrentBoundedQueue<Elem, moodycamel::BlockingConcurrentQueue<Elem>>(INT_MAX){};
+};
+
 #ifdef _MACH_BOOLEAN_H_
 // on mac, system headers define FALSE and TRUE as macros. Undefine them so that they don't break parser.
 #undef TRUE
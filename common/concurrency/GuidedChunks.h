@@ -0,0 +1,55 @@
+#ifndef SORBET_GUIDEDCHUNKS_H
+#define SORBET_GUIDEDCHUNKS_H
+
+#include "common/common.h"
+#include <atomic>
+
+namespace sorbet {
+
+/**
+ * A guided-scheduling cursor over the index range [0, numTasks).
+ *
+ * Where WorkStealingQueue moves the items themselves, this hands out index ranges into a vector the
+ * caller already owns: workers claim exponentially shrinking chunks off one shared cursor — half of
+ * what remains split evenly across the pool, never less than one index. Early claims are large, so
+ * the cursor is touched O(workers * log(tasks)) times instead of once per item; late claims are
+ * single indices, so no worker sits on a big chunk while the rest of the pool idles.
+ *
+ * Best for fine-grained, roughly uniform items (one file each) where per-item pops on a shared
+ * queue show up in profiles. For items with wildly skewed costs prefer WorkStealingQueue.
+ */
+class GuidedChunks {
+    std::atomic<size_t> cursor{0};
+    const size_t numTasks;
+    const size_t numWorkers;
+
+public:
+    GuidedChunks(size_t numTasks, int workers) noexcept
+        : numTasks(numTasks), numWorkers(std::max(workers, 1)) {}
+    GuidedChunks(const GuidedChunks &other) = delete;
+    GuidedChunks(GuidedChunks &&other) = delete;
+
+    /** Claims the next chunk [begin, end); returns false once the range is exhausted. */
+    bool try_pop(size_t &begin, size_t &end) noexcept {
+        auto claimed = cursor.load(std::memory_order_relaxed);
+        while (claimed < numTasks) {
+            auto chunk = std::max<size_t>(1, (numTasks - claimed) / (2 * numWorkers));
+            if (cursor.compare_exchange_weak(claimed, claimed + chunk, std::memory_order_relaxed)) {
+                begin = claimed;
+                end = claimed + chunk;
+                return true;
+            }
+            // The failed exchange reloaded `claimed`; recompute the chunk for the new remainder.
+        }
+        return false;
+    }
+
+    /** How many indices have been claimed so far. Claimed chunks may still be in flight, so this
+     * overestimates completed work by at most one chunk per worker. */
+    size_t doneEstimate() const noexcept {
+        return cursor.load(std::memory_order_relaxed);
+    }
+};
+
+}; // namespace sorbet
+#endif // SORBET_GUIDEDCHUNKS_H
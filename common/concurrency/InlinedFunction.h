@@ -0,0 +1,149 @@
+#ifndef SORBET_INLINED_FUNCTION_H
+#define SORBET_INLINED_FUNCTION_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace sorbet {
+
+/**
+ * A type-erased callable like std::function, but with `InlineBytes` of inline storage so the common
+ * capture shapes (a handful of references, shared_ptrs and small values) are stored without
+ * touching the heap. WorkerPool creates tasks per phase per worker, and the LSP fast path creates
+ * them per edit; those allocations were pure overhead. Callables that are too big, over-aligned, or
+ * lack a noexcept move constructor fall back to one heap allocation, preserving std::function
+ * semantics. Copyable, because WorkerPool fans a single task out to every worker queue.
+ */
+template <typename Signature, std::size_t InlineBytes = 64> class InlinedFunction;
+
+template <typename R, typename... Args, std::size_t InlineBytes> class InlinedFunction<R(Args...), InlineBytes> {
+    static_assert(InlineBytes >= sizeof(void *), "inline storage must at least hold the heap fallback pointer");
+
+    struct VTable {
+        R (*invoke)(void *obj, Args &&... args);
+        void (*copyTo)(const void *obj, void *dst);
+        // Leaves the source in a state where destroy() is still safe to call.
+        void (*moveTo)(void *obj, void *dst);
+        void (*destroy)(void *obj);
+    };
+
+    template <typename F> static constexpr bool fitsInline() {
+        return sizeof(F) <= InlineBytes && alignof(F) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible<F>::value;
+    }
+
+    template <typename F> struct InlineOps {
+        static R invoke(void *obj, Args &&... args) {
+            return (*static_cast<F *>(obj))(std::forward<Args>(args)...);
+        }
+        static void copyTo(const void *obj, void *dst) {
+            new (dst) F(*static_cast<const F *>(obj));
+        }
+        static void moveTo(void *obj, void *dst) {
+            new (dst) F(std::move(*static_cast<F *>(obj)));
+        }
+        static void destroy(void *obj) {
+            static_cast<F *>(obj)->~F();
+        }
+        static constexpr VTable table{&invoke, &copyTo, &moveTo, &destroy};
+    };
+
+    template <typename F> struct HeapOps {
+        static R invoke(void *obj, Args &&... args) {
+            return (**static_cast<F **>(obj))(std::forward<Args>(args)...);
+        }
+        static void copyTo(const void *obj, void *dst) {
+            *static_cast<F **>(dst) = new F(**static_cast<F *const *>(obj));
+        }
+        static void moveTo(void *obj, void *dst) {
+            *static_cast<F **>(dst) = *static_cast<F **>(obj);
+            *static_cast<F **>(obj) = nullptr;
+        }
+        static void destroy(void *obj) {
+            delete *static_cast<F **>(obj);
+        }
+        static constexpr VTable table{&invoke, &copyTo, &moveTo, &destroy};
+    };
+
+    const VTable *vtable = nullptr;
+    // Mutable so operator() can stay const-qualified (matching std::function, which invokes the
+    // wrapped callable through a const wrapper).
+    alignas(std::max_align_t) mutable unsigned char storage[InlineBytes];
+
+    void reset() noexcept {
+        if (vtable != nullptr) {
+            vtable->destroy(&storage);
+            vtable = nullptr;
+        }
+    }
+
+public:
+    InlinedFunction() noexcept = default;
+
+    template <typename F,
+              typename = std::enable_if_t<!std::is_same<std::decay_t<F>, InlinedFunction>::value>>
+    InlinedFunction(F &&f) {
+        using Fn = std::decay_t<F>;
+        if constexpr (fitsInline<Fn>()) {
+            new (&storage) Fn(std::forward<F>(f));
+            vtable = &InlineOps<Fn>::table;
+        } else {
+            *reinterpret_cast<Fn **>(&storage) = new Fn(std::forward<F>(f));
+            vtable = &HeapOps<Fn>::table;
+        }
+    }
+
+    InlinedFunction(const InlinedFunction &other) {
+        if (other.vtable != nullptr) {
+            other.vtable->copyTo(&other.storage, &storage);
+            vtable = other.vtable;
+        }
+    }
+
+    InlinedFunction(InlinedFunction &&other) noexcept {
+        if (other.vtable != nullptr) {
+            other.vtable->moveTo(&other.storage, &storage);
+            vtable = other.vtable;
+            other.reset();
+        }
+    }
+
+    InlinedFunction &operator=(InlinedFunction &&other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.vtable != nullptr) {
+                other.vtable->moveTo(&other.storage, &storage);
+                vtable = other.vtable;
+                other.reset();
+            }
+        }
+        return *this;
+    }
+
+    InlinedFunction &operator=(const InlinedFunction &other) {
+        if (this != &other) {
+            // Copy into a temporary first so a throwing copy leaves *this intact.
+            InlinedFunction tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    ~InlinedFunction() {
+        reset();
+    }
+
+    explicit operator bool() const noexcept {
+        return vtable != nullptr;
+    }
+
+    R operator()(Args... args) const {
+        return vtable->invoke(&storage, std::forward<Args>(args)...);
+    }
+};
+
+} // namespace sorbet
+
+#endif // SORBET_INLINED_FUNCTION_H
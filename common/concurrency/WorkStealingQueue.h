@@ -0,0 +1,123 @@
+#ifndef SORBET_WORKSTEALINGQUEUE_H
+#define SORBET_WORKSTEALINGQUEUE_H
+
+#include "common/common.h"
+#include "common/concurrency/ConcurrentQueue.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+namespace sorbet {
+
+/**
+ * A bounded queue with one deque per worker and steal-half semantics.
+ *
+ * The shared ConcurrentBoundedQueue distributes single items, which works well when work units are
+ * uniform. Our typecheck units are wildly skewed in size: workers draining a shared queue all pay
+ * contention on every item while the tail of a run is still serialized behind whoever drew the big
+ * items. Here each worker drains its own deque contention-free and only touches a lock when it runs
+ * dry, at which point it steals half of a victim's remaining items in one critical section.
+ *
+ * Producers seed the queue before workers start (matching how pipeline phases use bounded queues);
+ * the `count` passed to push plays the same safe-publication role as in ConcurrentBoundedQueue.
+ */
+template <class Elem> class WorkStealingQueue {
+    struct Shard {
+        std::mutex lock;
+        std::deque<Elem> items;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<int> elementsLeftToPush;
+    std::atomic<int> elementsPopped{0};
+    std::atomic<int> nextSeed{0};
+    std::atomic<int> nextSlot{0};
+
+public:
+    const int bound;
+
+    WorkStealingQueue(int workers, int bound) noexcept : elementsLeftToPush(bound), bound(bound) {
+        int shardCount = std::max(workers, 1);
+        shards.reserve(shardCount);
+        for (int i = 0; i < shardCount; i++) {
+            shards.emplace_back(std::make_unique<Shard>());
+        }
+    }
+    WorkStealingQueue(const WorkStealingQueue &other) = delete;
+    WorkStealingQueue(WorkStealingQueue &&other) = delete;
+
+    /** Returns the slot whose deque the calling worker should drain first. Call once per worker. */
+    int registerWorker() noexcept {
+        return nextSlot.fetch_add(1, std::memory_order_relaxed) % shards.size();
+    }
+
+    /** Items are dealt round-robin across shards, so seeding in decreasing cost order gives every
+     * worker a similar aggregate. */
+    void push(Elem &&elem, int count) noexcept {
+        auto &shard = *shards[nextSeed.fetch_add(1, std::memory_order_relaxed) % shards.size()];
+        {
+            std::lock_guard<std::mutex> guard(shard.lock);
+            shard.items.emplace_back(std::move(elem));
+        }
+        elementsLeftToPush.fetch_add(-count, std::memory_order_release);
+        ENFORCE(elementsLeftToPush.load(std::memory_order_relaxed) >= 0);
+    }
+
+    DequeueResult try_pop(int worker, Elem &elem) noexcept {
+        DequeueResult ret;
+        ret.shouldRetry = elementsLeftToPush.load(std::memory_order_acquire) != 0;
+        ret.returned = popLocal(worker, elem) || steal(worker, elem);
+        if (ret.returned) {
+            elementsPopped.fetch_add(1, std::memory_order_relaxed);
+        }
+        return ret;
+    }
+
+    int doneEstimate() noexcept {
+        return elementsPopped.load(std::memory_order_relaxed);
+    }
+
+private:
+    bool popLocal(int worker, Elem &elem) noexcept {
+        auto &shard = *shards[worker];
+        std::lock_guard<std::mutex> guard(shard.lock);
+        if (shard.items.empty()) {
+            return false;
+        }
+        elem = std::move(shard.items.front());
+        shard.items.pop_front();
+        return true;
+    }
+
+    bool steal(int worker, Elem &elem) noexcept {
+        int shardCount = shards.size();
+        for (int offset = 1; offset < shardCount; offset++) {
+            auto &victim = *shards[(worker + offset) % shardCount];
+            std::deque<Elem> stolen;
+            {
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (victim.items.empty()) {
+                    continue;
+                }
+                // Take the back half: the victim keeps its biggest items, which it is already
+                // draining in order.
+                auto half = (victim.items.size() + 1) / 2;
+                auto from = victim.items.end() - half;
+                std::move(from, victim.items.end(), std::back_inserter(stolen));
+                victim.items.erase(from, victim.items.end());
+            }
+            elem = std::move(stolen.front());
+            stolen.pop_front();
+            if (!stolen.empty()) {
+                auto &mine = *shards[worker];
+                std::lock_guard<std::mutex> guard(mine.lock);
+                std::move(stolen.begin(), stolen.end(), std::back_inserter(mine.items));
+            }
+            return true;
+        }
+        return false;
+    }
+};
+
+}; // namespace sorbet
+#endif // SORBET_WORKSTEALINGQUEUE_H
@@ -2,6 +2,7 @@
 #define SORBET_WORKERPOOL_H
 
 #include "common/common.h"
+#include "common/concurrency/InlinedFunction.h"
 #include "spdlog/spdlog.h"
 namespace spd = spdlog;
 namespace sorbet {
@@ -11,9 +12,18 @@ public:
         using namespace std::chrono_literals;
         return 250ms;
     }
-    typedef std::function<void()> Task;
+    // Small captures (the common shape: a few references and shared_ptrs) live inline in the task;
+    // bigger ones fall back to one heap allocation, like std::function always paid.
+    typedef InlinedFunction<void()> Task;
     static std::unique_ptr<WorkerPool> create(int size, spd::logger &logger);
+    // NUMA node the calling thread was assigned to, or 0 for threads that are not pool workers (and
+    // for all threads on single-node machines). Tasks can use this to index per-node data.
+    static int currentThreadNumaNode();
     virtual void multiplexJob(std::string_view taskName, Task t) = 0;
+    virtual int size() const = 0;
+    // How many NUMA nodes the pool's workers are spread across; 1 when the machine has a single
+    // node or the pool is too small to cover more than one.
+    virtual int numaNodeCount() const = 0;
     virtual ~WorkerPool() = 0;
     WorkerPool() = default;
     WorkerPool(WorkerPool &) = delete;
@@ -1,24 +1,39 @@
 #include "common/concurrency/WorkerPoolImpl.h"
+#include "absl/algorithm/container.h"
 #include "absl/strings/str_cat.h"
 #include "common/concurrency/WorkerPool.h"
 
 using namespace std;
 namespace sorbet {
+namespace {
+thread_local int currentNumaNode = 0;
+} // namespace
+
 unique_ptr<WorkerPool> WorkerPool::create(int size, spd::logger &logger) {
     return make_unique<WorkerPoolImpl>(size, logger);
 }
 
+int WorkerPool::currentThreadNumaNode() {
+    return currentNumaNode;
+}
+
 WorkerPool::~WorkerPool() {
     // see https://eli.thegreenplace.net/2010/11/13/pure-virtual-destructors-in-c
 }
 
-WorkerPoolImpl::WorkerPoolImpl(int size, spd::logger &logger) : size(size), logger(logger) {
+WorkerPoolImpl::WorkerPoolImpl(int size, spd::logger &logger) : numThreads(size), logger(logger) {
     logger.debug("Creating {} worker threads", size);
     if (sorbet::emscripten_build) {
         ENFORCE(size == 0);
-        this->size = 0;
+        this->numThreads = 0;
     } else {
         bool pinThreads = (size > 0) && (size == thread::hardware_concurrency());
+        auto nodeCpus = numaNodeCpus();
+        bool numaAware = nodeCpus.size() > 1 && size >= static_cast<int>(nodeCpus.size());
+        if (numaAware) {
+            this->numaNodes = nodeCpus.size();
+            logger.debug("Spreading workers across {} NUMA nodes", this->numaNodes);
+        }
         threadQueues.reserve(size);
         for (int i = 0; i < size; i++) {
             auto &last = threadQueues.emplace_back(make_unique<Queue>());
@@ -28,9 +43,31 @@ WorkerPoolImpl::WorkerPoolImpl(int size, spd::logger &logger) : size(size), logg
             if (pinThreads) {
                 pinToCore = i;
             }
+            int node = 0;
+            vector<int> nodeCpuList;
+            if (numaAware) {
+                if (pinThreads) {
+                    // Core-pinned workers already sit on a fixed node; record which one.
+                    for (int candidate = 0; candidate < this->numaNodes; candidate++) {
+                        if (absl::c_linear_search(nodeCpus[candidate], i)) {
+                            node = candidate;
+                            break;
+                        }
+                    }
+                } else {
+                    // Round-robin workers across nodes and confine each to its node's cpuset so the
+                    // scheduler can't migrate it to remote memory mid-run.
+                    node = i % this->numaNodes;
+                    nodeCpuList = nodeCpus[node];
+                }
+            }
             threads.emplace_back(runInAThread(
                 threadIdleName,
-                [ptr, &logger, threadIdleName]() {
+                [ptr, &logger, threadIdleName, node, nodeCpuList{move(nodeCpuList)}]() {
+                    currentNumaNode = node;
+                    if (!nodeCpuList.empty()) {
+                        bindThreadToCores(pthread_self(), nodeCpuList);
+                    }
                     bool repeat = true;
                     while (repeat) {
                         Task_ task;
@@ -56,7 +93,7 @@ WorkerPoolImpl::~WorkerPoolImpl() {
 }
 
 void WorkerPoolImpl::multiplexJob(string_view taskName, WorkerPool::Task t) {
-    if (size > 0) {
+    if (numThreads > 0) {
         multiplexJob_([t{move(t)}, taskName] {
             setCurrentThreadName(taskName);
             t();
@@ -70,7 +107,7 @@ void WorkerPoolImpl::multiplexJob(string_view taskName, WorkerPool::Task t) {
 
 void WorkerPoolImpl::multiplexJob_(WorkerPoolImpl::Task_ t) {
     logger.debug("Multiplexing job");
-    for (int i = 0; i < size; i++) {
+    for (int i = 0; i < numThreads; i++) {
         threadQueues[i]->enqueue(t);
     }
 }
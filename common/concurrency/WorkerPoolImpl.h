@@ -10,7 +10,8 @@
 namespace spd = spdlog;
 namespace sorbet {
 class WorkerPoolImpl : public WorkerPool {
-    int size;
+    int numThreads;
+    int numaNodes = 1;
     // Tune queue for small size
     struct ConcurrentQueueCustomTraits {
         // General-purpose size type. std::size_t is strongly recommended.
@@ -76,7 +77,10 @@ class WorkerPoolImpl : public WorkerPool {
             return std::free(ptr);
         }
     };
-    typedef std::function<bool()> Task_; // return value indicates if the worker should continie gathering jobs
+    // Return value indicates if the worker should continue gathering jobs. 128 bytes of inline
+    // storage so the multiplexJob wrapper (which holds a WorkerPool::Task plus the task name) still
+    // fits without a heap allocation.
+    typedef InlinedFunction<bool(), 128> Task_;
     typedef moodycamel::BlockingConcurrentQueue<Task_, ConcurrentQueueCustomTraits> Queue;
     // ORDER IS IMPORTANT. threads must be killed before Queues.
     std::vector<std::unique_ptr<Queue>> threadQueues;
@@ -90,6 +94,12 @@ public:
     ~WorkerPoolImpl();
 
     void multiplexJob(std::string_view taskName, Task t) override;
+    int size() const override {
+        return numThreads;
+    }
+    int numaNodeCount() const override {
+        return numaNodes;
+    }
 };
 };     // namespace sorbet
 #endif // SORBET_WORKERPOOL_IMPL_H
@@ -2,6 +2,7 @@
 #define RUBY_TYPER_CRYPTO_HASHING_H
 
 #include "common/common.h"
+#include <cstring>
 extern "C" {
 #ifndef EMSCRIPTEN
 #include "blake2.h"
@@ -24,5 +25,51 @@ inline std::array<u1, 64> hash64(std::string_view data) {
     ENFORCE(err == 0);
     return res;
 };
+
+/**
+ * Fast non-cryptographic 128-bit hash for cache keys and content fingerprints. Collisions only
+ * matter here if an adversary can manufacture them, so content-addressed lookups that are not
+ * security-sensitive should prefer this; hash64 (Blake2b) stays for anything where integrity
+ * matters. xxHash-style: two independently seeded 64-bit lanes, each mixing 8-byte words with
+ * multiply-rotate rounds and an avalanche finalizer.
+ */
+inline std::array<u1, 16> hash128Fast(std::string_view data) {
+    constexpr u8 PRIME1 = 0x9E3779B185EBCA87ULL;
+    constexpr u8 PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr u8 PRIME3 = 0x165667B19E3779F9ULL;
+    auto rotl = [](u8 x, int r) -> u8 { return (x << r) | (x >> (64 - r)); };
+    auto round = [&](u8 acc, u8 input) -> u8 { return rotl(acc + input * PRIME2, 31) * PRIME1; };
+    auto avalanche = [&](u8 h) -> u8 {
+        h ^= h >> 33;
+        h *= PRIME2;
+        h ^= h >> 29;
+        h *= PRIME3;
+        h ^= h >> 32;
+        return h;
+    };
+
+    u8 lane1 = PRIME1 + data.size();
+    u8 lane2 = PRIME2 ^ data.size();
+    size_t i = 0;
+    u8 word;
+    for (; i + 8 <= data.size(); i += 8) {
+        memcpy(&word, data.data() + i, 8);
+        lane1 = round(lane1, word);
+        lane2 = round(lane2, word + PRIME3);
+    }
+    word = 0;
+    if (i < data.size()) {
+        memcpy(&word, data.data() + i, data.size() - i);
+    }
+    lane1 = round(lane1, word);
+    lane2 = round(lane2, word + PRIME3);
+
+    lane1 = avalanche(lane1);
+    lane2 = avalanche(lane2);
+    std::array<u1, 16> res;
+    memcpy(&res[0], &lane1, 8);
+    memcpy(&res[8], &lane2, 8);
+    return res;
+};
 } // namespace sorbet::crypto_hashing
 #endif // RUBY_TYPER_CRYPTO_HASHING_H
@@ -1,4 +1,5 @@
 #include "common/kvstore/KeyValueStore.h"
+#include "common/FileOps.h"
 
 #include <utility>
 
@@ -7,91 +8,143 @@ namespace sorbet {
 constexpr string_view OLD_VERSION_KEY = "VERSION"sv;
 constexpr string_view VERSION_KEY = "DB_FORMAT_VERSION"sv;
 constexpr size_t MAX_DB_SIZE_BYTES =
-    1L * 1024 * 1024 * 1024; // 1G. This is both maximum fs db size and max virtual memory usage.
+    1L * 1024 * 1024 * 1024; // 1G. This is both maximum fs db size and max virtual memory usage, per shard.
 
 static void throw_mdb_error(string_view what, int err) {
     fmt::print(stderr, "mdb error: {}: {}\n", what, mdb_strerror(err));
     throw invalid_argument(string(what));
 }
 
-KeyValueStore::KeyValueStore(string version, string path, string flavor)
-    : path(move(path)), flavor(move(flavor)), writerId(this_thread::get_id()) {
-    int rc;
-    rc = mdb_env_create(&env);
-    if (rc != 0) {
-        goto fail;
-    }
-    rc = mdb_env_set_mapsize(env, MAX_DB_SIZE_BYTES);
-    if (rc != 0) {
-        goto fail;
+// FNV-1a. Shard assignment must be stable across processes and builds (entries persist in the
+// shard their key hashed to), which rules out std::hash and the per-process-seeded absl hashes.
+static size_t stableHash(string_view key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : key) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
     }
-    rc = mdb_env_set_maxdbs(env, 3);
-    if (rc != 0) {
-        goto fail;
-    }
-    rc = mdb_env_open(env, this->path.c_str(), 0, 0664);
-    if (rc != 0) {
-        goto fail;
-    }
-    refreshMainTransaction();
-    {
-        if (read(OLD_VERSION_KEY)) { // remove databases that use old(non-string) versioning scheme.
-            clear();
+    return hash;
+}
+
+LmdbKeyValueStore::LmdbKeyValueStore(string version, string path, string flavor)
+    : path(move(path)), flavor(move(flavor)), writerId(this_thread::get_id()) {
+    for (size_t i = 0; i < shards.size(); i++) {
+        auto &shard = shards[i];
+        auto shardPath = fmt::format("{}/shard-{}", this->path, i);
+        if (!FileOps::dirExists(shardPath)) {
+            FileOps::createDir(shardPath);
         }
-        auto dbVersion = readString(VERSION_KEY);
-        if (dbVersion != version) {
-            clear();
-            writeString(VERSION_KEY, version);
+        int rc;
+        rc = mdb_env_create(&shard.env);
+        if (rc != 0) {
+            goto fail;
         }
-        return;
+        rc = mdb_env_set_mapsize(shard.env, MAX_DB_SIZE_BYTES);
+        if (rc != 0) {
+            goto fail;
+        }
+        rc = mdb_env_set_maxdbs(shard.env, 3);
+        if (rc != 0) {
+            goto fail;
+        }
+        rc = mdb_env_open(shard.env, shardPath.c_str(), 0, 0664);
+        if (rc != 0) {
+            goto fail;
+        }
+        refreshMainTransaction(shard);
+        {
+            // Every shard carries its own copy of the version so each can detect staleness on its
+            // own; a partially-written cache just means some shards clear and others do not.
+            if (readShard(shard, OLD_VERSION_KEY)) { // remove databases that use old(non-string) versioning scheme.
+                clear(shard);
+            }
+            string_view dbVersion;
+            auto rawData = readShard(shard, VERSION_KEY);
+            if (rawData) {
+                size_t sz;
+                memcpy(&sz, rawData, sizeof(sz));
+                dbVersion = string_view(((const char *)rawData) + sizeof(sz), sz);
+            }
+            if (dbVersion != version) {
+                clear(shard);
+                // Written through the startup transaction rather than staged: a cleared shard
+                // must come out versioned even if this run never commits.
+                size_t sz = version.size();
+                vector<u1> rawValue(sz + sizeof(sz));
+                memcpy(rawValue.data(), &sz, sizeof(sz));
+                memcpy(rawValue.data() + sizeof(sz), version.data(), sz);
+                MDB_val kv;
+                MDB_val dv;
+                kv.mv_size = VERSION_KEY.size();
+                kv.mv_data = (void *)VERSION_KEY.data();
+                dv.mv_size = rawValue.size();
+                dv.mv_data = (void *)rawValue.data();
+                rc = mdb_put(shard.txn, shard.dbi, &kv, &dv, 0);
+                if (rc != 0) {
+                    goto fail;
+                }
+            }
+        }
+        // Writes are staged in memory from here on, and doCommit() may run on another thread. LMDB
+        // write transactions cannot cross threads, so finish the startup transaction now and
+        // release the writer lock; the writer thread will read through its own read-only
+        // transaction like everybody else.
+        {
+            absl::WriterMutexLock lk(&shard.readers_mtx);
+            shard.readers.erase(writerId);
+        }
+        rc = mdb_txn_commit(shard.txn);
+        if (rc != 0) {
+            goto fail;
+        }
+        shard.txn = nullptr;
+        continue;
+    fail:
+        throw_mdb_error("failed to create database"sv, rc);
     }
-fail:
-    throw_mdb_error("failed to create database"sv, rc);
 }
-KeyValueStore::~KeyValueStore() noexcept(false) {
+LmdbKeyValueStore::~LmdbKeyValueStore() noexcept(false) {
     if (commited) {
         return;
     }
 
-    mdb_txn_abort(txn);
-    mdb_close(env, dbi);
-    mdb_env_close(env);
+    for (auto &shard : shards) {
+        mdb_close(shard.env, shard.dbi);
+        mdb_env_close(shard.env);
+    }
 }
 
-void KeyValueStore::write(string_view key, const vector<u1> &value) {
+void LmdbKeyValueStore::write(string_view key, const vector<u1> &value) {
     if (writerId != this_thread::get_id()) {
         throw invalid_argument("KeyValueStore can only write from thread that created it");
     }
-    MDB_val kv;
-    MDB_val dv;
-    kv.mv_size = key.size();
-    kv.mv_data = (void *)key.data();
-    dv.mv_size = value.size();
-    dv.mv_data = (void *)value.data();
+    staged.emplace_back(string(key), value);
+}
 
-    int rc;
-    rc = mdb_put(txn, dbi, &kv, &dv, 0);
-    if (rc != 0) {
-        throw invalid_argument("failed write into database");
-    }
+LmdbKeyValueStore::Shard &LmdbKeyValueStore::shardFor(string_view key) {
+    return shards[stableHash(key) % shards.size()];
 }
 
-u1 *KeyValueStore::read(string_view key) {
+u1 *LmdbKeyValueStore::read(string_view key) {
+    return readShard(shardFor(key), key);
+}
+
+u1 *LmdbKeyValueStore::readShard(Shard &shard, string_view key) {
     MDB_txn *txn = nullptr;
     int rc = 0;
     {
-        absl::ReaderMutexLock lk(&readers_mtx);
-        auto fnd = readers.find(this_thread::get_id());
-        if (fnd != readers.end()) {
+        absl::ReaderMutexLock lk(&shard.readers_mtx);
+        auto fnd = shard.readers.find(this_thread::get_id());
+        if (fnd != shard.readers.end()) {
             txn = fnd->second;
             ENFORCE(txn != nullptr);
         }
     }
     if (txn == nullptr) {
-        absl::WriterMutexLock lk(&readers_mtx);
-        auto &txn_store = readers[this_thread::get_id()];
+        absl::WriterMutexLock lk(&shard.readers_mtx);
+        auto &txn_store = shard.readers[this_thread::get_id()];
         ENFORCE(txn_store == nullptr);
-        rc = mdb_txn_begin(env, nullptr, MDB_RDONLY, &txn_store);
+        rc = mdb_txn_begin(shard.env, nullptr, MDB_RDONLY, &txn_store);
         txn = txn_store;
     }
     if (rc != 0) {
@@ -102,7 +155,7 @@ u1 *KeyValueStore::read(string_view key) {
     kv.mv_size = key.size();
     kv.mv_data = (void *)key.data();
     MDB_val data;
-    rc = mdb_get(txn, dbi, &kv, &data);
+    rc = mdb_get(txn, shard.dbi, &kv, &data);
     if (rc != 0) {
         if (rc == MDB_NOTFOUND) {
             return nullptr;
@@ -112,25 +165,25 @@ u1 *KeyValueStore::read(string_view key) {
     return (u1 *)data.mv_data;
 }
 
-void KeyValueStore::clear() {
+void LmdbKeyValueStore::clear(Shard &shard) {
     if (writerId != this_thread::get_id()) {
         throw invalid_argument("KeyValueStore can only write from thread that created it");
     }
-    int rc = mdb_drop(txn, dbi, 0);
+    int rc = mdb_drop(shard.txn, shard.dbi, 0);
     if (rc != 0) {
         goto fail;
     }
-    rc = mdb_txn_commit(txn);
+    rc = mdb_txn_commit(shard.txn);
     if (rc != 0) {
         goto fail;
     }
-    refreshMainTransaction();
+    refreshMainTransaction(shard);
     return;
 fail:
     throw_mdb_error("failed to clear the database"sv, rc);
 }
 
-string_view KeyValueStore::readString(string_view key) {
+string_view LmdbKeyValueStore::readString(string_view key) {
     auto rawData = read(key);
     if (!rawData) {
         return string_view();
@@ -141,7 +194,7 @@ string_view KeyValueStore::readString(string_view key) {
     return result;
 }
 
-void KeyValueStore::writeString(string_view key, string_view value) {
+void LmdbKeyValueStore::writeString(string_view key, string_view value) {
     vector<u1> rawData(value.size() + sizeof(size_t));
     size_t sz = value.size();
     memcpy(rawData.data(), &sz, sizeof(sz));
@@ -149,15 +202,15 @@ void KeyValueStore::writeString(string_view key, string_view value) {
     write(key, move(rawData));
 }
 
-void KeyValueStore::refreshMainTransaction() {
+void LmdbKeyValueStore::refreshMainTransaction(Shard &shard) {
     if (writerId != this_thread::get_id()) {
         throw invalid_argument("KeyValueStore can only write from thread that created it");
     }
-    auto rc = mdb_txn_begin(env, nullptr, 0, &txn);
+    auto rc = mdb_txn_begin(shard.env, nullptr, 0, &shard.txn);
     if (rc != 0) {
         goto fail;
     }
-    rc = mdb_dbi_open(txn, flavor.c_str(), MDB_CREATE, &dbi);
+    rc = mdb_dbi_open(shard.txn, flavor.c_str(), MDB_CREATE, &shard.dbi);
     if (rc != 0) {
         goto fail;
     }
@@ -173,17 +226,17 @@ void KeyValueStore::refreshMainTransaction() {
     // So we commit immediately to force the dbi into the shared space
     // so that readers can use it, and then re-open the transaction
     // for future writes.
-    rc = mdb_txn_commit(txn);
+    rc = mdb_txn_commit(shard.txn);
     if (rc != 0) {
         goto fail;
     }
-    rc = mdb_txn_begin(env, nullptr, 0, &txn);
+    rc = mdb_txn_begin(shard.env, nullptr, 0, &shard.txn);
     if (rc != 0) {
         goto fail;
     }
     {
-        absl::WriterMutexLock lk(&readers_mtx);
-        readers[writerId] = txn;
+        absl::WriterMutexLock lk(&shard.readers_mtx);
+        shard.readers[writerId] = shard.txn;
     }
     return;
 fail:
@@ -191,16 +244,55 @@ fail:
 }
 
 bool KeyValueStore::commit(unique_ptr<KeyValueStore> k) {
-    int rc;
-    k->commited = true;
-    rc = mdb_txn_commit(k->txn);
+    return k->doCommit();
+}
 
-    if (rc != 0) {
-        return false;
+unique_ptr<Joinable> KeyValueStore::commitInBackground(unique_ptr<KeyValueStore> k) {
+    // std::function must be copyable, so the store rides along in a shared_ptr.
+    shared_ptr<KeyValueStore> store = move(k);
+    return runInAThread("kvstore.commit", [store]() { store->doCommit(); });
+}
+
+bool LmdbKeyValueStore::doCommit() {
+    // May run on a thread other than the writer's: LMDB write transactions must begin and end on
+    // the same thread, so the transactions live entirely within this call.
+    commited = true;
+    bool success = true;
+    for (auto &shard : shards) {
+        MDB_txn *commitTxn = nullptr;
+        int rc = mdb_txn_begin(shard.env, nullptr, 0, &commitTxn);
+        if (rc != 0) {
+            success = false;
+        } else {
+            for (auto &entry : staged) {
+                if (&shardFor(entry.first) != &shard) {
+                    continue;
+                }
+                MDB_val kv;
+                MDB_val dv;
+                kv.mv_size = entry.first.size();
+                kv.mv_data = (void *)entry.first.data();
+                dv.mv_size = entry.second.size();
+                dv.mv_data = (void *)entry.second.data();
+                rc = mdb_put(commitTxn, shard.dbi, &kv, &dv, 0);
+                if (rc != 0) {
+                    break;
+                }
+            }
+            if (rc != 0) {
+                mdb_txn_abort(commitTxn);
+                success = false;
+            } else if (mdb_txn_commit(commitTxn) != 0) {
+                success = false;
+            }
+        }
+        // Close the shard even when its commit failed: a partially-committed cache is fine (each
+        // entry stands alone), and the environments must not leak.
+        mdb_close(shard.env, shard.dbi);
+        mdb_env_close(shard.env);
     }
-    mdb_close(k->env, k->dbi);
-    mdb_env_close(k->env);
-    return true;
+    staged.clear();
+    return success;
 }
 
 } // namespace sorbet
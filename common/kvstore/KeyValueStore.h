@@ -2,32 +2,89 @@
 #define SORBET_KEYVALUESTORE_H
 #include "absl/synchronization/mutex.h"
 #include "common/common.h"
+#include "common/os/os.h"
 #include "lmdb.h"
+#include <array>
 #include <thread>
 namespace sorbet {
 
 /**
- * A database with single writer and multiple readers.
- * Only the thread that created KeyValueStore is allowed to invoke Write.
- * Creating KeyValueStore grabs a lock and allows to have consistent view over database.
+ * The cache the pipeline reads and writes serialized artifacts through.
+ *
+ * Callers only ever hold a unique_ptr<KeyValueStore>, so alternative backends — for example a
+ * remote content-addressed store that reads through to the local LMDB cache and writes back
+ * asynchronously — can be slotted in without touching the pipeline.
  */
 class KeyValueStore {
-    MDB_env *env;
-    MDB_dbi dbi;
-    MDB_txn *txn;
+public:
+    KeyValueStore() = default;
+    KeyValueStore(const KeyValueStore &) = delete;
+    KeyValueStore &operator=(const KeyValueStore &) = delete;
+    virtual ~KeyValueStore() noexcept(false) {}
+
+    /** returns nullptr if not found. The returned memory is owned by the store and stays valid
+     * until the store is committed or destroyed. */
+    virtual u1 *read(std::string_view key) = 0;
+    virtual std::string_view readString(std::string_view key) = 0;
+    virtual void writeString(std::string_view key, std::string_view value) = 0;
+    /** can only be called from the thread that created the store */
+    virtual void write(std::string_view key, const std::vector<u1> &value) = 0;
+
+    /** Persist everything written to the store so far; returns false on failure. */
+    static bool commit(std::unique_ptr<KeyValueStore>);
+
+    /** Like commit, but runs on a background thread so that the caller never blocks on cache
+     * persistence. The returned handle joins the thread when destroyed; hold on to it until the
+     * end of the run. */
+    static std::unique_ptr<Joinable> commitInBackground(std::unique_ptr<KeyValueStore>);
+
+protected:
+    /** Backend-specific half of commit(); called at most once. */
+    virtual bool doCommit() = 0;
+};
+
+/**
+ * The local-disk LMDB backend.
+ *
+ * A database with single writer and multiple readers.
+ * Only the thread that created the store is allowed to invoke write.
+ * Creating the store grabs a lock and allows to have consistent view over database.
+ *
+ * The store is sharded by key hash across several LMDB environments, each in its own subdirectory
+ * of `path`. Readers in different shards touch disjoint reader-transaction maps (and disjoint LMDB
+ * reader tables), so parallel cache reads from a full worker pool spread across shards instead of
+ * serializing on one mutex.
+ */
+class LmdbKeyValueStore final : public KeyValueStore {
+    // Shard assignment is persisted implicitly (a key's value lives in the shard it hashes to), so
+    // changing this orphans existing entries: the next run just misses and rewrites them.
+    static constexpr size_t SHARD_COUNT = 8;
+
+    struct Shard {
+        MDB_env *env = nullptr;
+        MDB_dbi dbi;
+        MDB_txn *txn = nullptr; // the startup write transaction; writer thread only
+        UnorderedMap<std::thread::id, MDB_txn *> readers;
+        absl::Mutex readers_mtx;
+    };
+    std::array<Shard, SHARD_COUNT> shards;
     const std::string path;
     const std::string flavor;
     const std::thread::id writerId;
-    UnorderedMap<std::thread::id, MDB_txn *> readers;
-    absl::Mutex readers_mtx;
     bool commited = false;
 
-    void clear();
-    void refreshMainTransaction();
+    // Writes are staged here and only hit LMDB in doCommit(). Staged values are not visible to
+    // read() within the same process; no caller reads a key it wrote.
+    std::vector<std::pair<std::string, std::vector<u1>>> staged;
+
+    Shard &shardFor(std::string_view key);
+    u1 *readShard(Shard &shard, std::string_view key);
+    void clear(Shard &shard);
+    void refreshMainTransaction(Shard &shard);
 
 public:
     /**
-     * A KeyValueStore lives at a given `path` on disk, which must be
+     * An LmdbKeyValueStore lives at a given `path` on disk, which must be
      * a pre-existing, writeable, directory.
      *
      * `version` contains a string naming the format of the data
@@ -40,18 +97,18 @@ public:
      * Multiple `flavor`s, however, may coexist within the
      * database. `flavor` should encode the set of configuration or
      * other options that may affect the cached data. Two
-     * `KeyValueStore`s opened with different `flavor`s will not share
+     * stores opened with different `flavor`s will not share
      * any entries, but each will see their own set of values.
      */
-    KeyValueStore(std::string version, std::string path, std::string flavor);
-    /** returns nullptr if not found*/
-    u1 *read(std::string_view key);
-    std::string_view readString(std::string_view key);
-    void writeString(std::string_view key, std::string_view value);
-    /** can only be called from main thread */
-    void write(std::string_view key, const std::vector<u1> &value);
-    ~KeyValueStore() noexcept(false);
-    static bool commit(std::unique_ptr<KeyValueStore>);
+    LmdbKeyValueStore(std::string version, std::string path, std::string flavor);
+    u1 *read(std::string_view key) override;
+    std::string_view readString(std::string_view key) override;
+    void writeString(std::string_view key, std::string_view value) override;
+    void write(std::string_view key, const std::vector<u1> &value) override;
+    ~LmdbKeyValueStore() noexcept(false) override;
+
+protected:
+    bool doCommit() override;
 };
 } // namespace sorbet
 
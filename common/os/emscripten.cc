@@ -1,5 +1,7 @@
 #ifdef EMSCRIPTEN
+#include <pthread.h>
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -7,6 +9,14 @@ bool stopInDebugger() {
     return false;
 }
 
+bool bindThreadToCores(pthread_t handle, const vector<int> &coreIds) {
+    return false;
+}
+
+vector<vector<int>> numaNodeCpus() {
+    return {};
+}
+
 string getProgramName() {
     return "sorbet";
 }
@@ -108,4 +108,50 @@ bool bindThreadToCore(pthread_t handle, int coreId) {
     int rc = pthread_setaffinity_np(handle, sizeof(cpu_set_t), &cpuset);
     return rc == 0;
 }
+
+bool bindThreadToCores(pthread_t handle, const vector<int> &coreIds) {
+    if (coreIds.empty()) {
+        return false;
+    }
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (auto coreId : coreIds) {
+        CPU_SET(coreId, &cpuset);
+    }
+    int rc = pthread_setaffinity_np(handle, sizeof(cpu_set_t), &cpuset);
+    return rc == 0;
+}
+
+vector<vector<int>> numaNodeCpus() {
+    vector<vector<int>> nodes;
+    for (int node = 0;; node++) {
+        // The kernel publishes each node's CPUs as a comma-separated list of ranges, e.g.
+        // "0-31,64-95" on a hyperthreaded dual-socket box.
+        auto path = "/sys/devices/system/node/node" + to_string(node) + "/cpulist";
+        FILE *f = fopen(path.c_str(), "r");
+        if (f == nullptr) {
+            break;
+        }
+        char buf[4096];
+        vector<int> cpus;
+        if (fgets(buf, sizeof(buf), f) != nullptr) {
+            char *cursor = buf;
+            while (*cursor != '\0' && *cursor != '\n') {
+                char *end = nullptr;
+                long first = strtol(cursor, &end, 10);
+                long last = first;
+                if (*end == '-') {
+                    last = strtol(end + 1, &end, 10);
+                }
+                for (long cpu = first; cpu <= last; cpu++) {
+                    cpus.emplace_back(static_cast<int>(cpu));
+                }
+                cursor = *end == ',' ? end + 1 : end;
+            }
+        }
+        fclose(f);
+        nodes.emplace_back(move(cpus));
+    }
+    return nodes;
+}
 #endif
@@ -87,4 +87,14 @@ bool bindThreadToCore(pthread_t handle, int coreId) {
     auto ret = thread_policy_set(mach_thread, THREAD_AFFINITY_POLICY, (thread_policy_t)&policy, 1);
     return ret == 0;
 }
+
+bool bindThreadToCores(pthread_t handle, const vector<int> &coreIds) {
+    // Mach affinity tags can't express "any of these cores"; treat the machine as uniform.
+    return false;
+}
+
+vector<vector<int>> numaNodeCpus() {
+    // Darwin doesn't expose a NUMA topology.
+    return {};
+}
 #endif
@@ -5,6 +5,7 @@
 #include <optional>
 #include <pthread.h>
 #include <string>
+#include <vector>
 
 std::string addr2line(std::string_view programName, void const *const *addr, int count);
 
@@ -37,6 +38,12 @@ std::unique_ptr<Joinable> runInAThread(std::string_view threadName, std::functio
                                        std::optional<int> bindToCore = std::nullopt);
 bool setCurrentThreadName(std::string_view name);
 bool bindThreadToCore(pthread_t handle, int coreId);
+bool bindThreadToCores(pthread_t handle, const std::vector<int> &coreIds);
+
+// CPU ids per NUMA node, indexed by node id. Empty on platforms that do not expose the topology
+// (mac, emscripten) and on machines the kernel reports as a single node; callers should treat
+// anything smaller than two nodes as "not NUMA".
+std::vector<std::vector<int>> numaNodeCpus();
 
 /** The should trigger debugger breakpoint if the debugger is attached, if no debugger is attach, it should do nothing
  *  This allows to:
@@ -1,4 +1,5 @@
 #include "common/statsd/statsd.h"
+#include "common/os/os.h"
 using namespace std;
 
 namespace sorbet {
@@ -9,4 +10,12 @@ bool StatsD::submitCounters(const CounterState &counters, string_view host, int
 
 void StatsD::addRusageStats() {}
 
+// No threads and no sockets under emscripten; the exporter swallows everything.
+StatsDExporter::StatsDExporter(string_view host, int port, string_view prefix, shared_ptr<spdlog::logger> logger)
+    : host(host), port(port), prefix(prefix), logger(move(logger)) {}
+
+StatsDExporter::~StatsDExporter() = default;
+
+void StatsDExporter::submit(CounterState counters) {}
+
 } // namespace sorbet
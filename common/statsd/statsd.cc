@@ -7,6 +7,9 @@ extern "C" {
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_replace.h"
+#include "common/concurrency/ConcurrentQueue.h"
+#include "common/concurrency/WorkerPool.h"
+#include "common/os/os.h"
 
 #include <string>
 #include <sys/resource.h> // getrusage
@@ -54,14 +57,23 @@ public:
     void gauge(string_view name, size_t value) { // type : g
         addMetric(name, value, "g");
     }
-    void timing(const CounterImpl::Timing &tim) { // type: ms
+    void timing(const CounterImpl::Timing &tim, bool includeArgs) { // type: ms
         auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(tim.end - tim.start).count();
         addMetric(absl::StrCat(tim.measure, ".duration_ns"), nanoseconds,
                   "ms"); // format suggested by #observability (@sjung and @an)
+        if (includeArgs) {
+            for (const auto &arg : tim.args) {
+                // Path separators and dots would otherwise splinter the metric hierarchy.
+                addMetric(absl::StrCat(tim.measure, ".", arg.first, ".",
+                                       absl::StrReplaceAll(arg.second, {{"/", "_"}, {".", "_"}}), ".duration_ns"),
+                          nanoseconds, "ms");
+            }
+        }
     }
 };
 
-bool StatsD::submitCounters(const CounterState &counters, string_view host, int port, string_view prefix) {
+bool StatsD::submitCounters(const CounterState &counters, string_view host, int port, string_view prefix,
+                            bool includeTimingArgs) {
     StatsdClientWrapper statsd(string(host), port, string(prefix));
 
     counters.counters->canonicalize();
@@ -91,12 +103,63 @@ bool StatsD::submitCounters(const CounterState &counters, string_view host, int
 
     UnorderedMap<int, CounterImpl::Timing> flowStarts;
     for (const auto &e : counters.counters->timings) {
-        statsd.timing(e);
+        statsd.timing(e, includeTimingArgs);
     }
 
     return true;
 }
 
+struct StatsDExporter::Queue {
+    BlockingUnBoundedQueue<CounterState> q;
+};
+
+namespace {
+// Snapshots arrive minutes apart in steady state, so even a small backlog means the network path
+// has been stuck for a long time.
+constexpr int MAX_QUEUED_SNAPSHOTS = 8;
+} // namespace
+
+StatsDExporter::StatsDExporter(string_view host, int port, string_view prefix,
+                               shared_ptr<spdlog::logger> logger)
+    : host(host), port(port), prefix(prefix), logger(move(logger)), queue(make_shared<Queue>()) {
+    auto q = this->queue;
+    thread = runInAThread("statsdExporter", [q, log = this->logger, host = this->host, port = this->port,
+                                             prefix = this->prefix]() {
+        CounterState job;
+        while (true) {
+            auto result = q->q.wait_pop_timed(job, WorkerPool::BLOCK_INTERVAL(), *log);
+            if (!result.gotItem()) {
+                continue;
+            }
+            if (job.hasNullCounters()) {
+                // Poison pill pushed by the destructor; everything queued before it has been sent.
+                return;
+            }
+            StatsD::submitCounters(job, host, port, prefix);
+        }
+    });
+}
+
+StatsDExporter::~StatsDExporter() {
+    queue->q.push(CounterState(), 1);
+    // Joinable's destructor waits for the thread, which drains the queue up to the poison pill, so
+    // nothing submitted before shutdown is silently lost.
+}
+
+void StatsDExporter::submit(CounterState counters) {
+    if (counters.hasNullCounters()) {
+        return;
+    }
+    if (queue->q.enqueuedEstimate() - queue->q.doneEstimate() >= MAX_QUEUED_SNAPSHOTS) {
+        // Shedding load: the process being observed must not pay for a stuck metrics sink. The
+        // dropped counters are lost, which gauge semantics tolerate; the drop itself rides along in
+        // the submitting thread's counters and reaches statsd with a later snapshot.
+        prodCounterInc("statsd.exporter.dropped_snapshots");
+        return;
+    }
+    queue->q.push(move(counters), 1);
+}
+
 void StatsD::addRusageStats() {
     struct rusage usage;
     if (getrusage(RUSAGE_SELF, &usage) == 0) {
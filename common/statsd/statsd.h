@@ -2,6 +2,13 @@
 #define SORBET_CORE_STATSD_H
 
 #include "core/core.h"
+#include <memory>
+
+namespace spdlog {
+class logger;
+}
+
+class Joinable;
 
 namespace sorbet {
 class StatsD {
@@ -10,7 +17,43 @@ public:
 
     /** Adds standard process-related metrics (RSS, faults, etc). */
     static void addRusageStats();
-    static bool submitCounters(const CounterState &counters, std::string_view host, int port, std::string_view prefix);
+    /** When `includeTimingArgs` is set, each timing additionally produces one metric per timer
+     * arg (e.g. `<measure>.file.<path>.duration_ns`), giving per-phase, per-file resolution.
+     * Reserved for sampled runs: the metric-name cardinality is too high to emit on every run. */
+    static bool submitCounters(const CounterState &counters, std::string_view host, int port, std::string_view prefix,
+                               bool includeTimingArgs = false);
+};
+
+/**
+ * Ships counter snapshots to statsd from a background thread, so the thread being measured (e.g.
+ * the LSP main loop) never blocks on DNS resolution or socket sends. Snapshots are handed off
+ * through a queue with a small cap; if the exporter falls behind (unreachable host, slow DNS), new
+ * snapshots are dropped rather than queued without bound. Metrics within one snapshot are batched
+ * into multi-metric datagrams by submitCounters.
+ */
+class StatsDExporter final {
+    struct Queue;
+
+    const std::string host;
+    const int port;
+    const std::string prefix;
+    std::shared_ptr<spdlog::logger> logger;
+    std::shared_ptr<Queue> queue;
+    std::unique_ptr<Joinable> thread;
+
+public:
+    StatsDExporter(std::string_view host, int port, std::string_view prefix, std::shared_ptr<spdlog::logger> logger);
+    /** Flushes whatever is already queued, then stops the background thread. */
+    ~StatsDExporter();
+
+    StatsDExporter(const StatsDExporter &) = delete;
+    StatsDExporter &operator=(const StatsDExporter &) = delete;
+
+    /**
+     * Hands `counters` to the background thread. Never blocks; on overload the snapshot is dropped
+     * and statsd.exporter.dropped_snapshots (in the submitting thread's counters) records it.
+     */
+    void submit(CounterState counters);
 };
 } // namespace sorbet
 
@@ -12,4 +12,16 @@ TEST(CommonTest, Levenstein) { // NOLINT
     EXPECT_EQ(INT_MAX, Levenstein::distance("Java", "S", 1));
 }
 
+TEST(CommonTest, LevensteinBound) { // NOLINT
+    // The bound is inclusive: a distance exactly at the bound is still reported exactly.
+    EXPECT_EQ(5, Levenstein::distance("Ruby", "Scala", 5));
+    EXPECT_EQ(3, Levenstein::distance("Java", "Scala", 3));
+    // Anything past the bound comes back as INT_MAX, even when the lengths are close.
+    EXPECT_EQ(INT_MAX, Levenstein::distance("Ruby", "Scala", 4));
+    EXPECT_EQ(INT_MAX, Levenstein::distance("Mama", "Papa", 1));
+    EXPECT_EQ(0, Levenstein::distance("", "", 0));
+    EXPECT_EQ(3, Levenstein::distance("", "abc", 3));
+    EXPECT_EQ(INT_MAX, Levenstein::distance("", "abc", 2));
+}
+
 } // namespace sorbet::common
@@ -0,0 +1,76 @@
+#include "gtest/gtest.h"
+// violates our requirements, thus has to go first
+#include "common/concurrency/InlinedFunction.h"
+
+#include <memory>
+#include <string>
+
+namespace sorbet::common {
+
+TEST(InlinedFunctionTest, SmallCaptureInvokes) { // NOLINT
+    int hits = 0;
+    InlinedFunction<void()> task([&hits] { hits++; });
+    task();
+    task();
+    EXPECT_EQ(2, hits);
+}
+
+TEST(InlinedFunctionTest, CopiesAreIndependent) { // NOLINT
+    auto counter = std::make_shared<int>(0);
+    InlinedFunction<void()> task([counter] { (*counter)++; });
+    auto copy = task;
+    task();
+    copy();
+    EXPECT_EQ(2, *counter);
+    // Both the original and the copy hold the shared capture.
+    EXPECT_EQ(3, counter.use_count());
+}
+
+TEST(InlinedFunctionTest, MoveLeavesSourceEmpty) { // NOLINT
+    auto counter = std::make_shared<int>(0);
+    InlinedFunction<void()> task([counter] { (*counter)++; });
+    counter.reset();
+    InlinedFunction<void()> moved(std::move(task));
+    EXPECT_FALSE(static_cast<bool>(task)); // NOLINT(bugprone-use-after-move): post-move state is the point
+    EXPECT_TRUE(static_cast<bool>(moved));
+    moved();
+}
+
+TEST(InlinedFunctionTest, LargeCaptureFallsBackToHeap) { // NOLINT
+    // Way past the inline budget; exercises the heap path's copy/move/destroy.
+    std::string a(100, 'a');
+    std::string b(100, 'b');
+    std::string c(100, 'c');
+    InlinedFunction<size_t()> task([a, b, c] { return a.size() + b.size() + c.size(); });
+    auto copy = task;
+    InlinedFunction<size_t()> moved(std::move(copy));
+    EXPECT_EQ(300, task());
+    EXPECT_EQ(300, moved());
+}
+
+TEST(InlinedFunctionTest, ArgumentsAndReturnValues) { // NOLINT
+    InlinedFunction<int(int, int)> add([](int x, int y) { return x + y; });
+    EXPECT_EQ(7, add(3, 4));
+
+    int sink = 0;
+    InlinedFunction<bool(int)> record([&sink](int x) {
+        sink = x;
+        return x > 0;
+    });
+    EXPECT_TRUE(record(5));
+    EXPECT_EQ(5, sink);
+}
+
+TEST(InlinedFunctionTest, AssignmentReplacesTarget) { // NOLINT
+    auto first = std::make_shared<int>(0);
+    auto second = std::make_shared<int>(0);
+    InlinedFunction<void()> task([first] { (*first)++; });
+    task = InlinedFunction<void()>([second] { (*second)++; });
+    // The original capture was destroyed by the assignment.
+    EXPECT_EQ(1, first.use_count());
+    task();
+    EXPECT_EQ(0, *first);
+    EXPECT_EQ(1, *second);
+}
+
+} // namespace sorbet::common
@@ -0,0 +1,175 @@
+#include "common/web_tracer_framework/sampling.h"
+
+#ifdef EMSCRIPTEN
+
+namespace sorbet::web_tracer_framework {
+bool SamplingProfiler::start(int intervalMicros) {
+    return false;
+}
+bool SamplingProfiler::stop(std::string_view traceFile) {
+    return false;
+}
+bool SamplingProfiler::isRunning() {
+    return false;
+}
+} // namespace sorbet::web_tracer_framework
+
+#else
+
+#include "common/FileOps.h"
+#include "common/common.h"
+
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <ctime>
+#include <dlfcn.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace sorbet::web_tracer_framework {
+
+namespace {
+
+constexpr int MAX_FRAMES = 48;
+constexpr int MAX_SAMPLES = 1 << 14;
+
+struct Sample {
+    struct timespec when;
+    int frameCount;
+    void *pcs[MAX_FRAMES];
+};
+
+// Written only by the signal handler while `running` is true; drained by stop() after the timer
+// is disarmed, so no sample is ever read while it is being written.
+Sample *samples = nullptr;
+atomic<int> sampleCount{0};
+atomic<bool> running{false};
+
+void onSigprof(int, siginfo_t *, void *) {
+    if (!running.load(memory_order_relaxed)) {
+        return;
+    }
+    auto idx = sampleCount.fetch_add(1, memory_order_relaxed);
+    if (idx >= MAX_SAMPLES) {
+        return;
+    }
+    auto &sample = samples[idx];
+    // CLOCK_MONOTONIC is what steady_clock reads on our platforms, so these timestamps land on
+    // the same axis as the Timer spans already in the trace.
+    clock_gettime(CLOCK_MONOTONIC, &sample.when);
+    sample.frameCount = 0;
+
+    // Walk saved frame pointers starting from our own frame. The top entries are this handler and
+    // the signal trampoline; offline symbolization strips them. Every step is bounds-checked: the
+    // chain must be aligned, march up the stack, and stay within a sane distance, or we stop
+    // rather than fault on a frame the compiler did not link.
+    void **fp = static_cast<void **>(__builtin_frame_address(0));
+    while (sample.frameCount < MAX_FRAMES && fp != nullptr &&
+           (reinterpret_cast<uintptr_t>(fp) & (sizeof(void *) - 1)) == 0) {
+        void *ret = fp[1];
+        if (ret == nullptr) {
+            break;
+        }
+        sample.pcs[sample.frameCount++] = ret;
+        void **next = static_cast<void **>(fp[0]);
+        if (next <= fp || reinterpret_cast<char *>(next) - reinterpret_cast<char *>(fp) > (1 << 20)) {
+            break;
+        }
+        fp = next;
+    }
+}
+
+} // namespace
+
+bool SamplingProfiler::isRunning() {
+    return running.load(memory_order_relaxed);
+}
+
+bool SamplingProfiler::start(int intervalMicros) {
+    if (intervalMicros <= 0 || running.load(memory_order_relaxed)) {
+        return false;
+    }
+    if (samples == nullptr) {
+        // Allocated once, outside the handler, and never freed: a signal already in flight when a
+        // later stop() disarms the timer may still write into it, so the buffer must outlive
+        // every delivery.
+        samples = new Sample[MAX_SAMPLES];
+    }
+    sampleCount.store(0, memory_order_relaxed);
+
+    struct sigaction sa = {};
+    sa.sa_sigaction = onSigprof;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGPROF, &sa, nullptr) != 0) {
+        return false;
+    }
+    running.store(true, memory_order_relaxed);
+
+    itimerval timer;
+    timer.it_interval.tv_sec = intervalMicros / 1'000'000;
+    timer.it_interval.tv_usec = intervalMicros % 1'000'000;
+    timer.it_value = timer.it_interval;
+    // ITIMER_PROF counts process CPU time, so whichever thread is actually burning cycles gets
+    // sampled and idle waits cost nothing.
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        running.store(false, memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool SamplingProfiler::stop(string_view traceFile) {
+    if (!running.load(memory_order_relaxed)) {
+        return false;
+    }
+    itimerval timer = {};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    running.store(false, memory_order_relaxed);
+
+    if (traceFile.empty()) {
+        return true;
+    }
+
+    auto taken = sampleCount.load(memory_order_relaxed);
+    auto count = min(taken, MAX_SAMPLES);
+    auto dropped = max(taken - MAX_SAMPLES, 0);
+
+    // The module base lets offline tooling undo ASLR: the address to look up in the binary's
+    // symbol table is PC - fbase + the module's preferred load address.
+    Dl_info info;
+    uintptr_t fbase = 0;
+    if (dladdr(reinterpret_cast<void *>(&SamplingProfiler::start), &info) != 0 && info.dli_fbase != nullptr) {
+        fbase = reinterpret_cast<uintptr_t>(info.dli_fbase);
+    }
+
+    auto pid = getpid();
+    fmt::memory_buffer result;
+    if (!FileOps::exists(traceFile)) {
+        fmt::format_to(result, "[\n");
+    }
+    fmt::format_to(result,
+                   "{{\"name\":\"sampling_profile\",\"ph\":\"M\",\"pid\":{},\"args\":{{\"fbase\":\"{:#x}\","
+                   "\"dropped\":{}}}}},\n",
+                   pid, fbase, dropped);
+    for (int i = 0; i < count; i++) {
+        auto &sample = samples[i];
+        auto micros = sample.when.tv_sec * 1'000'000.0 + sample.when.tv_nsec / 1000.0;
+        fmt::memory_buffer pcs;
+        for (int f = 0; f < sample.frameCount; f++) {
+            fmt::format_to(pcs, "{}{:#x}", f == 0 ? "" : ";", reinterpret_cast<uintptr_t>(sample.pcs[f]));
+        }
+        fmt::format_to(result, "{{\"name\":\"sample\",\"ph\":\"i\",\"s\":\"p\",\"ts\":{:.3f},\"pid\":{},"
+                               "\"args\":{{\"pcs\":\"{}\"}}}},\n",
+                       micros, pid, to_string(pcs));
+    }
+    FileOps::append(traceFile, to_string(result));
+    return true;
+}
+
+} // namespace sorbet::web_tracer_framework
+
+#endif
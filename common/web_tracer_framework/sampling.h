@@ -0,0 +1,36 @@
+#ifndef SORBET_COMMON_WEB_TRACER_FRAMEWORK_SAMPLING_H
+#define SORBET_COMMON_WEB_TRACER_FRAMEWORK_SAMPLING_H
+
+#include <string_view>
+
+namespace sorbet::web_tracer_framework {
+
+// Built-in sampling profiler for sessions where attaching an external profiler is not an option
+// (customer-reported slow LSP sessions, most commonly). A SIGPROF timer fires on process CPU time;
+// the handler walks frame pointers into a preallocated buffer and records nothing else, so it is
+// async-signal-safe (no allocation, no locks, no formatting). Samples carry raw program counters
+// and are symbolized offline against the matching binary; stop() appends them to a chrome-trace
+// file as instant events timestamped on the same clock as the Timer spans, so samples line up with
+// the phases already in the trace. Tracing answers which phase is slow; this answers why.
+//
+// Stacks come from frame-pointer walks, so release binaries need -fno-omit-frame-pointer for the
+// samples to reach past the leaf frame.
+class SamplingProfiler {
+public:
+    SamplingProfiler() = delete;
+
+    // Starts sampling every `intervalMicros` of process CPU time. Returns false if sampling is
+    // already running or the platform does not support it.
+    static bool start(int intervalMicros);
+
+    // Stops sampling and appends the collected samples to `traceFile` in chrome-trace format;
+    // when `traceFile` is empty the samples are discarded. Returns false if sampling was not
+    // running.
+    static bool stop(std::string_view traceFile);
+
+    static bool isRunning();
+};
+
+} // namespace sorbet::web_tracer_framework
+
+#endif
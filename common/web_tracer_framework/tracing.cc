@@ -11,10 +11,14 @@
 #include <unistd.h>
 using namespace std;
 namespace sorbet::web_tracer_framework {
-bool Tracing::storeTraces(const CounterState &counters, string_view fileName) {
+bool Tracing::storeTraces(const CounterState &counters, string_view fileName, size_t maxFileSize) {
     fmt::memory_buffer result;
 
-    if (!FileOps::exists(fileName)) {
+    bool startFresh = !FileOps::exists(fileName);
+    if (!startFresh && maxFileSize != 0 && FileOps::fileSize(fileName) >= static_cast<long>(maxFileSize)) {
+        startFresh = true;
+    }
+    if (startFresh) {
         fmt::format_to(result, "[\n");
     }
     auto now = std::chrono::duration<double, std::micro>(chrono::steady_clock::now().time_since_epoch()).count();
@@ -72,7 +76,209 @@ bool Tracing::storeTraces(const CounterState &counters, string_view fileName) {
     }
 
     fmt::format_to(result, "\n");
-    FileOps::append(fileName, to_string(result));
+    if (startFresh) {
+        FileOps::write(fileName, to_string(result));
+    } else {
+        FileOps::append(fileName, to_string(result));
+    }
+    return true;
+}
+
+bool Tracing::storeCollapsedStacks(const CounterState &counters, string_view fileName) {
+    counters.counters->canonicalize();
+
+    // Timers are scoped objects, so within one thread their intervals nest properly; rebuilding
+    // the stack tree is a matter of sorting by start time and popping frames that ended before
+    // the next one starts. Sub-millisecond scopes are dropped by Timer's destructor, so their
+    // time shows up as self time of the enclosing frame.
+    UnorderedMap<int, vector<const CounterImpl::Timing *>> timingsPerThread;
+    for (const auto &timing : counters.counters->timings) {
+        timingsPerThread[timing.threadId].emplace_back(&timing);
+    }
+
+    UnorderedMap<string, double> selfMicrosByStack;
+    for (auto &[threadId, timings] : timingsPerThread) {
+        fast_sort(timings, [](const auto *a, const auto *b) {
+            if (a->start != b->start) {
+                return a->start < b->start;
+            }
+            // Same start: the longer interval is the enclosing one.
+            return a->end > b->end;
+        });
+
+        struct Frame {
+            const CounterImpl::Timing *timing;
+            double childMicros = 0.0;
+            string path;
+        };
+        vector<Frame> stack;
+        auto popFrame = [&]() {
+            auto &frame = stack.back();
+            auto total = chrono::duration<double, micro>(frame.timing->end - frame.timing->start).count();
+            selfMicrosByStack[frame.path] += total - frame.childMicros;
+            if (stack.size() > 1) {
+                stack[stack.size() - 2].childMicros += total;
+            }
+            stack.pop_back();
+        };
+
+        for (const auto *timing : timings) {
+            while (!stack.empty() && stack.back().timing->end <= timing->start) {
+                popFrame();
+            }
+            Frame frame;
+            frame.timing = timing;
+            frame.path = stack.empty() ? string(timing->measure)
+                                       : absl::StrCat(stack.back().path, ";", timing->measure);
+            stack.emplace_back(move(frame));
+        }
+        while (!stack.empty()) {
+            popFrame();
+        }
+    }
+
+    vector<pair<string, double>> lines(selfMicrosByStack.begin(), selfMicrosByStack.end());
+    fast_sort(lines, [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    fmt::memory_buffer result;
+    for (auto &[stack, selfMicros] : lines) {
+        // Collapsed-stack counts must be integers; microseconds keep sub-millisecond resolution.
+        fmt::format_to(result, "{} {}\n", stack, static_cast<long>(selfMicros + 0.5));
+    }
+    FileOps::write(fileName, to_string(result));
+    return true;
+}
+
+namespace {
+// Phases that time a single file and do not enclose one another. `indexOneWithPlugins` wraps the
+// first four, so counting it too would double every index-side microsecond, and file reading is
+// I/O rather than compute, so it is left out as well.
+bool isPerFilePhase(string_view measure) {
+    return measure == "runParser" || measure == "runDesugar" || measure == "runDSL" || measure == "runLocalVars" ||
+           measure == "typecheckOne";
+}
+
+// Each record in a report occupies one line (see below), so a previous report can be re-read with
+// a line scan rather than pulling a JSON parser into this target.
+UnorderedMap<string, long> readPreviousTotals(string_view fileName) {
+    UnorderedMap<string, long> totals;
+    if (!FileOps::exists(fileName)) {
+        return totals;
+    }
+    auto contents = FileOps::read(fileName);
+    size_t pos = 0;
+    while (pos < contents.size()) {
+        auto eol = contents.find('\n', pos);
+        if (eol == string::npos) {
+            eol = contents.size();
+        }
+        string_view line(contents.data() + pos, eol - pos);
+        pos = eol + 1;
+
+        constexpr string_view fileKey = "\"file\":\"";
+        constexpr string_view totalKey = "\"total_us\":";
+        auto fileAt = line.find(fileKey);
+        auto totalAt = line.find(totalKey);
+        if (fileAt == string_view::npos || totalAt == string_view::npos) {
+            continue;
+        }
+        auto fileBegin = fileAt + fileKey.size();
+        auto fileEnd = line.find('"', fileBegin);
+        if (fileEnd == string_view::npos) {
+            continue;
+        }
+        auto total = strtol(line.data() + totalAt + totalKey.size(), nullptr, 10);
+        totals[string(line.substr(fileBegin, fileEnd - fileBegin))] = total;
+    }
+    return totals;
+}
+} // namespace
+
+bool Tracing::storeHotFileReport(const CounterState &counters, string_view fileName, string_view compareAgainst) {
+    counters.counters->canonicalize();
+
+    // Sub-millisecond timer scopes are dropped by Timer's destructor, so a file only appears here
+    // once some phase spent real time on it — which is exactly the population this report is for.
+    struct FileEntry {
+        vector<pair<string_view, long>> phaseMicros;
+        long totalMicros = 0;
+    };
+    UnorderedMap<string, FileEntry> perFile;
+    for (const auto &timing : counters.counters->timings) {
+        if (!isPerFilePhase(timing.measure)) {
+            continue;
+        }
+        const string *file = nullptr;
+        for (const auto &arg : timing.args) {
+            if (string_view(arg.first) == "file") {
+                file = &arg.second;
+                break;
+            }
+        }
+        if (file == nullptr) {
+            continue;
+        }
+        auto micros =
+            static_cast<long>(chrono::duration<double, micro>(timing.end - timing.start).count() + 0.5);
+        auto &entry = perFile[*file];
+        auto phase = absl::c_find_if(entry.phaseMicros,
+                                     [&](const auto &pr) { return pr.first == string_view(timing.measure); });
+        if (phase == entry.phaseMicros.end()) {
+            entry.phaseMicros.emplace_back(timing.measure, micros);
+        } else {
+            phase->second += micros;
+        }
+        entry.totalMicros += micros;
+    }
+
+    UnorderedMap<string, long> previous;
+    if (!compareAgainst.empty()) {
+        previous = readPreviousTotals(compareAgainst);
+    }
+
+    struct Row {
+        const string *file;
+        const FileEntry *entry;
+        long deltaMicros;
+    };
+    vector<Row> rows;
+    rows.reserve(perFile.size());
+    for (auto &[file, entry] : perFile) {
+        // Files absent from the previous report were too fast to record then, so their whole
+        // total is treated as regression.
+        auto prevIt = previous.find(file);
+        auto prevMicros = prevIt == previous.end() ? 0 : prevIt->second;
+        rows.emplace_back(Row{&file, &entry, entry.totalMicros - prevMicros});
+    }
+    fast_sort(rows, [&](const auto &a, const auto &b) {
+        auto lhs = compareAgainst.empty() ? a.entry->totalMicros : a.deltaMicros;
+        auto rhs = compareAgainst.empty() ? b.entry->totalMicros : b.deltaMicros;
+        if (lhs != rhs) {
+            return lhs > rhs;
+        }
+        return *a.file < *b.file;
+    });
+
+    fmt::memory_buffer result;
+    fmt::format_to(result, "[\n");
+    bool first = true;
+    for (auto &row : rows) {
+        auto phases = row.entry->phaseMicros;
+        fast_sort(phases, [](const auto &a, const auto &b) { return a.first < b.first; });
+        string maybeDelta;
+        if (!compareAgainst.empty()) {
+            maybeDelta = fmt::format(",\"previous_us\":{},\"delta_us\":{}", row.entry->totalMicros - row.deltaMicros,
+                                     row.deltaMicros);
+        }
+        fmt::format_to(result, "{}{{\"file\":\"{}\",\"total_us\":{}{},\"phases\":{{{}}}}}", first ? "" : ",\n",
+                       *row.file, row.entry->totalMicros, maybeDelta,
+                       fmt::map_join(phases, ",", [](const auto &pr) -> string {
+                           return fmt::format("\"{}\":{}", pr.first, pr.second);
+                       }));
+        first = false;
+    }
+    fmt::format_to(result, "\n]\n");
+    FileOps::write(fileName, to_string(result));
     return true;
 }
 } // namespace sorbet::web_tracer_framework
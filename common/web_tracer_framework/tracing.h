@@ -8,7 +8,23 @@ class Tracing {
 public:
     Tracing() = delete;
 
-    static bool storeTraces(const CounterState &counters, std::string_view fileName);
+    /** Appends the traces in `counters` to `fileName` in chrome-trace format. If `maxFileSize` is
+     * nonzero and the file has grown past it, the file is restarted instead of appended to, so
+     * long-lived servers can leave tracing on without the trace file growing without bound. */
+    static bool storeTraces(const CounterState &counters, std::string_view fileName, size_t maxFileSize = 0);
+
+    /** Writes the traces in `counters` to `fileName` in collapsed-stack format
+     * ("index;runParser <self_micros>" per line), suitable for flamegraph.pl and similar tooling.
+     * Timer scopes nest lexically within a thread, so the stack tree is rebuilt from interval
+     * containment and each frame is attributed its self time. */
+    static bool storeCollapsedStacks(const CounterState &counters, std::string_view fileName);
+
+    /** Writes a per-file breakdown of phase timings (parse, desugar, dsl, local vars, typecheck)
+     * as JSON to `fileName`, one file record per line, ranked by total time. When `compareAgainst`
+     * names a report produced by an earlier run, each record additionally carries that run's total
+     * and the delta, and the ranking switches to largest regression first. */
+    static bool storeHotFileReport(const CounterState &counters, std::string_view fileName,
+                                   std::string_view compareAgainst);
 };
 } // namespace sorbet::web_tracer_framework
 
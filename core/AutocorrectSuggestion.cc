@@ -1,30 +1,9 @@
 #include "core/AutocorrectSuggestion.h"
-#include "absl/strings/str_cat.h"
 
 using namespace std;
 
 namespace sorbet::core {
 
-bool hasSeen(const UnorderedSet<Loc> &seen, Loc loc) {
-    for (auto &seenLoc : seen) {
-        if (seenLoc.file() != loc.file()) {
-            continue;
-        }
-        // Check exactly equal for zero-width locs
-        if (seenLoc == loc) {
-            return true;
-        }
-        // Check for overlapping
-        if (seenLoc.beginPos() >= loc.beginPos() && seenLoc.beginPos() < loc.endPos()) {
-            return true;
-        }
-        if (seenLoc.endPos() >= loc.beginPos() && seenLoc.endPos() < loc.endPos()) {
-            return true;
-        }
-    }
-    return false;
-}
-
 UnorderedMap<FileRef, string> AutocorrectSuggestion::apply(vector<AutocorrectSuggestion> autocorrects,
                                                            UnorderedMap<FileRef, string> sources) {
     vector<AutocorrectSuggestion::Edit> edits;
@@ -32,7 +11,10 @@ UnorderedMap<FileRef, string> AutocorrectSuggestion::apply(vector<AutocorrectSug
         move(autocorrect.edits.begin(), autocorrect.edits.end(), back_inserter(edits));
     }
 
-    // Sort the locs backwards
+    // Sort the locs backwards, grouped by file. Within a file the edits then arrive in descending
+    // beginPos order, so the overlap filter below only ever has to look at the most recently
+    // accepted edit: every accepted edit so far begins at or after the candidate, and the last
+    // accepted one begins earliest among them.
     auto compare = [](const AutocorrectSuggestion::Edit &left, const AutocorrectSuggestion::Edit &right) {
         if (left.loc.file() != right.loc.file()) {
             return left.loc.file().id() > right.loc.file().id();
@@ -48,22 +30,46 @@ UnorderedMap<FileRef, string> AutocorrectSuggestion::apply(vector<AutocorrectSug
     };
     fast_sort(edits, compare);
 
-    UnorderedSet<Loc> seen; // used to make sure nothing overlaps
     UnorderedMap<FileRef, string> ret;
-    for (auto &edit : edits) {
-        core::Loc loc = edit.loc;
-        if (!ret.count(loc.file())) {
-            ret[loc.file()] = sources[loc.file()];
+    size_t i = 0;
+    while (i < edits.size()) {
+        auto file = edits[i].loc.file();
+        size_t fileEnd = i;
+        while (fileEnd < edits.size() && edits[fileEnd].loc.file() == file) {
+            fileEnd++;
+        }
+
+        // Drop edits that overlap an already-accepted one (first in descending order wins, as
+        // before); duplicate zero-width edits count as overlapping.
+        vector<const AutocorrectSuggestion::Edit *> accepted;
+        for (size_t j = i; j < fileEnd; j++) {
+            auto loc = edits[j].loc;
+            if (!accepted.empty() && (accepted.back()->loc == loc || accepted.back()->loc.beginPos() < loc.endPos())) {
+                continue;
+            }
+            accepted.emplace_back(&edits[j]);
         }
-        auto source = ret[loc.file()];
-        auto start = loc.beginPos();
-        auto end = loc.endPos();
 
-        if (hasSeen(seen, loc)) {
-            continue;
+        // Rebuild the file in a single forward pass over the accepted edits instead of rewriting
+        // the whole buffer once per edit.
+        auto &source = sources[file];
+        long sizeDelta = 0;
+        for (auto *edit : accepted) {
+            sizeDelta += long(edit->replacement.size()) - long(edit->loc.endPos() - edit->loc.beginPos());
         }
-        seen.emplace(loc);
-        ret[loc.file()] = absl::StrCat(source.substr(0, start), edit.replacement, source.substr(end, -1));
+        string out;
+        out.reserve(source.size() + max(sizeDelta, 0L));
+        u4 pos = 0;
+        for (auto it = accepted.rbegin(); it != accepted.rend(); ++it) {
+            const auto *edit = *it;
+            out.append(source, pos, edit->loc.beginPos() - pos);
+            out.append(edit->replacement);
+            pos = edit->loc.endPos();
+        }
+        out.append(source, pos, string::npos);
+        ret[file] = move(out);
+
+        i = fileEnd;
     }
     return ret;
 }
@@ -86,9 +86,16 @@ GlobalSubstitution::GlobalSubstitution(const GlobalState &from, GlobalState &to,
     }
 
     fastPath = false;
+    int sharedNames = 0;
     if (optionalCommonParent != nullptr) {
-        if (from.namesUsed() == optionalCommonParent->namesUsed() &&
-            from.symbolsUsed() == optionalCommonParent->symbolsUsed()) {
+        // `from` and `to` both forked off of the common parent, so every name that existed in the
+        // parent has the same id in both; only names interned after the fork need real
+        // substitution. This keeps a merge from re-hashing the entire payload name table for every
+        // worker result.
+        sharedNames = optionalCommonParent->namesUsed();
+        ENFORCE(from.namesUsed() >= sharedNames);
+        ENFORCE(to.namesUsed() >= sharedNames);
+        if (from.namesUsed() == sharedNames && from.symbolsUsed() == optionalCommonParent->symbolsUsed()) {
             ENFORCE(to.namesUsed() >= from.namesUsed());
             ENFORCE(to.symbolsUsed() >= from.symbolsUsed());
             fastPath = true;
@@ -97,13 +104,23 @@ GlobalSubstitution::GlobalSubstitution(const GlobalState &from, GlobalState &to,
 
     if (!fastPath || debug_mode) {
         bool seenEmpty = false;
+        bool appendOnly = true;
         {
             UnfreezeNameTable unfreezeNames(to);
+            // At most this many names are new to `to`; reserving up front keeps the merge from
+            // rehashing the whole destination table at every doubling.
+            to.reserveNames(from.namesUsed() - sharedNames);
             nameSubstitution.reserve(from.names.size());
             int i = -1;
             for (const Name &nm : from.names) {
                 i++;
                 ENFORCE(nameSubstitution.size() == i, "Name substitution has wrong size");
+                if (i < sharedNames && !debug_mode) {
+                    // Identical by construction in `from` and `to`; skip the hash-table lookup.
+                    nameSubstitution.emplace_back(to, i);
+                    seenEmpty = true;
+                    continue;
+                }
                 if (seenEmpty) {
                     switch (nm.kind) {
                         case NameKind::UNIQUE:
@@ -123,10 +140,18 @@ GlobalSubstitution::GlobalSubstitution(const GlobalState &from, GlobalState &to,
                     nameSubstitution.emplace_back(to, 0);
                     seenEmpty = true;
                 }
+                appendOnly = appendOnly && nameSubstitution.back()._id == i;
                 ENFORCE(!fastPath || nameSubstitution.back()._id == i);
             }
         }
 
+        if (appendOnly) {
+            // `to` already had every one of `from`'s names interned at the same ids (its table grew
+            // append-only from the same base), so the substitution is the identity and whole-tree
+            // rewrites in ast::Substitute can be skipped.
+            fastPath = true;
+        }
+
         // Enforce that the symbol tables are the same
         for (int i = 0; i < from.symbols.size(); ++i) {
             ENFORCE(substitute(from.symbols[i].name) == from.symbols[i].name);
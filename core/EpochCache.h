@@ -0,0 +1,90 @@
+#ifndef SORBET_EPOCH_CACHE_H
+#define SORBET_EPOCH_CACHE_H
+
+#include "core/GlobalState.h"
+
+namespace sorbet::core {
+
+// Epoch-validated caching.
+//
+// Caches keyed off the symbol table (dispatch results, subtype memos, resolved constants, ...)
+// all face the same invalidation problem, and solving it per-cache invites bugs. Instead, every
+// cached value is stamped with GlobalState::symbolTableEpoch() when recorded and is treated as
+// absent whenever the stamp no longer matches. The epoch moves on every freeze/unfreeze
+// transition of the symbol table, so a mutation anywhere — however unrelated it looks — retires
+// every stamped value at once. That is deliberately coarse: staleness is impossible by
+// construction, and re-deriving a cache entry after an edit is cheap next to chasing a
+// wrong-answer bug.
+//
+// Two rules for users:
+//  * Only consult a cache while the symbol table is frozen. Entries recorded while it is
+//    unfrozen are legal but die at the refreeze.
+//  * Stamped values must not outlive the GlobalState they were derived from; a deepCopy carries
+//    the epoch, so values stay valid against the copy until its own first mutation.
+
+// A single value with an epoch stamp. The building block for ad-hoc memo fields:
+//
+//     EpochStamped<TypePtr> memo;
+//     if (auto *cached = memo.get(gs)) { return *cached; }
+//     memo.set(gs, computed);
+template <typename Value> class EpochStamped {
+    u4 epoch = 0; // 0 predates every GlobalState epoch, so a default-constructed stamp is stale
+    Value value;
+
+public:
+    const Value *get(const GlobalState &gs) const {
+        if (epoch != gs.symbolTableEpoch()) {
+            return nullptr;
+        }
+        return &value;
+    }
+
+    void set(const GlobalState &gs, Value newValue) {
+        epoch = gs.symbolTableEpoch();
+        value = std::move(newValue);
+    }
+};
+
+// A map from Key to epoch-stamped Value. Stale entries are invisible to find() and overwritten in
+// place by insert(); they are not collected eagerly, so long-lived caches that churn keys across
+// many epochs should compact() at a phase boundary.
+template <typename Key, typename Value> class EpochCache {
+    UnorderedMap<Key, EpochStamped<Value>> entries;
+
+public:
+    // Returns the value recorded for `key` under the current epoch, or nullptr.
+    const Value *find(const GlobalState &gs, const Key &key) const {
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            return nullptr;
+        }
+        return it->second.get(gs);
+    }
+
+    void insert(const GlobalState &gs, Key key, Value value) {
+        entries[std::move(key)].set(gs, std::move(value));
+    }
+
+    // Drops every entry not recorded under the current epoch.
+    void compact(const GlobalState &gs) {
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.get(gs) == nullptr) {
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void clear() {
+        entries.clear();
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+};
+
+} // namespace sorbet::core
+
+#endif // SORBET_EPOCH_CACHE_H
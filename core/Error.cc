@@ -112,6 +112,9 @@ ErrorRegion::~ErrorRegion() {
 ErrorBuilder::ErrorBuilder(const GlobalState &gs, bool willBuild, Loc loc, ErrorClass what)
     : gs(gs), state(willBuild ? State::WillBuild : State::Unreported), loc(loc), what(what) {
     ENFORCE(willBuild || what.minLevel != StrictLevel::Internal);
+    if (state == State::WillBuild && gs.suppressErrorDetails && what.minLevel != StrictLevel::Internal) {
+        state = State::CountOnly;
+    }
 }
 
 void ErrorBuilder::_setHeader(string &&header) {
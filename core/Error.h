@@ -46,8 +46,11 @@ struct ErrorLine {
     const std::string formattedMessage;
     ErrorLine(Loc loc, std::string formattedMessage) : loc(loc), formattedMessage(move(formattedMessage)){};
 
-    template <typename... Args> static ErrorLine from(Loc loc, std::string_view msg, const Args &... args) {
-        std::string formatted = ErrorColors::format(msg, args...);
+    template <typename... Args> static ErrorLine from(Loc loc, ConstExprStr msg, const Args &... args) {
+        ENFORCE(msg.placeholderCount() == sizeof...(Args),
+                "format string \"{}\" has {} placeholders but {} arguments were passed", msg.str,
+                msg.placeholderCount(), sizeof...(Args));
+        std::string formatted = ErrorColors::format(msg.str, args...);
         return ErrorLine(loc, move(formatted));
     }
     std::string toString(const GlobalState &gs, bool color = true) const;
@@ -111,6 +114,11 @@ class ErrorBuilder {
     //    No method is valid on an Unreported ErrorBuilder other than
     //    `operator bool()` and `build()`
     //
+    //  - CountOnly: This error will be reported — it counts toward the error total and the exit
+    //    code — but carries only (code, loc, file): GlobalState::suppressErrorDetails is set, so
+    //    `operator bool()` returns false and callers never compute the header, sections, or
+    //    autocorrects. Critical errors never enter this state.
+    //
     //  - WillBuild: This error builder is live and in the process of
     //    constructing an error. This is the only state in which mutation
     //    methods (setHeader, etc) are valid.
@@ -123,6 +131,7 @@ class ErrorBuilder {
     //  default behavior of reporting on destruction.
     enum class State {
         Unreported,
+        CountOnly,
         WillBuild,
         DidBuild,
     };
@@ -147,11 +156,17 @@ public:
     }
     void addErrorSection(ErrorSection &&section);
     template <typename... Args> void addErrorLine(Loc loc, ConstExprStr msg, const Args &... args) {
+        ENFORCE(msg.placeholderCount() == sizeof...(Args),
+                "format string \"{}\" has {} placeholders but {} arguments were passed", msg.str,
+                msg.placeholderCount(), sizeof...(Args));
         std::string formatted = ErrorColors::format(msg.str, args...);
         addErrorSection(ErrorSection({ErrorLine(loc, formatted)}));
     }
 
     template <typename... Args> void setHeader(ConstExprStr msg, const Args &... args) {
+        ENFORCE(msg.placeholderCount() == sizeof...(Args),
+                "format string \"{}\" has {} placeholders but {} arguments were passed", msg.str,
+                msg.placeholderCount(), sizeof...(Args));
         std::string formatted = ErrorColors::format(msg.str, args...);
         _setHeader(move(formatted));
     }
@@ -159,6 +174,9 @@ public:
     void addAutocorrect(AutocorrectSuggestion &&autocorrect);
     template <typename... Args>
     void replaceWith(const std::string &title, Loc loc, ConstExprStr replacement, const Args &... args) {
+        ENFORCE(replacement.placeholderCount() == sizeof...(Args),
+                "format string \"{}\" has {} placeholders but {} arguments were passed", replacement.str,
+                replacement.placeholderCount(), sizeof...(Args));
         std::string formatted = fmt::format(replacement.str, args...);
         addAutocorrect(AutocorrectSuggestion{title, {AutocorrectSuggestion::Edit{loc, move(formatted)}}});
     }
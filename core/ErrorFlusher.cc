@@ -1,29 +1,38 @@
 #include "core/ErrorFlusher.h"
 #include "common/FileSystem.h"
+#include "common/concurrency/ConcurrentQueue.h"
+#include "common/concurrency/WorkerPool.h"
 #include "core/lsp/QueryResponse.h"
 
 using namespace std;
 
 namespace sorbet::core {
 
-void ErrorFlusher::flushErrors(spdlog::logger &logger, vector<unique_ptr<ErrorQueueMessage>> errors) {
+void ErrorFlusher::flushErrors(const GlobalState &gs, spdlog::logger &logger, vector<ErrorQueueMessage> errors) {
     fmt::memory_buffer critical, nonCritical;
     for (auto &error : errors) {
-        if (error->kind == ErrorQueueMessage::Kind::Error) {
-            if (error->error->isSilenced) {
+        if (error.kind == ErrorQueueMessage::Kind::Error) {
+            if (error.error->isSilenced) {
                 continue;
             }
 
-            prodHistogramAdd("error", error->error->what.code, 1);
+            prodHistogramAdd("error", error.error->what.code, 1);
 
-            auto &out = error->error->isCritical() ? critical : nonCritical;
+            if (gs.suppressErrorDetails && !error.error->isCritical()) {
+                // Count-only errors carry no header or sections (ErrorBuilder::State::CountOnly);
+                // there is nothing to render, and skipping here also skips Loc::position line scans.
+                continue;
+            }
+
+            auto &out = error.error->isCritical() ? critical : nonCritical;
             if (out.size() != 0) {
                 fmt::format_to(out, "\n\n");
             }
-            ENFORCE(error->text.has_value());
-            fmt::format_to(out, "{}", error->text.value_or(""));
+            // This is the only place error text is rendered: errors stay structured until we know
+            // they will actually print.
+            fmt::format_to(out, "{}", error.error->toString(gs));
 
-            for (auto &autocorrect : error->error->autocorrects) {
+            for (auto &autocorrect : error.error->autocorrects) {
                 autocorrects.emplace_back(move(autocorrect));
             }
         }
@@ -55,7 +64,7 @@ void ErrorFlusher::flushErrorCount(spdlog::logger &logger, int count) {
     }
 }
 
-void ErrorFlusher::flushAutocorrects(const GlobalState &gs, FileSystem &fs) {
+void ErrorFlusher::flushAutocorrects(const GlobalState &gs, FileSystem &fs, WorkerPool &workers) {
     UnorderedMap<FileRef, string> sources;
     for (auto &autocorrect : autocorrects) {
         for (auto &edit : autocorrect.edits) {
@@ -67,8 +76,29 @@ void ErrorFlusher::flushAutocorrects(const GlobalState &gs, FileSystem &fs) {
     }
 
     auto toWrite = AutocorrectSuggestion::apply(autocorrects, sources);
+    // Strictness migrations rewrite thousands of files; fan the writes out over the pool rather
+    // than serializing them behind one thread's IO.
+    auto fileq = make_shared<ConcurrentBoundedQueue<pair<string, string>>>(toWrite.size());
     for (auto &entry : toWrite) {
-        fs.writeFile(entry.first.data(gs).path(), entry.second);
+        fileq->push(make_pair(string(entry.first.data(gs).path()), move(entry.second)), 1);
+    }
+    auto resultq = make_shared<BlockingBoundedQueue<int>>(toWrite.size());
+    workers.multiplexJob("writeAutocorrects", [&fs, fileq, resultq]() {
+        pair<string, string> job;
+        int written = 0;
+        for (auto result = fileq->try_pop(job); !result.done(); result = fileq->try_pop(job)) {
+            if (result.gotItem()) {
+                fs.writeFile(job.first, job.second);
+                written++;
+            }
+        }
+        if (written > 0) {
+            resultq->push(move(written), written);
+        }
+    });
+    int written;
+    for (auto result = resultq->wait_pop_timed(written, WorkerPool::BLOCK_INTERVAL(), gs.tracer()); !result.done();
+         result = resultq->wait_pop_timed(written, WorkerPool::BLOCK_INTERVAL(), gs.tracer())) {
     }
     autocorrects.clear();
 }
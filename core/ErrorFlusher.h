@@ -7,6 +7,7 @@
 
 namespace sorbet {
 class FileSystem;
+class WorkerPool;
 namespace core {
 
 class ErrorFlusher {
@@ -16,9 +17,9 @@ private:
 
 public:
     ErrorFlusher() = default;
-    void flushErrors(spdlog::logger &logger, std::vector<std::unique_ptr<ErrorQueueMessage>> error);
+    void flushErrors(const GlobalState &gs, spdlog::logger &logger, std::vector<ErrorQueueMessage> error);
     void flushErrorCount(spdlog::logger &logger, int count);
-    void flushAutocorrects(const GlobalState &gs, FileSystem &fs);
+    void flushAutocorrects(const GlobalState &gs, FileSystem &fs, WorkerPool &workers);
 };
 
 } // namespace core
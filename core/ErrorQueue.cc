@@ -20,11 +20,11 @@ ErrorQueue::drainWithQueryResponses() {
 
     out.reserve(collected.size());
     for (auto &msg : collected) {
-        if (msg->kind == ErrorQueueMessage::Kind::QueryResponse) {
-            outResponses.emplace_back(move(msg->queryResponse));
+        if (msg.kind == ErrorQueueMessage::Kind::QueryResponse) {
+            outResponses.emplace_back(move(msg.queryResponse));
         }
-        if (msg->kind == ErrorQueueMessage::Kind::Error) {
-            out.emplace_back(move(msg->error));
+        if (msg.kind == ErrorQueueMessage::Kind::Error) {
+            out.emplace_back(move(msg.error));
         }
     }
 
@@ -51,28 +51,35 @@ vector<unique_ptr<core::Error>> ErrorQueue::drainAllErrors() {
     return move(drainWithQueryResponses().first);
 }
 
-void ErrorQueue::flushErrors(bool all) {
+void ErrorQueue::flushErrors(const GlobalState &gs, bool all) {
     checkOwned();
     if (ignoreFlushes) {
         return;
     }
 
     Timer timeit(tracer, "ErrorQueue::flushErrors");
-    vector<unique_ptr<ErrorQueueMessage>> errors;
+    vector<ErrorQueueMessage> errors;
     if (all) {
         errors = drainAll();
     } else {
         errors = drainFlushed();
     }
-    errorFlusher.flushErrors(logger, move(errors));
+    if (errorSink != nullptr) {
+        for (auto &error : errors) {
+            if (error.kind == ErrorQueueMessage::Kind::Error && !error.error->isSilenced) {
+                errorSink(gs, *error.error);
+            }
+        }
+    }
+    errorFlusher.flushErrors(gs, logger, move(errors));
 }
 
 void ErrorQueue::flushErrorCount() {
     errorFlusher.flushErrorCount(logger, nonSilencedErrorCount);
 }
 
-void ErrorQueue::flushAutocorrects(const GlobalState &gs, FileSystem &fs) {
-    errorFlusher.flushAutocorrects(gs, fs);
+void ErrorQueue::flushAutocorrects(const GlobalState &gs, FileSystem &fs, WorkerPool &workers) {
+    errorFlusher.flushAutocorrects(gs, fs, workers);
 }
 
 void ErrorQueue::pushError(const core::GlobalState &gs, unique_ptr<core::Error> error) {
@@ -81,42 +88,68 @@ void ErrorQueue::pushError(const core::GlobalState &gs, unique_ptr<core::Error>
     msg.whatFile = error->loc.file();
     if (!error->isSilenced) {
         this->nonSilencedErrorCount.fetch_add(1);
-        // Serializing errors is expensive, so we only serialize them if the error isn't silenced.
-        msg.text = error->toString(gs);
     }
+    // Errors cross the queue structured; ErrorFlusher renders text at flush time, and only for
+    // errors that print. That keeps errors that are silenced, drained structurally (LSP, the
+    // file-hashing pass), or suppressed by the error baseline from ever paying for formatting.
     msg.error = move(error);
     this->queue.push(move(msg), 1);
 }
 
-void ErrorQueue::collectForFile(core::FileRef whatFile, vector<unique_ptr<core::ErrorQueueMessage>> &out) {
+void ErrorQueue::collectForFile(core::FileRef whatFile, vector<core::ErrorQueueMessage> &out) {
     auto it = collected.find(whatFile);
     if (it == collected.end()) {
         return;
     }
-    for (auto &error : it->second) {
-        out.emplace_back(make_unique<core::ErrorQueueMessage>(move(error)));
-    }
+    // Messages move out by value; re-boxing each one into a fresh allocation here showed up on
+    // query-heavy LSP profiles.
+    out.insert(out.end(), make_move_iterator(it->second.begin()), make_move_iterator(it->second.end()));
     collected[whatFile].clear();
 };
 
-vector<unique_ptr<core::ErrorQueueMessage>> ErrorQueue::drainFlushed() {
+vector<core::ErrorQueueMessage> ErrorQueue::drainFlushed() {
     checkOwned();
 
-    vector<unique_ptr<core::ErrorQueueMessage>> ret;
+    vector<core::ErrorQueueMessage> ret;
 
     core::ErrorQueueMessage msg;
     for (auto result = queue.try_pop(msg); result.gotItem(); result = queue.try_pop(msg)) {
         if (msg.kind == core::ErrorQueueMessage::Kind::Flush) {
-            collectForFile(msg.whatFile, ret);
+            if (flushOrderDeferred.contains(msg.whatFile)) {
+                flushOrderReady.insert(msg.whatFile);
+            } else {
+                collectForFile(msg.whatFile, ret);
+            }
             collectForFile(core::FileRef(), ret);
         } else {
             collected[msg.whatFile].emplace_back(move(msg));
         }
     }
 
+    // Emit the contiguous run of finished files at the head of the flush order; a file that
+    // finished early waits here until everything scheduled before it has finished too, so the
+    // output reads as if the files were checked serially in input order.
+    while (flushOrderNext < flushOrder.size() && flushOrderReady.contains(flushOrder[flushOrderNext])) {
+        auto file = flushOrder[flushOrderNext];
+        flushOrderReady.erase(file);
+        flushOrderDeferred.erase(file);
+        collectForFile(file, ret);
+        flushOrderNext++;
+    }
+
     return ret;
 }
 
+void ErrorQueue::setFlushOrder(vector<core::FileRef> order) {
+    checkOwned();
+    flushOrder = move(order);
+    flushOrderNext = 0;
+    flushOrderReady.clear();
+    flushOrderDeferred.clear();
+    flushOrderDeferred.reserve(flushOrder.size());
+    flushOrderDeferred.insert(flushOrder.begin(), flushOrder.end());
+}
+
 void ErrorQueue::markFileForFlushing(core::FileRef file) {
     core::ErrorQueueMessage msg;
     msg.kind = core::ErrorQueueMessage::Kind::Flush;
@@ -139,16 +172,19 @@ bool ErrorQueue::isEmpty() {
     checkOwned();
     return collected.empty();
 }
-vector<unique_ptr<core::ErrorQueueMessage>> ErrorQueue::drainAll() {
+vector<core::ErrorQueueMessage> ErrorQueue::drainAll() {
     checkOwned();
     auto out = drainFlushed();
 
     for (auto &part : collected) {
-        for (auto &error : part.second) {
-            out.emplace_back(make_unique<core::ErrorQueueMessage>(move(error)));
-        }
+        out.insert(out.end(), make_move_iterator(part.second.begin()), make_move_iterator(part.second.end()));
     }
     collected.clear();
+    // Everything is out now, including files whose ordered turn never came (e.g. a cancelled run).
+    flushOrder.clear();
+    flushOrderNext = 0;
+    flushOrderReady.clear();
+    flushOrderDeferred.clear();
 
     return out;
 }
@@ -6,28 +6,42 @@
 #include "core/ErrorQueueMessage.h"
 #include "core/lsp/QueryResponse.h"
 #include <atomic>
+#include <functional>
 
 namespace sorbet {
 class FileSystem;
+class WorkerPool;
 
 namespace core {
 class ErrorQueue {
 private:
     void checkOwned();
-    std::vector<std::unique_ptr<ErrorQueueMessage>> drainAll();
-    std::vector<std::unique_ptr<ErrorQueueMessage>> drainFlushed();
-    void collectForFile(core::FileRef whatFile, std::vector<std::unique_ptr<core::ErrorQueueMessage>> &out);
+    std::vector<ErrorQueueMessage> drainAll();
+    std::vector<ErrorQueueMessage> drainFlushed();
+    void collectForFile(core::FileRef whatFile, std::vector<core::ErrorQueueMessage> &out);
     ErrorFlusher errorFlusher;
     const std::thread::id owner;
     UnorderedMap<core::FileRef, std::vector<core::ErrorQueueMessage>> collected;
     ConcurrentUnBoundedQueue<core::ErrorQueueMessage> queue;
+    // Reorder window for deterministic streaming (see setFlushOrder): files still awaiting their
+    // ordered turn, the ones whose flush marker has already arrived, and the cursor into the order.
+    std::vector<core::FileRef> flushOrder;
+    size_t flushOrderNext = 0;
+    UnorderedSet<core::FileRef> flushOrderDeferred;
+    UnorderedSet<core::FileRef> flushOrderReady;
 
 public:
     spdlog::logger &logger;
     spdlog::logger &tracer;
     std::atomic<bool> hadCritical{false};
     std::atomic<int> nonSilencedErrorCount{0};
+    // Set before typechecking starts on queues that are drained structurally (LSP) rather than
+    // flushed; such queues never print, so pushError also skips formatting the error text.
     bool ignoreFlushes{false};
+    // Invoked from flushErrors with every non-silenced error, in flush order, before the text is
+    // rendered. Set by callers that stream a structured copy of the diagnostics alongside the text
+    // output (--print=errors-proto).
+    std::function<void(const GlobalState &, const Error &)> errorSink;
 
     ErrorQueue(spdlog::logger &logger, spdlog::logger &tracer);
 
@@ -36,6 +50,14 @@ public:
     void pushQueryResponse(std::unique_ptr<lsp::QueryResponse> response);
     /** indicate that errors for `file` should be flushed on next call to to flushErrors */
     void markFileForFlushing(FileRef file);
+    /**
+     * Makes flushErrors emit the listed files' errors in exactly this order, releasing each file as
+     * soon as it and every file before it have been marked for flushing. Errors still stream out
+     * during the run, but the output no longer depends on worker completion order. Files not listed
+     * keep flushing as soon as they are marked; the order is forgotten once fully emitted or on the
+     * next drain-everything call.
+     */
+    void setFlushOrder(std::vector<FileRef> order);
     /** Extract all query responses. This discards all errors currently present in error Queue */
     std::pair<std::vector<std::unique_ptr<core::Error>>, std::vector<std::unique_ptr<core::lsp::QueryResponse>>>
     drainWithQueryResponses();
@@ -43,9 +65,9 @@ public:
     /** Extract all errors. This discards all query responses currently present in error Queue */
     std::vector<std::unique_ptr<core::Error>> drainAllErrors();
 
-    void flushErrors(bool all = false);
+    void flushErrors(const GlobalState &gs, bool all = false);
     void flushErrorCount();
-    void flushAutocorrects(const GlobalState &gs, FileSystem &fs);
+    void flushAutocorrects(const GlobalState &gs, FileSystem &fs, WorkerPool &workers);
 };
 
 } // namespace core
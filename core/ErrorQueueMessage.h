@@ -11,8 +11,8 @@ struct ErrorQueueMessage {
     enum class Kind { Error, Flush, QueryResponse };
     Kind kind;
     core::FileRef whatFile;
-    // The text of the error. Is a `nullopt` if the error is silenced.
-    std::optional<std::string> text;
+    // Errors stay structured all the way through the queue; ErrorFlusher renders text only for the
+    // ones that actually print, so errors that end up suppressed never pay for formatting.
     std::unique_ptr<Error> error;
     std::unique_ptr<lsp::QueryResponse> queryResponse;
 };
@@ -1,6 +1,10 @@
 #include "core/Files.h"
+#include "common/ByteScan.h"
+#include "common/Counters.h"
+#include "common/FileOps.h"
 #include "core/Context.h"
 #include "core/GlobalState.h"
+#include <mutex>
 #include <vector>
 
 #include "absl/strings/match.h"
@@ -13,21 +17,17 @@ namespace sorbet::core {
 
 vector<int> findLineBreaks(string_view s) {
     vector<int> res;
-    int i = -1;
     res.emplace_back(-1);
-    for (auto c : s) {
-        i++;
-        if (c == '\n') {
-            res.emplace_back(i);
-        }
-    }
-    // We start at -1 so the last character of the file is actually i+1
-    res.emplace_back(i + 1);
-    ENFORCE(i + 1 == s.size());
+    bytescan::appendOffsets(s, '\n', res);
+    // We start at -1 so the last character of the file is one past the last offset
+    res.emplace_back(s.size());
     return res;
 }
 
-StrictLevel File::fileSigil(string_view source) {
+namespace {
+// The sigil pattern is '#', any spaces, "typed:", any spaces, level word. `hashOffsets` lists the
+// offset of every '#' in `source`; shared between fileSigil and the constructor's fused scan.
+StrictLevel sigilFromHashOffsets(string_view source, const vector<int> &hashOffsets) {
     /*
      * StrictLevel::None: <none>
      * StrictLevel::False: # typed: false
@@ -36,25 +36,12 @@ StrictLevel File::fileSigil(string_view source) {
      * StrictLevel::String: # typed: strong
      * StrictLevel::Autogenerated: # typed: autogenerated
      */
-    size_t start = 0;
-    while (true) {
-        start = source.find("typed:", start);
-        if (start == string_view::npos) {
-            return StrictLevel::None;
-        }
-
-        auto comment_start = start;
-        while (comment_start > 0) {
-            --comment_start;
-            auto c = source[comment_start];
-            if (c == ' ') {
-                continue;
-            } else {
-                break;
-            }
-        }
-        if (source[comment_start] != '#') {
+    for (auto hashOffset : hashOffsets) {
+        size_t start = hashOffset + 1;
+        while (start < source.size() && source[start] == ' ') {
             ++start;
+        }
+        if (source.compare(start, 6, "typed:") != 0) {
             continue;
         }
 
@@ -92,17 +79,35 @@ StrictLevel File::fileSigil(string_view source) {
             // access to GlobalState or can return errors to someone who
             // does.
         }
-
-        start = end;
     }
+    return StrictLevel::None;
+}
+} // namespace
+
+StrictLevel File::fileSigil(string_view source) {
+    vector<int> hashOffsets;
+    bytescan::appendOffsets(source, '#', hashOffsets);
+    return sigilFromHashOffsets(source, hashOffsets);
 }
 
 File::File(string &&path_, string &&source_, Type sourceType)
-    : sourceType(sourceType), path_(path_), source_(source_), originalSigil(fileSigil(this->source_)),
-      strictLevel(originalSigil) {}
+    : sourceType(sourceType), path_(path_), source_(source_) {
+    // One fused pass computes the line-break table and locates the `# typed:` sigil. Each used to
+    // take its own full scan of the buffer -- a small fixed cost multiplied by every file on a cold
+    // start and by every editor edit.
+    auto lineBreaks = make_shared<vector<int>>();
+    lineBreaks->emplace_back(-1);
+    vector<int> hashOffsets;
+    bytescan::appendOffsets2(this->source_, '\n', '#', *lineBreaks, hashOffsets);
+    // We start at -1 so the last character of the file is one past the last offset
+    lineBreaks->emplace_back(this->source_.size());
+    atomic_store(&this->lineBreaks_, move(lineBreaks));
+    this->originalSigil = sigilFromHashOffsets(this->source_, hashOffsets);
+    this->strictLevel = this->originalSigil;
+}
 
 unique_ptr<File> File::deepCopy(GlobalState &gs) const {
-    string sourceCopy = source_;
+    string sourceCopy = string(source()); // rematerializes if released
     string pathCopy = path_;
     auto ret = make_unique<File>(move(pathCopy), move(sourceCopy), sourceType);
     ret->lineBreaks_ = lineBreaks_;
@@ -146,13 +151,57 @@ string_view File::path() const {
 string_view File::source() const {
     ENFORCE(this->sourceType != Type::TombStone);
     ENFORCE(this->sourceType != File::NotYetRead);
+    if (this->sourceReleased_.load(memory_order_acquire)) {
+        materializeSource();
+    }
     return this->source_;
 }
 
+void File::releaseSource() {
+    if (this->sourceType != Type::Normal || this->pluginGenerated || this->sourceReleased_.load(memory_order_acquire) ||
+        !FileOps::exists(this->path_)) {
+        return;
+    }
+    // Compute (and retain) the line-break table while the buffer is still here: turning error
+    // offsets into line/column positions then never faults the source back in, only snippet
+    // printing and autocorrects do.
+    this->lineBreaks();
+    this->releasedSourceSize_ = this->source_.size();
+    this->source_ = string();
+    this->sourceReleased_.store(true, memory_order_release);
+}
+
+void File::materializeSource() const {
+    // Shared across all files: rematerialization is rare and the critical section is one read.
+    static mutex materializeLock;
+    lock_guard<mutex> guard(materializeLock);
+    if (!this->sourceReleased_.load(memory_order_acquire)) {
+        // Another thread beat us to it.
+        return;
+    }
+    string contents;
+    try {
+        contents = FileOps::read(this->path_);
+    } catch (FileNotFoundException &) {
+        // Deleted from under us; the padded buffer below keeps locs in bounds.
+    }
+    // Locs and the cached line-break table index into the buffer as originally read. If the file
+    // changed on disk in the meantime, clamp to the original extent so they stay in bounds;
+    // snippets printed from such a file may be stale, which is the lesser evil.
+    contents.resize(this->releasedSourceSize_, ' ');
+    this->source_ = move(contents);
+    prodCounterInc("types.input.files.rematerialized");
+    this->sourceReleased_.store(false, memory_order_release);
+}
+
 StrictLevel File::minErrorLevel() const {
     return minErrorLevel_;
 }
 
+u4 File::errorCount() const {
+    return errorCount_.load();
+}
+
 bool File::isPayload() const {
     return sourceType == Type::PayloadGeneration || sourceType == Type::Payload;
 }
@@ -162,7 +211,21 @@ bool File::isRBI() const {
 }
 
 bool File::isStdlib() const {
-    return fileSigil(source()) == StrictLevel::Stdlib;
+    // originalSigil is the constructor's fileSigil(source()); answering from it avoids re-scanning
+    // the whole buffer on every call (this runs per overload-permission check).
+    return originalSigil == StrictLevel::Stdlib;
+}
+
+size_t File::memoryBytes() const {
+    size_t result = sizeof(*this) + this->path_.capacity();
+    if (!this->sourceReleased_.load(std::memory_order_acquire)) {
+        result += this->source_.capacity();
+    }
+    auto lineBreaks = atomic_load(&this->lineBreaks_);
+    if (lineBreaks != nullptr) {
+        result += lineBreaks->capacity() * sizeof(int);
+    }
+    return result;
 }
 
 vector<int> &File::lineBreaks() const {
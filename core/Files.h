@@ -3,6 +3,7 @@
 
 #include "core/Names.h"
 #include "core/StrictLevel.h"
+#include <atomic>
 #include <string>
 
 namespace sorbet::core {
@@ -70,6 +71,10 @@ public:
     bool cachedParseTree = false;
     bool hasParseErrors = false; // some reasonable invariants don't hold for invalid files
     bool pluginGenerated = false;
+    // Whether the file may contain constructs the DSL pass rewrites. Cleared and recomputed during
+    // desugaring (which visits every send anyway); the conservative default keeps the DSL pass on
+    // for files that were never desugared.
+    bool hasDSLConstructs = true;
 
     friend class GlobalState;
     friend class ::sorbet::core::serialize::SerializerImpl;
@@ -80,10 +85,21 @@ public:
     std::string_view source() const;
     Type sourceType;
 
+    /** Drops the source buffer to reclaim memory; source() transparently re-reads the file from
+     * disk on next use. Only meaningful for Normal files that came from disk; editor buffers and
+     * plugin output have no backing file and are left alone. The line-break table is computed
+     * (and retained) before the buffer is dropped, so diagnostic positions never fault it back.
+     * Must not race with concurrent users of this file; call it between pipeline phases. */
+    void releaseSource();
+
     bool isPayload() const;
     bool isRBI() const;
     bool isStdlib() const;
 
+    /** Approximate heap bytes owned by this file, for the memory counters. Does not fault a
+     * released source buffer back in. */
+    size_t memoryBytes() const;
+
     File(std::string &&path_, std::string &&source_, Type sourceType);
     File(File &&other) = delete;
     File(const File &other) = delete;
@@ -92,18 +108,32 @@ public:
     std::vector<int> &lineBreaks() const;
     int lineCount() const;
     StrictLevel minErrorLevel() const;
+    u4 errorCount() const;
 
     /** Given a 1-based line number, returns a string view of the line. */
     std::string_view getLine(int i);
 
 private:
+    void materializeSource() const;
+
     const std::string path_;
-    const std::string source_;
+    mutable std::string source_;
+    // Set while source_ is dropped; see releaseSource().
+    mutable std::atomic<bool> sourceReleased_{false};
+    // Size of the buffer when it was dropped, so rematerialization can clamp to the extent all
+    // existing locs index into.
+    u4 releasedSourceSize_ = 0;
     mutable std::shared_ptr<std::vector<int>> lineBreaks_;
     mutable StrictLevel minErrorLevel_ = StrictLevel::Max;
+    // Non-silenced errors reported against this file, maintained by GlobalState::_error. Feeds the
+    // per-file error budget (--max-errors-per-file). Deliberately not carried across deepCopy: each
+    // run re-reports a file's errors from scratch, so a fresh GlobalState starts at zero.
+    mutable std::atomic<u4> errorCount_{0};
 
 public:
-    const StrictLevel originalSigil;
+    // The `# typed:` sigil as written in the file. Assigned once by the constructor (from the same
+    // fused scan that builds the line-break table) and never changed afterwards.
+    StrictLevel originalSigil;
     StrictLevel strictLevel;
 };
 
@@ -1,6 +1,8 @@
 #include "GlobalState.h"
 
 #include "common/Timer.h"
+#include "common/concurrency/ConcurrentQueue.h"
+#include "common/concurrency/WorkerPool.h"
 #include "core/Error.h"
 #include "core/Hashing.h"
 #include "core/NameHash.h"
@@ -55,6 +57,7 @@ GlobalState::GlobalState(shared_ptr<ErrorQueue> errorQueue)
     unsigned int maxSymbolCount = 16384;
 
     names.reserve(maxNameCount);
+    nameShortHashes.reserve(maxNameCount);
     symbols.reserve(maxSymbolCount);
     int namesByHashSize = 2 * maxNameCount;
     namesByHash.resize(namesByHashSize);
@@ -68,6 +71,7 @@ void GlobalState::initEmpty() {
     names.emplace_back(); // first name is used in hashes to indicate empty cell
     names[0].kind = NameKind::UTF8;
     names[0].raw.utf8 = string_view();
+    nameShortHashes.emplace_back(incZero(_hash(names[0].raw.utf8)));
     Names::registerNames(*this);
 
     SymbolRef id;
@@ -579,6 +583,21 @@ void GlobalState::reserveMemory(u4 kb) {
                        " names=", names.capacity()));
 }
 
+void GlobalState::reserveSymbols(u4 count) {
+    if (symbols.size() + count > symbols.capacity()) {
+        symbols.reserve(nextPowerOfTwo(symbols.size() + count));
+    }
+}
+
+void GlobalState::reserveNames(u4 count) {
+    u8 want = names.size() + count;
+    if (want <= names.capacity()) {
+        return;
+    }
+    u4 growBy = nextPowerOfTwo((want + names.capacity() - 1) / names.capacity());
+    expandNames(growBy);
+}
+
 constexpr decltype(GlobalState::STRINGS_PAGE_SIZE) GlobalState::STRINGS_PAGE_SIZE;
 
 // look up a symbol whose flags match the desired flags. This might look through mangled names to discover one whose
@@ -617,6 +636,10 @@ SymbolRef GlobalState::enterSymbol(Loc loc, SymbolRef owner, NameRef name, u4 fl
     if (store.exists()) {
         ENFORCE((store.data(*this)->flags & flags) == flags, "existing symbol has wrong flags");
         counterInc("symbols.hit");
+        if (store._id < payloadSymbolsEnd && reopenedPayloadSymbolIds.emplace(store._id).second) {
+            // Project code reopening a payload definition; project-segment walks must see it.
+            reopenedPayloadSymbols.emplace_back(store);
+        }
         return store;
     }
 
@@ -840,6 +863,8 @@ NameRef GlobalState::enterNameUTF8(string_view nm) {
 
     names[idx].kind = NameKind::UTF8;
     names[idx].raw.utf8 = enterString(nm);
+    // For UTF8 names the intern hash is exactly the short-name hash, so reuse it.
+    nameShortHashes.emplace_back(incZero(hs));
     ENFORCE(names[idx].hash(*this) == hs);
     categoryCounterInc("names", "utf8");
 
@@ -902,6 +927,8 @@ NameRef GlobalState::enterNameConstant(NameRef original) {
 
     names[idx].kind = CONSTANT;
     names[idx].cnst.original = original;
+    // shortName chases to the original, so the short-name hash is the original's.
+    nameShortHashes.emplace_back(nameShortHashes[original.id()]);
     ENFORCE(names[idx].hash(*this) == hs);
     wasModified_ = true;
     categoryCounterInc("names", "constant");
@@ -941,6 +968,26 @@ void GlobalState::expandNames(int growBy) {
     namesByHash.swap(new_namesByHash);
 }
 
+void GlobalState::refreshNameShortHashes() {
+    nameShortHashes.reserve(names.capacity());
+    for (auto i = nameShortHashes.size(); i < names.size(); i++) {
+        const auto &nm = names[i];
+        switch (nm.kind) {
+            case NameKind::UTF8:
+                nameShortHashes.emplace_back(incZero(_hash(nm.raw.utf8)));
+                break;
+            case NameKind::UNIQUE:
+                // Names only reference earlier names, so the original's slot is already filled.
+                nameShortHashes.emplace_back(nameShortHashes[nm.unique.original.id()]);
+                break;
+            case NameKind::CONSTANT:
+                nameShortHashes.emplace_back(nameShortHashes[nm.cnst.original.id()]);
+                break;
+        }
+    }
+    ENFORCE(nameShortHashes.size() == names.size());
+}
+
 NameRef GlobalState::lookupNameUnique(UniqueNameKind uniqueNameKind, NameRef original, u2 num) const {
     ENFORCE(num > 0, "num == 0, name overflow");
     const auto hs = _hash_mix_unique((u2)uniqueNameKind, UNIQUE, num, original.id());
@@ -1019,6 +1066,7 @@ NameRef GlobalState::freshNameUnique(UniqueNameKind uniqueNameKind, NameRef orig
     names[idx].unique.num = num;
     names[idx].unique.uniqueNameKind = uniqueNameKind;
     names[idx].unique.original = original;
+    nameShortHashes.emplace_back(nameShortHashes[original.id()]);
     ENFORCE(names[idx].hash(*this) == hs);
     wasModified_ = true;
     categoryCounterInc("names", "unique");
@@ -1105,6 +1153,45 @@ string GlobalState::toStringWithOptions(bool showFull, bool showRaw) const {
     return Symbols::root().data(*this)->toStringWithOptions(*this, 0, showFull, showRaw);
 }
 
+size_t GlobalState::nameTableMemoryBytes() const {
+    return names.capacity() * sizeof(Name) + namesByHash.capacity() * sizeof(pair<unsigned int, unsigned int>) +
+           strings.size() * STRINGS_PAGE_SIZE;
+}
+
+size_t GlobalState::symbolTableMemoryBytes() const {
+    size_t result = symbols.capacity() * sizeof(Symbol);
+    for (auto &sym : symbols) {
+        result += sym.members().size() * sizeof(SymbolMembers::value_type);
+        result += sym.arguments().size() * sizeof(ArgInfo);
+        result += sym.mixins_.capacity() * sizeof(SymbolRef);
+        result += sym.typeParams.capacity() * sizeof(SymbolRef);
+        result += sym.locs_.capacity() * sizeof(Loc);
+    }
+    return result;
+}
+
+size_t GlobalState::fileTableMemoryBytes() const {
+    size_t result = files.capacity() * sizeof(shared_ptr<File>);
+    for (auto &file : files) {
+        if (file != nullptr) {
+            result += file->memoryBytes();
+        }
+    }
+    return result;
+}
+
+void GlobalState::compactSymbolTable() {
+    Timer timeit(tracer(), "GlobalState::compactSymbolTable");
+    for (auto &sym : symbols) {
+        sym.members().shrink_to_fit();
+        sym.arguments().shrink_to_fit();
+        sym.mixins_.shrink_to_fit();
+        sym.typeParams.shrink_to_fit();
+        sym.locs_.shrink_to_fit();
+    }
+    symbols.shrink_to_fit();
+}
+
 void GlobalState::sanityCheck() const {
     if (!debug_mode) {
         return;
@@ -1123,6 +1210,7 @@ void GlobalState::sanityCheck() const {
             "name table and hash name table sizes out of sync names.capacity={} namesByHash.capacity={}",
             names.capacity(), namesByHash.capacity());
     ENFORCE(namesByHash.size() == namesByHash.capacity(), "hash name table not at full capacity");
+    ENFORCE(names.size() == nameShortHashes.size(), "name short-name hash cache out of sync with name table");
     int i = -1;
     for (auto &nm : names) {
         i++;
@@ -1147,6 +1235,45 @@ void GlobalState::sanityCheck() const {
     }
 }
 
+namespace {
+// Number of mutexes the lazy-hydration fault-in path stripes over; must be a power of two.
+constexpr u4 LAZY_SYMBOL_LOCK_COUNT = 64;
+} // namespace
+
+void GlobalState::enableLazySymbolHydration(void (*hydrator)(const GlobalState &gs, u4 symbolId),
+                                            const u1 *tableData, vector<u4> offsets) {
+    ENFORCE(!offsets.empty());
+    this->lazySymbolHydrator = hydrator;
+    this->lazySymbolTableData = tableData;
+    this->lazySymbolCount = offsets.size() - 1;
+    this->lazySymbolOffsets = move(offsets);
+    this->lazySymbolHydrated = make_unique<atomic<u1>[]>(this->lazySymbolCount);
+    this->lazySymbolLocks = make_unique<absl::Mutex[]>(LAZY_SYMBOL_LOCK_COUNT);
+}
+
+void GlobalState::hydrateLazySymbol(u4 symbolId) const {
+    auto &hydrated = this->lazySymbolHydrated[symbolId];
+    if (hydrated.load(std::memory_order_acquire)) {
+        return;
+    }
+    absl::MutexLock lock(&this->lazySymbolLocks[symbolId & (LAZY_SYMBOL_LOCK_COUNT - 1)]);
+    if (hydrated.load(std::memory_order_acquire)) {
+        return;
+    }
+    this->lazySymbolHydrator(*this, symbolId);
+    hydrated.store(1, std::memory_order_release);
+}
+
+void GlobalState::hydrateAllLazySymbols() const {
+    if (this->lazySymbolHydrator == nullptr) {
+        return;
+    }
+    Timer timeit(tracer(), "GlobalState::hydrateAllLazySymbols");
+    for (u4 i = 0; i < this->lazySymbolCount; i++) {
+        hydrateLazySymbol(i);
+    }
+}
+
 bool GlobalState::freezeNameTable() {
     bool old = this->nameTableFrozen;
     this->nameTableFrozen = true;
@@ -1162,6 +1289,11 @@ bool GlobalState::freezeFileTable() {
 bool GlobalState::freezeSymbolTable() {
     bool old = this->symbolTableFrozen;
     this->symbolTableFrozen = true;
+    if (!old) {
+        // Entries stamped while the table was unfrozen may predate later mutations in the same
+        // window, so the refreeze retires them too.
+        symbolTableEpoch_.fetch_add(1, std::memory_order_relaxed);
+    }
     return old;
 }
 
@@ -1180,17 +1312,87 @@ bool GlobalState::unfreezeFileTable() {
 bool GlobalState::unfreezeSymbolTable() {
     bool old = this->symbolTableFrozen;
     this->symbolTableFrozen = false;
+    if (old) {
+        symbolTableEpoch_.fetch_add(1, std::memory_order_relaxed);
+    }
     return old;
 }
 
-unique_ptr<GlobalState> GlobalState::deepCopy(bool keepId) const {
+namespace {
+// Symbols copied per unit of work when deep copying the symbol table in parallel.
+constexpr int SYMBOL_DEEP_COPY_CHUNK_SIZE = 4096;
+// Below this table size the fan-out overhead outweighs the parallelism.
+constexpr size_t MIN_SYMBOLS_FOR_PARALLEL_DEEP_COPY = 16384;
+} // namespace
+
+// Copying a symbol only reads `to`'s (already-populated) name table, so chunks of the table can be
+// copied on worker threads. Symbols are move-only; workers hand back whole chunks, which are
+// stitched together in table order at the end.
+void GlobalState::deepCopySymbolsParallel(GlobalState &to, bool keepId, WorkerPool &workers) const {
+    Timer timeit(tracer(), "GlobalState::deepCopySymbolsParallel");
+    const int numSymbols = this->symbols.size();
+    const int numChunks = (numSymbols + SYMBOL_DEEP_COPY_CHUNK_SIZE - 1) / SYMBOL_DEEP_COPY_CHUNK_SIZE;
+    auto chunkq = make_shared<ConcurrentBoundedQueue<int>>(numChunks);
+    for (int i = 0; i < numChunks; i++) {
+        auto copy = i;
+        chunkq->push(move(copy), 1);
+    }
+
+    auto resultq = make_shared<BlockingBoundedQueue<vector<pair<int, vector<Symbol>>>>>(numChunks);
+    workers.multiplexJob("deepCopySymbols", [chunkq, resultq, &from = *this, &to, keepId, numSymbols]() {
+        vector<pair<int, vector<Symbol>>> threadResult;
+        int processedByThread = 0;
+        int job;
+        for (auto result = chunkq->try_pop(job); !result.done(); result = chunkq->try_pop(job)) {
+            if (result.gotItem()) {
+                processedByThread++;
+                const int start = job * SYMBOL_DEEP_COPY_CHUNK_SIZE;
+                const int end = min(start + SYMBOL_DEEP_COPY_CHUNK_SIZE, numSymbols);
+                vector<Symbol> chunk;
+                chunk.reserve(end - start);
+                for (int i = start; i < end; i++) {
+                    chunk.emplace_back(from.symbols[i].deepCopy(to, keepId));
+                }
+                threadResult.emplace_back(job, move(chunk));
+            }
+        }
+        if (processedByThread > 0) {
+            resultq->push(move(threadResult), processedByThread);
+        }
+    });
+
+    vector<vector<Symbol>> chunks(numChunks);
+    {
+        vector<pair<int, vector<Symbol>>> threadResult;
+        for (auto result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), tracer());
+             !result.done(); result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), tracer())) {
+            if (result.gotItem()) {
+                for (auto &chunk : threadResult) {
+                    chunks[chunk.first] = move(chunk.second);
+                }
+            }
+        }
+    }
+    for (auto &chunk : chunks) {
+        for (auto &sym : chunk) {
+            to.symbols.emplace_back(move(sym));
+        }
+    }
+}
+
+unique_ptr<GlobalState> GlobalState::deepCopy(bool keepId, WorkerPool *workers) const {
     Timer timeit(tracer(), "GlobalState::deepCopy", this->creation);
     this->sanityCheck();
+    // Copying walks the symbol table directly, so any lazily-loaded records must be materialized
+    // first.
+    this->hydrateAllLazySymbols();
     auto result = make_unique<GlobalState>(this->errorQueue);
 
     result->silenceErrors = this->silenceErrors;
+    result->suppressErrorDetails = this->suppressErrorDetails;
     result->autocorrect = this->autocorrect;
     result->suggestRuntimeProfiledType = this->suggestRuntimeProfiledType;
+    result->deferSigSuggestions = this->deferSigSuggestions;
     result->ensureCleanStrings = this->ensureCleanStrings;
     result->runningUnderAutogen = this->runningUnderAutogen;
     result->censorForSnapshotTests = this->censorForSnapshotTests;
@@ -1200,6 +1402,9 @@ unique_ptr<GlobalState> GlobalState::deepCopy(bool keepId) const {
     }
     result->deepCloneHistory = this->deepCloneHistory;
     result->deepCloneHistory.emplace_back(DeepCloneHistoryEntry{this->globalStateId, namesUsed()});
+    // Carried over so epoch-stamped values captured from the original remain valid against the
+    // copy until the copy's own first mutation.
+    result->symbolTableEpoch_.store(this->symbolTableEpoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
 
     result->strings = this->strings;
     result->stringsLastPageUsed = STRINGS_PAGE_SIZE;
@@ -1222,14 +1427,26 @@ unique_ptr<GlobalState> GlobalState::deepCopy(bool keepId) const {
         }
     }
 
+    // Name ids (and thus short-name hashes) are preserved by both copy modes above.
+    result->nameShortHashes = this->nameShortHashes;
+
     result->namesByHash.reserve(this->namesByHash.size());
     result->namesByHash = this->namesByHash;
 
     result->symbols.reserve(this->symbols.size());
-    for (auto &sym : this->symbols) {
-        result->symbols.emplace_back(sym.deepCopy(*result, keepId));
+    if (workers != nullptr && workers->size() > 1 && this->symbols.size() >= MIN_SYMBOLS_FOR_PARALLEL_DEEP_COPY) {
+        deepCopySymbolsParallel(*result, keepId, *workers);
+    } else {
+        for (auto &sym : this->symbols) {
+            result->symbols.emplace_back(sym.deepCopy(*result, keepId));
+        }
     }
     result->pathPrefix = this->pathPrefix;
+    // Symbol ids are preserved by both copy modes above (records are copied in table order), so the
+    // segment boundary and the reopened set stay valid in the copy.
+    result->payloadSymbolsEnd = this->payloadSymbolsEnd;
+    result->reopenedPayloadSymbols = this->reopenedPayloadSymbols;
+    result->reopenedPayloadSymbolIds = this->reopenedPayloadSymbolIds;
     for (auto &semanticExtension : this->semanticExtensions) {
         result->semanticExtensions.emplace_back(semanticExtension->deepCopy(*this, *result));
     }
@@ -1262,6 +1479,11 @@ void GlobalState::_error(unique_ptr<Error> error) const {
         error->what != core::errors::Resolver::SigInFileWithoutSigil) {
         loc.file().data(*this).minErrorLevel_ = min(loc.file().data(*this).minErrorLevel_, error->what.minLevel);
     }
+    if (loc.file().exists() && !error->isSilenced) {
+        // Feeds the per-file error budget (--max-errors-per-file); readers only compare the count
+        // against a threshold.
+        loc.file().data(*this).errorCount_.fetch_add(1, std::memory_order_relaxed);
+    }
 
     errorQueue->pushError(*this, move(error));
 }
@@ -1350,10 +1572,19 @@ bool GlobalState::wasModified() const {
     return wasModified_;
 }
 
+u4 GlobalState::symbolTableEpoch() const {
+    return symbolTableEpoch_.load(std::memory_order_relaxed);
+}
+
 void GlobalState::trace(string_view msg) const {
     errorQueue->tracer.trace(msg);
 }
 
+void GlobalState::markPayloadSymbolBoundary() {
+    ENFORCE(payloadSymbolsEnd == 0, "payload symbol boundary already recorded");
+    payloadSymbolsEnd = symbols.size();
+}
+
 void GlobalState::markAsPayload() {
     bool seenEmpty = false;
     for (auto &f : files) {
@@ -1398,18 +1629,30 @@ u4 patchHash(u4 hash) {
 }
 
 unique_ptr<GlobalStateHash> GlobalState::hash() const {
+    this->hydrateAllLazySymbols();
     constexpr bool DEBUG_HASHING_TAIL = false;
     u4 hierarchyHash = 0;
     UnorderedMap<NameHash, u4> methodHashes;
+    UnorderedMap<NameHash, u4> methodShapeHashes;
+    UnorderedMap<NameHash, u4> defHashes;
     int counter = 0;
     for (const auto &sym : this->symbols) {
         if (!sym.ignoreInHashing(*this)) {
             if (sym.isMethod()) {
-                auto &target = methodHashes[NameHash(*this, sym.name.data(*this))];
+                auto nameHash = NameHash(*this, sym.name);
+                auto &target = methodHashes[nameHash];
                 target = mix(target, sym.hash(*this));
-                hierarchyHash = mix(hierarchyHash, sym.methodShapeHash(*this));
+                // Shape changes are tracked per name rather than folded into hierarchyHash:
+                // adding or removing a method still changes the owner's hash (member names are
+                // part of it), but editing an existing method's shape only needs to reach the
+                // files that use or override that name.
+                auto &shapeTarget = methodShapeHashes[nameHash];
+                shapeTarget = mix(shapeTarget, sym.methodShapeHash(*this));
             } else {
-                hierarchyHash = mix(hierarchyHash, sym.hash(*this));
+                auto symHash = sym.hash(*this);
+                auto &defTarget = defHashes[NameHash(*this, sym.name)];
+                defTarget = mix(defTarget, symHash);
+                hierarchyHash = mix(hierarchyHash, symHash);
             }
         }
         counter++;
@@ -1421,6 +1664,12 @@ unique_ptr<GlobalStateHash> GlobalState::hash() const {
     for (const auto &e : methodHashes) {
         result->methodHashes[e.first] = patchHash(e.second);
     }
+    for (const auto &e : methodShapeHashes) {
+        result->methodShapeHashes[e.first] = patchHash(e.second);
+    }
+    for (const auto &e : defHashes) {
+        result->defHashes[e.first] = patchHash(e.second);
+    }
     result->hierarchyHash = patchHash(hierarchyHash);
     return result;
 }
@@ -10,8 +10,13 @@
 #include "core/Symbols.h"
 #include "core/lsp/Query.h"
 #include "main/pipeline/semantic_extension/SemanticExtension.h"
+#include <atomic>
 #include <memory>
 
+namespace sorbet {
+class WorkerPool;
+}
+
 namespace sorbet::core {
 
 class Name;
@@ -21,6 +26,7 @@ class SymbolRef;
 class GlobalSubstitution;
 class ErrorRegion;
 class ErrorQueue;
+class NameHash;
 struct GlobalStateHash;
 
 namespace serialize {
@@ -36,6 +42,7 @@ class GlobalState final {
     friend File;
     friend FileRef;
     friend GlobalSubstitution;
+    friend NameHash;
     friend ErrorRegion;
     friend ErrorBuilder;
     friend serialize::Serializer;
@@ -55,6 +62,15 @@ public:
     // operation to avoid table resizes.
     void reserveMemory(u4 kb);
 
+    // Ensure capacity for `count` more symbols, so that entering them won't reallocate the
+    // symbol table mid-phase. A capacity hint: overshooting wastes some memory, undershooting
+    // just means the table grows as usual.
+    void reserveSymbols(u4 count);
+    // Ensures capacity for `count` additional names. expandNames rehashes every existing name, so
+    // callers that know how many names are coming (e.g. substitution merges) should reserve once
+    // up front instead of letting the table double repeatedly as entries stream in.
+    void reserveNames(u4 count);
+
     GlobalState(const GlobalState &) = delete;
     GlobalState(GlobalState &&) = delete;
 
@@ -113,7 +129,36 @@ public:
     unsigned int symbolsUsed() const;
     unsigned int filesUsed() const;
 
+    // Symbol table segmentation. When the base image is the compiled-in payload, every symbol below
+    // the recorded boundary originates from the stdlib and was fully resolved before the payload
+    // was serialized, so full-table passes can walk just [boundary, symbolsUsed()). Payload symbols
+    // that project code reopens (and that namer may therefore mutate) are tracked as they are
+    // re-entered and visited by project-segment walks too. The boundary stays unset — and the walk
+    // degrades to the full table — for kvstore images, which carry the previous run's project
+    // symbols, and for --no-stdlib runs, where nothing above the synthetic symbols is settled.
+    void markPayloadSymbolBoundary();
+    // Bounds are re-evaluated every iteration (like the `i < symbolsUsed()` loops this replaces)
+    // so that symbols the callback itself creates or reopens still get visited.
+    template <typename Fn> void forEachProjectSymbol(Fn fn) const {
+        for (size_t i = 0; i < reopenedPayloadSymbols.size(); i++) {
+            fn(reopenedPayloadSymbols[i]);
+        }
+        for (u4 i = payloadSymbolsEnd == 0 ? 1 : payloadSymbolsEnd; i < symbolsUsed(); i++) {
+            fn(SymbolRef(this, i));
+        }
+    }
+
     void sanityCheck() const;
+    // Approximate heap bytes owned by the major tables, surfaced through --counters / statsd at
+    // phase boundaries. Shallow element sizes only (no tree or type graphs), and cheap enough to
+    // call once per phase.
+    size_t nameTableMemoryBytes() const;
+    size_t symbolTableMemoryBytes() const;
+    size_t fileTableMemoryBytes() const;
+    // Drops slack capacity from the symbol table. Called once the resolver has finished mutating
+    // symbols; the growth-doubling headroom in the table and in each symbol's member vectors is
+    // dead weight for the rest of the run.
+    void compactSymbolTable();
     void markAsPayload();
 
     // These methods are here to make it easier to print the symbol table in lldb.
@@ -146,11 +191,24 @@ public:
 
     int totalErrors() const;
     bool wasModified() const;
+    // Monotonic generation counter for the symbol table, for epoch-validated caches (see
+    // core/EpochCache.h). Bumped on every freeze/unfreeze transition of the symbol table: any
+    // mutation — enterSymbol or a direct field write through SymbolData — requires an unfrozen
+    // table, so a value observed while the table is frozen stays valid until the next unfreeze.
+    u4 symbolTableEpoch() const;
 
     int globalStateId;
     bool silenceErrors = false;
+    // Errors still count toward the total and the exit code, but stop at (code, loc, file):
+    // ErrorBuilder never lets callers attach a header, sections, or autocorrects, and the flusher
+    // prints nothing for them. For runs that only consume the exit code and error count
+    // (--count-errors-only). Critical errors keep full detail.
+    bool suppressErrorDetails = false;
     bool autocorrect = false;
     bool suggestRuntimeProfiledType = false;
+    // When set, inference records sig-suggestion evidence instead of computing suggestions inline;
+    // pipeline::typecheck emits the suggestions in a parallel post-pass. See infer::SigSuggestion.
+    bool deferSigSuggestions = false;
 
     // We have a lot of internal names of form `<something>` that's chosen with `<` and `>` as you can't make
     // this into a valid ruby identifier without suffering.
@@ -166,7 +224,7 @@ public:
     bool runningUnderAutogen = false;
     bool censorForSnapshotTests = false;
 
-    std::unique_ptr<GlobalState> deepCopy(bool keepId = false) const;
+    std::unique_ptr<GlobalState> deepCopy(bool keepId = false, WorkerPool *workers = nullptr) const;
     mutable std::shared_ptr<ErrorQueue> errorQueue;
 
     // Contains a path prefix that should be stripped from all printed paths.
@@ -202,8 +260,14 @@ public:
 
     std::vector<std::unique_ptr<pipeline::semantic_extension::SemanticExtension>> semanticExtensions;
 
+    // Deserializes every symbol record still pending lazy hydration (see the lazySymbol* fields
+    // below). Must be called before anything walks `symbols` directly instead of going through
+    // SymbolRef::data; logically const, like the fault-in it forces.
+    void hydrateAllLazySymbols() const;
+
 private:
     bool shouldReportErrorOn(Loc loc, ErrorClass what) const;
+    void deepCopySymbolsParallel(GlobalState &to, bool keepId, WorkerPool &workers) const;
     struct DeepCloneHistoryEntry {
         int globalStateId;
         unsigned int lastNameKnownByParentGlobalState;
@@ -215,6 +279,10 @@ private:
     std::string_view enterString(std::string_view nm);
     u2 stringsLastPageUsed = STRINGS_PAGE_SIZE + 1;
     std::vector<Name> names;
+    // NameHash (incZero'd short-name hash) of every entered name, indexed by name id. Maintained
+    // incrementally by the enterName* methods and rebuilt in one flat pass after bulk loads (see
+    // refreshNameShortHashes), so hashing state never re-walks name bytes.
+    std::vector<u4> nameShortHashes;
     UnorderedMap<std::string, FileRef> fileRefByPath;
     std::vector<Symbol> symbols;
     std::vector<std::pair<unsigned int, unsigned int>> namesByHash;
@@ -223,6 +291,32 @@ private:
     UnorderedSet<int> onlyErrorClasses;
     UnorderedMap<NameRef, std::string> dslPlugins;
     bool wasModified_ = false;
+    // See symbolTableEpoch(). Atomic only so concurrent frozen-table readers can stamp and
+    // validate cache entries without formal data races; all bumps happen between phases on the
+    // coordinating thread.
+    std::atomic<u4> symbolTableEpoch_{1};
+
+    // See markPayloadSymbolBoundary / forEachProjectSymbol. 0 means "no boundary known".
+    u4 payloadSymbolsEnd = 0;
+    std::vector<SymbolRef> reopenedPayloadSymbols;
+    UnorderedSet<u4> reopenedPayloadSymbolIds;
+
+    // Lazy symbol hydration. When the compiled-in payload is loaded, `symbols` starts out as
+    // default-constructed records and the serialized bytes stay in rodata; a record is
+    // deserialized the first time SymbolRef::dataAllowingNone touches it, so stdlib corners a run
+    // never looks at are never decoded. The hydrator is a function pointer (rather than a direct
+    // call) so that core doesn't depend on core/serialize. Hydration is keyed by per-symbol
+    // acquire/release flags with striped locks, making fault-in safe from concurrent readers of a
+    // `const GlobalState &`.
+    void (*lazySymbolHydrator)(const GlobalState &gs, u4 symbolId) = nullptr;
+    const u1 *lazySymbolTableData = nullptr;
+    std::vector<u4> lazySymbolOffsets;
+    u4 lazySymbolCount = 0;
+    std::unique_ptr<std::atomic<u1>[]> lazySymbolHydrated;
+    std::unique_ptr<absl::Mutex[]> lazySymbolLocks;
+    void enableLazySymbolHydration(void (*hydrator)(const GlobalState &gs, u4 symbolId), const u1 *tableData,
+                                  std::vector<u4> offsets);
+    void hydrateLazySymbol(u4 symbolId) const;
 
     bool freezeSymbolTable();
     bool freezeNameTable();
@@ -235,6 +329,10 @@ private:
     bool fileTableFrozen = true;
 
     void expandNames(int growBy = 2);
+    // Extends nameShortHashes to cover names entered since the last call (a no-op when the cache
+    // is already current). Used after code paths that materialize names wholesale, e.g.
+    // deserialization, where the enterName* bookkeeping is bypassed.
+    void refreshNameShortHashes();
 
     SymbolRef synthesizeClass(NameRef nameID, u4 superclass = Symbols::todo()._id, bool isModule = false);
     SymbolRef enterSymbol(Loc loc, SymbolRef owner, NameRef name, u4 flags);
@@ -9,6 +9,14 @@
 namespace sorbet::core {
 class GlobalState;
 
+/**
+ * Maps NameRefs interned in one GlobalState onto another, for rewriting trees when parallel
+ * indexing results are merged. NameRef ids are dense, so the translation is a flat vector indexed
+ * by old id, built once per merge; `substitute` is a plain array load. When both states forked off
+ * `optionalCommonParent`, the shared prefix of the name table is identity by construction and is
+ * filled in without hash lookups, and if nothing was interned after the fork the walk is skipped
+ * entirely (see `useFastPath`).
+ */
 class GlobalSubstitution {
 public:
     GlobalSubstitution(const GlobalState &from, GlobalState &to, const GlobalState *optionalCommonParent = nullptr);
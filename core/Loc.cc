@@ -28,14 +28,17 @@ Loc::Detail Loc::offset2Pos(const File &file, u4 off) {
 
     ENFORCE(off <= file.source().size(), "file offset out of bounds in file: {} @ {} <= {}", string(file.path()),
             to_string(off), to_string(file.source().size()));
-    auto it = absl::c_lower_bound(file.lineBreaks(), off);
-    if (it == file.lineBreaks().begin()) {
+    // Fetch the cached table once: every lineBreaks() call is an atomic shared_ptr load, and this
+    // conversion runs per diagnostic and per LSP position mapping.
+    auto &lineBreaks = file.lineBreaks();
+    auto it = absl::c_lower_bound(lineBreaks, off);
+    if (it == lineBreaks.begin()) {
         pos.line = 1;
         pos.column = off + 1;
         return pos;
     }
     --it;
-    pos.line = (it - file.lineBreaks().begin()) + 1;
+    pos.line = (it - lineBreaks.begin()) + 1;
     pos.column = off - *it;
     return pos;
 }
@@ -52,8 +55,9 @@ Loc Loc::fromDetails(const GlobalState &gs, FileRef fileRef, Loc::Detail begin,
 }
 
 pair<Loc::Detail, Loc::Detail> Loc::position(const GlobalState &gs) const {
-    Loc::Detail begin(offset2Pos(this->file().data(gs), beginPos()));
-    Loc::Detail end(offset2Pos(this->file().data(gs), endPos()));
+    const auto &file = this->file().data(gs);
+    Loc::Detail begin(offset2Pos(file, beginPos()));
+    Loc::Detail end(offset2Pos(file, endPos()));
     return make_pair(begin, end);
 }
 namespace {
@@ -82,13 +86,14 @@ static_assert((WINDOW_SIZE & 1) == 0, "WINDOW_SIZE should be divisable by 2");
 void addLocLine(stringstream &buf, int line, const File &file, int tabs, int posWidth) {
     printTabs(buf, tabs);
     buf << rang::fgB::black << leftPad(to_string(line + 1), posWidth) << " |" << rang::style::reset;
-    ENFORCE(file.lineBreaks().size() > line + 1);
-    auto endPos = file.lineBreaks()[line + 1];
-    auto numToWrite = endPos - file.lineBreaks()[line];
+    auto &lineBreaks = file.lineBreaks();
+    ENFORCE(lineBreaks.size() > line + 1);
+    auto endPos = lineBreaks[line + 1];
+    auto numToWrite = endPos - lineBreaks[line];
     if (numToWrite <= 0) {
         return;
     }
-    buf.write(file.source().data() + file.lineBreaks()[line] + 1, numToWrite - 1);
+    buf.write(file.source().data() + lineBreaks[line] + 1, numToWrite - 1);
 }
 } // namespace
 
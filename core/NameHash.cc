@@ -4,11 +4,11 @@
 #include "core/Names.h"
 using namespace std;
 namespace sorbet::core {
-u4 incZero(u4 a) {
-    return a == 0 ? 1 : a;
-};
 NameHash::NameHash(const GlobalState &gs, const NameData &nm) : _hashValue(incZero(_hash(nm->shortName(gs)))){};
 NameHash::NameHash(const GlobalState &gs, const Name &nm) : _hashValue(incZero(_hash(nm.shortName(gs)))){};
+NameHash::NameHash(const GlobalState &gs, NameRef nm) : _hashValue(gs.nameShortHashes[nm.id()]) {
+    ENFORCE(_hashValue == incZero(_hash(nm.data(gs)->shortName(gs))));
+}
 
 void NameHash::sortAndDedupe(std::vector<core::NameHash> &hashes) {
     fast_sort(hashes);
@@ -4,7 +4,14 @@
 namespace sorbet::core {
 class Name;
 class NameData;
+class NameRef;
 class GlobalState;
+
+// NameHash values must never be 0: 0 is reserved for "not computed" (see isDefined).
+inline u4 incZero(u4 a) {
+    return a == 0 ? 1 : a;
+}
+
 class NameHash {
 public:
     /** Sorts an array of NameHashes and removes duplicates. */
@@ -12,11 +19,22 @@ public:
 
     NameHash(const GlobalState &gs, const NameData &nm);
     NameHash(const GlobalState &gs, const Name &nm);
+    /**
+     * O(1): reads the hash maintained by `gs` as names are entered instead of re-hashing the
+     * name's bytes. Prefer this overload whenever a NameRef is at hand.
+     */
+    NameHash(const GlobalState &gs, NameRef nm);
     inline bool isDefined() const {
         return _hashValue != 0;
     }
     NameHash(const NameHash &nm) = default;
     NameHash() : _hashValue(0){};
+    /** Rebuilds a NameHash from a previously computed _hashValue (e.g. a deserialized FileHash). */
+    static NameHash fromRaw(u4 hashValue) {
+        NameHash result;
+        result._hashValue = hashValue;
+        return result;
+    }
     inline bool operator==(const NameHash &rhs) const {
         ENFORCE(isDefined());
         ENFORCE(rhs.isDefined());
@@ -45,6 +63,15 @@ struct GlobalStateHash {
     static constexpr int HASH_STATE_INVALID_COLLISION_AVOID = 3;
     u4 hierarchyHash = HASH_STATE_NOT_COMPUTED;
     UnorderedMap<NameHash, u4> methodHashes;
+    // Per-name hashes of non-method definitions (classes, static fields, type members), mixed
+    // across same-named definitions. hierarchyHash folds the same symbols into one value and only
+    // says that *something* definition-shaped changed; these entries let the fast-path decision
+    // see which definitions changed and intersect them against the usage indexes.
+    UnorderedMap<NameHash, u4> defHashes;
+    // Method shapes (arity, keyword argument names, argument kinds) keyed by method name. Kept out
+    // of hierarchyHash so that editing a method's shape doesn't force retypechecking the whole
+    // workspace: the edit's dependants can be found by name through the usage indexes instead.
+    UnorderedMap<NameHash, u4> methodShapeHashes;
 };
 
 struct UsageHash {
@@ -55,6 +82,10 @@ struct UsageHash {
 struct FileHash {
     GlobalStateHash definitions;
     UsageHash usages;
+    // Hash of each method definition's source text, keyed by method name and mixed across
+    // same-named definitions. Unlike methodHashes (which cover the symbol, i.e. the signature),
+    // these tell the fast path which method bodies an edit actually touched.
+    UnorderedMap<NameHash, u4> methodBodyHashes;
 };
 
 }; // namespace sorbet::core
@@ -8,6 +8,7 @@
 #include "core/Names.h"
 #include "core/Types.h"
 #include "core/errors/internal.h"
+#include <cstdlib>
 #include <string>
 
 template class std::vector<sorbet::core::TypeAndOrigins>;
@@ -47,7 +48,7 @@ TypePtr Symbol::selfType(const GlobalState &gs) const {
     if (typeMembers().empty()) {
         return externalType(gs);
     } else {
-        return make_type<AppliedType>(ref(gs), selfTypeArgs(gs));
+        return AppliedType::make_shared(ref(gs), selfTypeArgs(gs));
     }
 }
 
@@ -59,7 +60,7 @@ TypePtr Symbol::externalType(const GlobalState &gs) const {
         TypePtr newResultType;
         auto ref = this->ref(gs);
         if (typeMembers().empty()) {
-            newResultType = make_type<ClassType>(ref);
+            newResultType = Types::classType(ref);
         } else {
             vector<TypePtr> targs;
             for (auto tm : typeMembers()) {
@@ -89,6 +90,11 @@ TypePtr Symbol::externalType(const GlobalState &gs) const {
 }
 
 bool Symbol::derivesFrom(const GlobalState &gs, SymbolRef sym) const {
+    if (this->ancestorFingerprint != 0 && (this->ancestorFingerprint & fingerprintBit(sym)) == 0) {
+        // The fingerprint contains every ancestor's bit, so a clear bit settles the common
+        // (negative) case without walking the hierarchy.
+        return false;
+    }
     if (isClassLinearizationComputed()) {
         for (SymbolRef a : mixins()) {
             if (a == sym) {
@@ -120,6 +126,9 @@ SymbolData SymbolRef::data(GlobalState &gs) const {
 
 SymbolData SymbolRef::dataAllowingNone(GlobalState &gs) const {
     ENFORCE(_id < gs.symbols.size());
+    if (gs.lazySymbolHydrator != nullptr && _id < gs.lazySymbolCount) {
+        gs.hydrateLazySymbol(_id);
+    }
     return SymbolData(gs.symbols[this->_id], gs);
 }
 
@@ -130,6 +139,9 @@ const SymbolData SymbolRef::data(const GlobalState &gs) const {
 
 const SymbolData SymbolRef::dataAllowingNone(const GlobalState &gs) const {
     ENFORCE(_id < gs.symbols.size());
+    if (gs.lazySymbolHydrator != nullptr && _id < gs.lazySymbolCount) {
+        gs.hydrateLazySymbol(_id);
+    }
     return SymbolData(const_cast<Symbol &>(gs.symbols[this->_id]), gs);
 }
 
@@ -357,8 +369,11 @@ vector<Symbol::FuzzySearchResult> Symbol::findMemberFuzzyMatchConstant(const Glo
                     if (member.first.data(gs)->kind == NameKind::CONSTANT &&
                         member.first.data(gs)->cnst.original.data(gs)->kind == NameKind::UTF8 &&
                         member.second.exists()) {
-                        auto thisDistance = Levenstein::distance(
-                            currentName, member.first.data(gs)->cnst.original.data(gs)->raw.utf8, best.distance);
+                        auto candidate = member.first.data(gs)->cnst.original.data(gs)->raw.utf8;
+                        if (abs((int)candidate.size() - (int)currentName.size()) > best.distance) {
+                            continue;
+                        }
+                        auto thisDistance = Levenstein::distance(currentName, candidate, best.distance);
                         if (thisDistance <= best.distance) {
                             best.distance = thisDistance;
                             best.symbol = member.second;
@@ -396,8 +411,14 @@ vector<Symbol::FuzzySearchResult> Symbol::findMemberFuzzyMatchConstant(const Glo
                         member.second.data(gs)->derivesFrom(gs, core::Symbols::StubModule())) {
                         continue;
                     }
-                    auto thisDistance = Levenstein::distance(
-                        currentName, member.first.data(gs)->cnst.original.data(gs)->raw.utf8, best.distance);
+                    auto candidate = member.first.data(gs)->cnst.original.data(gs)->raw.utf8;
+                    if (abs((int)candidate.size() - (int)currentName.size()) > best.distance) {
+                        if (member.second.data(gs)->isClass()) {
+                            yetToGoDeeper.emplace_back(member.second);
+                        }
+                        continue;
+                    }
+                    auto thisDistance = Levenstein::distance(currentName, candidate, best.distance);
                     if (thisDistance <= globalBestDistance) {
                         if (thisDistance < globalBestDistance) {
                             globalBest.clear();
@@ -440,6 +461,9 @@ Symbol::FuzzySearchResult Symbol::findMemberFuzzyMatchUTF8(const GlobalState &gs
             continue;
         }
         auto utf8 = thisName.data(gs)->raw.utf8;
+        if (abs((int)utf8.size() - (int)currentName.size()) > result.distance) {
+            continue;
+        }
         int thisDistance = Levenstein::distance(currentName, utf8, result.distance);
         if (thisDistance < result.distance ||
             (thisDistance == result.distance && result.symbol._id > pair.second._id)) {
@@ -842,7 +866,7 @@ void Symbol::recordSealedSubclass(MutableContext ctx, SymbolRef subclass) {
     auto currentClasses = appliedType->targs[0];
     // Abusing T.any to be list cons, with T.noreturn as the empty list.
     // (Except it's not, because Types::lub is too smart, and drops the T.noreturn to prevent allocating a T.any)
-    appliedType->targs[0] = Types::any(ctx, currentClasses, make_type<ClassType>(classOfSubclass));
+    appliedType->targs[0] = Types::any(ctx, currentClasses, Types::classType(classOfSubclass));
 }
 
 const InlinedVector<Loc, 2> &Symbol::sealedLocs(const GlobalState &gs) const {
@@ -867,7 +891,7 @@ TypePtr Symbol::sealedSubclassesToUnion(const Context ctx) const {
     auto currentClasses = appliedType->targs[0];
     if (currentClasses->isBottom()) {
         // Declared sealed parent class, but never saw any children.
-        return make_type<ClassType>(this->ref(ctx));
+        return Types::classType(this->ref(ctx));
     }
 
     auto result = Types::bottom();
@@ -876,14 +900,14 @@ TypePtr Symbol::sealedSubclassesToUnion(const Context ctx) const {
         ENFORCE(classType != nullptr, "Something in sealedSubclasses that's not a ClassType");
         auto subclass = classType->symbol.data(ctx)->attachedClass(ctx);
         ENFORCE(subclass.exists());
-        result = Types::any(ctx, make_type<ClassType>(subclass), result);
+        result = Types::any(ctx, Types::classType(subclass), result);
         currentClasses = orType->left;
     }
     auto lastClassType = cast_type<ClassType>(currentClasses.get());
     ENFORCE(lastClassType != nullptr, "Last element of sealedSubclasses must be ClassType");
     auto subclass = lastClassType->symbol.data(ctx)->attachedClass(ctx);
     ENFORCE(subclass.exists());
-    result = Types::any(ctx, make_type<ClassType>(subclass), result);
+    result = Types::any(ctx, Types::classType(subclass), result);
 
     return result;
 }
@@ -970,6 +994,7 @@ Symbol Symbol::deepCopy(const GlobalState &to, bool keepGsId) const {
     }
     result.superClassOrRebind = this->superClassOrRebind;
     result.uniqueCounter = this->uniqueCounter;
+    result.ancestorFingerprint = this->ancestorFingerprint;
     result.intrinsic = this->intrinsic;
     return result;
 }
@@ -1039,7 +1064,10 @@ u4 Symbol::hash(const GlobalState &gs) const {
     result = mix(result, this->superClassOrRebind._id);
     // argumentsOrMixins, typeParams, typeAliases
     for (auto e : membersStableOrderSlow(gs)) {
-        if (e.second.exists() && !e.second.data(gs)->ignoreInHashing(gs)) {
+        // Method members are tracked per-name in GlobalStateHash::methodHashes; folding their
+        // names into the owner's hash would turn every method addition or rename into a change of
+        // the owning class, which the fast path can only treat as a whole-hierarchy change.
+        if (e.second.exists() && !e.second.data(gs)->ignoreInHashing(gs) && !e.second.data(gs)->isMethod()) {
             result = mix(result, _hash(e.second.data(gs)->name.data(gs)->shortName(gs)));
         }
     }
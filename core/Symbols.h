@@ -6,6 +6,7 @@
 #include "core/Names.h"
 #include "core/SymbolRef.h"
 #include "core/Types.h"
+#include <algorithm>
 #include <memory>
 #include <tuple>
 #include <vector>
@@ -32,6 +33,92 @@ public:
 
 enum class Variance { CoVariant = 1, ContraVariant = -1, Invariant = 0 };
 
+/**
+ * The member table of a Symbol scope. Most scopes hold only a handful of members, so this is a
+ * vector sorted by name id (with inline storage for small scopes) rather than a hash map: lookups
+ * are a binary search over one or two cache lines, iteration never chases buckets, and warm symbol
+ * tables shrink accordingly. The interface mirrors the subset of the map API the code base uses.
+ */
+class SymbolMembers final {
+public:
+    using value_type = std::pair<NameRef, SymbolRef>;
+    using iterator = InlinedVector<value_type, 4>::iterator;
+    using const_iterator = InlinedVector<value_type, 4>::const_iterator;
+
+    iterator begin() {
+        return entries_.begin();
+    }
+    iterator end() {
+        return entries_.end();
+    }
+    const_iterator begin() const {
+        return entries_.begin();
+    }
+    const_iterator end() const {
+        return entries_.end();
+    }
+
+    size_t size() const {
+        return entries_.size();
+    }
+    bool empty() const {
+        return entries_.empty();
+    }
+    void reserve(size_t n) {
+        entries_.reserve(n);
+    }
+    void shrink_to_fit() {
+        entries_.shrink_to_fit();
+    }
+
+    iterator find(NameRef name) {
+        auto it = lowerBound(name);
+        if (it != entries_.end() && it->first == name) {
+            return it;
+        }
+        return entries_.end();
+    }
+    const_iterator find(NameRef name) const {
+        auto it = lowerBound(name);
+        if (it != entries_.end() && it->first == name) {
+            return it;
+        }
+        return entries_.end();
+    }
+
+    /** Inserts `name` with a non-existing SymbolRef if absent. The returned reference is
+     * invalidated by the next insertion into this table. */
+    SymbolRef &operator[](NameRef name) {
+        auto it = lowerBound(name);
+        if (it == entries_.end() || it->first != name) {
+            it = entries_.insert(it, std::make_pair(name, SymbolRef()));
+        }
+        return it->second;
+    }
+
+    SymbolRef at(NameRef name) const {
+        auto it = find(name);
+        ENFORCE(it != entries_.end());
+        return it->second;
+    }
+
+    void erase(iterator it) {
+        entries_.erase(it);
+    }
+
+private:
+    iterator lowerBound(NameRef name) {
+        return std::lower_bound(entries_.begin(), entries_.end(), name,
+                                [](const value_type &entry, NameRef name) { return entry.first.id() < name.id(); });
+    }
+    const_iterator lowerBound(NameRef name) const {
+        return std::lower_bound(entries_.begin(), entries_.end(), name,
+                                [](const value_type &entry, NameRef name) { return entry.first.id() < name.id(); });
+    }
+
+    InlinedVector<value_type, 4> entries_;
+};
+
 class Symbol final {
 public:
     Symbol(const Symbol &) = delete;
@@ -153,6 +240,12 @@ public:
 
     bool derivesFrom(const GlobalState &gs, SymbolRef sym) const;
 
+    /** The single bit a symbol contributes to ancestorFingerprint: its id scrambled by Knuth's
+     * multiplicative hash, taken to one of 64 positions. */
+    static inline u8 fingerprintBit(SymbolRef sym) {
+        return u8(1) << ((sym._id * 2654435761u) >> 26);
+    }
+
     // TODO(dmitry) perf: most calls to this method could be eliminated as part of perf work.
     SymbolRef ref(const GlobalState &gs) const;
 
@@ -578,6 +671,11 @@ public:
 
     u4 flags = Flags::NONE;
     u4 uniqueCounter = 1; // used as a counter inside the namer
+    // For classes: the union of fingerprintBit() over every ancestor (superclass chain plus
+    // linearized mixins, including the class itself), filled in after resolver linearization.
+    // Zero means not computed and derivesFrom walks the hierarchy as before. A clear bit proves
+    // non-ancestry; a set bit proves nothing.
+    u8 ancestorFingerprint = 0;
     NameRef name;         // todo: move out? it should not matter but it's important for name resolution
     TypePtr resultType;
 
@@ -586,13 +684,13 @@ public:
         return resultType != nullptr;
     }
 
-    UnorderedMap<NameRef, SymbolRef> members_;
+    SymbolMembers members_;
     std::vector<ArgInfo> arguments_;
 
-    UnorderedMap<NameRef, SymbolRef> &members() {
+    SymbolMembers &members() {
         return members_;
     };
-    const UnorderedMap<NameRef, SymbolRef> &members() const {
+    const SymbolMembers &members() const {
         return members_;
     };
 
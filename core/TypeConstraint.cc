@@ -1,8 +1,64 @@
 #include "core/TypeConstraint.h"
 #include "core/Symbols.h"
+#include "core/Types.h"
 using namespace std;
 namespace sorbet::core {
 
+namespace {
+// Dispatching into a generic method (or any call with a block) allocates a fresh constraint, and
+// generic-heavy code does so thousands of times per method body. Recycled constraints keep the
+// capacity of their bound vectors, so in steady state a dispatch allocates nothing.
+constexpr size_t MAX_POOLED_CONSTRAINTS = 64;
+thread_local vector<unique_ptr<TypeConstraint>> constraintPool;
+} // namespace
+
+unique_ptr<TypeConstraint> TypeConstraint::make() {
+    if (constraintPool.empty()) {
+        return make_unique<TypeConstraint>();
+    }
+    auto res = move(constraintPool.back());
+    constraintPool.pop_back();
+    return res;
+}
+
+void TypeConstraint::recycle(unique_ptr<TypeConstraint> constr) {
+    if (constr == nullptr || constraintPool.size() >= MAX_POOLED_CONSTRAINTS) {
+        return;
+    }
+    constr->reset();
+    constraintPool.emplace_back(move(constr));
+}
+
+void TypeConstraint::reset() {
+    upperBounds.clear();
+    lowerBounds.clear();
+    solution.clear();
+    wasSolved = false;
+    cantSolve = false;
+}
+
+TypeConstraint TypeConstraint::snapshot() const {
+    ENFORCE(!wasSolved);
+    TypeConstraint res;
+    res.upperBounds = this->upperBounds;
+    res.lowerBounds = this->lowerBounds;
+    res.solution = this->solution;
+    res.cantSolve = this->cantSolve;
+    return res;
+}
+
+void TypeConstraint::rollback(TypeConstraint &&snapshot) {
+    ENFORCE(!wasSolved);
+    this->upperBounds = move(snapshot.upperBounds);
+    this->lowerBounds = move(snapshot.lowerBounds);
+    this->solution = move(snapshot.solution);
+    this->cantSolve = snapshot.cantSolve;
+}
+
+DispatchComponent::~DispatchComponent() {
+    TypeConstraint::recycle(move(constr));
+}
+
 bool TypeConstraint::isEmpty() const {
     return upperBounds.empty() && lowerBounds.empty();
 }
@@ -16,11 +16,25 @@ class TypeConstraint {
     TypePtr &findUpperBound(SymbolRef forWhat);
     TypePtr &findLowerBound(SymbolRef forWhat);
     TypePtr &findSolution(SymbolRef forWhat);
+    void reset();
 
 public:
     TypeConstraint() = default;
     TypeConstraint(const TypeConstraint &) = delete;
     TypeConstraint(TypeConstraint &&) = default;
+    TypeConstraint &operator=(TypeConstraint &&) = default;
+
+    // Fetches a constraint from the per-thread pool, falling back to a fresh allocation when the
+    // pool is empty. Constraints handed out here come back via recycle().
+    static std::unique_ptr<TypeConstraint> make();
+    // Returns a constraint to the per-thread pool, keeping its vectors' capacity for the next
+    // dispatch. Accepts nullptr so callers can pass a possibly-empty member unconditionally.
+    static void recycle(std::unique_ptr<TypeConstraint> constr);
+
+    // Copies the recorded bounds so that a speculative probe can be undone with rollback(). Only
+    // valid before the constraint is solved.
+    TypeConstraint snapshot() const;
+    void rollback(TypeConstraint &&snapshot);
     void defineDomain(Context ctx, const InlinedVector<SymbolRef, 4> &typeParams);
     bool hasUpperBound(SymbolRef forWhat) const;
     bool hasLowerBound(SymbolRef forWhat) const;
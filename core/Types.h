@@ -103,6 +103,14 @@ public:
     static TypePtr declBuilderForProcsSingletonClass();
     static TypePtr falsyTypes();
 
+    /** Canonicalized `ClassType` for `symbol`; repeated requests return the same allocation. */
+    static TypePtr classType(SymbolRef symbol);
+
+    /** Canonicalized `LiteralType` for a symbol or string literal. Shapes repeat the same keys in
+     * every file that mentions a literal hash, so sharing one allocation per name matters. */
+    static TypePtr symbolLiteral(NameRef name);
+    static TypePtr stringLiteral(NameRef name);
+
     static TypePtr dropSubtypesOf(Context ctx, const TypePtr &from, SymbolRef klass);
     static TypePtr approximateSubtract(Context ctx, const TypePtr &from, const TypePtr &what);
     static bool canBeTruthy(Context ctx, const TypePtr &what);
@@ -566,6 +574,11 @@ public:
     std::vector<TypePtr> targs;
     AppliedType(SymbolRef klass, std::vector<TypePtr> targs);
 
+    // Hash-conses construction like OrType/AndType::make_shared: applying the same class to the
+    // same targs hands back the same TypePtr, so e.g. `T::Array[String]` is not reallocated by
+    // every generic instantiation that produces it.
+    static TypePtr make_shared(SymbolRef klass, std::vector<TypePtr> targs);
+
     virtual std::string toStringWithTabs(const GlobalState &gs, int tabs = 0) const final;
     virtual std::string show(const GlobalState &gs) const final;
     virtual std::string typeName() const final;
@@ -627,6 +640,18 @@ public:
     core::NameRef fun;
     std::shared_ptr<DispatchResult> result;
 
+    // Memoized block types from dispatchCallSymbol. A send with a block is re-dispatched once per
+    // component of a union receiver and once per CFG fixpoint iteration; when the method's type
+    // constraint is empty, its block types are a pure function of (receiver, method, targs) and the
+    // recompute can be skipped. Mutable because dispatch sees the link as const; a link is only ever
+    // used from the thread inferring its CFG.
+    mutable SymbolRef cachedBlockReceiver;
+    mutable SymbolRef cachedBlockMethod;
+    mutable int cachedBlockGlobalStateId = -1;
+    mutable InlinedVector<TypePtr, 4> cachedBlockTargs;
+    mutable TypePtr cachedBlockPreType;
+    mutable TypePtr cachedBlockReturnType;
+
     SendAndBlockLink(NameRef fun, std::vector<ArgInfo::ArgFlags> &&argFlags);
     std::optional<int> fixedArity() const;
     std::shared_ptr<SendAndBlockLink> duplicate();
@@ -689,6 +714,12 @@ struct DispatchComponent {
     TypePtr blockPreType;
     ArgInfo blockSpec; // used only by LoadSelf to change type of self inside method.
     std::unique_ptr<TypeConstraint> constr;
+
+    DispatchComponent() = default;
+    DispatchComponent(DispatchComponent &&) = default;
+    DispatchComponent &operator=(DispatchComponent &&) = default;
+    // Hands `constr` back to the per-thread constraint pool (see TypeConstraint::recycle).
+    ~DispatchComponent();
 };
 
 struct DispatchResult {
@@ -702,7 +733,7 @@ struct DispatchResult {
     DispatchResult(TypePtr returnType, TypePtr receiverType, core::SymbolRef method)
         : returnType(returnType),
           main(DispatchComponent{
-              receiverType, method, {}, std::move(returnType), nullptr, nullptr, ArgInfo{}, nullptr}){};
+              std::move(receiverType), method, {}, std::move(returnType), nullptr, nullptr, ArgInfo{}, nullptr}){};
     DispatchResult(TypePtr returnType, DispatchComponent comp)
         : returnType(std::move(returnType)), main(std::move(comp)){};
     DispatchResult(TypePtr returnType, DispatchComponent comp, std::unique_ptr<DispatchResult> secondary,
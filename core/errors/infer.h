@@ -33,5 +33,6 @@ constexpr ErrorClass AbstractClassInstantiated{7025, StrictLevel::True};
 constexpr ErrorClass NotExhaustive{7026, StrictLevel::True};
 constexpr ErrorClass UntypedConstantSuggestion{7027, StrictLevel::Strict};
 constexpr ErrorClass GenericTypeParamBoundMismatch{7028, StrictLevel::False};
+constexpr ErrorClass ErrorBudgetExceeded{7029, StrictLevel::True};
 } // namespace sorbet::core::errors::Infer
 #endif
@@ -1,5 +1,6 @@
 // have to be included first as they violate our poisons
 #include "core/proto/proto.h"
+#include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/util/type_resolver_util.h>
 
@@ -7,6 +8,7 @@
 #include "common/Counters_impl.h"
 #include "common/Random.h"
 #include "common/typecase.h"
+#include "core/Error.h"
 #include "core/Names.h"
 
 using namespace std;
@@ -216,6 +218,15 @@ com::stripe::rubytyper::Loc Proto::toProto(const GlobalState &gs, Loc loc) {
     return protoLoc;
 }
 
+com::stripe::rubytyper::Diagnostic Proto::toProto(const GlobalState &gs, const Error &error) {
+    com::stripe::rubytyper::Diagnostic diagnostic;
+    *diagnostic.mutable_loc() = toProto(gs, error.loc);
+    diagnostic.set_code(error.what.code);
+    diagnostic.set_is_critical(error.isCritical());
+    diagnostic.set_message(error.header);
+    return diagnostic;
+}
+
 com::stripe::payserver::events::cibot::SourceMetrics Proto::toProto(const CounterState &counters, string_view prefix) {
     com::stripe::payserver::events::cibot::SourceMetrics metrics;
     auto unix_timestamp = chrono::seconds(time(nullptr));
@@ -339,6 +350,17 @@ com::stripe::rubytyper::FileTable Proto::filesToProto(const GlobalState &gs) {
     return files;
 }
 
+string Proto::toDelimitedBinary(const google::protobuf::Message &message) {
+    string result;
+    {
+        google::protobuf::io::StringOutputStream stream(&result);
+        google::protobuf::io::CodedOutputStream coded(&stream);
+        coded.WriteVarint32(static_cast<google::protobuf::uint32>(message.ByteSizeLong()));
+        message.SerializeWithCachedSizes(&coded);
+    }
+    return result;
+}
+
 string Proto::toJSON(const google::protobuf::Message &message) {
     string jsonString;
     google::protobuf::util::JsonPrintOptions options;
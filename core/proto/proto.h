@@ -1,6 +1,7 @@
 #ifndef SORBET_CORE_PROTO_H
 #define SORBET_CORE_PROTO_H
 // have to go first as they violate our poisons
+#include "proto/Error.pb.h"
 #include "proto/File.pb.h"
 #include "proto/Loc.pb.h"
 #include "proto/Name.pb.h"
@@ -13,6 +14,8 @@
 #include <fstream>
 
 namespace sorbet::core {
+class Error;
+
 class Proto {
 public:
     Proto() = delete;
@@ -26,6 +29,7 @@ public:
     static com::stripe::rubytyper::Type toProto(const GlobalState &gs, TypePtr typ);
 
     static com::stripe::rubytyper::Loc toProto(const GlobalState &gs, Loc loc);
+    static com::stripe::rubytyper::Diagnostic toProto(const GlobalState &gs, const Error &error);
     static com::stripe::rubytyper::FileTable filesToProto(const GlobalState &gs);
 
     static com::stripe::payserver::events::cibot::SourceMetrics toProto(const CounterState &counters,
@@ -33,6 +37,9 @@ public:
 
     static std::string toJSON(const google::protobuf::Message &message);
     static void toJSON(const google::protobuf::Message &message, std::ostream &out);
+    // Serializes as a varint length prefix followed by the binary message, the framing consumers
+    // stream-parse with protobuf's delimited readers.
+    static std::string toDelimitedBinary(const google::protobuf::Message &message);
 };
 } // namespace sorbet::core
 
@@ -7,12 +7,28 @@ namespace sorbet::core::serialize {
 class Pickler {
     std::vector<u1> data;
     u1 zeroCounter = 0;
+    u4 lastU4Delta = 0;
 
 public:
+    // Passed as compressionDegree to store the stream raw; UnPickler then reads it in place.
+    static constexpr int UNCOMPRESSED = 0;
     void putU4(u4 u);
+    // Writes `u` as a zigzag-encoded delta against the previous value written through this
+    // method. Streams of clustered or slowly growing values (e.g. Loc offsets, which arrive
+    // roughly in source order) then collapse into one- and two-byte varints, and runs of equal
+    // values join putU4's zero-run encoding. The running value resets at boundary(), so
+    // records that a reader seeks to independently stay decodable.
+    void putU4Delta(u4 u);
     void putU1(const u1 u);
     void putS8(const int64_t i);
     void putStr(std::string_view s);
+    // Flushes any pending zero-run and returns the current byte offset. A reader that seeks to an
+    // offset returned by this method can decode from there without having read the bytes before
+    // it; see UnPickler::seek.
+    u4 boundary();
+    // Appends another pickler's raw bytes at a clean boundary. Call boundary() on `other` first so
+    // it has no pending zero-run.
+    void putPickler(const Pickler &other);
     std::vector<u1> result(int compressionDegree);
     Pickler() = default;
 };
@@ -20,14 +36,51 @@ public:
 class UnPickler {
     int pos;
     u1 zeroCounter = 0;
-    std::vector<u1> data;
+    u4 lastU4Delta = 0;
+    // When the input was stored uncompressed (see Pickler::result), `data` borrows the caller's
+    // buffer directly and `ownedData` stays empty: loading the compiled-in payload then touches
+    // only the pages it actually reads instead of decompressing and copying the whole stream.
+    std::vector<u1> ownedData;
+    const u1 *data;
 
 public:
     u4 getU4();
+    // Reads a value written with Pickler::putU4Delta.
+    u4 getU4Delta();
     u1 getU1();
     int64_t getS8();
     std::string_view getStr();
+    // Current byte offset; only meaningful at a clean boundary (no zero-run in flight).
+    int position() const {
+        ENFORCE(zeroCounter == 0);
+        return pos;
+    }
+    // Repositions the reader to an offset produced by Pickler::boundary.
+    void seek(int offset) {
+        pos = offset;
+        zeroCounter = 0;
+        lastU4Delta = 0;
+    }
+    // Mirrors Pickler::boundary() for a sequential reader: resets the putU4Delta running value at a
+    // point where the writer called boundary(). The byte stream itself is unchanged there, so only
+    // the delta state needs to follow along.
+    void resetDeltaState() {
+        ENFORCE(zeroCounter == 0);
+        lastU4Delta = 0;
+    }
+    // True when `data` borrows the caller's buffer instead of owning a decompressed copy.
+    bool borrowsData() const {
+        return ownedData.empty();
+    }
+    const u1 *borrowedData() const {
+        ENFORCE(borrowsData());
+        return data;
+    }
     explicit UnPickler(const u1 *const compressed, spdlog::logger &tracer);
+    // Positions a reader at `offset` inside a raw stream previously produced with
+    // Pickler::result(UNCOMPRESSED). `raw` must point past that stream's header (see
+    // borrowedData) and outlive the reader.
+    UnPickler(const u1 *const raw, int offset) : pos(offset), data(raw) {}
 };
 
 } // namespace sorbet::core::serialize
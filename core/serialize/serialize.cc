@@ -26,23 +26,29 @@ const u1 Serializer::FILE_COMPRESSION_DEGREE;
 class SerializerImpl {
 public:
     static Pickler pickle(const GlobalState &gs, bool payloadOnly = false);
+    static Pickler pickleDelta(const GlobalState &gs, const GlobalState &base);
     static void pickle(Pickler &p, const File &what);
     static void pickle(Pickler &p, const Name &what);
     static void pickle(Pickler &p, Type *what);
     static void pickle(Pickler &p, const ArgInfo &a);
     static void pickle(Pickler &p, const Symbol &what);
     static void pickle(Pickler &p, FileRef file, const unique_ptr<ast::Expression> &what);
+    static void pickle(Pickler &p, FileRef file, ast::Expression *what);
     static void pickle(Pickler &p, core::Loc loc);
+    static void pickleTreeLoc(Pickler &p, core::Loc loc);
 
     template <class T> static void pickleTree(Pickler &p, FileRef file, unique_ptr<T> &t);
 
     static shared_ptr<File> unpickleFile(UnPickler &p);
-    static Name unpickleName(UnPickler &p, GlobalState &gs);
+    static Name unpickleName(UnPickler &p, GlobalState &gs, bool borrowStrings = false);
     static TypePtr unpickleType(UnPickler &p, GlobalState *gs);
     static ArgInfo unpickleArgInfo(UnPickler &p, GlobalState *gs);
     static Symbol unpickleSymbol(UnPickler &p, GlobalState *gs);
-    static void unpickleGS(UnPickler &p, GlobalState &result);
-    static Loc unpickleLoc(UnPickler &p, FileRef file);
+    static void unpickleGS(UnPickler &p, GlobalState &result, bool lazySymbols = false);
+    static void hydrateLazySymbol(const GlobalState &gs, u4 symbolId);
+    static void unpickleDelta(UnPickler &p, GlobalState &result);
+    static Loc unpickleLoc(UnPickler &p);
+    static Loc unpickleTreeLoc(UnPickler &p, FileRef file);
     static unique_ptr<ast::Expression> unpickleExpr(UnPickler &p, GlobalState &, FileRef file);
     static NameRef unpickleNameRef(UnPickler &p, GlobalState &);
 
@@ -62,11 +68,30 @@ void Pickler::putStr(string_view s) {
 
 constexpr size_t SIZE_BYTES = sizeof(int) / sizeof(u1);
 
+// Collects one (name id, byte offset) pair per MethodDef while storeExpression pickles a tree; the
+// recursive pickle overloads have no spare parameter to thread it through. nullptr outside
+// storeExpression (e.g. while pickling a GlobalState), in which case the MethodDef case only
+// establishes the boundary.
+thread_local vector<Serializer::ExpressionChunk> *currentExpressionChunks = nullptr;
+
 vector<u1> Pickler::result(int compressionDegree) {
     if (zeroCounter != 0) {
         data.emplace_back(zeroCounter);
         zeroCounter = 0;
     }
+    if (compressionDegree == UNCOMPRESSED) {
+        // Stored raw so that UnPickler can borrow the buffer without decompressing or copying.
+        // The header keeps the same shape as the compressed format; a compressedSize of -1 marks
+        // the raw encoding.
+        vector<u1> rawData;
+        rawData.resize(data.size() + SIZE_BYTES * 2);
+        int rawMarker = -1;
+        memcpy(rawData.data(), &rawMarker, SIZE_BYTES);
+        int uncompressedSize = data.size();
+        memcpy(rawData.data() + SIZE_BYTES, &uncompressedSize, SIZE_BYTES);
+        memcpy(rawData.data() + SIZE_BYTES * 2, data.data(), data.size());
+        return rawData;
+    }
     const size_t maxDstSize = Lizard_compressBound(data.size());
     vector<u1> compressedData;
     compressedData.resize(2048 + maxDstSize); // give extra room for compression
@@ -97,13 +122,22 @@ UnPickler::UnPickler(const u1 *const compressed, spdlog::logger &tracer) : pos(0
     int uncompressedSize;
     memcpy(&uncompressedSize, compressed + SIZE_BYTES, SIZE_BYTES);
 
-    data.resize(uncompressedSize);
+    if (compressedSize == -1) {
+        // Raw encoding (see Pickler::result): read straight out of the caller's buffer. For the
+        // compiled-in payload this is a pointer into the binary's rodata, so startup cost becomes
+        // the page faults for what we read rather than a full decompress-and-copy.
+        this->data = compressed + 2 * SIZE_BYTES;
+        return;
+    }
+
+    ownedData.resize(uncompressedSize);
 
-    int resultCode = Lizard_decompress_safe((const char *)(compressed + 2 * SIZE_BYTES), (char *)this->data.data(),
+    int resultCode = Lizard_decompress_safe((const char *)(compressed + 2 * SIZE_BYTES), (char *)ownedData.data(),
                                             compressedSize, uncompressedSize);
     if (resultCode != uncompressedSize) {
         Exception::raise("incomplete decompression");
     }
+    this->data = ownedData.data();
 }
 
 string_view UnPickler::getStr() {
@@ -122,6 +156,24 @@ void Pickler::putU1(u1 u) {
     data.emplace_back(u);
 }
 
+u4 Pickler::boundary() {
+    if (zeroCounter != 0) {
+        data.emplace_back(zeroCounter);
+        zeroCounter = 0;
+    }
+    lastU4Delta = 0;
+    return data.size();
+}
+
+void Pickler::putPickler(const Pickler &other) {
+    ENFORCE(other.zeroCounter == 0, "call boundary() on the appended pickler first");
+    if (zeroCounter != 0) {
+        data.emplace_back(zeroCounter);
+        zeroCounter = 0;
+    }
+    data.insert(data.end(), other.data.begin(), other.data.end());
+}
+
 u1 UnPickler::getU1() {
     ENFORCE(zeroCounter == 0);
     auto res = data[pos++];
@@ -202,6 +254,20 @@ u4 UnPickler::getU4() {
     }
 }
 
+void Pickler::putU4Delta(u4 u) {
+    // Values are at most 24 bits wide (Loc offsets), so the difference always fits in an int32_t.
+    auto delta = static_cast<int32_t>(u) - static_cast<int32_t>(lastU4Delta);
+    lastU4Delta = u;
+    putU4((static_cast<u4>(delta) << 1) ^ static_cast<u4>(delta >> 31));
+}
+
+u4 UnPickler::getU4Delta() {
+    auto zigzag = getU4();
+    auto delta = static_cast<int32_t>(zigzag >> 1) ^ -static_cast<int32_t>(zigzag & 1);
+    lastU4Delta = static_cast<u4>(static_cast<int32_t>(lastU4Delta) + delta);
+    return lastU4Delta;
+}
+
 void Pickler::putS8(const int64_t i) {
     auto u = absl::bit_cast<u8>(i);
     while (u > 127) {
@@ -254,13 +320,21 @@ void SerializerImpl::pickle(Pickler &p, const Name &what) {
     }
 }
 
-Name SerializerImpl::unpickleName(UnPickler &p, GlobalState &gs) {
+Name SerializerImpl::unpickleName(UnPickler &p, GlobalState &gs, bool borrowStrings) {
     Name result;
     result.kind = (NameKind)p.getU1();
     switch (result.kind) {
         case NameKind::UTF8:
             result.kind = NameKind::UTF8;
-            result.raw.utf8 = gs.enterString(p.getStr());
+            if (borrowStrings) {
+                // The caller promised the stream outlives the GlobalState (the lazy-symbol
+                // contract), so point straight into it instead of copying every name into the
+                // string pages. The payload stores name bytes contiguously in table order, which
+                // is also denser under the enterNameUTF8 probe walk than scattered pages.
+                result.raw.utf8 = p.getStr();
+            } else {
+                result.raw.utf8 = gs.enterString(p.getStr());
+            }
             break;
         case NameKind::UNIQUE:
             result.unique.uniqueNameKind = (UniqueNameKind)p.getU1();
@@ -346,7 +420,7 @@ TypePtr SerializerImpl::unpickleType(UnPickler &p, GlobalState *gs) {
             return empty;
         }
         case 1:
-            return make_type<ClassType>(SymbolRef(gs, p.getU4()));
+            return Types::classType(SymbolRef(gs, p.getU4()));
         case 2:
             return OrType::make_shared(unpickleType(p, gs), unpickleType(p, gs));
         case 3: {
@@ -358,9 +432,10 @@ TypePtr SerializerImpl::unpickleType(UnPickler &p, GlobalState *gs) {
                 case LiteralType::LiteralTypeKind::Float:
                     return make_type<LiteralType>(absl::bit_cast<double>(value));
                 case LiteralType::LiteralTypeKind::String:
-                    return make_type<LiteralType>(Symbols::String(), core::NameRef(NameRef::WellKnown{}, value));
+                    // Interned: unpickling a cached file rebuilds the same key literals over and over.
+                    return Types::stringLiteral(core::NameRef(NameRef::WellKnown{}, value));
                 case LiteralType::LiteralTypeKind::Symbol:
-                    return make_type<LiteralType>(Symbols::Symbol(), core::NameRef(NameRef::WellKnown{}, value));
+                    return Types::symbolLiteral(core::NameRef(NameRef::WellKnown{}, value));
                 case LiteralType::LiteralTypeKind::True:
                     return make_type<LiteralType>(true);
                 case LiteralType::LiteralTypeKind::False:
@@ -434,13 +509,7 @@ ArgInfo SerializerImpl::unpickleArgInfo(UnPickler &p, GlobalState *gs) {
     ArgInfo result;
     result.name = core::NameRef(*gs, p.getU4());
     result.rebind = core::SymbolRef(gs, p.getU4());
-    {
-        core::Loc loc;
-        auto low = p.getU4();
-        auto high = p.getU4();
-        loc.setFrom2u4(low, high);
-        result.loc = loc;
-    }
+    result.loc = unpickleLoc(p);
     {
         u1 flags = p.getU1();
         result.flags.setFromU1(flags);
@@ -532,17 +601,14 @@ Symbol SerializerImpl::unpickleSymbol(UnPickler &p, GlobalState *gs) {
     result.resultType = unpickleType(p, gs);
     auto locCount = p.getU4();
     for (int i = 0; i < locCount; i++) {
-        core::Loc loc;
-        auto low = p.getU4();
-        auto high = p.getU4();
-        loc.setFrom2u4(low, high);
-        result.locs_.emplace_back(loc);
+        result.locs_.emplace_back(unpickleLoc(p));
     }
     return result;
 }
 
 Pickler SerializerImpl::pickle(const GlobalState &gs, bool payloadOnly) {
     Timer timeit(gs.tracer(), "pickleGlobalState");
+    gs.hydrateAllLazySymbols();
     Pickler result;
     result.putU4(Serializer::VERSION);
 
@@ -575,8 +641,24 @@ Pickler SerializerImpl::pickle(const GlobalState &gs, bool payloadOnly) {
     }
 
     result.putU4(gs.symbols.size());
-    for (const Symbol &s : gs.symbols) {
-        pickle(result, s);
+    {
+        // Symbol records go through a side pickler so that each record starts at a clean varint
+        // boundary, and the boundary offsets are written out ahead of the records. A loader can
+        // then decode any single record without having read the ones before it, which is what
+        // makes lazy hydration possible (see unpickleGS). The final offset is the total size of
+        // the record section.
+        Pickler symbolData;
+        vector<u4> offsets;
+        offsets.reserve(gs.symbols.size() + 1);
+        for (const Symbol &s : gs.symbols) {
+            offsets.emplace_back(symbolData.boundary());
+            pickle(symbolData, s);
+        }
+        offsets.emplace_back(symbolData.boundary());
+        for (auto offset : offsets) {
+            result.putU4(offset);
+        }
+        result.putPickler(symbolData);
     }
 
     result.putU4(gs.namesByHash.size());
@@ -595,7 +677,13 @@ int nearestPowerOf2(int from) {
     return i;
 }
 
-void SerializerImpl::unpickleGS(UnPickler &p, GlobalState &result) {
+void SerializerImpl::hydrateLazySymbol(const GlobalState &gs, u4 symbolId) {
+    UnPickler p(gs.lazySymbolTableData, static_cast<int>(gs.lazySymbolOffsets[symbolId]));
+    auto &writableGs = const_cast<GlobalState &>(gs);
+    writableGs.symbols[symbolId] = unpickleSymbol(p, &writableGs);
+}
+
+void SerializerImpl::unpickleGS(UnPickler &p, GlobalState &result, bool lazySymbols) {
     Timer timeit(result.tracer(), "unpickleGS");
     result.creation = timeit.getFlowEdge();
     if (p.getU4() != Serializer::VERSION) {
@@ -629,6 +717,8 @@ void SerializerImpl::unpickleGS(UnPickler &p, GlobalState &result) {
 
         int namesSize = p.getU4();
         ENFORCE(namesSize > 0);
+        // Mirrors the lazy-symbol gate below: only borrow when the stream has static storage.
+        const bool borrowNameStrings = lazySymbols && p.borrowsData();
         names.reserve(nearestPowerOf2(namesSize));
         for (int i = 0; i < namesSize; i++) {
             if (i == 0) {
@@ -636,7 +726,7 @@ void SerializerImpl::unpickleGS(UnPickler &p, GlobalState &result) {
                 inserted.kind = NameKind::UTF8;
                 inserted.raw.utf8 = string_view();
             } else {
-                names.emplace_back(unpickleName(p, result));
+                names.emplace_back(unpickleName(p, result, borrowNameStrings));
             }
         }
     }
@@ -646,10 +736,31 @@ void SerializerImpl::unpickleGS(UnPickler &p, GlobalState &result) {
 
         int symbolSize = p.getU4();
         ENFORCE(symbolSize > 0);
-        symbols.reserve(symbolSize);
-        for (int i = 0; i < symbolSize; i++) {
-            symbols.emplace_back(unpickleSymbol(p, &result));
+        vector<u4> offsets(symbolSize + 1);
+        for (auto &offset : offsets) {
+            offset = p.getU4();
         }
+        // Record offsets are relative to the start of the record section, which begins right
+        // after the offset table.
+        auto sectionStart = p.position();
+        auto sectionEnd = sectionStart + offsets[symbolSize];
+        // Lazy hydration keeps pointers into the serialized stream, so it is only safe when the
+        // stream is the compiled-in payload (static storage); callers opt in accordingly.
+        // Debug builds hydrate eagerly so that sanity checks see a fully materialized table.
+        if (lazySymbols && !debug_mode && p.borrowsData()) {
+            symbols.resize(symbolSize);
+            for (auto &offset : offsets) {
+                offset += sectionStart;
+            }
+            result.enableLazySymbolHydration(&SerializerImpl::hydrateLazySymbol, p.borrowedData(), std::move(offsets));
+        } else {
+            symbols.reserve(symbolSize);
+            for (int i = 0; i < symbolSize; i++) {
+                p.seek(sectionStart + offsets[i]);
+                symbols.emplace_back(unpickleSymbol(p, &result));
+            }
+        }
+        p.seek(sectionEnd);
     }
 
     {
@@ -681,39 +792,258 @@ void SerializerImpl::unpickleGS(UnPickler &p, GlobalState &result) {
         result.symbols = std::move(symbols);
         result.namesByHash = std::move(namesByHash);
     }
+    // The unpickled names replace the table wholesale, so the short-name hash cache has to be
+    // rebuilt from scratch rather than extended.
+    result.nameShortHashes.clear();
+    result.refreshNameShortHashes();
+    result.sanityCheck();
+}
+
+// Distinguishes a delta blob from a full payload (whose second word is a file count).
+constexpr u4 DELTA_MAGIC = 0xde17ade1;
+
+Pickler SerializerImpl::pickleDelta(const GlobalState &gs, const GlobalState &base) {
+    Timer timeit(gs.tracer(), "pickleGlobalStateDelta");
+    // Diffing compares serialized symbol records on both sides, so both tables must be fully
+    // materialized.
+    gs.hydrateAllLazySymbols();
+    base.hydrateAllLazySymbols();
+    ENFORCE(base.files.size() <= gs.files.size(), "delta base is newer than the state diffed against it");
+    ENFORCE(base.names.size() <= gs.names.size(), "delta base is newer than the state diffed against it");
+    ENFORCE(base.symbols.size() <= gs.symbols.size(), "delta base is newer than the state diffed against it");
+
+    // Records are compared through their serialized form: both sides pickle names and symbols by
+    // table id, and `gs` was built on top of `base`, so an untouched record produces identical
+    // bytes on both sides.
+    auto fileBytes = [](const File &f) {
+        Pickler p;
+        pickle(p, f);
+        return p.result(Pickler::UNCOMPRESSED);
+    };
+    auto symbolBytes = [](const Symbol &s) {
+        Pickler p;
+        pickle(p, s);
+        return p.result(Pickler::UNCOMPRESSED);
+    };
+
+    Pickler result;
+    result.putU4(Serializer::VERSION);
+    result.putU4(DELTA_MAGIC);
+    result.putU4(base.files.size());
+    result.putU4(base.names.size());
+    result.putU4(base.symbols.size());
+
+    vector<u4> changedFiles;
+    for (u4 i = 1; i < gs.files.size(); i++) {
+        if (i < base.files.size() && fileBytes(*gs.files[i]) == fileBytes(*base.files[i])) {
+            continue;
+        }
+        changedFiles.emplace_back(i);
+    }
+    result.putU4(gs.files.size());
+    result.putU4(changedFiles.size());
+    for (auto idx : changedFiles) {
+        result.putU4(idx);
+        pickle(result, *gs.files[idx]);
+    }
+
+    // Names are append-only, so everything past the base's count is the delta.
+    result.putU4(gs.names.size());
+    for (u4 i = base.names.size(); i < gs.names.size(); i++) {
+        pickle(result, gs.names[i]);
+    }
+
+    vector<u4> changedSymbols;
+    for (u4 i = 0; i < gs.symbols.size(); i++) {
+        if (i < base.symbols.size() && symbolBytes(gs.symbols[i]) == symbolBytes(base.symbols[i])) {
+            continue;
+        }
+        changedSymbols.emplace_back(i);
+    }
+    result.putU4(gs.symbols.size());
+    result.putU4(changedSymbols.size());
+    for (auto idx : changedSymbols) {
+        result.putU4(idx);
+        pickle(result, gs.symbols[idx]);
+    }
+
+    return result;
+}
+
+void SerializerImpl::unpickleDelta(UnPickler &p, GlobalState &result) {
+    Timer timeit(result.tracer(), "unpickleGSDelta");
+    // The delta overwrites symbol records by index, which requires a fully materialized table.
+    result.hydrateAllLazySymbols();
+    if (p.getU4() != Serializer::VERSION) {
+        Exception::raise("Payload version mismatch");
+    }
+    if (p.getU4() != DELTA_MAGIC) {
+        Exception::raise("Not a payload delta");
+    }
+    auto baseFiles = p.getU4();
+    auto baseNames = p.getU4();
+    auto baseSymbols = p.getU4();
+    if (baseFiles != result.files.size() || baseNames != result.names.size() ||
+        baseSymbols != result.symbols.size()) {
+        Exception::raise("Payload delta does not match the base image it is applied over");
+    }
+
+    {
+        Timer timeit(result.tracer(), "applyFileDelta");
+        auto fileCount = p.getU4();
+        auto changed = p.getU4();
+        result.files.reserve(fileCount);
+        for (u4 i = 0; i < changed; i++) {
+            auto idx = p.getU4();
+            auto file = unpickleFile(p);
+            if (idx < result.files.size()) {
+                result.files[idx] = move(file);
+            } else {
+                ENFORCE(idx == result.files.size());
+                result.files.emplace_back(move(file));
+            }
+        }
+        ENFORCE(result.files.size() == fileCount);
+        if (changed > 0) {
+            result.fileRefByPath.clear();
+            int i = 0;
+            for (auto &f : result.files) {
+                if (f && !f->path().empty()) {
+                    result.fileRefByPath[string(f->path())] = FileRef(i);
+                }
+                i++;
+            }
+        }
+    }
+
+    bool namesAdded;
+    {
+        Timer timeit(result.tracer(), "applyNameDelta");
+        auto nameCount = p.getU4();
+        namesAdded = nameCount > result.names.size();
+        result.names.reserve(nearestPowerOf2(nameCount));
+        while (result.names.size() < nameCount) {
+            result.names.emplace_back(unpickleName(p, result));
+        }
+        result.refreshNameShortHashes();
+    }
+
+    {
+        Timer timeit(result.tracer(), "applySymbolDelta");
+        auto symbolCount = p.getU4();
+        auto changed = p.getU4();
+        result.symbols.reserve(symbolCount);
+        for (u4 i = 0; i < changed; i++) {
+            auto idx = p.getU4();
+            auto symbol = unpickleSymbol(p, &result);
+            if (idx < result.symbols.size()) {
+                result.symbols[idx] = move(symbol);
+            } else {
+                ENFORCE(idx == result.symbols.size());
+                result.symbols.emplace_back(move(symbol));
+            }
+        }
+        ENFORCE(result.symbols.size() == symbolCount);
+    }
+
+    if (namesAdded) {
+        // The name hash table is not append-only (growth rehashes everything), so it is omitted
+        // from the delta and rebuilt here instead.
+        Timer timeit(result.tracer(), "rebuildNameTable");
+        unsigned int hashTableSize = result.namesByHash.size();
+        while (hashTableSize < 2 * result.names.size()) {
+            hashTableSize *= 2;
+        }
+        vector<pair<unsigned int, unsigned int>> namesByHash(hashTableSize);
+        unsigned int mask = hashTableSize - 1;
+        for (u4 i = 1; i < result.names.size(); i++) {
+            auto hs = result.names[i].hash(result);
+            auto bucketId = hs & mask;
+            unsigned int probeCount = 1;
+            while (namesByHash[bucketId].second != 0) {
+                bucketId = (bucketId + probeCount) & mask;
+                probeCount++;
+            }
+            namesByHash[bucketId] = make_pair(hs, i);
+        }
+        result.namesByHash = std::move(namesByHash);
+    }
+
     result.sanityCheck();
 }
 
 void SerializerImpl::pickle(Pickler &p, Loc loc) {
-    auto [low, high] = loc.getAs2u4();
-    p.putU4(low);
-    p.putU4(high);
+    // Locs dominate tree pickles (two offsets per node). Within a tree or a symbol record they
+    // arrive roughly in source order, so begin and end are stored as deltas against one running
+    // value: end lands close behind begin, and the next node's begin close behind this end.
+    p.putU4(loc.storage.fileRef);
+    p.putU4Delta(loc.storage.beginLoc);
+    p.putU4Delta(loc.storage.endLoc);
 }
 
-Loc SerializerImpl::unpickleLoc(UnPickler &p, FileRef file) {
+Loc SerializerImpl::unpickleLoc(UnPickler &p) {
     Loc loc;
-    auto low = p.getU4();
-    auto high = p.getU4();
-    loc.setFrom2u4(low, high);
-    loc.setFile(file);
+    loc.storage.fileRef = p.getU4();
+    loc.storage.beginLoc = p.getU4Delta();
+    loc.storage.endLoc = p.getU4Delta();
+    return loc;
+}
+
+void SerializerImpl::pickleTreeLoc(Pickler &p, Loc loc) {
+    // Tree locs never leave their file (pickle ENFORCEs it) and the reader assigns the file id of
+    // whatever file the tree is being loaded as, so only the offsets are stored.
+    p.putU4Delta(loc.storage.beginLoc);
+    p.putU4Delta(loc.storage.endLoc);
+}
+
+Loc SerializerImpl::unpickleTreeLoc(UnPickler &p, FileRef file) {
+    Loc loc;
+    loc.storage.fileRef = file.id();
+    loc.storage.beginLoc = p.getU4Delta();
+    loc.storage.endLoc = p.getU4Delta();
     return loc;
 }
 
 vector<u1> Serializer::store(GlobalState &gs) {
     Pickler p = SerializerImpl::pickle(gs);
-    return p.result(GLOBAL_STATE_COMPRESSION_DEGREE);
+    // Only used via --store-state to produce the payload that gets compiled into the binary;
+    // stored raw so that startup can unpickle straight out of rodata. See
+    // storePayloadAndNameTable.
+    return p.result(Pickler::UNCOMPRESSED);
 }
 
 vector<u1> Serializer::storePayloadAndNameTable(GlobalState &gs) {
     Timer timeit(gs.tracer(), "Serializer::storePayloadAndNameTable");
     Pickler p = SerializerImpl::pickle(gs, true);
-    return p.result(GLOBAL_STATE_COMPRESSION_DEGREE);
+    // The payload is loaded on every startup, either from the binary's rodata or from the
+    // kvstore's memory map. Storing it raw lets UnPickler read it in place, turning load cost
+    // into page faults for the bytes actually touched; the ~3x larger stored size is a good
+    // trade for that.
+    return p.result(Pickler::UNCOMPRESSED);
 }
 
-void Serializer::loadGlobalState(GlobalState &gs, const u1 *const data) {
+void Serializer::loadGlobalState(GlobalState &gs, const u1 *const data, bool lazySymbols) {
     ENFORCE(gs.files.empty() && gs.names.empty() && gs.symbols.empty(), "Can't load into a non-empty state");
     UnPickler p(data, gs.tracer());
+    SerializerImpl::unpickleGS(p, gs, lazySymbols);
+    gs.installIntrinsics();
+}
+
+vector<u1> Serializer::storeDelta(GlobalState &gs, const GlobalState &base) {
+    Timer timeit(gs.tracer(), "Serializer::storeDelta");
+    Pickler p = SerializerImpl::pickleDelta(gs, base);
+    // Deltas ride along with the base image and are applied on every startup; stored raw for the
+    // same in-place-read reasons as the payload itself, and they are small enough that on-disk
+    // size doesn't matter.
+    return p.result(Pickler::UNCOMPRESSED);
+}
+
+void Serializer::loadGlobalStateWithDelta(GlobalState &gs, const u1 *const baseData, const u1 *const deltaData) {
+    ENFORCE(gs.files.empty() && gs.names.empty() && gs.symbols.empty(), "Can't load into a non-empty state");
+    UnPickler p(baseData, gs.tracer());
     SerializerImpl::unpickleGS(p, gs);
+    UnPickler d(deltaData, gs.tracer());
+    SerializerImpl::unpickleDelta(d, gs);
     gs.installIntrinsics();
 }
 
@@ -727,10 +1057,14 @@ template <class T> void SerializerImpl::pickleTree(Pickler &p, FileRef file, uni
 
 void SerializerImpl::pickleAstHeader(Pickler &p, u1 tag, ast::Expression *tree) {
     p.putU1(tag);
-    pickle(p, tree->loc);
+    pickleTreeLoc(p, tree->loc);
 }
 
 void SerializerImpl::pickle(Pickler &p, FileRef file, const unique_ptr<ast::Expression> &what) {
+    pickle(p, file, what.get());
+}
+
+void SerializerImpl::pickle(Pickler &p, FileRef file, ast::Expression *what) {
     if (what == nullptr) {
         p.putU1(1);
         return;
@@ -739,7 +1073,7 @@ void SerializerImpl::pickle(Pickler &p, FileRef file, const unique_ptr<ast::Expr
             " inside a tree from ", file.id());
 
     typecase(
-        what.get(),
+        what,
         [&](ast::Send *s) {
             pickleAstHeader(p, 2, s);
             p.putU4(s->fun._id);
@@ -849,7 +1183,7 @@ void SerializerImpl::pickle(Pickler &p, FileRef file, const unique_ptr<ast::Expr
         [&](ast::EmptyTree *n) { pickleAstHeader(p, 20, n); },
         [&](ast::ClassDef *c) {
             pickleAstHeader(p, 21, c);
-            pickle(p, c->declLoc);
+            pickleTreeLoc(p, c->declLoc);
             p.putU1(c->kind);
             p.putU4(c->symbol._id);
             p.putU4(c->ancestors.size());
@@ -867,8 +1201,15 @@ void SerializerImpl::pickle(Pickler &p, FileRef file, const unique_ptr<ast::Expr
             }
         },
         [&](ast::MethodDef *c) {
+            // Every MethodDef subtree starts at a clean boundary so the chunk table written by
+            // storeExpression can hand out its offset for independent deserialization; unpickleExpr
+            // mirrors the delta reset when it reads the tag.
+            auto chunkOffset = p.boundary();
+            if (currentExpressionChunks != nullptr) {
+                currentExpressionChunks->emplace_back(Serializer::ExpressionChunk{c->name._id, chunkOffset});
+            }
             pickleAstHeader(p, 22, c);
-            pickle(p, c->declLoc);
+            pickleTreeLoc(p, c->declLoc);
             p.putU4(c->flags);
             p.putU4(c->name._id);
             p.putU4(c->symbol._id);
@@ -938,7 +1279,12 @@ unique_ptr<ast::Expression> SerializerImpl::unpickleExpr(serialize::UnPickler &p
     if (kind == 1) {
         return nullptr;
     }
-    Loc loc = unpickleLoc(p, file);
+    if (kind == 22) {
+        // MethodDefs are written at a Pickler boundary (see the chunk table in storeExpression);
+        // follow the writer's delta reset before decoding this subtree's locs.
+        p.resetDeltaState();
+    }
+    Loc loc = unpickleTreeLoc(p, file);
 
     switch (kind) {
         case 2: {
@@ -1055,7 +1401,7 @@ unique_ptr<ast::Expression> SerializerImpl::unpickleExpr(serialize::UnPickler &p
             return ast::MK::EmptyTree();
         }
         case 21: {
-            auto declLoc = unpickleLoc(p, file);
+            auto declLoc = unpickleTreeLoc(p, file);
             auto kind = p.getU1();
             SymbolRef symbol(gs, p.getU4());
             auto ancestorsSize = p.getU4();
@@ -1081,7 +1427,7 @@ unique_ptr<ast::Expression> SerializerImpl::unpickleExpr(serialize::UnPickler &p
             return ret;
         }
         case 22: {
-            auto declLoc = unpickleLoc(p, file);
+            auto declLoc = unpickleTreeLoc(p, file);
             auto flags = p.getU4();
             NameRef name = unpickleNameRef(p, gs);
             SymbolRef symbol(gs, p.getU4());
@@ -1167,16 +1513,120 @@ unique_ptr<ast::Expression> Serializer::loadExpression(GlobalState &gs, const u1
     serialize::UnPickler up(p, gs.tracer());
     u4 loaded = up.getU4();
     FileRef fileId(forceId > 0 ? forceId : loaded);
+    auto chunkCount = up.getU4();
+    for (u4 i = 0; i < chunkCount; i++) {
+        up.getU4(); // name id
+        up.getU4(); // offset
+    }
     return SerializerImpl::unpickleExpr(up, gs, fileId);
 }
 
-vector<u1> Serializer::storeExpression(GlobalState &gs, unique_ptr<ast::Expression> &e) {
+vector<u1> Serializer::storeExpression(GlobalState &gs, ast::Expression &e) {
+    // The tree is pickled into its own Pickler first: the header's offset table cannot be written
+    // until the offsets are known, and the offsets are relative to the start of the tree bytes so
+    // they do not depend on the table's own encoded size.
+    serialize::Pickler tree;
+    vector<ExpressionChunk> chunks;
+    ENFORCE(currentExpressionChunks == nullptr);
+    currentExpressionChunks = &chunks;
+    SerializerImpl::pickle(tree, e.loc.file(), &e);
+    currentExpressionChunks = nullptr;
+    tree.boundary();
+
     serialize::Pickler pickler;
-    pickler.putU4(e->loc.file().id());
-    SerializerImpl::pickle(pickler, e->loc.file(), e);
+    pickler.putU4(e.loc.file().id());
+    pickler.putU4(chunks.size());
+    for (auto &chunk : chunks) {
+        pickler.putU4(chunk.nameId);
+        pickler.putU4(chunk.offset);
+    }
+    pickler.boundary();
+    pickler.putPickler(tree);
     return pickler.result(FILE_COMPRESSION_DEGREE);
 }
 
+vector<Serializer::ExpressionChunk> Serializer::loadExpressionChunkTable(const u1 *const p, spdlog::logger &tracer) {
+    serialize::UnPickler up(p, tracer);
+    up.getU4(); // file id
+    auto chunkCount = up.getU4();
+    vector<ExpressionChunk> ret(chunkCount);
+    for (auto &chunk : ret) {
+        chunk.nameId = up.getU4();
+        chunk.offset = up.getU4();
+    }
+    return ret;
+}
+
+unique_ptr<ast::Expression> Serializer::loadExpressionChunk(GlobalState &gs, const u1 *const p, u4 offset,
+                                                            u4 forceId) {
+    serialize::UnPickler up(p, gs.tracer());
+    u4 loaded = up.getU4();
+    FileRef fileId(forceId > 0 ? forceId : loaded);
+    auto chunkCount = up.getU4();
+    for (u4 i = 0; i < chunkCount; i++) {
+        up.getU4(); // name id
+        up.getU4(); // offset
+    }
+    // Chunk offsets are relative to the first byte after the header, which is where the reader now
+    // stands; the target is a MethodDef written at a Pickler boundary, so decoding can start there.
+    up.seek(up.position() + offset);
+    return SerializerImpl::unpickleExpr(up, gs, fileId);
+}
+
+vector<u1> Serializer::storeFileHash(const FileHash &hash) {
+    serialize::Pickler p;
+    auto putMap = [&p](const UnorderedMap<NameHash, u4> &map) {
+        p.putU4(map.size());
+        for (const auto &entry : map) {
+            p.putU4(entry.first._hashValue);
+            p.putU4(entry.second);
+        }
+    };
+    auto putVec = [&p](const vector<NameHash> &vec) {
+        p.putU4(vec.size());
+        for (const auto &nameHash : vec) {
+            p.putU4(nameHash._hashValue);
+        }
+    };
+    p.putU4(hash.definitions.hierarchyHash);
+    putMap(hash.definitions.methodHashes);
+    putMap(hash.definitions.methodShapeHashes);
+    putMap(hash.definitions.defHashes);
+    putVec(hash.usages.sends);
+    putVec(hash.usages.constants);
+    putMap(hash.methodBodyHashes);
+    // Tiny and read back on the latency-sensitive LSP startup path; not worth compressing.
+    return p.result(Pickler::UNCOMPRESSED);
+}
+
+FileHash Serializer::loadFileHash(const u1 *const data, spdlog::logger &tracer) {
+    serialize::UnPickler p(data, tracer);
+    FileHash result;
+    auto getMap = [&p](UnorderedMap<NameHash, u4> &map) {
+        u4 size = p.getU4();
+        map.reserve(size);
+        for (u4 i = 0; i < size; i++) {
+            auto key = p.getU4();
+            map[NameHash::fromRaw(key)] = p.getU4();
+        }
+    };
+    auto getVec = [&p](vector<NameHash> &vec) {
+        u4 size = p.getU4();
+        vec.reserve(size);
+        for (u4 i = 0; i < size; i++) {
+            vec.emplace_back(NameHash::fromRaw(p.getU4()));
+        }
+    };
+    result.definitions.hierarchyHash = p.getU4();
+    getMap(result.definitions.methodHashes);
+    getMap(result.definitions.methodShapeHashes);
+    getMap(result.definitions.defHashes);
+    getVec(result.usages.sends);
+    getVec(result.usages.constants);
+    getMap(result.methodBodyHashes);
+    return result;
+}
+
 NameRef SerializerImpl::unpickleNameRef(UnPickler &p, GlobalState &gs) {
     NameRef name(NameRef::WellKnown{}, p.getU4());
     ENFORCE(name.data(gs)->ref(gs) == name);
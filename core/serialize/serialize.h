@@ -1,16 +1,20 @@
 #ifndef SORBET_SERIALIZE_H
 #define SORBET_SERIALIZE_H
 #include "ast/ast.h"
+#include "core/NameHash.h"
 #include "core/core.h"
 
 namespace sorbet::core::serialize {
 class Serializer {
 public:
-    static const u4 VERSION = 4;
+    static const u4 VERSION = 7;
     static const u1 GLOBAL_STATE_COMPRESSION_DEGREE =
         10; // >20 introduce decompression slowdown, >10 introduces compression slowdown
-    static const u1 FILE_COMPRESSION_DEGREE =
-        10; // >20 introduce decompression slowdown, >10 introduces compression slowdown
+    // Cached trees are written once and read back on later runs, so on-disk size (and with it CI
+    // cache upload/download time) matters more than compression speed. Levels 40+ add Huffman
+    // entropy coding on top of LIZv1, which roughly halves the size of the highly repetitive
+    // pickle format; decompression stays cheap relative to parsing the file again.
+    static const u1 FILE_COMPRESSION_DEGREE = 41;
 
     // Serialize a global state
     static std::vector<u1> store(GlobalState &gs);
@@ -20,12 +24,51 @@ public:
     // a global state containing a name table along side a large number of
     // individual cached files, which can be loaded independently.
     static std::vector<u1> storePayloadAndNameTable(GlobalState &gs);
-    static std::vector<u1> storeExpression(GlobalState &gs, std::unique_ptr<ast::Expression> &e);
+
+    // Layered payloads: storeDelta captures how `gs` differs from `base` — appended names, plus
+    // new or changed files and symbols — as a small blob that loadGlobalStateWithDelta applies on
+    // top of the base image. `gs` must have been built by loading `base` and entering things on
+    // top of it: names are assumed to be append-only, and the diff is keyed by table index. A
+    // one-line stdlib tweak then ships as a few records instead of a full payload rebuild.
+    static std::vector<u1> storeDelta(GlobalState &gs, const GlobalState &base);
+    static void loadGlobalStateWithDelta(GlobalState &gs, const u1 *const baseData, const u1 *const deltaData);
+
+    // Takes the tree by reference so callers can pickle trees they only hold a raw pointer to
+    // (e.g. from a background serializer thread); the tree is not modified.
+    //
+    // The stream is chunked: the header carries a per-method-definition offset table, and every
+    // MethodDef subtree starts at a clean Pickler boundary, so a single definition can be
+    // deserialized through loadExpressionChunk without rebuilding the rest of the file's tree.
+    static std::vector<u1> storeExpression(GlobalState &gs, ast::Expression &e);
 
     // Loads an ast::Expression saved by storeExpression. Optionally overrides
     // the saved file ID to the caller-specified ID.
     static std::unique_ptr<ast::Expression> loadExpression(GlobalState &gs, const u1 *const p, u4 forceId = 0);
-    static void loadGlobalState(GlobalState &gs, const u1 *const data);
+
+    // One entry in the offset table written by storeExpression, in stream order (a depth-first
+    // walk of the tree, so nested defs follow their enclosing method's entry).
+    struct ExpressionChunk {
+        u4 nameId; // raw NameRef id of the method's name at pickling time
+        u4 offset; // opaque token identifying the MethodDef subtree, for loadExpressionChunk
+    };
+    static std::vector<ExpressionChunk> loadExpressionChunkTable(const u1 *const p, spdlog::logger &tracer);
+
+    // Deserializes the single MethodDef at `offset` (from loadExpressionChunkTable). Each call
+    // decompresses the blob, so callers that want most of a file should loadExpression instead;
+    // this is for rehydrating one definition's body on demand.
+    static std::unique_ptr<ast::Expression> loadExpressionChunk(GlobalState &gs, const u1 *const p, u4 offset,
+                                                                u4 forceId = 0);
+
+    // File hashes are pure functions of the file's content, so they cache alongside the trees and
+    // let an LSP restart skip re-running the per-file hashing pipeline for unchanged files.
+    static std::vector<u1> storeFileHash(const FileHash &hash);
+    static FileHash loadFileHash(const u1 *const data, spdlog::logger &tracer);
+
+    // With lazySymbols, symbol records are not deserialized up front: they fault in on first
+    // access through SymbolRef::data, so stdlib corners a run never touches are never decoded.
+    // Only safe when `data` outlives the GlobalState (it is meant for the compiled-in payload);
+    // compressed inputs fall back to eager loading.
+    static void loadGlobalState(GlobalState &gs, const u1 *const data, bool lazySymbols = false);
 };
 }; // namespace sorbet::core::serialize
 
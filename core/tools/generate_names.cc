@@ -310,6 +310,7 @@ NameDef names[] = {
     {"first"},
     {"min"},
     {"max"},
+    {"fetch"},
 
     // Enumerable#flat_map has special-case logic in Infer
     {"flatMap", "flat_map"},
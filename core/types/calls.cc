@@ -26,8 +26,39 @@ TypePtr ProxyType::getCallArguments(Context ctx, NameRef name) {
     return underlying()->getCallArguments(ctx, name);
 }
 
+namespace {
+// Budget for one top-level dispatch through a union receiver. Each OrType node spends one unit, so
+// ordinary unions (tens of components) are unaffected, while pathological nested unions -- which
+// otherwise produce an exponential dispatch tree -- get cut off and degrade to untyped instead of
+// taking seconds per call site. Thread-local because files are typechecked in parallel.
+constexpr int UNION_DISPATCH_BUDGET = 256;
+thread_local int unionDispatchDepth = 0;
+thread_local int unionDispatchBudgetLeft = 0;
+
+struct UnionDispatchFrame {
+    UnionDispatchFrame() {
+        if (unionDispatchDepth == 0) {
+            unionDispatchBudgetLeft = UNION_DISPATCH_BUDGET;
+        }
+        unionDispatchDepth++;
+    }
+    ~UnionDispatchFrame() {
+        unionDispatchDepth--;
+    }
+};
+} // namespace
+
 DispatchResult OrType::dispatchCall(Context ctx, DispatchArgs args) {
     categoryCounterInc("dispatch_call", "ortype");
+    UnionDispatchFrame frame;
+    if (unionDispatchBudgetLeft <= 0) {
+        // Budget exhausted: give up on this component and let untyped absorb the rest of the union.
+        // The lub with untyped makes the whole call site untyped, which is our usual degradation for
+        // work we decline to do.
+        prodCounterInc("dispatch_call.union_budget_exhausted");
+        return DispatchResult(Types::untypedUntracked(), args.selfType, Symbols::noSymbol());
+    }
+    unionDispatchBudgetLeft--;
     auto leftRet = left->dispatchCall(ctx, args.withSelfRef(left));
     auto rightRet = right->dispatchCall(ctx, args.withSelfRef(right));
     DispatchResult ret{Types::any(ctx, leftRet.returnType, rightRet.returnType), move(leftRet.main),
@@ -139,9 +170,14 @@ bool isSetter(Context ctx, NameRef fun) {
     return false;
 }
 
+// `argOrigins` names the TypeAndOrigins whose origins describe where `argType` came from: for a
+// positional argument that is the argument itself, for a keyword argument pulled out of a hash it
+// is the hash argument. Taking the two separately lets keyword dispatch skip copying origin
+// vectors on the success path, where origins are never read.
 unique_ptr<Error> matchArgType(Context ctx, TypeConstraint &constr, Loc callLoc, Loc receiverLoc, SymbolRef inClass,
-                               SymbolRef method, const TypeAndOrigins &argTpe, const ArgInfo &argSym,
-                               const TypePtr &selfType, vector<TypePtr> &targs, Loc loc, bool mayBeSetter = false) {
+                               SymbolRef method, const TypePtr &argType, const TypeAndOrigins &argOrigins,
+                               const ArgInfo &argSym, const TypePtr &selfType, vector<TypePtr> &targs, Loc loc,
+                               bool mayBeSetter = false) {
     TypePtr expectedType = Types::resultTypeAsSeenFrom(ctx, argSym.type, method.data(ctx)->owner, inClass, targs);
     if (!expectedType) {
         expectedType = Types::untyped(ctx, method);
@@ -149,7 +185,7 @@ unique_ptr<Error> matchArgType(Context ctx, TypeConstraint &constr, Loc callLoc,
 
     expectedType = Types::replaceSelfType(ctx, expectedType, selfType);
 
-    if (Types::isSubTypeUnderConstraint(ctx, constr, argTpe.type, expectedType)) {
+    if (Types::isSubTypeUnderConstraint(ctx, constr, argType, expectedType)) {
         return nullptr;
     }
     if (auto e = ctx.state.beginError(callLoc, errors::Infer::MethodArgumentMismatch)) {
@@ -158,15 +194,15 @@ unique_ptr<Error> matchArgType(Context ctx, TypeConstraint &constr, Loc callLoc,
                         expectedType->show(ctx));
         } else {
             e.setHeader("Expected `{}` but found `{}` for argument `{}`", expectedType->show(ctx),
-                        argTpe.type->show(ctx), argSym.argumentName(ctx));
+                        argType->show(ctx), argSym.argumentName(ctx));
             e.addErrorSection(ErrorSection({
                 ErrorLine::from(argSym.loc, "Method `{}` has specified `{}` as `{}`", method.data(ctx)->show(ctx),
                                 argSym.argumentName(ctx), expectedType->show(ctx)),
             }));
         }
         e.addErrorSection(
-            ErrorSection("Got " + argTpe.type->show(ctx) + " originating from:", argTpe.origins2Explanations(ctx)));
-        auto withoutNil = Types::approximateSubtract(ctx, argTpe.type, Types::nilClass());
+            ErrorSection("Got " + argType->show(ctx) + " originating from:", argOrigins.origins2Explanations(ctx)));
+        auto withoutNil = Types::approximateSubtract(ctx, argType, Types::nilClass());
         if (!withoutNil->isBottom() && Types::isSubTypeUnderConstraint(ctx, constr, withoutNil, expectedType)) {
             if (loc.exists()) {
                 e.replaceWith("Wrap in `T.must`", loc, "T.must({})", loc.source(ctx));
@@ -571,7 +607,7 @@ DispatchResult dispatchCallSymbol(Context ctx, DispatchArgs args,
     unique_ptr<TypeConstraint> &maybeConstraint = result.main.constr;
     TypeConstraint *constr;
     if (args.block || data->isGenericMethod()) {
-        maybeConstraint = make_unique<TypeConstraint>();
+        maybeConstraint = TypeConstraint::make();
         constr = maybeConstraint.get();
     } else {
         constr = &TypeConstraint::EmptyFrozenConstraint;
@@ -607,8 +643,8 @@ DispatchResult dispatchCallSymbol(Context ctx, DispatchArgs args,
         }
 
         auto offset = ait - args.args.begin();
-        if (auto e = matchArgType(ctx, *constr, args.locs.call, args.locs.receiver, symbol, method, *arg, spec,
-                                  args.selfType, targs, args.locs.args[offset], args.args.size() == 1)) {
+        if (auto e = matchArgType(ctx, *constr, args.locs.call, args.locs.receiver, symbol, method, arg->type, *arg,
+                                  spec, args.selfType, targs, args.locs.args[offset], args.args.size() == 1)) {
             result.main.errors.emplace_back(std::move(e));
         }
 
@@ -682,12 +718,10 @@ DispatchResult dispatchCallSymbol(Context ctx, DispatchArgs args,
                         }
                         consumed.insert(arg);
 
-                        TypeAndOrigins tpe;
-                        tpe.origins = args.args.back()->origins;
                         auto offset = it - hash->keys.begin();
-                        tpe.type = hash->values[offset];
-                        if (auto e = matchArgType(ctx, *constr, args.locs.call, args.locs.receiver, symbol, method, tpe,
-                                                  spec, args.selfType, targs, Loc::none())) {
+                        if (auto e = matchArgType(ctx, *constr, args.locs.call, args.locs.receiver, symbol, method,
+                                                  hash->values[offset], *args.args.back(), spec, args.selfType, targs,
+                                                  Loc::none())) {
                             result.main.errors.emplace_back(std::move(e));
                         }
                     }
@@ -709,12 +743,10 @@ DispatchResult dispatchCallSymbol(Context ctx, DispatchArgs args,
                     continue;
                 }
                 consumed.insert(spec.name);
-                TypeAndOrigins tpe;
-                tpe.origins = args.args.back()->origins;
                 auto offset = arg - hash->keys.begin();
-                tpe.type = hash->values[offset];
-                if (auto e = matchArgType(ctx, *constr, args.locs.call, args.locs.receiver, symbol, method, tpe, spec,
-                                          args.selfType, targs, Loc::none())) {
+                if (auto e = matchArgType(ctx, *constr, args.locs.call, args.locs.receiver, symbol, method,
+                                          hash->values[offset], *args.args.back(), spec, args.selfType, targs,
+                                          Loc::none())) {
                     result.main.errors.emplace_back(std::move(e));
                 }
             }
@@ -797,15 +829,50 @@ DispatchResult dispatchCallSymbol(Context ctx, DispatchArgs args,
         const auto &bspec = data->arguments().back();
         ENFORCE(bspec.flags.isBlock, "The last symbol must be the block arg: {}", data->show(ctx));
 
-        TypePtr blockType = Types::resultTypeAsSeenFrom(ctx, bspec.type, data->owner, symbol, targs);
-        if (!blockType) {
-            blockType = Types::untyped(ctx, method);
+        // When the constraint is empty the block types are fully determined by the signature, so
+        // they can be replayed from the link when this send is re-dispatched (per union component,
+        // or per fixpoint iteration over a loop body).
+        auto &link = *args.block;
+        bool sigDetermined = constr->isEmpty();
+        bool replayed = false;
+        if (sigDetermined && link.cachedBlockReceiver == symbol && link.cachedBlockMethod == method &&
+            link.cachedBlockGlobalStateId == ctx.state.globalStateId &&
+            link.cachedBlockTargs.size() == targs.size()) {
+            replayed = true;
+            for (size_t i = 0; i < targs.size(); i++) {
+                if (link.cachedBlockTargs[i].get() != targs[i].get()) {
+                    replayed = false;
+                    break;
+                }
+            }
         }
+        if (replayed) {
+            counterInc("dispatch_call.block_types.replayed");
+            component.blockReturnType = link.cachedBlockReturnType;
+            component.blockPreType = link.cachedBlockPreType;
+        } else {
+            TypePtr blockType = Types::resultTypeAsSeenFrom(ctx, bspec.type, data->owner, symbol, targs);
+            if (!blockType) {
+                blockType = Types::untyped(ctx, method);
+            }
 
-        component.blockReturnType = Types::getProcReturnType(ctx, blockType);
-        blockType = constr->isSolved() ? Types::instantiate(ctx, blockType, *constr)
-                                       : Types::approximate(ctx, blockType, *constr);
-        component.blockPreType = blockType;
+            component.blockReturnType = Types::getProcReturnType(ctx, blockType);
+            blockType = constr->isSolved() ? Types::instantiate(ctx, blockType, *constr)
+                                           : Types::approximate(ctx, blockType, *constr);
+            component.blockPreType = blockType;
+            if (sigDetermined) {
+                link.cachedBlockReceiver = symbol;
+                link.cachedBlockMethod = method;
+                link.cachedBlockGlobalStateId = ctx.state.globalStateId;
+                link.cachedBlockTargs.clear();
+                for (auto &targ : targs) {
+                    // Storing the targs pins them, so a recycled address can never alias this key.
+                    link.cachedBlockTargs.emplace_back(targ);
+                }
+                link.cachedBlockPreType = component.blockPreType;
+                link.cachedBlockReturnType = component.blockReturnType;
+            }
+        }
         component.blockSpec = bspec.deepCopy();
     }
 
@@ -867,10 +934,98 @@ DispatchResult dispatchCallSymbol(Context ctx, DispatchArgs args,
     return result;
 }
 
+namespace {
+
+// Thread-local memoization of blockless ClassType dispatches.
+//
+// Inference resolves the same sends over and over — `Array#each`, `Hash#[]`, `Integer#+` — and each
+// resolution redoes member lookup, argument matching and return-type resolution from scratch. A
+// dispatch to a ClassType receiver is fully determined by (receiver symbol, method name, self type,
+// argument types), plus the file's strict level because that decides whether suppressed errors would
+// have been reported. Only results with no errors, no block, no type constraint and no secondary
+// component are stored, so a hit can be replayed as a plain (returnType, method) pair with no
+// observable difference. Entries pin the self and argument TypePtrs they are keyed on, so recycled
+// addresses can never alias a key.
+constexpr size_t DISPATCH_CACHE_SIZE = 8192;
+static_assert((DISPATCH_CACHE_SIZE & (DISPATCH_CACHE_SIZE - 1)) == 0, "must be a power of two");
+constexpr size_t DISPATCH_CACHE_MAX_ARGS = 4;
+
+struct DispatchCacheEntry {
+    SymbolRef receiver;
+    NameRef fun;
+    TypePtr selfType;
+    InlinedVector<TypePtr, DISPATCH_CACHE_MAX_ARGS> argTypes;
+    StrictLevel strictLevel = StrictLevel::None;
+    int globalStateId = -1;
+    SymbolRef method;
+    TypePtr returnType;
+};
+thread_local vector<DispatchCacheEntry> dispatchCache;
+
+size_t dispatchCacheSlot(SymbolRef receiver, NameRef fun, const DispatchArgs &args) {
+    uintptr_t h = receiver._id;
+    h = h * 31u + fun.id();
+    h = h * 31u + (reinterpret_cast<uintptr_t>(args.selfType.get()) >> 4);
+    for (auto *arg : args.args) {
+        h = h * 31u + (reinterpret_cast<uintptr_t>(arg->type.get()) >> 4);
+    }
+    h ^= h >> 16;
+    return h & (DISPATCH_CACHE_SIZE - 1);
+}
+
+bool dispatchCacheEntryMatches(const DispatchCacheEntry &entry, SymbolRef receiver, NameRef fun,
+                               const DispatchArgs &args, StrictLevel strictLevel, int globalStateId) {
+    if (entry.receiver != receiver || entry.fun != fun || entry.selfType.get() != args.selfType.get() ||
+        entry.strictLevel != strictLevel || entry.globalStateId != globalStateId ||
+        entry.argTypes.size() != args.args.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < entry.argTypes.size(); i++) {
+        if (entry.argTypes[i].get() != args.args[i]->type.get()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
 DispatchResult ClassType::dispatchCall(Context ctx, DispatchArgs args) {
     categoryCounterInc("dispatch_call", "classtype");
     vector<TypePtr> empty;
-    return dispatchCallSymbol(ctx, args, this, symbol, empty);
+    bool cacheable = args.block == nullptr && args.args.size() <= DISPATCH_CACHE_MAX_ARGS &&
+                     args.locs.call.file().exists() && symbol != Symbols::untyped() && symbol != Symbols::void_();
+    if (!cacheable) {
+        return dispatchCallSymbol(ctx, args, this, symbol, empty);
+    }
+
+    auto strictLevel = args.locs.call.file().data(ctx).strictLevel;
+    if (dispatchCache.empty()) {
+        dispatchCache.resize(DISPATCH_CACHE_SIZE);
+    }
+    auto &entry = dispatchCache[dispatchCacheSlot(symbol, args.name, args)];
+    if (dispatchCacheEntryMatches(entry, symbol, args.name, args, strictLevel, ctx.state.globalStateId)) {
+        counterInc("dispatch_call.cache.hit");
+        return DispatchResult(entry.returnType, args.selfType, entry.method);
+    }
+    counterInc("dispatch_call.cache.miss");
+
+    auto result = dispatchCallSymbol(ctx, args, this, symbol, empty);
+    if (result.secondary == nullptr && result.main.errors.empty() && result.main.constr == nullptr &&
+        result.main.blockReturnType == nullptr && result.main.blockPreType == nullptr) {
+        entry.receiver = symbol;
+        entry.fun = args.name;
+        entry.selfType = args.selfType;
+        entry.argTypes.clear();
+        for (auto *arg : args.args) {
+            entry.argTypes.emplace_back(arg->type);
+        }
+        entry.strictLevel = strictLevel;
+        entry.globalStateId = ctx.state.globalStateId;
+        entry.method = result.main.method;
+        entry.returnType = result.returnType;
+    }
+    return result;
 }
 
 DispatchResult AppliedType::dispatchCall(Context ctx, DispatchArgs args) {
@@ -1065,7 +1220,7 @@ public:
         SymbolRef self = unwrapSymbol(thisType);
         auto singleton = self.data(ctx)->lookupSingletonClass(ctx);
         if (singleton.exists()) {
-            res.returnType = make_type<ClassType>(singleton);
+            res.returnType = Types::classType(singleton);
         } else {
             res.returnType = Types::classClass();
         }
@@ -1198,7 +1353,7 @@ public:
             }
         }
 
-        res.returnType = make_type<MetaType>(make_type<AppliedType>(attachedClass, move(targs)));
+        res.returnType = make_type<MetaType>(AppliedType::make_shared(attachedClass, move(targs)));
     }
 } T_Generic_squareBrackets;
 
@@ -1577,7 +1732,7 @@ public:
             Magic_callWithBlock::typeToProc(ctx, args.args[2]->type, args.locs.call, args.locs.args[2]);
         std::optional<int> blockArity = Magic_callWithBlock::getArityForBlock(finalBlockType);
         auto link = make_shared<core::SendAndBlockLink>(fn, Magic_callWithBlock::argInfoByArity(blockArity));
-        res.main.constr = make_unique<TypeConstraint>();
+        res.main.constr = TypeConstraint::make();
 
         DispatchArgs innerArgs{fn, sendLocs, sendArgs, receiver->type, receiver->type, link};
 
@@ -1642,7 +1797,7 @@ public:
             Magic_callWithBlock::typeToProc(ctx, args.args[3]->type, args.locs.call, args.locs.args[3]);
         std::optional<int> blockArity = Magic_callWithBlock::getArityForBlock(finalBlockType);
         auto link = make_shared<core::SendAndBlockLink>(fn, Magic_callWithBlock::argInfoByArity(blockArity));
-        res.main.constr = make_unique<TypeConstraint>();
+        res.main.constr = TypeConstraint::make();
 
         DispatchArgs innerArgs{fn, sendLocs, sendArgs, receiver->type, receiver->type, link};
 
@@ -1726,6 +1881,30 @@ public:
     }
 } Tuple_squareBrackets;
 
+class Tuple_fetch : public IntrinsicMethod {
+public:
+    void apply(Context ctx, DispatchArgs args, const Type *thisType, DispatchResult &res) const override {
+        auto *tuple = cast_type<TupleType>(thisType);
+        ENFORCE(tuple);
+        LiteralType *lit = nullptr;
+        if (args.args.size() == 1 && args.block == nullptr) {
+            lit = cast_type<LiteralType>(args.args.front()->type.get());
+        }
+        if (!lit || !lit->underlying()->derivesFrom(ctx, Symbols::Integer())) {
+            return;
+        }
+
+        auto idx = lit->value;
+        if (idx < 0) {
+            idx = tuple->elems.size() + idx;
+        }
+        if (idx >= 0 && idx < tuple->elems.size()) {
+            res.returnType = tuple->elems[idx];
+        }
+        // An out-of-range index raises at runtime; fall through to the normal Array#fetch signature.
+    }
+} Tuple_fetch;
+
 class Tuple_last : public IntrinsicMethod {
 public:
     void apply(Context ctx, DispatchArgs args, const Type *thisType, DispatchResult &res) const override {
@@ -1834,6 +2013,51 @@ public:
     }
 } Shape_merge;
 
+class Shape_squareBrackets : public IntrinsicMethod {
+public:
+    void apply(Context ctx, DispatchArgs args, const Type *thisType, DispatchResult &res) const override {
+        auto *shape = cast_type<ShapeType>(thisType);
+        ENFORCE(shape);
+        LiteralType *lit = nullptr;
+        if (args.args.size() == 1) {
+            lit = cast_type<LiteralType>(args.args.front()->type.get());
+        }
+        if (!lit) {
+            return;
+        }
+
+        auto fnd = absl::c_find_if(shape->keys,
+                                   [&lit](auto &key) { return lit->equals(*cast_type<LiteralType>(key.get())); });
+        if (fnd == shape->keys.end()) {
+            res.returnType = Types::nilClass();
+        } else {
+            res.returnType = shape->values[fnd - shape->keys.begin()];
+        }
+    }
+} Shape_squareBrackets;
+
+class Shape_fetch : public IntrinsicMethod {
+public:
+    void apply(Context ctx, DispatchArgs args, const Type *thisType, DispatchResult &res) const override {
+        auto *shape = cast_type<ShapeType>(thisType);
+        ENFORCE(shape);
+        LiteralType *lit = nullptr;
+        if (args.args.size() == 1 && args.block == nullptr) {
+            lit = cast_type<LiteralType>(args.args.front()->type.get());
+        }
+        if (!lit) {
+            return;
+        }
+
+        auto fnd = absl::c_find_if(shape->keys,
+                                   [&lit](auto &key) { return lit->equals(*cast_type<LiteralType>(key.get())); });
+        if (fnd != shape->keys.end()) {
+            res.returnType = shape->values[fnd - shape->keys.begin()];
+        }
+        // A missing key raises at runtime; fall through to the normal Hash#fetch signature.
+    }
+} Shape_fetch;
+
 class Array_flatten : public IntrinsicMethod {
     // Flattens a (nested) array all way down to its (inner) element type, stopping if we hit the depth limit first.
     static TypePtr recursivelyFlattenArrays(Context ctx, const TypePtr &type, const int64_t depth) {
@@ -1956,7 +2180,7 @@ class enumerable_to_h : public IntrinsicMethod {
 public:
     // Forward Enumerable.to_h to RubyType.enumerable_to_h[self]
     void apply(Context ctx, DispatchArgs args, const Type *thisType, DispatchResult &res) const override {
-        auto hash = make_type<ClassType>(core::Symbols::Sorbet_Private_Static().data(ctx)->lookupSingletonClass(ctx));
+        auto hash = Types::classType(core::Symbols::Sorbet_Private_Static().data(ctx)->lookupSingletonClass(ctx));
         InlinedVector<Loc, 2> argLocs{args.locs.receiver};
         CallLocs locs{
             args.locs.call,
@@ -2051,6 +2275,7 @@ const vector<Intrinsic> intrinsicMethods{
     {Symbols::DeclBuilderForProcsSingleton(), Intrinsic::Kind::Instance, Names::bind(), &DeclBuilderForProcs_bind},
 
     {Symbols::Tuple(), Intrinsic::Kind::Instance, Names::squareBrackets(), &Tuple_squareBrackets},
+    {Symbols::Tuple(), Intrinsic::Kind::Instance, Names::fetch(), &Tuple_fetch},
     {Symbols::Tuple(), Intrinsic::Kind::Instance, Names::first(), &Tuple_first},
     {Symbols::Tuple(), Intrinsic::Kind::Instance, Names::last(), &Tuple_last},
     {Symbols::Tuple(), Intrinsic::Kind::Instance, Names::min(), &Tuple_minMax},
@@ -2059,6 +2284,8 @@ const vector<Intrinsic> intrinsicMethods{
     {Symbols::Tuple(), Intrinsic::Kind::Instance, Names::concat(), &Tuple_concat},
 
     {Symbols::Shape(), Intrinsic::Kind::Instance, Names::merge(), &Shape_merge},
+    {Symbols::Shape(), Intrinsic::Kind::Instance, Names::squareBrackets(), &Shape_squareBrackets},
+    {Symbols::Shape(), Intrinsic::Kind::Instance, Names::fetch(), &Shape_fetch},
 
     {Symbols::Array(), Intrinsic::Kind::Instance, Names::flatten(), &Array_flatten},
     {Symbols::Array(), Intrinsic::Kind::Instance, Names::compact(), &Array_compact},
@@ -18,6 +18,37 @@ string buildTabs(int count) {
     return res;
 }
 
+// Error-heavy runs render the same types hundreds of times (the same union printed by every call
+// site that trips over it). Leaf renderings are memoized per thread, keyed by the type's address;
+// each entry holds a strong TypePtr so a recycled allocation can never alias a stale key, and the
+// entry cap bounds both the memory and how long that reference extends a type's lifetime.
+constexpr size_t SHOW_CACHE_MAX_ENTRIES = 4096;
+
+struct ShowCacheEntry {
+    TypePtr key;
+    string rendered;
+};
+thread_local UnorderedMap<const Type *, ShowCacheEntry> showCache;
+thread_local int showCacheGlobalStateId = -1;
+
+const string &cachedShow(const GlobalState &gs, const TypePtr &ty) {
+    if (showCacheGlobalStateId != gs.globalStateId) {
+        showCache.clear();
+        showCacheGlobalStateId = gs.globalStateId;
+    }
+    auto it = showCache.find(ty.get());
+    if (it != showCache.end()) {
+        return it->second.rendered;
+    }
+    if (showCache.size() >= SHOW_CACHE_MAX_ENTRIES) {
+        showCache.clear();
+    }
+    auto &entry = showCache[ty.get()];
+    entry.key = ty;
+    entry.rendered = ty->show(gs);
+    return entry.rendered;
+}
+
 } // namespace
 
 string ClassType::toStringWithTabs(const GlobalState &gs, int tabs) const {
@@ -187,92 +218,62 @@ struct OrInfo {
     }
 
     OrInfo() {}
-
-    static OrInfo nilInfo() {
-        OrInfo res;
-        res.containsNil = true;
-        return res;
-    }
-
-    static OrInfo trueInfo() {
-        OrInfo res;
-        res.containsTrue = true;
-        return res;
-    }
-
-    static OrInfo falseInfo() {
-        OrInfo res;
-        res.containsFalse = true;
-        return res;
-    }
-
-    static OrInfo otherInfo() {
-        OrInfo res;
-        res.containsOther = true;
-        return res;
-    }
-
-    static OrInfo merge(const OrInfo &left, const OrInfo &right) {
-        OrInfo res;
-        res.containsNil = left.containsNil || right.containsNil;
-        res.containsFalse = left.containsFalse || right.containsFalse;
-        res.containsTrue = left.containsTrue || right.containsTrue;
-        res.containsOther = left.containsOther || right.containsOther;
-        res.containsMultiple = left.containsMultiple || right.containsMultiple;
-        return res;
-    }
 };
 
-pair<OrInfo, optional<string>> showOrs(const GlobalState &, TypePtr, TypePtr);
+void showOrs(const GlobalState &gs, const TypePtr &left, const TypePtr &right, OrInfo &info, vector<string> &parts);
 
-pair<OrInfo, optional<string>> showOrElem(const GlobalState &gs, TypePtr ty) {
+// Appends the rendering of one flattened union member to `parts` (NilClass contributes no part;
+// it resurfaces as T.nilable). Collecting parts and joining once keeps a wide union linear, where
+// pairwise concatenation up the OrType tree used to recopy the accumulated string at every level.
+void showOrElem(const GlobalState &gs, const TypePtr &ty, OrInfo &info, vector<string> &parts) {
     if (auto classType = cast_type<ClassType>(ty.get())) {
         if (classType->symbol == Symbols::NilClass()) {
-            return make_pair(OrInfo::nilInfo(), nullopt);
+            info.containsNil = true;
+            return;
         } else if (classType->symbol == Symbols::TrueClass()) {
-            return make_pair(OrInfo::trueInfo(), make_optional(classType->show(gs)));
+            info.containsTrue = true;
+            parts.emplace_back(classType->show(gs));
+            return;
         } else if (classType->symbol == Symbols::FalseClass()) {
-            return make_pair(OrInfo::falseInfo(), make_optional(classType->show(gs)));
+            info.containsFalse = true;
+            parts.emplace_back(classType->show(gs));
+            return;
         }
     } else if (auto orType = cast_type<OrType>(ty.get())) {
-        return showOrs(gs, orType->left, orType->right);
+        showOrs(gs, orType->left, orType->right, info, parts);
+        return;
     }
 
-    return make_pair(OrInfo::otherInfo(), make_optional(ty->show(gs)));
+    info.containsOther = true;
+    parts.emplace_back(cachedShow(gs, ty));
 }
 
-pair<OrInfo, optional<string>> showOrs(const GlobalState &gs, TypePtr left, TypePtr right) {
-    auto [leftInfo, leftStr] = showOrElem(gs, left);
-    auto [rightInfo, rightStr] = showOrElem(gs, right);
-
-    OrInfo merged = OrInfo::merge(leftInfo, rightInfo);
-
-    if (leftStr.has_value() && rightStr.has_value()) {
-        merged.markContainsMultiple();
-        return make_pair(merged, make_optional(fmt::format("{}, {}", *leftStr, *rightStr)));
-    } else if (leftStr.has_value()) {
-        return make_pair(merged, leftStr);
-    } else {
-        return make_pair(merged, rightStr);
-    }
+void showOrs(const GlobalState &gs, const TypePtr &left, const TypePtr &right, OrInfo &info, vector<string> &parts) {
+    showOrElem(gs, left, info, parts);
+    showOrElem(gs, right, info, parts);
 }
 
 string OrType::show(const GlobalState &gs) const {
-    auto [info, str] = showOrs(gs, this->left, this->right);
+    OrInfo info;
+    vector<string> parts;
+    showOrs(gs, this->left, this->right, info, parts);
 
-    // If str is empty at this point, all of the types present in the flattened
+    // If no part was collected, all of the types present in the flattened
     // OrType are NilClass.
-    if (!str.has_value()) {
+    if (parts.empty()) {
         return Symbols::NilClass().show(gs);
     }
+    if (parts.size() > 1) {
+        info.markContainsMultiple();
+    }
 
     string res;
     if (info.isBoolean()) {
         res = "T::Boolean";
     } else if (info.containsMultiple) {
-        res = fmt::format("T.any({})", *str);
+        res = fmt::format("T.any({})", fmt::join(parts, ", "));
     } else {
-        res = *str;
+        res = parts.front();
     }
 
     if (info.containsNil) {
@@ -44,9 +44,38 @@ const TypePtr underlying(const TypePtr &t1) {
     return t1;
 }
 
+// Or trees are built as left spines, so lubbing the same component in repeatedly (the common shape
+// for block-merge lubs) would otherwise recurse through the whole spine every time. A pointer-equality
+// scan catches that case before any recursion or allocation.
+bool orSpineContains(const TypePtr &tree, const TypePtr &elem) {
+    auto *o = cast_type<OrType>(tree.get());
+    while (o != nullptr) {
+        if (o->right.get() == elem.get() || o->left.get() == elem.get()) {
+            return true;
+        }
+        o = cast_type<OrType>(o->left.get());
+    }
+    return false;
+}
+
+bool andSpineContains(const TypePtr &tree, const TypePtr &elem) {
+    auto *a = cast_type<AndType>(tree.get());
+    while (a != nullptr) {
+        if (a->right.get() == elem.get() || a->left.get() == elem.get()) {
+            return true;
+        }
+        a = cast_type<AndType>(a->left.get());
+    }
+    return false;
+}
+
 TypePtr lubDistributeOr(Context ctx, const TypePtr &t1, const TypePtr &t2) {
     auto *o1 = cast_type<OrType>(t1.get());
     ENFORCE(o1 != nullptr);
+    if (orSpineContains(t1, t2)) {
+        categoryCounterInc("lubDistributeOr.outcome", "spineDup");
+        return t1;
+    }
     TypePtr n1 = Types::any(ctx, o1->left, t2);
     if (n1.get() == o1->left.get()) {
         categoryCounterInc("lubDistributeOr.outcome", "t1");
@@ -79,6 +108,10 @@ TypePtr lubDistributeOr(Context ctx, const TypePtr &t1, const TypePtr &t2) {
 TypePtr glbDistributeAnd(Context ctx, const TypePtr &t1, const TypePtr &t2) {
     auto *a1 = cast_type<AndType>(t1.get());
     ENFORCE(t1 != nullptr);
+    if (andSpineContains(t1, t2)) {
+        categoryCounterInc("glbDistributeAnd.outcome", "spineDup");
+        return t1;
+    }
     TypePtr n1 = Types::all(ctx, a1->left, t2);
     if (n1.get() == a1->left.get()) {
         categoryCounterInc("lubDistributeOr.outcome", "t1");
@@ -244,7 +277,7 @@ TypePtr Types::lub(Context ctx, const TypePtr &t1, const TypePtr &t2) {
             j++;
         }
         if (changed) {
-            return make_type<AppliedType>(a2->klass, newTargs);
+            return AppliedType::make_shared(a2->klass, move(newTargs));
         } else {
             return t2s;
         }
@@ -854,7 +887,7 @@ TypePtr Types::glb(Context ctx, const TypePtr &t1, const TypePtr &t2) {
         } else if (absl::c_equal(a2->targs, newTargs) && a1->klass == a2->klass) {
             return ltr ? t1 : t2;
         } else {
-            return make_type<AppliedType>(a1->klass, newTargs);
+            return AppliedType::make_shared(a1->klass, move(newTargs));
         }
     }
     {
@@ -1150,10 +1183,35 @@ bool isSubTypeUnderConstraintSingle(Context ctx, TypeConstraint &constr, const T
     }
 }
 
-bool Types::isSubTypeUnderConstraint(Context ctx, TypeConstraint &constr, const TypePtr &t1, const TypePtr &t2) {
-    if (t1.get() == t2.get()) {
-        return true;
-    }
+namespace {
+
+// A direct-mapped, thread-local cache of ground subtyping queries.
+//
+// The same (lhs, rhs) pairs recur millions of times per run as different call sites dispatch into
+// the same generic stdlib methods. Results are only cacheable when the constraint is empty: under a
+// non-empty constraint a query can both read and record bounds. Entries hold owning TypePtr copies
+// so a cached pointer can never be confused with a recycled allocation, and they remember which
+// GlobalState answered the query so sibling GlobalStates (e.g. in LSP) cannot see each other's
+// results.
+struct SubtypeQueryCacheEntry {
+    TypePtr lhs;
+    TypePtr rhs;
+    int globalStateId = -1;
+    bool result = false;
+};
+
+constexpr size_t SUBTYPE_QUERY_CACHE_SIZE = 8192;
+static_assert((SUBTYPE_QUERY_CACHE_SIZE & (SUBTYPE_QUERY_CACHE_SIZE - 1)) == 0, "must be a power of two");
+thread_local vector<SubtypeQueryCacheEntry> subtypeQueryCache;
+
+size_t subtypeQueryCacheSlot(const Type *t1, const Type *t2) {
+    auto h = reinterpret_cast<uintptr_t>(t1) >> 4;
+    h = h * 31u + (reinterpret_cast<uintptr_t>(t2) >> 4);
+    h ^= h >> 16;
+    return h & (SUBTYPE_QUERY_CACHE_SIZE - 1);
+}
+
+bool isSubTypeUnderConstraintImpl(Context ctx, TypeConstraint &constr, const TypePtr &t1, const TypePtr &t2) {
 
     // pairs to cover: 1  (_, _)
     //                 2  (_, And)
@@ -1213,17 +1271,61 @@ bool Types::isSubTypeUnderConstraint(Context ctx, TypeConstraint &constr, const
 
     // This order matters
     if (o2 != nullptr) { // 3
-        return Types::isSubTypeUnderConstraint(ctx, constr, t1, o2->left) ||
-               Types::isSubTypeUnderConstraint(ctx, constr, t1, o2->right);
+        // This is a speculative probe: when the left alternative fails, the bounds it recorded
+        // along the way must not leak into the attempt on the right alternative.
+        if (constr.isSolved()) {
+            return Types::isSubTypeUnderConstraint(ctx, constr, t1, o2->left) ||
+                   Types::isSubTypeUnderConstraint(ctx, constr, t1, o2->right);
+        }
+        auto saved = constr.snapshot();
+        if (Types::isSubTypeUnderConstraint(ctx, constr, t1, o2->left)) {
+            return true;
+        }
+        constr.rollback(move(saved));
+        return Types::isSubTypeUnderConstraint(ctx, constr, t1, o2->right);
     }
     if (a1 != nullptr) { // 4
-        return Types::isSubTypeUnderConstraint(ctx, constr, a1->left, t2) ||
-               Types::isSubTypeUnderConstraint(ctx, constr, a1->right, t2);
+        if (constr.isSolved()) {
+            return Types::isSubTypeUnderConstraint(ctx, constr, a1->left, t2) ||
+                   Types::isSubTypeUnderConstraint(ctx, constr, a1->right, t2);
+        }
+        auto saved = constr.snapshot();
+        if (Types::isSubTypeUnderConstraint(ctx, constr, a1->left, t2)) {
+            return true;
+        }
+        constr.rollback(move(saved));
+        return Types::isSubTypeUnderConstraint(ctx, constr, a1->right, t2);
     }
 
     return isSubTypeUnderConstraintSingle(ctx, constr, t1, t2); // 1
 }
 
+} // namespace
+
+bool Types::isSubTypeUnderConstraint(Context ctx, TypeConstraint &constr, const TypePtr &t1, const TypePtr &t2) {
+    if (t1.get() == t2.get()) {
+        return true;
+    }
+    if (!constr.isEmpty()) {
+        return isSubTypeUnderConstraintImpl(ctx, constr, t1, t2);
+    }
+    if (subtypeQueryCache.empty()) {
+        subtypeQueryCache.resize(SUBTYPE_QUERY_CACHE_SIZE);
+    }
+    auto &entry = subtypeQueryCache[subtypeQueryCacheSlot(t1.get(), t2.get())];
+    if (entry.lhs.get() == t1.get() && entry.rhs.get() == t2.get() && entry.globalStateId == ctx.state.globalStateId) {
+        counterInc("types.subtype_cache.hit");
+        return entry.result;
+    }
+    counterInc("types.subtype_cache.miss");
+    auto result = isSubTypeUnderConstraintImpl(ctx, constr, t1, t2);
+    entry.lhs = t1;
+    entry.rhs = t2;
+    entry.globalStateId = ctx.state.globalStateId;
+    entry.result = result;
+    return result;
+}
+
 bool Types::equiv(Context ctx, const TypePtr &t1, const TypePtr &t2) {
     return isSubType(ctx, t1, t2) && isSubType(ctx, t2, t1);
 }
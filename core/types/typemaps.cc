@@ -346,7 +346,7 @@ TypePtr AppliedType::_instantiate(Context ctx, const InlinedVector<SymbolRef, 4>
             newTargs[i] = this->targs[i];
             i++;
         }
-        return make_type<AppliedType>(this->klass, newTargs);
+        return AppliedType::make_shared(this->klass, move(newTargs));
     }
 
     return nullptr;
@@ -375,7 +375,7 @@ TypePtr AppliedType::_instantiate(Context ctx, const TypeConstraint &tc) {
             newTargs[i] = this->targs[i];
             i++;
         }
-        return make_type<AppliedType>(this->klass, newTargs);
+        return AppliedType::make_shared(this->klass, move(newTargs));
     }
 
     return nullptr;
@@ -404,7 +404,7 @@ TypePtr AppliedType::_approximate(Context ctx, const TypeConstraint &tc) {
             newTargs[i] = this->targs[i];
             i++;
         }
-        return make_type<AppliedType>(this->klass, newTargs);
+        return AppliedType::make_shared(this->klass, move(newTargs));
     }
 
     return nullptr;
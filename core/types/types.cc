@@ -251,13 +251,13 @@ TypePtr Types::lubAll(Context ctx, vector<TypePtr> &elements) {
 
 TypePtr Types::arrayOf(Context ctx, const TypePtr &elem) {
     vector<TypePtr> targs{move(elem)};
-    return make_type<AppliedType>(Symbols::Array(), targs);
+    return AppliedType::make_shared(Symbols::Array(), move(targs));
 }
 
 TypePtr Types::hashOf(Context ctx, const TypePtr &elem) {
     vector<TypePtr> tupleArgs{Types::Symbol(), elem};
     vector<TypePtr> targs{Types::Symbol(), elem, TupleType::build(ctx, tupleArgs)};
-    return make_type<AppliedType>(Symbols::Hash(), targs);
+    return AppliedType::make_shared(Symbols::Hash(), move(targs));
 }
 
 std::optional<int> Types::getProcArity(const AppliedType &type) {
@@ -717,17 +717,146 @@ bool OrType::hasUntyped() {
     return left->hasUntyped() || right->hasUntyped();
 }
 
+namespace {
+
+// Thread-local hash-consing of composite types.
+//
+// lub/glb and sig resolution rebuild the same OrType/AndType shapes over and over (think
+// `T.nilable` around a handful of stdlib classes), so identical composites used to be allocated
+// fresh each time and equality degraded to deep structural comparison. A small direct-mapped table
+// per kind canonicalizes composites with identical children at construction: repeated shapes come
+// back as the same TypePtr, which makes pointer equality (and the pointer-keyed subtype cache)
+// effective and trims resident memory on files with big unions. The cached composite itself pins
+// its children alive, so the child pointers used as keys can never be recycled aliases.
+constexpr size_t GROUND_TYPE_INTERN_SIZE = 4096;
+static_assert((GROUND_TYPE_INTERN_SIZE & (GROUND_TYPE_INTERN_SIZE - 1)) == 0, "must be a power of two");
+thread_local vector<TypePtr> orTypeInternCache;
+thread_local vector<TypePtr> andTypeInternCache;
+thread_local vector<TypePtr> classTypeInternCache;
+thread_local vector<TypePtr> symbolLiteralInternCache;
+thread_local vector<TypePtr> stringLiteralInternCache;
+thread_local vector<TypePtr> appliedTypeInternCache;
+
+// Symbol and string literal types are the keys of every shape; a large literal hash repeats the
+// same handful of names in each file that builds one, and desugar used to allocate a fresh
+// LiteralType per occurrence. Like ClassType, a LiteralType stores only the raw name id, so a
+// cached instance is valid for any GlobalState that assigns the same id; a stale slot misses and
+// is replaced.
+TypePtr cachedNameLiteral(vector<TypePtr> &cache, SymbolRef klass, NameRef name, ConstExprStr counter) {
+    if (cache.empty()) {
+        cache.resize(GROUND_TYPE_INTERN_SIZE);
+    }
+    auto &entry = cache[static_cast<u4>(name.id()) & (GROUND_TYPE_INTERN_SIZE - 1)];
+    if (entry != nullptr && cast_type<LiteralType>(entry.get())->value == name.id()) {
+        counterInc(counter);
+        return entry;
+    }
+    entry = make_type<LiteralType>(klass, name);
+    return entry;
+}
+
+size_t groundTypeInternSlot(const Type *left, const Type *right) {
+    auto h = reinterpret_cast<uintptr_t>(left) >> 4;
+    h = h * 31u + (reinterpret_cast<uintptr_t>(right) >> 4);
+    h ^= h >> 16;
+    return h & (GROUND_TYPE_INTERN_SIZE - 1);
+}
+
+size_t appliedTypeInternSlot(SymbolRef klass, const vector<TypePtr> &targs) {
+    uintptr_t h = klass._id;
+    for (auto &targ : targs) {
+        h = h * 31u + (reinterpret_cast<uintptr_t>(targ.get()) >> 4);
+    }
+    h ^= h >> 16;
+    return h & (GROUND_TYPE_INTERN_SIZE - 1);
+}
+
+} // namespace
+
 TypePtr OrType::make_shared(const TypePtr &left, const TypePtr &right) {
+    if (orTypeInternCache.empty()) {
+        orTypeInternCache.resize(GROUND_TYPE_INTERN_SIZE);
+    }
+    auto &entry = orTypeInternCache[groundTypeInternSlot(left.get(), right.get())];
+    if (entry != nullptr) {
+        auto *cached = cast_type<OrType>(entry.get());
+        if (cached->left.get() == left.get() && cached->right.get() == right.get()) {
+            counterInc("types.intern.or.hit");
+            return entry;
+        }
+    }
     TypePtr res(new OrType(left, right));
+    entry = res;
     return res;
 }
 
+TypePtr Types::classType(SymbolRef symbol) {
+    if (classTypeInternCache.empty()) {
+        classTypeInternCache.resize(GROUND_TYPE_INTERN_SIZE);
+    }
+    // ClassType carries nothing but the symbol id, so a cached instance is valid for any GlobalState
+    // that assigns the same id; a stale slot for a different symbol simply misses and is replaced.
+    auto &entry = classTypeInternCache[symbol._id & (GROUND_TYPE_INTERN_SIZE - 1)];
+    if (entry != nullptr && cast_type<ClassType>(entry.get())->symbol == symbol) {
+        counterInc("types.intern.class.hit");
+        return entry;
+    }
+    entry = make_type<ClassType>(symbol);
+    return entry;
+}
+
+TypePtr Types::symbolLiteral(NameRef name) {
+    return cachedNameLiteral(symbolLiteralInternCache, Symbols::Symbol(), name, "types.intern.symbol_literal.hit");
+}
+
+TypePtr Types::stringLiteral(NameRef name) {
+    return cachedNameLiteral(stringLiteralInternCache, Symbols::String(), name, "types.intern.string_literal.hit");
+}
+
 bool AndType::hasUntyped() {
     return left->hasUntyped() || right->hasUntyped();
 }
 
 TypePtr AndType::make_shared(const TypePtr &left, const TypePtr &right) {
+    if (andTypeInternCache.empty()) {
+        andTypeInternCache.resize(GROUND_TYPE_INTERN_SIZE);
+    }
+    auto &entry = andTypeInternCache[groundTypeInternSlot(left.get(), right.get())];
+    if (entry != nullptr) {
+        auto *cached = cast_type<AndType>(entry.get());
+        if (cached->left.get() == left.get() && cached->right.get() == right.get()) {
+            counterInc("types.intern.and.hit");
+            return entry;
+        }
+    }
     TypePtr res(new AndType(left, right));
+    entry = res;
+    return res;
+}
+
+TypePtr AppliedType::make_shared(SymbolRef klass, vector<TypePtr> targs) {
+    if (appliedTypeInternCache.empty()) {
+        appliedTypeInternCache.resize(GROUND_TYPE_INTERN_SIZE);
+    }
+    auto &entry = appliedTypeInternCache[appliedTypeInternSlot(klass, targs)];
+    if (entry != nullptr) {
+        auto *cached = cast_type<AppliedType>(entry.get());
+        if (cached->klass == klass && cached->targs.size() == targs.size()) {
+            bool sameTargs = true;
+            for (size_t i = 0; i < targs.size(); i++) {
+                if (cached->targs[i].get() != targs[i].get()) {
+                    sameTargs = false;
+                    break;
+                }
+            }
+            if (sameTargs) {
+                counterInc("types.intern.applied.hit");
+                return entry;
+            }
+        }
+    }
+    auto res = make_type<AppliedType>(klass, move(targs));
+    entry = res;
     return res;
 }
 
@@ -826,7 +955,7 @@ TypePtr Types::widen(Context ctx, const TypePtr &type) {
             for (const auto &t : appliedType->targs) {
                 newTargs.emplace_back(widen(ctx, t));
             }
-            ret = make_type<AppliedType>(appliedType->klass, newTargs);
+            ret = AppliedType::make_shared(appliedType->klass, move(newTargs));
         },
         [&](Type *tp) { ret = type; });
     ENFORCE(ret);
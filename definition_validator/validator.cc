@@ -465,45 +465,67 @@ void validateSealed(const core::GlobalState &gs, const core::SymbolRef klass,
     validateSealedAncestorHelper(gs, singleton, classDef, klass, "extended");
 }
 
-class ValidateWalk {
-private:
-    UnorderedMap<core::SymbolRef, vector<core::SymbolRef>> abstractCache;
+namespace {
+
+// Memoized per-class tables of inherited abstract methods. A class's table depends only on the
+// (frozen) symbol table, not on which file mentions the class, so it is shared across every file
+// validated on this thread rather than rebuilt per file: deep hierarchies reopened in many files
+// otherwise recompute the same ancestor tables once per file. Entries remember which GlobalState
+// filled them (and its symbol count, which the incremental path can grow) so results never leak
+// between different symbol tables.
+struct AbstractMethodsCache {
+    int globalStateId = -1;
+    unsigned int symbolsUsed = 0;
+    UnorderedMap<core::SymbolRef, vector<core::SymbolRef>> methods;
+};
+thread_local AbstractMethodsCache abstractMethodsCache;
 
-    const vector<core::SymbolRef> &getAbstractMethods(const core::GlobalState &gs, core::SymbolRef klass) {
-        vector<core::SymbolRef> abstract;
-        auto ent = abstractCache.find(klass);
-        if (ent != abstractCache.end()) {
-            return ent->second;
-        }
+const vector<core::SymbolRef> &getAbstractMethods(const core::GlobalState &gs, core::SymbolRef klass) {
+    auto &cache = abstractMethodsCache;
+    if (cache.globalStateId != gs.globalStateId || cache.symbolsUsed != gs.symbolsUsed()) {
+        cache.methods.clear();
+        cache.globalStateId = gs.globalStateId;
+        cache.symbolsUsed = gs.symbolsUsed();
+    }
 
-        auto superclass = klass.data(gs)->superClass();
-        if (superclass.exists()) {
-            auto &superclassMethods = getAbstractMethods(gs, superclass);
-            // TODO(nelhage): This code could go quadratic or even exponential given
-            // pathological arrangements of interfaces and abstract methods. Switch
-            // to a better data structure if that is ever a problem.
-            abstract.insert(abstract.end(), superclassMethods.begin(), superclassMethods.end());
-        }
+    vector<core::SymbolRef> abstract;
+    auto ent = cache.methods.find(klass);
+    if (ent != cache.methods.end()) {
+        return ent->second;
+    }
 
-        for (auto ancst : klass.data(gs)->mixins()) {
-            auto fromMixin = getAbstractMethods(gs, ancst);
-            abstract.insert(abstract.end(), fromMixin.begin(), fromMixin.end());
-        }
+    auto superclass = klass.data(gs)->superClass();
+    if (superclass.exists()) {
+        auto &superclassMethods = getAbstractMethods(gs, superclass);
+        // TODO(nelhage): This code could go quadratic or even exponential given
+        // pathological arrangements of interfaces and abstract methods. Switch
+        // to a better data structure if that is ever a problem.
+        abstract.insert(abstract.end(), superclassMethods.begin(), superclassMethods.end());
+    }
 
-        auto isAbstract = klass.data(gs)->isClassAbstract();
-        if (isAbstract) {
-            for (auto [name, sym] : klass.data(gs)->members()) {
-                if (sym.exists() && sym.data(gs)->isMethod() && sym.data(gs)->isAbstract()) {
-                    abstract.emplace_back(sym);
-                }
+    for (auto ancst : klass.data(gs)->mixins()) {
+        auto fromMixin = getAbstractMethods(gs, ancst);
+        abstract.insert(abstract.end(), fromMixin.begin(), fromMixin.end());
+    }
+
+    auto isAbstract = klass.data(gs)->isClassAbstract();
+    if (isAbstract) {
+        for (auto [name, sym] : klass.data(gs)->members()) {
+            if (sym.exists() && sym.data(gs)->isMethod() && sym.data(gs)->isAbstract()) {
+                abstract.emplace_back(sym);
             }
         }
-
-        auto &entry = abstractCache[klass];
-        entry = std::move(abstract);
-        return entry;
     }
 
+    auto &entry = cache.methods[klass];
+    entry = std::move(abstract);
+    return entry;
+}
+
+} // namespace
+
+class ValidateWalk {
+private:
     // if/when we get final classes, we can just mark subclasses of `T::Struct` as final and essentially subsume the
     // logic here.
     void validateTStructNotGrandparent(const core::GlobalState &gs, core::SymbolRef sym) {
@@ -90,7 +90,8 @@ vector<unique_ptr<ast::Expression>> DSLBuilder::replaceDSL(core::MutableContext
             arg = make_unique<ast::OptionalArg>(loc, move(arg), move(default_));
         }
         stats.emplace_back(ast::MK::Method1(loc, loc, name, move(arg), ast::MK::EmptyTree(),
-                                            ast::MethodDef::SelfMethod | ast::MethodDef::DSLSynthesized));
+                                            ast::MethodDef::SelfMethod | ast::MethodDef::DSLSynthesized |
+                                                ast::MethodDef::DSLSynthesizedTemplate));
     }
 
     if (!skipGetter) {
@@ -103,12 +104,14 @@ vector<unique_ptr<ast::Expression>> DSLBuilder::replaceDSL(core::MutableContext
         stats.emplace_back(ast::MK::Sig0(loc, ASTUtil::dupType(type.get())));
         stats.emplace_back(ast::MK::Method(loc, loc, getName, ast::MethodDef::ARGS_store(),
                                            ast::MK::Unsafe(loc, ast::MK::Nil(loc)),
-                                           ast::MethodDef::SelfMethod | ast::MethodDef::DSLSynthesized));
+                                           ast::MethodDef::SelfMethod | ast::MethodDef::DSLSynthesized |
+                                               ast::MethodDef::DSLSynthesizedTemplate));
 
         // def <prop>()
         stats.emplace_back(ast::MK::Sig0(loc, ASTUtil::dupType(type.get())));
         stats.emplace_back(ast::MK::Method(loc, loc, name, ast::MethodDef::ARGS_store(),
-                                           ast::MK::Unsafe(loc, ast::MK::Nil(loc)), ast::MethodDef::DSLSynthesized));
+                                           ast::MK::Unsafe(loc, ast::MK::Nil(loc)),
+                                           ast::MethodDef::DSLSynthesized | ast::MethodDef::DSLSynthesizedTemplate));
     }
 
     return stats;
@@ -69,10 +69,12 @@ vector<unique_ptr<ast::Expression>> MixinEncryptedProp::replaceDSL(core::Mutable
     // Compute the getters
 
     stats.emplace_back(ast::MK::Sig(loc, ast::MK::Hash0(loc), mkNilableString(loc)));
-    stats.emplace_back(mkGet(loc, name, ast::MK::Cast(loc, mkNilableString(loc))));
+    stats.emplace_back(
+        mkGet(loc, name, ast::MK::Cast(loc, mkNilableString(loc)), ast::MethodDef::DSLSynthesizedTemplate));
 
     stats.emplace_back(ast::MK::Sig(loc, ast::MK::Hash0(loc), mkNilableEncryptedValue(ctx, loc)));
-    stats.emplace_back(mkGet(loc, enc_name, ast::MK::Cast(loc, mkNilableEncryptedValue(ctx, loc))));
+    stats.emplace_back(mkGet(loc, enc_name, ast::MK::Cast(loc, mkNilableEncryptedValue(ctx, loc)),
+                             ast::MethodDef::DSLSynthesizedTemplate));
     core::NameRef setName = name.addEq(ctx);
     core::NameRef setEncName = enc_name.addEq(ctx);
 
@@ -81,12 +83,14 @@ vector<unique_ptr<ast::Expression>> MixinEncryptedProp::replaceDSL(core::Mutable
         stats.emplace_back(
             ast::MK::Sig(loc, ast::MK::Hash1(loc, ast::MK::Symbol(nameLoc, core::Names::arg0()), mkNilableString(loc)),
                          mkNilableString(loc)));
-        stats.emplace_back(mkSet(loc, setName, nameLoc, ast::MK::Cast(loc, mkNilableString(loc))));
+        stats.emplace_back(mkSet(loc, setName, nameLoc, ast::MK::Cast(loc, mkNilableString(loc)),
+                                 ast::MethodDef::DSLSynthesizedTemplate));
 
         stats.emplace_back(ast::MK::Sig(
             loc, ast::MK::Hash1(loc, ast::MK::Symbol(nameLoc, core::Names::arg0()), mkNilableEncryptedValue(ctx, loc)),
             mkNilableEncryptedValue(ctx, loc)));
-        stats.emplace_back(mkSet(loc, setEncName, nameLoc, ast::MK::Cast(loc, mkNilableEncryptedValue(ctx, loc))));
+        stats.emplace_back(mkSet(loc, setEncName, nameLoc, ast::MK::Cast(loc, mkNilableEncryptedValue(ctx, loc)),
+                                 ast::MethodDef::DSLSynthesizedTemplate));
     }
 
     // Compute the Mutator
@@ -96,12 +100,14 @@ vector<unique_ptr<ast::Expression>> MixinEncryptedProp::replaceDSL(core::Mutable
         rhs.emplace_back(
             ast::MK::Sig(loc, ast::MK::Hash1(nameLoc, ast::MK::Symbol(loc, core::Names::arg0()), mkNilableString(loc)),
                          mkNilableString(loc)));
-        rhs.emplace_back(mkSet(loc, setName, nameLoc, ast::MK::Cast(loc, mkNilableString(loc))));
+        rhs.emplace_back(mkSet(loc, setName, nameLoc, ast::MK::Cast(loc, mkNilableString(loc)),
+                               ast::MethodDef::DSLSynthesizedTemplate));
 
         rhs.emplace_back(ast::MK::Sig(
             loc, ast::MK::Hash1(loc, ast::MK::Symbol(nameLoc, core::Names::arg0()), mkNilableEncryptedValue(ctx, loc)),
             mkNilableEncryptedValue(ctx, loc)));
-        rhs.emplace_back(mkSet(loc, setEncName, nameLoc, ast::MK::Cast(loc, mkNilableEncryptedValue(ctx, loc))));
+        rhs.emplace_back(mkSet(loc, setEncName, nameLoc, ast::MK::Cast(loc, mkNilableEncryptedValue(ctx, loc)),
+                               ast::MethodDef::DSLSynthesizedTemplate));
     }
 
     return stats;
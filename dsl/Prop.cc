@@ -241,7 +241,8 @@ optional<NodesAndPropInfo> processProp(core::MutableContext ctx, ast::Send *send
                                                      ASTUtil::dupType(getType.get()));
         ret.nodes.emplace_back(mkGet(loc, name, std::move(assertTypeMatches)));
     } else {
-        ret.nodes.emplace_back(mkGet(loc, name, ast::MK::Cast(loc, std::move(getType))));
+        ret.nodes.emplace_back(
+            mkGet(loc, name, ast::MK::Cast(loc, std::move(getType)), ast::MethodDef::DSLSynthesizedTemplate));
     }
 
     core::NameRef setName = name.addEq(ctx);
@@ -252,7 +253,8 @@ optional<NodesAndPropInfo> processProp(core::MutableContext ctx, ast::Send *send
         ret.nodes.emplace_back(ast::MK::Sig(
             loc, ast::MK::Hash1(loc, ast::MK::Symbol(nameLoc, core::Names::arg0()), ASTUtil::dupType(setType.get())),
             ASTUtil::dupType(setType.get())));
-        ret.nodes.emplace_back(mkSet(loc, setName, nameLoc, ast::MK::Cast(loc, std::move(setType))));
+        ret.nodes.emplace_back(mkSet(loc, setName, nameLoc, ast::MK::Cast(loc, std::move(setType)),
+                                     ast::MethodDef::DSLSynthesizedTemplate));
     }
 
     // Compute the `_` foreign accessor
@@ -280,9 +282,9 @@ optional<NodesAndPropInfo> processProp(core::MutableContext ctx, ast::Send *send
 
         unique_ptr<ast::Expression> arg =
             ast::MK::RestArg(nameLoc, ast::MK::KeywordArg(nameLoc, ast::MK::Local(nameLoc, core::Names::opts())));
-        ret.nodes.emplace_back(ast::MK::Method1(loc, loc, fk_method, std::move(arg),
-                                                ast::MK::Unsafe(loc, ast::MK::Nil(loc)),
-                                                ast::MethodDef::DSLSynthesized));
+        ret.nodes.emplace_back(
+            ast::MK::Method1(loc, loc, fk_method, std::move(arg), ast::MK::Unsafe(loc, ast::MK::Nil(loc)),
+                             ast::MethodDef::DSLSynthesized | ast::MethodDef::DSLSynthesizedTemplate));
 
         // sig {params(opts: T.untyped).returns($foreign)}
         ret.nodes.emplace_back(ast::MK::Sig1(loc, ast::MK::Symbol(nameLoc, core::Names::opts()), ast::MK::Untyped(loc),
@@ -295,9 +297,9 @@ optional<NodesAndPropInfo> processProp(core::MutableContext ctx, ast::Send *send
         auto fk_method_bang = ctx.state.enterNameUTF8(name.data(ctx)->show(ctx) + "_!");
         unique_ptr<ast::Expression> arg2 =
             ast::MK::RestArg(nameLoc, ast::MK::KeywordArg(nameLoc, ast::MK::Local(nameLoc, core::Names::opts())));
-        ret.nodes.emplace_back(ast::MK::Method1(loc, loc, fk_method_bang, std::move(arg2),
-                                                ast::MK::Unsafe(loc, ast::MK::Nil(loc)),
-                                                ast::MethodDef::DSLSynthesized));
+        ret.nodes.emplace_back(
+            ast::MK::Method1(loc, loc, fk_method_bang, std::move(arg2), ast::MK::Unsafe(loc, ast::MK::Nil(loc)),
+                             ast::MethodDef::DSLSynthesized | ast::MethodDef::DSLSynthesizedTemplate));
     }
 
     // Compute the Mutator
@@ -308,7 +310,8 @@ optional<NodesAndPropInfo> processProp(core::MutableContext ctx, ast::Send *send
         rhs.emplace_back(ast::MK::Sig(
             loc, ast::MK::Hash1(loc, ast::MK::Symbol(nameLoc, core::Names::arg0()), ASTUtil::dupType(setType.get())),
             ASTUtil::dupType(setType.get())));
-        rhs.emplace_back(mkSet(loc, setName, nameLoc, ast::MK::Cast(loc, std::move(setType))));
+        rhs.emplace_back(mkSet(loc, setName, nameLoc, ast::MK::Cast(loc, std::move(setType)),
+                               ast::MethodDef::DSLSynthesizedTemplate));
 
         // Maybe make a getter
         unique_ptr<ast::Expression> mutator;
@@ -339,7 +342,8 @@ optional<NodesAndPropInfo> processProp(core::MutableContext ctx, ast::Send *send
 
         if (mutator.get()) {
             rhs.emplace_back(ast::MK::Sig0(loc, ASTUtil::dupType(mutator.get())));
-            rhs.emplace_back(mkGet(loc, name, ast::MK::Cast(loc, std::move(mutator))));
+            rhs.emplace_back(
+                mkGet(loc, name, ast::MK::Cast(loc, std::move(mutator)), ast::MethodDef::DSLSynthesizedTemplate));
 
             ast::ClassDef::ANCESTORS_store ancestors;
             auto name = core::Names::Constants::Mutator();
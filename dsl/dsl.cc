@@ -2,6 +2,7 @@
 #include "ast/treemap/treemap.h"
 #include "ast/verifier/verifier.h"
 #include "common/typecase.h"
+#include "core/Names.h"
 #include "dsl/ClassNew.h"
 #include "dsl/Command.h"
 #include "dsl/DSLBuilder.h"
@@ -69,48 +70,53 @@ public:
                         }
                     }
 
-                    nodes = MixinEncryptedProp::replaceDSL(ctx, send);
-                    if (!nodes.empty()) {
-                        replaceNodes[stat.get()] = std::move(nodes);
-                        return;
-                    }
-
-                    nodes = Minitest::replaceDSL(ctx, send);
-                    if (!nodes.empty()) {
-                        replaceNodes[stat.get()] = move(nodes);
-                        return;
-                    }
-
-                    nodes = DSLBuilder::replaceDSL(ctx, send);
-                    if (!nodes.empty()) {
-                        replaceNodes[stat.get()] = std::move(nodes);
-                        return;
-                    }
-
-                    nodes = Private::replaceDSL(ctx, send);
-                    if (!nodes.empty()) {
-                        replaceNodes[stat.get()] = std::move(nodes);
-                        return;
-                    }
-
-                    nodes = Delegate::replaceDSL(ctx, send);
-                    if (!nodes.empty()) {
-                        replaceNodes[stat.get()] = std::move(nodes);
-                        return;
-                    }
-
-                    // This one is different: it gets an extra prevStat argument.
-                    nodes = AttrReader::replaceDSL(ctx, send, prevStat);
-                    if (!nodes.empty()) {
-                        replaceNodes[stat.get()] = std::move(nodes);
-                        return;
+                    // Classify the send by method name once and hand it to the one rewriter that
+                    // could match, rather than letting every rewriter re-inspect the same node.
+                    // The name sets below are disjoint, so the routing preserves the old
+                    // try-each-in-order behavior. Well-known name ids are compile-time constants,
+                    // so this compiles down to a jump table.
+                    switch (send->fun._id) {
+                        case core::Names::encrypted_prop()._id:
+                            nodes = MixinEncryptedProp::replaceDSL(ctx, send);
+                            break;
+                        case core::Names::before()._id:
+                        case core::Names::describe()._id:
+                        case core::Names::it()._id:
+                            nodes = Minitest::replaceDSL(ctx, send);
+                            break;
+                        case core::Names::dslOptional()._id:
+                        case core::Names::dslRequired()._id:
+                            nodes = DSLBuilder::replaceDSL(ctx, send);
+                            break;
+                        case core::Names::private_()._id:
+                        case core::Names::privateClassMethod()._id:
+                            nodes = Private::replaceDSL(ctx, send);
+                            break;
+                        case core::Names::delegate()._id:
+                            nodes = Delegate::replaceDSL(ctx, send);
+                            break;
+                        case core::Names::attr()._id:
+                        case core::Names::attrReader()._id:
+                        case core::Names::attrWriter()._id:
+                        case core::Names::attrAccessor()._id:
+                            // This one is different: it gets an extra prevStat argument.
+                            nodes = AttrReader::replaceDSL(ctx, send, prevStat);
+                            break;
+                        case core::Names::mattrReader()._id:
+                        case core::Names::mattrWriter()._id:
+                        case core::Names::mattrAccessor()._id:
+                        case core::Names::cattrReader()._id:
+                        case core::Names::cattrWriter()._id:
+                        case core::Names::cattrAccessor()._id:
+                        case core::Names::classAttribute()._id:
+                            // This one is also a little different: it gets the ClassDef kind
+                            nodes = Mattr::replaceDSL(ctx, send, classDef->kind);
+                            break;
+                        default:
+                            return;
                     }
-
-                    // This one is also a little different: it gets the ClassDef kind
-                    nodes = Mattr::replaceDSL(ctx, send, classDef->kind);
                     if (!nodes.empty()) {
                         replaceNodes[stat.get()] = std::move(nodes);
-                        return;
                     }
                 },
 
@@ -9,14 +9,14 @@ using namespace std;
 
 namespace sorbet::dsl {
 
-unique_ptr<ast::Expression> mkGet(core::Loc loc, core::NameRef name, unique_ptr<ast::Expression> rhs) {
-    return ast::MK::Method0(loc, loc, name, move(rhs), ast::MethodDef::DSLSynthesized);
+unique_ptr<ast::Expression> mkGet(core::Loc loc, core::NameRef name, unique_ptr<ast::Expression> rhs, u4 extraFlags) {
+    return ast::MK::Method0(loc, loc, name, move(rhs), ast::MethodDef::DSLSynthesized | extraFlags);
 }
 
 unique_ptr<ast::Expression> mkSet(core::Loc loc, core::NameRef name, core::Loc argLoc,
-                                  unique_ptr<ast::Expression> rhs) {
+                                  unique_ptr<ast::Expression> rhs, u4 extraFlags) {
     return ast::MK::Method1(loc, loc, name, ast::MK::Local(argLoc, core::Names::arg0()), move(rhs),
-                            ast::MethodDef::DSLSynthesized);
+                            ast::MethodDef::DSLSynthesized | extraFlags);
 }
 
 unique_ptr<ast::Expression> mkNilable(core::Loc loc, unique_ptr<ast::Expression> type) {
@@ -8,10 +8,13 @@
 
 namespace sorbet::dsl {
 
-std::unique_ptr<ast::Expression> mkGet(core::Loc loc, core::NameRef name, std::unique_ptr<ast::Expression> rhs);
+// `extraFlags` is OR'd into the MethodDef flags on top of DSLSynthesized; pass
+// ast::MethodDef::DSLSynthesizedTemplate when (and only when) `rhs` contains no user-written trees.
+std::unique_ptr<ast::Expression> mkGet(core::Loc loc, core::NameRef name, std::unique_ptr<ast::Expression> rhs,
+                                       u4 extraFlags = 0);
 
 std::unique_ptr<ast::Expression> mkSet(core::Loc loc, core::NameRef name, core::Loc argLoc,
-                                       std::unique_ptr<ast::Expression> rhs);
+                                       std::unique_ptr<ast::Expression> rhs, u4 extraFlags = 0);
 
 std::unique_ptr<ast::Expression> mkNilable(core::Loc loc, std::unique_ptr<ast::Expression> type);
 
@@ -1,4 +1,5 @@
 #include "infer/SigSuggestion.h"
+#include "absl/synchronization/mutex.h"
 #include "common/common.h"
 #include "core/Loc.h"
 #include "core/TypeConstraint.h"
@@ -215,14 +216,14 @@ UnorderedMap<core::NameRef, core::TypePtr> guessArgumentTypes(core::Context ctx,
             }
             InlinedVector<core::NameRef, 1> newInsert;
 
-            if (auto load = cfg::cast_instruction<cfg::LoadArg>(bind.value.get())) {
+            if (auto load = cfg::cast_instruction<cfg::LoadArg>(bind.value)) {
                 newInsert.emplace_back(load->argument(ctx).name);
-            } else if (auto ident = cfg::cast_instruction<cfg::Ident>(bind.value.get())) {
+            } else if (auto ident = cfg::cast_instruction<cfg::Ident>(bind.value)) {
                 auto fnd = blockLocals.find(ident->what);
                 if (fnd != blockLocals.end()) {
                     newInsert.insert(newInsert.end(), fnd->second.begin(), fnd->second.end());
                 }
-            } else if (auto snd = cfg::cast_instruction<cfg::Send>(bind.value.get())) {
+            } else if (auto snd = cfg::cast_instruction<cfg::Send>(bind.value)) {
                 // see if we have at least a single call argument that is a method argument
                 bool shouldFindArgumentTypes = false;
                 for (auto &arg : snd->args) {
@@ -358,28 +359,34 @@ bool parentNeedsOverridable(core::Context ctx, core::SymbolRef childSymbol, core
 
 bool SigSuggestion::maybeSuggestSig(core::Context ctx, core::ErrorBuilder &e, unique_ptr<cfg::CFG> &cfg,
                                     const core::TypePtr &methodReturnType, core::TypeConstraint &constr) {
-    core::SymbolRef methodSymbol = cfg->symbol;
-
-    bool guessedSomethingUseful = false;
-    if (ctx.state.suggestRuntimeProfiledType) {
-        guessedSomethingUseful = true;
+    auto evidence = collectEvidence(ctx, cfg, methodReturnType, constr);
+    if (!evidence.has_value()) {
+        return false;
     }
+    return emitSuggestion(ctx, e, *evidence);
+}
+
+optional<SigSuggestion::SigEvidence> SigSuggestion::collectEvidence(core::Context ctx, unique_ptr<cfg::CFG> &cfg,
+                                                                    const core::TypePtr &methodReturnType,
+                                                                    core::TypeConstraint &constr) {
+    core::SymbolRef methodSymbol = cfg->symbol;
 
-    core::TypePtr guessedReturnType;
+    SigEvidence evidence;
+    evidence.method = methodSymbol;
     if (!constr.isEmpty()) {
         if (!constr.solve(ctx)) {
-            return false;
+            return nullopt;
         }
 
-        guessedReturnType = core::Types::widen(ctx, core::Types::instantiate(ctx, methodReturnType, constr));
+        evidence.returnType = core::Types::widen(ctx, core::Types::instantiate(ctx, methodReturnType, constr));
 
-        if (!guessedReturnType->isFullyDefined()) {
-            guessedReturnType = core::Types::untypedUntracked();
+        if (!evidence.returnType->isFullyDefined()) {
+            evidence.returnType = core::Types::untypedUntracked();
         }
 
-        guessedSomethingUseful = guessedSomethingUseful || !guessedReturnType->isUntyped();
+        evidence.returnTypeUseful = !evidence.returnType->isUntyped();
     } else {
-        guessedReturnType = methodReturnType;
+        evidence.returnType = methodReturnType;
     }
 
     auto isBadArg = [&](const core::ArgInfo &arg) -> bool {
@@ -392,10 +399,18 @@ bool SigSuggestion::maybeSuggestSig(core::Context ctx, core::ErrorBuilder &e, un
     };
     bool hasBadArg = absl::c_any_of(methodSymbol.data(ctx)->arguments(), isBadArg);
     if (hasBadArg) {
-        return false;
+        return nullopt;
     }
 
-    auto guessedArgumentTypes = guessArgumentTypes(ctx, methodSymbol, cfg);
+    evidence.argumentTypes = guessArgumentTypes(ctx, methodSymbol, cfg);
+    return evidence;
+}
+
+bool SigSuggestion::emitSuggestion(core::Context ctx, core::ErrorBuilder &e, const SigEvidence &evidence) {
+    core::SymbolRef methodSymbol = evidence.method;
+    bool guessedSomethingUseful = ctx.state.suggestRuntimeProfiledType || evidence.returnTypeUseful;
+    core::TypePtr guessedReturnType = evidence.returnType;
+    auto guessedArgumentTypes = evidence.argumentTypes;
 
     auto enclosingClass = methodSymbol.data(ctx)->enclosingClass(ctx);
     auto closestMethod = closestOverridenMethod(ctx, enclosingClass, methodSymbol.data(ctx)->name);
@@ -543,4 +558,26 @@ bool SigSuggestion::maybeSuggestSig(core::Context ctx, core::ErrorBuilder &e, un
     return true;
 }
 
+namespace {
+struct DeferredSigEvidence {
+    absl::Mutex mtx;
+    std::vector<SigSuggestion::SigEvidence> evidence;
+};
+// Shared across inference threads; contention is one lock per suggested method, which is noise
+// next to the inference that produced the evidence.
+DeferredSigEvidence deferredSigEvidence;
+} // namespace
+
+void SigSuggestion::recordEvidence(SigEvidence evidence) {
+    absl::MutexLock lock(&deferredSigEvidence.mtx);
+    deferredSigEvidence.evidence.emplace_back(move(evidence));
+}
+
+vector<SigSuggestion::SigEvidence> SigSuggestion::drainEvidence() {
+    absl::MutexLock lock(&deferredSigEvidence.mtx);
+    auto result = move(deferredSigEvidence.evidence);
+    deferredSigEvidence.evidence.clear();
+    return result;
+}
+
 } // namespace sorbet::infer
@@ -2,12 +2,43 @@
 #define SORBET_SIG_SUGGESTION_H
 
 #include "cfg/CFG.h"
+#include <optional>
 
 namespace sorbet::infer {
 class SigSuggestion final {
 public:
+    // The per-method facts a sig suggestion is computed from. collectEvidence distills these while
+    // the method's CFG and type constraint are still live; everything else a suggestion needs
+    // (ancestor sigs, source text, autocorrect assembly) is reachable from GlobalState, so
+    // emitSuggestion can run long after inference — in particular from a parallel post-pass when
+    // `GlobalState::deferSigSuggestions` is set.
+    struct SigEvidence {
+        core::SymbolRef method;
+        core::TypePtr returnType;
+        // Whether returnType came from a solved constraint and is not untyped. Tracked separately
+        // because an overriden method's sig may later replace returnType without making the
+        // original guess any more useful.
+        bool returnTypeUseful = false;
+        UnorderedMap<core::NameRef, core::TypePtr> argumentTypes;
+    };
+
     static bool maybeSuggestSig(core::Context ctx, core::ErrorBuilder &e, std::unique_ptr<cfg::CFG> &cfg,
                                 const core::TypePtr &methodReturnType, core::TypeConstraint &constr);
+
+    // The CFG-bound half of maybeSuggestSig: solves the return-type constraint and walks the CFG
+    // for argument type guesses. Returns nullopt when no suggestion should be made for this method.
+    static std::optional<SigEvidence> collectEvidence(core::Context ctx, std::unique_ptr<cfg::CFG> &cfg,
+                                                      const core::TypePtr &methodReturnType,
+                                                      core::TypeConstraint &constr);
+
+    // The formatting half: builds the sig text and attaches the autocorrect to `e`. Returns false
+    // when the suggestion was abandoned (e.g. the method has no `def` in the source).
+    static bool emitSuggestion(core::Context ctx, core::ErrorBuilder &e, const SigEvidence &evidence);
+
+    // Deferred-mode plumbing: inference threads record evidence here instead of formatting inline;
+    // pipeline::typecheck drains it once all files are done and emits the suggestions in parallel.
+    static void recordEvidence(SigEvidence evidence);
+    static std::vector<SigEvidence> drainEvidence();
 };
 } // namespace sorbet::infer
 
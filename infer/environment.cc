@@ -1,4 +1,6 @@
 #include "environment.h"
+#include "common/Counters.h"
+#include "common/MicroTimer.h"
 #include "common/typecase.h"
 #include "core/GlobalState.h"
 #include "core/TypeConstraint.h"
@@ -34,12 +36,12 @@ KnowledgeFilter::KnowledgeFilter(core::Context ctx, unique_ptr<cfg::CFG> &cfg) {
         changed = false;
         for (auto &bb : cfg->forwardsTopoSort) {
             for (auto &bind : bb->exprs) {
-                if (auto *id = cfg::cast_instruction<cfg::Ident>(bind.value.get())) {
+                if (auto *id = cfg::cast_instruction<cfg::Ident>(bind.value)) {
                     if (isNeeded(bind.bind.variable) && !isNeeded(id->what)) {
                         used_vars.insert(id->what);
                         changed = true;
                     }
-                } else if (auto *send = cfg::cast_instruction<cfg::Send>(bind.value.get())) {
+                } else if (auto *send = cfg::cast_instruction<cfg::Send>(bind.value)) {
                     if (send->fun == core::Names::bang()) {
                         if (send->args.empty()) {
                             if (isNeeded(bind.bind.variable) && !isNeeded(send->recv.variable)) {
@@ -183,6 +185,18 @@ string KnowledgeFact::toString(core::Context ctx) const {
     return fmt::format("{}{}", fmt::join(buf1, ""), fmt::join(buf2, ""));
 }
 
+namespace {
+// Almost every variable's knowledge is empty; sharing one immutable empty fact makes default
+// construction a refcount bump instead of two heap allocations per variable per environment.
+// `mutate` unshares before the first write, so the singleton itself is never modified.
+const shared_ptr<KnowledgeFact> &emptyKnowledgeFact() {
+    static const shared_ptr<KnowledgeFact> empty = make_shared<KnowledgeFact>();
+    return empty;
+}
+} // namespace
+
+KnowledgeRef::KnowledgeRef() : knowledge(emptyKnowledgeFact()) {}
+
 const KnowledgeFact &KnowledgeRef::operator*() const {
     return *knowledge.get();
 }
@@ -250,7 +264,7 @@ string Environment::toString(core::Context ctx) const {
 bool Environment::hasType(core::Context ctx, core::LocalVariable symbol) const {
     auto fnd = vars.find(symbol);
     if (fnd == vars.end()) {
-        return false;
+        return ephemeralTypes.find(symbol) != ephemeralTypes.end();
     }
     // We don't distinguish between nullptr and "not set"
     return fnd->second.typeAndOrigins.type.get() != nullptr;
@@ -259,6 +273,10 @@ bool Environment::hasType(core::Context ctx, core::LocalVariable symbol) const {
 const core::TypeAndOrigins &Environment::getTypeAndOrigin(core::Context ctx, core::LocalVariable symbol) const {
     auto fnd = vars.find(symbol);
     if (fnd == vars.end()) {
+        auto eph = ephemeralTypes.find(symbol);
+        if (eph != ephemeralTypes.end()) {
+            return eph->second;
+        }
         return uninitialized;
     }
     ENFORCE(fnd->second.typeAndOrigins.type.get() != nullptr);
@@ -283,6 +301,10 @@ bool Environment::getKnownTruthy(core::LocalVariable var) const {
 void Environment::propagateKnowledge(core::Context ctx, core::LocalVariable to, core::LocalVariable from,
                                      KnowledgeFilter &knowledgeFilter) {
     if (knowledgeFilter.isNeeded(to) && knowledgeFilter.isNeeded(from)) {
+        // Materialize both entries before taking references: an insertion into the sorted table
+        // invalidates references into it.
+        vars[from];
+        vars[to];
         auto &fromState = vars[from];
         auto &toState = vars[to];
         toState.knownTruthy = fromState.knownTruthy;
@@ -306,23 +328,34 @@ void Environment::propagateKnowledge(core::Context ctx, core::LocalVariable to,
 }
 
 void Environment::clearKnowledge(core::Context ctx, core::LocalVariable reassigned, KnowledgeFilter &knowledgeFilter) {
+    auto references = [&](const KnowledgeFact &fact) -> bool {
+        return absl::c_any_of(fact.yesTypeTests, [&](auto const &c) -> bool { return c.first == reassigned; }) ||
+               absl::c_any_of(fact.noTypeTests, [&](auto const &c) -> bool { return c.first == reassigned; });
+    };
     for (auto &el : vars) {
         auto &k = el.second.knowledge;
         if (knowledgeFilter.isNeeded(el.first)) {
-            auto &truthy = k.truthy.mutate();
-            auto &falsy = k.falsy.mutate();
-            truthy.yesTypeTests.erase(remove_if(truthy.yesTypeTests.begin(), truthy.yesTypeTests.end(),
-                                                [&](auto const &c) -> bool { return c.first == reassigned; }),
-                                      truthy.yesTypeTests.end());
-            falsy.yesTypeTests.erase(remove_if(falsy.yesTypeTests.begin(), falsy.yesTypeTests.end(),
-                                               [&](auto const &c) -> bool { return c.first == reassigned; }),
-                                     falsy.yesTypeTests.end());
-            truthy.noTypeTests.erase(remove_if(truthy.noTypeTests.begin(), truthy.noTypeTests.end(),
-                                               [&](auto const &c) -> bool { return c.first == reassigned; }),
-                                     truthy.noTypeTests.end());
-            falsy.noTypeTests.erase(remove_if(falsy.noTypeTests.begin(), falsy.noTypeTests.end(),
-                                              [&](auto const &c) -> bool { return c.first == reassigned; }),
-                                    falsy.noTypeTests.end());
+            // Only unshare a fact that actually references the reassigned variable; most facts are
+            // shared (often the empty one) and mutating them blindly would copy on every
+            // assignment.
+            if (references(*k.truthy)) {
+                auto &truthy = k.truthy.mutate();
+                truthy.yesTypeTests.erase(remove_if(truthy.yesTypeTests.begin(), truthy.yesTypeTests.end(),
+                                                    [&](auto const &c) -> bool { return c.first == reassigned; }),
+                                          truthy.yesTypeTests.end());
+                truthy.noTypeTests.erase(remove_if(truthy.noTypeTests.begin(), truthy.noTypeTests.end(),
+                                                   [&](auto const &c) -> bool { return c.first == reassigned; }),
+                                         truthy.noTypeTests.end());
+            }
+            if (references(*k.falsy)) {
+                auto &falsy = k.falsy.mutate();
+                falsy.yesTypeTests.erase(remove_if(falsy.yesTypeTests.begin(), falsy.yesTypeTests.end(),
+                                                   [&](auto const &c) -> bool { return c.first == reassigned; }),
+                                         falsy.yesTypeTests.end());
+                falsy.noTypeTests.erase(remove_if(falsy.noTypeTests.begin(), falsy.noTypeTests.end(),
+                                                  [&](auto const &c) -> bool { return c.first == reassigned; }),
+                                        falsy.noTypeTests.end());
+            }
             k.sanityCheck();
         }
     }
@@ -494,7 +527,7 @@ void Environment::setTypeAndOrigin(core::LocalVariable symbol, const core::TypeA
 }
 
 const Environment &Environment::withCond(core::Context ctx, const Environment &env, Environment &copy, bool isTrue,
-                                         const UnorderedMap<core::LocalVariable, VariableState> &filter) {
+                                         const VariableStateTable &filter) {
     if (!env.bb->bexit.cond.variable.exists() || env.bb->bexit.cond.variable == core::LocalVariable::blockCall()) {
         return env;
     }
@@ -504,7 +537,7 @@ const Environment &Environment::withCond(core::Context ctx, const Environment &e
 }
 
 void Environment::assumeKnowledge(core::Context ctx, bool isTrue, core::LocalVariable cond, core::Loc loc,
-                                  const UnorderedMap<core::LocalVariable, VariableState> &filter) {
+                                  const VariableStateTable &filter) {
     auto &thisKnowledge = getKnowledge(cond, false);
     thisKnowledge.sanityCheck();
     if (!isTrue) {
@@ -616,7 +649,7 @@ void Environment::mergeWith(core::Context ctx, const Environment &other, core::L
                 if (!thisKnowledge.seenTruthyOption) {
                     thisKnowledge.seenTruthyOption = true;
                     thisKnowledge.truthy = otherTruthy;
-                } else {
+                } else if (!thisKnowledge.truthy.sharesFactWith(otherTruthy)) {
                     thisKnowledge.truthy.mutate().min(ctx, *otherTruthy);
                 }
             }
@@ -630,7 +663,7 @@ void Environment::mergeWith(core::Context ctx, const Environment &other, core::L
                 if (!thisKnowledge.seenFalsyOption) {
                     thisKnowledge.seenFalsyOption = true;
                     thisKnowledge.falsy = otherFalsy;
-                } else {
+                } else if (!thisKnowledge.falsy.sharesFactWith(otherFalsy)) {
                     thisKnowledge.falsy.mutate().min(ctx, *otherFalsy);
                 }
             }
@@ -689,6 +722,25 @@ void Environment::populateFrom(core::Context ctx, const Environment &other) {
     this->pinnedTypes = other.pinnedTypes;
 }
 
+void Environment::populateFromMove(core::Context ctx, Environment &other) {
+    this->isDead = other.isDead;
+    for (auto &pair : vars) {
+        auto var = pair.first;
+        auto fnd = other.vars.find(var);
+        if (fnd == other.vars.end()) {
+            pair.second.typeAndOrigins = other.getTypeAndOrigin(ctx, var);
+            pair.second.knowledge = other.getKnowledge(var, false);
+            pair.second.knownTruthy = other.getKnownTruthy(var);
+            continue;
+        }
+        pair.second = move(fnd->second);
+    }
+    // The sole consumer of `other`'s pins is this block's computePins call, which with a single
+    // parent recomputes exactly the values moved here, so leaving `other` empty is observationally
+    // identical to the copy in populateFrom.
+    this->pinnedTypes = std::move(other.pinnedTypes);
+}
+
 core::TypePtr Environment::getReturnType(core::Context ctx, core::TypePtr procType) {
     if (!procType->derivesFrom(ctx, core::Symbols::Proc())) {
         return core::Types::untypedUntracked();
@@ -740,19 +792,20 @@ core::TypePtr flatmapHack(core::Context ctx, core::TypePtr receiver, core::TypeP
 core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind, int loopCount, int bindMinLoops,
                                           KnowledgeFilter &knowledgeFilter, core::TypeConstraint &constr,
                                           core::TypePtr &methodReturnType) {
+    MicroTimer timeit(MicroTimerSlot::ProcessBinding);
     try {
         core::TypeAndOrigins tp;
-        bool noLoopChecking = cfg::isa_instruction<cfg::Alias>(bind.value.get()) ||
-                              cfg::isa_instruction<cfg::LoadArg>(bind.value.get()) ||
-                              cfg::isa_instruction<cfg::LoadSelf>(bind.value.get());
+        bool noLoopChecking = cfg::isa_instruction<cfg::Alias>(bind.value) ||
+                              cfg::isa_instruction<cfg::LoadArg>(bind.value) ||
+                              cfg::isa_instruction<cfg::LoadSelf>(bind.value);
 
         bool checkFullyDefined = true;
         const core::lsp::Query &lspQuery = ctx.state.lspQuery;
         bool lspQueryMatch = lspQuery.matchesLoc(bind.loc);
 
-        typecase(
-            bind.value.get(),
-            [&](cfg::Send *send) {
+        switch (bind.value->tag) {
+            case cfg::Instruction::Tag::Send: {
+                auto *send = static_cast<cfg::Send *>(bind.value);
                 InlinedVector<const core::TypeAndOrigins *, 2> args;
 
                 args.reserve(send->args.size());
@@ -770,16 +823,59 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
                     send->argLocs,
                 };
                 core::DispatchArgs dispatchArgs{send->fun, locs, args, recvType.type, recvType.type, send->link};
-                auto dispatched = recvType.type->dispatchCall(ctx, dispatchArgs);
 
+                // The inline cache replays the previous dispatch when the incoming types are
+                // identical. It is bypassed whenever a query is active: a hit skips dispatchCall,
+                // which would also skip the matchesSymbol check below.
+                bool icUsable = send->link == nullptr && lspQuery.isEmpty();
+                if (icUsable && send->ic != nullptr && send->ic->receiverType.get() == recvType.type.get() &&
+                    send->ic->argTypes.size() == args.size()) {
+                    bool icHit = true;
+                    for (size_t i = 0; i < args.size(); i++) {
+                        if (send->ic->argTypes[i].get() != args[i]->type.get()) {
+                            icHit = false;
+                            break;
+                        }
+                    }
+                    if (icHit) {
+                        counterInc("infer.send_inline_cache.hit");
+                        tp.type = send->ic->returnType;
+                        tp.origins.emplace_back(bind.loc);
+                        break;
+                    }
+                }
+
+                auto dispatched = [&] {
+                    MicroTimer timeit(MicroTimerSlot::DispatchCall);
+                    return recvType.type->dispatchCall(ctx, dispatchArgs);
+                }();
+
+                bool dispatchHadErrors = false;
                 auto it = &dispatched;
                 while (it != nullptr) {
+                    dispatchHadErrors = dispatchHadErrors || !it->main.errors.empty();
                     for (auto &err : it->main.errors) {
                         ctx.state._error(std::move(err));
                     }
                     lspQueryMatch = lspQueryMatch || lspQuery.matchesSymbol(it->main.method);
                     it = it->secondary.get();
                 }
+
+                if (icUsable && !dispatchHadErrors && dispatched.secondary == nullptr &&
+                    dispatched.main.constr == nullptr && dispatched.main.blockReturnType == nullptr &&
+                    dispatched.main.blockPreType == nullptr) {
+                    counterInc("infer.send_inline_cache.fill");
+                    if (send->ic == nullptr) {
+                        send->ic = make_unique<cfg::Send::InlineCache>();
+                    }
+                    auto &ic = *send->ic;
+                    ic.receiverType = recvType.type;
+                    ic.argTypes.clear();
+                    for (auto *arg : args) {
+                        ic.argTypes.emplace_back(arg->type);
+                    }
+                    ic.returnType = dispatched.returnType;
+                }
                 shared_ptr<core::DispatchResult> retainedResult;
                 if (send->link) {
                     // this type should never be used, thus we put a useless type
@@ -807,8 +903,10 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
                     send->link->result = move(retainedResult);
                 }
                 tp.origins.emplace_back(bind.loc);
-            },
-            [&](cfg::Ident *i) {
+                break;
+            }
+            case cfg::Instruction::Tag::Ident: {
+                auto *i = static_cast<cfg::Ident *>(bind.value);
                 const core::TypeAndOrigins &typeAndOrigin = getTypeAndOrigin(ctx, i->what);
                 tp.type = typeAndOrigin.type;
                 tp.origins = typeAndOrigin.origins;
@@ -820,8 +918,10 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
 
                 ENFORCE((bind.loc.exists() && bind.loc.file().data(ctx).hasParseErrors) || !tp.origins.empty(),
                         "Inferencer did not assign location");
-            },
-            [&](cfg::Alias *a) {
+                break;
+            }
+            case cfg::Instruction::Tag::Alias: {
+                auto *a = static_cast<cfg::Alias *>(bind.value);
                 core::SymbolRef symbol = a->what.data(ctx)->dealias(ctx);
                 const auto &data = symbol.data(ctx);
                 if (data->isClass()) {
@@ -863,8 +963,10 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
                 }
 
                 pinnedTypes[bind.bind.variable] = tp;
-            },
-            [&](cfg::SolveConstraint *i) {
+                break;
+            }
+            case cfg::Instruction::Tag::SolveConstraint: {
+                auto *i = static_cast<cfg::SolveConstraint *>(bind.value);
                 if (i->link->result->main.constr && !i->link->result->main.constr->solve(ctx)) {
                     if (auto e = ctx.state.beginError(bind.loc, core::errors::Infer::GenericMethodConstaintUnsolved)) {
                         e.setHeader("Could not find valid instantiation of type parameters");
@@ -881,8 +983,10 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
                 type = flatmapHack(ctx, i->link->result->main.receiver, type, i->link->fun);
                 tp.type = std::move(type);
                 tp.origins.emplace_back(bind.loc);
-            },
-            [&](cfg::LoadArg *i) {
+                break;
+            }
+            case cfg::Instruction::Tag::LoadArg: {
+                auto *i = static_cast<cfg::LoadArg *>(bind.value);
                 /* read type from info filled by define_method */
                 /*
                  * TODO(nelhage): This should arguably use the klass and targs
@@ -899,8 +1003,10 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
                 auto argType = i->argument(ctx).argumentTypeAsSeenByImplementation(ctx, constr);
                 tp.type = std::move(argType);
                 tp.origins.emplace_back(bind.loc);
-            },
-            [&](cfg::LoadYieldParams *insn) {
+                break;
+            }
+            case cfg::Instruction::Tag::LoadYieldParams: {
+                auto *insn = static_cast<cfg::LoadYieldParams *>(bind.value);
                 ENFORCE(insn->link);
                 ENFORCE(insn->link->result);
                 ENFORCE(insn->link->result->main.blockPreType);
@@ -924,8 +1030,10 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
                     tp.type = params;
                 }
                 tp.origins.emplace_back(bind.loc);
-            },
-            [&](cfg::Return *i) {
+                break;
+            }
+            case cfg::Instruction::Tag::Return: {
+                auto *i = static_cast<cfg::Return *>(bind.value);
                 tp.type = core::Types::bottom();
                 tp.origins.emplace_back(bind.loc);
 
@@ -947,8 +1055,10 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
                                                typeAndOrigin.origins2Explanations(ctx)));
                     }
                 }
-            },
-            [&](cfg::BlockReturn *i) {
+                break;
+            }
+            case cfg::Instruction::Tag::BlockReturn: {
+                auto *i = static_cast<cfg::BlockReturn *>(bind.value);
                 ENFORCE(i->link);
                 ENFORCE(i->link->result->main.blockReturnType != nullptr);
 
@@ -980,8 +1090,10 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
 
                 tp.type = core::Types::bottom();
                 tp.origins.emplace_back(bind.loc);
-            },
-            [&](cfg::Literal *i) {
+                break;
+            }
+            case cfg::Instruction::Tag::Literal: {
+                auto *i = static_cast<cfg::Literal *>(bind.value);
                 tp.type = i->value;
                 tp.origins.emplace_back(bind.loc);
 
@@ -989,8 +1101,10 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
                     core::lsp::QueryResponse::pushQueryResponse(ctx,
                                                                 core::lsp::LiteralResponse(ctx.owner, bind.loc, tp));
                 }
-            },
-            [&](cfg::TAbsurd *i) {
+                break;
+            }
+            case cfg::Instruction::Tag::TAbsurd: {
+                auto *i = static_cast<cfg::TAbsurd *>(bind.value);
                 const core::TypeAndOrigins &typeAndOrigin = getTypeAndOrigin(ctx, i->what.variable);
 
                 if (auto e = ctx.state.beginError(bind.loc, core::errors::Infer::NotExhaustive)) {
@@ -1005,12 +1119,16 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
 
                 tp.type = core::Types::bottom();
                 tp.origins.emplace_back(bind.loc);
-            },
-            [&](cfg::Unanalyzable *i) {
+                break;
+            }
+            case cfg::Instruction::Tag::Unanalyzable:
+            case cfg::Instruction::Tag::NotSupported: {
                 tp.type = core::Types::untypedUntracked();
                 tp.origins.emplace_back(bind.loc);
-            },
-            [&](cfg::LoadSelf *l) {
+                break;
+            }
+            case cfg::Instruction::Tag::LoadSelf: {
+                auto *l = static_cast<cfg::LoadSelf *>(bind.value);
                 ENFORCE(l->link);
                 if (l->link->result->main.blockSpec.rebind.exists()) {
                     tp.type = l->link->result->main.blockSpec.rebind.data(ctx)->externalType(ctx);
@@ -1019,8 +1137,10 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
                 } else {
                     tp = getTypeAndOrigin(ctx, l->fallback);
                 }
-            },
-            [&](cfg::Cast *c) {
+                break;
+            }
+            case cfg::Instruction::Tag::Cast: {
+                auto *c = static_cast<cfg::Cast *>(bind.value);
                 auto klass = ctx.owner.data(ctx)->enclosingClass(ctx);
                 auto castType = core::Types::instantiate(ctx, c->type, klass.data(ctx)->typeMembers(),
                                                          klass.data(ctx)->selfTypeArgs(ctx));
@@ -1064,7 +1184,9 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
                 if (c->cast == core::Names::let()) {
                     pinnedTypes[bind.bind.variable] = tp;
                 }
-            });
+                break;
+            }
+        }
 
         ENFORCE(tp.type.get() != nullptr, "Inferencer did not assign type: {}", bind.value->toString(ctx));
         tp.type->sanityCheck(ctx);
@@ -1123,7 +1245,7 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
                         break;
                     default: {
                         if (!asGoodAs || (tp.type->isUntyped() && !cur.type->isUntyped())) {
-                            if (auto ident = cfg::cast_instruction<cfg::Ident>(bind.value.get())) {
+                            if (auto ident = cfg::cast_instruction<cfg::Ident>(bind.value)) {
                                 // See cfg/builder/builder_walk.cc for an explanation of why this is here.
                                 if (ident->what._name == core::Names::blockBreakAssign()) {
                                     break;
@@ -1169,12 +1291,22 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
                 }
             }
         }
+        // Single-use temporaries never earn a `vars` slot: their value is consumed by an upcoming
+        // binding in this block and is dead afterwards, and no knowledge is ever recorded for them
+        // (every knowledge update below is gated on the filter). All other variables take the full
+        // path: type slot plus knowledge maintenance.
+        if (singleUseTemps != nullptr && !knowledgeFilter.isNeeded(bind.bind.variable) &&
+            singleUseTemps->find(bind.bind.variable) != singleUseTemps->end()) {
+            ephemeralTypes[bind.bind.variable] = tp;
+            return move(tp.type);
+        }
+
         setTypeAndOrigin(bind.bind.variable, tp);
 
         clearKnowledge(ctx, bind.bind.variable, knowledgeFilter);
-        if (auto *send = cfg::cast_instruction<cfg::Send>(bind.value.get())) {
+        if (auto *send = cfg::cast_instruction<cfg::Send>(bind.value)) {
             updateKnowledge(ctx, bind.bind.variable, bind.loc, send, knowledgeFilter);
-        } else if (auto *i = cfg::cast_instruction<cfg::Ident>(bind.value.get())) {
+        } else if (auto *i = cfg::cast_instruction<cfg::Ident>(bind.value)) {
             propagateKnowledge(ctx, bind.bind.variable, i->what, knowledgeFilter);
         }
 
@@ -1191,6 +1323,8 @@ core::TypePtr Environment::processBinding(core::Context ctx, cfg::Binding &bind,
 void Environment::cloneFrom(const Environment &rhs) {
     this->isDead = rhs.isDead;
     this->vars = rhs.vars;
+    this->ephemeralTypes = rhs.ephemeralTypes;
+    this->singleUseTemps = rhs.singleUseTemps;
     this->bb = rhs.bb;
     this->pinnedTypes = rhs.pinnedTypes;
 }
@@ -1217,5 +1351,15 @@ core::TypeAndOrigins nilTypesWithOriginWithLoc(core::Loc loc) {
 
 Environment::Environment(core::Loc ownerLoc) : uninitialized(nilTypesWithOriginWithLoc(ownerLoc)) {}
 
+void Environment::reset(core::Loc ownerLoc) {
+    this->uninitialized = nilTypesWithOriginWithLoc(ownerLoc);
+    this->isDead = false;
+    this->bb = nullptr;
+    this->vars.clear();
+    this->ephemeralTypes.clear();
+    this->singleUseTemps = nullptr;
+    this->pinnedTypes.clear();
+}
+
 TestedKnowledge TestedKnowledge::empty;
 } // namespace sorbet::infer
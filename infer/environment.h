@@ -58,10 +58,13 @@ struct KnowledgeFact {
     std::string toString(core::Context ctx) const;
 };
 
-// KnowledgeRef wraps a `KnowledgeFact` with copy-on-write semantics
+// KnowledgeRef wraps a `KnowledgeFact` with copy-on-write semantics. Facts are shared structurally:
+// a fresh ref points at a process-wide empty fact (no allocation), copies alias the same fact, and
+// `mutate` unshares only at the point of the first write. Environments cloned on branching therefore
+// share all of their knowledge until one side actually learns something new.
 class KnowledgeRef {
 public:
-    KnowledgeRef() : knowledge(std::make_shared<KnowledgeFact>()) {}
+    KnowledgeRef();
     KnowledgeRef(const KnowledgeRef &) = default;
     KnowledgeRef &operator=(const KnowledgeRef &) = default;
     KnowledgeRef(KnowledgeRef &&) = default;
@@ -70,6 +73,12 @@ public:
     const KnowledgeFact &operator*() const;
     const KnowledgeFact *operator->() const;
 
+    /** True when both refs alias the same underlying fact; merging a fact with itself is a no-op,
+     * so callers use this to skip an unshare-and-scan. */
+    bool sharesFactWith(const KnowledgeRef &other) const {
+        return knowledge == other.knowledge;
+    }
+
     KnowledgeFact &mutate();
 
 private:
@@ -93,13 +102,18 @@ public:
 };
 
 class Environment {
-    const core::TypeAndOrigins uninitialized;
+    // Not const so that pooled environments can be re-seeded for a new method by reset().
+    core::TypeAndOrigins uninitialized;
 
 public:
     Environment(core::Loc ownerLoc);
     Environment(const Environment &rhs) = delete;
     Environment(Environment &&rhs) = default;
 
+    /** Returns this environment to the state a fresh `Environment(ownerLoc)` would have, but keeps
+     * the backing storage so pooled environments reused across methods don't reallocate. */
+    void reset(core::Loc ownerLoc);
+
     bool isDead = false;
     cfg::BasicBlock *bb;
 
@@ -127,7 +141,94 @@ public:
         TestedKnowledge knowledge;
         bool knownTruthy;
     };
-    UnorderedMap<core::LocalVariable, VariableState> vars;
+
+    /**
+     * Maps LocalVariable to VariableState as a vector sorted by variable. A block's environment
+     * holds one entry per live variable, and the per-block merge walks every entry while probing
+     * the parent environment, so contiguous storage with binary-search lookups beats hashing each
+     * variable: merges and `withCond` filters become linear scans over a few cache lines.
+     */
+    class VariableStateTable final {
+    public:
+        using value_type = std::pair<core::LocalVariable, VariableState>;
+        using iterator = std::vector<value_type>::iterator;
+        using const_iterator = std::vector<value_type>::const_iterator;
+
+        iterator begin() {
+            return entries_.begin();
+        }
+        iterator end() {
+            return entries_.end();
+        }
+        const_iterator begin() const {
+            return entries_.begin();
+        }
+        const_iterator end() const {
+            return entries_.end();
+        }
+
+        size_t size() const {
+            return entries_.size();
+        }
+        void reserve(size_t n) {
+            entries_.reserve(n);
+        }
+        void clear() {
+            entries_.clear();
+        }
+
+        iterator find(core::LocalVariable var) {
+            auto it = lowerBound(var);
+            if (it != entries_.end() && it->first == var) {
+                return it;
+            }
+            return entries_.end();
+        }
+        const_iterator find(core::LocalVariable var) const {
+            auto it = lowerBound(var);
+            if (it != entries_.end() && it->first == var) {
+                return it;
+            }
+            return entries_.end();
+        }
+
+        /** Inserts a default VariableState if absent. The returned reference is invalidated by the
+         * next insertion into this table. */
+        VariableState &operator[](core::LocalVariable var) {
+            auto it = lowerBound(var);
+            if (it == entries_.end() || it->first != var) {
+                it = entries_.insert(it, std::make_pair(var, VariableState{}));
+            }
+            return it->second;
+        }
+
+    private:
+        iterator lowerBound(core::LocalVariable var) {
+            return std::lower_bound(entries_.begin(), entries_.end(), var,
+                                    [](const value_type &entry, core::LocalVariable var) { return entry.first < var; });
+        }
+        const_iterator lowerBound(core::LocalVariable var) const {
+            return std::lower_bound(entries_.begin(), entries_.end(), var,
+                                    [](const value_type &entry, core::LocalVariable var) { return entry.first < var; });
+        }
+
+        std::vector<value_type> entries_;
+    };
+
+    VariableStateTable vars;
+
+    /**
+     * Types of the CFG's single-use temporaries (cfg::CFG::singleUseTemps) bound in this block.
+     * These are written once and read once by the very next few bindings, so they never earn a
+     * slot in `vars`: keeping them out means merges, knowledge scans, and `withCond` filters only
+     * walk real locals. `getTypeAndOrigin` falls back to this map when a variable is absent from
+     * `vars`.
+     */
+    UnorderedMap<core::LocalVariable, core::TypeAndOrigins> ephemeralTypes;
+
+    /** The owning CFG's single-use temporary set; assigned alongside `bb` before the block is
+     * processed. */
+    const UnorderedSet<core::LocalVariable> *singleUseTemps = nullptr;
 
     UnorderedMap<core::LocalVariable, core::TypeAndOrigins> pinnedTypes;
 
@@ -169,10 +270,10 @@ public:
      * then discard it, so the mixed lifetimes are not a problem in practice.
      */
     static const Environment &withCond(core::Context ctx, const Environment &env, Environment &copy, bool isTrue,
-                                       const UnorderedMap<core::LocalVariable, VariableState> &filter);
+                                       const VariableStateTable &filter);
 
     void assumeKnowledge(core::Context ctx, bool isTrue, core::LocalVariable cond, core::Loc loc,
-                         const UnorderedMap<core::LocalVariable, VariableState> &filter);
+                         const VariableStateTable &filter);
 
     void mergeWith(core::Context ctx, const Environment &other, core::Loc loc, cfg::CFG &inWhat, cfg::BasicBlock *bb,
                    KnowledgeFilter &knowledgeFilter);
@@ -182,6 +283,11 @@ public:
 
     void populateFrom(core::Context ctx, const Environment &other);
 
+    /* Destructive populateFrom: steals `other`'s per-variable state and pinned types instead of
+     * copying them. Only valid when this block is `other`'s sole successor, so `other` is never
+     * read again after this call. */
+    void populateFromMove(core::Context ctx, Environment &other);
+
     // Extract the return value type from a proc. This should potentially be a
     // method on `Type` or otherwise handled there.
     core::TypePtr getReturnType(core::Context ctx, core::TypePtr procType);
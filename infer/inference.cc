@@ -9,6 +9,44 @@
 using namespace std;
 namespace sorbet::infer {
 
+namespace {
+
+// Per-thread workspace reused across methods. Most methods are tiny, and for them constructing
+// fresh environments costs more than analyzing the method; retaining the backing storage keeps
+// per-method setup proportional to the method's own size.
+struct InferenceWorkspace {
+    vector<Environment> outEnvironments;
+    vector<bool> visited;
+};
+
+thread_local InferenceWorkspace inferenceWorkspace;
+
+// Hands out `count` pooled environments for one method and clears them again when the method is
+// done, so no types stay pinned by the pool between methods.
+class WorkspaceGuard final {
+    InferenceWorkspace &ws;
+    int used;
+
+public:
+    WorkspaceGuard(InferenceWorkspace &ws, core::Loc methodLoc, int count) : ws(ws), used(count) {
+        while (ws.outEnvironments.size() < used) {
+            ws.outEnvironments.emplace_back(methodLoc);
+        }
+        for (int i = 0; i < used; i++) {
+            ws.outEnvironments[i].reset(methodLoc);
+        }
+        ws.visited.assign(used, false);
+    }
+
+    ~WorkspaceGuard() {
+        for (int i = 0; i < used; i++) {
+            ws.outEnvironments[i].reset(core::Loc::none());
+        }
+    }
+};
+
+} // namespace
+
 unique_ptr<cfg::CFG> Inference::run(core::Context ctx, unique_ptr<cfg::CFG> cfg) {
     ENFORCE(cfg->symbol == ctx.owner);
     auto methodLoc = cfg->symbol.data(ctx)->loc();
@@ -65,16 +103,17 @@ unique_ptr<cfg::CFG> Inference::run(core::Context ctx, unique_ptr<cfg::CFG> cfg)
         methodReturnType = core::Types::replaceSelfType(ctx, methodReturnType, enclosingClass.data(ctx)->selfType(ctx));
     }
 
-    vector<Environment> outEnvironments;
-    outEnvironments.reserve(cfg->maxBasicBlockId);
-    for (int i = 0; i < cfg->maxBasicBlockId; i++) {
-        outEnvironments.emplace_back(methodLoc);
-    }
+    // One slot per basic block plus a scratch slot for withCond during merges.
+    WorkspaceGuard environmentPool(inferenceWorkspace, methodLoc, cfg->maxBasicBlockId + 1);
+    vector<Environment> &outEnvironments = inferenceWorkspace.outEnvironments;
     for (int i = 0; i < cfg->basicBlocks.size(); i++) {
         outEnvironments[cfg->forwardsTopoSort[i]->id].bb = cfg->forwardsTopoSort[i];
+        outEnvironments[cfg->forwardsTopoSort[i]->id].singleUseTemps = &cfg->singleUseTemps;
     }
-    vector<bool> visited;
-    visited.resize(cfg->maxBasicBlockId);
+    vector<bool> &visited = inferenceWorkspace.visited;
+    // Its contents are fully overwritten (cloneFrom) whenever withCond actually populates it, so
+    // one slot can serve every merge in the method.
+    Environment &condScratch = outEnvironments[cfg->maxBasicBlockId];
     KnowledgeFilter knowledgeFilter(ctx, cfg);
     if (!cfg->basicBlocks.empty()) {
         ENFORCE(!cfg->symbol.data(ctx)->isAbstract());
@@ -95,13 +134,29 @@ unique_ptr<cfg::CFG> Inference::run(core::Context ctx, unique_ptr<cfg::CFG> cfg)
         if (bb->backEdges.size() == 1) {
             auto *parent = bb->backEdges[0];
             bool isTrueBranch = parent->bexit.thenb == bb;
-            if (!outEnvironments[parent->id].isDead) {
-                Environment tempEnv(methodLoc);
-                auto &envAsSeenFromBranch =
-                    Environment::withCond(ctx, outEnvironments[parent->id], tempEnv, isTrueBranch, current.vars);
-                current.populateFrom(ctx, envAsSeenFromBranch);
-            } else {
+            auto &parentEnv = outEnvironments[parent->id];
+            if (parentEnv.isDead) {
                 current.isDead = true;
+            } else if (!parent->bexit.cond.variable.exists() ||
+                       parent->bexit.cond.variable == core::LocalVariable::blockCall()) {
+                if (parent->bexit.thenb == parent->bexit.elseb) {
+                    // Straight-line code: this block is the parent's only successor, so nothing
+                    // reads the parent environment after this point and we can steal its state
+                    // instead of copying it.
+                    current.populateFromMove(ctx, parentEnv);
+                } else {
+                    current.populateFrom(ctx, parentEnv);
+                }
+            } else {
+                // With a single predecessor there is no need to clone the whole parent environment
+                // into a temporary only to copy the live subset out of it again (what withCond +
+                // populateFrom would do); copy the live subset once and refine the branch condition
+                // in place. The condition variable must be part of the copy even when it is dead in
+                // this block because the refinement reads its type.
+                current.vars[parent->bexit.cond.variable].typeAndOrigins.type = nullptr;
+                current.populateFrom(ctx, parentEnv);
+                current.assumeKnowledge(ctx, isTrueBranch, parent->bexit.cond.variable, parent->bexit.loc,
+                                        current.vars);
             }
         } else {
             current.isDead = (bb != cfg->entry());
@@ -110,9 +165,8 @@ unique_ptr<cfg::CFG> Inference::run(core::Context ctx, unique_ptr<cfg::CFG> cfg)
                     continue;
                 }
                 bool isTrueBranch = parent->bexit.thenb == bb;
-                Environment tempEnv(methodLoc);
                 auto &envAsSeenFromBranch =
-                    Environment::withCond(ctx, outEnvironments[parent->id], tempEnv, isTrueBranch, current.vars);
+                    Environment::withCond(ctx, outEnvironments[parent->id], condScratch, isTrueBranch, current.vars);
                 if (!envAsSeenFromBranch.isDead) {
                     current.isDead = false;
                     current.mergeWith(ctx, envAsSeenFromBranch, parent->bexit.loc, *cfg.get(), bb, knowledgeFilter);
@@ -144,7 +198,7 @@ unique_ptr<cfg::CFG> Inference::run(core::Context ctx, unique_ptr<cfg::CFG> cfg)
                     if (expr.value->isSynthetic) {
                         continue;
                     }
-                    if (cfg::isa_instruction<cfg::TAbsurd>(expr.value.get())) {
+                    if (cfg::isa_instruction<cfg::TAbsurd>(expr.value)) {
                         continue;
                     }
                     if (auto e = ctx.state.beginError(expr.loc, core::errors::Infer::DeadBranchInferencer)) {
@@ -164,7 +218,7 @@ unique_ptr<cfg::CFG> Inference::run(core::Context ctx, unique_ptr<cfg::CFG> cfg)
                 current.ensureGoodAssignTarget(ctx, bind.bind.variable);
                 bind.bind.type = current.processBinding(ctx, bind, bb->outerLoops, cfg->minLoops[bind.bind.variable],
                                                         knowledgeFilter, *constr, methodReturnType);
-                if (cfg::isa_instruction<cfg::Send>(bind.value.get())) {
+                if (cfg::isa_instruction<cfg::Send>(bind.value)) {
                     totalSendCount++;
                     if (bind.bind.type && !bind.bind.type->isUntyped()) {
                         typedSendCount++;
@@ -214,7 +268,14 @@ unique_ptr<cfg::CFG> Inference::run(core::Context ctx, unique_ptr<cfg::CFG> cfg)
     }
 
     if ((missingReturnType || cfg->symbol.data(ctx)->hasGeneratedSig()) && guessTypes) {
-        if (auto e = ctx.state.beginError(cfg->symbol.data(ctx)->loc(), core::errors::Infer::UntypedMethod)) {
+        if (ctx.state.deferSigSuggestions) {
+            // Batch suggestion mode: keep only the CFG-bound evidence now; the suggestion itself
+            // (ancestor walks, source inspection, autocorrect assembly) and the UntypedMethod error
+            // are produced by a parallel post-pass once typechecking is done.
+            if (auto evidence = SigSuggestion::collectEvidence(ctx, cfg, methodReturnType, *constr)) {
+                SigSuggestion::recordEvidence(move(*evidence));
+            }
+        } else if (auto e = ctx.state.beginError(cfg->symbol.data(ctx)->loc(), core::errors::Infer::UntypedMethod)) {
             e.setHeader("This function does not have a `sig`");
             SigSuggestion::maybeSuggestSig(ctx, e, cfg, methodReturnType, *constr);
         }
@@ -94,19 +94,35 @@ class LocalNameInserter {
     }
 
     struct LocalFrame {
-        UnorderedMap<core::NameRef, core::LocalVariable> locals;
         vector<core::LocalVariable> args;
         core::Loc loc;
         std::optional<u4> oldBlockCounter = nullopt;
         u4 localId = 0;
+        // Index into localsStack where this frame's bindings begin. Everything at or above it is
+        // popped when the frame exits.
+        u4 localsStart = 0;
+        // Lowest localsStack index visible from this frame. Blocks see through to their enclosing
+        // method's bindings; methods and classes start fresh.
+        u4 localsFloor = 0;
         bool insideBlock = false;
         bool insideMethod = false;
     };
 
+    // One binding on the flat scope stack. Bindings are pushed in declaration order and resolved
+    // by scanning from the top down to the current frame's floor, so inner declarations shadow
+    // outer ones without ever copying a parent frame's bindings.
+    struct LocalEntry {
+        core::NameRef name;
+        core::LocalVariable local;
+    };
+
     LocalFrame &pushBlockFrame(core::Loc loc, bool insideMethod) {
+        auto floor = scopeStack.empty() ? 0 : scopeStack.back().localsFloor;
         auto &frame = scopeStack.emplace_back();
         frame.loc = loc;
         frame.localId = blockCounter;
+        frame.localsStart = static_cast<u4>(localsStack.size());
+        frame.localsFloor = floor;
         frame.insideBlock = true;
         frame.insideMethod = insideMethod;
         ++blockCounter;
@@ -123,6 +139,8 @@ class LocalNameInserter {
         auto &frame = scopeStack.emplace_back();
         frame.loc = loc;
         frame.oldBlockCounter = blockCounter;
+        frame.localsStart = static_cast<u4>(localsStack.size());
+        frame.localsFloor = frame.localsStart;
         frame.insideMethod = true;
         blockCounter = 1;
         return frame;
@@ -132,6 +150,8 @@ class LocalNameInserter {
         auto &frame = scopeStack.emplace_back();
         frame.oldBlockCounter = blockCounter;
         frame.loc = loc;
+        frame.localsStart = static_cast<u4>(localsStack.size());
+        frame.localsFloor = frame.localsStart;
         blockCounter = 1;
         return frame;
     }
@@ -141,10 +161,29 @@ class LocalNameInserter {
         if (oldScopeCounter) {
             blockCounter = *oldScopeCounter;
         }
+        localsStack.resize(scopeStack.back().localsStart);
         scopeStack.pop_back();
     }
 
+    // Finds the innermost visible binding for `name`, or nullptr if the name has not been declared
+    // in any scope visible from the current frame.
+    core::LocalVariable *lookupLocal(core::NameRef name) {
+        auto floor = scopeStack.back().localsFloor;
+        for (auto i = localsStack.size(); i > floor; --i) {
+            auto &entry = localsStack[i - 1];
+            if (entry.name == name) {
+                return &entry.local;
+            }
+        }
+        return nullptr;
+    }
+
+    void declareLocal(core::NameRef name, core::LocalVariable local) {
+        localsStack.emplace_back(LocalEntry{name, local});
+    }
+
     vector<LocalFrame> scopeStack;
+    vector<LocalEntry> localsStack;
     // The purpose of this counter is to ensure that every block within a method/class has a unique scope id.
     // For example, a possible assignment of ids is the following:
     //
@@ -176,8 +215,7 @@ class LocalNameInserter {
 
         for (auto &named : namedArgs) {
             args.emplace_back(move(named.expr));
-            auto frame = scopeStack.back();
-            scopeStack.back().locals[named.name] = named.local;
+            declareLocal(named.name, named.local);
             scopeStack.back().args.emplace_back(named.local);
         }
 
@@ -237,15 +275,9 @@ public:
         auto outerArgs = scopeStack.back().args;
         auto &frame = enterBlock(blk->loc);
         frame.args = std::move(outerArgs);
-        auto &parent = *(scopeStack.end() - 2);
-
-        // We inherit our parent's locals
-        for (auto &binding : parent.locals) {
-            frame.locals.insert(binding);
-        }
 
-        // If any of our arguments shadow our parent, fillInArgs will overwrite
-        // them in `frame.locals`
+        // We see our parent's locals through the frame's floor; any of our arguments that shadow
+        // the parent are pushed above the parent's bindings, so lookupLocal finds them first.
         blk->args = fillInArgs(nameArgs(ctx, blk->args));
 
         return blk;
@@ -259,12 +291,12 @@ public:
     unique_ptr<ast::Expression> postTransformUnresolvedIdent(core::MutableContext ctx,
                                                              unique_ptr<ast::UnresolvedIdent> nm) {
         if (nm->kind == ast::UnresolvedIdent::Local) {
-            auto &frame = scopeStack.back();
-            core::LocalVariable &cur = frame.locals[nm->name];
-            if (!cur.exists()) {
-                cur = enterLocal(nm->name);
-                frame.locals[nm->name] = cur;
+            auto *found = lookupLocal(nm->name);
+            if (found != nullptr) {
+                return make_unique<ast::Local>(nm->loc, *found);
             }
+            auto cur = enterLocal(nm->name);
+            declareLocal(nm->name, cur);
             return make_unique<ast::Local>(nm->loc, cur);
         } else {
             return nm;
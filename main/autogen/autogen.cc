@@ -33,14 +33,23 @@ class AutogenWalk {
 
     UnorderedMap<ast::Expression *, ReferenceRef> refMap;
 
-    vector<core::NameRef> symbolName(core::Context ctx, core::SymbolRef sym) {
+    // Lazily materialized trie of the definition namespace: each symbol's full name is its owner's
+    // cached full name plus one segment, so a chain is walked once no matter how many references
+    // resolve through it. Files reference the same handful of namespaces over and over, which makes
+    // this the hottest part of the walk without the cache.
+    UnorderedMap<core::SymbolRef, vector<core::NameRef>> symbolNameCache;
+
+    const vector<core::NameRef> &symbolName(core::Context ctx, core::SymbolRef sym) {
+        auto it = symbolNameCache.find(sym);
+        if (it != symbolNameCache.end()) {
+            return it->second;
+        }
         vector<core::NameRef> out;
-        while (sym.exists() && sym != core::Symbols::root()) {
+        if (sym.exists() && sym != core::Symbols::root()) {
+            out = symbolName(ctx, sym.data(ctx)->owner);
             out.emplace_back(sym.data(ctx)->name);
-            sym = sym.data(ctx)->owner;
         }
-        reverse(out.begin(), out.end());
-        return out;
+        return symbolNameCache[sym] = move(out);
     }
 
     vector<core::NameRef> constantName(core::Context ctx, ast::ConstantLit *cnst) {
@@ -0,0 +1,313 @@
+#include "main/daemon.h"
+
+#ifdef EMSCRIPTEN
+
+namespace sorbet::realmain {
+int daemonMain(const char *socketPath) {
+    return 1;
+}
+int clientMain(const char *socketPath, int argc, char *argv[]) {
+    return 1;
+}
+} // namespace sorbet::realmain
+
+#else
+
+#include "core/ErrorQueue.h"
+#include "core/GlobalState.h"
+#include "main/options/options.h"
+#include "main/realmain.h"
+#include "payload/payload.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
+
+#include <csignal>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+namespace sorbet::realmain {
+
+namespace {
+
+// Wire protocol, one request per connection:
+//  - client -> daemon: 4-byte request length, then `cwd\0argv[0]\0argv[1]\0...` (every element
+//    NUL-terminated). The first sendmsg carries the client's stdin/stdout/stderr via SCM_RIGHTS,
+//    so the child talks to the client's terminal directly and no output relaying is needed.
+//  - daemon -> client: 1 byte, the child's exit code.
+constexpr size_t MAX_REQUEST_BYTES = 1 << 20;
+constexpr int PASSED_FD_COUNT = 3;
+
+bool writeAll(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        auto written = ::write(fd, buf, len);
+        if (written <= 0) {
+            return false;
+        }
+        buf += written;
+        len -= written;
+    }
+    return true;
+}
+
+bool readAll(int fd, char *buf, size_t len) {
+    while (len > 0) {
+        auto nread = ::read(fd, buf, len);
+        if (nread <= 0) {
+            return false;
+        }
+        buf += nread;
+        len -= nread;
+    }
+    return true;
+}
+
+int listenOn(const char *socketPath) {
+    sockaddr_un addr;
+    if (strlen(socketPath) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "sorbet daemon: socket path too long: %s\n", socketPath);
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("sorbet daemon: socket");
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+    unlink(socketPath);
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(fd, 8) != 0) {
+        perror("sorbet daemon: bind/listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Loads the compiled-in payload once so that forked children start with the symbol tables' rodata
+// faulted in and the allocator warmed. The state itself is discarded: options shape GlobalState
+// construction (strictness overrides, DSL flags, ...), so one resident instance cannot be reused
+// across arbitrary argv — the warmth children inherit is the address space, not the object.
+void warmUp() {
+    auto console = spdlog::stderr_color_mt("sorbet-daemon-warmup");
+    options::Options opts;
+    auto gs = make_unique<core::GlobalState>(make_shared<core::ErrorQueue>(*console, *console));
+    unique_ptr<KeyValueStore> kvstore;
+    payload::createInitialGlobalState(gs, opts, kvstore);
+    spdlog::drop("sorbet-daemon-warmup");
+}
+
+int runRequest(int conn, int listenFd) {
+    // The client's stdio arrives with the first recvmsg on the connection.
+    char lenBuf[4];
+    iovec iov = {lenBuf, sizeof(lenBuf)};
+    char cmsgBuf[CMSG_SPACE(PASSED_FD_COUNT * sizeof(int))];
+    msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cmsgBuf;
+    msg.msg_controllen = sizeof(cmsgBuf);
+    if (recvmsg(conn, &msg, MSG_WAITALL) != sizeof(lenBuf)) {
+        return 1;
+    }
+    int clientFds[PASSED_FD_COUNT] = {-1, -1, -1};
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+            cmsg->cmsg_len == CMSG_LEN(PASSED_FD_COUNT * sizeof(int))) {
+            memcpy(clientFds, CMSG_DATA(cmsg), sizeof(clientFds));
+        }
+    }
+    auto closeClientFds = [&clientFds]() {
+        for (int fd : clientFds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    };
+
+    uint32_t requestLen;
+    memcpy(&requestLen, lenBuf, sizeof(requestLen));
+    if (requestLen == 0 || requestLen > MAX_REQUEST_BYTES || clientFds[0] < 0 || clientFds[1] < 0 ||
+        clientFds[2] < 0) {
+        closeClientFds();
+        return 1;
+    }
+    string request(requestLen, '\0');
+    if (!readAll(conn, request.data(), requestLen)) {
+        closeClientFds();
+        return 1;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        closeClientFds();
+        return 1;
+    }
+    if (pid == 0) {
+        // Child: become the client. Its terminal is our stdio; its cwd ours, so relative paths in
+        // argv resolve the same way they would for a local run.
+        for (int i = 0; i < PASSED_FD_COUNT; i++) {
+            dup2(clientFds[i], i);
+        }
+        closeClientFds();
+        close(conn);
+        close(listenFd);
+
+        vector<char *> argv;
+        size_t offset = 0;
+        auto nextString = [&]() -> char * {
+            if (offset >= request.size()) {
+                return nullptr;
+            }
+            char *result = request.data() + offset;
+            offset = request.find('\0', offset) + 1;
+            return result;
+        };
+        char *cwd = nextString();
+        if (cwd == nullptr || chdir(cwd) != 0) {
+            fprintf(stderr, "sorbet daemon: cannot chdir to %s\n", cwd == nullptr ? "(none)" : cwd);
+            _exit(1);
+        }
+        while (char *arg = nextString()) {
+            argv.emplace_back(arg);
+        }
+        argv.emplace_back(nullptr);
+
+        int code;
+        try {
+            code = realmain(argv.size() - 1, argv.data());
+        } catch (options::EarlyReturnWithCode &c) {
+            code = c.returnCode;
+        } catch (SorbetException &) {
+            code = 1;
+        }
+        // _exit, not exit: the child shares the daemon's static state and must not run its
+        // destructors or flush its streams.
+        fflush(nullptr);
+        _exit(code);
+    }
+
+    closeClientFds();
+    int status = 0;
+    waitpid(pid, &status, 0);
+    char code = WIFEXITED(status) ? static_cast<char>(WEXITSTATUS(status)) : 1;
+    writeAll(conn, &code, 1);
+    return 0;
+}
+
+int connectTo(const char *socketPath) {
+    sockaddr_un addr;
+    if (strlen(socketPath) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "sorbet: socket path too long: %s\n", socketPath);
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+int daemonMain(const char *socketPath) {
+    int listenFd = listenOn(socketPath);
+    if (listenFd < 0) {
+        return 1;
+    }
+    // Dead children are reaped synchronously in runRequest; ignore the signal so an early client
+    // disconnect cannot kill the daemon mid-write.
+    signal(SIGPIPE, SIG_IGN);
+    warmUp();
+    fprintf(stderr, "sorbet daemon: listening on %s\n", socketPath);
+
+    // Requests are handled one at a time: the target workload (pre-commit hooks, shell loops) is
+    // serial, and each child already fans out over its own worker pool.
+    while (true) {
+        int conn = accept(listenFd, nullptr, nullptr);
+        if (conn < 0) {
+            continue;
+        }
+        runRequest(conn, listenFd);
+        close(conn);
+    }
+}
+
+int clientMain(const char *socketPath, int argc, char *argv[]) {
+    int conn = connectTo(socketPath);
+    if (conn < 0) {
+        fprintf(stderr, "sorbet: cannot connect to daemon at %s (is `sorbet --daemon %s` running?)\n", socketPath,
+                socketPath);
+        return 1;
+    }
+
+    char cwd[4096];
+    if (getcwd(cwd, sizeof(cwd)) == nullptr) {
+        close(conn);
+        return 1;
+    }
+    string request;
+    request.append(cwd);
+    request.push_back('\0');
+    // argv[0] for the forwarded command; the daemon's realmain only uses it for usage output.
+    request.append("sorbet");
+    request.push_back('\0');
+    for (int i = 0; i < argc; i++) {
+        request.append(argv[i]);
+        request.push_back('\0');
+    }
+    if (request.size() > MAX_REQUEST_BYTES) {
+        fprintf(stderr, "sorbet: argument list too long for daemon request\n");
+        close(conn);
+        return 1;
+    }
+
+    uint32_t requestLen = request.size();
+    char lenBuf[4];
+    memcpy(lenBuf, &requestLen, sizeof(lenBuf));
+    iovec iov = {lenBuf, sizeof(lenBuf)};
+    char cmsgBuf[CMSG_SPACE(PASSED_FD_COUNT * sizeof(int))];
+    memset(cmsgBuf, 0, sizeof(cmsgBuf));
+    msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cmsgBuf;
+    msg.msg_controllen = sizeof(cmsgBuf);
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(PASSED_FD_COUNT * sizeof(int));
+    int stdioFds[PASSED_FD_COUNT] = {0, 1, 2};
+    memcpy(CMSG_DATA(cmsg), stdioFds, sizeof(stdioFds));
+    if (sendmsg(conn, &msg, 0) != sizeof(lenBuf) || !writeAll(conn, request.data(), request.size())) {
+        fprintf(stderr, "sorbet: failed to send request to daemon\n");
+        close(conn);
+        return 1;
+    }
+
+    char code = 1;
+    if (!readAll(conn, &code, 1)) {
+        fprintf(stderr, "sorbet: daemon closed the connection without reporting an exit code\n");
+        close(conn);
+        return 1;
+    }
+    close(conn);
+    return code;
+}
+
+} // namespace sorbet::realmain
+
+#endif
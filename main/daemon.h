@@ -0,0 +1,21 @@
+#ifndef RUBY_TYPER_DAEMON_H
+#define RUBY_TYPER_DAEMON_H
+
+namespace sorbet::realmain {
+
+// Resident daemon mode for CLI invocations.
+//
+// `sorbet --daemon <socket-path>` starts a resident process that loads the payload once (so the
+// binary, its rodata, and the allocator are warm), listens on a unix socket, and forks one child
+// per request. The child inherits the warm address space copy-on-write, runs the ordinary
+// `realmain` with the forwarded argv, and writes directly to the client's terminal via file
+// descriptors passed over the socket.
+//
+// `sorbet --connect <socket-path> [args...]` is the thin client: it forwards its argv, cwd, and
+// stdio descriptors to the daemon and exits with the code the daemon reports back.
+int daemonMain(const char *socketPath);
+int clientMain(const char *socketPath, int argc, char *argv[]);
+
+} // namespace sorbet::realmain
+
+#endif // RUBY_TYPER_DAEMON_H
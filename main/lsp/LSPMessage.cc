@@ -153,6 +153,8 @@ bool LSPMessage::isDelayable() const {
         case LSPMethod::SorbetWatchmanFileChange:
         // A file read. Should not be reordered with respect to file updates.
         case LSPMethod::SorbetReadFile:
+        // Profiler control. Delaying start/stop would skew what the samples cover.
+        case LSPMethod::SorbetSampleProfile:
             return false;
         // VS Code requests document symbols automatically and in the background. It's OK to delay these requests.
         case LSPMethod::TextDocumentDocumentSymbol:
@@ -244,6 +246,9 @@ LSPMethod LSPMessage::method() const {
 }
 
 string LSPMessage::toJSON(bool prettyPrint) const {
+    if (cachedJSON.has_value() && !prettyPrint) {
+        return *cachedJSON;
+    }
     if (isRequest()) {
         return asRequest().toJSON(prettyPrint);
     } else if (isNotification()) {
@@ -254,4 +259,19 @@ string LSPMessage::toJSON(bool prettyPrint) const {
         Exception::raise("LSPMessage is not a request, notification, or a response.");
     }
 }
+
+string_view LSPMessage::toJSONView() const {
+    if (cachedJSON.has_value()) {
+        return *cachedJSON;
+    }
+    if (isRequest()) {
+        return asRequest().toJSONView();
+    } else if (isNotification()) {
+        return asNotification().toJSONView();
+    } else if (isResponse()) {
+        return asResponse().toJSONView();
+    } else {
+        Exception::raise("LSPMessage is not a request, notification, or a response.");
+    }
+}
 } // namespace sorbet::realmain::lsp
\ No newline at end of file
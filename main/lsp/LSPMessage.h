@@ -68,6 +68,13 @@ public:
     /** If `true`, then this LSPMessage contains a canceled LSP request. */
     bool canceled = false;
 
+    /**
+     * JSON rendered ahead of time (e.g. on a worker thread while fanning out diagnostic
+     * serialization); toJSON returns it verbatim. Only set this on a message that will not be
+     * mutated before it is sent.
+     */
+    std::optional<std::string> cachedJSON;
+
     /**
      * Returns an ID if the message has one. Otherwise, returns nullopt.
      */
@@ -139,6 +146,13 @@ public:
      * Returns the message in JSON form.
      */
     std::string toJSON(bool prettyPrint = false) const;
+
+    /**
+     * Returns the message in JSON form as a view: either into cachedJSON, or into the thread-local
+     * render buffer (see JSONBaseType::toJSONView). The view is only valid until the next message
+     * is rendered on this thread, so consume it before rendering anything else.
+     */
+    std::string_view toJSONView() const;
 };
 } // namespace sorbet::realmain::lsp
 
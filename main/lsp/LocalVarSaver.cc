@@ -5,45 +5,40 @@
 using namespace std;
 
 namespace sorbet::realmain::lsp {
-unique_ptr<ast::Local> LocalVarSaver::postTransformLocal(core::Context ctx, unique_ptr<ast::Local> local) {
+void LocalVarSaver::postTransformLocal(core::Context ctx, const ast::Local &local) {
     core::SymbolRef owner;
     if (ctx.owner.data(ctx)->isMethod()) {
         owner = ctx.owner;
     } else if (ctx.owner == core::Symbols::root()) {
-        owner = ctx.state.lookupStaticInitForFile(local->loc);
+        owner = ctx.state.lookupStaticInitForFile(local.loc);
     } else {
         ENFORCE(ctx.owner.data(ctx)->isClass());
         owner = ctx.state.lookupStaticInitForClass(ctx.owner);
     }
 
-    bool lspQueryMatch = ctx.state.lspQuery.matchesVar(owner, local->localVariable);
+    bool lspQueryMatch = ctx.state.lspQuery.matchesVar(owner, local.localVariable);
     if (lspQueryMatch) {
         // No need for type information; this is for a reference request.
         // Let the default constructor make tp.type an empty shared_ptr and tp.origins an empty vector
         core::TypeAndOrigins tp;
         core::lsp::QueryResponse::pushQueryResponse(
-            ctx, core::lsp::IdentResponse(ctx.owner, local->loc, local->localVariable, tp));
+            ctx, core::lsp::IdentResponse(ctx.owner, local.loc, local.localVariable, tp));
     }
-
-    return local;
 }
 
-unique_ptr<ast::MethodDef> LocalVarSaver::postTransformMethodDef(core::Context ctx,
-                                                                 unique_ptr<ast::MethodDef> methodDef) {
+void LocalVarSaver::postTransformMethodDef(core::Context ctx, const ast::MethodDef &methodDef) {
     // Check args.
-    for (auto &arg : methodDef->args) {
+    for (auto &arg : methodDef.args) {
         // nullptrs should never happen, but guard against it anyway.
         if (auto *localExp = ast::MK::arg2Local(arg.get())) {
-            bool lspQueryMatch = ctx.state.lspQuery.matchesVar(methodDef->symbol, localExp->localVariable);
+            bool lspQueryMatch = ctx.state.lspQuery.matchesVar(methodDef.symbol, localExp->localVariable);
             if (lspQueryMatch) {
                 // (Ditto)
                 core::TypeAndOrigins tp;
                 core::lsp::QueryResponse::pushQueryResponse(
-                    ctx, core::lsp::IdentResponse(methodDef->symbol, localExp->loc, localExp->localVariable, tp));
+                    ctx, core::lsp::IdentResponse(methodDef.symbol, localExp->loc, localExp->localVariable, tp));
             }
         }
     }
-
-    return methodDef;
 }
 } // namespace sorbet::realmain::lsp
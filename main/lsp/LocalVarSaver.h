@@ -9,9 +9,8 @@ namespace sorbet::realmain::lsp {
 
 class LocalVarSaver {
 public:
-    std::unique_ptr<ast::Local> postTransformLocal(core::Context ctx, std::unique_ptr<ast::Local> local);
-    std::unique_ptr<ast::MethodDef> postTransformMethodDef(core::Context ctx,
-                                                           std::unique_ptr<ast::MethodDef> methodDef);
+    void postTransformLocal(core::Context ctx, const ast::Local &local);
+    void postTransformMethodDef(core::Context ctx, const ast::MethodDef &methodDef);
 };
 }; // namespace sorbet::realmain::lsp
 
@@ -80,10 +80,21 @@ InvalidTypeError::InvalidTypeError(string_view fieldName, string_view expectedTy
 
 const std::string JSONBaseType::defaultFieldName = "root";
 
-string JSONBaseType::toJSON(bool prettyPrint) const {
-    rapidjson::MemoryPoolAllocator<> alloc;
-    auto v = toJSONValue(alloc);
-    rapidjson::StringBuffer buffer;
+namespace {
+// One arena and output buffer per thread, reused across calls: publishing diagnostics after a
+// slow path renders tens of thousands of messages back to back, and reallocating fresh chunks
+// for each dwarfed the writer itself. Safe to share because the generated toJSONValue
+// implementations only recurse through toJSONValue with the caller's allocator; nothing
+// re-enters toJSON mid-render on the same thread. Clear() keeps the initial chunk and the
+// buffer's capacity, so steady-state rendering does not touch malloc at all.
+string_view renderJSON(const JSONBaseType &obj, bool prettyPrint) {
+    static thread_local char initialChunk[1 << 16];
+    static thread_local rapidjson::MemoryPoolAllocator<> alloc(initialChunk, sizeof(initialChunk));
+    static thread_local rapidjson::StringBuffer buffer;
+    alloc.Clear();
+    buffer.Clear();
+
+    auto v = obj.toJSONValue(alloc);
     if (!prettyPrint) {
         rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
         v->Accept(writer);
@@ -91,7 +102,16 @@ string JSONBaseType::toJSON(bool prettyPrint) const {
         rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
         v->Accept(writer);
     }
-    return buffer.GetString();
+    return string_view(buffer.GetString(), buffer.GetSize());
+}
+} // namespace
+
+string JSONBaseType::toJSON(bool prettyPrint) const {
+    return string(renderJSON(*this, prettyPrint));
+}
+
+string_view JSONBaseType::toJSONView() const {
+    return renderJSON(*this, false);
 }
 
 // Object-specific helpers
@@ -98,6 +98,14 @@ public:
      */
     std::string toJSON(bool prettyPrint = false) const;
 
+    /**
+     * Like toJSON, but returns a view into a thread-local render buffer instead of copying into a
+     * fresh string. The view is valid until the next toJSON/toJSONView call on this thread; use it
+     * when the serialized bytes are written out immediately (e.g. straight to the LSP output
+     * stream).
+     */
+    std::string_view toJSONView() const;
+
     /**
      * Converts C++ object into a RapidJSON JSON value owned by the given rapidjson allocator.
      */
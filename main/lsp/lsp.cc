@@ -1,20 +1,28 @@
 #include "main/lsp/lsp.h"
 #include "common/Timer.h"
+#include "common/concurrency/ConcurrentQueue.h"
 #include "common/statsd/statsd.h"
 #include "common/typecase.h"
 #include "common/web_tracer_framework/tracing.h"
 #include "core/errors/internal.h"
 #include "core/errors/namer.h"
 #include "core/errors/resolver.h"
+#include "main/pipeline/pipeline.h"
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 using namespace std;
 
 namespace sorbet::realmain::lsp {
 
+// Flight-recorder cap on per-thread timing events between flushes; see setMaxRetainedTimings.
+constexpr size_t MAX_RETAINED_TIMINGS = 4096;
+
 LSPLoop::LSPLoop(unique_ptr<core::GlobalState> gs, const options::Options &opts, const shared_ptr<spd::logger> &logger,
                  WorkerPool &workers, int inputFd, std::ostream &outputStream, bool skipConfigatron,
-                 bool disableFastPath)
-    : initialGS(std::move(gs)), opts(opts), logger(logger), workers(workers), inputFd(inputFd),
+                 bool disableFastPath, unique_ptr<KeyValueStore> kvstore)
+    : initialGS(std::move(gs)), opts(opts), kvstore(move(kvstore)), logger(logger), workers(workers), inputFd(inputFd),
       outputStream(outputStream), skipConfigatron(skipConfigatron), disableFastPath(disableFastPath),
       lastMetricUpdateTime(chrono::steady_clock::now()) {
     errorQueue = dynamic_pointer_cast<core::ErrorQueue>(initialGS->errorQueue);
@@ -27,6 +35,112 @@ LSPLoop::LSPLoop(unique_ptr<core::GlobalState> gs, const options::Options &opts,
         throw options::EarlyReturnWithCode(1);
     }
     rootPath = opts.rawInputDirNames.at(0);
+
+    if (!opts.webTraceFile.empty()) {
+        // The server can run for days; cap per-thread timing retention so tracing stays on without
+        // unbounded memory growth between statsd flushes.
+        setMaxRetainedTimings(MAX_RETAINED_TIMINGS);
+    }
+
+    if (!opts.statsdHost.empty()) {
+        statsdExporter = make_unique<StatsDExporter>(opts.statsdHost, opts.statsdPort,
+                                                     fmt::format("{}.lsp.counters", opts.statsdPrefix), logger);
+    }
+}
+
+void LSPLoop::performIdleMaintenance() {
+    Timer timeit(logger, "performIdleMaintenance");
+    prodCounterInc("lsp.idle_maintenance.runs");
+
+    // These caches are pure memoization: dropping them costs a recompute on the next query but
+    // frees every resolved tree, query response and outline accumulated since the last typecheck.
+    size_t locQueryEntries = 0;
+    for (auto &entry : locQueryCache) {
+        locQueryEntries += entry.second.size();
+    }
+    size_t queryTreeEntries = queryTreeCache.size();
+    prodCounterAdd("lsp.idle_maintenance.loc_queries_dropped", locQueryEntries);
+    prodCounterAdd("lsp.idle_maintenance.query_trees_dropped", queryTreeEntries);
+    prodCounterAdd("lsp.idle_maintenance.document_symbols_dropped", documentSymbolCache.size());
+    prodCounterAdd("lsp.idle_maintenance.symbol_index_trigrams_dropped", workspaceSymbolsIndex.trigrams.size());
+    locQueryCache.clear();
+    queryTreeCache.clear();
+    documentSymbolCache.clear();
+    workspaceSymbolsIndex.valid = false;
+    workspaceSymbolsIndex.trigrams.clear();
+
+#if defined(__GLIBC__) && defined(__GLIBC_PREREQ)
+#if __GLIBC_PREREQ(2, 33)
+    // Hand freed arena slack back to the OS and report how much actually left the process. With a
+    // non-glibc allocator (e.g. jemalloc) this walks empty glibc arenas and is a harmless no-op.
+    auto before = mallinfo2().fordblks;
+    malloc_trim(0);
+    auto after = mallinfo2().fordblks;
+    if (before > after) {
+        prodCounterAdd("lsp.idle_maintenance.bytes_released", before - after);
+    }
+#else
+    malloc_trim(0);
+#endif
+#endif
+    logger->debug("Idle maintenance dropped {} cached query replies and {} cached query trees", locQueryEntries,
+                  queryTreeEntries);
+}
+
+void LSPLoop::preloadLikelyNextFiles() {
+    auto seed = speculationSeed;
+    if (!initialized || !seed.exists() || seed == speculationSeedPreloaded ||
+        seed.id() >= globalStateHashes.size()) {
+        return;
+    }
+    speculationSeedPreloaded = seed;
+
+    // The constants a file mentions are its imports in all but name; the files sharing those
+    // mentions (including the defining files, since definition names are collected as constant
+    // usages) are where the next didOpen or definition hop most plausibly lands. Only files whose
+    // tree was dropped after the initial typecheck need any work: everything else is already warm.
+    constexpr size_t maxPreloadedFiles = 64;
+    vector<core::FileRef> candidates;
+    UnorderedSet<core::FileRef> seen;
+    for (auto &nameHash : globalStateHashes[seed.id()].usages.constants) {
+        auto it = filesByConstantHash.find(nameHash);
+        if (it == filesByConstantHash.end()) {
+            continue;
+        }
+        for (auto ref : it->second) {
+            if (ref == seed || !ref.exists() || ref.id() >= indexed.size()) {
+                continue;
+            }
+            auto &entry = indexed[ref.id()];
+            if (!entry.file.exists() || entry.tree != nullptr) {
+                continue;
+            }
+            if (seen.insert(ref).second) {
+                candidates.emplace_back(ref);
+            }
+        }
+        if (candidates.size() >= maxPreloadedFiles) {
+            candidates.resize(maxPreloadedFiles);
+            break;
+        }
+    }
+    if (candidates.empty()) {
+        return;
+    }
+
+    Timer timeit(logger, "preloadLikelyNextFiles");
+    prodCounterAdd("lsp.speculative_preload.files", candidates.size());
+    logger->debug("Speculatively pre-parsing {} files near {}", candidates.size(), seed.data(*initialGS).path());
+    unique_ptr<KeyValueStore> noKvstore; // the cache handle was committed at startup
+    for (auto &tree : pipeline::index(initialGS, move(candidates), opts, workers, noKvstore)) {
+        const int id = tree.file.id();
+        if (id >= 0 && id < indexed.size()) {
+            indexed[id] = move(tree);
+        }
+    }
+    // Drop any indexing errors: the files' diagnostics were published when they were last
+    // typechecked, and this pass must be invisible to the client.
+    errorQueue->drainWithQueryResponses();
 }
 
 LSPLoop::QueryRun LSPLoop::setupLSPQueryByLoc(unique_ptr<core::GlobalState> gs, string_view uri, const Position &pos,
@@ -39,6 +153,8 @@ LSPLoop::QueryRun LSPLoop::setupLSPQueryByLoc(unique_ptr<core::GlobalState> gs,
             fmt::format("Did not find file at uri {} in {}", uri, convertLSPMethodToString(forMethod)));
         return LSPLoop::QueryRun{move(gs), {}, move(error)};
     }
+    // This file is where the user is working; remember it as the seed for speculative pre-parsing.
+    speculationSeed = fref;
 
     if (errorIfFileIsUntyped && fref.data(*gs).strictLevel < core::StrictLevel::True) {
         logger->info("Ignoring request on untyped file `{}`", uri);
@@ -54,29 +170,57 @@ LSPLoop::QueryRun LSPLoop::setupLSPQueryByLoc(unique_ptr<core::GlobalState> gs,
         return LSPLoop::QueryRun{move(gs), {}, move(error)};
     }
 
-    return runQuery(move(gs), core::lsp::Query::createLocQuery(*loc.get()), {fref});
+    // Hovering over the same expression re-sends the same position over and over; serve identical
+    // repeats from the cache rather than retypechecking the file. Entries are keyed by exact byte
+    // offset: widening them to the responding term's range would be wrong, since a narrower term
+    // inside it (hovering `bar` vs `foo` in `foo(bar)`) answers differently.
+    auto offset = loc->beginPos();
+    auto cacheIt = locQueryCache.find(fref);
+    if (cacheIt != locQueryCache.end()) {
+        auto entryIt = cacheIt->second.find(offset);
+        if (entryIt != cacheIt->second.end()) {
+            prodCounterInc("lsp.loc_query_cache.hit");
+            QueryRun run{move(gs), {}};
+            run.responses.reserve(entryIt->second.size());
+            for (auto &resp : entryIt->second) {
+                run.responses.emplace_back(make_unique<core::lsp::QueryResponse>(*resp));
+            }
+            return run;
+        }
+    }
+    prodCounterInc("lsp.loc_query_cache.miss");
+
+    auto run = runQuery(move(gs), core::lsp::Query::createLocQuery(*loc.get()), {fref});
+    if (run.error == nullptr) {
+        auto &cached = locQueryCache[fref][offset];
+        cached.reserve(run.responses.size());
+        for (auto &resp : run.responses) {
+            cached.emplace_back(make_unique<core::lsp::QueryResponse>(*resp));
+        }
+    }
+    return run;
 }
 
 LSPLoop::QueryRun LSPLoop::setupLSPQueryBySymbol(unique_ptr<core::GlobalState> gs, core::SymbolRef sym) const {
     Timer timeit(logger, "setupLSPQueryBySymbol");
     ENFORCE(sym.exists());
     vector<core::FileRef> frefs;
-    const core::NameHash symNameHash(*gs, sym.data(*gs)->name.data(*gs));
+    const core::NameHash symNameHash(*gs, sym.data(*gs)->name);
     // Locate files that contain the same Name as the symbol. Is an overapproximation, but a good first filter.
-    int i = -1;
-    for (auto &hash : globalStateHashes) {
-        i++;
-        const auto &usedSends = hash.usages.sends;
-        const auto &usedConstants = hash.usages.constants;
-        auto ref = core::FileRef(i);
-
-        const bool fileIsValid = ref.exists() && ref.data(*gs).sourceType == core::File::Type::Normal;
-        if (fileIsValid &&
-            (std::find(usedSends.begin(), usedSends.end(), symNameHash) != usedSends.end() ||
-             std::find(usedConstants.begin(), usedConstants.end(), symNameHash) != usedConstants.end())) {
-            frefs.emplace_back(ref);
+    for (const auto *index : {&filesBySendHash, &filesByConstantHash}) {
+        auto it = index->find(symNameHash);
+        if (it == index->end()) {
+            continue;
+        }
+        for (auto ref : it->second) {
+            if (ref.exists() && ref.data(*gs).sourceType == core::File::Type::Normal) {
+                frefs.emplace_back(ref);
+            }
         }
     }
+    // A file mentioning the name in both a send and a constant appears in both indexes.
+    fast_sort(frefs);
+    frefs.resize(std::distance(frefs.begin(), std::unique(frefs.begin(), frefs.end())));
 
     return runQuery(move(gs), core::lsp::Query::createSymbolQuery(sym), frefs);
 }
@@ -144,8 +288,32 @@ LSPResult LSPLoop::pushDiagnostics(TypecheckRun run) {
 
     this->filesThatHaveErrors = errorFilesInNewRun;
 
-    for (auto file : filesToUpdateErrorListFor) {
-        if (file.exists()) {
+    // Converting errors to Diagnostics and rendering each publish notification to JSON is pure
+    // string work against a read-only GlobalState, and after a slow path it can span tens of
+    // thousands of errors, so fan it out across the pool. Workers pre-render each message's JSON
+    // (sendMessage then only writes bytes on the main thread), and slots are reassembled by index
+    // below so the client still sees publishes in file order.
+    const int numFiles = filesToUpdateErrorListFor.size();
+    auto fileq = make_shared<ConcurrentBoundedQueue<int>>(numFiles);
+    for (int i = 0; i < numFiles; i++) {
+        fileq->push(int(i), 1);
+    }
+    typedef vector<pair<int, unique_ptr<LSPMessage>>> DiagnosticsMessages;
+    auto resultq = make_shared<BlockingBoundedQueue<DiagnosticsMessages>>(numFiles);
+    const auto &filesToUpdate = filesToUpdateErrorListFor;
+    workers.multiplexJob("publishDiagnostics", [this, &gs, &filesToUpdate, &errorsAccumulated, fileq, resultq]() {
+        DiagnosticsMessages threadResult;
+        int processed = 0;
+        int idx;
+        for (auto result = fileq->try_pop(idx); !result.done(); result = fileq->try_pop(idx)) {
+            if (!result.gotItem()) {
+                continue;
+            }
+            processed++;
+            auto file = filesToUpdate[idx];
+            if (!file.exists()) {
+                continue;
+            }
             string uri;
             { // uri
                 if (file.data(gs).sourceType == core::File::Type::Payload) {
@@ -158,8 +326,9 @@ LSPResult LSPLoop::pushDiagnostics(TypecheckRun run) {
             vector<unique_ptr<Diagnostic>> diagnostics;
             {
                 // diagnostics
-                if (errorsAccumulated.find(file) != errorsAccumulated.end()) {
-                    for (auto &e : errorsAccumulated[file]) {
+                auto errorsForFile = errorsAccumulated.find(file);
+                if (errorsForFile != errorsAccumulated.end()) {
+                    for (auto &e : errorsForFile->second) {
                         auto range = Range::fromLoc(gs, e->loc);
                         if (range == nullptr) {
                             continue;
@@ -201,15 +370,43 @@ LSPResult LSPLoop::pushDiagnostics(TypecheckRun run) {
                 }
             }
 
-            responses.push_back(make_unique<LSPMessage>(
+            auto msg = make_unique<LSPMessage>(
                 make_unique<NotificationMessage>("2.0", LSPMethod::TextDocumentPublishDiagnostics,
-                                                 make_unique<PublishDiagnosticsParams>(uri, move(diagnostics)))));
+                                                 make_unique<PublishDiagnosticsParams>(uri, move(diagnostics))));
+            msg->cachedJSON = msg->toJSON();
+            threadResult.emplace_back(idx, move(msg));
+        }
+        // The drain below waits until pushed counts cover every file, so count skipped
+        // (nonexistent) files too, not just the ones that produced a message.
+        if (processed > 0) {
+            resultq->push(move(threadResult), processed);
+        }
+    });
+
+    vector<unique_ptr<LSPMessage>> orderedMessages(numFiles);
+    {
+        DiagnosticsMessages threadResult;
+        for (auto result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), gs.tracer());
+             !result.done();
+             result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), gs.tracer())) {
+            if (result.gotItem()) {
+                for (auto &entry : threadResult) {
+                    orderedMessages[entry.first] = move(entry.second);
+                }
+            }
+        }
+    }
+    for (auto &msg : orderedMessages) {
+        if (msg != nullptr) {
+            responses.push_back(move(msg));
         }
     }
     return LSPResult{move(run.gs), move(responses)};
 }
 
 constexpr chrono::minutes STATSD_INTERVAL = chrono::minutes(5);
+// Restart the chrome-trace file once it grows past this size; see Tracing::storeTraces.
+constexpr size_t MAX_TRACE_FILE_SIZE = 128 * 1024 * 1024;
 
 bool LSPLoop::shouldSendCountersToStatsd(chrono::time_point<chrono::steady_clock> currentTime) const {
     return !opts.statsdHost.empty() && (currentTime - lastMetricUpdateTime) > STATSD_INTERVAL;
@@ -220,14 +417,14 @@ void LSPLoop::sendCountersToStatsd(chrono::time_point<chrono::steady_clock> curr
     // Record rusage-related stats.
     StatsD::addRusageStats();
     auto counters = getAndClearThreadCounters();
-    if (!opts.statsdHost.empty()) {
-        lastMetricUpdateTime = currentTime;
-
-        auto prefix = fmt::format("{}.lsp.counters", opts.statsdPrefix);
-        StatsD::submitCounters(counters, opts.statsdHost, opts.statsdPort, prefix);
-    }
     if (!opts.webTraceFile.empty()) {
-        web_tracer_framework::Tracing::storeTraces(counters, opts.webTraceFile);
+        web_tracer_framework::Tracing::storeTraces(counters, opts.webTraceFile, MAX_TRACE_FILE_SIZE);
+    }
+    if (statsdExporter != nullptr) {
+        lastMetricUpdateTime = currentTime;
+        // The exporter sends from its own thread; a slow or unreachable statsd host never stalls
+        // the loop whose latency these metrics measure.
+        statsdExporter->submit(move(counters));
     }
 }
 
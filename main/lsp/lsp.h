@@ -4,11 +4,13 @@
 #include "ast/ast.h"
 #include "common/concurrency/WorkerPool.h"
 #include "common/kvstore/KeyValueStore.h"
+#include "common/statsd/statsd.h"
 #include "core/ErrorQueue.h"
 #include "core/NameHash.h"
 #include "core/core.h"
 #include "main/lsp/LSPMessage.h"
 #include "main/options/options.h"
+#include <atomic>
 #include <chrono>
 #include <deque>
 #include <optional>
@@ -59,6 +61,8 @@ class LSPLoop {
         bool paused = false;
         int requestCounter = 0;
         int errorCode = 0;
+        /** When the most recent file update was enqueued; used to debounce bursts of edits. */
+        std::chrono::steady_clock::time_point lastEditArrival;
         // Counters collected from worker threads.
         CounterState counters;
     };
@@ -95,8 +99,60 @@ class LSPLoop {
     UnorderedMap<int, ast::ParsedFile> indexedFinalGS;
     /** Hashes of global states obtained by resolving every file in isolation. Used for fastpath. */
     std::vector<core::FileHash> globalStateHashes;
+    /** Inverted indexes over the usage hashes in globalStateHashes: map a name hash to the files
+     * whose sends (or constant references) mention it. Built alongside the state hashes and patched
+     * as per-file hashes are replaced, they turn the candidate-file scans in setupLSPQueryBySymbol
+     * and the fast path into hash probes instead of walks over every file. */
+    UnorderedMap<core::NameHash, std::vector<core::FileRef>> filesBySendHash;
+    UnorderedMap<core::NameHash, std::vector<core::FileRef>> filesByConstantHash;
+    /** Replies to earlier location queries (hover/definition/completion setup), keyed by file and
+     * byte offset. Editors re-request hover for the same position many times with no intervening
+     * edit, and each request otherwise costs a typecheck of the file; identical repeats are served
+     * from here instead. commitTypecheckRun drops a file's entries whenever it is retypechecked.
+     * Mutable because it is filled in from the const query paths. */
+    mutable UnorderedMap<core::FileRef, UnorderedMap<u4, std::vector<std::unique_ptr<core::lsp::QueryResponse>>>>
+        locQueryCache;
+    /** Resolved (and flattened) trees left behind by earlier query runs, keyed by file id. A query
+     * otherwise deep-copies the indexed tree and re-runs incrementalResolve every time; between
+     * edits the result is identical, so batched queries against the same file reuse it from here.
+     * Cleared on every commitTypecheckRun because the trees bake in symbol ids of the committed
+     * state. Mutable because it is maintained from the const query path. */
+    mutable UnorderedMap<int, ast::ParsedFile> queryTreeCache;
+    struct DocumentSymbolCacheEntry {
+        /** Folded view of FileHash::definitions (hierarchy plus method and method-shape hashes)
+         * current when the outline was built. */
+        u4 definitionsKey;
+        std::vector<std::unique_ptr<DocumentSymbol>> symbols;
+    };
+    /** documentSymbol outlines keyed by file. Editors re-request the outline on every edit, but it
+     * only changes when the file's definitions do; entries are validated against the file's
+     * definition hashes at lookup, so body-only edits replay a deep copy of the cached outline
+     * instead of walking the whole symbol table. Mutable because it is maintained from the const
+     * request path. */
+    mutable UnorderedMap<core::FileRef, DocumentSymbolCacheEntry> documentSymbolCache;
+    struct WorkspaceSymbolsIndex {
+        bool valid = false;
+        /** Packed trigram of a symbol's short name (three bytes) -> ascending ids of the symbols
+         * whose short name contains it. */
+        UnorderedMap<u4, std::vector<u4>> trigrams;
+    };
+    /** Trigram index over symbol short names serving workspace/symbol queries, which arrive once
+     * per keystroke in the symbol picker. Built lazily on the first query after an edit commits
+     * (symbol ids are rewritten by slow paths, so patching entries in place has nothing stable to
+     * patch) and invalidated in commitTypecheckRun. Mutable because it is maintained from the
+     * const request path. */
+    mutable WorkspaceSymbolsIndex workspaceSymbolsIndex;
+    /** The file behind the most recent location query or didOpen: the seed for speculative
+     * pre-parsing when the request queue drains. Mutable because the const query paths record it. */
+    mutable core::FileRef speculationSeed;
+    /** Seed the last speculative pre-parse ran for, so an unchanged seed doesn't rescan the usage
+     * indexes every time the queue empties. */
+    core::FileRef speculationSeedPreloaded;
     /** List of files that have had errors in last run*/
     std::vector<core::FileRef> filesThatHaveErrors;
+    /** Set by the message-intake threads when an edit arrives while a typecheck run is in flight;
+     * polled by the slow path so it can yield to the superseding edit. */
+    mutable std::atomic<bool> supersedingEditArrived{false};
     /** Root of LSP client workspace */
     std::string rootUri;
     /** File system root of LSP client workspace. May be empty if it is the current working directory. */
@@ -113,7 +169,11 @@ class LSPLoop {
      */
     std::unique_ptr<core::GlobalState> initialGS;
     const options::Options &opts;
-    std::unique_ptr<KeyValueStore> kvstore; // always null for now.
+    /** On-disk cache handle, if --cache-dir was given. Consumed (handed to the background commit
+     * thread) once the initial index has retained its state; null from then on. */
+    std::unique_ptr<KeyValueStore> kvstore;
+    /** Joins the background cache-commit thread when the loop is destroyed. */
+    std::unique_ptr<Joinable> kvstoreCommit;
     std::shared_ptr<spdlog::logger> logger;
     WorkerPool &workers;
     /**
@@ -156,6 +216,8 @@ class LSPLoop {
      * The time that LSP last sent metrics to statsd -- if `opts.statsdHost` was specified.
      */
     std::chrono::time_point<std::chrono::steady_clock> lastMetricUpdateTime;
+    /** Ships counter snapshots to statsd off the main loop; null when statsd reporting is disabled. */
+    std::unique_ptr<StatsDExporter> statsdExporter;
     /** ID of the main thread, which actually processes LSP requests and performs typechecking. */
     std::thread::id mainThreadId;
 
@@ -173,6 +235,14 @@ class LSPLoop {
     /** Invalidate all currently cached trees and re-index them from file system.
      * This runs code that is not considered performance critical and this is expected to be slow */
     void reIndexFromFileSystem();
+    /** Runs after the server has sat idle for opts.lspIdleMaintenanceSeconds: drops rebuildable
+     * caches and returns freed allocator slack to the OS, so a long-lived server's footprint tracks
+     * its live state instead of its high-water mark. */
+    void performIdleMaintenance();
+    /** Runs when the request queue drains: pre-parses files the usage indexes connect to the most
+     * recently active file, so a didOpen or definition hop into one of them finds a warm tree
+     * instead of paying a parse on the request's critical path. */
+    void preloadLikelyNextFiles();
     struct TypecheckRun {
         std::vector<std::unique_ptr<core::Error>> errors;
         std::vector<core::FileRef> filesTypechecked;
@@ -181,6 +251,9 @@ class LSPLoop {
         // The edit applied to `gs`.
         LSPLoop::FileUpdates updates;
         bool tookFastPath = false;
+        // True when the run yielded to a superseding edit before typechecking every file; its
+        // diagnostics are incomplete and must not be pushed to the client.
+        bool canceled = false;
     };
     struct QueryRun {
         std::unique_ptr<core::GlobalState> gs;
@@ -193,6 +266,8 @@ class LSPLoop {
     TypecheckRun runSlowPath(FileUpdates updates) const;
     /** Returns `true` if the given changes can run on the fast path. */
     bool canTakeFastPath(const FileUpdates &updates, const std::vector<core::FileHash> &hashes) const;
+    /** True when some file other than `edited` records a send or constant usage of `nameHash`. */
+    bool nameUsedOutsideFile(core::NameHash nameHash, core::FileRef edited) const;
     /** Applies conservative heuristics to see if we can run incremental typechecking on the update. If not, it bails
      * out and takes slow path. */
     TypecheckRun runTypechecking(std::unique_ptr<core::GlobalState> gs, FileUpdates updates) const;
@@ -205,6 +280,11 @@ class LSPLoop {
     LSPResult pushDiagnostics(TypecheckRun run);
 
     std::vector<core::FileHash> computeStateHashes(const std::vector<std::shared_ptr<core::File>> &files) const;
+    /** Replaces `fref`'s entries in filesBySendHash/filesByConstantHash: drops the usages recorded
+     * under `oldHash` and records those in `newHash`. */
+    void updateUsageIndexes(core::FileRef fref, const core::FileHash &oldHash, const core::FileHash &newHash);
+    /** Rebuilds filesBySendHash/filesByConstantHash from scratch to match globalStateHashes. */
+    void rebuildUsageIndexes();
     bool ensureInitialized(const LSPMethod forMethod, const LSPMessage &msg,
                            const std::unique_ptr<core::GlobalState> &currentGs) const;
 
@@ -218,6 +298,7 @@ class LSPLoop {
      * Returns `nullptr` if symbol kind is not supported by LSP
      * */
     std::unique_ptr<SymbolInformation> symbolRef2SymbolInformation(const core::GlobalState &gs, core::SymbolRef) const;
+    void buildWorkspaceSymbolsIndex(const core::GlobalState &gs) const;
     LSPLoop::QueryRun setupLSPQueryByLoc(std::unique_ptr<core::GlobalState> gs, std::string_view uri,
                                          const Position &pos, const LSPMethod forMethod,
                                          bool errorIfFileIsUntyped = true) const;
@@ -253,7 +334,8 @@ class LSPLoop {
      * If `collectThreadCounters` is `true`, it also merges in thread-local counters into the QueueState counters.
      */
     static void enqueueRequest(const std::shared_ptr<spd::logger> &logger, LSPLoop::QueueState &state,
-                               std::unique_ptr<LSPMessage> msg, bool collectThreadCounters = false);
+                               std::unique_ptr<LSPMessage> msg, bool collectThreadCounters = false,
+                               std::atomic<bool> *editArrivedSignal = nullptr);
 
     LSPResult processRequestInternal(std::unique_ptr<core::GlobalState> gs, const LSPMessage &msg);
 
@@ -294,7 +376,8 @@ class LSPLoop {
 public:
     LSPLoop(std::unique_ptr<core::GlobalState> gs, const options::Options &opts,
             const std::shared_ptr<spd::logger> &logger, WorkerPool &workers, int inputFd, std::ostream &output,
-            bool skipConfigatron = false, bool disableFastPath = false);
+            bool skipConfigatron = false, bool disableFastPath = false,
+            std::unique_ptr<KeyValueStore> kvstore = nullptr);
     std::unique_ptr<core::GlobalState> runLSP();
     LSPResult processRequest(std::unique_ptr<core::GlobalState> gs, const LSPMessage &msg);
     LSPResult processRequest(std::unique_ptr<core::GlobalState> gs, const std::string &json);
@@ -4,6 +4,7 @@
 #include "common/Timer.h"
 #include "common/web_tracer_framework/tracing.h"
 #include "lsp.h"
+#include "main/lsp/watcher/NativeFileWatcher.h"
 #include "main/lsp/watchman/WatchmanProcess.h"
 #include "main/options/options.h" // For EarlyReturnWithCode.
 #include <iostream>
@@ -100,40 +101,74 @@ public:
     }
 };
 
+/**
+ * Returns true for queued messages that carry file updates from the file watcher. These are
+ * debounced before processing: a git branch switch can deliver thousands of Watchman events, and
+ * briefly holding the head of the queue lets enqueueRequest merge the burst so the slow path runs
+ * once over the final state instead of once per intermediate state.
+ */
+bool isWatchmanEdit(const LSPMessage &msg) {
+    if (msg.method() == LSPMethod::SorbetWatchmanFileChange) {
+        return true;
+    }
+    if (msg.method() == LSPMethod::SorbetWorkspaceEdit) {
+        auto &editParams = get<unique_ptr<SorbetWorkspaceEditParams>>(msg.asNotification().params);
+        return editParams->counts->sorbetWatchmanFileChange > 0;
+    }
+    return false;
+}
+
 unique_ptr<core::GlobalState> LSPLoop::runLSP() {
     // Naming convention: thread that executes this function is called coordinator thread
     LSPLoop::QueueState guardedState{{}, false, false, 0};
     absl::Mutex mtx;
     absl::Notification initializedNotification;
+    // Raw pointer so the intake lambdas below can signal in-flight typechecks without capturing
+    // `this`.
+    std::atomic<bool> *editArrivedSignal = &this->supersedingEditArrived;
 
     unique_ptr<watchman::WatchmanProcess> watchmanProcess;
+    unique_ptr<watcher::NativeFileWatcher> nativeFileWatcher;
     if (!opts.disableWatchman) {
         if (opts.rawInputDirNames.size() == 1 && opts.rawInputFileNames.empty()) {
-            // The lambda below intentionally does not capture `this`.
-            watchmanProcess = make_unique<watchman::WatchmanProcess>(
-                logger, opts.watchmanPath, opts.rawInputDirNames.at(0), vector<string>({"rb", "rbi"}),
-                [&guardedState, &mtx, logger = this->logger,
-                 &initializedNotification](std::unique_ptr<WatchmanQueryResponse> response) {
-                    auto notifMsg =
-                        make_unique<NotificationMessage>("2.0", LSPMethod::SorbetWatchmanFileChange, move(response));
-                    auto msg = make_unique<LSPMessage>(move(notifMsg));
-                    // Don't start enqueueing requests until LSP is initialized.
-                    initializedNotification.WaitForNotification();
-                    {
-                        absl::MutexLock lck(&mtx); // guards guardedState
-                        // Merge with any existing pending watchman file updates.
-                        enqueueRequest(logger, guardedState, move(msg), true);
-                    }
-                },
-                [&guardedState, &mtx](int watchmanExitCode) {
-                    {
-                        absl::MutexLock lck(&mtx); // guards guardedState
-                        if (!guardedState.terminate) {
-                            guardedState.terminate = true;
-                            guardedState.errorCode = watchmanExitCode;
-                        }
+            // The lambdas below intentionally do not capture `this`. Both watcher implementations push the
+            // same WatchmanQueryResponse-shaped updates.
+            auto processUpdate = [&guardedState, &mtx, logger = this->logger, editArrivedSignal,
+                                  &initializedNotification](std::unique_ptr<WatchmanQueryResponse> response) {
+                auto notifMsg =
+                    make_unique<NotificationMessage>("2.0", LSPMethod::SorbetWatchmanFileChange, move(response));
+                auto msg = make_unique<LSPMessage>(move(notifMsg));
+                // Don't start enqueueing requests until LSP is initialized.
+                initializedNotification.WaitForNotification();
+                {
+                    absl::MutexLock lck(&mtx); // guards guardedState
+                    // Merge with any existing pending watchman file updates.
+                    enqueueRequest(logger, guardedState, move(msg), true, editArrivedSignal);
+                }
+            };
+            auto processExit = [&guardedState, &mtx](int watcherExitCode) {
+                {
+                    absl::MutexLock lck(&mtx); // guards guardedState
+                    if (!guardedState.terminate) {
+                        guardedState.terminate = true;
+                        guardedState.errorCode = watcherExitCode;
                     }
-                });
+                }
+            };
+            if (opts.nativeWatcher) {
+                if (!watcher::NativeFileWatcher::isSupported()) {
+                    logger->error("--native-watcher is not supported on this platform. Remove the flag to watch files "
+                                  "with Watchman, or run Sorbet with `--disable-watchman`.");
+                    throw options::EarlyReturnWithCode(1);
+                }
+                nativeFileWatcher = make_unique<watcher::NativeFileWatcher>(
+                    logger, opts.rawInputDirNames.at(0), vector<string>({"rb", "rbi"}), move(processUpdate),
+                    move(processExit));
+            } else {
+                watchmanProcess = make_unique<watchman::WatchmanProcess>(
+                    logger, opts.watchmanPath, opts.rawInputDirNames.at(0), vector<string>({"rb", "rbi"}),
+                    move(processUpdate), move(processExit));
+            }
         } else {
             logger->error("Watchman support currently only works when Sorbet is run with a single input directory. If "
                           "Watchman is not needed, run Sorbet with `--disable-watchman`.");
@@ -142,7 +177,8 @@ unique_ptr<core::GlobalState> LSPLoop::runLSP() {
     }
 
     auto readerThread =
-        runInAThread("lspReader", [&guardedState, &mtx, logger = this->logger, inputFd = this->inputFd] {
+        runInAThread("lspReader", [&guardedState, &mtx, logger = this->logger, inputFd = this->inputFd,
+                                   editArrivedSignal] {
             // Thread that executes this lambda is called reader thread.
             // This thread _intentionally_ does not capture `this`.
             NotifyOnDestruction notify(mtx, guardedState.terminate);
@@ -154,7 +190,7 @@ unique_ptr<core::GlobalState> LSPLoop::runLSP() {
                     {
                         absl::MutexLock lck(&mtx); // guards guardedState.
                         if (msg) {
-                            enqueueRequest(logger, guardedState, move(msg), true);
+                            enqueueRequest(logger, guardedState, move(msg), true, editArrivedSignal);
                             // Reset span now that we've found a request.
                             timeit = make_unique<Timer>(logger, "getNewRequest");
                         }
@@ -175,19 +211,53 @@ unique_ptr<core::GlobalState> LSPLoop::runLSP() {
     {
         // Ensure Watchman thread gets unstuck when thread exits.
         NotifyNotificationOnDestruction notify(initializedNotification);
+        // True once idle maintenance has run for the current idle stretch; reset whenever a message
+        // is processed so the next stretch gets its own pass.
+        bool ranIdleMaintenance = false;
         while (true) {
             unique_ptr<LSPMessage> msg;
             bool hasMoreMessages;
+            bool doIdleMaintenance = false;
             {
                 absl::MutexLock lck(&mtx);
                 Timer timeit(logger, "idle");
-                mtx.Await(absl::Condition(
+                const auto hasWorkOrTerminate = absl::Condition(
                     +[](LSPLoop::QueueState *guardedState) -> bool {
                         return guardedState->terminate ||
                                (!guardedState->paused && !guardedState->pendingRequests.empty());
                     },
-                    &guardedState));
-                ENFORCE(!guardedState.paused);
+                    &guardedState);
+                if (opts.lspIdleMaintenanceSeconds > 0 && initialized && !ranIdleMaintenance &&
+                    !mtx.AwaitWithTimeout(hasWorkOrTerminate, absl::Seconds(opts.lspIdleMaintenanceSeconds))) {
+                    // The queue stayed empty for the whole window; run maintenance outside the lock
+                    // so intake threads aren't blocked behind it, then come back to waiting.
+                    doIdleMaintenance = true;
+                } else {
+                    mtx.Await(hasWorkOrTerminate);
+                }
+                ENFORCE(doIdleMaintenance || !guardedState.paused);
+                if (!doIdleMaintenance && !guardedState.terminate && opts.watchmanDebounceMillis > 0 &&
+                    isWatchmanEdit(*guardedState.pendingRequests.front())) {
+                    // Debounce Watchman-driven edits (see isWatchmanEdit). Each new edit restarts
+                    // the window; the overall hold is capped so a steady stream of events cannot
+                    // postpone typechecking indefinitely.
+                    const auto debounceWindow = chrono::milliseconds(opts.watchmanDebounceMillis);
+                    const auto maxDeadline = chrono::steady_clock::now() + 10 * debounceWindow;
+                    while (!guardedState.terminate && !guardedState.pendingRequests.empty() &&
+                           isWatchmanEdit(*guardedState.pendingRequests.front())) {
+                        auto now = chrono::steady_clock::now();
+                        auto deadline = min(guardedState.lastEditArrival + debounceWindow, maxDeadline);
+                        if (now >= deadline) {
+                            break;
+                        }
+                        mtx.AwaitWithTimeout(absl::Condition(
+                                                 +[](LSPLoop::QueueState *guardedState) -> bool {
+                                                     return guardedState->terminate;
+                                                 },
+                                                 &guardedState),
+                                             absl::FromChrono(deadline - now));
+                    }
+                }
                 if (guardedState.terminate) {
                     if (guardedState.errorCode != 0) {
                         // Abnormal termination.
@@ -197,10 +267,20 @@ unique_ptr<core::GlobalState> LSPLoop::runLSP() {
                         break;
                     }
                 }
-                msg = move(guardedState.pendingRequests.front());
-                guardedState.pendingRequests.pop_front();
-                hasMoreMessages = !guardedState.pendingRequests.empty();
+                if (doIdleMaintenance) {
+                    hasMoreMessages = false;
+                } else {
+                    msg = move(guardedState.pendingRequests.front());
+                    guardedState.pendingRequests.pop_front();
+                    hasMoreMessages = !guardedState.pendingRequests.empty();
+                }
+            }
+            if (doIdleMaintenance) {
+                performIdleMaintenance();
+                ranIdleMaintenance = true;
+                continue;
             }
+            ranIdleMaintenance = false;
             prodCounterInc("lsp.messages.received");
             auto result = processRequest(move(gs), *msg);
             gs = move(result.gs);
@@ -212,6 +292,13 @@ unique_ptr<core::GlobalState> LSPLoop::runLSP() {
                 initializedNotification.Notify();
             }
 
+            if (!hasMoreMessages) {
+                // The queue drained: spend the gap pre-parsing the files the user is most likely to
+                // open next, so their first request into one lands on a warm tree. Bounded work on
+                // idle cores; new messages simply queue behind it like behind any request.
+                preloadLikelyNextFiles();
+            }
+
             auto currentTime = chrono::steady_clock::now();
             if (shouldSendCountersToStatsd(currentTime)) {
                 {
@@ -383,14 +470,53 @@ void cancelRequest(std::deque<std::unique_ptr<LSPMessage>> &pendingRequests, con
     // and ignore.
 }
 
+/**
+ * Read-only queries served from the current typechecked snapshot. These form the queue's fast
+ * lane: they may hop ahead of queued background bulk edits (see enqueueRequest), since they do not
+ * mutate state and a branch-switch storm of Watchman events can otherwise hold a hover or
+ * completion hostage for the length of a slow path.
+ */
+bool isFastLaneQuery(const LSPMethod method) {
+    switch (method) {
+        case LSPMethod::TextDocumentHover:
+        case LSPMethod::TextDocumentDefinition:
+        case LSPMethod::TextDocumentCompletion:
+        case LSPMethod::TextDocumentSignatureHelp:
+        case LSPMethod::TextDocumentReferences:
+        case LSPMethod::TextDocumentDocumentSymbol:
+        case LSPMethod::TextDocumentCodeAction:
+        case LSPMethod::WorkspaceSymbol:
+        case LSPMethod::SorbetReadFile:
+            return true;
+        default:
+            return false;
+    }
+}
+
 void LSPLoop::enqueueRequest(const shared_ptr<spd::logger> &logger, LSPLoop::QueueState &state,
-                             std::unique_ptr<LSPMessage> msg, bool collectThreadCounters) {
+                             std::unique_ptr<LSPMessage> msg, bool collectThreadCounters,
+                             std::atomic<bool> *editArrivedSignal) {
     Timer timeit(logger, "enqueueRequest");
     msg->counter = state.requestCounter++;
     msg->startTracers.push_back(timeit.getFlowEdge());
     msg->timers.push_back(make_unique<Timer>(logger, "processing_time"));
 
     const LSPMethod method = msg->method();
+    switch (method) {
+        case LSPMethod::TextDocumentDidOpen:
+        case LSPMethod::TextDocumentDidChange:
+        case LSPMethod::TextDocumentDidClose:
+        case LSPMethod::SorbetWatchmanFileChange:
+        case LSPMethod::SorbetWorkspaceEdit:
+            state.lastEditArrival = chrono::steady_clock::now();
+            if (editArrivedSignal != nullptr) {
+                // Let an in-flight slow path know its results are about to be superseded.
+                editArrivedSignal->store(true);
+            }
+            break;
+        default:
+            break;
+    }
     if (method == LSPMethod::$CancelRequest) {
         cancelRequest(state.pendingRequests, *get<unique_ptr<CancelParams>>(msg->asNotification().params));
         mergeFileChanges(state.pendingRequests);
@@ -410,7 +536,21 @@ void LSPLoop::enqueueRequest(const shared_ptr<spd::logger> &logger, LSPLoop::Que
         }
         state.pendingRequests.push_back(move(msg));
     } else {
-        state.pendingRequests.push_back(move(msg));
+        auto insertAt = state.pendingRequests.end();
+        if (isFastLaneQuery(method)) {
+            // Fast lane: queries hop ahead of queued Watchman-driven bulk edits and run against
+            // the current snapshot, so a cheap hover never waits out the slow path those edits
+            // will trigger. They deliberately do not hop over client document edits
+            // (didOpen/didChange/didClose): the query's positions refer to the document state
+            // after those edits, so reordering would answer against the wrong text.
+            while (insertAt != state.pendingRequests.begin() && isWatchmanEdit(**(insertAt - 1))) {
+                --insertAt;
+            }
+            if (insertAt != state.pendingRequests.end()) {
+                prodCounterInc("lsp.queue.fast_lane_hops");
+            }
+        }
+        state.pendingRequests.insert(insertAt, move(msg));
         mergeFileChanges(state.pendingRequests);
     }
 
@@ -456,10 +596,12 @@ void LSPLoop::sendMessage(const LSPMessage &msg) const {
     } else if (msg.isNotification()) {
         ENFORCE(isServerNotification(msg.method()));
     }
-    auto json = msg.toJSON();
-    string outResult = fmt::format("Content-Length: {}\r\n\r\n{}", json.length(), json);
+    // Render once into the thread-local buffer and hand the header and body to the stream as
+    // separate writes: a multi-MB completion or documentSymbol payload used to be copied twice on
+    // its way out (buffer -> string -> header-prefixed string).
+    auto json = msg.toJSONView();
     logger->debug("Write: {}\n", json);
-    outputStream << outResult << flush;
+    outputStream << "Content-Length: " << json.length() << "\r\n\r\n" << json << flush;
 }
 
 } // namespace sorbet::realmain::lsp
@@ -1,5 +1,7 @@
 #include "common/Timer.h"
+#include "common/web_tracer_framework/sampling.h"
 #include "lsp.h"
+#include "payload/payload.h"
 
 #include "absl/strings/match.h"
 
@@ -75,6 +77,26 @@ LSPResult LSPLoop::processRequestInternal(unique_ptr<core::GlobalState> gs, cons
             return commitTypecheckRun(
                 handleSorbetWorkspaceEdit(move(gs), *get<unique_ptr<WatchmanQueryResponse>>(params)));
         }
+        if (method == LSPMethod::SorbetSampleProfile) {
+            prodCategoryCounterInc("lsp.messages.processed", "sorbet/sampleProfile");
+            auto &sampleParams = get<unique_ptr<SorbetSampleProfileParams>>(params);
+            if (sampleParams->running) {
+                if (web_tracer_framework::SamplingProfiler::start(sampleParams->intervalMicros)) {
+                    logger->info("Started sampling profiler ({}us interval)", sampleParams->intervalMicros);
+                } else {
+                    logger->error("Could not start sampling profiler (already running, bad interval, or unsupported "
+                                  "platform)");
+                }
+            } else {
+                if (opts.webTraceFile.empty()) {
+                    logger->error("Discarding sampling profile: Sorbet was started without --web-trace-file");
+                }
+                if (web_tracer_framework::SamplingProfiler::stop(opts.webTraceFile) && !opts.webTraceFile.empty()) {
+                    logger->info("Appended sampling profile to {}", opts.webTraceFile);
+                }
+            }
+            return LSPResult{move(gs), {}};
+        }
         if (method == LSPMethod::SorbetWorkspaceEdit) {
             // Note: We increment `lsp.messages.processed` when the original requests were merged into this one.
             auto &editParams = get<unique_ptr<SorbetWorkspaceEditParams>>(params);
@@ -95,12 +117,54 @@ LSPResult LSPLoop::processRequestInternal(unique_ptr<core::GlobalState> gs, cons
             prodCategoryCounterInc("lsp.messages.processed", "initialized");
             Timer timeit(logger, "initial_index");
             reIndexFromFileSystem();
-            LSPResult result = pushDiagnostics(runSlowPath({}));
-            ENFORCE(result.gs);
             if (!disableFastPath) {
+                // Hash before the cache handle is consumed below: computeStateHashes reads and
+                // writes per-file hash entries, so a restart re-hashes only files that changed
+                // since the last session. Hashes depend on file contents alone, so hashing off
+                // initialGS gives the same answers as hashing after the slow path.
                 ShowOperation stateHashOp(*this, "GlobalStateHash", "Finishing initialization...");
-                this->globalStateHashes = computeStateHashes(result.gs->getFiles());
+                this->globalStateHashes = computeStateHashes(initialGS->getFiles());
+                rebuildUsageIndexes();
+            }
+            // Retain the state and trees just built (reIndexFromFileSystem reads and writes the
+            // per-file tree cache) so the next cold start -- e.g. the restart a payload update
+            // forces, since the payload is baked into the binary -- warms from the cache instead
+            // of re-running loadGlobalState and a full index. The commit runs on a background
+            // thread while the server keeps serving, and joins when the loop is destroyed.
+            kvstoreCommit = payload::retainGlobalState(initialGS, opts, kvstore);
+            if (kvstore != nullptr) {
+                // retainGlobalState skips the commit when the global state itself came from the
+                // cache, but the index and hashing may still have written fresh entries.
+                kvstoreCommit = KeyValueStore::commitInBackground(move(kvstore));
+            }
+            LSPResult result = pushDiagnostics(runSlowPath({}));
+            ENFORCE(result.gs);
+            // The initial index, typecheck, and file hashes are done; from here the raw sources
+            // are only read to print snippets and answer queries, and those fault back in one
+            // file at a time. Dropping them keeps the resident set proportional to the trees
+            // rather than the corpus. Files open in the editor keep their buffers: their File
+            // holds editor contents that may not match the disk.
+            for (auto &file : result.gs->getFiles()) {
+                if (file == nullptr || openFiles.contains(file->path())) {
+                    continue;
+                }
+                file->releaseSource();
+            }
+            // The indexed trees are likewise only parse caches once the initial typecheck is
+            // done. Drop them for files the editor has not opened: the fast path and queries
+            // re-index a missing tree one file at a time (the source faults back in from disk),
+            // and the slow path re-indexes the remainder on the worker pool, so steady-state
+            // memory tracks the files being worked on rather than the whole workspace.
+            u4 droppedTrees = 0;
+            for (auto &tree : indexed) {
+                if (tree.tree == nullptr || !tree.file.exists() ||
+                    openFiles.contains(tree.file.data(*initialGS).path())) {
+                    continue;
+                }
+                tree.tree.reset();
+                droppedTrees++;
             }
+            prodCounterAdd("lsp.initialization.indexed_trees_dropped", droppedTrees);
             initialized = true;
             return result;
         }
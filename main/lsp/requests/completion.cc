@@ -10,6 +10,12 @@ using namespace std;
 
 namespace sorbet::realmain::lsp {
 
+// Rendering a CompletionItem is the expensive half of a completion request (method details,
+// snippets, and a documentation lookup that re-reads the defining file), so after ranking we only
+// render this many. The response is marked incomplete when the cap bites, which tells the editor
+// to re-query as the user narrows the prefix.
+constexpr size_t MAX_COMPLETION_RESULTS = 100;
+
 UnorderedMap<core::NameRef, vector<core::SymbolRef>>
 mergeMaps(UnorderedMap<core::NameRef, vector<core::SymbolRef>> &&first,
           UnorderedMap<core::NameRef, vector<core::SymbolRef>> &&second) {
@@ -27,7 +33,10 @@ UnorderedMap<core::NameRef, vector<core::SymbolRef>> findSimilarMethodsIn(const
         receiver.get(),
         [&](core::ClassType *c) {
             const auto &owner = c->symbol.data(gs);
-            for (auto member : owner->membersStableOrderSlow(gs)) {
+            // Candidate generation does not need sorted members (results are merged into a map
+            // and ranked by the caller), so skip membersStableOrderSlow's per-class sort — its
+            // comparator renders showRaw strings, which dominated wide-receiver completions.
+            for (const auto &member : owner->members()) {
                 auto sym = member.second;
                 if (sym.data(gs)->isMethod() && hasSimilarName(gs, sym.data(gs)->name, name)) {
                     result[sym.data(gs)->name].emplace_back(sym);
@@ -35,12 +44,12 @@ UnorderedMap<core::NameRef, vector<core::SymbolRef>> findSimilarMethodsIn(const
             }
             for (auto mixin : owner->mixins()) {
                 result = mergeMaps(std::move(result),
-                                   findSimilarMethodsIn(gs, core::make_type<core::ClassType>(mixin), name));
+                                   findSimilarMethodsIn(gs, core::Types::classType(mixin), name));
             }
             if (owner->superClass().exists()) {
                 result =
                     mergeMaps(std::move(result),
-                              findSimilarMethodsIn(gs, core::make_type<core::ClassType>(owner->superClass()), name));
+                              findSimilarMethodsIn(gs, core::Types::classType(owner->superClass()), name));
             }
         },
         [&](core::AndType *c) {
@@ -62,7 +71,7 @@ UnorderedMap<core::NameRef, vector<core::SymbolRef>> findSimilarMethodsIn(const
             }
         },
         [&](core::AppliedType *c) {
-            result = findSimilarMethodsIn(gs, core::make_type<core::ClassType>(c->klass), name);
+            result = findSimilarMethodsIn(gs, core::Types::classType(c->klass), name);
         },
         [&](core::ProxyType *c) { result = findSimilarMethodsIn(gs, c->underlying(), name); }, [&](core::Type *c) {});
     return result;
@@ -247,18 +256,38 @@ void LSPLoop::findSimilarConstantOrIdent(const core::GlobalState &gs, const core
         auto pattern = c->symbol.data(gs)->name.data(gs)->shortName(gs);
         logger->debug("Looking for constant similar to {}", pattern);
         core::SymbolRef owner = c->symbol;
+        vector<core::SymbolRef> candidates;
         do {
             owner = owner.data(gs)->owner;
-            for (auto member : owner.data(gs)->membersStableOrderSlow(gs)) {
+            for (const auto &member : owner.data(gs)->members()) {
                 auto sym = member.second;
                 if (sym.exists() && (sym.data(gs)->isClass() || sym.data(gs)->isStaticField()) &&
                     sym.data(gs)->name.data(gs)->kind == core::NameKind::CONSTANT &&
                     // hide singletons
                     hasSimilarName(gs, sym.data(gs)->name, pattern)) {
-                    items.push_back(getCompletionItem(gs, sym, receiverType, nullptr));
+                    candidates.emplace_back(sym);
                 }
             }
         } while (owner != core::Symbols::root());
+        fast_sort(candidates, [&](auto lhs, auto rhs) -> bool {
+            auto lhsShort = lhs.data(gs)->name.data(gs)->shortName(gs);
+            auto rhsShort = rhs.data(gs)->name.data(gs)->shortName(gs);
+            auto lhsPrefix = absl::StartsWith(lhsShort, pattern);
+            auto rhsPrefix = absl::StartsWith(rhsShort, pattern);
+            if (lhsPrefix != rhsPrefix) {
+                return lhsPrefix;
+            }
+            if (lhsShort != rhsShort) {
+                return lhsShort < rhsShort;
+            }
+            return lhs._id < rhs._id;
+        });
+        for (auto sym : candidates) {
+            if (items.size() >= MAX_COMPLETION_RESULTS) {
+                break;
+            }
+            items.push_back(getCompletionItem(gs, sym, receiverType, nullptr));
+        }
     }
 }
 
@@ -299,12 +328,22 @@ LSPResult LSPLoop::handleTextDocumentCompletion(unique_ptr<core::GlobalState> gs
                 fast_sort(methodsSorted, [&](auto leftPair, auto rightPair) -> bool {
                     auto leftShortName = leftPair.first.data(*gs)->shortName(*gs);
                     auto rightShortName = rightPair.first.data(*gs)->shortName(*gs);
+                    // What the user typed is most likely the start of the method name, so prefix
+                    // matches rank ahead of mid-name matches; alphabetical within each group.
+                    auto leftPrefix = absl::StartsWith(leftShortName, pattern);
+                    auto rightPrefix = absl::StartsWith(rightShortName, pattern);
+                    if (leftPrefix != rightPrefix) {
+                        return leftPrefix;
+                    }
                     if (leftShortName != rightShortName) {
                         return leftShortName < rightShortName;
                     }
                     return leftPair.first._id < rightPair.first._id;
                 });
                 for (auto &entry : methodsSorted) {
+                    if (items.size() >= MAX_COMPLETION_RESULTS) {
+                        break;
+                    }
                     if (entry.second[0].exists()) {
                         fast_sort(entry.second, [&](auto lhs, auto rhs) -> bool { return lhs._id < rhs._id; });
                         items.push_back(getCompletionItem(*gs, entry.second[0], receiverType,
@@ -317,7 +356,7 @@ LSPResult LSPLoop::handleTextDocumentCompletion(unique_ptr<core::GlobalState> gs
                 findSimilarConstantOrIdent(*gs, constantResp->retType.type, items);
             }
         }
-        response->result = make_unique<CompletionList>(false, move(items));
+        response->result = make_unique<CompletionList>(items.size() >= MAX_COMPLETION_RESULTS, move(items));
     }
     return LSPResult::make(move(gs), move(response));
 }
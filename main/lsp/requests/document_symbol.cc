@@ -1,3 +1,4 @@
+#include "core/Hashing.h"
 #include "core/lsp/QueryResponse.h"
 #include "main/lsp/lsp.h"
 
@@ -7,6 +8,45 @@ namespace sorbet::realmain::lsp {
 std::unique_ptr<DocumentSymbol> symbolRef2DocumentSymbol(const core::GlobalState &gs, core::SymbolRef symRef,
                                                          core::FileRef filter);
 
+namespace {
+// Folds the parts of a FileHash that the outline depends on into one validity key: the hierarchy
+// hash plus the per-method symbol and shape hashes (the latter two are kept out of hierarchyHash
+// for fast-path purposes, but arity or signature edits do change the rendered `detail`). XOR keeps
+// the fold independent of map iteration order.
+u4 definitionsKey(const core::FileHash &hash) {
+    u4 key = hash.definitions.hierarchyHash;
+    for (const auto &e : hash.definitions.methodHashes) {
+        key ^= core::mix(e.first._hashValue, e.second);
+    }
+    for (const auto &e : hash.definitions.methodShapeHashes) {
+        key ^= core::mix(core::mix(e.first._hashValue, e.second), 1);
+    }
+    return key;
+}
+
+vector<unique_ptr<DocumentSymbol>> copyDocumentSymbols(const vector<unique_ptr<DocumentSymbol>> &symbols);
+
+unique_ptr<DocumentSymbol> copyDocumentSymbol(const DocumentSymbol &symbol) {
+    auto result = make_unique<DocumentSymbol>(symbol.name, symbol.kind, symbol.range->copy(),
+                                              symbol.selectionRange->copy());
+    result->detail = symbol.detail;
+    result->deprecated = symbol.deprecated;
+    if (symbol.children.has_value()) {
+        result->children = copyDocumentSymbols(*symbol.children);
+    }
+    return result;
+}
+
+vector<unique_ptr<DocumentSymbol>> copyDocumentSymbols(const vector<unique_ptr<DocumentSymbol>> &symbols) {
+    vector<unique_ptr<DocumentSymbol>> result;
+    result.reserve(symbols.size());
+    for (const auto &symbol : symbols) {
+        result.push_back(copyDocumentSymbol(*symbol));
+    }
+    return result;
+}
+} // namespace
+
 void symbolRef2DocumentSymbolWalkMembers(const core::GlobalState &gs, core::SymbolRef sym, core::FileRef filter,
                                          vector<unique_ptr<DocumentSymbol>> &out) {
     for (auto mem : sym.data(gs)->membersStableOrderSlow(gs)) {
@@ -81,8 +121,23 @@ LSPResult LSPLoop::handleTextDocumentDocumentSymbol(unique_ptr<core::GlobalState
     vector<unique_ptr<DocumentSymbol>> result;
     string_view uri = params.textDocument->uri;
     auto fref = uri2FileRef(uri);
-    for (u4 idx = 1; idx < gs->symbolsUsed(); idx++) {
-        core::SymbolRef ref(gs.get(), idx);
+
+    // The outline only changes when the file's definitions do, but editors re-request it on every
+    // edit; replay the cached outline when the definition hashes are unchanged.
+    u4 defKey = 0;
+    bool cacheable = fref.exists() && fref.id() < globalStateHashes.size();
+    if (cacheable) {
+        defKey = definitionsKey(globalStateHashes[fref.id()]);
+        auto it = documentSymbolCache.find(fref);
+        if (it != documentSymbolCache.end() && it->second.definitionsKey == defKey) {
+            prodCounterInc("lsp.document_symbol_cache.hit");
+            response->result = copyDocumentSymbols(it->second.symbols);
+            return LSPResult::make(move(gs), move(response));
+        }
+        prodCounterInc("lsp.document_symbol_cache.miss");
+    }
+
+    auto collectSymbol = [&](core::SymbolRef ref) {
         if (!hideSymbol(*gs, ref) &&
             // a bit counter-intuitive, but this actually should be `!= fref`, as it prevents duplicates.
             (ref.data(*gs)->owner.data(*gs)->loc().file() != fref || ref.data(*gs)->owner == core::Symbols::root())) {
@@ -96,6 +151,21 @@ LSPResult LSPLoop::handleTextDocumentDocumentSymbol(unique_ptr<core::GlobalState
                 }
             }
         }
+    };
+    if (fref.exists() && fref.data(*gs).isPayload()) {
+        // Symbols defined in a payload file sit below the project segment; scan everything.
+        for (u4 idx = 1; idx < gs->symbolsUsed(); idx++) {
+            collectSymbol(core::SymbolRef(gs.get(), idx));
+        }
+    } else {
+        // Only project-segment symbols (and payload symbols the project reopens) can have a
+        // definition loc in a project file.
+        gs->forEachProjectSymbol(collectSymbol);
+    }
+    if (cacheable) {
+        auto &entry = documentSymbolCache[fref];
+        entry.definitionsKey = defKey;
+        entry.symbols = copyDocumentSymbols(result);
     }
     response->result = move(result);
     return LSPResult::make(move(gs), move(response));
@@ -19,6 +19,23 @@ string readFile(string_view path, const FileSystem &fs) {
     }
 }
 
+namespace {
+// Byte offset of an LSP (line, character) position within `contents`. Mirrors Loc::pos2Offset's
+// byte-column semantics without materializing a core::File — whose constructor copies the whole
+// buffer — for every content change in a didChange burst.
+size_t position2Offset(string_view contents, int line, int character) {
+    size_t offset = 0;
+    for (int i = 0; i < line; i++) {
+        auto lineEnd = contents.find('\n', offset);
+        if (lineEnd == string_view::npos) {
+            return contents.size();
+        }
+        offset = lineEnd + 1;
+    }
+    return min(offset + character, contents.size());
+}
+} // namespace
+
 string_view LSPLoop::getFileContents(UnorderedMap<string, LSPLoop::SorbetWorkspaceFileUpdate> &updates,
                                      const core::GlobalState &initialGS, string_view path) {
     if (updates.find(path) != updates.end()) {
@@ -41,26 +58,36 @@ void LSPLoop::preprocessSorbetWorkspaceEdit(const DidChangeTextDocumentParams &c
         if (FileOps::isFileIgnored(rootPath, localPath, opts.absoluteIgnorePatterns, opts.relativeIgnorePatterns)) {
             return;
         }
-        string fileContents = string(getFileContents(updates, *initialGS, localPath));
+        // The previous contents are only needed once an incremental change shows up; full-sync
+        // clients replace the whole document and never pay for the copy.
+        string fileContents;
+        bool haveContents = false;
         for (auto &change : changeParams.contentChanges) {
             if (change->range) {
+                if (!haveContents) {
+                    fileContents = string(getFileContents(updates, *initialGS, localPath));
+                    haveContents = true;
+                }
+                // incremental update, applied in place: offsets are computed against the buffer
+                // directly, and string::replace shifts the tail without cloning the document.
                 auto &range = *change->range;
-                // incremental update
-                core::Loc::Detail start, end;
-                start.line = range->start->line + 1;
-                start.column = range->start->character + 1;
-                end.line = range->end->line + 1;
-                end.column = range->end->character + 1;
-                core::File old(string(localPath), string(fileContents), core::File::Type::Normal);
-                auto startOffset = core::Loc::pos2Offset(old, start);
-                auto endOffset = core::Loc::pos2Offset(old, end);
-                fileContents = fileContents.replace(startOffset, endOffset - startOffset, change->text);
+                auto startOffset = position2Offset(fileContents, range->start->line, range->start->character);
+                auto endOffset = position2Offset(fileContents, range->end->line, range->end->character);
+                if (endOffset < startOffset) {
+                    endOffset = startOffset;
+                }
+                fileContents.replace(startOffset, endOffset - startOffset, change->text);
             } else {
                 // replace
-                fileContents = change->text;
+                fileContents = move(change->text);
+                haveContents = true;
             }
         }
-        updates[localPath] = {fileContents, /* newlyOpened */ false, /* newlyClosed */ false};
+        if (!haveContents) {
+            // A didChange with no content changes must not wipe the document.
+            fileContents = string(getFileContents(updates, *initialGS, localPath));
+        }
+        updates[localPath] = {move(fileContents), /* newlyOpened */ false, /* newlyClosed */ false};
     }
 }
 
@@ -70,6 +97,11 @@ void LSPLoop::preprocessSorbetWorkspaceEdit(const DidOpenTextDocumentParams &ope
     if (absl::StartsWith(uri, rootUri)) {
         string localPath = remoteName2Local(uri);
         if (!FileOps::isFileIgnored(rootPath, localPath, opts.absoluteIgnorePatterns, opts.relativeIgnorePatterns)) {
+            auto fref = initialGS->findFileByPath(localPath);
+            if (fref.exists()) {
+                // The user navigated here; seed speculative pre-parsing from this file.
+                speculationSeed = fref;
+            }
             updates[localPath] = {move(openParams.textDocument->text), /* newlyOpened */ true, /* newlyClosed */ false};
         }
     }
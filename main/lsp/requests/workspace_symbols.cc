@@ -1,5 +1,7 @@
+#include "common/concurrency/ConcurrentQueue.h"
 #include "core/lsp/QueryResponse.h"
 #include "main/lsp/lsp.h"
+#include <algorithm> // std::set_intersection
 
 using namespace std;
 
@@ -22,6 +24,48 @@ unique_ptr<SymbolInformation> LSPLoop::symbolRef2SymbolInformation(const core::G
     return result;
 }
 
+namespace {
+// How many symbols each worker claims at a time when scanning the symbol table. Small enough to
+// keep the pool balanced when matches (and their string rendering) cluster, large enough that
+// queue traffic is negligible against a table of hundreds of thousands of symbols.
+constexpr u4 WORKSPACE_SYMBOLS_SHARD_SIZE = 4096;
+
+// The index only answers queries long enough to contain a trigram; shorter ones fall back to the
+// table scan (and produce result sets so large that matching is not the dominant cost anyway).
+constexpr size_t MIN_INDEXED_QUERY_LENGTH = 3;
+
+u4 packTrigram(string_view text, size_t at) {
+    return (u4(u1(text[at])) << 16) | (u4(u1(text[at + 1])) << 8) | u4(u1(text[at + 2]));
+}
+} // namespace
+
+void LSPLoop::buildWorkspaceSymbolsIndex(const core::GlobalState &gs) const {
+    Timer timeit(logger, "buildWorkspaceSymbolsIndex");
+    auto &index = workspaceSymbolsIndex;
+    index.trigrams.clear();
+    const u4 symbolsUsed = gs.symbolsUsed();
+    for (u4 idx = 1; idx < symbolsUsed; idx++) {
+        core::SymbolRef ref(gs, idx);
+        auto data = ref.data(gs);
+        if (!data->loc().file().exists()) {
+            continue;
+        }
+        auto view = data->name.data(gs)->shortName(gs);
+        if (view.size() < MIN_INDEXED_QUERY_LENGTH) {
+            continue;
+        }
+        for (size_t i = 0; i + 2 < view.size(); i++) {
+            auto &postings = index.trigrams[packTrigram(view, i)];
+            // A name that repeats a trigram would otherwise appear twice in its list.
+            if (postings.empty() || postings.back() != idx) {
+                postings.emplace_back(idx);
+            }
+        }
+    }
+    index.valid = true;
+    prodCounterAdd("lsp.workspace_symbols_index.trigrams", index.trigrams.size());
+}
+
 LSPResult LSPLoop::handleWorkspaceSymbols(unique_ptr<core::GlobalState> gs, const MessageId &id,
                                           const WorkspaceSymbolParams &params) const {
     auto response = make_unique<ResponseMessage>("2.0", id, LSPMethod::WorkspaceSymbol);
@@ -34,18 +78,126 @@ LSPResult LSPLoop::handleWorkspaceSymbols(unique_ptr<core::GlobalState> gs, cons
 
     prodCategoryCounterInc("lsp.messages.processed", "workspace.symbols");
 
-    vector<unique_ptr<SymbolInformation>> result;
     string_view searchString = params.query;
     ShowOperation op(*this, "WorkspaceSymbols", fmt::format("Searching for symbol `{}`...", searchString));
 
-    for (u4 idx = 1; idx < gs->symbolsUsed(); idx++) {
-        core::SymbolRef ref(gs.get(), idx);
-        if (hasSimilarName(*gs, ref.data(*gs)->name, searchString)) {
-            auto data = symbolRef2SymbolInformation(*gs, ref);
-            if (data) {
-                result.push_back(move(data));
+    if (searchString.size() >= MIN_INDEXED_QUERY_LENGTH) {
+        if (!workspaceSymbolsIndex.valid) {
+            buildWorkspaceSymbolsIndex(*gs);
+        }
+        // Every trigram of the query must appear in a matching name; a missing posting list means
+        // no symbol can contain the query.
+        vector<const vector<u4> *> lists;
+        for (size_t i = 0; i + 2 < searchString.size(); i++) {
+            auto it = workspaceSymbolsIndex.trigrams.find(packTrigram(searchString, i));
+            if (it == workspaceSymbolsIndex.trigrams.end()) {
+                lists.clear();
+                break;
             }
+            lists.emplace_back(&it->second);
         }
+        vector<unique_ptr<SymbolInformation>> result;
+        if (!lists.empty()) {
+            // Intersect starting from the rarest trigram so the candidate set collapses early.
+            fast_sort(lists, [](const auto *lhs, const auto *rhs) -> bool { return lhs->size() < rhs->size(); });
+            vector<u4> candidates = *lists[0];
+            vector<u4> narrowed;
+            for (size_t i = 1; i < lists.size() && !candidates.empty(); i++) {
+                narrowed.clear();
+                set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(),
+                                 back_inserter(narrowed));
+                candidates.swap(narrowed);
+            }
+            for (auto idx : candidates) {
+                core::SymbolRef ref(*gs, idx);
+                // Trigram containment overapproximates (the query's trigrams can match at
+                // unrelated positions), so verify the actual substring before rendering.
+                if (!hasSimilarName(*gs, ref.data(*gs)->name, searchString)) {
+                    continue;
+                }
+                auto data = symbolRef2SymbolInformation(*gs, ref);
+                if (data) {
+                    result.push_back(move(data));
+                }
+            }
+            // Rank tighter matches first: the query covers more of a shorter name.
+            fast_sort(result, [](const auto &lhs, const auto &rhs) -> bool {
+                if (lhs->name.size() != rhs->name.size()) {
+                    return lhs->name.size() < rhs->name.size();
+                }
+                return lhs->name < rhs->name;
+            });
+        }
+        prodCounterInc("lsp.workspace_symbols_index.queries");
+        response->result = move(result);
+        return LSPResult::make(move(gs), move(response));
+    }
+
+    // The scan only reads the (frozen) name and symbol tables, so it can fan out across the pool;
+    // this request is the slowest read-only one we serve, and everything behind it in the queue
+    // waits for it. Workers claim fixed-size shards of the symbol id space and render matches
+    // themselves; shards are reassembled in id order below so the response stays deterministic.
+    const u4 symbolsUsed = gs->symbolsUsed();
+    vector<pair<u4, u4>> shards;
+    for (u4 begin = 1; begin < symbolsUsed; begin += WORKSPACE_SYMBOLS_SHARD_SIZE) {
+        shards.emplace_back(begin, min(begin + WORKSPACE_SYMBOLS_SHARD_SIZE, symbolsUsed));
+    }
+    auto shardq = make_shared<ConcurrentBoundedQueue<pair<u4, u4>>>(shards.size());
+    for (auto &shard : shards) {
+        shardq->push(pair<u4, u4>(shard), 1);
+    }
+
+    typedef vector<pair<u4, vector<unique_ptr<SymbolInformation>>>> ShardResults;
+    auto resultq = make_shared<BlockingBoundedQueue<ShardResults>>(shards.size());
+    const core::GlobalState &cgs = *gs;
+    workers.multiplexJob("workspaceSymbols", [this, &cgs, searchString, shardq, resultq]() {
+        ShardResults results;
+        int processed = 0;
+        pair<u4, u4> shard;
+        for (auto result = shardq->try_pop(shard); !result.done(); result = shardq->try_pop(shard)) {
+            if (!result.gotItem()) {
+                continue;
+            }
+            processed++;
+            vector<unique_ptr<SymbolInformation>> matches;
+            for (u4 idx = shard.first; idx < shard.second; idx++) {
+                core::SymbolRef ref(cgs, idx);
+                if (hasSimilarName(cgs, ref.data(cgs)->name, searchString)) {
+                    auto data = symbolRef2SymbolInformation(cgs, ref);
+                    if (data) {
+                        matches.push_back(move(data));
+                    }
+                }
+            }
+            if (!matches.empty()) {
+                results.emplace_back(shard.first, move(matches));
+            }
+        }
+        // The drain below waits until pushed counts cover every shard, so count matchless shards
+        // too, not just the ones that produced results.
+        if (processed > 0) {
+            resultq->push(move(results), processed);
+        }
+    });
+
+    ShardResults collected;
+    {
+        ShardResults threadResults;
+        for (auto result = resultq->wait_pop_timed(threadResults, WorkerPool::BLOCK_INTERVAL(), gs->tracer());
+             !result.done();
+             result = resultq->wait_pop_timed(threadResults, WorkerPool::BLOCK_INTERVAL(), gs->tracer())) {
+            if (result.gotItem()) {
+                collected.insert(collected.end(), make_move_iterator(threadResults.begin()),
+                                 make_move_iterator(threadResults.end()));
+            }
+        }
+    }
+    fast_sort(collected, [](const auto &lhs, const auto &rhs) -> bool { return lhs.first < rhs.first; });
+
+    vector<unique_ptr<SymbolInformation>> result;
+    for (auto &shardResult : collected) {
+        result.insert(result.end(), make_move_iterator(shardResult.second.begin()),
+                      make_move_iterator(shardResult.second.end()));
     }
     response->result = move(result);
     return LSPResult::make(move(gs), move(response));
@@ -1302,6 +1302,13 @@ void makeLSPTypes(vector<shared_ptr<JSONClassType>> &enumTypes, vector<shared_pt
                                                 },
                                                 classTypes);
 
+    auto SorbetSampleProfileParams = makeObject("SorbetSampleProfileParams",
+                                                {
+                                                    makeField("running", JSONBool),
+                                                    makeField("intervalMicros", JSONInt),
+                                                },
+                                                classTypes);
+
     auto SorbetTypecheckRunInfo = makeObject("SorbetTypecheckRunInfo",
                                              {
                                                  makeField("tookFastPath", JSONBool),
@@ -1323,6 +1330,7 @@ void makeLSPTypes(vector<shared_ptr<JSONClassType>> &enumTypes, vector<shared_pt
                                      "shutdown",
                                      "sorbet/error",
                                      "sorbet/readFile",
+                                     "sorbet/sampleProfile",
                                      "sorbet/showOperation",
                                      "sorbet/typecheckRunInfo",
                                      "sorbet/watchmanFileChange",
@@ -1416,6 +1424,7 @@ void makeLSPTypes(vector<shared_ptr<JSONClassType>> &enumTypes, vector<shared_pt
                                                 {"window/showMessage", ShowMessageParams},
                                                 {"__PAUSE__", makeOptional(JSONNull)},
                                                 {"__RESUME__", makeOptional(JSONNull)},
+                                                {"sorbet/sampleProfile", SorbetSampleProfileParams},
                                                 {"sorbet/watchmanFileChange", WatchmanQueryResponse},
                                                 {"sorbet/showOperation", SorbetShowOperationParams},
                                                 {"sorbet/error", SorbetErrorParams},
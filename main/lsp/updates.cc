@@ -1,5 +1,10 @@
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "ast/ExpressionArena.h"
 #include "ast/treemap/treemap.h"
+#include "common/ArenaStats.h"
 #include "common/Timer.h"
+#include "common/crypto_hashing/crypto_hashing.h"
 #include "core/Error.h"
 #include "core/Files.h"
 #include "core/GlobalState.h"
@@ -10,6 +15,7 @@
 #include "core/errors/parser.h"
 #include "core/errors/resolver.h"
 #include "core/lsp/QueryResponse.h"
+#include "core/serialize/serialize.h"
 #include "lsp.h"
 #include "main/lsp/DefLocSaver.h"
 #include "main/lsp/LocalVarSaver.h"
@@ -71,6 +77,10 @@ LSPResult LSPLoop::commitTypecheckRun(TypecheckRun run) {
     if (!run.tookFastPath) {
         indexedFinalGS.clear();
     }
+    // Symbols (and on the slow path, their ids) changed; the next workspace/symbol query rebuilds
+    // the trigram index against the committed table.
+    workspaceSymbolsIndex.valid = false;
+    workspaceSymbolsIndex.trigrams.clear();
 
     for (auto &ast : updates.updatedFileIndexes) {
         indexedFinalGS[ast.file.id()] = move(ast);
@@ -100,14 +110,52 @@ LSPResult LSPLoop::commitTypecheckRun(TypecheckRun run) {
         if (id >= globalStateHashes.size()) {
             globalStateHashes.resize(id + 1);
         }
+        updateUsageIndexes(fref, globalStateHashes[id], entry.second);
         globalStateHashes[fref.id()] = move(entry.second);
     }
 
+    // Typechecking can change the answer to any location query in the affected files; drop their
+    // cached query responses.
+    if (!run.tookFastPath) {
+        locQueryCache.clear();
+    } else {
+        for (auto fref : run.filesTypechecked) {
+            locQueryCache.erase(fref);
+        }
+    }
+    // Cached query trees bake in symbol ids of the previous state; any committed run may have
+    // reassigned them, so drop the lot rather than track which ids survived.
+    queryTreeCache.clear();
+
+    if (run.canceled) {
+        // The run yielded to a superseding edit: its error list stops at whatever file was being
+        // drained. Keep the committed state (indexes, hashes, gs are all valid) but leave the
+        // client's diagnostics alone; the follow-up typecheck will refresh them.
+        prodCategoryCounterInc("lsp.updates", "canceled");
+        return LSPResult{move(run.gs), {}};
+    }
     return pushDiagnostics(move(run));
 }
 
+namespace {
+// Content-addressed cache key for a file's FileHash; sibling of the per-file tree cache entries.
+string fileHashCacheKey(const core::File &file) {
+    auto hashBytes = sorbet::crypto_hashing::hash128Fast(file.source());
+    // v2: FileHash gained definitions.defHashes; entries pickled before that lack the map.
+    return absl::StrCat("filehash:v2:",
+                        absl::BytesToHexString(string_view{(char *)hashBytes.data(), size(hashBytes)}));
+}
+} // namespace
+
 vector<core::FileHash> LSPLoop::computeStateHashes(const vector<shared_ptr<core::File>> &files) const {
     Timer timeit(logger, "computeStateHashes");
+    struct StateHashResult {
+        int idx;
+        core::FileHash hash;
+        // Set when the hash was freshly computed and should be cached; the owning thread writes
+        // it back, since only the thread that created the store may write.
+        string cacheKey;
+    };
     vector<core::FileHash> res(files.size());
     shared_ptr<ConcurrentBoundedQueue<int>> fileq = make_shared<ConcurrentBoundedQueue<int>>(files.size());
     for (int i = 0; i < files.size(); i++) {
@@ -119,10 +167,10 @@ vector<core::FileHash> LSPLoop::computeStateHashes(const vector<shared_ptr<core:
 
     res.resize(files.size());
 
-    shared_ptr<BlockingBoundedQueue<vector<pair<int, core::FileHash>>>> resultq =
-        make_shared<BlockingBoundedQueue<vector<pair<int, core::FileHash>>>>(files.size());
-    workers.multiplexJob("lspStateHash", [fileq, resultq, files, logger = this->logger]() {
-        vector<pair<int, core::FileHash>> threadResult;
+    shared_ptr<BlockingBoundedQueue<vector<StateHashResult>>> resultq =
+        make_shared<BlockingBoundedQueue<vector<StateHashResult>>>(files.size());
+    workers.multiplexJob("lspStateHash", [fileq, resultq, files, logger = this->logger, &kvstore = this->kvstore]() {
+        vector<StateHashResult> threadResult;
         int processedByThread = 0;
         int job;
         options::Options emptyOpts;
@@ -134,11 +182,25 @@ vector<core::FileHash> LSPLoop::computeStateHashes(const vector<shared_ptr<core:
                     processedByThread++;
 
                     if (!files[job]) {
-                        threadResult.emplace_back(job, core::FileHash{});
+                        threadResult.emplace_back(StateHashResult{job, core::FileHash{}, ""});
                         continue;
                     }
+                    // Hashes are pure functions of the file contents, so the initial hash-everything
+                    // pass on an editor restart serves mostly from the cache.
+                    string key;
+                    if (kvstore != nullptr) {
+                        key = fileHashCacheKey(*files[job]);
+                        auto cached = kvstore->read(key);
+                        if (cached != nullptr) {
+                            prodCounterInc("lsp.filehash_cache.hit");
+                            threadResult.emplace_back(
+                                StateHashResult{job, core::serialize::Serializer::loadFileHash(cached, *logger), ""});
+                            continue;
+                        }
+                        prodCounterInc("lsp.filehash_cache.miss");
+                    }
                     auto hash = pipeline::computeFileHash(files[job], *logger);
-                    threadResult.emplace_back(job, move(hash));
+                    threadResult.emplace_back(StateHashResult{job, move(hash), move(key)});
                 }
             }
         }
@@ -149,12 +211,15 @@ vector<core::FileHash> LSPLoop::computeStateHashes(const vector<shared_ptr<core:
     });
 
     {
-        vector<pair<int, core::FileHash>> threadResult;
+        vector<StateHashResult> threadResult;
         for (auto result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), *logger); !result.done();
              result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), *logger)) {
             if (result.gotItem()) {
                 for (auto &a : threadResult) {
-                    res[a.first] = move(a.second);
+                    if (kvstore != nullptr && !a.cacheKey.empty()) {
+                        kvstore->write(a.cacheKey, core::serialize::Serializer::storeFileHash(a.hash));
+                    }
+                    res[a.idx] = move(a.hash);
                 }
             }
         }
@@ -162,6 +227,56 @@ vector<core::FileHash> LSPLoop::computeStateHashes(const vector<shared_ptr<core:
     return res;
 }
 
+void LSPLoop::updateUsageIndexes(core::FileRef fref, const core::FileHash &oldHash, const core::FileHash &newHash) {
+    auto remove = [fref](UnorderedMap<core::NameHash, vector<core::FileRef>> &index,
+                         const vector<core::NameHash> &usages) {
+        for (auto &nameHash : usages) {
+            auto it = index.find(nameHash);
+            if (it == index.end()) {
+                continue;
+            }
+            auto &files = it->second;
+            files.erase(std::remove(files.begin(), files.end(), fref), files.end());
+        }
+    };
+    auto add = [fref](UnorderedMap<core::NameHash, vector<core::FileRef>> &index,
+                      const vector<core::NameHash> &usages) {
+        for (auto &nameHash : usages) {
+            index[nameHash].emplace_back(fref);
+        }
+    };
+    remove(filesBySendHash, oldHash.usages.sends);
+    remove(filesByConstantHash, oldHash.usages.constants);
+    add(filesBySendHash, newHash.usages.sends);
+    add(filesByConstantHash, newHash.usages.constants);
+}
+
+bool LSPLoop::nameUsedOutsideFile(core::NameHash nameHash, core::FileRef edited) const {
+    for (const auto *index : {&filesBySendHash, &filesByConstantHash}) {
+        auto it = index->find(nameHash);
+        if (it == index->end()) {
+            continue;
+        }
+        for (auto ref : it->second) {
+            if (ref != edited) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void LSPLoop::rebuildUsageIndexes() {
+    Timer timeit(logger, "rebuildUsageIndexes");
+    filesBySendHash.clear();
+    filesByConstantHash.clear();
+    int i = -1;
+    for (auto &hash : globalStateHashes) {
+        i++;
+        updateUsageIndexes(core::FileRef(i), core::FileHash{}, hash);
+    }
+}
+
 void LSPLoop::reIndexFromFileSystem() {
     ShowOperation op(*this, "Indexing", "Indexing files...");
     Timer timeit(logger, "reIndexFromFileSystem");
@@ -183,7 +298,7 @@ void tryApplyLocalVarSaver(const core::GlobalState &gs, vector<ast::ParsedFile>
     for (auto &t : indexedCopies) {
         LocalVarSaver localVarSaver;
         core::Context ctx(gs, core::Symbols::root());
-        t.tree = ast::TreeMap::apply(ctx, localVarSaver, move(t.tree));
+        ast::ConstTreeMap::apply(ctx, localVarSaver, *t.tree);
     }
 }
 
@@ -194,7 +309,7 @@ void tryApplyDefLocSaver(const core::GlobalState &gs, vector<ast::ParsedFile> &i
     for (auto &t : indexedCopies) {
         DefLocSaver defLocSaver;
         core::Context ctx(gs, core::Symbols::root());
-        t.tree = ast::TreeMap::apply(ctx, defLocSaver, move(t.tree));
+        ast::ConstTreeMap::apply(ctx, defLocSaver, *t.tree);
     }
 }
 
@@ -202,13 +317,16 @@ LSPLoop::TypecheckRun LSPLoop::runSlowPath(FileUpdates updates) const {
     ShowOperation slowPathOp(*this, "SlowPath", "Typechecking...");
     Timer timeit(logger, "slow_path");
     ENFORCE(initialGS->errorQueue->isEmpty());
+    // Every arena from the previous edit cycle should be dead by now; blocks still live here are
+    // drifting across cycles and will compound over a session. Debug builds only.
+    ArenaStats::enforceAllFreed();
     prodCategoryCounterInc("lsp.updates", "slowpath");
     logger->debug("Taking slow path");
 
     UnorderedSet<int> updatedFiles;
-    vector<ast::ParsedFile> indexedCopies;
-    auto finalGS = initialGS->deepCopy(true);
-    // Index the updated files using finalGS.
+    auto finalGS = initialGS->deepCopy(true, &workers);
+    // Index the updated files using finalGS. These indexes outlive the run (they are committed into
+    // indexedFinalGS), so they are built before the arena scope opens and stay on the heap.
     {
         core::UnfreezeFileTable fileTableAccess(*finalGS);
         for (auto &file : updates.updatedFiles) {
@@ -216,33 +334,78 @@ LSPLoop::TypecheckRun LSPLoop::runSlowPath(FileUpdates updates) const {
             finalGS = move(pair.first);
             auto &ast = pair.second;
             if (ast.tree) {
-                indexedCopies.emplace_back(ast::ParsedFile{ast.tree->deepCopy(), ast.file});
                 updatedFiles.insert(ast.file.id());
                 updates.updatedFileIndexes.push_back(move(ast));
             }
         }
     }
 
+    // Everything below works on copies made for this run and discarded with it: a slow path deep
+    // copies every tree in the workspace, and freeing those node by node is the main source of
+    // heap fragmentation in a long session. One arena holds them all and is torn down in one shot
+    // when this function returns. Nodes that resolve or flatten splice in from worker threads land
+    // on the heap and are freed individually, which is a small minority of the tree.
+    ast::ExpressionArena::Scope treeArenaScope;
+    vector<ast::ParsedFile> indexedCopies;
+    for (auto &ast : updates.updatedFileIndexes) {
+        indexedCopies.emplace_back(ast::ParsedFile{ast.tree->deepCopy(), ast.file});
+    }
+
     // Copy the indexes of unchanged files.
+    vector<core::FileRef> reindexFromDisk;
     for (const auto &tree : indexed) {
         // Note: indexed entries for payload files don't have any contents.
-        if (tree.tree && !updatedFiles.contains(tree.file.id())) {
+        if (!tree.file.exists() || updatedFiles.contains(tree.file.id())) {
+            continue;
+        }
+        if (tree.tree) {
             indexedCopies.emplace_back(ast::ParsedFile{tree.tree->deepCopy(), tree.file});
+        } else {
+            // The tree was dropped after the initial typecheck (see the Initialized handler), so
+            // rebuild it for this run: the source faults back in from disk and the parse runs on
+            // the worker pool. The fresh trees land in the run's arena like every other copy here.
+            reindexFromDisk.emplace_back(tree.file);
+        }
+    }
+    if (!reindexFromDisk.empty()) {
+        prodCounterAdd("lsp.slowpath.reindexed_dropped_trees", reindexFromDisk.size());
+        unique_ptr<KeyValueStore> noKvstore; // the cache handle was committed at startup
+        for (auto &tree : pipeline::index(finalGS, move(reindexFromDisk), opts, workers, noKvstore)) {
+            indexedCopies.emplace_back(move(tree));
         }
     }
 
     ENFORCE(finalGS->lspQuery.isEmpty());
     auto resolved = pipeline::resolve(finalGS, move(indexedCopies), opts, workers, skipConfigatron);
+    if (initialGS->lspTypecheckCount > 0) {
+        // On a replay (the workspace has been typechecked at least once), an RBI file that this
+        // edit didn't touch reproduces its previous diagnostics: RBIs declare interfaces but
+        // contain no method bodies to infer. The resolve above already re-entered their symbols
+        // into finalGS, so they only need to be dropped from the typecheck phase; staying out of
+        // affectedFiles also leaves their previously published diagnostics in place.
+        auto unchangedRBI = [&](const ast::ParsedFile &tree) {
+            return tree.file.data(*finalGS).isRBI() && !updatedFiles.contains(tree.file.id());
+        };
+        auto it = stable_partition(resolved.begin(), resolved.end(),
+                                   [&](const ast::ParsedFile &tree) { return !unchangedRBI(tree); });
+        prodCounterAdd("lsp.slowpath.unchanged_rbis_skipped", distance(it, resolved.end()));
+        resolved.erase(it, resolved.end());
+    }
     vector<core::FileRef> affectedFiles;
     for (auto &tree : resolved) {
         ENFORCE(tree.file.exists());
         affectedFiles.push_back(tree.file);
     }
-    pipeline::typecheck(finalGS, move(resolved), opts, workers);
+    // Edits enqueued from here on supersede this run; typecheck polls the signal between files and
+    // drains early when it fires. An edit that slips in just before the reset simply costs one
+    // full typecheck, the same as before cancellation existed.
+    supersedingEditArrived.store(false);
+    pipeline::typecheck(finalGS, move(resolved), opts, workers, nullptr, &supersedingEditArrived);
+    bool canceled = supersedingEditArrived.load();
     auto out = initialGS->errorQueue->drainWithQueryResponses();
     finalGS->lspTypecheckCount++;
     finalGS->lspQuery = core::lsp::Query::noQuery();
-    return TypecheckRun{move(out.first), move(affectedFiles), move(finalGS), move(updates), false};
+    return TypecheckRun{move(out.first), move(affectedFiles), move(finalGS), move(updates), false, canceled};
 }
 
 bool LSPLoop::canTakeFastPath(const FileUpdates &updates, const vector<core::FileHash> &hashes) const {
@@ -266,12 +429,54 @@ bool LSPLoop::canTakeFastPath(const FileUpdates &updates, const vector<core::Fil
                 auto &oldHash = globalStateHashes[fref.id()];
                 ENFORCE(oldHash.definitions.hierarchyHash != core::GlobalStateHash::HASH_STATE_NOT_COMPUTED);
                 if (hashes[i].definitions.hierarchyHash == core::GlobalStateHash::HASH_STATE_INVALID) {
-                    logger->debug("Taking slow path because {} has a syntax error", f->path());
-                    return false;
-                } else if (hashes[i].definitions.hierarchyHash != core::GlobalStateHash::HASH_STATE_INVALID &&
-                           hashes[i].definitions.hierarchyHash != oldHash.definitions.hierarchyHash) {
-                    logger->debug("Taking slow path because {} has changed definitions", f->path());
-                    return false;
+                    // A syntax error mid-edit: the degraded parse carries no definition hashes to
+                    // compare. Retypecheck just this file against its last good definitions (which
+                    // stay committed; see runTypechecking) so typing through a broken state never
+                    // pays for a slow path; the error-recovery tree still yields the syntax
+                    // diagnostics. Once the file parses again, the edit is compared against the
+                    // last good hash and routed normally.
+                    logger->debug("Treating syntax error in {} as a fast-path edit", f->path());
+                    prodCounterInc("lsp.fast_path.syntax_error_edits");
+                    continue;
+                }
+                // Definition-granularity comparison. hierarchyHash only says that *something*
+                // definition-shaped changed; diffing the per-name entries and intersecting them
+                // against the usage indexes lets an edit ride the fast path when every changed
+                // definition is used nowhere else — renaming a private helper retypechecks just
+                // this file. Any outside user forces the slow path: deleted definitions linger in
+                // the symbol table (namer cannot remove symbols), so a caller elsewhere would
+                // still resolve the stale symbol, and class changes reach users of *subclasses*
+                // that never mention the changed name.
+                auto &newDefs = hashes[i].definitions.defHashes;
+                auto &oldDefs = oldHash.definitions.defHashes;
+                vector<core::NameHash> changedDefs;
+                for (auto &entry : oldDefs) {
+                    auto fnd = newDefs.find(entry.first);
+                    if (fnd == newDefs.end() || fnd->second != entry.second) {
+                        changedDefs.emplace_back(entry.first);
+                    }
+                }
+                for (auto &entry : newDefs) {
+                    if (!oldDefs.contains(entry.first)) {
+                        changedDefs.emplace_back(entry.first);
+                    }
+                }
+                // Deleted methods need the same treatment (added and changed ones ride the
+                // existing methodHashes machinery): the stale symbol would keep satisfying
+                // callers, silently suppressing their method-does-not-exist errors.
+                for (auto &entry : oldHash.definitions.methodHashes) {
+                    if (!hashes[i].definitions.methodHashes.contains(entry.first)) {
+                        changedDefs.emplace_back(entry.first);
+                    }
+                }
+                for (auto &changed : changedDefs) {
+                    if (nameUsedOutsideFile(changed, fref)) {
+                        logger->debug("Taking slow path because {} changed a definition used elsewhere", f->path());
+                        return false;
+                    }
+                }
+                if (!changedDefs.empty()) {
+                    prodCounterInc("lsp.fast_path.local_definition_edits");
                 }
             }
         }
@@ -287,6 +492,7 @@ LSPLoop::TypecheckRun LSPLoop::runTypechecking(unique_ptr<core::GlobalState> gs,
     bool takeFastPath = false;
     vector<core::FileRef> subset;
     vector<core::NameHash> changedHashes;
+    vector<pair<core::FileRef, vector<core::NameHash>>> unchangedBodyCandidates;
     {
         Timer timeit(logger, "fast_path_decision");
         auto hashes = computeStateHashes(updates.updatedFiles);
@@ -303,15 +509,51 @@ LSPLoop::TypecheckRun LSPLoop::runTypechecking(unique_ptr<core::GlobalState> gs,
                 auto &oldHash = globalStateHashes[fref.id()];
                 for (auto &p : hashes[i].definitions.methodHashes) {
                     auto fnd = oldHash.definitions.methodHashes.find(p.first);
-                    ENFORCE(fnd != oldHash.definitions.methodHashes.end(), "definitionHash should have failed");
-                    if (fnd->second != p.second) {
+                    // A key missing from the old hash is a method this edit added; its callers
+                    // (sitting on method-does-not-exist errors) are dependants like any other.
+                    if (fnd == oldHash.definitions.methodHashes.end() || fnd->second != p.second) {
                         changedHashes.emplace_back(p.first);
                     }
                 }
+                // Shape changes (arity, keyword args) are hashed separately from hierarchyHash, so
+                // they also ride the fast path; their dependants are found through the same indexes.
+                for (auto &p : hashes[i].definitions.methodShapeHashes) {
+                    auto fnd = oldHash.definitions.methodShapeHashes.find(p.first);
+                    if (fnd == oldHash.definitions.methodShapeHashes.end() || fnd->second != p.second) {
+                        changedHashes.emplace_back(p.first);
+                    }
+                }
+                // Methods of this file whose source text the edit did not touch infer to the
+                // previous result unless their signature changed or they call something that did;
+                // when the file was diagnostic-free last run there is nothing to replay for them,
+                // so they can skip inference like unedited dependants do. Files with prior errors
+                // re-infer everything so diagnostics are recomputed (or cleared) at fresh
+                // positions, and a sigil change re-infers everything because it rescopes which
+                // errors the file reports at all. Filtered against changedHashes below, once that
+                // set is complete.
+                if (f->originalSigil == fref.data(*initialGS).originalSigil &&
+                    !absl::c_linear_search(this->filesThatHaveErrors, fref)) {
+                    vector<core::NameHash> unchanged;
+                    const auto &oldBodies = oldHash.methodBodyHashes;
+                    for (auto &p : hashes[i].methodBodyHashes) {
+                        auto fnd = oldBodies.find(p.first);
+                        if (fnd != oldBodies.end() && fnd->second == p.second) {
+                            unchanged.emplace_back(p.first);
+                        }
+                    }
+                    unchangedBodyCandidates.emplace_back(fref, move(unchanged));
+                }
                 gs = core::GlobalState::replaceFile(move(gs), fref, f);
                 subset.emplace_back(fref);
             }
             // Note: We may not have an id yet for this file if it is brand new, so we store hashes with their paths.
+            if (takeFastPath && fref.exists() &&
+                hashes[i].definitions.hierarchyHash == core::GlobalStateHash::HASH_STATE_INVALID) {
+                // A syntax-broken edit riding the fast path keeps its last good hashes and usage
+                // index entries committed: the degraded parse has none of its own, and the next
+                // parseable state must be compared against the state before the breakage.
+                continue;
+            }
             updates.updatedFileHashes.push_back(make_pair(f->path(), hashes[i]));
         }
         core::NameHash::sortAndDedupe(changedHashes);
@@ -322,27 +564,87 @@ LSPLoop::TypecheckRun LSPLoop::runTypechecking(unique_ptr<core::GlobalState> gs,
     }
 
     Timer timeit(logger, "fast_path");
-    int i = -1;
-    for (auto &oldHash : globalStateHashes) {
-        i++;
-        vector<core::NameHash> intersection;
-        std::set_intersection(changedHashes.begin(), changedHashes.end(), oldHash.usages.sends.begin(),
-                              oldHash.usages.sends.end(), std::back_inserter(intersection));
-        if (!intersection.empty()) {
-            auto ref = core::FileRef(i);
-            logger->debug("Added {} to update set as used a changed method", !ref.exists() ? "" : ref.data(*gs).path());
-            subset.emplace_back(ref);
+    vector<core::FileRef> editedFiles = subset;
+    vector<core::FileRef> dependantFiles;
+    // Callers come from the send index. The constant index additionally finds files that define or
+    // override a method with a changed name (method definition names are collected as constant
+    // usages), whose override-compatibility checks depend on the changed signature.
+    for (auto &changed : changedHashes) {
+        for (const auto *index : {&filesBySendHash, &filesByConstantHash}) {
+            auto it = index->find(changed);
+            if (it == index->end()) {
+                continue;
+            }
+            for (auto ref : it->second) {
+                logger->debug("Added {} to update set as used a changed method",
+                              !ref.exists() ? "" : ref.data(*gs).path());
+                subset.emplace_back(ref);
+                dependantFiles.emplace_back(ref);
+            }
         }
     }
     // Remove any duplicate files.
     fast_sort(subset);
     subset.resize(std::distance(subset.begin(), std::unique(subset.begin(), subset.end())));
 
+    // Files pulled in only as dependants were not edited; methods in them that don't call a changed
+    // method will infer to exactly the previous result. When that result was diagnostic-free, such
+    // methods can skip inference entirely. Files that reported errors last run are excluded so their
+    // diagnostics get faithfully recomputed (or cleared).
+    pipeline::IncrementalTypecheckInfo incrementalInfo;
+    incrementalInfo.changedMethodHashes = changedHashes;
+    {
+        UnorderedSet<core::FileRef> excluded(editedFiles.begin(), editedFiles.end());
+        for (auto f : this->filesThatHaveErrors) {
+            excluded.insert(f);
+        }
+        for (auto ref : dependantFiles) {
+            if (excluded.find(ref) == excluded.end()) {
+                incrementalInfo.dependantFilesWithoutErrors.emplace_back(ref);
+            }
+        }
+        fast_sort(incrementalInfo.dependantFilesWithoutErrors);
+        incrementalInfo.dependantFilesWithoutErrors.resize(
+            std::distance(incrementalInfo.dependantFilesWithoutErrors.begin(),
+                          std::unique(incrementalInfo.dependantFilesWithoutErrors.begin(),
+                                      incrementalInfo.dependantFilesWithoutErrors.end())));
+    }
+    for (auto &candidate : unchangedBodyCandidates) {
+        auto &unchanged = candidate.second;
+        // A changed signature or shape re-infers the method even when its body text is identical:
+        // sigs live outside the def's source range, so only the method hashes see them.
+        unchanged.erase(remove_if(unchanged.begin(), unchanged.end(),
+                                  [&changedHashes](const core::NameHash &h) {
+                                      return binary_search(changedHashes.begin(), changedHashes.end(), h);
+                                  }),
+                        unchanged.end());
+        if (!unchanged.empty()) {
+            core::NameHash::sortAndDedupe(unchanged);
+            incrementalInfo.unchangedMethodsInEditedFiles[candidate.first] = move(unchanged);
+        }
+    }
+
     prodCategoryCounterInc("lsp.updates", "fastpath");
     logger->debug("Taking fast path");
     ENFORCE(initialGS->errorQueue->isEmpty());
     vector<ast::ParsedFile> updatedIndexed;
     for (auto &f : subset) {
+        // Only the edited files have new text. Dependants were pulled in by the usage indexes and
+        // their previous parse is still exact, so splice in the stored tree the way runQuery does
+        // instead of running the parser on them again; on large files the parser dominates
+        // fast-path latency, and the dependant set is usually the bulk of `subset`.
+        if (!absl::c_linear_search(editedFiles, f)) {
+            const int id = f.id();
+            const auto it = indexedFinalGS.find(id);
+            const auto &parsedFile = it == indexedFinalGS.end() ? indexed[id] : it->second;
+            if (parsedFile.tree) {
+                prodCounterInc("lsp.fast_path.reused_trees");
+                updatedIndexed.emplace_back(ast::ParsedFile{parsedFile.tree->deepCopy(), parsedFile.file});
+                // indexedFinalGS already holds this tree (or `indexed` still matches the file),
+                // so there is nothing to write back in commitTypecheckRun.
+                continue;
+            }
+        }
         unique_ptr<KeyValueStore> kvstore; // nullptr
         // TODO: Thread through kvstore.
         ENFORCE(this->kvstore == nullptr);
@@ -353,7 +655,7 @@ LSPLoop::TypecheckRun LSPLoop::runTypechecking(unique_ptr<core::GlobalState> gs,
 
     ENFORCE(gs->lspQuery.isEmpty());
     auto resolved = pipeline::incrementalResolve(*gs, move(updatedIndexed), opts);
-    pipeline::typecheck(gs, move(resolved), opts, workers);
+    pipeline::typecheck(gs, move(resolved), opts, workers, &incrementalInfo);
     auto out = initialGS->errorQueue->drainWithQueryResponses();
     gs->lspTypecheckCount++;
     return TypecheckRun{move(out.first), move(subset), move(gs), move(updates), true};
@@ -369,21 +671,45 @@ LSPLoop::QueryRun LSPLoop::runQuery(unique_ptr<core::GlobalState> gs, const core
     prodCategoryCounterInc("lsp.updates", "query");
     ENFORCE(initialGS->errorQueue->isEmpty());
     vector<ast::ParsedFile> updatedIndexed;
+    vector<ast::ParsedFile> resolvedFromCache;
     for (auto &f : filesForQuery) {
         const int id = f.id();
+        auto cached = queryTreeCache.find(id);
+        if (cached != queryTreeCache.end()) {
+            prodCounterInc("lsp.query_tree_cache.hit");
+            resolvedFromCache.emplace_back(move(cached->second));
+            queryTreeCache.erase(cached);
+            continue;
+        }
+        prodCounterInc("lsp.query_tree_cache.miss");
         const auto it = indexedFinalGS.find(id);
         const auto &parsedFile = it == indexedFinalGS.end() ? indexed[id] : it->second;
         if (parsedFile.tree) {
             updatedIndexed.emplace_back(ast::ParsedFile{parsedFile.tree->deepCopy(), parsedFile.file});
+        } else if (parsedFile.file.exists()) {
+            // The tree was dropped after the initial typecheck; re-index it for this query.
+            unique_ptr<KeyValueStore> kvstore; // nullptr
+            updatedIndexed.emplace_back(pipeline::indexOne(opts, *gs, parsedFile.file, kvstore));
         }
     }
 
     ENFORCE(gs->lspQuery.isEmpty());
     gs->lspQuery = q;
     auto resolved = pipeline::incrementalResolve(*gs, move(updatedIndexed), opts);
+    for (auto &t : resolvedFromCache) {
+        resolved.emplace_back(move(t));
+    }
     tryApplyDefLocSaver(*gs, resolved);
     tryApplyLocalVarSaver(*gs, resolved);
-    pipeline::typecheck(gs, move(resolved), opts, workers);
+    auto typechecked = pipeline::typecheck(gs, move(resolved), opts, workers);
+    for (auto &t : typechecked) {
+        // CFG construction and inference leave the tree itself untouched, and flatten is a no-op
+        // on its own output, so the tree can seed the next query against this file. RBI files come
+        // back as placeholder empty trees (typecheckOne skips them) and must not be cached.
+        if (t.tree != nullptr && !ast::isa_tree<ast::EmptyTree>(t.tree.get())) {
+            queryTreeCache[t.file.id()] = move(t);
+        }
+    }
     auto out = initialGS->errorQueue->drainWithQueryResponses();
     gs->lspTypecheckCount++;
     gs->lspQuery = core::lsp::Query::noQuery();
@@ -0,0 +1,214 @@
+#include "NativeFileWatcher.h"
+#include "common/FileOps.h"
+
+#ifdef __linux__
+#include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace sorbet::realmain::lsp::watcher {
+
+NativeFileWatcher::NativeFileWatcher(
+    shared_ptr<spdlog::logger> logger, string_view workSpace, vector<string> extensions,
+    function<void(unique_ptr<sorbet::realmain::lsp::WatchmanQueryResponse>)> processUpdate,
+    std::function<void(int)> processExit)
+    : logger(std::move(logger)), workSpace(string(workSpace)), extensions(std::move(extensions)),
+      processUpdate(std::move(processUpdate)), processExit(std::move(processExit)),
+      thread(runInAThread("nativeFileWatcher", std::bind(&NativeFileWatcher::start, this))) {}
+
+NativeFileWatcher::~NativeFileWatcher() {
+    exitWithCode(0);
+    // Destructor of Joinable ensures the watcher thread exits before this destructor finishes.
+};
+
+bool NativeFileWatcher::isStopped() {
+    absl::MutexLock lck(&mutex);
+    return stopped;
+}
+
+void NativeFileWatcher::exitWithCode(int code) {
+    absl::MutexLock lck(&mutex);
+    if (!stopped) {
+        stopped = true;
+        processExit(code);
+    }
+}
+
+#ifdef __linux__
+
+namespace {
+
+constexpr uint32_t WATCH_MASK = IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+bool hasWatchedExtension(string_view path, const vector<string> &extensions) {
+    for (auto &ext : extensions) {
+        if (path.length() > ext.length() + 1 && path[path.length() - ext.length() - 1] == '.' &&
+            path.compare(path.length() - ext.length(), ext.length(), ext) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+string joinRelative(string_view relativeDir, string_view name) {
+    return relativeDir.empty() ? string(name) : fmt::format("{}/{}", relativeDir, name);
+}
+
+/**
+ * Adds a watch on the directory `relativePath` (relative to `workSpace`; "" for the workspace root) and, recursively,
+ * on every directory below it. Crawls with dirent like FileOps::listFilesInDir; this replaces watchman's initial
+ * crawl and only has to stat directories, not every file.
+ */
+void watchRecursively(int inotifyFd, const string &workSpace, const string &relativePath,
+                      UnorderedMap<int, string> &watchedDirs, spdlog::logger &logger) {
+    auto fullPath = relativePath.empty() ? workSpace : fmt::format("{}/{}", workSpace, relativePath);
+    auto wd = inotify_add_watch(inotifyFd, fullPath.c_str(), WATCH_MASK);
+    if (wd < 0) {
+        // The directory may have been removed between the event that led us here and now; not fatal.
+        logger.debug("inotify_add_watch failed for `{}`: {}", fullPath, strerror(errno));
+        return;
+    }
+    watchedDirs[wd] = relativePath;
+
+    DIR *dir;
+    struct dirent *entry;
+    if ((dir = opendir(fullPath.c_str())) == nullptr) {
+        return;
+    }
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_type != DT_DIR || strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        watchRecursively(inotifyFd, workSpace, joinRelative(relativePath, entry->d_name), watchedDirs, logger);
+    }
+    closedir(dir);
+}
+
+/**
+ * Inserts into `changed` the workspace-relative path of every watched file under `relativePath`.
+ */
+void collectFilesUnder(const string &workSpace, const string &relativePath,
+                       const UnorderedSet<string> &extensionsWithDot, UnorderedSet<string> &changed) {
+    auto fullPath = relativePath.empty() ? workSpace : fmt::format("{}/{}", workSpace, relativePath);
+    try {
+        for (auto &file : FileOps::listFilesInDir(fullPath, extensionsWithDot, true, {}, {})) {
+            changed.insert(file.substr(workSpace.length() + 1));
+        }
+    } catch (FileNotFoundException e) {
+        // Directory disappeared while we were looking at it; its deletion events will follow.
+    } catch (FileNotDirException e) {
+    }
+}
+
+} // namespace
+
+bool NativeFileWatcher::isSupported() {
+    return true;
+}
+
+void NativeFileWatcher::start() {
+    auto inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        logger->error("Unable to initialize inotify: {}", strerror(errno));
+        exitWithCode(1);
+        return;
+    }
+
+    UnorderedSet<string> extensionsWithDot;
+    for (auto &ext : extensions) {
+        extensionsWithDot.insert(fmt::format(".{}", ext));
+    }
+
+    logger->debug("Starting monitoring path {} with inotify for files with extensions {}", workSpace,
+                  fmt::join(extensions, ","));
+
+    UnorderedMap<int, string> watchedDirs;
+    watchRecursively(inotifyFd, workSpace, "", watchedDirs, *logger);
+
+    // inotify_event is followed by a name of up to NAME_MAX bytes; this fits many events per read.
+    alignas(struct inotify_event) char buf[64 * 1024];
+    UnorderedSet<string> changed;
+    while (!isStopped()) {
+        struct pollfd pfd = {inotifyFd, POLLIN, 0};
+        auto ready = poll(&pfd, 1, 100);
+        if (ready <= 0) {
+            // Timeout or EINTR. See if we should abort before waiting further.
+            continue;
+        }
+
+        // Drain everything the kernel has batched up before reporting, so a burst of events (e.g. a git branch
+        // switch) arrives downstream as a single update rather than thousands.
+        bool overflowed = false;
+        ssize_t len;
+        while ((len = read(inotifyFd, buf, sizeof(buf))) > 0) {
+            for (char *ptr = buf; ptr < buf + len;) {
+                auto *event = reinterpret_cast<const struct inotify_event *>(ptr);
+                ptr += sizeof(struct inotify_event) + event->len;
+
+                if ((event->mask & IN_Q_OVERFLOW) != 0) {
+                    overflowed = true;
+                    continue;
+                }
+                auto it = watchedDirs.find(event->wd);
+                if ((event->mask & IN_IGNORED) != 0) {
+                    // The kernel dropped this watch (the directory was deleted or moved away).
+                    if (it != watchedDirs.end()) {
+                        watchedDirs.erase(it);
+                    }
+                    continue;
+                }
+                if (it == watchedDirs.end() || event->len == 0) {
+                    continue;
+                }
+
+                auto relativePath = joinRelative(it->second, event->name);
+                if ((event->mask & IN_ISDIR) != 0) {
+                    if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+                        // Watch the new directory, and pick up any files that landed in it before the watch
+                        // was in place.
+                        watchRecursively(inotifyFd, workSpace, relativePath, watchedDirs, *logger);
+                        collectFilesUnder(workSpace, relativePath, extensionsWithDot, changed);
+                    }
+                } else if (hasWatchedExtension(relativePath, extensions)) {
+                    changed.insert(move(relativePath));
+                }
+            }
+        }
+
+        if (overflowed) {
+            // The kernel event queue overflowed and events were lost; conservatively report every watched file
+            // as changed so nothing stays stale.
+            logger->warn("inotify event queue overflowed; rescanning {}", workSpace);
+            collectFilesUnder(workSpace, "", extensionsWithDot, changed);
+        }
+
+        if (!changed.empty()) {
+            vector<string> files(make_move_iterator(changed.begin()), make_move_iterator(changed.end()));
+            changed.clear();
+            fast_sort(files);
+            logger->debug("Reporting {} changed files", files.size());
+            processUpdate(make_unique<sorbet::realmain::lsp::WatchmanQueryResponse>("", "", false, move(files)));
+        }
+    }
+
+    close(inotifyFd);
+}
+
+#else
+
+bool NativeFileWatcher::isSupported() {
+    return false;
+}
+
+void NativeFileWatcher::start() {
+    logger->error("The native file watcher is not supported on this platform; use Watchman instead.");
+    exitWithCode(1);
+}
+
+#endif
+
+} // namespace sorbet::realmain::lsp::watcher
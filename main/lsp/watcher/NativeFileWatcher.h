@@ -0,0 +1,57 @@
+#ifndef RUBY_TYPER_LSP_WATCHER_NATIVEFILEWATCHER_H
+#define RUBY_TYPER_LSP_WATCHER_NATIVEFILEWATCHER_H
+
+#include "absl/synchronization/mutex.h"
+#include "common/common.h"
+#include "core/core.h"
+#include "main/lsp/json_types.h"
+#include "spdlog/spdlog.h"
+
+namespace sorbet::realmain::lsp::watcher {
+class NativeFileWatcher {
+private:
+    std::shared_ptr<spdlog::logger> logger;
+    const std::string workSpace;
+    const std::vector<std::string> extensions;
+    const std::function<void(std::unique_ptr<sorbet::realmain::lsp::WatchmanQueryResponse>)> processUpdate;
+    const std::function<void(int)> processExit;
+    const std::unique_ptr<Joinable> thread;
+    // Mutex that must be held before reading or writing stopped.
+    absl::Mutex mutex;
+    // If true, the watcher has been stopped.
+    bool stopped = false;
+
+    /**
+     * Registers kernel watches on the workspace and begins processing file changes. Runs in a dedicated thread.
+     */
+    void start();
+
+    void exitWithCode(int code);
+
+    bool isStopped();
+
+public:
+    /**
+     * True if this platform has a kernel filesystem event API we know how to talk to (currently inotify on Linux).
+     */
+    static bool isSupported();
+
+    /**
+     * Immediately begins watching the provided workspace folder in-process and passes batches of changed files
+     * (as workspace-relative paths) to `processUpdate`. Callbacks have the same shape as those of
+     * watchman::WatchmanProcess so callers can treat the two interchangeably.
+     */
+    NativeFileWatcher(std::shared_ptr<spdlog::logger> logger, std::string_view workSpace,
+                      std::vector<std::string> extensions,
+                      std::function<void(std::unique_ptr<sorbet::realmain::lsp::WatchmanQueryResponse>)> processUpdate,
+                      std::function<void(int)> processExit);
+
+    ~NativeFileWatcher();
+
+    NativeFileWatcher(const NativeFileWatcher &&) = delete;
+    NativeFileWatcher(NativeFileWatcher &) = delete;
+    void operator=(const NativeFileWatcher &) = delete;
+};
+} // namespace sorbet::realmain::lsp::watcher
+
+#endif // RUBY_TYPER_LSP_WATCHER_NATIVEFILEWATCHER_H
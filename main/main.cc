@@ -1,7 +1,17 @@
 #include "common/common.h"
+#include "main/daemon.h"
 #include "main/options/options.h"
 #include "main/realmain.h"
+#include <cstring>
 int main(int argc, char *argv[]) {
+    // Daemon mode is dispatched before option parsing: the daemon forwards raw argv, so these
+    // flags must not be mixed into an ordinary invocation's options. See main/daemon.h.
+    if (argc >= 3 && strcmp(argv[1], "--daemon") == 0) {
+        return sorbet::realmain::daemonMain(argv[2]);
+    }
+    if (argc >= 3 && strcmp(argv[1], "--connect") == 0) {
+        return sorbet::realmain::clientMain(argv[2], argc - 3, argv + 3);
+    }
     try {
         // Initialize the symbolizer to get a human-readable stack trace
         return sorbet::realmain::realmain(argc, argv);
@@ -3,6 +3,7 @@
 #include "yaml-cpp/yaml.h"
 #include <cxxopts.hpp>
 
+#include "absl/algorithm/container.h"
 #include "absl/strings/str_split.h"
 #include "common/FileOps.h"
 #include "common/Timer.h"
@@ -45,6 +46,7 @@ const vector<PrintOptions> print_options({
     {"name-tree", &Printers::NameTree, true},
     {"name-tree-raw", &Printers::NameTreeRaw, true},
     {"file-table-json", &Printers::FileTableJson, true},
+    {"errors-proto", &Printers::ErrorsProto, true},
     {"resolve-tree", &Printers::ResolveTree, true},
     {"resolve-tree-raw", &Printers::ResolveTreeRaw, true},
     {"missing-constants", &Printers::MissingConstants, true},
@@ -53,8 +55,10 @@ const vector<PrintOptions> print_options({
     {"cfg", &Printers::CFG, true},
     {"cfg-json", &Printers::CFGJson, true},
     {"cfg-proto", &Printers::CFGProto, true},
-    {"autogen", &Printers::Autogen, true},
-    {"autogen-msgpack", &Printers::AutogenMsgPack, true},
+    // The two whole-output autogen printers stream records straight to their output file as
+    // workers finish (see runAutogen) rather than buffering through PrinterConfig.
+    {"autogen", &Printers::Autogen, true, false},
+    {"autogen-msgpack", &Printers::AutogenMsgPack, true, false},
     {"autogen-classlist", &Printers::AutogenClasslist, true},
     {"autogen-autoloader", &Printers::AutogenAutoloader, true, false},
     {"autogen-subclasses", &Printers::AutogenSubclasses, true},
@@ -100,6 +104,7 @@ vector<reference_wrapper<PrinterConfig>> Printers::printers() {
         NameTree,
         NameTreeRaw,
         FileTableJson,
+        ErrorsProto,
         ResolveTree,
         ResolveTreeRaw,
         MissingConstants,
@@ -122,6 +127,18 @@ bool Printers::isAutogen() const {
            AutogenAutoloader.enabled;
 }
 
+bool Printers::isMissingConstantsOnly() const {
+    if (!MissingConstants.enabled) {
+        return false;
+    }
+    int enabled = 0;
+    // printers() only hands out references; it never mutates.
+    for (PrinterConfig &cfg : const_cast<Printers *>(this)->printers()) {
+        enabled += cfg.enabled ? 1 : 0;
+    }
+    return enabled == 1;
+}
+
 struct StopAfterOptions {
     string option;
     Phase flag;
@@ -307,6 +324,18 @@ buildOptions(const vector<pipeline::semantic_extension::SemanticExtensionProvide
                                     cxxopts::value<vector<string>>(), "path");
     options.add_options("advanced")("web-trace-file", "Web trace file. For use with chrome about://tracing",
                                     cxxopts::value<string>()->default_value(empty.webTraceFile), "file");
+    options.add_options("advanced")("flamegraph-file",
+                                    "Write timer scopes as collapsed stacks with self-time attribution, for use with "
+                                    "flamegraph tooling",
+                                    cxxopts::value<string>()->default_value(empty.flamegraphFile), "file");
+    options.add_options("advanced")("hot-file-report",
+                                    "Write per-file phase timings (parse, desugar, dsl, local vars, typecheck) as "
+                                    "JSON, ranked by total time",
+                                    cxxopts::value<string>()->default_value(empty.hotFileReportFile), "file");
+    options.add_options("advanced")("hot-file-report-compare",
+                                    "Previous --hot-file-report artifact to diff against; ranks the new report by "
+                                    "largest regression",
+                                    cxxopts::value<string>()->default_value(empty.hotFileReportCompare), "file");
     options.add_options("advanced")("debug-log-file", "Path to debug log file",
                                     cxxopts::value<string>()->default_value(empty.debugLogFile), "file");
     options.add_options("advanced")("reserve-mem-kb",
@@ -332,6 +361,19 @@ buildOptions(const vector<pipeline::semantic_extension::SemanticExtensionProvide
     options.add_options("advanced")("watchman-path",
                                     "Path to watchman executable. Defaults to using `watchman` on your PATH.",
                                     cxxopts::value<string>()->default_value(empty.watchmanPath));
+    options.add_options("advanced")(
+        "watchman-debounce-ms",
+        "How long to wait for additional Watchman file change events before typechecking, so bursts of "
+        "events (e.g. a git branch switch) are merged into a single typecheck",
+        cxxopts::value<int>()->default_value(to_string(empty.watchmanDebounceMillis)), "ms");
+    options.add_options("advanced")("native-watcher",
+                                    "When in language-server-protocol mode, watch files with the built-in kernel "
+                                    "event watcher instead of Watchman. Currently Linux-only.");
+    options.add_options("advanced")(
+        "lsp-idle-maintenance-sec",
+        "How long the language server must sit idle before it drops rebuildable caches and returns freed memory "
+        "to the OS. 0 disables idle maintenance",
+        cxxopts::value<int>()->default_value(to_string(empty.lspIdleMaintenanceSeconds)), "sec");
     options.add_options("advanced")("enable-experimental-lsp-autocomplete",
                                     "Enable experimental LSP feature: Autocomplete");
     options.add_options("advanced")("enable-experimental-lsp-workspace-symbols",
@@ -354,7 +396,39 @@ buildOptions(const vector<pipeline::semantic_extension::SemanticExtensionProvide
         "Directory prefixes that are not accessible editor-side. References to files in these directories will be sent "
         "as sorbet: URIs to clients that understand them.",
         cxxopts::value<vector<string>>(), "string");
+    options.add_options("advanced")(
+        "deterministic",
+        "Merge parallel indexing results in input order instead of arrival order, so repeated runs over the same "
+        "inputs produce byte-identical serialized state (--store-state). Runs being compared must share the same "
+        "--threads value and cache state.");
     options.add_options("advanced")("no-error-count", "Do not print the error count summary line");
+    options.add_options("advanced")("count-errors-only",
+                                    "Report only the error count and exit code; skip building and printing "
+                                    "error details");
+    options.add_options("advanced")(
+        "max-errors-per-file",
+        "Once a file has produced this many errors, stop typechecking its remaining methods and report a single "
+        "summary diagnostic instead. 0 (the default) disables the budget",
+        cxxopts::value<int>()->default_value(to_string(empty.maxErrorsPerFile)), "n");
+    options.add_options("advanced")("error-baseline",
+                                    "Only print errors for files whose error set changed since the previous run with "
+                                    "the same --cache-dir");
+    options.add_options("advanced")(
+        "pinned-dir",
+        "Declare a directory (e.g. vendor/) immutable: when its files are unchanged since the last run in which they "
+        "typechecked without errors, they skip CFG and inference on startup. Requires --cache-dir.",
+        cxxopts::value<vector<string>>(), "dir");
+    options.add_options("advanced")(
+        "file-class",
+        "Assign input files to a named class: <class>:<pattern>, where <pattern> uses --ignore matching. Repeat to "
+        "add patterns; files not matching any class are unclassified. See --skip-file-class.",
+        cxxopts::value<vector<string>>(), "class:pattern");
+    options.add_options("advanced")(
+        "skip-file-class",
+        "Do not typecheck files in the given --file-class: they are still indexed and resolved, so definitions in "
+        "them stay visible to the rest of the run, but they report no resolve diagnostics and skip inference. Lets "
+        "CI gate production code without paying for the test shard.",
+        cxxopts::value<vector<string>>(), "class");
     options.add_options("advanced")("autogen-version", "Autogen version to output", cxxopts::value<int>());
     options.add_options("advanced")("stripe-mode", "Enable Stripe specific error enforcement", cxxopts::value<bool>());
 
@@ -420,6 +494,18 @@ buildOptions(const vector<pipeline::semantic_extension::SemanticExtensionProvide
                                cxxopts::value<string>()->default_value(""), "filepath.yaml");
     options.add_options("dev")("store-state", "Store state into file",
                                cxxopts::value<string>()->default_value(empty.storeState), "file");
+    options.add_options("dev")("store-state-delta", "Store only the difference against the compiled-in payload",
+                               cxxopts::value<string>()->default_value(empty.storeStateDelta), "file");
+    options.add_options("dev")("load-state-delta", "Apply a state delta on top of the compiled-in payload",
+                               cxxopts::value<string>()->default_value(empty.loadStateDelta), "file");
+    options.add_options("dev")("typecheck-shard", "Typecheck only shard <k> (0-based) of --typecheck-num-shards",
+                               cxxopts::value<int>()->default_value(to_string(empty.typecheckShard)), "k");
+    options.add_options("dev")("typecheck-num-shards", "Split the typecheck phase into this many shards",
+                               cxxopts::value<int>()->default_value(to_string(empty.typecheckNumShards)), "n");
+    options.add_options("dev")("typecheck-processes",
+                               "Fork this many processes after resolve; each typechecks one shard over the "
+                               "copy-on-write GlobalState",
+                               cxxopts::value<int>()->default_value(to_string(empty.typecheckProcesses)), "n");
     options.add_options("dev")("cache-dir", "Use the specified folder to cache data",
                                cxxopts::value<string>()->default_value(empty.cacheDir), "dir");
     options.add_options("dev")("suppress-non-critical", "Exit 0 unless there was a critical error");
@@ -441,10 +527,16 @@ buildOptions(const vector<pipeline::semantic_extension::SemanticExtensionProvide
         options.add_options("dev")("suggest-sig", "Report typing candidates. Only supported in debug builds");
     }
     options.add_options("dev")("suggest-typed", "Suggest which typed: sigils to add or upgrade");
+    options.add_options("dev")("batch-sig-suggestions",
+                               "Compute sig suggestions in a parallel post-pass instead of inline during inference");
     options.add_options("dev")("statsd-prefix", "StatsD prefix",
                                cxxopts::value<string>()->default_value(empty.statsdPrefix), "prefix");
     options.add_options("dev")("statsd-port", "StatsD server port",
                                cxxopts::value<int>()->default_value(fmt::format("{}", empty.statsdPort)), "port");
+    options.add_options("dev")("statsd-detail-sample-every",
+                               "Emit per-file phase timings to StatsD on 1 in every N runs (0 disables)",
+                               cxxopts::value<int>()->default_value(fmt::format("{}", empty.statsdDetailSampleEvery)),
+                               "N");
     options.add_options("dev")("metrics-file", "File to export metrics to",
                                cxxopts::value<string>()->default_value(empty.metricsFile), "file");
     options.add_options("dev")("metrics-prefix", "Prefix to use in metrics",
@@ -557,6 +649,27 @@ void parseIgnorePatterns(const vector<string> &rawIgnorePatterns, vector<string>
     }
 }
 
+bool Options::isFileClassSkipped(string_view path) const {
+    if (skippedFileClasses.empty()) {
+        return false;
+    }
+    // Match the way directory expansion probes ignore patterns: relative to the input root, with a
+    // leading "/" so absolute patterns anchor correctly.
+    if (path.length() >= 2 && path.substr(0, 2) == "./") {
+        path = path.substr(2);
+    }
+    auto probe = path.empty() || path.front() == '/' ? string(path) : fmt::format("/{}", path);
+    for (auto &klass : fileClasses) {
+        if (!absl::c_linear_search(skippedFileClasses, klass.name)) {
+            continue;
+        }
+        if (FileOps::isFileIgnored("", probe, klass.absolutePatterns, klass.relativePatterns)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool extractAutoloaderConfig(cxxopts::ParseResult &raw, Options &opts, shared_ptr<spdlog::logger> logger) {
     AutoloaderConfig &cfg = opts.autoloaderConfig;
     if (raw.count("autogen-autoloader-exclude-require") > 0) {
@@ -678,18 +791,68 @@ void readOptions(Options &opts,
         }
 
         opts.cacheDir = raw["cache-dir"].as<string>();
+        if (raw.count("pinned-dir") > 0) {
+            for (auto &dir : raw["pinned-dir"].as<vector<string>>()) {
+                auto normalized = dir;
+                while (!normalized.empty() && normalized.back() == '/') {
+                    normalized.pop_back();
+                }
+                if (!normalized.empty()) {
+                    opts.pinnedDirs.emplace_back(move(normalized));
+                }
+            }
+            if (!opts.pinnedDirs.empty() && opts.cacheDir.empty()) {
+                logger->error("--pinned-dir requires --cache-dir");
+                throw EarlyReturnWithCode(1);
+            }
+        }
+        if (raw.count("file-class") > 0) {
+            for (auto &spec : raw["file-class"].as<vector<string>>()) {
+                auto colon = spec.find(':');
+                if (colon == string::npos || colon == 0 || colon + 1 == spec.size()) {
+                    logger->error("--file-class must look like <class>:<pattern>, got `{}`", spec);
+                    throw EarlyReturnWithCode(1);
+                }
+                auto name = spec.substr(0, colon);
+                auto klass = absl::c_find_if(opts.fileClasses,
+                                             [&name](const auto &existing) { return existing.name == name; });
+                if (klass == opts.fileClasses.end()) {
+                    opts.fileClasses.emplace_back();
+                    klass = opts.fileClasses.end() - 1;
+                    klass->name = move(name);
+                }
+                vector<string> pattern = {spec.substr(colon + 1)};
+                parseIgnorePatterns(pattern, klass->absolutePatterns, klass->relativePatterns);
+            }
+        }
+        if (raw.count("skip-file-class") > 0) {
+            for (auto &name : raw["skip-file-class"].as<vector<string>>()) {
+                auto declared = absl::c_any_of(opts.fileClasses,
+                                               [&name](const auto &klass) { return klass.name == name; });
+                if (!declared) {
+                    logger->error("--skip-file-class: no --file-class named `{}`", name);
+                    throw EarlyReturnWithCode(1);
+                }
+                opts.skippedFileClasses.emplace_back(name);
+            }
+        }
         if (!extractPrinters(raw, opts, logger)) {
             throw EarlyReturnWithCode(1);
         }
         opts.stopAfterPhase = extractStopAfter(raw, logger);
 
         opts.silenceErrors = raw["quiet"].as<bool>();
+        opts.countErrorsOnly = raw["count-errors-only"].as<bool>();
         opts.autocorrect = raw["autocorrect"].as<bool>();
         opts.inlineInput = raw["e"].as<string>();
         if (opts.autocorrect && opts.silenceErrors) {
             logger->error("You may not use autocorrect when silencing errors.");
             throw EarlyReturnWithCode(1);
         }
+        if (opts.autocorrect && opts.countErrorsOnly) {
+            logger->error("You may not use autocorrect with count-errors-only; autocorrects are never built.");
+            throw EarlyReturnWithCode(1);
+        }
         if (opts.autocorrect && !opts.inlineInput.empty()) {
             logger->error("You may not use autocorrect with inline input.");
             throw EarlyReturnWithCode(1);
@@ -702,6 +865,9 @@ void readOptions(Options &opts,
         }
         opts.disableWatchman = raw["disable-watchman"].as<bool>();
         opts.watchmanPath = raw["watchman-path"].as<string>();
+        opts.watchmanDebounceMillis = raw["watchman-debounce-ms"].as<int>();
+        opts.nativeWatcher = raw["native-watcher"].as<bool>();
+        opts.lspIdleMaintenanceSeconds = raw["lsp-idle-maintenance-sec"].as<int>();
         // Certain features only need certain passes
         if (opts.print.isAutogen() && (opts.stopAfterPhase != Phase::NAMER)) {
             logger->error(
@@ -732,6 +898,21 @@ void readOptions(Options &opts,
         }
 
         opts.noErrorCount = raw["no-error-count"].as<bool>();
+        opts.maxErrorsPerFile = raw["max-errors-per-file"].as<int>();
+        if (opts.maxErrorsPerFile < 0) {
+            logger->error("--max-errors-per-file must be non-negative");
+            throw EarlyReturnWithCode(1);
+        }
+        opts.errorBaseline = raw["error-baseline"].as<bool>();
+        if (opts.errorBaseline && opts.cacheDir.empty()) {
+            logger->error("--error-baseline requires --cache-dir");
+            throw EarlyReturnWithCode(1);
+        }
+        if (opts.errorBaseline && opts.autocorrect) {
+            logger->error("--error-baseline may not be used with --autocorrect; suppressed errors would silently drop "
+                          "their autocorrects");
+            throw EarlyReturnWithCode(1);
+        }
         opts.noStdlib = raw["no-stdlib"].as<bool>();
         opts.stdoutHUPHack = raw["stdout-hup-hack"].as<bool>();
 
@@ -772,6 +953,25 @@ void readOptions(Options &opts,
         }
         opts.skipDSLPasses = raw["skip-dsl-passes"].as<bool>();
         opts.storeState = raw["store-state"].as<string>();
+        opts.storeStateDelta = raw["store-state-delta"].as<string>();
+        opts.loadStateDelta = raw["load-state-delta"].as<string>();
+        opts.typecheckShard = raw["typecheck-shard"].as<int>();
+        opts.typecheckNumShards = raw["typecheck-num-shards"].as<int>();
+        if (opts.typecheckNumShards < 1 || opts.typecheckShard < 0 ||
+            opts.typecheckShard >= opts.typecheckNumShards) {
+            logger->error("--typecheck-shard must be in [0, --typecheck-num-shards)");
+            throw EarlyReturnWithCode(1);
+        }
+        opts.typecheckProcesses = raw["typecheck-processes"].as<int>();
+        if (opts.typecheckProcesses < 1) {
+            logger->error("--typecheck-processes must be at least 1");
+            throw EarlyReturnWithCode(1);
+        }
+        if (opts.typecheckProcesses > 1 && opts.typecheckNumShards > 1) {
+            logger->error("--typecheck-processes assigns shards itself; it cannot be combined with "
+                          "--typecheck-num-shards");
+            throw EarlyReturnWithCode(1);
+        }
         opts.suggestTyped = raw["suggest-typed"].as<bool>();
         opts.waitForDebugger = raw["wait-for-dbg"].as<bool>();
         opts.stressIncrementalResolver = raw["stress-incremental-resolver"].as<bool>();
@@ -779,8 +979,10 @@ void readOptions(Options &opts,
         opts.enableCounters = raw["counters"].as<bool>();
         opts.silenceDevMessage = raw["silence-dev-message"].as<bool>();
         opts.censorForSnapshotTests = raw["censor-for-snapshot-tests"].as<bool>();
+        opts.deterministic = raw["deterministic"].as<bool>();
         opts.statsdHost = raw["statsd-host"].as<string>();
         opts.statsdPort = raw["statsd-port"].as<int>();
+        opts.statsdDetailSampleEvery = raw["statsd-detail-sample-every"].as<int>();
         opts.statsdPrefix = raw["statsd-prefix"].as<string>();
         opts.metricsSha = raw["metrics-sha"].as<string>();
         opts.metricsFile = raw["metrics-file"].as<string>();
@@ -789,6 +991,13 @@ void readOptions(Options &opts,
         opts.metricsPrefix = raw["metrics-prefix"].as<string>();
         opts.debugLogFile = raw["debug-log-file"].as<string>();
         opts.webTraceFile = raw["web-trace-file"].as<string>();
+        opts.flamegraphFile = raw["flamegraph-file"].as<string>();
+        opts.hotFileReportFile = raw["hot-file-report"].as<string>();
+        opts.hotFileReportCompare = raw["hot-file-report-compare"].as<string>();
+        if (!opts.hotFileReportCompare.empty() && opts.hotFileReportFile.empty()) {
+            logger->error("`{}` requires `{}`", "--hot-file-report-compare", "--hot-file-report");
+            throw EarlyReturnWithCode(1);
+        }
         opts.reserveMemKiB = raw["reserve-mem-kb"].as<u8>();
         if (raw.count("autogen-version") > 0) {
             if (!opts.print.AutogenMsgPack.enabled) {
@@ -815,6 +1024,7 @@ void readOptions(Options &opts,
         if (sorbet::debug_mode) {
             opts.suggestSig = raw["suggest-sig"].as<bool>();
         }
+        opts.batchSigSuggestions = raw["batch-sig-suggestions"].as<bool>();
 
         if (raw.count("e") == 0 && opts.inputFileNames.empty() && !opts.runLSP && opts.storeState.empty()) {
             logger->error("You must pass either `{}` or at least one folder or ruby file.\n\n{}", "-e",
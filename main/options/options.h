@@ -61,6 +61,7 @@ struct Printers {
     PrinterConfig SymbolTableFullRaw;
     PrinterConfig SymbolTableFullJson;
     PrinterConfig FileTableJson;
+    PrinterConfig ErrorsProto;
     PrinterConfig ResolveTree;
     PrinterConfig ResolveTreeRaw;
     PrinterConfig MissingConstants;
@@ -84,6 +85,10 @@ struct Printers {
 
     std::vector<std::reference_wrapper<PrinterConfig>> printers();
     bool isAutogen() const;
+    // True when MissingConstants is the only enabled printer. The sole resolver output it consumes
+    // is constant resolution, so a run that also stops at the resolver can skip the sig and
+    // finalization walks entirely (see pipeline::resolve).
+    bool isMissingConstantsOnly() const;
 };
 
 enum Phase {
@@ -127,31 +132,85 @@ struct Options {
     bool showProgress = false;
     bool suggestTyped = false;
     bool silenceErrors = false;
+    // Report only the error count and exit code: errors stop at (code, loc, file) and all detail
+    // computation — headers, sections, autocorrects, line/column conversion — is skipped. For CI
+    // gates that never read the diagnostics.
+    bool countErrorsOnly = false;
     bool silenceDevMessage = false;
     bool suggestSig = false;
+    // Collect sig-suggestion evidence during inference and build the suggestions (and their
+    // UntypedMethod errors) in a parallel post-pass, instead of running the full guessing
+    // machinery inline per method. Intended for whole-repo suggestion sweeps.
+    bool batchSigSuggestions = false;
     bool supressNonCriticalErrors = false;
     bool runLSP = false;
     bool disableWatchman = false;
     std::string watchmanPath = "watchman";
+    int watchmanDebounceMillis = 100;
+    bool nativeWatcher = false;
+    int lspIdleMaintenanceSeconds = 300;
     bool stressIncrementalResolver = false;
     bool noErrorCount = false;
+    // Per-file error budget: once a file has produced this many errors, its remaining methods skip
+    // CFG+inference and a single summary diagnostic is reported instead. 0 means unlimited. Bounds
+    // the cost of catastrophically broken files (usually codegen output), which can otherwise hold
+    // tens of thousands of errors each.
+    int maxErrorsPerFile = 0;
     bool autocorrect = false;
+    // Only print errors for files whose error set changed since the previous run with the same
+    // --cache-dir; the per-file baseline is persisted under the cache dir.
+    bool errorBaseline = false;
     bool waitForDebugger = false;
     bool skipDSLPasses = false;
     bool suggestRuntimeProfiledType = false;
     bool censorForSnapshotTests = false;
+    // Merge parallel indexing results in input order instead of arrival order, making name and
+    // symbol ids — and therefore serialized state (--store-state) — byte-reproducible across runs
+    // with the same inputs, --threads value, and cache state. Costs one GlobalState copy per index
+    // chunk instead of one per worker.
+    bool deterministic = false;
     int threads = 0;
     int logLevel = 0; // number of time -v was passed
     int autogenVersion = 0;
     bool stripeMode = false;
     std::string typedSource = "";
     std::string cacheDir = "";
+    // Directories declared immutable with --pinned-dir (vendor/, sorbet/rbi, ...). When nothing
+    // under one changed since the last run in which it typechecked without diagnostics, its files
+    // skip CFG+inference on startup; the record is persisted under the cache dir.
+    std::vector<std::string> pinnedDirs;
+    // File classification for split CI gates (--file-class / --skip-file-class). Files matching a
+    // skipped class's patterns stay in the run so the symbol table the remaining files check
+    // against is complete, but they are capped at `typed: false`: no resolve diagnostics, no
+    // CFG+inference. Patterns use --ignore semantics.
+    struct FileClass {
+        std::string name;
+        std::vector<std::string> absolutePatterns;
+        std::vector<std::string> relativePatterns;
+    };
+    std::vector<FileClass> fileClasses;
+    std::vector<std::string> skippedFileClasses;
+    bool isFileClassSkipped(std::string_view path) const;
     std::vector<std::string> configatronDirs;
     std::vector<std::string> configatronFiles;
     UnorderedMap<std::string, core::StrictLevel> strictnessOverrides;
     UnorderedMap<std::string, std::string> dslPluginTriggers;
     std::vector<std::string> dslRubyExtraArgs;
     std::string storeState = "";
+    // Write only the difference against the compiled-in payload instead of a full state image.
+    std::string storeStateDelta = "";
+    // Apply a delta produced by --store-state-delta on top of the compiled-in payload at startup.
+    std::string loadStateDelta = "";
+    // Typecheck only the files whose id falls in shard `typecheckShard` of `typecheckNumShards`.
+    // Lets a coordinator run index/name/resolve once, ship the state via --store-state, and fan the
+    // per-file typecheck phase out across machines; error streams and metrics merge downstream.
+    int typecheckShard = 0;
+    int typecheckNumShards = 1;
+    // Fork this many worker processes after resolve, one shard each. The children inherit the
+    // frozen GlobalState through copy-on-write pages, so the tables are shared with no
+    // synchronization and TypePtr refcount updates stay process-local instead of bouncing cache
+    // lines between NUMA sockets.
+    int typecheckProcesses = 1;
     bool enableCounters = false;
     std::vector<std::string> someCounters;
     std::string errorUrlBase = "https://srb.help/";
@@ -165,6 +224,8 @@ struct Options {
     std::string statsdHost;
     std::string statsdPrefix = "ruby_typer.unknown";
     int statsdPort = 8200;
+    // When positive, 1 in every N runs submits per-file phase timings to StatsD.
+    int statsdDetailSampleEvery = 0;
 
     std::string metricsFile;
     std::string metricsRepo = "none";
@@ -202,6 +263,9 @@ struct Options {
     std::string inlineInput; // passed via -e
     std::string debugLogFile;
     std::string webTraceFile;
+    std::string flamegraphFile;
+    std::string hotFileReportFile;
+    std::string hotFileReportCompare;
 
     std::shared_ptr<FileSystem> fs = std::make_shared<OSFileSystem>();
 
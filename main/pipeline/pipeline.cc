@@ -7,31 +7,45 @@
 #include "namer/configatron/configatron.h"
 #include "plugin/Plugins.h"
 #include "plugin/SubprocessTextPlugin.h"
+#include <limits>
 #include <sstream>
 #endif
 #include "ProgressIndicator.h"
+#include "absl/algorithm/container.h"
 #include "absl/strings/escaping.h" // BytesToHexString
 #include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "ast/ExpressionArena.h"
 #include "ast/desugar/Desugar.h"
 #include "ast/substitute/substitute.h"
 #include "ast/treemap/treemap.h"
 #include "cfg/CFG.h"
 #include "cfg/builder/builder.h"
 #include "common/FileOps.h"
+#include "common/ByteScan.h"
 #include "common/Timer.h"
+#include "common/os/os.h"
 #include "common/concurrency/ConcurrentQueue.h"
+#include "common/concurrency/GuidedChunks.h"
+#include "common/concurrency/WorkStealingQueue.h"
 #include "common/crypto_hashing/crypto_hashing.h"
 #include "core/GlobalSubstitution.h"
+#include "core/Hashing.h"
 #include "core/Unfreeze.h"
+#include "core/errors/infer.h"
 #include "core/errors/parser.h"
 #include "core/serialize/serialize.h"
 #include "definition_validator/validator.h"
 #include "dsl/dsl.h"
 #include "flattener/flatten.h"
+#include "infer/SigSuggestion.h"
 #include "infer/infer.h"
 #include "local_vars/local_vars.h"
 #include "main/pipeline/semantic_extension/SemanticExtension.h"
 #include "namer/namer.h"
+#include "parser/NodeArena.h"
 #include "parser/parser.h"
 #include "pipeline.h"
 #include "resolver/resolver.h"
@@ -40,55 +54,350 @@ using namespace std;
 
 namespace sorbet::realmain::pipeline {
 
+// Returns true if any send in the CFG dispatches to a name in `changedMethodHashes` (sorted).
+bool cfgUsesChangedMethod(core::Context ctx, const cfg::CFG &cfg,
+                          const vector<core::NameHash> &changedMethodHashes) {
+    for (auto &bb : cfg.basicBlocks) {
+        for (auto &bind : bb->exprs) {
+            if (auto *send = cfg::cast_instruction<cfg::Send>(bind.value)) {
+                core::NameHash funHash(ctx.state, send->fun.data(ctx));
+                if (binary_search(changedMethodHashes.begin(), changedMethodHashes.end(), funHash)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// Builds the CFG for one method and runs inference over it. Safe to call from multiple threads at
+// once (for different methods): it only reads the tree and GlobalState, and errors go through the
+// multi-producer ErrorQueue.
+bool isStaticInitMethod(core::Context ctx, core::SymbolRef sym) {
+    auto name = sym.data(ctx)->name;
+    if (name == core::Names::staticInit()) {
+        return true;
+    }
+    return name.data(ctx)->kind == core::NameKind::UNIQUE &&
+           name.data(ctx)->unique.original == core::Names::staticInit();
+}
+
+// Per-worker buffers for extensions using the deferred typecheck protocol (see SemanticExtension.h),
+// keyed by extension so several can batch independently. Harvested alongside the thread counters
+// when a worker finishes and handed to drainDeferredExtensionEvents after the fan-out.
+using DeferredExtensionEvents =
+    UnorderedMap<const sorbet::pipeline::semantic_extension::SemanticExtension *, vector<string>>;
+thread_local DeferredExtensionEvents deferredExtensionEvents;
+
+DeferredExtensionEvents getAndClearDeferredExtensionEvents() {
+    auto out = move(deferredExtensionEvents);
+    deferredExtensionEvents.clear();
+    return out;
+}
+
+void drainDeferredExtensionEvents(const core::GlobalState &gs, DeferredExtensionEvents events) {
+    if (events.empty()) {
+        return;
+    }
+    Timer timeit(gs.tracer(), "typecheck.drain_deferred_extension_events");
+    // One dedicated thread per extension: the drains are independent of each other and of the
+    // (already finished) inference workers, and an extension sees all workers' events in one call.
+    vector<unique_ptr<Joinable>> threads;
+    for (auto &entry : events) {
+        auto *extension = entry.first;
+        prodCounterAdd("types.semantic_extension.deferred_events", entry.second.size());
+        threads.emplace_back(runInAThread("extensionDrain", [&gs, extension, evs = move(entry.second)]() mutable {
+            extension->drainDeferred(gs, move(evs));
+        }));
+    }
+    threads.clear(); // joins
+}
+
+void typecheckMethod(core::Context ctx, const options::Options &opts,
+                     const vector<core::NameHash> *changedMethodHashes,
+                     const vector<core::NameHash> *unchangedMethodNames, ast::MethodDef *m) {
+    if (m->loc.file().data(ctx).strictLevel < core::StrictLevel::True || m->symbol.data(ctx)->isOverloaded()) {
+        return;
+    }
+    if (opts.maxErrorsPerFile > 0 &&
+        m->loc.file().data(ctx).errorCount() >= static_cast<u4>(opts.maxErrorsPerFile)) {
+        // The file blew its error budget, so the remaining diagnostics would be noise on top of
+        // noise; broken codegen output can hold tens of thousands of them. Methods already handed
+        // to workers may still finish after the count crosses the threshold — the budget bounds the
+        // work, it is not an exact cutoff. typecheckOne reports the summary diagnostic.
+        prodCounterInc("types.input.methods.skipped_error_budget");
+        return;
+    }
+    const auto &query = ctx.state.lspQuery;
+    if (query.kind == core::lsp::Query::Kind::LOC && query.loc.file() == m->loc.file() && m->loc.exists() &&
+        (m->loc.endPos() - m->loc.beginPos()) > 0 && !m->loc.contains(query.loc) &&
+        !isStaticInitMethod(ctx, m->symbol)) {
+        // A position query can only be answered from the method enclosing that position, so
+        // CFG+inference for every other `def` in the file would run purely to discard its results.
+        // <static-init> methods hold relocated class-body code (sigs included) whose locs the
+        // MethodDef loc doesn't span, and zero-length synthesized locs contain nothing, so both are
+        // typechecked unconditionally rather than reasoned about.
+        prodCounterInc("types.input.methods.skipped_query_scope");
+        return;
+    }
+    auto &print = opts.print;
+    if (m->isDSLSynthesizedTemplate() && query.isEmpty() && ctx.state.semanticExtensions.empty() &&
+        !print.CFG.enabled && !print.CFGJson.enabled && !print.CFGProto.enabled) {
+        // The DSL passes stamp this flag only on expansions whose bodies consist entirely of
+        // synthesized casts and T.unsafe stubs, so inference over them cannot produce diagnostics.
+        // A model-heavy codebase repeats a handful of such template shapes across thousands of prop
+        // accessors; running CFG+inference on each copy would only reconfirm the same clean result.
+        prodCounterInc("types.input.methods.skipped_dsl_template");
+        return;
+    }
+    auto cfg = cfg::CFGBuilder::buildFor(ctx.withOwner(m->symbol), *m);
+
+    if (opts.stopAfterPhase == options::Phase::CFG) {
+        return;
+    }
+    if (changedMethodHashes != nullptr) {
+        // In a dependant file every method is a candidate; in an edited file only the methods
+        // whose source text (and signature) the edit left alone are.
+        const bool candidate = unchangedMethodNames == nullptr ||
+                               binary_search(unchangedMethodNames->begin(), unchangedMethodNames->end(),
+                                             core::NameHash(ctx.state, m->name));
+        if (candidate && !cfgUsesChangedMethod(ctx, *cfg, *changedMethodHashes)) {
+            // This method did not change and calls nothing that changed, so inference would
+            // reproduce the previous (diagnostic-free) result.
+            prodCounterInc("types.input.methods.skipped_unchanged");
+            return;
+        }
+    }
+    cfg = infer::Inference::run(ctx.withOwner(cfg->symbol), move(cfg));
+    if (cfg) {
+        for (auto &extension : ctx.state.semanticExtensions) {
+            if (extension->defersTypecheck()) {
+                extension->deferTypecheck(ctx.state, *cfg, *m, deferredExtensionEvents[extension.get()]);
+            } else {
+                extension->typecheck(ctx.state, *cfg, *m);
+            }
+        }
+    }
+    if (print.CFG.enabled) {
+        print.CFG.fmt("{}\n\n", cfg->toString(ctx));
+    }
+#ifndef SORBET_REALMAIN_MIN
+    if ((print.CFGJson.enabled || print.CFGProto.enabled) && cfg->shouldExport(ctx.state)) {
+        auto proto = cfg::Proto::toProto(ctx.state, *cfg);
+        if (print.CFGJson.enabled) {
+            string buf = core::Proto::toJSON(proto);
+            print.CFGJson.print(buf);
+        } else {
+            // The proto wire format allows simply concatenating repeated message fields
+            string buf = cfg::Proto::toMulti(proto).SerializeAsString();
+            print.CFGProto.print(buf);
+        }
+    }
+#endif
+}
+
 class CFGCollectorAndTyper {
     const options::Options &opts;
+    // Non-null only for files that can prove methods unaffected by an incremental update; see
+    // IncrementalTypecheckInfo.
+    const vector<core::NameHash> *changedMethodHashes;
+    const vector<core::NameHash> *unchangedMethodNames;
 
 public:
-    CFGCollectorAndTyper(const options::Options &opts) : opts(opts){};
+    CFGCollectorAndTyper(const options::Options &opts, const vector<core::NameHash> *changedMethodHashes = nullptr,
+                         const vector<core::NameHash> *unchangedMethodNames = nullptr)
+        : opts(opts), changedMethodHashes(changedMethodHashes), unchangedMethodNames(unchangedMethodNames){};
 
     unique_ptr<ast::MethodDef> preTransformMethodDef(core::Context ctx, unique_ptr<ast::MethodDef> m) {
-        if (m->loc.file().data(ctx).strictLevel < core::StrictLevel::True || m->symbol.data(ctx)->isOverloaded()) {
-            return m;
+        typecheckMethod(ctx, opts, changedMethodHashes, unchangedMethodNames, m.get());
+        return m;
+    }
+};
+
+// Records the methods of a file without typechecking them, so that they can be fanned out to a
+// WorkerPool afterwards. After flatten every MethodDef sits either at the top level of the file or
+// directly in a ClassDef body (FlattenWalk hoists nested defs into those sequences), so a shallow
+// scan over them finds every method without a TreeMap walk that visits every node of every body.
+// The tree itself is not modified.
+void collectFlattenedMethodDefs(ast::Expression *expr, vector<ast::MethodDef *> &methods) {
+    if (auto *m = ast::cast_tree<ast::MethodDef>(expr)) {
+        methods.emplace_back(m);
+    } else if (auto *klass = ast::cast_tree<ast::ClassDef>(expr)) {
+        for (auto &stat : klass->rhs) {
+            collectFlattenedMethodDefs(stat.get(), methods);
         }
-        auto &print = opts.print;
-        auto cfg = cfg::CFGBuilder::buildFor(ctx.withOwner(m->symbol), *m);
+    } else if (auto *seq = ast::cast_tree<ast::InsSeq>(expr)) {
+        for (auto &stat : seq->stats) {
+            collectFlattenedMethodDefs(stat.get(), methods);
+        }
+        collectFlattenedMethodDefs(seq->expr.get(), methods);
+    }
+}
 
-        if (opts.stopAfterPhase == options::Phase::CFG) {
-            return m;
+// For a position query only the method enclosing the position can contribute responses.
+// typecheckMethod skips the others one at a time, but with the collected spans sorted the
+// enclosing def falls out of a binary search, so the work queue never sees the rest of the file's
+// methods at all. Methods kept unconditionally mirror typecheckMethod's rules: <static-init> holds
+// relocated class-body code its loc doesn't span, and zero-length synthesized locs contain nothing
+// to compare against.
+void narrowMethodsToLocQuery(core::Context ctx, core::FileRef f, vector<ast::MethodDef *> &methods) {
+    const auto &query = ctx.state.lspQuery;
+    if (query.kind != core::lsp::Query::Kind::LOC || query.loc.file() != f) {
+        return;
+    }
+    fast_sort(methods, [](const ast::MethodDef *a, const ast::MethodDef *b) {
+        return a->loc.beginPos() < b->loc.beginPos();
+    });
+    vector<ast::MethodDef *> selected;
+    for (auto *m : methods) {
+        if (!m->loc.exists() || m->loc.endPos() - m->loc.beginPos() == 0 || isStaticInitMethod(ctx, m->symbol)) {
+            selected.emplace_back(m);
         }
-        cfg = infer::Inference::run(ctx.withOwner(cfg->symbol), move(cfg));
-        if (cfg) {
-            for (auto &extension : ctx.state.semanticExtensions) {
-                extension->typecheck(ctx.state, *cfg, m);
+    }
+    // Methods do not nest after flatten, so the last real span starting at or before the query is
+    // the only one that can enclose it.
+    auto it = absl::c_upper_bound(methods, query.loc.beginPos(), [](u4 pos, const ast::MethodDef *m) {
+        return pos < m->loc.beginPos();
+    });
+    for (auto rit = make_reverse_iterator(it); rit != methods.rend(); ++rit) {
+        auto *candidate = *rit;
+        if (!candidate->loc.exists() || candidate->loc.endPos() - candidate->loc.beginPos() == 0 ||
+            isStaticInitMethod(ctx, candidate->symbol)) {
+            // Already kept unconditionally; keep looking for the enclosing real span.
+            continue;
+        }
+        if (candidate->loc.contains(query.loc)) {
+            selected.emplace_back(candidate);
+        }
+        break;
+    }
+    prodCounterAdd("types.input.methods.skipped_query_scope", methods.size() - selected.size());
+    methods = move(selected);
+}
+
+// Below this many methods the fan-out overhead outweighs the parallelism.
+constexpr size_t MIN_METHODS_FOR_PARALLEL_TYPECHECK = 32;
+
+void typecheckMethods(core::Context ctx, const options::Options &opts,
+                      const vector<core::NameHash> *changedMethodHashes,
+                      const vector<core::NameHash> *unchangedMethodNames, const vector<ast::MethodDef *> &methods,
+                      WorkerPool &workers) {
+    if (methods.size() < MIN_METHODS_FOR_PARALLEL_TYPECHECK) {
+        for (auto *m : methods) {
+            typecheckMethod(ctx, opts, changedMethodHashes, unchangedMethodNames, m);
+        }
+        return;
+    }
+
+    auto methodq = make_shared<ConcurrentBoundedQueue<ast::MethodDef *>>(methods.size());
+    for (auto *m : methods) {
+        methodq->push(m, 1);
+    }
+    struct typecheck_methods_result {
+        CounterState counters;
+        DeferredExtensionEvents deferredEvents;
+    };
+    auto resultq = make_shared<BlockingBoundedQueue<typecheck_methods_result>>(methods.size());
+    workers.multiplexJob("typecheckMethods", [ctx, &opts, changedMethodHashes, unchangedMethodNames, methodq,
+                                              resultq]() {
+        ast::MethodDef *job = nullptr;
+        int processedByThread = 0;
+        for (auto result = methodq->try_pop(job); !result.done(); result = methodq->try_pop(job)) {
+            if (result.gotItem()) {
+                processedByThread++;
+                try {
+                    typecheckMethod(ctx, opts, changedMethodHashes, unchangedMethodNames, job);
+                } catch (SorbetException &) {
+                    Exception::failInFuzzer();
+                    auto file = job->loc.file();
+                    if (auto e = ctx.state.beginError(core::Loc::none(file), core::errors::Internal::InternalError)) {
+                        e.setHeader("Exception in cfg+infer: {} (backtrace is above)", file.data(ctx).path());
+                    }
+                }
             }
         }
-        if (print.CFG.enabled) {
-            print.CFG.fmt("{}\n\n", cfg->toString(ctx));
+        if (processedByThread > 0) {
+            typecheck_methods_result threadResult;
+            threadResult.counters = getAndClearThreadCounters();
+            threadResult.deferredEvents = getAndClearDeferredExtensionEvents();
+            resultq->push(move(threadResult), processedByThread);
         }
-#ifndef SORBET_REALMAIN_MIN
-        if ((print.CFGJson.enabled || print.CFGProto.enabled) && cfg->shouldExport(ctx.state)) {
-            auto proto = cfg::Proto::toProto(ctx.state, *cfg);
-            if (print.CFGJson.enabled) {
-                string buf = core::Proto::toJSON(proto);
-                print.CFGJson.print(buf);
-            } else {
-                // The proto wire format allows simply concatenating repeated message fields
-                string buf = cfg::Proto::toMulti(proto).SerializeAsString();
-                print.CFGProto.print(buf);
+    });
+
+    // The drain doubles as the barrier: typecheckOne must not return before all methods are done.
+    // Deferred extension events fold into the calling thread's buffer so the caller's harvest sees
+    // them like its own.
+    typecheck_methods_result threadResult;
+    for (auto result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), ctx.state.tracer());
+         !result.done();
+         result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), ctx.state.tracer())) {
+        if (result.gotItem()) {
+            counterConsume(move(threadResult.counters));
+            for (auto &entry : threadResult.deferredEvents) {
+                auto &merged = deferredExtensionEvents[entry.first];
+                merged.insert(merged.end(), make_move_iterator(entry.second.begin()),
+                              make_move_iterator(entry.second.end()));
             }
         }
-#endif
-        return m;
     }
-};
+}
+
+// Batch suggestion mode (--batch-sig-suggestions): inference recorded per-method evidence instead
+// of building suggestions inline; compute the suggestions and report their UntypedMethod errors
+// here, fanned out over the worker pool. Runs after the typecheck fan-out, so realmain's final
+// flush is what prints these errors.
+void emitDeferredSigSuggestions(const core::GlobalState &gs, WorkerPool &workers) {
+    auto evidence = infer::SigSuggestion::drainEvidence();
+    if (evidence.empty()) {
+        return;
+    }
+    Timer timeit(gs.tracer(), "typecheck.sig_suggestions");
+    prodCounterAdd("types.sig_suggestions.deferred", evidence.size());
+
+    auto jobq = make_shared<ConcurrentBoundedQueue<infer::SigSuggestion::SigEvidence>>(evidence.size());
+    for (auto &e : evidence) {
+        jobq->push(move(e), 1);
+    }
+    auto resultq = make_shared<BlockingBoundedQueue<CounterState>>(evidence.size());
+    workers.multiplexJob("sigSuggestions", [&gs, jobq, resultq]() {
+        core::Context ctx(gs, core::Symbols::root());
+        infer::SigSuggestion::SigEvidence job;
+        int processedByThread = 0;
+        for (auto result = jobq->try_pop(job); !result.done(); result = jobq->try_pop(job)) {
+            if (result.gotItem()) {
+                processedByThread++;
+                if (auto e = gs.beginError(job.method.data(gs)->loc(), core::errors::Infer::UntypedMethod)) {
+                    e.setHeader("This function does not have a `sig`");
+                    infer::SigSuggestion::emitSuggestion(ctx, e, job);
+                }
+            }
+        }
+        if (processedByThread > 0) {
+            resultq->push(getAndClearThreadCounters(), processedByThread);
+        }
+    });
+
+    // Drain doubles as the barrier: every suggestion must be on the error queue before the caller
+    // reaches realmain's final flush.
+    CounterState threadCounters;
+    for (auto result = resultq->wait_pop_timed(threadCounters, WorkerPool::BLOCK_INTERVAL(), gs.tracer());
+         !result.done();
+         result = resultq->wait_pop_timed(threadCounters, WorkerPool::BLOCK_INTERVAL(), gs.tracer())) {
+        if (result.gotItem()) {
+            counterConsume(move(threadCounters));
+        }
+    }
+}
 
 string fileKey(core::GlobalState &gs, core::FileRef file) {
-    auto path = file.data(gs).path();
-    string key(path.begin(), path.end());
-    key += "//";
-    auto hashBytes = sorbet::crypto_hashing::hash64(file.data(gs).source());
-    key += absl::BytesToHexString(string_view{(char *)hashBytes.data(), size(hashBytes)});
-    return key;
+    // Cache entries are keyed purely by content hash: parsing, desugaring and the DSL passes look
+    // only at file contents, and Serializer::loadExpression rebinds the stored tree to the caller's
+    // FileRef. Keying on content (rather than path + content) lets renamed files and identical
+    // copies hit the same entry, which matters a lot for warm-cache startup across CI checkouts.
+    // A fast non-cryptographic hash: these keys gate a content-addressed cache, not an integrity
+    // check, and hashing every file shows up on LSP updates with the cryptographic one.
+    auto hashBytes = sorbet::crypto_hashing::hash128Fast(file.data(gs).source());
+    return absl::BytesToHexString(string_view{(char *)hashBytes.data(), size(hashBytes)});
 }
 
 unique_ptr<ast::Expression> fetchTreeFromCache(core::GlobalState &gs, core::FileRef file,
@@ -118,10 +427,111 @@ void cacheTrees(core::GlobalState &gs, unique_ptr<KeyValueStore> &kvstore, vecto
             continue;
         }
         string fileHashKey = fileKey(gs, tree.file);
-        kvstore->write(fileHashKey, core::serialize::Serializer::storeExpression(gs, tree.tree));
+        kvstore->write(fileHashKey, core::serialize::Serializer::storeExpression(gs, *tree.tree));
     }
 }
 
+// Pickling a tree is the expensive half of caching it — KeyValueStore::write only stages the bytes
+// in memory — so the merge loop hands completed trees to a background serializer thread instead of
+// pickling them inline. LMDB only accepts writes from the thread that created the store, so the
+// pickled bytes come back through a second queue and are staged on the owner's thread. Callers must
+// not mutate or free an enqueued tree until flush() has returned.
+class TreeCacheWriter {
+    struct Job {
+        string key;
+        core::GlobalState *gs;
+        ast::Expression *tree; // nullptr is the shutdown marker pushed by the destructor
+    };
+    struct Result {
+        string key;
+        vector<u1> value;
+    };
+
+    unique_ptr<KeyValueStore> &kvstore;
+    spdlog::logger &tracer;
+    shared_ptr<BlockingUnBoundedQueue<Job>> jobq;
+    shared_ptr<BlockingUnBoundedQueue<Result>> resultq;
+    unique_ptr<Joinable> thread;
+    int inFlight = 0;
+
+    void stageResults(bool blockUntilEmpty) {
+        Result res;
+        while (inFlight > 0) {
+            auto result = blockUntilEmpty ? resultq->wait_pop_timed(res, WorkerPool::BLOCK_INTERVAL(), tracer)
+                                          : resultq->try_pop(res);
+            if (result.gotItem()) {
+                kvstore->write(res.key, res.value);
+                inFlight--;
+            } else if (!blockUntilEmpty) {
+                break;
+            }
+        }
+    }
+
+public:
+    TreeCacheWriter(unique_ptr<KeyValueStore> &kvstore, spdlog::logger &tracer) : kvstore(kvstore), tracer(tracer) {
+        if (!kvstore) {
+            return;
+        }
+        jobq = make_shared<BlockingUnBoundedQueue<Job>>();
+        resultq = make_shared<BlockingUnBoundedQueue<Result>>();
+        auto jobs = this->jobq;
+        auto results = this->resultq;
+        auto &log = this->tracer;
+        thread = runInAThread("treeCacheWriter", [jobs, results, &log]() {
+            Job job;
+            while (true) {
+                auto result = jobs->wait_pop_timed(job, WorkerPool::BLOCK_INTERVAL(), log);
+                if (!result.gotItem()) {
+                    continue;
+                }
+                if (job.tree == nullptr) {
+                    return;
+                }
+                results->push(Result{move(job.key), core::serialize::Serializer::storeExpression(*job.gs, *job.tree)},
+                              1);
+            }
+        });
+    }
+
+    TreeCacheWriter(const TreeCacheWriter &) = delete;
+    TreeCacheWriter &operator=(const TreeCacheWriter &) = delete;
+
+    // Same eligibility rules as cacheTrees; also opportunistically stages any pickles that have
+    // finished, so the staging cost is spread over the merge loop.
+    void enqueue(core::GlobalState &gs, vector<ast::ParsedFile> &trees) {
+        if (!kvstore) {
+            return;
+        }
+        for (auto &tree : trees) {
+            if (tree.file.data(gs).cachedParseTree || tree.file.data(gs).hasParseErrors) {
+                continue;
+            }
+            jobq->push(Job{fileKey(gs, tree.file), &gs, tree.tree.get()}, 1);
+            inFlight++;
+        }
+        stageResults(false);
+    }
+
+    // Blocks until every enqueued tree has been pickled and staged; after this the trees may be
+    // mutated or freed again.
+    void flush() {
+        if (!kvstore) {
+            return;
+        }
+        stageResults(true);
+    }
+
+    ~TreeCacheWriter() {
+        if (!kvstore) {
+            return;
+        }
+        stageResults(true);
+        jobq->push(Job{string(), nullptr, nullptr}, 1);
+        thread = nullptr; // joins the serializer thread
+    }
+};
+
 unique_ptr<parser::Node> runParser(core::GlobalState &gs, core::FileRef file, const options::Printers &print) {
     Timer timeit(gs.tracer(), "runParser", {{"file", (string)file.data(gs).path()}});
     unique_ptr<parser::Node> nodes;
@@ -161,6 +571,14 @@ unique_ptr<ast::Expression> runDesugar(core::GlobalState &gs, core::FileRef file
 }
 
 unique_ptr<ast::Expression> runDSL(core::GlobalState &gs, core::FileRef file, unique_ptr<ast::Expression> ast) {
+    if (!file.data(gs).hasDSLConstructs && gs.semanticExtensions.empty()) {
+        // The desugarer saw nothing any DSL rewriter keys on, so the pass would walk the whole
+        // tree only to hand it back unchanged. Semantic extensions can rewrite arbitrary sends,
+        // so their presence disables the skip. This pays off most under LSP, where every edited
+        // file is re-indexed (and re-hashed) on each keystroke.
+        prodCounterInc("dsl.files_skipped");
+        return ast;
+    }
     core::MutableContext ctx(gs, core::Symbols::root());
     Timer timeit(gs.tracer(), "runDSL", {{"file", (string)file.data(gs).path()}});
     core::UnfreezeNameTable nameTableAccess(gs); // creates temporaries during desugaring
@@ -193,6 +611,9 @@ ast::ParsedFile indexOne(const options::Options &opts, core::GlobalState &lgs, c
             if (file.data(lgs).strictLevel == core::StrictLevel::Ignore) {
                 return emptyParsedFile(file);
             }
+            // All parser nodes for this file live in one arena that is freed in one shot after
+            // desugaring has consumed the parse tree.
+            parser::NodeArena::Scope nodeArenaScope;
             auto parseTree = runParser(lgs, file, print);
             if (opts.stopAfterPhase == options::Phase::PARSER) {
                 return emptyParsedFile(file);
@@ -250,6 +671,8 @@ pair<ast::ParsedFile, vector<shared_ptr<core::File>>> indexOneWithPlugins(const
             if (file.data(gs).strictLevel == core::StrictLevel::Ignore) {
                 return emptyPluginFile(file);
             }
+            // See indexOne: parser nodes for this file are bump-allocated and freed in one shot.
+            parser::NodeArena::Scope nodeArenaScope;
             auto parseTree = runParser(gs, file, print);
             if (opts.stopAfterPhase == options::Phase::PARSER) {
                 return emptyPluginFile(file);
@@ -388,6 +811,14 @@ core::StrictLevel decideStrictLevel(const core::GlobalState &gs, const core::Fil
         level = core::StrictLevel::False;
     }
 
+    if (level > core::StrictLevel::False && level <= core::StrictLevel::Max && opts.isFileClassSkipped(filePath)) {
+        // Skipped classes are still indexed and resolved so their definitions stay visible to the
+        // rest of the run, but capping them at `typed: false` silences their resolve diagnostics
+        // and skips CFG+inference for them.
+        prodCounterInc("types.input.files.skipped_class");
+        level = core::StrictLevel::False;
+    }
+
     return level;
 }
 
@@ -426,23 +857,21 @@ void incrementStrictLevelCounter(core::StrictLevel level) {
     }
 }
 
-void readFileWithStrictnessOverrides(unique_ptr<core::GlobalState> &gs, core::FileRef file,
-                                     const options::Options &opts) {
-    if (file.dataAllowingUnsafe(*gs).sourceType != core::File::NotYetRead) {
-        return;
-    }
-    auto fileName = file.dataAllowingUnsafe(*gs).path();
-    Timer timeit(gs->tracer(), "readFileWithStrictnessOverrides", {{"file", (string)fileName}});
-    string src;
-    bool fileFound = true;
+// Reads `file`'s contents off disk. Returns false (and leaves `src` empty) when the file does not
+// exist; callers continue with an empty source because every input file must map to one output
+// tree. Does not touch the file table, so it can run on any thread.
+bool readFileContents(const core::GlobalState &gs, core::FileRef file, const options::Options &opts, string &src) {
     try {
-        src = opts.fs->readFile(fileName);
+        src = opts.fs->readFile(file.dataAllowingUnsafe(gs).path());
     } catch (FileNotFoundException e) {
-        // continue with an empty source, because the
-        // assertion below requires every input file to map
-        // to one output tree
-        fileFound = false;
+        return false;
     }
+    return true;
+}
+
+void enterFileWithStrictnessOverrides(unique_ptr<core::GlobalState> &gs, core::FileRef file, string src, bool fileFound,
+                                      const options::Options &opts) {
+    auto fileName = file.dataAllowingUnsafe(*gs).path();
     prodCounterAdd("types.input.bytes", src.size());
     prodCounterInc("types.input.files");
 
@@ -461,9 +890,15 @@ void readFileWithStrictnessOverrides(unique_ptr<core::GlobalState> &gs, core::Fi
         if (auto e = gs->beginError(sorbet::core::Loc::none(file), core::errors::Internal::FileNotFound)) {
             e.setHeader("File Not Found");
         }
+    } else if (!bytescan::isValidUTF8(fileData.source())) {
+        // Flagging this up front beats letting the lexer chew on malformed bytes one diagnostic at
+        // a time.
+        if (auto e = gs->beginError(sorbet::core::Loc::none(file), core::errors::Parser::ParserError)) {
+            e.setHeader("File is not valid UTF-8");
+        }
     }
 
-    if (!opts.storeState.empty()) {
+    if (!opts.storeState.empty() || !opts.storeStateDelta.empty()) {
         fileData.sourceType = core::File::PayloadGeneration;
     }
 
@@ -472,6 +907,79 @@ void readFileWithStrictnessOverrides(unique_ptr<core::GlobalState> &gs, core::Fi
     incrementStrictLevelCounter(level);
 }
 
+void readFileWithStrictnessOverrides(unique_ptr<core::GlobalState> &gs, core::FileRef file,
+                                     const options::Options &opts) {
+    if (file.dataAllowingUnsafe(*gs).sourceType != core::File::NotYetRead) {
+        return;
+    }
+    auto fileName = file.dataAllowingUnsafe(*gs).path();
+    Timer timeit(gs->tracer(), "readFileWithStrictnessOverrides", {{"file", (string)fileName}});
+    string src;
+    bool fileFound = readFileContents(*gs, file, opts, src);
+    enterFileWithStrictnessOverrides(gs, file, move(src), fileFound, opts);
+}
+
+// Reads the contents of all not-yet-read `files` on the worker pool and enters them into the file
+// table, so that by the time parser workers get to a file its contents are already in memory. On
+// cold caches (NFS-backed CI in particular) the index phase is I/O-latency-bound before it is
+// CPU-bound, and interleaving blocking reads with parsing leaves every worker stalled on its own
+// read; batching the reads keeps the full pool's worth of requests in flight at the disk.
+void prefetchFileContents(unique_ptr<core::GlobalState> &gs, const vector<core::FileRef> &files,
+                          const options::Options &opts, WorkerPool &workers) {
+    if (workers.size() <= 1) {
+        return;
+    }
+    auto fileq = make_shared<ConcurrentBoundedQueue<core::FileRef>>(files.size());
+    int pending = 0;
+    for (auto file : files) {
+        if (file.dataAllowingUnsafe(*gs).sourceType == core::File::NotYetRead) {
+            fileq->push(move(file), 1);
+            pending++;
+        }
+    }
+    if (pending == 0) {
+        return;
+    }
+    Timer timeit(gs->tracer(), "prefetchFileContents");
+
+    struct ReadResult {
+        core::FileRef file;
+        string src;
+        bool fileFound;
+    };
+    auto resultq = make_shared<BlockingBoundedQueue<vector<ReadResult>>>(pending);
+    const core::GlobalState &sharedGs = *gs;
+    workers.multiplexJob("prefetchFileContents", [&sharedGs, &opts, fileq, resultq]() {
+        vector<ReadResult> threadResult;
+        core::FileRef job;
+        for (auto result = fileq->try_pop(job); !result.done(); result = fileq->try_pop(job)) {
+            if (result.gotItem()) {
+                string src;
+                bool fileFound = readFileContents(sharedGs, job, opts, src);
+                threadResult.emplace_back(ReadResult{job, move(src), fileFound});
+            }
+        }
+        if (!threadResult.empty()) {
+            auto readByThread = threadResult.size();
+            resultq->push(move(threadResult), readByThread);
+        }
+    });
+
+    // Only this thread may mutate the file table, so workers hand contents back here to be entered.
+    {
+        vector<ReadResult> threadResult;
+        for (auto result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), gs->tracer());
+             !result.done();
+             result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), gs->tracer())) {
+            if (result.gotItem()) {
+                for (auto &read : threadResult) {
+                    enterFileWithStrictnessOverrides(gs, read.file, move(read.src), read.fileFound, opts);
+                }
+            }
+        }
+    }
+}
+
 struct IndexResult {
     unique_ptr<core::GlobalState> gs;
     vector<ast::ParsedFile> trees;
@@ -479,74 +987,151 @@ struct IndexResult {
 };
 
 struct IndexThreadResultPack {
+    // The merge may apply packs carrying this value in arrival order.
+    static constexpr size_t NO_SEQUENCE = std::numeric_limits<size_t>::max();
+
     CounterState counters;
     IndexResult res;
+    // Position of the pack's first file in the input order. Under --deterministic the producers
+    // emit one pack per chunk with this set, and mergeIndexResults applies them in input order so
+    // name and symbol ids come out identical from run to run.
+    size_t sequence = NO_SEQUENCE;
 };
 
+// Runs the namer over trees[firstNewTree..] on the collector thread. Worker threads only touch
+// their own deep copies of the proto GlobalState, so mutating the merged GlobalState here is safe
+// while they keep indexing, and the name phase overlaps the otherwise idle merge tail.
+void nameTreesWhileMerging(core::GlobalState &gs, vector<ast::ParsedFile> &trees, size_t firstNewTree) {
+    Timer timeit(gs.tracer(), "nameWhileMerging");
+    vector<ast::ParsedFile> batch;
+    batch.reserve(trees.size() - firstNewTree);
+    std::move(trees.begin() + firstNewTree, trees.end(), back_inserter(batch));
+    trees.erase(trees.begin() + firstNewTree, trees.end());
+    core::MutableContext ctx(gs, core::Symbols::root());
+    core::UnfreezeNameTable nameTableAccess(gs);     // creates singletons and class names
+    core::UnfreezeSymbolTable symbolTableAccess(gs); // enters symbols
+    batch = namer::Namer::run(ctx, move(batch));
+    trees.insert(trees.end(), make_move_iterator(batch.begin()), make_move_iterator(batch.end()));
+}
+
 IndexResult mergeIndexResults(const shared_ptr<core::GlobalState> cgs, const options::Options &opts,
                               shared_ptr<BlockingBoundedQueue<IndexThreadResultPack>> input,
-                              unique_ptr<KeyValueStore> &kvstore) {
+                              unique_ptr<KeyValueStore> &kvstore, bool runNamerWhileMerging = false) {
     ProgressIndicator progress(opts.showProgress, "Indexing", input->bound);
     Timer timeit(cgs->tracer(), "mergeIndexResults");
     IndexThreadResultPack threadResult;
     IndexResult ret;
+    TreeCacheWriter cacheWriter(kvstore, cgs->tracer());
+    auto applyPack = [&](IndexThreadResultPack threadResult) {
+        counterConsume(move(threadResult.counters));
+        auto firstNewTree = ret.trees.size();
+        if (ret.gs == nullptr) {
+            ret.gs = move(threadResult.res.gs);
+            ENFORCE(ret.trees.empty());
+            ret.trees = move(threadResult.res.trees);
+            ret.pluginGeneratedFiles = move(threadResult.res.pluginGeneratedFiles);
+            cacheWriter.enqueue(*ret.gs, ret.trees);
+        } else {
+            core::GlobalSubstitution substitution(*threadResult.res.gs, *ret.gs, cgs.get());
+            core::MutableContext ctx(*ret.gs, core::Symbols::root());
+            {
+                Timer timeit(cgs->tracer(), "substituteTrees");
+                for (auto &tree : threadResult.res.trees) {
+                    auto file = tree.file;
+                    core::ErrorRegion errs(*ret.gs, file);
+                    if (!file.data(*ret.gs).cachedParseTree) {
+                        tree.tree = ast::Substitute::run(ctx, substitution, move(tree.tree));
+                    }
+                }
+            }
+            cacheWriter.enqueue(*ret.gs, threadResult.res.trees);
+            ret.trees.insert(ret.trees.end(), make_move_iterator(threadResult.res.trees.begin()),
+                             make_move_iterator(threadResult.res.trees.end()));
+
+            ret.pluginGeneratedFiles.insert(ret.pluginGeneratedFiles.end(),
+                                            make_move_iterator(threadResult.res.pluginGeneratedFiles.begin()),
+                                            make_move_iterator(threadResult.res.pluginGeneratedFiles.end()));
+        }
+        if (runNamerWhileMerging) {
+            // Namer mutates the trees the serializer thread may still be pickling; wait for
+            // this batch's pickles before touching them.
+            cacheWriter.flush();
+            nameTreesWhileMerging(*ret.gs, ret.trees, firstNewTree);
+        }
+        ret.gs->errorQueue->flushErrors(*ret.gs);
+    };
+    // Packs tagged with a sequence (--deterministic) are applied in input order: `sequence` is the
+    // position of the pack's first file, so the next pack to apply is always the one whose
+    // sequence equals the number of trees applied so far. Out-of-order arrivals wait here.
+    UnorderedMap<size_t, IndexThreadResultPack> pending;
+    size_t nextSequence = 0;
     for (auto result = input->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), cgs->tracer()); !result.done();
          result = input->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), cgs->tracer())) {
         if (result.gotItem()) {
-            counterConsume(move(threadResult.counters));
-            if (ret.gs == nullptr) {
-                ret.gs = move(threadResult.res.gs);
-                ENFORCE(ret.trees.empty());
-                ret.trees = move(threadResult.res.trees);
-                ret.pluginGeneratedFiles = move(threadResult.res.pluginGeneratedFiles);
-                cacheTrees(*ret.gs, kvstore, ret.trees);
+            if (threadResult.sequence == IndexThreadResultPack::NO_SEQUENCE) {
+                applyPack(move(threadResult));
             } else {
-                core::GlobalSubstitution substitution(*threadResult.res.gs, *ret.gs, cgs.get());
-                core::MutableContext ctx(*ret.gs, core::Symbols::root());
-                {
-                    Timer timeit(cgs->tracer(), "substituteTrees");
-                    for (auto &tree : threadResult.res.trees) {
-                        auto file = tree.file;
-                        core::ErrorRegion errs(*ret.gs, file);
-                        if (!file.data(*ret.gs).cachedParseTree) {
-                            tree.tree = ast::Substitute::run(ctx, substitution, move(tree.tree));
-                        }
-                    }
+                auto sequence = threadResult.sequence;
+                pending.emplace(sequence, move(threadResult));
+                for (auto it = pending.find(nextSequence); it != pending.end(); it = pending.find(nextSequence)) {
+                    auto pack = move(it->second);
+                    pending.erase(it);
+                    nextSequence += pack.res.trees.size();
+                    applyPack(move(pack));
                 }
-                cacheTrees(*ret.gs, kvstore, threadResult.res.trees);
-                ret.trees.insert(ret.trees.end(), make_move_iterator(threadResult.res.trees.begin()),
-                                 make_move_iterator(threadResult.res.trees.end()));
-
-                ret.pluginGeneratedFiles.insert(ret.pluginGeneratedFiles.end(),
-                                                make_move_iterator(threadResult.res.pluginGeneratedFiles.begin()),
-                                                make_move_iterator(threadResult.res.pluginGeneratedFiles.end()));
             }
             progress.reportProgress(input->doneEstimate());
-            ret.gs->errorQueue->flushErrors();
         }
     }
+    ENFORCE(pending.empty(), "deterministic merge finished with {} unapplied packs", pending.size());
     return ret;
 }
 
 IndexResult indexSuppliedFiles(const shared_ptr<core::GlobalState> &baseGs, vector<core::FileRef> &files,
-                               const options::Options &opts, WorkerPool &workers, unique_ptr<KeyValueStore> &kvstore) {
+                               const options::Options &opts, WorkerPool &workers, unique_ptr<KeyValueStore> &kvstore,
+                               bool runNamerWhileMerging = false) {
     Timer timeit(baseGs->tracer(), "indexSuppliedFiles");
     auto resultq = make_shared<BlockingBoundedQueue<IndexThreadResultPack>>(files.size());
-    auto fileq = make_shared<ConcurrentBoundedQueue<core::FileRef>>(files.size());
-    for (auto &file : files) {
-        fileq->push(move(file), 1);
-    }
+    // Index units are small and fairly uniform (one file each), so chunked claims off a shared
+    // cursor beat a queue pop per file; see GuidedChunks.
+    auto chunks = make_shared<GuidedChunks>(files.size(), workers.size());
 
-    workers.multiplexJob("indexSuppliedFiles", [baseGs, &opts, fileq, resultq, &kvstore]() {
+    workers.multiplexJob("indexSuppliedFiles", [baseGs, &opts, &files, chunks, resultq, &kvstore]() {
         Timer timeit(baseGs->tracer(), "indexSuppliedFilesWorker");
-        unique_ptr<core::GlobalState> localGs = baseGs->deepCopy();
+        unique_ptr<core::GlobalState> localGs;
+        if (!opts.deterministic) {
+            localGs = baseGs->deepCopy();
+        }
         IndexThreadResultPack threadResult;
 
         {
-            core::FileRef job;
-            for (auto result = fileq->try_pop(job); !result.done(); result = fileq->try_pop(job)) {
-                if (result.gotItem()) {
-                    core::FileRef file = job;
+            size_t begin, end;
+            while (chunks->try_pop(begin, end)) {
+                if (opts.deterministic) {
+                    // One pack per chunk, built against a fresh copy of the base state: the pack's
+                    // name table is then a pure function of the chunk's files (chunk boundaries
+                    // depend only on the worker count), and the merge applying packs in input
+                    // order yields run-to-run identical name and symbol ids.
+                    IndexThreadResultPack chunkResult;
+                    chunkResult.sequence = begin;
+                    auto chunkGs = baseGs->deepCopy();
+                    for (auto i = begin; i < end; i++) {
+                        core::FileRef file = files[i];
+                        readFileWithStrictnessOverrides(chunkGs, file, opts);
+                        auto [parsedFile, pluginFiles] = indexOneWithPlugins(opts, *chunkGs, file, kvstore);
+                        chunkResult.res.pluginGeneratedFiles.insert(chunkResult.res.pluginGeneratedFiles.end(),
+                                                                    make_move_iterator(pluginFiles.begin()),
+                                                                    make_move_iterator(pluginFiles.end()));
+                        chunkResult.res.trees.emplace_back(move(parsedFile));
+                    }
+                    chunkResult.counters = getAndClearThreadCounters();
+                    chunkResult.res.gs = move(chunkGs);
+                    auto computedTreesCount = chunkResult.res.trees.size();
+                    resultq->push(move(chunkResult), computedTreesCount);
+                    continue;
+                }
+                for (auto i = begin; i < end; i++) {
+                    core::FileRef file = files[i];
                     readFileWithStrictnessOverrides(localGs, file, opts);
                     auto [parsedFile, pluginFiles] = indexOneWithPlugins(opts, *localGs, file, kvstore);
                     threadResult.res.pluginGeneratedFiles.insert(threadResult.res.pluginGeneratedFiles.end(),
@@ -565,11 +1150,11 @@ IndexResult indexSuppliedFiles(const shared_ptr<core::GlobalState> &baseGs, vect
         }
     });
 
-    return mergeIndexResults(baseGs, opts, resultq, kvstore);
+    return mergeIndexResults(baseGs, opts, resultq, kvstore, runNamerWhileMerging);
 }
 
 IndexResult indexPluginFiles(IndexResult firstPass, const options::Options &opts, WorkerPool &workers,
-                             unique_ptr<KeyValueStore> &kvstore) {
+                             unique_ptr<KeyValueStore> &kvstore, bool runNamerWhileMerging = false) {
     if (firstPass.pluginGeneratedFiles.empty()) {
         return firstPass;
     }
@@ -605,7 +1190,7 @@ IndexResult indexPluginFiles(IndexResult firstPass, const options::Options &opts
             resultq->push(move(threadResult), sizeIncrement);
         }
     });
-    auto indexedPluginFiles = mergeIndexResults(protoGs, opts, resultq, kvstore);
+    auto indexedPluginFiles = mergeIndexResults(protoGs, opts, resultq, kvstore, runNamerWhileMerging);
     IndexResult suppliedFilesAndPluginFiles;
     if (indexedPluginFiles.trees.empty()) {
         return firstPass;
@@ -629,6 +1214,15 @@ IndexResult indexPluginFiles(IndexResult firstPass, const options::Options &opts
     return suppliedFilesAndPluginFiles;
 }
 
+// Byte accounting for the major GlobalState tables, reported once per phase so the counters act
+// as per-phase gauges; the tables only grow, so the last phase's values are the run's high-water
+// marks. Tree, type and CFG allocations have no central owner to hook and are not covered.
+void reportGlobalStateMemoryCounters(const core::GlobalState &gs, ConstExprStr phase) {
+    prodCategoryCounterAdd(phase, "name_table_bytes", gs.nameTableMemoryBytes());
+    prodCategoryCounterAdd(phase, "symbol_table_bytes", gs.symbolTableMemoryBytes());
+    prodCategoryCounterAdd(phase, "file_table_bytes", gs.fileTableMemoryBytes());
+}
+
 vector<ast::ParsedFile> index(unique_ptr<core::GlobalState> &gs, vector<core::FileRef> files,
                               const options::Options &opts, WorkerPool &workers, unique_ptr<KeyValueStore> &kvstore) {
     Timer timeit(gs->tracer(), "index");
@@ -662,6 +1256,7 @@ vector<ast::ParsedFile> index(unique_ptr<core::GlobalState> &gs, vector<core::Fi
         }
         ENFORCE(files.size() + pluginFileCount == ret.size());
     } else {
+        prefetchFileContents(gs, files, opts, workers);
         auto firstPass = indexSuppliedFiles(move(gs), files, opts, workers, kvstore);
         auto pluginPass = indexPluginFiles(move(firstPass), opts, workers, kvstore);
         gs = move(pluginPass.gs);
@@ -669,10 +1264,45 @@ vector<ast::ParsedFile> index(unique_ptr<core::GlobalState> &gs, vector<core::Fi
     }
 
     fast_sort(ret, [](ast::ParsedFile const &a, ast::ParsedFile const &b) { return a.file < b.file; });
+    reportGlobalStateMemoryCounters(*gs, "memory.after_index");
     return ret;
 }
 
-ast::ParsedFile typecheckOne(core::Context ctx, ast::ParsedFile resolved, const options::Options &opts) {
+vector<ast::ParsedFile> indexAndName(unique_ptr<core::GlobalState> &gs, vector<core::FileRef> files,
+                                     const options::Options &opts, WorkerPool &workers,
+                                     unique_ptr<KeyValueStore> &kvstore) {
+    if (files.size() < 3 || opts.stopAfterPhase == options::Phase::INIT) {
+        // Too little work to overlap; run the phases back to back.
+        auto trees = index(gs, move(files), opts, workers, kvstore);
+        return name(*gs, move(trees), opts, false, &workers);
+    }
+
+    Timer timeit(gs->tracer(), "indexAndName");
+    gs->sanityCheck();
+
+#ifndef SORBET_REALMAIN_MIN
+    {
+        // Configatron has to run before the first tree is named, so it cannot wait for the merge;
+        // running it on the proto GlobalState also shares its symbols with every worker's copy.
+        core::UnfreezeNameTable nameTableAccess(*gs);     // creates names from config
+        core::UnfreezeSymbolTable symbolTableAccess(*gs); // creates methods for them
+        namer::configatron::fillInFromFileSystem(*gs, opts.configatronDirs, opts.configatronFiles);
+    }
+#endif
+
+    prefetchFileContents(gs, files, opts, workers);
+    auto firstPass = indexSuppliedFiles(move(gs), files, opts, workers, kvstore, /*runNamerWhileMerging=*/true);
+    auto pluginPass = indexPluginFiles(move(firstPass), opts, workers, kvstore, /*runNamerWhileMerging=*/true);
+    gs = move(pluginPass.gs);
+    auto ret = move(pluginPass.trees);
+
+    fast_sort(ret, [](ast::ParsedFile const &a, ast::ParsedFile const &b) { return a.file < b.file; });
+    reportGlobalStateMemoryCounters(*gs, "memory.after_index");
+    return ret;
+}
+
+ast::ParsedFile typecheckOne(core::Context ctx, ast::ParsedFile resolved, const options::Options &opts,
+                             const IncrementalTypecheckInfo *incrementalInfo, WorkerPool *workers) {
     ast::ParsedFile result{make_unique<ast::EmptyTree>(), resolved.file};
     core::FileRef f = resolved.file;
 
@@ -694,16 +1324,70 @@ ast::ParsedFile typecheckOne(core::Context ctx, ast::ParsedFile resolved, const
         return result;
     }
 
+    bool cfgPrintsEnabled = opts.print.CFG.enabled;
+#ifndef SORBET_REALMAIN_MIN
+    cfgPrintsEnabled = cfgPrintsEnabled || opts.print.CFGJson.enabled || opts.print.CFGProto.enabled;
+#endif
+    if (f.data(ctx).strictLevel < core::StrictLevel::True && !cfgPrintsEnabled) {
+        // typecheckMethod skips every method of a file below typed: true before building its CFG
+        // (queries included: inference never runs for such files), so walking the tree just to
+        // collect the methods is pure overhead. The strict level comes from decideStrictLevel
+        // (sigil, --typed overrides, per-path config), making this the degraded mode for
+        // typed: false files: they surface resolution errors only, and everything they define stays
+        // untyped for callers without inference ever running. CFG printing keeps the walk so each
+        // file still emits its digraph block.
+        prodCounterInc("types.input.files.skipped_below_typed_true");
+        result.tree = move(resolved.tree);
+        return result;
+    }
+
     Timer timeit(ctx.state.tracer(), "typecheckOne", {{"file", (string)f.data(ctx).path()}});
     try {
         if (opts.print.CFG.enabled) {
             opts.print.CFG.fmt("digraph \"{}\" {{\n", FileOps::getFileName(f.data(ctx).path()));
         }
-        CFGCollectorAndTyper collector(opts);
-        {
+        // Methods may only be skipped when no LSP query needs responses collected from inference.
+        bool canSkipUnchangedMethods =
+            incrementalInfo != nullptr && ctx.state.lspQuery.isEmpty() &&
+            binary_search(incrementalInfo->dependantFilesWithoutErrors.begin(),
+                          incrementalInfo->dependantFilesWithoutErrors.end(), f);
+        const vector<core::NameHash> *changedMethodHashes =
+            canSkipUnchangedMethods ? &incrementalInfo->changedMethodHashes : nullptr;
+        // Edited files skip more selectively: only the methods whose source text the edit left
+        // intact are candidates.
+        const vector<core::NameHash> *unchangedMethodNames = nullptr;
+        if (!canSkipUnchangedMethods && incrementalInfo != nullptr && ctx.state.lspQuery.isEmpty()) {
+            auto it = incrementalInfo->unchangedMethodsInEditedFiles.find(f);
+            if (it != incrementalInfo->unchangedMethodsInEditedFiles.end()) {
+                changedMethodHashes = &incrementalInfo->changedMethodHashes;
+                unchangedMethodNames = &it->second;
+            }
+        }
+        // CFG printing interleaves output from concurrent methods, so it forces the serial path.
+        bool typecheckMethodsInParallel = workers != nullptr && workers->size() > 1 && !opts.print.CFG.enabled;
+#ifndef SORBET_REALMAIN_MIN
+        typecheckMethodsInParallel =
+            typecheckMethodsInParallel && !opts.print.CFGJson.enabled && !opts.print.CFGProto.enabled;
+#endif
+        if (typecheckMethodsInParallel) {
+            vector<ast::MethodDef *> methods;
+            collectFlattenedMethodDefs(resolved.tree.get(), methods);
+            narrowMethodsToLocQuery(ctx, f, methods);
+            core::ErrorRegion errs(ctx, f);
+            result.tree = move(resolved.tree);
+            typecheckMethods(ctx, opts, changedMethodHashes, unchangedMethodNames, methods, *workers);
+        } else {
+            CFGCollectorAndTyper collector(opts, changedMethodHashes, unchangedMethodNames);
             core::ErrorRegion errs(ctx, f);
             result.tree = ast::TreeMap::apply(ctx, collector, move(resolved.tree));
         }
+        if (opts.maxErrorsPerFile > 0 && f.data(ctx).errorCount() >= static_cast<u4>(opts.maxErrorsPerFile)) {
+            prodCounterInc("types.input.files.error_budget_exceeded");
+            if (auto e = ctx.state.beginError(core::Loc::none(f), core::errors::Infer::ErrorBudgetExceeded)) {
+                e.setHeader("File exceeded the error budget of `{}`; its remaining methods were not typechecked",
+                            opts.maxErrorsPerFile);
+            }
+        }
         if (opts.print.CFG.enabled) {
             opts.print.CFG.fmt("}}\n\n");
         }
@@ -718,12 +1402,182 @@ ast::ParsedFile typecheckOne(core::Context ctx, ast::ParsedFile resolved, const
 
 struct typecheck_thread_result {
     vector<ast::ParsedFile> trees;
+    vector<pair<core::FileRef, u4>> timings;
     CounterState counters;
+    DeferredExtensionEvents deferredEvents;
+};
+
+// Per-file typecheck durations from the previous run, used to seed the work queue longest-first
+// (LPT scheduling). Like realmain's error baseline, this lives in a flat file under the cache dir
+// rather than in the KeyValueStore because the kvstore handle is handed to the background commit
+// thread before typechecking starts.
+constexpr char TYPECHECK_TIMINGS_HEADER[] = "sorbet-typecheck-timings-v1";
+
+string typecheckTimingsPath(const options::Options &opts) {
+    return absl::StrCat(opts.cacheDir, "/typecheck_timings");
+}
+
+// path -> duration in microseconds. Returns an empty map when caching is off or the file is from
+// another format version.
+UnorderedMap<string, u4> loadTypecheckTimings(const options::Options &opts) {
+    UnorderedMap<string, u4> result;
+    if (opts.cacheDir.empty()) {
+        return result;
+    }
+    auto path = typecheckTimingsPath(opts);
+    if (!FileOps::exists(path)) {
+        return result;
+    }
+    auto contents = FileOps::read(path);
+    auto lines = absl::StrSplit(contents, '\n');
+    auto it = lines.begin();
+    if (it == lines.end() || *it != TYPECHECK_TIMINGS_HEADER) {
+        return result;
+    }
+    for (++it; it != lines.end(); ++it) {
+        auto tab = it->rfind('\t');
+        u4 micros;
+        if (tab != string_view::npos && absl::SimpleAtoi(it->substr(tab + 1), &micros)) {
+            result[string(it->substr(0, tab))] = micros;
+        }
+    }
+    return result;
+}
+
+void storeTypecheckTimings(const options::Options &opts, const UnorderedMap<string, u4> &timings) {
+    vector<pair<string_view, u4>> sorted;
+    sorted.reserve(timings.size());
+    for (auto &entry : timings) {
+        sorted.emplace_back(entry.first, entry.second);
+    }
+    // Sort so the file is stable from run to run.
+    fast_sort(sorted);
+    fmt::memory_buffer buf;
+    fmt::format_to(buf, "{}\n", TYPECHECK_TIMINGS_HEADER);
+    for (auto &entry : sorted) {
+        fmt::format_to(buf, "{}\t{}\n", entry.first, entry.second);
+    }
+    FileOps::write(typecheckTimingsPath(opts), to_string(buf));
+}
+
+// Aggregate content hashes for directories pinned with --pinned-dir. A directory appears in this
+// file only if its most recent full typecheck produced no diagnostics in any of its files; the
+// value hashes the sorted (path, content hash) pairs of the files typechecked under it, so adding,
+// removing, renaming, or editing anything under the directory invalidates the entry.
+constexpr char PINNED_DIRS_HEADER[] = "sorbet-pinned-dirs-v1";
+
+string pinnedDirsPath(const options::Options &opts) {
+    return absl::StrCat(opts.cacheDir, "/pinned_dirs");
+}
+
+UnorderedMap<string, string> loadPinnedDirHashes(const options::Options &opts) {
+    UnorderedMap<string, string> result;
+    auto path = pinnedDirsPath(opts);
+    if (!FileOps::exists(path)) {
+        return result;
+    }
+    auto contents = FileOps::read(path);
+    auto lines = absl::StrSplit(contents, '\n');
+    auto it = lines.begin();
+    if (it == lines.end() || *it != PINNED_DIRS_HEADER) {
+        return result;
+    }
+    for (++it; it != lines.end(); ++it) {
+        auto tab = it->rfind('\t');
+        if (tab != string_view::npos) {
+            result[string(it->substr(0, tab))] = string(it->substr(tab + 1));
+        }
+    }
+    return result;
+}
+
+void storePinnedDirHashes(const options::Options &opts, const UnorderedMap<string, string> &hashes) {
+    vector<pair<string_view, string_view>> sorted;
+    sorted.reserve(hashes.size());
+    for (auto &entry : hashes) {
+        sorted.emplace_back(entry.first, entry.second);
+    }
+    fast_sort(sorted);
+    fmt::memory_buffer buf;
+    fmt::format_to(buf, "{}\n", PINNED_DIRS_HEADER);
+    for (auto &entry : sorted) {
+        fmt::format_to(buf, "{}\t{}\n", entry.first, entry.second);
+    }
+    FileOps::write(pinnedDirsPath(opts), to_string(buf));
+}
+
+bool isUnderPinnedDir(string_view path, string_view dir) {
+    return path.size() > dir.size() + 1 && absl::StartsWith(path, dir) && path[dir.size()] == '/';
+}
+
+// Counts the tree shapes the namer turns into symbols. Read-only; the trees pass through
+// unchanged.
+class DefinitionCounter {
+public:
+    u4 classDefs = 0;
+    u4 methodDefs = 0;
+
+    unique_ptr<ast::ClassDef> postTransformClassDef(core::Context ctx, unique_ptr<ast::ClassDef> classDef) {
+        classDefs++;
+        return classDef;
+    }
+
+    unique_ptr<ast::MethodDef> postTransformMethodDef(core::Context ctx, unique_ptr<ast::MethodDef> methodDef) {
+        methodDefs++;
+        return methodDef;
+    }
 };
 
+// Below this many files the counting fan-out costs more than the reallocations it avoids.
+constexpr size_t MIN_FILES_FOR_PARALLEL_DEF_COUNT = 32;
+
+// Phase one of naming: scan the trees on the worker pool for definitions-to-be and reserve
+// symbol-table capacity for them, so the serial symbol-entering walk below never pays for a
+// reallocation (each of which moves every Symbol, members maps and all).
+void reserveSymbolsForNamer(core::GlobalState &gs, vector<ast::ParsedFile> &what, WorkerPool &workers) {
+    Timer timeit(gs.tracer(), "reserveSymbolsForNamer");
+    auto fileq = make_shared<ConcurrentBoundedQueue<ast::ParsedFile *>>(what.size());
+    for (auto &tree : what) {
+        fileq->push(&tree, 1);
+    }
+    auto resultq = make_shared<BlockingBoundedQueue<pair<u4, u4>>>(what.size());
+    core::Context ctx(gs, core::Symbols::root());
+    workers.multiplexJob("countDefinitions", [ctx, fileq, resultq]() {
+        DefinitionCounter counter;
+        int processedByThread = 0;
+        ast::ParsedFile *job = nullptr;
+        for (auto result = fileq->try_pop(job); !result.done(); result = fileq->try_pop(job)) {
+            if (result.gotItem()) {
+                processedByThread++;
+                job->tree = ast::TreeMap::apply(ctx, counter, move(job->tree));
+            }
+        }
+        if (processedByThread > 0) {
+            resultq->push(make_pair(counter.classDefs, counter.methodDefs), processedByThread);
+        }
+    });
+
+    u4 classDefs = 0;
+    u4 methodDefs = 0;
+    pair<u4, u4> threadResult;
+    for (auto result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), gs.tracer());
+         !result.done(); result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), gs.tracer())) {
+        if (result.gotItem()) {
+            classDefs += threadResult.first;
+            methodDefs += threadResult.second;
+        }
+    }
+    // Each ClassDef typically yields the class, its singleton class and a <static-init> method;
+    // each def one method symbol. This is a capacity hint, so erring high is fine.
+    gs.reserveSymbols(classDefs * 3 + methodDefs);
+}
+
 vector<ast::ParsedFile> name(core::GlobalState &gs, vector<ast::ParsedFile> what, const options::Options &opts,
-                             bool skipConfigatron) {
+                             bool skipConfigatron, WorkerPool *workers) {
     Timer timeit(gs.tracer(), "name");
+    if (workers != nullptr && workers->size() > 1 && what.size() >= MIN_FILES_FOR_PARALLEL_DEF_COUNT) {
+        reserveSymbolsForNamer(gs, what, *workers);
+    }
     if (!skipConfigatron) {
 #ifndef SORBET_REALMAIN_MIN
         core::UnfreezeNameTable nameTableAccess(gs);     // creates names from config
@@ -737,7 +1591,7 @@ vector<ast::ParsedFile> name(core::GlobalState &gs, vector<ast::ParsedFile> what
         core::UnfreezeNameTable nameTableAccess(gs);     // creates singletons and class names
         core::UnfreezeSymbolTable symbolTableAccess(gs); // enters symbols
         what = namer::Namer::run(ctx, move(what));
-        gs.errorQueue->flushErrors();
+        gs.errorQueue->flushErrors(gs);
     }
     return what;
 }
@@ -821,9 +1675,12 @@ ast::ParsedFile checkNoDefinitionsInsideProhibitedLines(core::GlobalState &gs, a
 }
 
 vector<ast::ParsedFile> resolve(unique_ptr<core::GlobalState> &gs, vector<ast::ParsedFile> what,
-                                const options::Options &opts, WorkerPool &workers, bool skipConfigatron) {
+                                const options::Options &opts, WorkerPool &workers, bool skipConfigatron,
+                                bool alreadyNamed) {
     try {
-        what = name(*gs, move(what), opts, skipConfigatron);
+        if (!alreadyNamed) {
+            what = name(*gs, move(what), opts, skipConfigatron, &workers);
+        }
 
         for (auto &named : what) {
             if (opts.print.NameTree.enabled) {
@@ -849,7 +1706,18 @@ vector<ast::ParsedFile> resolve(unique_ptr<core::GlobalState> &gs, vector<ast::P
             }
             core::UnfreezeNameTable nameTableAccess(*gs);     // Resolver::defineAttr
             core::UnfreezeSymbolTable symbolTableAccess(*gs); // enters stubs
-            what = resolver::Resolver::run(ctx, move(what), workers);
+            // A run that stops at the resolver and only prints missing constants consumes nothing
+            // from the sig and finalization walks, so it gets the same constants-only resolution
+            // autogen uses; sig-resolution diagnostics are deliberately not produced in this mode.
+            // The incremental-resolver stress harness replays a full resolve, so it opts out.
+            const bool constantsOnly = opts.stopAfterPhase == options::Phase::RESOLVER &&
+                                       opts.print.isMissingConstantsOnly() && !opts.stressIncrementalResolver;
+            if (constantsOnly) {
+                prodCounterInc("types.resolve.constants_only_runs");
+                what = resolver::Resolver::runConstantResolution(ctx, move(what), workers);
+            } else {
+                what = resolver::Resolver::run(ctx, move(what), workers);
+            }
         }
         if (opts.stressIncrementalResolver) {
             auto symbolsBefore = gs->symbolsUsed();
@@ -880,7 +1748,8 @@ vector<ast::ParsedFile> resolve(unique_ptr<core::GlobalState> &gs, vector<ast::P
         }
     }
 
-    gs->errorQueue->flushErrors();
+    gs->errorQueue->flushErrors(*gs);
+    reportGlobalStateMemoryCounters(*gs, "memory.after_resolve");
     if (opts.print.ResolveTree.enabled || opts.print.ResolveTreeRaw.enabled) {
         for (auto &resolved : what) {
             if (opts.print.ResolveTree.enabled) {
@@ -899,72 +1768,352 @@ vector<ast::ParsedFile> resolve(unique_ptr<core::GlobalState> &gs, vector<ast::P
 }
 
 vector<ast::ParsedFile> typecheck(unique_ptr<core::GlobalState> &gs, vector<ast::ParsedFile> what,
-                                  const options::Options &opts, WorkerPool &workers) {
+                                  const options::Options &opts, WorkerPool &workers,
+                                  const IncrementalTypecheckInfo *incrementalInfo,
+                                  const std::atomic<bool> *cancelRequested) {
     vector<ast::ParsedFile> typecheck_result;
 
     {
         Timer timeit(gs->tracer(), "typecheck");
 
-        shared_ptr<ConcurrentBoundedQueue<ast::ParsedFile>> fileq;
-        shared_ptr<BlockingBoundedQueue<typecheck_thread_result>> resultq;
+        core::Context ctx(*gs, core::Symbols::root());
 
-        {
-            fileq = make_shared<ConcurrentBoundedQueue<ast::ParsedFile>>(what.size());
-            resultq = make_shared<BlockingBoundedQueue<typecheck_thread_result>>(what.size());
+        // Sharded mode: a coordinator runs index/name/resolve once and ships the state (via
+        // --store-state); each worker machine loads it and typechecks only its shard. File ids are
+        // identical across workers by construction, so assigning by id partitions the run exactly.
+        // Out-of-shard trees pass through untouched so downstream consumers still see every file.
+        vector<ast::ParsedFile> outOfShard;
+        if (opts.typecheckNumShards > 1) {
+            auto inShard = [&](const ast::ParsedFile &resolved) {
+                return resolved.file.id() % opts.typecheckNumShards == opts.typecheckShard;
+            };
+            auto it = std::stable_partition(what.begin(), what.end(), inShard);
+            outOfShard.insert(outOfShard.end(), make_move_iterator(it), make_move_iterator(what.end()));
+            what.erase(it, what.end());
+            prodCounterAdd("typecheck.shard_files", what.size());
+            prodCounterAdd("typecheck.shard_skipped_files", outOfShard.size());
         }
 
-        core::Context ctx(*gs, core::Symbols::root());
-
-        // We want to start typeckecking big files first because it helps with better work distribution
-        fast_sort(what, [&](const auto &lhs, const auto &rhs) -> bool {
-            return lhs.file.data(*gs).source().size() > rhs.file.data(*gs).source().size();
-        });
-        for (auto &resolved : what) {
-            fileq->push(move(resolved), 1);
+        // Directories pinned with --pinned-dir skip CFG+inference wholesale when nothing under
+        // them changed since the last run in which they typechecked clean: identical inputs
+        // produced zero diagnostics then, so rerunning them can only reproduce silence, and the
+        // trees pass through untouched just as out-of-shard trees do. Prints that happen inside
+        // typecheckOne would be silenced by the skip, so any of them disables pinning.
+        vector<ast::ParsedFile> pinnedSkipped;
+        UnorderedMap<string, string> pinnedAggregates;
+        UnorderedMap<string, vector<core::FileRef>> pinnedTypechecked;
+        bool typecheckPrints = opts.print.CFG.enabled || opts.print.CFGJson.enabled || opts.print.CFGProto.enabled ||
+                               opts.print.FlattenedTree.enabled || opts.print.FlattenedTreeRaw.enabled;
+        bool pinningActive = !opts.pinnedDirs.empty() && !opts.cacheDir.empty() && incrementalInfo == nullptr &&
+                             cancelRequested == nullptr && !typecheckPrints;
+        if (pinningActive) {
+            UnorderedMap<string, vector<size_t>> filesByDir;
+            for (size_t i = 0; i < what.size(); i++) {
+                auto path = what[i].file.data(*gs).path();
+                for (auto &dir : opts.pinnedDirs) {
+                    if (isUnderPinnedDir(path, dir)) {
+                        filesByDir[dir].emplace_back(i);
+                        break;
+                    }
+                }
+            }
+            auto recorded = loadPinnedDirHashes(opts);
+            vector<bool> skip(what.size(), false);
+            for (auto &[dir, indices] : filesByDir) {
+                vector<pair<string_view, string>> entries;
+                entries.reserve(indices.size());
+                for (auto i : indices) {
+                    entries.emplace_back(what[i].file.data(*gs).path(), fileKey(*gs, what[i].file));
+                }
+                fast_sort(entries);
+                fmt::memory_buffer buf;
+                for (auto &entry : entries) {
+                    fmt::format_to(buf, "{}\t{}\n", entry.first, entry.second);
+                }
+                auto hashBytes = sorbet::crypto_hashing::hash128Fast(string_view(buf.data(), buf.size()));
+                auto aggregate = absl::BytesToHexString(string_view((char *)hashBytes.data(), size(hashBytes)));
+                pinnedAggregates[dir] = aggregate;
+                auto prev = recorded.find(dir);
+                if (prev != recorded.end() && prev->second == aggregate) {
+                    for (auto i : indices) {
+                        skip[i] = true;
+                    }
+                    prodCounterAdd("typecheck.pinned_files_skipped", indices.size());
+                } else {
+                    auto &checked = pinnedTypechecked[dir];
+                    for (auto i : indices) {
+                        checked.emplace_back(what[i].file);
+                    }
+                }
+            }
+            if (absl::c_any_of(skip, [](bool b) { return b; })) {
+                vector<ast::ParsedFile> kept;
+                kept.reserve(what.size());
+                for (size_t i = 0; i < what.size(); i++) {
+                    (skip[i] ? pinnedSkipped : kept).emplace_back(move(what[i]));
+                }
+                what = move(kept);
+            }
         }
 
-        {
-            ProgressIndicator cfgInferProgress(opts.showProgress, "CFG+Inference", what.size());
-            workers.multiplexJob("typecheck", [ctx, &opts, fileq, resultq]() {
-                typecheck_thread_result threadResult;
-                ast::ParsedFile job;
-                int processedByThread = 0;
+        if (what.size() == 1 && workers.size() > 1) {
+            // The LSP fast path typechecks exactly one file; file-level fan-out would leave the
+            // pool idle, so hand the pool to typecheckOne and let it fan out methods instead.
+            auto job = move(what[0]);
+            what.clear();
+            core::FileRef file = job.file;
+            if (cancelRequested != nullptr && cancelRequested->load(std::memory_order_relaxed)) {
+                typecheck_result.emplace_back(move(job));
+            } else {
+                try {
+                    typecheck_result.emplace_back(typecheckOne(ctx, move(job), opts, incrementalInfo, &workers));
+                } catch (SorbetException &) {
+                    Exception::failInFuzzer();
+                    ctx.state.tracer().error("Exception typing file: {} (backtrace is above)", file.data(ctx).path());
+                }
+            }
+            gs->errorQueue->flushErrors(*gs);
+            drainDeferredExtensionEvents(*gs, getAndClearDeferredExtensionEvents());
+        } else {
+            shared_ptr<WorkStealingQueue<ast::ParsedFile>> fileq;
+            shared_ptr<BlockingBoundedQueue<typecheck_thread_result>> resultq;
+
+            {
+                fileq = make_shared<WorkStealingQueue<ast::ParsedFile>>(workers.size(), what.size());
+                resultq = make_shared<BlockingBoundedQueue<typecheck_thread_result>>(what.size());
+            }
+
+            // On multi-socket machines every worker otherwise reads one symbol table that lives on a
+            // single node's memory. Give each remote node its own copy — deepCopy preserves all
+            // NameRef/SymbolRef ids and shares the error queue and file contents, so the copies are
+            // interchangeable with the original for the read-only typecheck phase. Only worth the
+            // copy on runs big enough to amortize it.
+            constexpr size_t NUMA_REPLICA_MIN_FILES = 1000;
+            vector<unique_ptr<core::GlobalState>> numaReplicas;
+            if (workers.numaNodeCount() > 1 && what.size() >= NUMA_REPLICA_MIN_FILES) {
+                Timer timeit(gs->tracer(), "typecheck.numa_replicas");
+                for (int node = 1; node < workers.numaNodeCount(); node++) {
+                    numaReplicas.emplace_back(gs->deepCopy(true, &workers));
+                }
+                prodCounterAdd("typecheck.numa_replicas", numaReplicas.size());
+            }
+
+            if (!gs->errorQueue->ignoreFlushes) {
+                // Errors stream out during the run, but longest-first scheduling (below) scrambles
+                // completion order; pin the flush order to the input order so the output is
+                // deterministic without waiting for the whole run to finish.
+                vector<core::FileRef> flushOrder;
+                flushOrder.reserve(what.size());
+                for (auto &resolved : what) {
+                    flushOrder.emplace_back(resolved.file);
+                }
+                gs->errorQueue->setFlushOrder(move(flushOrder));
+            }
+
+            // We want to start typeckecking expensive files first because it helps with better work
+            // distribution. Files measured on a previous run are scheduled longest-first from their
+            // recorded durations; new or unmeasured files are estimated from their line count,
+            // scaled by the measured cost per line when there is one.
+            auto timings = loadTypecheckTimings(opts);
+            bool measuredAny = false;
+            DeferredExtensionEvents mergedDeferredEvents;
+            vector<ast::ParsedFile> hugeFiles;
+            {
+                u8 matchedMicros = 0;
+                u8 matchedLines = 0;
+                UnorderedMap<int, double> weights;
+                weights.reserve(what.size());
+                for (auto &resolved : what) {
+                    auto &data = resolved.file.data(*gs);
+                    auto timing = timings.find(data.path());
+                    if (timing != timings.end()) {
+                        matchedMicros += timing->second;
+                        matchedLines += data.lineCount();
+                    }
+                }
+                double microsPerLine = matchedLines > 0 ? double(matchedMicros) / double(matchedLines) : 1.0;
+                for (auto &resolved : what) {
+                    auto &data = resolved.file.data(*gs);
+                    auto timing = timings.find(data.path());
+                    weights[resolved.file.id()] =
+                        timing != timings.end() ? timing->second : data.lineCount() * microsPerLine;
+                }
+                fast_sort(what, [&](const auto &lhs, const auto &rhs) -> bool {
+                    return weights[lhs.file.id()] > weights[rhs.file.id()];
+                });
+
+                // A file whose estimated cost far exceeds the ideal per-worker share stretches the
+                // phase tail no matter how well the rest packs: as a single work unit it pins one
+                // worker while the others drain and idle. Such files (a prefix of the sorted order)
+                // are peeled off and typechecked one at a time with the whole pool fanning out
+                // their methods, fixing the granularity at the source rather than leaving it to
+                // work stealing. The 2x margin exists because splitting trades file-level overlap
+                // for a per-file barrier, which only pays off for genuine outliers.
+                if (workers.size() > 1 && what.size() > 1) {
+                    double totalWeight = 0.0;
+                    for (auto &entry : weights) {
+                        totalWeight += entry.second;
+                    }
+                    double splitThreshold = 2.0 * totalWeight / workers.size();
+                    size_t firstSmall = 0;
+                    while (firstSmall < what.size() && weights[what[firstSmall].file.id()] > splitThreshold) {
+                        firstSmall++;
+                    }
+                    if (firstSmall > 0) {
+                        hugeFiles.assign(make_move_iterator(what.begin()),
+                                         make_move_iterator(what.begin() + firstSmall));
+                        what.erase(what.begin(), what.begin() + firstSmall);
+                        prodCounterAdd("typecheck.files_split_for_parallelism", hugeFiles.size());
+                    }
+                }
+            }
+            for (auto &job : hugeFiles) {
+                core::FileRef file = job.file;
+                if (cancelRequested != nullptr && cancelRequested->load(std::memory_order_relaxed)) {
+                    typecheck_result.emplace_back(move(job));
+                    continue;
+                }
+                try {
+                    typecheck_result.emplace_back(typecheckOne(ctx, move(job), opts, incrementalInfo, &workers));
+                } catch (SorbetException &) {
+                    Exception::failInFuzzer();
+                    ctx.state.tracer().error("Exception typing file: {} (backtrace is above)", file.data(ctx).path());
+                }
+                // No timing is recorded for a split file: the wall time here reflects the whole
+                // pool, and feeding it back would shrink the file's weight until it stops being
+                // split, then oscillate. Its previous entry (or line-count estimate) stays.
+                gs->errorQueue->flushErrors(*gs);
+            }
+            if (!hugeFiles.empty()) {
+                // The method fan-out folds worker counters and deferred extension events into this
+                // thread; harvest the events like any worker's.
+                for (auto &entry : getAndClearDeferredExtensionEvents()) {
+                    auto &merged = mergedDeferredEvents[entry.first];
+                    merged.insert(merged.end(), make_move_iterator(entry.second.begin()),
+                                  make_move_iterator(entry.second.end()));
+                }
+            }
+            for (auto &resolved : what) {
+                fileq->push(move(resolved), 1);
+            }
+
+            {
+                ProgressIndicator cfgInferProgress(opts.showProgress, "CFG+Inference", what.size());
+                workers.multiplexJob("typecheck", [ctx, &opts, fileq, resultq, incrementalInfo, cancelRequested,
+                                                   &numaReplicas]() {
+                    typecheck_thread_result threadResult;
+                    ast::ParsedFile job;
+                    int processedByThread = 0;
+                    int worker = fileq->registerWorker();
+
+                    // Read the symbol table from this worker's node-local replica when one exists.
+                    int node = WorkerPool::currentThreadNumaNode();
+                    const core::GlobalState &localGs =
+                        (node > 0 && node <= static_cast<int>(numaReplicas.size())) ? *numaReplicas[node - 1]
+                                                                                    : ctx.state;
+                    core::Context localCtx(localGs, ctx.owner);
+
+                    {
+                        for (auto result = fileq->try_pop(worker, job); !result.done();
+                             result = fileq->try_pop(worker, job)) {
+                            if (result.gotItem()) {
+                                processedByThread++;
+                                if (cancelRequested != nullptr && cancelRequested->load(std::memory_order_relaxed)) {
+                                    // A newer edit superseded this run; drain the queue without
+                                    // typechecking so the caller can start over promptly.
+                                    threadResult.trees.emplace_back(move(job));
+                                    continue;
+                                }
+                                core::FileRef file = job.file;
+                                try {
+                                    auto typecheckStart = chrono::steady_clock::now();
+                                    threadResult.trees.emplace_back(
+                                        typecheckOne(localCtx, move(job), opts, incrementalInfo));
+                                    auto micros = chrono::duration_cast<chrono::microseconds>(
+                                                      chrono::steady_clock::now() - typecheckStart)
+                                                      .count();
+                                    threadResult.timings.emplace_back(file, u4(micros));
+                                } catch (SorbetException &) {
+                                    Exception::failInFuzzer();
+                                    localCtx.state.tracer().error("Exception typing file: {} (backtrace is above)",
+                                                                  file.data(localCtx).path());
+                                }
+                            }
+                        }
+                    }
+                    if (processedByThread > 0) {
+                        threadResult.counters = getAndClearThreadCounters();
+                        threadResult.deferredEvents = getAndClearDeferredExtensionEvents();
+                        resultq->push(move(threadResult), processedByThread);
+                    }
+                });
 
+                typecheck_thread_result threadResult;
                 {
-                    for (auto result = fileq->try_pop(job); !result.done(); result = fileq->try_pop(job)) {
+                    for (auto result =
+                             resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), gs->tracer());
+                         !result.done();
+                         result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), gs->tracer())) {
                         if (result.gotItem()) {
-                            processedByThread++;
-                            core::FileRef file = job.file;
-                            try {
-                                threadResult.trees.emplace_back(typecheckOne(ctx, move(job), opts));
-                            } catch (SorbetException &) {
-                                Exception::failInFuzzer();
-                                ctx.state.tracer().error("Exception typing file: {} (backtrace is above)",
-                                                         file.data(ctx).path());
+                            counterConsume(move(threadResult.counters));
+                            for (auto &timing : threadResult.timings) {
+                                timings[string(timing.first.data(*gs).path())] = timing.second;
+                                measuredAny = true;
+                            }
+                            for (auto &entry : threadResult.deferredEvents) {
+                                auto &merged = mergedDeferredEvents[entry.first];
+                                merged.insert(merged.end(), make_move_iterator(entry.second.begin()),
+                                              make_move_iterator(entry.second.end()));
                             }
+                            typecheck_result.insert(typecheck_result.end(),
+                                                    make_move_iterator(threadResult.trees.begin()),
+                                                    make_move_iterator(threadResult.trees.end()));
                         }
+                        cfgInferProgress.reportProgress(fileq->doneEstimate());
+                        gs->errorQueue->flushErrors(*gs);
                     }
                 }
-                if (processedByThread > 0) {
-                    threadResult.counters = getAndClearThreadCounters();
-                    resultq->push(move(threadResult), processedByThread);
-                }
-            });
+            }
 
-            typecheck_thread_result threadResult;
-            {
-                for (auto result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), gs->tracer());
-                     !result.done();
-                     result = resultq->wait_pop_timed(threadResult, WorkerPool::BLOCK_INTERVAL(), gs->tracer())) {
-                    if (result.gotItem()) {
-                        counterConsume(move(threadResult.counters));
-                        typecheck_result.insert(typecheck_result.end(), make_move_iterator(threadResult.trees.begin()),
-                                                make_move_iterator(threadResult.trees.end()));
+            if (!opts.cacheDir.empty() && measuredAny) {
+                // Merge into the previous run's entries so files outside this run (incremental
+                // subsets) keep their measurements.
+                storeTypecheckTimings(opts, timings);
+            }
+
+            // Must happen before the NUMA replicas (whose extension copies may own some of these
+            // events) go out of scope.
+            drainDeferredExtensionEvents(*gs, move(mergedDeferredEvents));
+        }
+
+        if (gs->deferSigSuggestions) {
+            emitDeferredSigSuggestions(*gs, workers);
+            gs->errorQueue->flushErrors(*gs);
+        }
+
+        if (pinningActive && !pinnedTypechecked.empty()) {
+            auto recorded = loadPinnedDirHashes(opts);
+            bool changed = false;
+            for (auto &[dir, files] : pinnedTypechecked) {
+                // minErrorLevel_ only moves when an error is actually reported, so Max means this
+                // run produced no diagnostics anywhere in the file — including in phases before
+                // typecheck, which is stricter than necessary but never wrong.
+                bool clean = absl::c_all_of(
+                    files, [&](auto file) { return file.data(*gs).minErrorLevel() == core::StrictLevel::Max; });
+                auto it = recorded.find(dir);
+                if (clean) {
+                    if (it == recorded.end() || it->second != pinnedAggregates[dir]) {
+                        recorded[dir] = pinnedAggregates[dir];
+                        changed = true;
                     }
-                    cfgInferProgress.reportProgress(fileq->doneEstimate());
-                    gs->errorQueue->flushErrors();
+                } else if (it != recorded.end()) {
+                    recorded.erase(it);
+                    changed = true;
                 }
             }
+            if (changed) {
+                storePinnedDirHashes(opts, recorded);
+            }
         }
 
         if (opts.print.SymbolTable.enabled) {
@@ -1018,68 +2167,73 @@ vector<ast::ParsedFile> typecheck(unique_ptr<core::GlobalState> &gs, vector<ast:
             plugin::Plugins::dumpPluginGeneratedFiles(*gs, opts.print.PluginGeneratedCode);
         }
 #endif
+        reportGlobalStateMemoryCounters(*gs, "memory.after_typecheck");
+        typecheck_result.insert(typecheck_result.end(), make_move_iterator(pinnedSkipped.begin()),
+                                make_move_iterator(pinnedSkipped.end()));
+        typecheck_result.insert(typecheck_result.end(), make_move_iterator(outOfShard.begin()),
+                                make_move_iterator(outOfShard.end()));
         return typecheck_result;
     }
 }
 
-class AllNamesCollector {
+// Accumulates every FileHash ingredient that comes from the tree (usage names and per-method body
+// hashes) in a single walk; hashing runs for every file on every edit, so it shouldn't traverse the
+// tree once per ingredient.
+class FileHashCollector {
 public:
-    core::UsageHash acc;
-    unique_ptr<ast::Send> preTransformSend(core::Context ctx, unique_ptr<ast::Send> original) {
-        acc.sends.emplace_back(ctx.state, original->fun.data(ctx));
-        return original;
+    core::UsageHash names;
+    UnorderedMap<core::NameHash, u4> methodBodyHashes;
+
+    void preTransformSend(core::Context ctx, const ast::Send &original) {
+        names.sends.emplace_back(ctx.state, original.fun);
     }
 
-    unique_ptr<ast::MethodDef> postTransformMethodDef(core::Context ctx, unique_ptr<ast::MethodDef> original) {
-        acc.constants.emplace_back(ctx.state, original->name.data(ctx.state));
-        return original;
+    void postTransformMethodDef(core::Context ctx, const ast::MethodDef &original) {
+        names.constants.emplace_back(ctx.state, original.name);
+
+        if (!original.loc.exists()) {
+            // A def without a source range (wholly synthesized) stays out of the map, which keeps
+            // it permanently ineligible for the unchanged-method skip.
+            return;
+        }
+        // Hashing the source slice rather than the subtree makes the hash independent of where the
+        // method sits in the file, so an edit above it doesn't look like a change to it.
+        auto source = original.loc.file().data(ctx).source();
+        auto slice = source.substr(original.loc.beginPos(), original.loc.endPos() - original.loc.beginPos());
+        auto &target = methodBodyHashes[core::NameHash(ctx.state, original.name)];
+        target = core::mix(target, core::_hash(slice));
     }
 
-    void handleUnresolvedConstantLit(core::Context ctx, ast::UnresolvedConstantLit *expr) {
+    void handleUnresolvedConstantLit(core::Context ctx, const ast::UnresolvedConstantLit *expr) {
         while (expr) {
-            acc.constants.emplace_back(ctx.state, expr->cnst.data(ctx));
+            names.constants.emplace_back(ctx.state, expr->cnst);
             // Handle references to 'Foo' in 'Foo::Bar'.
             expr = ast::cast_tree<ast::UnresolvedConstantLit>(expr->scope.get());
         }
     }
 
-    unique_ptr<ast::ClassDef> postTransformClassDef(core::Context ctx, unique_ptr<ast::ClassDef> original) {
-        acc.constants.emplace_back(ctx.state, original->symbol.data(ctx)->name.data(ctx));
-        original->name->showRaw(ctx.state);
+    void postTransformClassDef(core::Context ctx, const ast::ClassDef &original) {
+        names.constants.emplace_back(ctx.state, original.symbol.data(ctx)->name);
 
-        handleUnresolvedConstantLit(ctx, ast::cast_tree<ast::UnresolvedConstantLit>(original->name.get()));
+        handleUnresolvedConstantLit(ctx, ast::cast_tree<ast::UnresolvedConstantLit>(original.name.get()));
 
         // Grab names of superclasses. (N.B. `include` and `extend` are captured as ConstantLits.)
-        for (auto &ancst : original->ancestors) {
+        for (auto &ancst : original.ancestors) {
             handleUnresolvedConstantLit(ctx, ast::cast_tree<ast::UnresolvedConstantLit>(ancst.get()));
         }
-
-        return original;
     }
 
-    unique_ptr<ast::UnresolvedConstantLit>
-    postTransformUnresolvedConstantLit(core::Context ctx, unique_ptr<ast::UnresolvedConstantLit> original) {
-        handleUnresolvedConstantLit(ctx, original.get());
-        return original;
+    void postTransformUnresolvedConstantLit(core::Context ctx, const ast::UnresolvedConstantLit &original) {
+        handleUnresolvedConstantLit(ctx, &original);
     }
 
-    unique_ptr<ast::UnresolvedIdent> postTransformUnresolvedIdent(core::Context ctx,
-                                                                  unique_ptr<ast::UnresolvedIdent> id) {
-        if (id->kind != ast::UnresolvedIdent::Local) {
-            acc.constants.emplace_back(ctx.state, id->name.data(ctx));
+    void postTransformUnresolvedIdent(core::Context ctx, const ast::UnresolvedIdent &id) {
+        if (id.kind != ast::UnresolvedIdent::Local) {
+            names.constants.emplace_back(ctx.state, id.name);
         }
-        return id;
     }
 };
 
-core::UsageHash getAllNames(const core::GlobalState &gs, unique_ptr<ast::Expression> &tree) {
-    AllNamesCollector collector;
-    tree = ast::TreeMap::apply(core::Context(gs, core::Symbols::root()), collector, move(tree));
-    core::NameHash::sortAndDedupe(collector.acc.sends);
-    core::NameHash::sortAndDedupe(collector.acc.constants);
-    return move(collector.acc);
-};
-
 core::FileHash computeFileHash(shared_ptr<core::File> forWhat, spdlog::logger &logger) {
     Timer timeit(logger, "computeFileHash");
     const static options::Options emptyOpts{};
@@ -1093,6 +2247,9 @@ core::FileHash computeFileHash(shared_ptr<core::File> forWhat, spdlog::logger &l
         fref = lgs->enterFile(forWhat);
         fref.data(*lgs).strictLevel = pipeline::decideStrictLevel(*lgs, fref, emptyOpts);
     }
+    // Every tree built here is discarded before this function returns, so the whole run lives in
+    // one arena instead of leaving a piecemeal-freed tree behind on every edit.
+    ast::ExpressionArena::Scope treeArenaScope;
     vector<ast::ParsedFile> single;
     unique_ptr<KeyValueStore> kvstore;
 
@@ -1105,11 +2262,14 @@ core::FileHash computeFileHash(shared_ptr<core::File> forWhat, spdlog::logger &l
             return {move(invalid), {}};
         }
     }
-    auto allNames = getAllNames(*lgs, single[0].tree);
+    FileHashCollector collector;
+    ast::ConstTreeMap::apply(core::Context(*lgs, core::Symbols::root()), collector, *single[0].tree);
+    core::NameHash::sortAndDedupe(collector.names.sends);
+    core::NameHash::sortAndDedupe(collector.names.constants);
     auto workers = WorkerPool::create(0, lgs->tracer());
     pipeline::resolve(lgs, move(single), emptyOpts, *workers, true);
 
-    return {move(*lgs->hash()), move(allNames)};
+    return {move(*lgs->hash()), move(collector.names), move(collector.methodBodyHashes)};
 }
 
 } // namespace sorbet::realmain::pipeline
@@ -3,6 +3,7 @@
 #include "ProgressIndicator.h"
 #include "ast/ast.h"
 #include "common/common.h"
+#include <atomic>
 #include "common/concurrency/WorkerPool.h"
 #include "common/kvstore/KeyValueStore.h"
 #include "core/NameHash.h"
@@ -22,19 +23,57 @@ std::vector<ast::ParsedFile> index(std::unique_ptr<core::GlobalState> &gs, std::
                                    const options::Options &opts, WorkerPool &workers,
                                    std::unique_ptr<KeyValueStore> &kvstore);
 
+// Like `index` followed by `name`, but streams merged batches of indexed trees into the namer on
+// the collector thread while worker threads are still indexing, so the name phase overlaps the
+// single-threaded tail of the index merge instead of starting after it. Callers that use this must
+// pass `alreadyNamed = true` to `resolve`.
+std::vector<ast::ParsedFile> indexAndName(std::unique_ptr<core::GlobalState> &gs, std::vector<core::FileRef> files,
+                                          const options::Options &opts, WorkerPool &workers,
+                                          std::unique_ptr<KeyValueStore> &kvstore);
+
 std::vector<ast::ParsedFile> resolve(std::unique_ptr<core::GlobalState> &gs, std::vector<ast::ParsedFile> what,
-                                     const options::Options &opts, WorkerPool &workers, bool skipConfigatron = false);
+                                     const options::Options &opts, WorkerPool &workers, bool skipConfigatron = false,
+                                     bool alreadyNamed = false);
 
 std::vector<ast::ParsedFile> incrementalResolve(core::GlobalState &gs, std::vector<ast::ParsedFile> what,
                                                 const options::Options &opts);
 
+// When `workers` is provided and the batch is large, a parallel scan counts the definitions the
+// namer is about to enter and reserves symbol-table capacity up front, so the serial naming walk
+// doesn't reallocate the table mid-phase.
 std::vector<ast::ParsedFile> name(core::GlobalState &gs, std::vector<ast::ParsedFile> what,
-                                  const options::Options &opts, bool skipConfigatron = false);
+                                  const options::Options &opts, bool skipConfigatron = false,
+                                  WorkerPool *workers = nullptr);
+
+// Describes what changed on an incremental (fast path) update so that typecheck can skip inference
+// for methods that cannot have been affected by it.
+struct IncrementalTypecheckInfo {
+    // Name hashes of methods whose definition hash changed in this update. Sorted.
+    std::vector<core::NameHash> changedMethodHashes;
+    // Files being retypechecked only because they use a changed method: they were not themselves
+    // edited and reported no diagnostics on the previous run, so methods in them that don't call a
+    // changed method can skip inference outright. Sorted.
+    std::vector<core::FileRef> dependantFilesWithoutErrors;
+    // For edited files that reported no diagnostics on the previous run: names of methods whose
+    // source text the edit did not touch (per FileHash::methodBodyHashes) and whose signature is
+    // unchanged. Such methods skip inference unless they call a changed method. Sorted per file.
+    UnorderedMap<core::FileRef, std::vector<core::NameHash>> unchangedMethodsInEditedFiles;
+};
 
+// `cancelRequested`, when provided, is polled between files: once it reads true the remaining
+// files are drained without running CFG+inference, so an in-flight run can yield quickly to a
+// superseding edit. Typecheck does not mutate GlobalState, so aborting between files is safe.
 std::vector<ast::ParsedFile> typecheck(std::unique_ptr<core::GlobalState> &gs, std::vector<ast::ParsedFile> what,
-                                       const options::Options &opts, WorkerPool &workers);
+                                       const options::Options &opts, WorkerPool &workers,
+                                       const IncrementalTypecheckInfo *incrementalInfo = nullptr,
+                                       const std::atomic<bool> *cancelRequested = nullptr);
 
-ast::ParsedFile typecheckOne(core::Context ctx, ast::ParsedFile resolved, const options::Options &opts);
+// When `workers` is provided, methods within the file may be typechecked on the worker pool; pass
+// it when typechecking a single file so the pool doesn't sit idle (the per-file fan-out in
+// typecheck() covers the many-file case). Must not be called from within a worker pool task.
+ast::ParsedFile typecheckOne(core::Context ctx, ast::ParsedFile resolved, const options::Options &opts,
+                             const IncrementalTypecheckInfo *incrementalInfo = nullptr,
+                             WorkerPool *workers = nullptr);
 
 core::FileHash computeFileHash(std::shared_ptr<core::File> forWhat, spdlog::logger &logger);
 
@@ -1,6 +1,7 @@
 #ifndef SORBET_PIPELINE_SEMANTIC_EXTENSION
 #define SORBET_PIPELINE_SEMANTIC_EXTENSION
 #include <memory> // unique_ptr
+#include <string>
 #include <vector>
 
 namespace cxxopts {
@@ -26,7 +27,20 @@ class CFG;
 namespace pipeline::semantic_extension {
 class SemanticExtension {
 public:
-    virtual void typecheck(const core::GlobalState &, cfg::CFG &, std::unique_ptr<ast::MethodDef> &) const = 0;
+    virtual void typecheck(const core::GlobalState &, cfg::CFG &, ast::MethodDef &) const = 0;
+
+    // Batching protocol. An extension whose per-method work has no ordering requirement can keep
+    // the inference loop extension-free: return true from defersTypecheck(), record one compact
+    // event per method in deferTypecheck() — which the pipeline calls in typecheck()'s place, with
+    // a per-worker buffer that needs no synchronization — and do the real work in drainDeferred(),
+    // which runs on a dedicated thread after the typecheck fan-out with every worker's events.
+    virtual bool defersTypecheck() const {
+        return false;
+    }
+    virtual void deferTypecheck(const core::GlobalState &, cfg::CFG &, ast::MethodDef &,
+                                std::vector<std::string> &events) const {}
+    virtual void drainDeferred(const core::GlobalState &, std::vector<std::string> events) const {}
+
     virtual std::vector<std::unique_ptr<ast::Expression>> replaceDSL(core::GlobalState &, ast::Send *) const = 0;
     virtual ~SemanticExtension() = 0;
     virtual std::unique_ptr<SemanticExtension> deepCopy(const core::GlobalState &from, core::GlobalState &to) = 0;
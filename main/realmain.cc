@@ -13,11 +13,18 @@
 #include "main/lsp/lsp.h"
 #endif
 
+#include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "common/ArenaStats.h"
 #include "common/FileOps.h"
+#include "common/crypto_hashing/crypto_hashing.h"
 #include "common/Timer.h"
 #include "core/Error.h"
+#include "core/ErrorFlusher.h"
 #include "core/Files.h"
+#include "core/Hashing.h"
+#include "core/NameHash.h"
 #include "core/Unfreeze.h"
 #include "core/errors/errors.h"
 #include "core/lsp/QueryResponse.h"
@@ -31,7 +38,11 @@
 #include "version/version.h"
 
 #include <csignal>
+#include <fstream>
 #include <poll.h>
+#include <random>
+#include <sys/wait.h>
+#include <unistd.h>
 
 namespace spd = spdlog;
 
@@ -167,6 +178,9 @@ struct AutogenResult {
         // Selectively populated based on print options
         string strval;
         string msgpack;
+        // When non-empty, the msgpack above was freshly generated and should be written back to
+        // the cache under this key.
+        string cacheKey;
         vector<string> classlist;
         optional<autogen::Subclasses::Map> subclasses;
     };
@@ -175,33 +189,87 @@ struct AutogenResult {
     unique_ptr<autogen::DefTree> defTree = make_unique<autogen::DefTree>();
 };
 
+// Order-independent fingerprint of every constant defined anywhere in the project. A file's autogen
+// output embeds the resolved names of the constants it references, and adding or removing a
+// constant in one file can change how references in any other file resolve, so per-file cache
+// entries are only valid while this universe stays the same.
+u4 autogenConstantUniverseHash(const core::GlobalState &gs) {
+    vector<u4> fullNameHashes(gs.symbolsUsed());
+    u8 acc = 0;
+    for (u4 i = 1; i < gs.symbolsUsed(); i++) {
+        auto data = core::SymbolRef(&gs, i).data(gs);
+        u4 ownerHash = data->owner.exists() ? fullNameHashes[data->owner._id] : 0;
+        auto h = ownerHash * 41 + core::NameHash(gs, data->name)._hashValue;
+        fullNameHashes[i] = h;
+        if (data->isClass() || data->isStaticField()) {
+            acc += h;
+        }
+    }
+    return (u4)(acc ^ (acc >> 32));
+}
+
 void runAutogen(core::Context ctx, options::Options &opts, const autogen::AutoloaderConfig &autoloaderCfg,
-                WorkerPool &workers, vector<ast::ParsedFile> &indexed) {
+                WorkerPool &workers, vector<ast::ParsedFile> &indexed, unique_ptr<KeyValueStore> &kvstore) {
     Timer timeit(logger, "autogen");
 
+    // A file's msgpack output is deterministic given its content and the project-wide constant
+    // universe, so it can be served from the cache. Only msgpack-only runs qualify: the other
+    // printers need the in-memory ParsedFile, which a cache hit never builds.
+    bool useCache = kvstore != nullptr && opts.print.AutogenMsgPack.enabled && !opts.print.Autogen.enabled &&
+                    !opts.print.AutogenClasslist.enabled && !opts.print.AutogenSubclasses.enabled &&
+                    !opts.print.AutogenAutoloader.enabled;
+    string cachePrefix;
+    if (useCache) {
+        Timer timeit(logger, "autogenCacheKey");
+        cachePrefix = fmt::format("autogen:{}:{:08x}:", opts.autogenVersion, autogenConstantUniverseHash(ctx.state));
+    }
+
     auto resultq = make_shared<BlockingBoundedQueue<AutogenResult>>(indexed.size());
     auto fileq = make_shared<ConcurrentBoundedQueue<int>>(indexed.size());
     for (int i = 0; i < indexed.size(); ++i) {
         fileq->push(move(i), 1);
     }
 
-    workers.multiplexJob("runAutogen", [&ctx, &opts, &indexed, &autoloaderCfg, fileq, resultq]() {
-        AutogenResult out;
-        int n = 0;
-        {
-            Timer timeit(logger, "autogenWorker");
-            int idx = 0;
-
-            for (auto result = fileq->try_pop(idx); !result.done(); result = fileq->try_pop(idx)) {
-                ++n;
-                auto &tree = indexed[idx];
-                if (tree.file.data(ctx).isRBI()) {
-                    continue;
+    // Each file's result is pushed individually rather than batched per worker: the collector
+    // below streams finished records to their destination and frees them, so at no point does the
+    // full output (which can run to gigabytes) sit in memory.
+    workers.multiplexJob("runAutogen", [&ctx, &opts, &indexed, &autoloaderCfg, &kvstore, useCache, cachePrefix, fileq,
+                                        resultq]() {
+        Timer timeit(logger, "autogenWorker");
+        int idx = 0;
+
+        for (auto result = fileq->try_pop(idx); !result.done(); result = fileq->try_pop(idx)) {
+            AutogenResult out;
+            AutogenResult::Serialized serialized;
+            auto &tree = indexed[idx];
+            if (tree.file.data(ctx).isRBI()) {
+                // An empty record: the collector needs to see every index to keep its output
+                // cursor moving, and emitting an empty record writes nothing.
+                out.prints.emplace_back(make_pair(idx, move(serialized)));
+                out.counters = getAndClearThreadCounters();
+                resultq->push(move(out), 1);
+                continue;
+            }
+            string cacheKey;
+            bool cacheHit = false;
+            if (useCache) {
+                auto hashBytes = sorbet::crypto_hashing::hash64(tree.file.data(ctx).source());
+                cacheKey =
+                    cachePrefix + absl::BytesToHexString(string_view{(char *)hashBytes.data(), size(hashBytes)});
+                auto cached = kvstore->readString(cacheKey);
+                if (cached.data() != nullptr) {
+                    prodCounterInc("types.autogen.kvstore.hit");
+                    serialized.msgpack = string(cached);
+                    cacheHit = true;
+                } else {
+                    prodCounterInc("types.autogen.kvstore.miss");
                 }
+            }
+            if (!cacheHit) {
                 auto pf = autogen::Autogen::generate(ctx, move(tree));
                 tree = move(pf.tree);
 
-                AutogenResult::Serialized serialized;
+                serialized.cacheKey = move(cacheKey);
                 if (opts.print.Autogen.enabled) {
                     Timer timeit(logger, "autogenToString");
                     serialized.strval = pf.toString(ctx);
@@ -224,40 +292,91 @@ void runAutogen(core::Context ctx, options::Options &opts, const autogen::Autolo
                     Timer timeit(logger, "autogenNamedDefs");
                     autogen::DefTreeBuilder::addParsedFileDefinitions(ctx, autoloaderCfg, out.defTree, pf);
                 }
-
-                out.prints.emplace_back(make_pair(idx, serialized));
             }
-        }
 
-        out.counters = getAndClearThreadCounters();
-        resultq->push(move(out), n);
+            out.prints.emplace_back(make_pair(idx, move(serialized)));
+            out.counters = getAndClearThreadCounters();
+            resultq->push(move(out), 1);
+        }
     });
 
+    // When the output goes to a file, records are streamed straight to it and freed as their turn
+    // comes up; PrinterConfig would buffer the whole output in memory first. Records still go out
+    // in file order: out-of-order arrivals wait in `pending` until the cursor reaches them, so the
+    // bytes written are identical to the old sort-then-print and the holdback is bounded by how
+    // far ahead of the slowest file the other workers run.
+    ofstream autogenOut;
+    if (opts.print.Autogen.enabled && !opts.print.Autogen.outputPath.empty()) {
+        autogenOut.open(opts.print.Autogen.outputPath, ios::trunc);
+    }
+    ofstream msgpackOut;
+    if (opts.print.AutogenMsgPack.enabled && !opts.print.AutogenMsgPack.outputPath.empty()) {
+        msgpackOut.open(opts.print.AutogenMsgPack.outputPath, ios::trunc | ios::binary);
+    }
+    vector<string> mergedClasslist;
+    autogen::Subclasses::Map childMap;
+    auto emit = [&](AutogenResult::Serialized &elem) {
+        if (useCache && !elem.cacheKey.empty()) {
+            // Workers only read from the store; all writes happen here, on the thread that
+            // created it.
+            kvstore->writeString(elem.cacheKey, elem.msgpack);
+        }
+        if (opts.print.Autogen.enabled) {
+            if (autogenOut.is_open()) {
+                autogenOut.write(elem.strval.data(), elem.strval.size());
+            } else {
+                opts.print.Autogen.print(elem.strval);
+            }
+        }
+        if (opts.print.AutogenMsgPack.enabled) {
+            if (msgpackOut.is_open()) {
+                msgpackOut.write(elem.msgpack.data(), elem.msgpack.size());
+            } else {
+                opts.print.AutogenMsgPack.print(elem.msgpack);
+            }
+        }
+        if (opts.print.AutogenClasslist.enabled) {
+            auto &v = elem.classlist;
+            mergedClasslist.insert(mergedClasslist.end(), make_move_iterator(v.begin()),
+                                   make_move_iterator(v.end()));
+        }
+        if (opts.print.AutogenSubclasses.enabled && elem.subclasses) {
+            for (const auto &[parentName, children] : *elem.subclasses) {
+                if (!parentName.empty()) {
+                    childMap[parentName].insert(children.begin(), children.end());
+                }
+            }
+        }
+    };
+
     autogen::DefTree root;
     AutogenResult out;
-    vector<pair<int, AutogenResult::Serialized>> merged;
+    int nextIdx = 0;
+    UnorderedMap<int, AutogenResult::Serialized> pending;
     for (auto res = resultq->wait_pop_timed(out, chrono::seconds{1}, *logger); !res.done();
          res = resultq->wait_pop_timed(out, chrono::seconds{1}, *logger)) {
         if (!res.gotItem()) {
             continue;
         }
         counterConsume(move(out.counters));
-        merged.insert(merged.end(), make_move_iterator(out.prints.begin()), make_move_iterator(out.prints.end()));
+        for (auto &print : out.prints) {
+            pending[print.first] = move(print.second);
+        }
+        while (true) {
+            auto ready = pending.find(nextIdx);
+            if (ready == pending.end()) {
+                break;
+            }
+            emit(ready->second);
+            pending.erase(ready);
+            ++nextIdx;
+        }
         if (opts.print.AutogenAutoloader.enabled) {
             Timer timeit(logger, "autogenAutoloaderDefTreeMerge");
             root = autogen::DefTreeBuilder::merge(ctx, move(root), move(*out.defTree));
         }
     }
-    fast_sort(merged, [](const auto &lhs, const auto &rhs) -> bool { return lhs.first < rhs.first; });
-
-    for (auto &elem : merged) {
-        if (opts.print.Autogen.enabled) {
-            opts.print.Autogen.print(elem.second.strval);
-        }
-        if (opts.print.AutogenMsgPack.enabled) {
-            opts.print.AutogenMsgPack.print(elem.second.msgpack);
-        }
-    }
+    ENFORCE(pending.empty());
     if (opts.print.AutogenAutoloader.enabled) {
         {
             Timer timeit(logger, "autogenAutoloaderPrune");
@@ -271,11 +390,6 @@ void runAutogen(core::Context ctx, options::Options &opts, const autogen::Autolo
 
     if (opts.print.AutogenClasslist.enabled) {
         Timer timeit(logger, "autogenClasslistPrint");
-        vector<string> mergedClasslist;
-        for (auto &el : merged) {
-            auto &v = el.second.classlist;
-            mergedClasslist.insert(mergedClasslist.end(), make_move_iterator(v.begin()), make_move_iterator(v.end()));
-        }
         fast_sort(mergedClasslist);
         auto last = unique(mergedClasslist.begin(), mergedClasslist.end());
         opts.print.AutogenClasslist.fmt("{}\n", fmt::join(mergedClasslist.begin(), last, "\n"));
@@ -283,21 +397,6 @@ void runAutogen(core::Context ctx, options::Options &opts, const autogen::Autolo
     if (opts.print.AutogenSubclasses.enabled) {
         Timer timeit(logger, "autogenSubclassesPrint");
 
-        // Merge the {Parent: Set{Child1, Child2}} maps from each thread
-        autogen::Subclasses::Map childMap;
-        for (const auto &el : merged) {
-            if (!el.second.subclasses) {
-                // File doesn't define any Child < Parent relationships
-                continue;
-            }
-
-            for (const auto &[parentName, children] : *el.second.subclasses) {
-                if (!parentName.empty()) {
-                    childMap[parentName].insert(children.begin(), children.end());
-                }
-            }
-        }
-
         vector<string> serializedDescendantsMap =
             autogen::Subclasses::genDescendantsMap(childMap, opts.autogenSubclassesParents);
 
@@ -307,6 +406,122 @@ void runAutogen(core::Context ctx, options::Options &opts, const autogen::Autolo
 }
 #endif
 
+namespace {
+
+// --error-baseline support. The baseline maps each file with errors to its content hash and an
+// order-independent fingerprint of its error set; a file whose both hashes match the previous run
+// is skipped before any error text is formatted. It lives in a flat file under the cache dir
+// rather than in the KeyValueStore because the kvstore handle is handed to the background commit
+// thread before typechecking finishes.
+constexpr char ERROR_BASELINE_HEADER[] = "sorbet-error-baseline-v1";
+
+string errorBaselinePath(const options::Options &opts) {
+    return absl::StrCat(opts.cacheDir, "/error_baseline");
+}
+
+string fileContentHash(const core::GlobalState &gs, core::FileRef file) {
+    auto hashBytes = crypto_hashing::hash128Fast(file.data(gs).source());
+    return absl::BytesToHexString(string_view((const char *)hashBytes.data(), 8));
+}
+
+u4 errorSetFingerprint(const vector<unique_ptr<core::Error>> &errors) {
+    vector<u4> prints;
+    prints.reserve(errors.size());
+    for (auto &error : errors) {
+        auto h = core::mix(core::mix(error->what.code, error->loc.beginPos()), error->loc.endPos());
+        prints.emplace_back(core::mix(h, core::_hash(error->header)));
+    }
+    fast_sort(prints);
+    u4 acc = 1;
+    for (auto h : prints) {
+        acc = core::mix(acc, h);
+    }
+    return acc;
+}
+
+void flushErrorsAgainstBaseline(core::GlobalState &gs, const options::Options &opts) {
+    Timer timeit(gs.tracer(), "flushErrorsAgainstBaseline");
+
+    UnorderedMap<core::FileRef, vector<unique_ptr<core::Error>>> byFile;
+    for (auto &error : gs.errorQueue->drainAllErrors()) {
+        if (error->isSilenced) {
+            continue;
+        }
+        byFile[error->loc.file()].emplace_back(move(error));
+    }
+
+    // path -> "contentHash errorSetHash"
+    UnorderedMap<string, string> oldBaseline;
+    auto baselinePath = errorBaselinePath(opts);
+    if (FileOps::exists(baselinePath)) {
+        auto contents = FileOps::read(baselinePath);
+        auto lines = absl::StrSplit(contents, '\n');
+        auto it = lines.begin();
+        if (it != lines.end() && *it == ERROR_BASELINE_HEADER) {
+            for (++it; it != lines.end(); ++it) {
+                auto tab = it->rfind('\t');
+                if (tab != string_view::npos) {
+                    oldBaseline[string(it->substr(0, tab))] = string(it->substr(tab + 1));
+                }
+            }
+        }
+    }
+
+    vector<pair<string, string>> newBaseline;
+    vector<core::FileRef> changedFiles;
+    int suppressedErrors = 0;
+    for (auto &entry : byFile) {
+        auto file = entry.first;
+        if (!file.exists()) {
+            // Errors without a location (e.g. internal ones) always print.
+            changedFiles.emplace_back(file);
+            continue;
+        }
+        auto path = string(file.data(gs).path());
+        auto signature = fmt::format("{} {:08x}", fileContentHash(gs, file), errorSetFingerprint(entry.second));
+        newBaseline.emplace_back(path, signature);
+        auto old = oldBaseline.find(path);
+        if (old != oldBaseline.end() && old->second == signature) {
+            suppressedErrors += entry.second.size();
+            continue;
+        }
+        changedFiles.emplace_back(file);
+    }
+    prodCounterAdd("errors.baseline.suppressed", suppressedErrors);
+
+    // Sort so that CI output is stable from run to run.
+    fast_sort(changedFiles, [&](auto l, auto r) {
+        if (!l.exists() || !r.exists()) {
+            return !l.exists() && r.exists();
+        }
+        return l.data(gs).path() < r.data(gs).path();
+    });
+    vector<core::ErrorQueueMessage> toFlush;
+    for (auto file : changedFiles) {
+        for (auto &error : byFile[file]) {
+            core::ErrorQueueMessage msg;
+            msg.kind = core::ErrorQueueMessage::Kind::Error;
+            msg.whatFile = file;
+            msg.error = move(error);
+            toFlush.emplace_back(move(msg));
+        }
+    }
+    core::ErrorFlusher flusher;
+    // The flusher formats only the errors handed to it, i.e. only the ones for changed files; that
+    // is the point of this mode.
+    flusher.flushErrors(gs, gs.errorQueue->logger, move(toFlush));
+
+    fast_sort(newBaseline);
+    fmt::memory_buffer buf;
+    fmt::format_to(buf, "{}\n", ERROR_BASELINE_HEADER);
+    for (auto &entry : newBaseline) {
+        fmt::format_to(buf, "{}\t{}\n", entry.first, entry.second);
+    }
+    FileOps::write(baselinePath, to_string(buf));
+}
+
+} // namespace
+
 int realmain(int argc, char *argv[]) {
 #ifndef SORBET_REALMAIN_MIN
     absl::InitializeSymbolizer(argv[0]);
@@ -330,6 +545,16 @@ int realmain(int argc, char *argv[]) {
     if (opts.stdoutHUPHack) {
         startHUPMonitor();
     }
+    // Decide once per run whether this invocation ships detailed (per-file) telemetry, and only
+    // collect per-scope timer args when something will actually consume them; the unsampled fleet
+    // pays one branch per Timer and nothing more.
+    bool sampleDetailedMetrics = opts.statsdDetailSampleEvery > 0 && !opts.statsdHost.empty() &&
+                                 random_device{}() % opts.statsdDetailSampleEvery == 0;
+    Timer::setCollectArgs(sampleDetailedMetrics || !opts.webTraceFile.empty() || !opts.flamegraphFile.empty() ||
+                          !opts.hotFileReportFile.empty());
+    if (sampleDetailedMetrics) {
+        prodCounterInc("statsd.detailed_sample");
+    }
     if (!opts.debugLogFile.empty()) {
         // LSP could run for a long time. Rotate log files, and trim at 1 GiB. Keep around 3 log files.
         // Cast first number to size_t to prevent integer multiplication.
@@ -395,30 +620,58 @@ int realmain(int argc, char *argv[]) {
     gs->pathPrefix = opts.pathPrefix;
     gs->errorUrlBase = opts.errorUrlBase;
     gs->semanticExtensions = move(extensions);
+#ifndef SORBET_REALMAIN_MIN
+    if (opts.print.ErrorsProto.enabled) {
+        // Stream a structured copy of every non-silenced error as it flushes: a varint
+        // length-delimited binary Diagnostic per error, so consumers parse incrementally instead of
+        // buffering and re-lexing the text output.
+        gs->errorQueue->errorSink = [&opts](const core::GlobalState &gs, const core::Error &error) {
+            opts.print.ErrorsProto.print(core::Proto::toDelimitedBinary(core::Proto::toProto(gs, error)));
+        };
+    }
+#endif
     vector<ast::ParsedFile> indexed;
 
     logger->trace("building initial global state");
     unique_ptr<KeyValueStore> kvstore;
+    unique_ptr<Joinable> kvstoreCommit;
     if (!opts.cacheDir.empty()) {
-        kvstore = make_unique<KeyValueStore>(Version::full_version_string, opts.cacheDir,
-                                             opts.skipDSLPasses ? "nodsl" : "default");
+        string flavor = opts.skipDSLPasses ? "nodsl" : "default";
+        if (!opts.loadStateDelta.empty()) {
+            // A different payload assigns different name and symbol ids, so cached state and trees
+            // must not be shared across deltas (or with the plain payload).
+            auto deltaHash = crypto_hashing::hash64(FileOps::read(opts.loadStateDelta));
+            flavor += ":delta-" + absl::BytesToHexString(string_view((const char *)deltaHash.data(), 8));
+        }
+        kvstore = make_unique<LmdbKeyValueStore>(Version::full_version_string, opts.cacheDir, flavor);
     }
     payload::createInitialGlobalState(gs, opts, kvstore);
     if (opts.silenceErrors) {
         gs->silenceErrors = true;
     }
+    if (opts.countErrorsOnly) {
+        gs->suppressErrorDetails = true;
+    }
     if (opts.autocorrect) {
         gs->autocorrect = true;
     }
     if (opts.suggestRuntimeProfiledType) {
         gs->suggestRuntimeProfiledType = true;
     }
+    if (opts.batchSigSuggestions) {
+        gs->deferSigSuggestions = true;
+    }
     if (opts.print.isAutogen()) {
         gs->runningUnderAutogen = true;
     }
     if (opts.censorForSnapshotTests) {
         gs->censorForSnapshotTests = true;
     }
+    if (opts.errorBaseline) {
+        // Don't format error text at report time; flushErrorsAgainstBaseline formats only the
+        // files whose error set changed.
+        gs->errorQueue->ignoreFlushes = true;
+    }
     if (opts.reserveMemKiB > 0) {
         gs->reserveMemory(opts.reserveMemKiB);
     }
@@ -451,7 +704,11 @@ int realmain(int argc, char *argv[]) {
                       "If you're developing an LSP extension to some editor, make sure to run sorbet with `-v` flag,"
                       "it will enable outputing the LSP session to stderr(`Write: ` and `Read: ` log lines)",
                       Version::full_version_string);
-        lsp::LSPLoop loop(move(gs), opts, logger, *workers, STDIN_FILENO, cout);
+        // The loop owns the cache handle: after its initial index it retains the global state and
+        // fresh tree entries so the next cold start (payload updates ship a new binary, forcing a
+        // restart) warms from the cache.
+        lsp::LSPLoop loop(move(gs), opts, logger, *workers, STDIN_FILENO, cout,
+                          /*skipConfigatron=*/false, /*disableFastPath=*/false, move(kvstore));
         gs = loop.runLSP();
 #endif
     } else {
@@ -477,9 +734,12 @@ int realmain(int argc, char *argv[]) {
             }
         }
 
-        { indexed = pipeline::index(gs, inputFiles, opts, *workers, kvstore); }
-
-        payload::retainGlobalState(gs, opts, kvstore);
+        if (gs->runningUnderAutogen) {
+            // Autogen names explicitly below, after suppressing a few error classes.
+            indexed = pipeline::index(gs, inputFiles, opts, *workers, kvstore);
+        } else {
+            indexed = pipeline::indexAndName(gs, inputFiles, opts, *workers, kvstore);
+        }
 
         if (gs->runningUnderAutogen) {
 #ifndef SORBET_REALMAIN_MIN
@@ -505,10 +765,86 @@ int realmain(int argc, char *argv[]) {
                 autoloaderCfg = autogen::AutoloaderConfig::enterConfig(*gs, opts.autoloaderConfig);
             }
 
-            runAutogen(ctx, opts, autoloaderCfg, *workers, indexed);
+            runAutogen(ctx, opts, autoloaderCfg, *workers, indexed, kvstore);
 #endif
+            // Autogen reads and writes its per-file cache entries above, so the commit has to wait
+            // until it is done.
+            kvstoreCommit = payload::retainGlobalState(gs, opts, kvstore);
+            if (kvstore != nullptr) {
+                // retainGlobalState skips the commit when the global state itself came from the
+                // cache, but autogen may still have written fresh entries.
+                kvstoreCommit = KeyValueStore::commitInBackground(move(kvstore));
+            }
         } else {
-            indexed = pipeline::resolve(gs, move(indexed), opts, *workers);
+            // The cache commit runs concurrently with the rest of the pipeline; the handle joins
+            // the commit thread when it goes out of scope at the end of this function.
+            kvstoreCommit = payload::retainGlobalState(gs, opts, kvstore);
+            if (!opts.suggestTyped && !opts.autocorrect && opts.typedSource.empty()) {
+                // Resolution and inference work off the trees; the raw sources are only needed
+                // again to print snippets for files that error, and those fault back in one at a
+                // time. Dropping them here lowers peak RSS for the rest of the run. Modes that
+                // rewrite or dump sources wholesale would just fault everything back, so they
+                // keep their buffers.
+                for (int i = 1; i < gs->filesUsed(); i++) {
+                    core::FileRef(i).dataAllowingUnsafe(*gs).releaseSource();
+                }
+            }
+            indexed = pipeline::resolve(gs, move(indexed), opts, *workers, /*skipConfigatron=*/false,
+                                        /*alreadyNamed=*/true);
+
+            if (opts.typecheckProcesses > 1) {
+                // Process-level typecheck parallelism for NUMA boxes: each forked child inherits
+                // the frozen, resolved GlobalState through copy-on-write pages, so the tables are
+                // shared with zero synchronization and TypePtr refcount updates stay process-local
+                // instead of bouncing cache lines between sockets. The children reuse the shard
+                // filter in pipeline::typecheck; the parent only merges exit statuses. Errors from
+                // the phases up to resolve were already flushed here in the parent, so each child
+                // reports exactly its own shard's typecheck errors.
+                int numShards = opts.typecheckProcesses;
+                vector<pid_t> children;
+                int myShard = -1;
+                for (int shard = 0; shard < numShards; shard++) {
+                    auto pid = fork();
+                    if (pid < 0) {
+                        logger->error("fork() failed while starting typecheck worker processes");
+                        return 10;
+                    }
+                    if (pid == 0) {
+                        myShard = shard;
+                        break;
+                    }
+                    children.emplace_back(pid);
+                }
+                if (myShard == -1) {
+                    int worst = 0;
+                    for (auto pid : children) {
+                        int status = 0;
+                        waitpid(pid, &status, 0);
+                        worst = max(worst, WIFEXITED(status) ? WEXITSTATUS(status) : 10);
+                    }
+                    // The children printed the diagnostics and wrote the metrics; none of the
+                    // post-typecheck work below applies to the parent. Leak like the normal exit
+                    // path does rather than paying for destructors on the way out.
+                    if (!sorbet::emscripten_build) {
+                        for (auto &e : indexed) {
+                            intentionallyLeakMemory(e.tree.release());
+                        }
+                        intentionallyLeakMemory(gs.release());
+                    }
+                    return worst;
+                }
+                // Child: the inherited worker threads and the background cache-commit thread live
+                // in the parent's address space only; their handles must never be joined here.
+                intentionallyLeakMemory(workers.release());
+                intentionallyLeakMemory(kvstoreCommit.release());
+                opts.typecheckShard = myShard;
+                opts.typecheckNumShards = numShards;
+                workers = WorkerPool::create(max(opts.threads / numShards, 1), *logger);
+                if (!opts.metricsFile.empty()) {
+                    opts.metricsFile = fmt::format("{}.shard-{}", opts.metricsFile, myShard);
+                }
+            }
+
             indexed = pipeline::typecheck(gs, move(indexed), opts, *workers);
         }
 
@@ -535,13 +871,17 @@ int realmain(int argc, char *argv[]) {
             }
         }
 
-        gs->errorQueue->flushErrors(true);
+        if (opts.errorBaseline) {
+            flushErrorsAgainstBaseline(*gs, opts);
+        } else {
+            gs->errorQueue->flushErrors(*gs, true);
+        }
 
         if (!opts.noErrorCount) {
             gs->errorQueue->flushErrorCount();
         }
         if (opts.autocorrect) {
-            gs->errorQueue->flushAutocorrects(*gs, *opts.fs);
+            gs->errorQueue->flushAutocorrects(*gs, *opts.fs, *workers);
         }
         logger->trace("sorbet done");
 
@@ -550,6 +890,14 @@ int realmain(int argc, char *argv[]) {
             FileOps::write(opts.storeState.c_str(), core::serialize::Serializer::store(*gs));
         }
 
+        if (!opts.storeStateDelta.empty()) {
+            gs->markAsPayload();
+            if (!payload::storeGlobalStateDelta(gs, opts)) {
+                logger->error("--store-state-delta requires a binary with a compiled-in payload");
+                return 1;
+            }
+        }
+
         auto untypedSources = getAndClearHistogram("untyped.sources");
         if (opts.suggestSig) {
             ENFORCE(sorbet::debug_mode);
@@ -585,6 +933,7 @@ int realmain(int argc, char *argv[]) {
         logger->debug("" + getCounterStatistics(Counters::ALL_COUNTERS));
     }
 
+    ArenaStats::submitHighWater();
     auto counters = getAndClearThreadCounters();
 
     if (!opts.statsdHost.empty()) {
@@ -592,11 +941,18 @@ int realmain(int argc, char *argv[]) {
         if (opts.runLSP) {
             prefix += ".lsp";
         }
-        StatsD::submitCounters(counters, opts.statsdHost, opts.statsdPort, prefix + ".counters");
+        StatsD::submitCounters(counters, opts.statsdHost, opts.statsdPort, prefix + ".counters",
+                               sampleDetailedMetrics);
     }
     if (!opts.webTraceFile.empty()) {
         web_tracer_framework::Tracing::storeTraces(counters, opts.webTraceFile);
     }
+    if (!opts.flamegraphFile.empty()) {
+        web_tracer_framework::Tracing::storeCollapsedStacks(counters, opts.flamegraphFile);
+    }
+    if (!opts.hotFileReportFile.empty()) {
+        web_tracer_framework::Tracing::storeHotFileReport(counters, opts.hotFileReportFile, opts.hotFileReportCompare);
+    }
 
     if (!opts.metricsFile.empty()) {
         auto metrics = core::Proto::toProto(counters, opts.metricsPrefix);
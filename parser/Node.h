@@ -20,6 +20,10 @@ public:
     virtual std::string nodeName() = 0;
     core::Loc loc;
 
+    // Nodes are bump-allocated while a `NodeArena::Scope` is active on this thread; see NodeArena.h.
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr);
+
 protected:
     void printTabs(fmt::memory_buffer &to, int count) const;
     void printNode(fmt::memory_buffer &to, const std::unique_ptr<Node> &node, const core::GlobalState &gs,
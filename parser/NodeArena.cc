@@ -0,0 +1,76 @@
+#include "parser/NodeArena.h"
+#include "common/ArenaStats.h"
+#include "parser/parser.h"
+
+using namespace std;
+
+namespace sorbet::parser {
+
+namespace {
+// Every node allocation is prefixed by one max-aligned header word recording whether it came from
+// an arena or from the global heap, so that `operator delete` can tell the two apart.
+constexpr size_t HEADER_SIZE = alignof(max_align_t);
+constexpr uintptr_t ARENA_TAG = 1;
+constexpr uintptr_t HEAP_TAG = 0;
+} // namespace
+
+thread_local NodeArena *NodeArena::active = nullptr;
+
+void *NodeArena::allocate(size_t size) {
+    size = (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+    if (size > available) {
+        size_t blockSize = max(size, BLOCK_SIZE);
+        blocks.emplace_back(make_unique<char[]>(blockSize));
+        freePtr = blocks.back().get();
+        available = blockSize;
+        blockBytes += blockSize;
+        ArenaStats::blockAllocated(blockSize);
+    }
+    char *result = freePtr;
+    freePtr += size;
+    available -= size;
+    allocatedBytes += size;
+    return result;
+}
+
+NodeArena::~NodeArena() {
+    if (!blocks.empty()) {
+        ArenaStats::arenaFreed(ArenaStats::Kind::Node, allocatedBytes, blockBytes, blocks.size());
+    }
+}
+
+NodeArena::Scope::Scope() : prev(active) {
+    active = &arena;
+}
+
+NodeArena::Scope::~Scope() {
+    active = prev;
+}
+
+void *Node::operator new(size_t size) {
+    char *mem;
+    uintptr_t tag;
+    if (auto *arena = NodeArena::active) {
+        mem = static_cast<char *>(arena->allocate(size + HEADER_SIZE));
+        tag = ARENA_TAG;
+    } else {
+        mem = static_cast<char *>(::operator new(size + HEADER_SIZE));
+        tag = HEAP_TAG;
+    }
+    *reinterpret_cast<uintptr_t *>(mem) = tag;
+    return mem + HEADER_SIZE;
+}
+
+void Node::operator delete(void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    char *mem = static_cast<char *>(ptr) - HEADER_SIZE;
+    if (*reinterpret_cast<uintptr_t *>(mem) == ARENA_TAG) {
+        // Freed in one shot when the owning NodeArena dies.
+        return;
+    }
+    ::operator delete(mem);
+}
+
+}; // namespace sorbet::parser
@@ -1,4 +1,5 @@
 #include "payload/payload.h"
+#include "common/FileOps.h"
 #include "common/Timer.h"
 #include "core/serialize/serialize.h"
 #include "payload/binary/binary.h"
@@ -35,18 +36,42 @@ void createInitialGlobalState(unique_ptr<core::GlobalState> &gs, const realmain:
     if (nameTablePayload == nullptr) {
         Timer timeit(gs->tracer(), "read_global_state.source");
         sorbet::rbi::polulateRBIsInto(gs);
+    } else if (!options.loadStateDelta.empty()) {
+        Timer timeit(gs->tracer(), "read_global_state.binary_delta");
+        auto delta = FileOps::read(options.loadStateDelta);
+        core::serialize::Serializer::loadGlobalStateWithDelta(*gs, nameTablePayload,
+                                                              reinterpret_cast<const u1 *>(delta.data()));
+        gs->markPayloadSymbolBoundary();
     } else {
         Timer timeit(gs->tracer(), "read_global_state.binary");
-        core::serialize::Serializer::loadGlobalState(*gs, nameTablePayload);
+        // The payload lives in the binary's rodata, so it outlives the GlobalState and symbol
+        // records can be hydrated lazily as they are first touched.
+        core::serialize::Serializer::loadGlobalState(*gs, nameTablePayload, /* lazySymbols */ true);
+        gs->markPayloadSymbolBoundary();
     }
 }
 
-void retainGlobalState(unique_ptr<core::GlobalState> &gs, const realmain::options::Options &options,
-                       unique_ptr<KeyValueStore> &kvstore) {
+unique_ptr<Joinable> retainGlobalState(unique_ptr<core::GlobalState> &gs, const realmain::options::Options &options,
+                                       unique_ptr<KeyValueStore> &kvstore) {
     if (kvstore && gs->wasModified() && !gs->hadCriticalError()) {
         Timer timeit(gs->tracer(), "write_global_state.kvstore");
         kvstore->write(GLOBAL_STATE_KEY, core::serialize::Serializer::storePayloadAndNameTable(*gs));
-        KeyValueStore::commit(move(kvstore));
+        return KeyValueStore::commitInBackground(move(kvstore));
     }
+    return nullptr;
+}
+
+bool storeGlobalStateDelta(unique_ptr<core::GlobalState> &gs, const realmain::options::Options &options) {
+    const u1 *const nameTablePayload = getNameTablePayload;
+    if (nameTablePayload == nullptr) {
+        return false;
+    }
+    Timer timeit(gs->tracer(), "write_global_state.delta");
+    // Diff against a fresh load of the compiled-in payload; everything this run entered on top of
+    // it lands in the delta.
+    auto base = make_unique<core::GlobalState>(gs->errorQueue);
+    core::serialize::Serializer::loadGlobalState(*base, nameTablePayload);
+    FileOps::write(options.storeStateDelta, core::serialize::Serializer::storeDelta(*gs, *base));
+    return true;
 }
 } // namespace sorbet::payload
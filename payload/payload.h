@@ -9,8 +9,16 @@ namespace sorbet::payload {
 
 void createInitialGlobalState(std::unique_ptr<core::GlobalState> &gs, const realmain::options::Options &options,
                               std::unique_ptr<KeyValueStore> &kvstore);
-void retainGlobalState(std::unique_ptr<core::GlobalState> &gs, const realmain::options::Options &options,
-                       std::unique_ptr<KeyValueStore> &kvstore);
+/** Writes the name table to the cache and commits it on a background thread. The returned handle
+ * (possibly nullptr) joins that thread when destroyed; hold it until the end of the run. */
+std::unique_ptr<Joinable> retainGlobalState(std::unique_ptr<core::GlobalState> &gs,
+                                            const realmain::options::Options &options,
+                                            std::unique_ptr<KeyValueStore> &kvstore);
+
+/** Writes a delta of `gs` against a fresh load of the compiled-in payload to
+ * `options.storeStateDelta` (see Serializer::storeDelta). Returns false when this binary has no
+ * compiled-in payload to diff against. */
+bool storeGlobalStateDelta(std::unique_ptr<core::GlobalState> &gs, const realmain::options::Options &options);
 
 } // namespace sorbet::payload
 #endif // RUBY_TYPER_PAYLOAD_H
@@ -1,4 +1,5 @@
 #include "common/Timer.h"
+#include "common/concurrency/ConcurrentQueue.h"
 #include "core/Names.h"
 #include "core/core.h"
 #include "core/errors/resolver.h"
@@ -157,8 +158,9 @@ void Resolver::finalizeAncestors(core::GlobalState &gs) {
     Timer timer(gs.errorQueue->logger, "resolver.finalize_ancestors");
     int methodCount = 0;
     int classCount = 0;
-    for (int i = 1; i < gs.symbolsUsed(); ++i) {
-        auto ref = core::SymbolRef(&gs, i);
+    // Untouched payload symbols already went through this pass before the payload was serialized
+    // (module/superclass defaults never get unset), so only the project segment needs the work.
+    gs.forEachProjectSymbol([&](core::SymbolRef ref) {
         auto loc = ref.data(gs)->loc();
         if (loc.file().exists() && loc.file().data(gs).sourceType == core::File::Type::Normal) {
             if (ref.data(gs)->isMethod()) {
@@ -168,7 +170,7 @@ void Resolver::finalizeAncestors(core::GlobalState &gs) {
             }
         }
         if (!ref.data(gs)->isClass()) {
-            continue;
+            return;
         }
         classCount++;
         if (!ref.data(gs)->isClassModuleSet()) {
@@ -176,13 +178,13 @@ void Resolver::finalizeAncestors(core::GlobalState &gs) {
             ref.data(gs)->setIsModule(true);
         }
         if (ref.data(gs)->superClass().exists() && ref.data(gs)->superClass() != core::Symbols::todo()) {
-            continue;
+            return;
         }
         if (ref == core::Symbols::Sorbet_Private_Static_ImplicitModuleSuperClass()) {
             // only happens if we run without stdlib
             ENFORCE(!core::Symbols::Sorbet_Private_Static_ImplicitModuleSuperClass().data(gs)->loc().exists());
             ref.data(gs)->setSuperClass(core::Symbols::BasicObject());
-            continue;
+            return;
         }
 
         auto attached = ref.data(gs)->attachedClass(gs);
@@ -210,7 +212,7 @@ void Resolver::finalizeAncestors(core::GlobalState &gs) {
                 }
             }
         }
-    }
+    });
 
     prodCounterAdd("types.input.classes.total", classCount);
     prodCounterAdd("types.input.methods.total", methodCount);
@@ -327,30 +329,130 @@ InlinedVector<core::SymbolRef, 4> ParentLinearizationInformation::fullLinearizat
     return res;
 }
 
-void computeLinearization(core::GlobalState &gs) {
+// Depth of a class in the parent DAG (superclass plus mixins). Parents always end up with a
+// strictly smaller level than their children, so computing linearizations level by level lets each
+// level run in parallel: a class only writes its own mixin list and reads already-computed parents.
+int computeLinearizationLevels(core::GlobalState &gs, vector<int> &levels, core::SymbolRef ofClass) {
+    auto &memo = levels[ofClass._id];
+    if (memo != 0) {
+        return memo;
+    }
+    auto data = ofClass.data(gs);
+    int level = 0;
+    if (data->superClass().exists()) {
+        level = max(level, computeLinearizationLevels(gs, levels, data->superClass()));
+    }
+    for (auto mixin : data->mixins()) {
+        level = max(level, computeLinearizationLevels(gs, levels, mixin));
+    }
+    memo = level + 1;
+    return memo;
+}
+
+// Below these sizes the fan-out overhead outweighs the parallelism.
+constexpr size_t MIN_CLASSES_FOR_PARALLEL_LINEARIZATION = 4096;
+constexpr size_t MIN_LEVEL_SIZE_FOR_PARALLEL_LINEARIZATION = 128;
+
+void computeLinearization(core::GlobalState &gs, WorkerPool &workers) {
     Timer timer(gs.errorQueue->logger, "resolver.compute_linearization");
 
     // TODO: this does not support `prepend`
-    for (int i = 1; i < gs.symbolsUsed(); ++i) {
-        const auto &data = core::SymbolRef(&gs, i).data(gs);
-        if (!data->isClass()) {
+    vector<core::SymbolRef> classes;
+    vector<int> levels(gs.symbolsUsed(), 0);
+    int maxLevel = 0;
+    // Untouched payload classes were serialized with their linearization flag set, so visiting
+    // them would be a no-op anyway; reopened ones come through the project walk.
+    gs.forEachProjectSymbol([&](core::SymbolRef ref) {
+        if (!ref.data(gs)->isClass()) {
+            return;
+        }
+        classes.emplace_back(ref);
+        maxLevel = max(maxLevel, computeLinearizationLevels(gs, levels, ref));
+    });
+
+    if (workers.size() <= 1 || classes.size() < MIN_CLASSES_FOR_PARALLEL_LINEARIZATION) {
+        for (auto ref : classes) {
+            computeLinearization(gs, ref);
+        }
+        return;
+    }
+
+    vector<vector<core::SymbolRef>> byLevel(maxLevel + 1);
+    for (auto ref : classes) {
+        byLevel[levels[ref._id]].emplace_back(ref);
+    }
+    for (auto &level : byLevel) {
+        if (level.size() < MIN_LEVEL_SIZE_FOR_PARALLEL_LINEARIZATION) {
+            for (auto ref : level) {
+                computeLinearization(gs, ref);
+            }
             continue;
         }
-        computeLinearization(gs, core::SymbolRef(&gs, i));
+        auto classq = make_shared<ConcurrentBoundedQueue<core::SymbolRef>>(level.size());
+        for (auto ref : level) {
+            auto copy = ref;
+            classq->push(move(copy), 1);
+        }
+        auto resultq = make_shared<BlockingBoundedQueue<int>>(level.size());
+        workers.multiplexJob("computeLinearization", [classq, resultq, &gs]() {
+            int processedByThread = 0;
+            core::SymbolRef job;
+            for (auto result = classq->try_pop(job); !result.done(); result = classq->try_pop(job)) {
+                if (result.gotItem()) {
+                    processedByThread++;
+                    computeLinearization(gs, job);
+                }
+            }
+            if (processedByThread > 0) {
+                resultq->push(move(processedByThread), processedByThread);
+            }
+        });
+        // The drain doubles as the barrier between levels: the next level may read any class
+        // processed here.
+        {
+            int processedByThread = 0;
+            for (auto result = resultq->wait_pop_timed(processedByThread, WorkerPool::BLOCK_INTERVAL(),
+                                                       gs.errorQueue->logger);
+                 !result.done(); result = resultq->wait_pop_timed(processedByThread, WorkerPool::BLOCK_INTERVAL(),
+                                                                  gs.errorQueue->logger)) {
+            }
+        }
+    }
+}
+
+// Fills in Symbol::ancestorFingerprint once linearization has made every class's mixin list
+// transitively complete: the fingerprint unions the bits of exactly the set derivesFrom scans —
+// the class itself, its own mixins, and everything along the superclass chain. Memoized through
+// the field itself (a computed fingerprint always has the class's own bit set, so it is nonzero).
+u8 computeAncestorFingerprint(core::GlobalState &gs, core::SymbolRef ofClass) {
+    auto data = ofClass.data(gs);
+    if (data->ancestorFingerprint != 0) {
+        return data->ancestorFingerprint;
     }
+    ENFORCE(data->isClassLinearizationComputed());
+    auto result = core::Symbol::fingerprintBit(ofClass);
+    for (auto mixin : data->mixins()) {
+        result |= core::Symbol::fingerprintBit(mixin);
+    }
+    if (data->superClass().exists()) {
+        result |= computeAncestorFingerprint(gs, data->superClass());
+    }
+    data->ancestorFingerprint = result;
+    return result;
 }
 
-void Resolver::finalizeSymbols(core::GlobalState &gs) {
+void Resolver::finalizeSymbols(core::GlobalState &gs, WorkerPool &workers) {
     Timer timer(gs.errorQueue->logger, "resolver.finalize_resolution");
     // TODO(nelhage): Properly this first loop should go in finalizeAncestors,
     // but we currently compute mixes_in_class_methods during the same AST walk
     // that resolves types and we don't want to introduce additional passes if
     // we don't have to. It would be a tractable refactor to merge it
     // `ResolveConstantsWalk` if it becomes necessary to process earlier.
-    for (int i = 1; i < gs.symbolsUsed(); ++i) {
-        auto sym = core::SymbolRef(&gs, i);
+    // Project segment only: payload classes had their mixes_in_class_methods mixins folded into
+    // their singletons before the payload was serialized, and repeating it would append duplicates.
+    gs.forEachProjectSymbol([&](core::SymbolRef sym) {
         if (!sym.data(gs)->isClass()) {
-            continue;
+            return;
         }
 
         core::SymbolRef singleton;
@@ -364,20 +466,33 @@ void Resolver::finalizeSymbols(core::GlobalState &gs) {
             }
             singleton.data(gs)->mixins().emplace_back(classMethods);
         }
-    }
+    });
 
-    computeLinearization(gs);
+    computeLinearization(gs, workers);
+
+    {
+        // Payload symbols arrive with fingerprint zero (the field is not serialized), so this
+        // recomputes them each run; the whole pass is one walk of the ancestor DAG.
+        Timer timerFingerprints(gs.errorQueue->logger, "resolver.ancestor_fingerprints");
+        for (int i = 1; i < gs.symbolsUsed(); ++i) {
+            auto sym = core::SymbolRef(&gs, i);
+            if (sym.data(gs)->isClass()) {
+                computeAncestorFingerprint(gs, sym);
+            }
+        }
+    }
 
     vector<vector<pair<core::SymbolRef, core::SymbolRef>>> typeAliases;
     typeAliases.resize(gs.symbolsUsed());
     vector<bool> resolved;
     resolved.resize(gs.symbolsUsed());
-    for (int i = 1; i < gs.symbolsUsed(); ++i) {
-        auto sym = core::SymbolRef(&gs, i);
+    // Project classes pull their payload ancestors in through the recursion; payload classes with
+    // no project descendant were fully resolved before serialization.
+    gs.forEachProjectSymbol([&](core::SymbolRef sym) {
         if (sym.data(gs)->isClass()) {
             resolveTypeMembers(gs, sym, typeAliases, resolved);
         }
-    }
+    });
 }
 
 } // namespace sorbet::resolver
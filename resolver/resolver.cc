@@ -13,6 +13,7 @@
 #include "absl/strings/str_cat.h"
 #include "common/Timer.h"
 #include "core/Symbols.h"
+#include <atomic>
 #include <utility>
 #include <vector>
 
@@ -93,10 +94,47 @@ private:
     struct Nesting {
         const shared_ptr<Nesting> parent;
         const core::SymbolRef scope;
+        // Interned id for the symbol sequence this chain names (see chainIds_): chains naming the
+        // same scopes get the same id within one walk, so resolution results can be shared across
+        // files that repeat a nesting (`module Opus; class Foo` etc.).
+        const u4 chainId;
 
-        Nesting(shared_ptr<Nesting> parent, core::SymbolRef scope) : parent(std::move(parent)), scope(scope) {}
+        Nesting(shared_ptr<Nesting> parent, core::SymbolRef scope, u4 chainId)
+            : parent(std::move(parent)), scope(scope), chainId(chainId) {}
     };
+
+    // Memoizes resolveLhs, misses included: (chain id << 32 | name id) -> result. Sound only while
+    // the symbol table is not mutated; see the individual holders for their lifetimes. Arena-backed
+    // because every holder is scratch scoped to one walk or pass.
+    typedef ArenaUnorderedMap<u8, core::SymbolRef> ResolveCache;
+
     shared_ptr<Nesting> nesting_;
+    // Backs the walk-scoped caches below; declared first so it outlives them. Their tables
+    // (including ones superseded by rehashes) bump-allocate here instead of churning the heap.
+    MonotonicArena scratchArena_;
+    // Interns nesting chains for this walk: (parent chain id << 32 | scope id) -> chain id. The
+    // root chain is id 0.
+    ArenaUnorderedMap<u8, u4> chainIds_{ArenaAllocator<std::pair<const u8, u4>>(scratchArena_)};
+    // First-pass resolution cache. Valid for the walk's whole lifetime (one worker's share of the
+    // files) because the walk only reads the symbol table.
+    ResolveCache resolveCache_{ResolveCache::allocator_type(scratchArena_)};
+
+    // Chain ids must be unique across walks, not just within one: the fixed-point workers mix
+    // ResolutionItems whose chains were interned by different walk workers, and a per-walk
+    // numbering would alias distinct chains in their caches. Equal chains from different walks
+    // getting different ids merely costs cache hits, never correctness.
+    static inline std::atomic<u4> nextChainId{1};
+
+    u4 internChainId(u4 parentChainId, core::SymbolRef scope) {
+        auto key = (u8(parentChainId) << 32) | scope._id;
+        auto it = chainIds_.find(key);
+        if (it != chainIds_.end()) {
+            return it->second;
+        }
+        auto id = nextChainId.fetch_add(1, std::memory_order_relaxed);
+        chainIds_.emplace(key, id);
+        return id;
+    }
 
     struct ResolutionItem {
         shared_ptr<Nesting> scope;
@@ -153,7 +191,8 @@ private:
     vector<ClassAliasResolutionItem> todoClassAliases_;
     vector<TypeAliasResolutionItem> todoTypeAliases_;
 
-    static core::SymbolRef resolveLhs(core::Context ctx, shared_ptr<Nesting> nesting, core::NameRef name) {
+    static core::SymbolRef resolveLhsUncached(core::Context ctx, const shared_ptr<Nesting> &nesting,
+                                              core::NameRef name) {
         Nesting *scope = nesting.get();
         while (scope != nullptr) {
             auto lookup = scope->scope.data(ctx)->findMember(ctx, name);
@@ -165,6 +204,24 @@ private:
         return nesting->scope.data(ctx)->findMemberTransitive(ctx, name);
     }
 
+    static core::SymbolRef resolveLhs(core::Context ctx, const shared_ptr<Nesting> &nesting, core::NameRef name,
+                                      ResolveCache *cache) {
+        if (cache == nullptr) {
+            return resolveLhsUncached(ctx, nesting, name);
+        }
+        // Common constants (`T::Sig`, logging helpers, ...) resolve through identical nesting
+        // chains millions of times; the chain walk and its ancestor-table fallback repeat the same
+        // work each time, so memoize per (chain, name), caching misses too.
+        const u8 key = (u8(nesting->chainId) << 32) | u4(name.id());
+        auto it = cache->find(key);
+        if (it != cache->end()) {
+            return it->second;
+        }
+        auto result = resolveLhsUncached(ctx, nesting, name);
+        cache->emplace(key, result);
+        return result;
+    }
+
     static bool isAlreadyResolved(core::Context ctx, const ast::ConstantLit &original) {
         auto sym = original.symbol;
         if (!sym.exists()) {
@@ -199,9 +256,10 @@ private:
     }
 
     static core::SymbolRef resolveConstant(core::Context ctx, shared_ptr<Nesting> nesting,
-                                           const unique_ptr<ast::UnresolvedConstantLit> &c, bool &resolutionFailed) {
+                                           const unique_ptr<ast::UnresolvedConstantLit> &c, bool &resolutionFailed,
+                                           ResolveCache *cache) {
         if (ast::isa_tree<ast::EmptyTree>(c->scope.get())) {
-            core::SymbolRef result = resolveLhs(ctx, nesting, c->cnst);
+            core::SymbolRef result = resolveLhs(ctx, nesting, c->cnst, cache);
             return result;
         }
         ast::Expression *resolvedScope = c->scope.get();
@@ -233,8 +291,8 @@ private:
 
     // We have failed to resolve the constant. We'll need to report the error and stub it so that we can proceed
     static void constantResolutionFailed(core::MutableContext ctx, ResolutionItem &job) {
-        auto resolved =
-            resolveConstant(ctx.withOwner(job.scope->scope), job.scope, job.out->original, job.resolutionFailed);
+        auto resolved = resolveConstant(ctx.withOwner(job.scope->scope), job.scope, job.out->original,
+                                        job.resolutionFailed, nullptr);
         if (resolved.exists() && resolved.data(ctx)->isTypeAlias()) {
             if (resolved.data(ctx)->resultType == nullptr) {
                 // This is actually a use-site error, but we limit ourselves to emitting it once by checking resultType
@@ -304,12 +362,12 @@ private:
         job.out->resolutionScope = scope;
     }
 
-    static bool resolveJob(core::Context ctx, ResolutionItem &job) {
+    static bool resolveJob(core::Context ctx, ResolutionItem &job, ResolveCache *cache) {
         if (isAlreadyResolved(ctx, *job.out)) {
             return true;
         }
-        auto resolved =
-            resolveConstant(ctx.withOwner(job.scope->scope), job.scope, job.out->original, job.resolutionFailed);
+        auto resolved = resolveConstant(ctx.withOwner(job.scope->scope), job.scope, job.out->original,
+                                        job.resolutionFailed, cache);
         if (!resolved.exists()) {
             return false;
         }
@@ -325,6 +383,63 @@ private:
         return true;
     }
 
+    // Items worth distributing over workers; below this the queue overhead dominates.
+    static constexpr size_t PARALLEL_RESOLVE_THRESHOLD = 1000;
+
+    // Runs resolveJob over `todo` on the worker pool and erases the items that resolved.
+    //
+    // This is safe because resolveJob never mutates the symbol table — it only reads it and fills
+    // in ConstantLit nodes — and `todo` is sorted by loc, so the items of one file form a
+    // contiguous range that is handed to exactly one worker. Every ConstantLit a job touches
+    // (including the scopes of nested constants) lives in that same file's tree, so no tree node
+    // is shared across workers. The alias and ancestor passes mutate symbols and stay sequential.
+    static void resolveJobsParallel(core::Context ctx, vector<ResolutionItem> &todo, WorkerPool &workers) {
+        vector<pair<u4, u4>> ranges;
+        size_t start = 0;
+        for (size_t i = 1; i <= todo.size(); i++) {
+            if (i == todo.size() || todo[i].out->loc.file() != todo[start].out->loc.file()) {
+                ranges.emplace_back(start, i);
+                start = i;
+            }
+        }
+        auto rangeq = make_shared<ConcurrentBoundedQueue<pair<u4, u4>>>(ranges.size());
+        for (auto &range : ranges) {
+            rangeq->push(move(range), 1);
+        }
+        auto resultq = make_shared<BlockingBoundedQueue<int>>(ranges.size());
+        auto *todoData = todo.data();
+        auto resolved = make_shared<vector<u1>>(todo.size(), false);
+        workers.multiplexJob("resolveConstantsFixedPoint", [ctx, rangeq, resultq, todoData, resolved]() {
+            // Per-pass cache: the table can change between passes (alias and ancestor phases run
+            // in between), but not during one.
+            MonotonicArena cacheArena;
+            ResolveCache cache{ResolveCache::allocator_type(cacheArena)};
+            pair<u4, u4> range;
+            int processed = 0;
+            for (auto result = rangeq->try_pop(range); !result.done(); result = rangeq->try_pop(range)) {
+                if (result.gotItem()) {
+                    processed++;
+                    for (auto i = range.first; i < range.second; i++) {
+                        (*resolved)[i] = resolveJob(ctx, todoData[i], &cache);
+                    }
+                }
+            }
+            if (processed > 0) {
+                resultq->push(move(processed), processed);
+            }
+        });
+        {
+            int count;
+            for (auto result = resultq->wait_pop_timed(count, WorkerPool::BLOCK_INTERVAL(), ctx.state.tracer());
+                 !result.done();
+                 result = resultq->wait_pop_timed(count, WorkerPool::BLOCK_INTERVAL(), ctx.state.tracer())) {
+            }
+        }
+        size_t idx = 0;
+        auto it = remove_if(todo.begin(), todo.end(), [&](ResolutionItem &) { return (*resolved)[idx++] != 0; });
+        todo.erase(it, todo.end());
+    }
+
     static bool resolveTypeAliasJob(core::MutableContext ctx, TypeAliasResolutionItem &job) {
         core::SymbolRef enclosingTypeMember;
         core::SymbolRef enclosingClass = job.lhs.data(ctx)->enclosingClass(ctx);
@@ -520,10 +635,11 @@ private:
     }
 
 public:
-    ResolveConstantsWalk(core::Context ctx) : nesting_(make_unique<Nesting>(nullptr, core::Symbols::root())) {}
+    ResolveConstantsWalk(core::Context ctx) : nesting_(make_unique<Nesting>(nullptr, core::Symbols::root(), 0)) {}
 
     unique_ptr<ast::ClassDef> preTransformClassDef(core::Context ctx, unique_ptr<ast::ClassDef> original) {
-        nesting_ = make_unique<Nesting>(std::move(nesting_), original->symbol);
+        auto chainId = internChainId(nesting_->chainId, original->symbol);
+        nesting_ = make_unique<Nesting>(std::move(nesting_), original->symbol, chainId);
         return original;
     }
 
@@ -537,7 +653,7 @@ public:
         auto loc = c->loc;
         auto out = make_unique<ast::ConstantLit>(loc, core::Symbols::noSymbol(), std::move(c));
         ResolutionItem job{nesting_, out.get()};
-        if (resolveJob(ctx, job)) {
+        if (resolveJob(ctx, job, &resolveCache_)) {
             categoryCounterInc("resolve.constants.nonancestor", "firstpass");
         } else {
             todo_.emplace_back(std::move(job));
@@ -762,9 +878,18 @@ public:
             {
                 Timer timeit(ctx.state.errorQueue->logger, "resolver.resolve_constants.fixed_point.constants");
                 int origSize = todo.size();
-                auto it = remove_if(todo.begin(), todo.end(),
-                                    [ctx](ResolutionItem &job) -> bool { return resolveJob(ctx, job); });
-                todo.erase(it, todo.end());
+                if (todo.size() >= PARALLEL_RESOLVE_THRESHOLD && workers.size() > 1) {
+                    resolveJobsParallel(ictx, todo, workers);
+                } else {
+                    MonotonicArena cacheArena;
+                    ResolveConstantsWalk::ResolveCache cache{
+                        ResolveConstantsWalk::ResolveCache::allocator_type(cacheArena)};
+                    auto it = remove_if(todo.begin(), todo.end(),
+                                        [ctx, &cache](ResolutionItem &job) -> bool {
+                                            return resolveJob(ctx, job, &cache);
+                                        });
+                    todo.erase(it, todo.end());
+                }
                 progress = progress || (origSize != todo.size());
                 categoryCounterAdd("resolve.constants.nonancestor", "retry", origSize - todo.size());
             }
@@ -966,6 +1091,9 @@ public:
 class ResolveSignaturesWalk {
 private:
     std::vector<int> nestedBlockCounts;
+    // One walk covers one resolver run, which is exactly the lifetime over which memoized type
+    // syntax stays valid (the symbol table can't change underneath it).
+    TypeSyntaxCache typeSyntaxCache;
 
     ast::Local *getArgLocal(core::Context ctx, const core::ArgInfo &argSym, const ast::MethodDef &mdef, int pos,
                             bool isOverloaded) {
@@ -1182,9 +1310,9 @@ private:
                 auto allowSelfType = true;
                 auto allowRebind = false;
                 auto allowTypeMember = true;
-                TypeSyntax::parseSig(
-                    ctx, sig, nullptr,
-                    TypeSyntaxArgs{allowSelfType, allowRebind, allowTypeMember, core::Symbols::untyped()});
+                TypeSyntax::parseSig(ctx, sig, nullptr,
+                                     TypeSyntaxArgs{allowSelfType, allowRebind, allowTypeMember,
+                                                    core::Symbols::untyped(), &typeSyntaxCache});
             }
 
             if (auto e = ctx.state.beginError(lastSigs[0]->loc, core::errors::Resolver::InvalidMethodSignature)) {
@@ -1308,9 +1436,10 @@ private:
                         auto allowSelfType = true;
                         auto allowRebind = false;
                         auto allowTypeMember = true;
-                        auto sig = TypeSyntax::parseSig(
-                            ctx.withOwner(sigOwner), ast::cast_tree<ast::Send>(lastSigs[i]), nullptr,
-                            TypeSyntaxArgs{allowSelfType, allowRebind, allowTypeMember, mdef->symbol});
+                        auto sig = TypeSyntax::parseSig(ctx.withOwner(sigOwner), ast::cast_tree<ast::Send>(lastSigs[i]),
+                                                       nullptr,
+                                                       TypeSyntaxArgs{allowSelfType, allowRebind, allowTypeMember,
+                                                                      mdef->symbol, &typeSyntaxCache});
                         core::SymbolRef overloadSym;
                         if (isOverloaded) {
                             vector<int> argsToKeep;
@@ -1792,10 +1921,18 @@ vector<ast::ParsedFile> Resolver::run(core::MutableContext ctx, vector<ast::Pars
     trees = ResolveConstantsWalk::resolveConstants(ctx, std::move(trees), workers);
     finalizeAncestors(ctx.state);
     trees = resolveMixesInClassMethods(ctx, std::move(trees));
-    finalizeSymbols(ctx.state);
+    finalizeSymbols(ctx.state, workers);
     trees = resolveTypeParams(ctx, std::move(trees));
+    // The hard barrier between sig resolution and typecheck is load-bearing: inference reads the
+    // sig of any method a file happens to call, call targets span arbitrary files and are not
+    // known until inference itself runs, and this walk mutates the shared symbol table. There is
+    // no per-file "sig closure" that could be declared complete and released to the typecheck
+    // pool early, so don't try to overlap the phases.
     trees = resolveSigs(ctx, std::move(trees));
     sanityCheck(ctx, trees);
+    // The symbol table is complete at this point (the tree passes on the fast path only read it),
+    // so drop the capacity slack it accumulated before the typecheck phase holds on to it.
+    ctx.state.compactSymbolTable();
 
     return trees;
 }
@@ -18,13 +18,15 @@ public:
      * to find this) */
     static std::vector<ast::ParsedFile> runTreePasses(core::MutableContext ctx, std::vector<ast::ParsedFile> trees);
 
-    // used by autogen only
+    // Constant resolution only: no ancestor finalization, no sig resolution. Used by autogen and by
+    // runs whose enabled outputs consume nothing beyond resolved constants (e.g.
+    // `-p missing-constants --stop-after resolver`).
     static std::vector<ast::ParsedFile> runConstantResolution(core::MutableContext ctx,
                                                               std::vector<ast::ParsedFile> trees, WorkerPool &workers);
 
 private:
     static void finalizeAncestors(core::GlobalState &gs);
-    static void finalizeSymbols(core::GlobalState &gs);
+    static void finalizeSymbols(core::GlobalState &gs, WorkerPool &workers);
     static std::vector<ast::ParsedFile> resolveTypeParams(core::MutableContext ctx, std::vector<ast::ParsedFile> trees);
     static std::vector<ast::ParsedFile> resolveSigs(core::MutableContext ctx, std::vector<ast::ParsedFile> trees);
     static std::vector<ast::ParsedFile> resolveMixesInClassMethods(core::MutableContext ctx,
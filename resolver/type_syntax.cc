@@ -486,7 +486,7 @@ core::TypePtr interpretTCombinator(core::MutableContext ctx, ast::Send *send, co
                 }
                 return core::Types::untypedUntracked();
             }
-            return core::make_type<core::ClassType>(singleton);
+            return core::Types::classType(singleton);
         }
         case core::Names::untyped()._id:
             return core::Types::untyped(ctx, args.untypedBlame);
@@ -514,12 +514,98 @@ core::TypePtr TypeSyntax::getResultType(core::MutableContext ctx, ast::Expressio
     return getResultTypeAndBind(ctx, expr, sigBeingParsed, args.withoutRebind()).type;
 }
 
+namespace {
+
+// 64-bit variant of core::mix, so that TypeSyntaxCache can index on the hash directly without
+// worrying about collisions between distinct expressions.
+u8 mixTypeSyntax(u8 acc, u8 nw) {
+    return nw + (acc << 6) + (acc << 16) - acc;
+}
+
+// Computes a structural hash of a type expression for TypeSyntaxCache, folding in resolved symbol
+// ids, method names and literal values. Returns false when the expression must not be memoized
+// because its meaning depends on more than its own structure.
+bool hashTypeSyntax(core::Context ctx, ast::Expression *expr, u8 &acc) {
+    acc = mixTypeSyntax(acc, static_cast<u8>(expr->tag));
+    bool ok = true;
+    typecase(
+        expr, [&](ast::Literal *lit) { acc = mixTypeSyntax(acc, lit->value->hash(ctx)); },
+        [&](ast::ConstantLit *i) {
+            auto sym = i->symbol;
+            if (!sym.exists() || sym == core::Symbols::StubModule() || sym.data(ctx)->isTypeMember() ||
+                sym.data(ctx)->isTypeAlias()) {
+                // Unresolved constants all share the StubModule symbol but keep their own spelling;
+                // type members resolve against the enclosing class; type aliases may not have a
+                // resolved right-hand side yet.
+                ok = false;
+                return;
+            }
+            acc = mixTypeSyntax(acc, sym._id);
+        },
+        [&](ast::Array *arr) {
+            acc = mixTypeSyntax(acc, arr->elems.size());
+            for (auto &el : arr->elems) {
+                ok = ok && hashTypeSyntax(ctx, el.get(), acc);
+            }
+        },
+        [&](ast::Hash *hash) {
+            acc = mixTypeSyntax(acc, hash->keys.size());
+            for (auto &key : hash->keys) {
+                ok = ok && hashTypeSyntax(ctx, key.get(), acc);
+            }
+            for (auto &value : hash->values) {
+                ok = ok && hashTypeSyntax(ctx, value.get(), acc);
+            }
+        },
+        [&](ast::Send *s) {
+            if (s->block != nullptr || s->fun == core::Names::typeParameter() ||
+                (sorbet::debug_mode && s->fun == core::Names::untyped())) {
+                // `T.type_parameter` looks its argument up in the surrounding sig; in debug builds
+                // `T.untyped` bakes the blame symbol into the type.
+                ok = false;
+                return;
+            }
+            acc = mixTypeSyntax(acc, s->fun._id);
+            ok = hashTypeSyntax(ctx, s->recv.get(), acc);
+            acc = mixTypeSyntax(acc, s->args.size());
+            for (auto &arg : s->args) {
+                ok = ok && hashTypeSyntax(ctx, arg.get(), acc);
+            }
+        },
+        // `self` resolves against the enclosing class; anything else isn't valid type syntax and
+        // reports errors we must not swallow.
+        [&](ast::Expression *expr) { ok = false; });
+    return ok;
+}
+
+} // namespace
+
 TypeSyntax::ResultType TypeSyntax::getResultTypeAndBind(core::MutableContext ctx, ast::Expression &expr,
                                                         const ParsedSig &sigBeingParsed, TypeSyntaxArgs args) {
     // Ensure that we only check types from a class context
     auto ctxOwnerData = ctx.owner.data(ctx);
     ENFORCE(ctxOwnerData->isClass(), "getResultTypeAndBind wasn't called with a class owner");
 
+    u8 key = 0;
+    bool memoize = args.cache != nullptr && ctx.state.lspQuery.isEmpty() && expr.loc.file().exists() &&
+                   hashTypeSyntax(ctx, &expr, key);
+    int errorsBefore = 0;
+    if (memoize) {
+        // Whether errors from this expression are reported depends on the file's sigil, so an
+        // entry made where they were silenced must not satisfy a lookup where they would not be
+        // (and vice versa).
+        key = mixTypeSyntax(key, static_cast<u8>(expr.loc.file().data(ctx).strictLevel));
+        key = mixTypeSyntax(key,
+                            (args.allowSelfType ? 1 : 0) | (args.allowRebind ? 2 : 0) | (args.allowTypeMember ? 4 : 0));
+        auto it = args.cache->entries.find(key);
+        if (it != args.cache->entries.end()) {
+            prodCounterInc("types.sig_cache.hits");
+            return it->second;
+        }
+        prodCounterInc("types.sig_cache.misses");
+        errorsBefore = ctx.state.totalErrors();
+    }
+
     ResultType result;
     typecase(
         &expr,
@@ -817,7 +903,7 @@ TypeSyntax::ResultType TypeSyntax::getResultTypeAndBind(core::MutableContext ctx
                 return;
             }
 
-            auto ctype = core::make_type<core::ClassType>(corrected.data(ctx)->singletonClass(ctx));
+            auto ctype = core::Types::classType(corrected.data(ctx)->singletonClass(ctx));
             core::CallLocs locs{
                 s->loc,
                 recvi->loc,
@@ -858,6 +944,11 @@ TypeSyntax::ResultType TypeSyntax::getResultTypeAndBind(core::MutableContext ctx
         });
     ENFORCE(result.type.get() != nullptr);
     result.type->sanityCheck(ctx);
+    if (memoize && ctx.state.totalErrors() == errorsBefore) {
+        // Memoizing an expression that reported an error would swallow the diagnostics that its
+        // next structurally identical occurrence should report.
+        args.cache->entries[key] = result;
+    }
     return result;
 } // namespace sorbet::resolver
 
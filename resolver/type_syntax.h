@@ -47,26 +47,29 @@ struct ParsedSig {
     const TypeArgSpec &findTypeArgByName(core::NameRef name) const;
 };
 
+class TypeSyntaxCache;
+
 struct TypeSyntaxArgs {
     const bool allowSelfType = false;
     const bool allowRebind = false;
     const bool allowTypeMember = false;
     const core::SymbolRef untypedBlame;
+    TypeSyntaxCache *const cache = nullptr;
 
     TypeSyntaxArgs withoutRebind() const {
-        return TypeSyntaxArgs{allowSelfType, false, allowTypeMember, untypedBlame};
+        return TypeSyntaxArgs{allowSelfType, false, allowTypeMember, untypedBlame, cache};
     }
 
     TypeSyntaxArgs withRebind() const {
-        return TypeSyntaxArgs{allowSelfType, true, allowTypeMember, untypedBlame};
+        return TypeSyntaxArgs{allowSelfType, true, allowTypeMember, untypedBlame, cache};
     }
 
     TypeSyntaxArgs withoutSelfType() const {
-        return TypeSyntaxArgs{false, allowRebind, allowTypeMember, untypedBlame};
+        return TypeSyntaxArgs{false, allowRebind, allowTypeMember, untypedBlame, cache};
     }
 
     TypeSyntaxArgs withoutTypeMember() const {
-        return TypeSyntaxArgs{allowSelfType, allowRebind, false, untypedBlame};
+        return TypeSyntaxArgs{allowSelfType, allowRebind, false, untypedBlame, cache};
     }
 };
 
@@ -87,6 +90,18 @@ public:
     TypeSyntax() = delete;
 };
 
+// Memoizes resolved type syntax across structurally identical type expressions within a single
+// resolver run. `sig {returns(NilClass)}` and friends repeat thousands of times over a large
+// codebase, and re-parsing them dominates resolver.sigs_vars_and_flatten profiles. Entries are
+// keyed by a structural hash over resolved symbol ids, names and literal values, so a cache must
+// be discarded whenever the symbol table can change; expressions whose meaning depends on the
+// enclosing context (self, type members, type parameters) are never memoized. See
+// getResultTypeAndBind for the details.
+class TypeSyntaxCache {
+    friend class TypeSyntax;
+    UnorderedMap<u8, TypeSyntax::ResultType> entries;
+};
+
 } // namespace sorbet::resolver
 
 #endif // SORBET_RESOLVER_TYPE_SYNTAX_H
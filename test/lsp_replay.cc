@@ -0,0 +1,155 @@
+#include "common/FileOps.h"
+#include "main/lsp/LSPMessage.h"
+#include "main/lsp/lsp.h"
+#include "main/lsp/wrapper.h"
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <thread>
+
+// Replays a recorded LSP session (one client->server JSON-RPC message per line) through LSPWrapper
+// and reports per-method request latency percentiles as JSON. A line may carry the original send
+// time as a `@<milliseconds> ` prefix; by default the driver sleeps to reproduce the recorded
+// inter-message gaps, so think time and edit cadence match the real session. Run the driver built
+// from two different revisions against the same transcript to A/B them (see
+// test/perf/lsp_replay_ab.sh).
+
+namespace sorbet::realmain::lsp {
+using namespace std;
+
+namespace {
+
+struct LatencySamples {
+    // Microseconds, one entry per completed request; sorted before reporting.
+    vector<long> micros;
+};
+
+long percentile(const vector<long> &sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t rank = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[rank];
+}
+
+void printReport(map<string, LatencySamples> &byMethod, long totalMessages, long totalWallMs) {
+    cout << "{\n";
+    cout << "  \"messages\": " << totalMessages << ",\n";
+    cout << "  \"wall_ms\": " << totalWallMs << ",\n";
+    cout << "  \"requests\": {\n";
+    bool first = true;
+    for (auto &[method, samples] : byMethod) {
+        if (!first) {
+            cout << ",\n";
+        }
+        first = false;
+        auto &sorted = samples.micros;
+        sort(sorted.begin(), sorted.end());
+        cout << "    \"" << method << "\": {"
+             << "\"count\": " << sorted.size() << ", \"p50_us\": " << percentile(sorted, 0.5)
+             << ", \"p90_us\": " << percentile(sorted, 0.9) << ", \"p99_us\": " << percentile(sorted, 0.99)
+             << ", \"max_us\": " << sorted.back() << "}";
+    }
+    cout << "\n  }\n}\n";
+}
+
+} // namespace
+
+int replayTranscript(string_view transcriptPath, string_view rootPath, bool useRecordedTiming) {
+    string transcript;
+    try {
+        transcript = FileOps::read(transcriptPath);
+    } catch (FileNotFoundException &) {
+        cerr << "fatal: cannot read transcript " << transcriptPath << "\n";
+        return 1;
+    }
+
+    LSPWrapper lspWrapper(rootPath, false);
+    lspWrapper.enableAllExperimentalFeatures();
+
+    map<string, LatencySamples> byMethod;
+    long totalMessages = 0;
+    bool sawRecordedTime = false;
+    long firstRecordedMs = 0;
+    auto replayStart = chrono::steady_clock::now();
+
+    size_t lineStart = 0;
+    while (lineStart < transcript.size()) {
+        auto lineEnd = transcript.find('\n', lineStart);
+        if (lineEnd == string::npos) {
+            lineEnd = transcript.size();
+        }
+        string line = transcript.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+        if (line.empty()) {
+            continue;
+        }
+
+        // `@<ms> {json}`: milliseconds since the recording started.
+        if (line[0] == '@') {
+            auto space = line.find(' ');
+            if (space == string::npos) {
+                cerr << "fatal: malformed timing prefix: " << line << "\n";
+                return 1;
+            }
+            long recordedMs = strtol(line.c_str() + 1, nullptr, 10);
+            if (!sawRecordedTime) {
+                sawRecordedTime = true;
+                firstRecordedMs = recordedMs;
+            }
+            if (useRecordedTiming) {
+                auto due = replayStart + chrono::milliseconds(recordedMs - firstRecordedMs);
+                this_thread::sleep_until(due);
+            }
+            line = line.substr(space + 1);
+        }
+
+        auto msg = LSPMessage::fromClient(line);
+        bool isRequest = msg->isRequest();
+        string method = isRequest ? string(convertLSPMethodToString(msg->method())) : "";
+
+        auto before = chrono::steady_clock::now();
+        lspWrapper.getLSPResponsesFor(*msg);
+        auto after = chrono::steady_clock::now();
+        totalMessages++;
+
+        if (isRequest) {
+            byMethod[method].micros.emplace_back(chrono::duration_cast<chrono::microseconds>(after - before).count());
+        }
+    }
+
+    auto totalWallMs =
+        chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - replayStart).count();
+    printReport(byMethod, totalMessages, totalWallMs);
+    return 0;
+}
+
+} // namespace sorbet::realmain::lsp
+
+int main(int argc, char *argv[]) {
+    std::string transcript;
+    std::string root;
+    bool useRecordedTiming = true;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--root" && i + 1 < argc) {
+            root = argv[++i];
+        } else if (arg == "--no-timing") {
+            useRecordedTiming = false;
+        } else if (transcript.empty() && !arg.empty() && arg[0] != '-') {
+            transcript = arg;
+        } else {
+            transcript.clear();
+            break;
+        }
+    }
+    if (transcript.empty()) {
+        std::cout << "Usage: lsp_replay [--root path] [--no-timing] transcript.jsonl\n"
+                     "Each transcript line is one client->server JSON-RPC message, optionally\n"
+                     "prefixed with `@<milliseconds> ` recording when the client sent it.\n";
+        return 1;
+    }
+
+    return sorbet::realmain::lsp::replayTranscript(transcript, root, useRecordedTiming);
+}
@@ -0,0 +1,89 @@
+#!/bin/bash
+
+# A/B runner for //test:lsp_replay. Builds of the replay driver from two revisions are pointed at
+# the same recorded transcript and their latency reports are emitted side by side. The drivers run
+# alternately so neither side systematically benefits from a warmer page cache.
+
+set -euo pipefail
+
+usage() {
+cat <<EOF
+usage:
+  $0 --a <lsp_replay-binary> --b <lsp_replay-binary> <transcript> [options] [-- <extra replay args>]
+
+options:
+  --iterations N   runs per side (default: 3)
+  --out FILE       write combined JSON here (default: stdout)
+EOF
+exit 1
+}
+
+a=""
+b=""
+transcript=""
+iterations=3
+out=""
+
+while [ "$#" -gt 0 ]; do
+  case "$1" in
+    --a) a="$2"; shift 2;;
+    --b) b="$2"; shift 2;;
+    --iterations) iterations="$2"; shift 2;;
+    --out) out="$2"; shift 2;;
+    --) shift; break;;
+    -*) usage;;
+    *) transcript="$1"; shift;;
+  esac
+done
+
+if [ -z "$a" ] || [ -z "$b" ] || [ -z "$transcript" ]; then
+  usage
+fi
+for bin in "$a" "$b"; do
+  if [ ! -x "$bin" ]; then
+    echo "fatal: replay binary not found or not executable: $bin" >&2
+    exit 1
+  fi
+done
+if [ ! -f "$transcript" ]; then
+  echo "fatal: transcript not found: $transcript" >&2
+  exit 1
+fi
+
+tmpdir="$(mktemp -d)"
+trap 'rm -rf "$tmpdir"' EXIT
+
+for ((i = 0; i < iterations; i++)); do
+  echo "iteration $((i + 1))/$iterations: a" >&2
+  "$a" "$transcript" "$@" > "$tmpdir/a.$i.json"
+  echo "iteration $((i + 1))/$iterations: b" >&2
+  "$b" "$transcript" "$@" > "$tmpdir/b.$i.json"
+done
+
+aggregate() {
+  echo '{'
+  echo "  \"transcript\": \"$transcript\","
+  for side in a b; do
+    comma=','
+    if [ "$side" = b ]; then
+      comma=''
+    fi
+    echo "  \"$side\": ["
+    for ((i = 0; i < iterations; i++)); do
+      inner=','
+      if [ "$i" -eq "$((iterations - 1))" ]; then
+        inner=''
+      fi
+      sed 's/^/    /' "$tmpdir/$side.$i.json" | sed "\$s/\$/$inner/"
+    done
+    echo "  ]$comma"
+  done
+  echo '}'
+}
+
+if [ -n "$out" ]; then
+  aggregate > "$out"
+  echo "wrote $out" >&2
+else
+  aggregate
+fi
@@ -0,0 +1,103 @@
+#!/bin/bash
+
+# Perf smoke runner: feeds a directory through the production sorbet binary (the exact realmain
+# pipeline, no test_corpus assertion parsing) several times and collects per-phase counters as
+# machine-readable JSON. Each measured iteration's --metrics-file output already contains the
+# per-phase timers and the run.utilization.* rusage counters that realmain records, so this script
+# only orchestrates warmup, iteration, and aggregation.
+
+set -euo pipefail
+
+usage() {
+cat <<EOF
+usage:
+  $0 <corpus-dir> [options] [-- <extra sorbet args>]
+
+options:
+  --iterations N   measured iterations (default: 5)
+  --warmup N       discarded warmup iterations (default: 1)
+  --out FILE       write aggregated JSON here (default: stdout)
+  --sorbet PATH    sorbet binary to run (default: main/sorbet under bazel runfiles,
+                   or \$SORBET_BIN)
+EOF
+exit 1
+}
+
+if [ "$#" -lt 1 ]; then
+  usage
+fi
+
+corpus="$1"
+shift
+
+iterations=5
+warmup=1
+out=""
+sorbet="${SORBET_BIN:-main/sorbet}"
+
+while [ "$#" -gt 0 ]; do
+  case "$1" in
+    --iterations) iterations="$2"; shift 2;;
+    --warmup) warmup="$2"; shift 2;;
+    --out) out="$2"; shift 2;;
+    --sorbet) sorbet="$2"; shift 2;;
+    --) shift; break;;
+    *) usage;;
+  esac
+done
+
+if [ ! -d "$corpus" ]; then
+  echo "fatal: not a directory: $corpus" >&2
+  exit 1
+fi
+if [ ! -x "$sorbet" ]; then
+  echo "fatal: sorbet binary not found or not executable: $sorbet" >&2
+  exit 1
+fi
+
+tmpdir="$(mktemp -d)"
+trap 'rm -rf "$tmpdir"' EXIT
+
+# Errors are expected in arbitrary corpora and are not what we are measuring; keep the output
+# quiet so terminal IO does not pollute the timings.
+run_sorbet() {
+  "$sorbet" --silence-dev-message -q --no-error-count "$@" "$corpus" || true
+}
+
+for ((i = 0; i < warmup; i++)); do
+  echo "warmup $((i + 1))/$warmup" >&2
+  run_sorbet
+done
+
+for ((i = 0; i < iterations; i++)); do
+  echo "iteration $((i + 1))/$iterations" >&2
+  start_ns="$(date +%s%N)"
+  run_sorbet --metrics-file "$tmpdir/metrics.$i.json"
+  end_ns="$(date +%s%N)"
+  echo "$(((end_ns - start_ns) / 1000000))" > "$tmpdir/wall_ms.$i"
+done
+
+aggregate() {
+  echo '{'
+  echo "  \"corpus\": \"$corpus\","
+  echo "  \"warmup\": $warmup,"
+  echo '  "iterations": ['
+  for ((i = 0; i < iterations; i++)); do
+    comma=','
+    if [ "$i" -eq "$((iterations - 1))" ]; then
+      comma=''
+    fi
+    echo "    {\"wall_ms\": $(cat "$tmpdir/wall_ms.$i"), \"metrics\":"
+    sed 's/^/    /' "$tmpdir/metrics.$i.json"
+    echo "    }$comma"
+  done
+  echo '  ]'
+  echo '}'
+}
+
+if [ -n "$out" ]; then
+  aggregate > "$out"
+  echo "wrote $out" >&2
+else
+  aggregate
+fi
@@ -111,7 +111,7 @@ UnorderedSet<string> knownExpectations = {
     "flattened-tree", "flattened-tree-raw", "cfg",       "cfg-json",      "autogen",      "document-symbols"};
 
 ast::ParsedFile testSerialize(core::GlobalState &gs, ast::ParsedFile expr) {
-    auto saved = core::serialize::Serializer::storeExpression(gs, expr.tree);
+    auto saved = core::serialize::Serializer::storeExpression(gs, *expr.tree);
     auto restored = core::serialize::Serializer::loadExpression(gs, saved.data());
     return {move(restored), expr.file};
 }
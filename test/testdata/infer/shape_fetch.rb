@@ -0,0 +1,12 @@
+# typed: true
+h = {a: 1, b: "hi"}
+T.assert_type!(h[:a], Integer)
+T.assert_type!(h[:b], String)
+T.assert_type!(h[:c], NilClass)
+T.assert_type!(h.fetch(:a), Integer)
+T.assert_type!(h.fetch(:b), String)
+
+t = [0, "hi"]
+T.assert_type!(t.fetch(0), Integer)
+T.assert_type!(t.fetch(1), String)
+T.assert_type!(t.fetch(-1), String)